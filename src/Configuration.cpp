@@ -10,6 +10,8 @@
 
 #include "Configuration.h"
 
+#include "Utilities/CpuTopology.h"
+
 #include <algorithm>
 #include <cstdlib>
 #include <limits.h>
@@ -94,6 +96,36 @@ void Configuration::Load()
         orchestratorRegionCode = std::string(varVal);
     }
 
+    // FTL_NODE_MAX_VIEWERS -> NodeMaxViewers
+    if (char* varVal = std::getenv("FTL_NODE_MAX_VIEWERS"))
+    {
+        nodeMaxViewers = std::stoul(varVal);
+    }
+
+    // FTL_NODE_MAX_EGRESS_BITS_PER_SECOND -> NodeMaxEgressBitsPerSecond
+    if (char* varVal = std::getenv("FTL_NODE_MAX_EGRESS_BITS_PER_SECOND"))
+    {
+        nodeMaxEgressBitsPerSecond = std::stoull(varVal);
+    }
+
+    // FTL_EDGE_RELAY_LINGER_MS -> EdgeRelayLingerTime
+    if (char* varVal = std::getenv("FTL_EDGE_RELAY_LINGER_MS"))
+    {
+        edgeRelayLingerTime = std::chrono::milliseconds(std::stoul(varVal));
+    }
+
+    // FTL_EDGE_RELAY_LINGER_MAX_BITS_PER_SECOND -> EdgeRelayLingerMaxBitsPerSecond
+    if (char* varVal = std::getenv("FTL_EDGE_RELAY_LINGER_MAX_BITS_PER_SECOND"))
+    {
+        edgeRelayLingerMaxBitsPerSecond = std::stoull(varVal);
+    }
+
+    // FTL_EDGE_PREWARM_CHANNELS -> EdgePrewarmChannelIds
+    if (char* varVal = std::getenv("FTL_EDGE_PREWARM_CHANNELS"))
+    {
+        edgePrewarmChannelIds = parseChannelIdList(std::string(varVal));
+    }
+
     // FTL_SERVICE_CONNECTION -> ServiceConnectionKind
     if (char* serviceConnectionEnv = std::getenv("FTL_SERVICE_CONNECTION"))
     {
@@ -123,12 +155,90 @@ void Configuration::Load()
         serviceConnectionMetadataReportInterval = std::chrono::milliseconds(std::stoi(varVal));
     }
 
+    // FTL_SERVICE_METADATAHEARTBEATINTERVALMS -> ServiceConnectionMetadataHeartbeatInterval
+    if (char* varVal = std::getenv("FTL_SERVICE_METADATAHEARTBEATINTERVALMS"))
+    {
+        serviceConnectionMetadataHeartbeatInterval = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_SERVICE_METADATABITRATECHANGEPERCENT -> ServiceConnectionMetadataBitrateChangePercent
+    if (char* varVal = std::getenv("FTL_SERVICE_METADATABITRATECHANGEPERCENT"))
+    {
+        serviceConnectionMetadataBitrateChangePercent = std::stoul(varVal);
+    }
+
+    // FTL_SERVICE_THUMBNAILINTERVALMS -> ServiceConnectionThumbnailInterval
+    if (char* varVal = std::getenv("FTL_SERVICE_THUMBNAILINTERVALMS"))
+    {
+        serviceConnectionThumbnailInterval = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_SERVICE_HMACKEYCACHETTLMS -> ServiceHmacKeyCacheTtl
+    if (char* varVal = std::getenv("FTL_SERVICE_HMACKEYCACHETTLMS"))
+    {
+        serviceHmacKeyCacheTtl = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_SERVICE_HMACKEYNEGATIVECACHETTLMS -> ServiceHmacKeyNegativeCacheTtl
+    if (char* varVal = std::getenv("FTL_SERVICE_HMACKEYNEGATIVECACHETTLMS"))
+    {
+        serviceHmacKeyNegativeCacheTtl = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_SERVICE_IO_THREADS -> ServiceIoThreads
+    if (char* varVal = std::getenv("FTL_SERVICE_IO_THREADS"))
+    {
+        serviceIoThreads = std::stoul(varVal);
+    }
+
+    // FTL_SERVICE_THUMBNAIL_THREADS -> ServiceThumbnailThreads
+    if (char* varVal = std::getenv("FTL_SERVICE_THUMBNAIL_THREADS"))
+    {
+        serviceThumbnailThreads = std::stoul(varVal);
+    }
+
+    // FTL_SERVICE_THUMBNAIL_MAX_WIDTH -> ServiceThumbnailMaxWidth
+    if (char* varVal = std::getenv("FTL_SERVICE_THUMBNAIL_MAX_WIDTH"))
+    {
+        serviceThumbnailMaxWidth = std::stoi(varVal);
+    }
+
+    // FTL_SERVICE_THUMBNAIL_MAX_HEIGHT -> ServiceThumbnailMaxHeight
+    if (char* varVal = std::getenv("FTL_SERVICE_THUMBNAIL_MAX_HEIGHT"))
+    {
+        serviceThumbnailMaxHeight = std::stoi(varVal);
+    }
+
+    // FTL_SERVICE_THUMBNAIL_HWACCEL -> ServiceThumbnailHardwareDevice
+    if (char* varVal = std::getenv("FTL_SERVICE_THUMBNAIL_HWACCEL"))
+    {
+        serviceThumbnailHardwareDevice = std::string(varVal);
+    }
+
+    // FTL_SERVICE_THUMBNAIL_QUALITY -> ServiceThumbnailQuality
+    if (char* varVal = std::getenv("FTL_SERVICE_THUMBNAIL_QUALITY"))
+    {
+        serviceThumbnailQuality = std::stoi(varVal);
+    }
+
     // FTL_MAX_ALLOWED_BITS_PER_SECOND -> MaxAllowedBitsPerSecond
     if (char* varVal = std::getenv("FTL_MAX_ALLOWED_BITS_PER_SECOND"))
     {
         maxAllowedBitsPerSecond = std::stoi(varVal);
     }
 
+    // FTL_MAX_ALLOWED_BITRATE_BURST_BYTES -> MaxAllowedBitrateBurstBytes
+    if (char* varVal = std::getenv("FTL_MAX_ALLOWED_BITRATE_BURST_BYTES"))
+    {
+        maxAllowedBitrateBurstBytes = std::stoull(varVal);
+    }
+
+    // FTL_MAX_ALLOWED_BITRATE_VIOLATIONS -> MaxAllowedBitrateViolations
+    if (char* varVal = std::getenv("FTL_MAX_ALLOWED_BITRATE_VIOLATIONS"))
+    {
+        maxAllowedBitrateViolations = std::stoul(varVal);
+    }
+
     // FTL_ROLLING_SIZE_AVG_MS -> RollingSizeAvgMs
     if (char* varVal = std::getenv("FTL_ROLLING_SIZE_AVG_MS"))
     {
@@ -141,6 +251,219 @@ void Configuration::Load()
         nackLostPackets = std::stoi(varVal);
     }
 
+    // FTL_STREAM_MAX_MEMORY_BYTES -> StreamMaxMemoryBytes
+    if (char* varVal = std::getenv("FTL_STREAM_MAX_MEMORY_BYTES"))
+    {
+        streamMaxMemoryBytes = std::stoull(varVal);
+    }
+
+    // FTL_MEDIA_REORDER_DELAY_MS -> MediaReorderDelay
+    if (char* varVal = std::getenv("FTL_MEDIA_REORDER_DELAY_MS"))
+    {
+        mediaReorderDelay = std::chrono::milliseconds(std::stoul(varVal));
+    }
+
+    // FTL_CONNECTION_REACTOR -> IsConnectionReactorEnabled
+    if (char* varVal = std::getenv("FTL_CONNECTION_REACTOR"))
+    {
+        connectionReactorEnabled = std::stoi(varVal);
+    }
+
+    // FTL_CONNECTION_REACTOR_THREADS -> ConnectionReactorThreads
+    if (char* varVal = std::getenv("FTL_CONNECTION_REACTOR_THREADS"))
+    {
+        connectionReactorThreads = std::stoul(varVal);
+    }
+
+    // FTL_CONNECTION_REACTOR_CPUS -> ConnectionReactorCpus
+    if (char* varVal = std::getenv("FTL_CONNECTION_REACTOR_CPUS"))
+    {
+        connectionReactorCpus = CpuTopology::ParseCpuList(std::string(varVal));
+    }
+
+    // FTL_MEDIA_THREAD_CPUS -> MediaThreadCpus
+    if (char* varVal = std::getenv("FTL_MEDIA_THREAD_CPUS"))
+    {
+        mediaThreadCpus = CpuTopology::ParseCpuList(std::string(varVal));
+    }
+
+    // FTL_MEDIA_FOLLOW_RX_CPU -> IsMediaFollowRxCpuEnabled
+    if (char* varVal = std::getenv("FTL_MEDIA_FOLLOW_RX_CPU"))
+    {
+        mediaFollowRxCpuEnabled = std::stoi(varVal);
+    }
+
+    // FTL_INGEST_CALLBACK_THREADS -> IngestCallbackThreads
+    if (char* varVal = std::getenv("FTL_INGEST_CALLBACK_THREADS"))
+    {
+        ingestCallbackThreads = std::stoul(varVal);
+    }
+
+    // FTL_CONTROL_LISTEN_SOCKETS -> ControlListenSockets
+    if (char* varVal = std::getenv("FTL_CONTROL_LISTEN_SOCKETS"))
+    {
+        controlListenSockets = std::stoul(varVal);
+    }
+
+    // FTL_CONTROL_ADMISSION_PER_MINUTE -> ControlAdmissionPerMinute
+    if (char* varVal = std::getenv("FTL_CONTROL_ADMISSION_PER_MINUTE"))
+    {
+        controlAdmissionPerMinute = std::stoul(varVal);
+    }
+
+    // FTL_CONTROL_ADMISSION_BURST -> ControlAdmissionBurst
+    if (char* varVal = std::getenv("FTL_CONTROL_ADMISSION_BURST"))
+    {
+        controlAdmissionBurst = std::stoul(varVal);
+    }
+
+    // FTL_MEDIA_SHARED_PORT -> MediaSharedPort
+    if (char* varVal = std::getenv("FTL_MEDIA_SHARED_PORT"))
+    {
+        mediaSharedPort = std::stoi(varVal);
+    }
+
+    // FTL_MEDIA_SHARED_PORT_SOCKETS -> MediaSharedPortSockets
+    if (char* varVal = std::getenv("FTL_MEDIA_SHARED_PORT_SOCKETS"))
+    {
+        mediaSharedPortSockets = std::stoul(varVal);
+    }
+
+    // FTL_MEDIA_SOURCE_FILTER -> IsMediaSourceFilterEnabled
+    if (char* varVal = std::getenv("FTL_MEDIA_SOURCE_FILTER"))
+    {
+        mediaSourceFilterEnabled = std::stoi(varVal);
+    }
+
+    // FTL_MEDIA_IO_URING -> IsMediaIoUringEnabled
+    if (char* varVal = std::getenv("FTL_MEDIA_IO_URING"))
+    {
+        mediaIoUringEnabled = std::stoi(varVal);
+    }
+
+    // FTL_VIEWER_FANOUT -> IsViewerFanoutEnabled
+    if (char* varVal = std::getenv("FTL_VIEWER_FANOUT"))
+    {
+        viewerFanoutEnabled = std::stoi(varVal);
+    }
+
+    // FTL_VIEWER_FANOUT_THREADS -> ViewerFanoutThreads
+    if (char* varVal = std::getenv("FTL_VIEWER_FANOUT_THREADS"))
+    {
+        viewerFanoutThreads = std::stoul(varVal);
+    }
+
+    // FTL_VIEWER_FANOUT_CPUS -> ViewerFanoutCpus
+    if (char* varVal = std::getenv("FTL_VIEWER_FANOUT_CPUS"))
+    {
+        viewerFanoutCpus = CpuTopology::ParseCpuList(std::string(varVal));
+    }
+
+    // FTL_NUMA_STREAM_PLACEMENT -> IsNumaStreamPlacementEnabled
+    if (char* varVal = std::getenv("FTL_NUMA_STREAM_PLACEMENT"))
+    {
+        numaStreamPlacementEnabled = std::stoi(varVal);
+    }
+
+    // FTL_RELAY_KEYFRAME_BURST -> IsRelayKeyframeBurstEnabled
+    if (char* varVal = std::getenv("FTL_RELAY_KEYFRAME_BURST"))
+    {
+        relayKeyframeBurstEnabled = std::stoi(varVal);
+    }
+
+    // FTL_RELAY_GROUP -> IsRelayGroupEnabled
+    if (char* varVal = std::getenv("FTL_RELAY_GROUP"))
+    {
+        relayGroupEnabled = std::stoi(varVal);
+    }
+
+    // FTL_RELAY_PACING_INTERVAL_MS -> RelayPacingInterval
+    if (char* varVal = std::getenv("FTL_RELAY_PACING_INTERVAL_MS"))
+    {
+        relayPacingInterval = std::chrono::milliseconds(std::stoul(varVal));
+    }
+
+    // FTL_METRICS_PORT -> MetricsPort
+    if (char* varVal = std::getenv("FTL_METRICS_PORT"))
+    {
+        metricsPort = std::stoul(varVal);
+    }
+
+    // FTL_HANDOFF_SOCKET_PATH -> HandoffSocketPath
+    if (char* varVal = std::getenv("FTL_HANDOFF_SOCKET_PATH"))
+    {
+        handoffSocketPath = std::string(varVal);
+    }
+
+    // FTL_RECORDING_DIR -> RecordingDirectory
+    if (char* varVal = std::getenv("FTL_RECORDING_DIR"))
+    {
+        recordingDirectory = std::string(varVal);
+    }
+
+    // FTL_RECORDING_SEGMENT_BYTES -> RecordingSegmentBytes
+    if (char* varVal = std::getenv("FTL_RECORDING_SEGMENT_BYTES"))
+    {
+        recordingSegmentBytes = std::stoull(varVal);
+    }
+
+    // FTL_RECORDING_ROTATE_ON_KEYFRAME -> IsRecordingRotateOnKeyframeEnabled
+    if (char* varVal = std::getenv("FTL_RECORDING_ROTATE_ON_KEYFRAME"))
+    {
+        recordingRotateOnKeyframe = std::stoi(varVal);
+    }
+
+    // FTL_BACKGROUND_INIT -> IsBackgroundInitEnabled
+    if (char* varVal = std::getenv("FTL_BACKGROUND_INIT"))
+    {
+        backgroundInitEnabled = std::stoi(varVal);
+    }
+
+    // FTL_OVERLOAD_MAXFANOUTQUEUEDEPTH -> OverloadMaxFanoutQueueDepth
+    if (char* varVal = std::getenv("FTL_OVERLOAD_MAXFANOUTQUEUEDEPTH"))
+    {
+        overloadMaxFanoutQueueDepth = std::stoul(varVal);
+    }
+
+    // FTL_OVERLOAD_MAXFANOUTLATENCYMS -> OverloadMaxFanoutLatency
+    if (char* varVal = std::getenv("FTL_OVERLOAD_MAXFANOUTLATENCYMS"))
+    {
+        overloadMaxFanoutLatency = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_OVERLOAD_SUSTAINMS -> OverloadSustainTime
+    if (char* varVal = std::getenv("FTL_OVERLOAD_SUSTAINMS"))
+    {
+        overloadSustainTime = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_OVERLOAD_RECOVERMS -> OverloadRecoverTime
+    if (char* varVal = std::getenv("FTL_OVERLOAD_RECOVERMS"))
+    {
+        overloadRecoverTime = std::chrono::milliseconds(std::stoi(varVal));
+    }
+
+    // FTL_OVERLOAD_SHEDVIEWERPERCENT -> OverloadShedViewerPercent
+    if (char* varVal = std::getenv("FTL_OVERLOAD_SHEDVIEWERPERCENT"))
+    {
+        overloadShedViewerPercent = std::stoul(varVal);
+    }
+
+    // FTL_OVERLOAD_REDIRECTHOSTNAME -> OverloadRedirectHostname
+    if (char* varVal = std::getenv("FTL_OVERLOAD_REDIRECTHOSTNAME"))
+    {
+        overloadRedirectHostname = std::string(varVal);
+    }
+
+    // FTL_CONTROL_BIND_* and friends -> ControlSocketBinding
+    loadSocketBinding("FTL_CONTROL", controlSocketBinding);
+
+    // FTL_MEDIA_BIND_* and friends -> MediaSocketBinding
+    loadSocketBinding("FTL_MEDIA", mediaSocketBinding);
+
+    // FTL_RELAY_BIND_* and friends -> RelaySocketBinding
+    loadSocketBinding("FTL_RELAY", relaySocketBinding);
+
     // FTL_SERVICE_DUMMY_HMAC_KEY -> DummyHmacKey
     if (char* varVal = std::getenv("FTL_SERVICE_DUMMY_HMAC_KEY"))
     {
@@ -256,6 +579,31 @@ std::string Configuration::GetOrchestratorRegionCode()
     return orchestratorRegionCode;
 }
 
+uint32_t Configuration::GetNodeMaxViewers()
+{
+    return nodeMaxViewers;
+}
+
+uint64_t Configuration::GetNodeMaxEgressBitsPerSecond()
+{
+    return nodeMaxEgressBitsPerSecond;
+}
+
+std::chrono::milliseconds Configuration::GetEdgeRelayLingerTime()
+{
+    return edgeRelayLingerTime;
+}
+
+uint64_t Configuration::GetEdgeRelayLingerMaxBitsPerSecond()
+{
+    return edgeRelayLingerMaxBitsPerSecond;
+}
+
+std::vector<ftl_channel_id_t> Configuration::GetEdgePrewarmChannelIds()
+{
+    return edgePrewarmChannelIds;
+}
+
 ServiceConnectionKind Configuration::GetServiceConnectionKind()
 {
     return serviceConnectionKind;
@@ -276,11 +624,76 @@ std::chrono::milliseconds Configuration::GetServiceConnectionMetadataReportInter
     return serviceConnectionMetadataReportInterval;
 }
 
+std::chrono::milliseconds Configuration::GetServiceConnectionMetadataHeartbeatInterval()
+{
+    return serviceConnectionMetadataHeartbeatInterval;
+}
+
+uint32_t Configuration::GetServiceConnectionMetadataBitrateChangePercent()
+{
+    return serviceConnectionMetadataBitrateChangePercent;
+}
+
+std::chrono::milliseconds Configuration::GetServiceConnectionThumbnailInterval()
+{
+    return serviceConnectionThumbnailInterval;
+}
+
+std::chrono::milliseconds Configuration::GetServiceHmacKeyCacheTtl()
+{
+    return serviceHmacKeyCacheTtl;
+}
+
+std::chrono::milliseconds Configuration::GetServiceHmacKeyNegativeCacheTtl()
+{
+    return serviceHmacKeyNegativeCacheTtl;
+}
+
+uint32_t Configuration::GetServiceIoThreads()
+{
+    return serviceIoThreads;
+}
+
+uint32_t Configuration::GetServiceThumbnailThreads()
+{
+    return serviceThumbnailThreads;
+}
+
+uint16_t Configuration::GetServiceThumbnailMaxWidth()
+{
+    return serviceThumbnailMaxWidth;
+}
+
+uint16_t Configuration::GetServiceThumbnailMaxHeight()
+{
+    return serviceThumbnailMaxHeight;
+}
+
+uint8_t Configuration::GetServiceThumbnailQuality()
+{
+    return serviceThumbnailQuality;
+}
+
+std::string Configuration::GetServiceThumbnailHardwareDevice()
+{
+    return serviceThumbnailHardwareDevice;
+}
+
 uint32_t Configuration::GetMaxAllowedBitsPerSecond()
 {
     return maxAllowedBitsPerSecond;
 }
 
+uint64_t Configuration::GetMaxAllowedBitrateBurstBytes()
+{
+    return maxAllowedBitrateBurstBytes;
+}
+
+uint32_t Configuration::GetMaxAllowedBitrateViolations()
+{
+    return maxAllowedBitrateViolations;
+}
+
 uint32_t Configuration::GetRollingSizeAvgMs()
 {
     return rollingSizeAvgMs;
@@ -291,6 +704,191 @@ bool Configuration::IsNackLostPacketsEnabled()
     return nackLostPackets;
 }
 
+uint64_t Configuration::GetStreamMaxMemoryBytes()
+{
+    return streamMaxMemoryBytes;
+}
+
+std::chrono::milliseconds Configuration::GetMediaReorderDelay()
+{
+    return mediaReorderDelay;
+}
+
+bool Configuration::IsConnectionReactorEnabled()
+{
+    return connectionReactorEnabled;
+}
+
+uint32_t Configuration::GetConnectionReactorThreads()
+{
+    return connectionReactorThreads;
+}
+
+std::vector<int> Configuration::GetConnectionReactorCpus()
+{
+    return connectionReactorCpus;
+}
+
+std::vector<int> Configuration::GetMediaThreadCpus()
+{
+    return mediaThreadCpus;
+}
+
+bool Configuration::IsMediaFollowRxCpuEnabled()
+{
+    return mediaFollowRxCpuEnabled;
+}
+
+uint32_t Configuration::GetIngestCallbackThreads()
+{
+    return ingestCallbackThreads;
+}
+
+uint32_t Configuration::GetControlListenSockets()
+{
+    return controlListenSockets;
+}
+
+uint32_t Configuration::GetControlAdmissionPerMinute()
+{
+    return controlAdmissionPerMinute;
+}
+
+uint32_t Configuration::GetControlAdmissionBurst()
+{
+    return controlAdmissionBurst;
+}
+
+uint16_t Configuration::GetMediaSharedPort()
+{
+    return mediaSharedPort;
+}
+
+uint32_t Configuration::GetMediaSharedPortSockets()
+{
+    return mediaSharedPortSockets;
+}
+
+bool Configuration::IsMediaSourceFilterEnabled()
+{
+    return mediaSourceFilterEnabled;
+}
+
+bool Configuration::IsMediaIoUringEnabled()
+{
+    return mediaIoUringEnabled;
+}
+
+bool Configuration::IsViewerFanoutEnabled()
+{
+    return viewerFanoutEnabled;
+}
+
+uint32_t Configuration::GetViewerFanoutThreads()
+{
+    return viewerFanoutThreads;
+}
+
+std::vector<int> Configuration::GetViewerFanoutCpus()
+{
+    return viewerFanoutCpus;
+}
+
+bool Configuration::IsNumaStreamPlacementEnabled()
+{
+    return numaStreamPlacementEnabled;
+}
+
+bool Configuration::IsRelayKeyframeBurstEnabled()
+{
+    return relayKeyframeBurstEnabled;
+}
+
+bool Configuration::IsRelayGroupEnabled()
+{
+    return relayGroupEnabled;
+}
+
+std::chrono::milliseconds Configuration::GetRelayPacingInterval()
+{
+    return relayPacingInterval;
+}
+
+uint16_t Configuration::GetMetricsPort()
+{
+    return metricsPort;
+}
+
+std::string Configuration::GetHandoffSocketPath()
+{
+    return handoffSocketPath;
+}
+
+std::string Configuration::GetRecordingDirectory()
+{
+    return recordingDirectory;
+}
+
+uint64_t Configuration::GetRecordingSegmentBytes()
+{
+    return recordingSegmentBytes;
+}
+
+bool Configuration::IsRecordingRotateOnKeyframeEnabled()
+{
+    return recordingRotateOnKeyframe;
+}
+
+bool Configuration::IsBackgroundInitEnabled()
+{
+    return backgroundInitEnabled;
+}
+
+size_t Configuration::GetOverloadMaxFanoutQueueDepth()
+{
+    return overloadMaxFanoutQueueDepth;
+}
+
+std::chrono::milliseconds Configuration::GetOverloadMaxFanoutLatency()
+{
+    return overloadMaxFanoutLatency;
+}
+
+std::chrono::milliseconds Configuration::GetOverloadSustainTime()
+{
+    return overloadSustainTime;
+}
+
+std::chrono::milliseconds Configuration::GetOverloadRecoverTime()
+{
+    return overloadRecoverTime;
+}
+
+uint32_t Configuration::GetOverloadShedViewerPercent()
+{
+    return overloadShedViewerPercent;
+}
+
+std::string Configuration::GetOverloadRedirectHostname()
+{
+    return overloadRedirectHostname;
+}
+
+SocketBinding Configuration::GetControlSocketBinding()
+{
+    return controlSocketBinding;
+}
+
+SocketBinding Configuration::GetMediaSocketBinding()
+{
+    return mediaSocketBinding;
+}
+
+SocketBinding Configuration::GetRelaySocketBinding()
+{
+    return relaySocketBinding;
+}
+
 std::string Configuration::GetGlimeshServiceHostname()
 {
     return glimeshServiceHostname;
@@ -361,4 +959,59 @@ std::vector<std::byte> Configuration::hexStringToByteArray(std::string hexString
 
     return retVal;
 }
+
+std::vector<ftl_channel_id_t> Configuration::parseChannelIdList(std::string channelIdList)
+{
+    std::vector<ftl_channel_id_t> retVal;
+    std::stringstream listStream(channelIdList);
+    std::string channelId;
+    while (std::getline(listStream, channelId, ','))
+    {
+        if (!channelId.empty())
+        {
+            retVal.push_back(std::stoul(channelId));
+        }
+    }
+
+    return retVal;
+}
+
+void Configuration::loadSocketBinding(const std::string& prefix, SocketBinding& binding)
+{
+    // <prefix>_BIND_ADDRESS -> Address
+    if (char* varVal = std::getenv((prefix + "_BIND_ADDRESS").c_str()))
+    {
+        binding.Address = std::string(varVal);
+    }
+
+    // <prefix>_BIND_INTERFACE -> Interface
+    if (char* varVal = std::getenv((prefix + "_BIND_INTERFACE").c_str()))
+    {
+        binding.Interface = std::string(varVal);
+    }
+
+    // <prefix>_RECV_BUFFER_BYTES -> ReceiveBufferBytes
+    if (char* varVal = std::getenv((prefix + "_RECV_BUFFER_BYTES").c_str()))
+    {
+        binding.ReceiveBufferBytes = std::stoi(varVal);
+    }
+
+    // <prefix>_SEND_BUFFER_BYTES -> SendBufferBytes
+    if (char* varVal = std::getenv((prefix + "_SEND_BUFFER_BYTES").c_str()))
+    {
+        binding.SendBufferBytes = std::stoi(varVal);
+    }
+
+    // <prefix>_BUSY_POLL_US -> BusyPollMicroseconds
+    if (char* varVal = std::getenv((prefix + "_BUSY_POLL_US").c_str()))
+    {
+        binding.BusyPollMicroseconds = std::stoi(varVal);
+    }
+
+    // <prefix>_INCOMING_CPUS -> IncomingCpus
+    if (char* varVal = std::getenv((prefix + "_INCOMING_CPUS").c_str()))
+    {
+        binding.IncomingCpus = CpuTopology::ParseCpuList(std::string(varVal));
+    }
+}
 #pragma endregion
\ No newline at end of file
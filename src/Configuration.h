@@ -10,6 +10,9 @@
 
 #pragma once
 
+#include "Utilities/FtlTypes.h"
+#include "Utilities/SocketBinding.h"
+
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -43,11 +46,66 @@ public:
     uint16_t GetOrchestratorPort();
     std::vector<std::byte> GetOrchestratorPsk();
     std::string GetOrchestratorRegionCode();
+    uint32_t GetNodeMaxViewers();
+    uint64_t GetNodeMaxEgressBitsPerSecond();
+    std::chrono::milliseconds GetEdgeRelayLingerTime();
+    uint64_t GetEdgeRelayLingerMaxBitsPerSecond();
+    std::vector<ftl_channel_id_t> GetEdgePrewarmChannelIds();
     ServiceConnectionKind GetServiceConnectionKind();
     std::chrono::milliseconds GetServiceConnectionMetadataReportInterval();
+    std::chrono::milliseconds GetServiceConnectionMetadataHeartbeatInterval();
+    uint32_t GetServiceConnectionMetadataBitrateChangePercent();
+    std::chrono::milliseconds GetServiceConnectionThumbnailInterval();
+    std::chrono::milliseconds GetServiceHmacKeyCacheTtl();
+    std::chrono::milliseconds GetServiceHmacKeyNegativeCacheTtl();
+    uint32_t GetServiceIoThreads();
+    uint32_t GetServiceThumbnailThreads();
+    uint16_t GetServiceThumbnailMaxWidth();
+    uint16_t GetServiceThumbnailMaxHeight();
+    uint8_t GetServiceThumbnailQuality();
+    std::string GetServiceThumbnailHardwareDevice();
     uint32_t GetMaxAllowedBitsPerSecond();
+    uint64_t GetMaxAllowedBitrateBurstBytes();
+    uint32_t GetMaxAllowedBitrateViolations();
     uint32_t GetRollingSizeAvgMs();
     bool IsNackLostPacketsEnabled();
+    uint64_t GetStreamMaxMemoryBytes();
+    std::chrono::milliseconds GetMediaReorderDelay();
+    bool IsConnectionReactorEnabled();
+    uint32_t GetConnectionReactorThreads();
+    std::vector<int> GetConnectionReactorCpus();
+    std::vector<int> GetMediaThreadCpus();
+    bool IsMediaFollowRxCpuEnabled();
+    uint32_t GetIngestCallbackThreads();
+    uint32_t GetControlListenSockets();
+    uint32_t GetControlAdmissionPerMinute();
+    uint32_t GetControlAdmissionBurst();
+    uint16_t GetMediaSharedPort();
+    uint32_t GetMediaSharedPortSockets();
+    bool IsMediaSourceFilterEnabled();
+    bool IsMediaIoUringEnabled();
+    bool IsViewerFanoutEnabled();
+    uint32_t GetViewerFanoutThreads();
+    std::vector<int> GetViewerFanoutCpus();
+    bool IsNumaStreamPlacementEnabled();
+    bool IsRelayKeyframeBurstEnabled();
+    bool IsRelayGroupEnabled();
+    std::chrono::milliseconds GetRelayPacingInterval();
+    uint16_t GetMetricsPort();
+    std::string GetHandoffSocketPath();
+    std::string GetRecordingDirectory();
+    uint64_t GetRecordingSegmentBytes();
+    bool IsRecordingRotateOnKeyframeEnabled();
+    bool IsBackgroundInitEnabled();
+    size_t GetOverloadMaxFanoutQueueDepth();
+    std::chrono::milliseconds GetOverloadMaxFanoutLatency();
+    std::chrono::milliseconds GetOverloadSustainTime();
+    std::chrono::milliseconds GetOverloadRecoverTime();
+    uint32_t GetOverloadShedViewerPercent();
+    std::string GetOverloadRedirectHostname();
+    SocketBinding GetControlSocketBinding();
+    SocketBinding GetMediaSocketBinding();
+    SocketBinding GetRelaySocketBinding();
 
     // Dummy Service Connection Values
     std::vector<std::byte> GetDummyHmacKey();
@@ -75,11 +133,66 @@ private:
     uint16_t orchestratorPort = 8085;
     std::vector<std::byte> orchestratorPsk;
     std::string orchestratorRegionCode = "global";
+    uint32_t nodeMaxViewers = 0;
+    uint64_t nodeMaxEgressBitsPerSecond = 0;
+    std::chrono::milliseconds edgeRelayLingerTime = std::chrono::milliseconds(0);
+    uint64_t edgeRelayLingerMaxBitsPerSecond = 0;
+    std::vector<ftl_channel_id_t> edgePrewarmChannelIds;
     ServiceConnectionKind serviceConnectionKind = ServiceConnectionKind::DummyServiceConnection;
     std::chrono::milliseconds serviceConnectionMetadataReportInterval = std::chrono::milliseconds(4000);
+    std::chrono::milliseconds serviceConnectionMetadataHeartbeatInterval = std::chrono::milliseconds(0);
+    uint32_t serviceConnectionMetadataBitrateChangePercent = 10;
+    std::chrono::milliseconds serviceConnectionThumbnailInterval = std::chrono::milliseconds(30000);
+    std::chrono::milliseconds serviceHmacKeyCacheTtl = std::chrono::milliseconds(0);
+    std::chrono::milliseconds serviceHmacKeyNegativeCacheTtl = std::chrono::milliseconds(5000);
+    uint32_t serviceIoThreads = 2;
+    uint32_t serviceThumbnailThreads = 2;
+    uint16_t serviceThumbnailMaxWidth = 640;
+    uint16_t serviceThumbnailMaxHeight = 360;
+    uint8_t serviceThumbnailQuality = 5;
+    std::string serviceThumbnailHardwareDevice;
     uint32_t maxAllowedBitsPerSecond = 0;
+    uint64_t maxAllowedBitrateBurstBytes = 0;
+    uint32_t maxAllowedBitrateViolations = 100;
     uint32_t rollingSizeAvgMs = 2000;
     bool nackLostPackets = false;
+    uint64_t streamMaxMemoryBytes = 4 * 1024 * 1024;
+    std::chrono::milliseconds mediaReorderDelay = std::chrono::milliseconds(0);
+    bool connectionReactorEnabled = false;
+    uint32_t connectionReactorThreads = 0;
+    std::vector<int> connectionReactorCpus;
+    std::vector<int> mediaThreadCpus;
+    bool mediaFollowRxCpuEnabled = false;
+    uint32_t ingestCallbackThreads = 8;
+    uint32_t controlListenSockets = 1;
+    uint32_t controlAdmissionPerMinute = 0;
+    uint32_t controlAdmissionBurst = 10;
+    uint16_t mediaSharedPort = 0;
+    uint32_t mediaSharedPortSockets = 4;
+    bool mediaSourceFilterEnabled = false;
+    bool mediaIoUringEnabled = false;
+    bool viewerFanoutEnabled = false;
+    uint32_t viewerFanoutThreads = 0;
+    std::vector<int> viewerFanoutCpus;
+    bool numaStreamPlacementEnabled = false;
+    bool relayKeyframeBurstEnabled = false;
+    bool relayGroupEnabled = false;
+    std::chrono::milliseconds relayPacingInterval = std::chrono::milliseconds(0);
+    uint16_t metricsPort = 0;
+    std::string handoffSocketPath;
+    std::string recordingDirectory;
+    uint64_t recordingSegmentBytes = 256 * 1024 * 1024;
+    bool recordingRotateOnKeyframe = true;
+    bool backgroundInitEnabled = false;
+    size_t overloadMaxFanoutQueueDepth = 0;
+    std::chrono::milliseconds overloadMaxFanoutLatency = std::chrono::milliseconds(0);
+    std::chrono::milliseconds overloadSustainTime = std::chrono::milliseconds(2000);
+    std::chrono::milliseconds overloadRecoverTime = std::chrono::milliseconds(10000);
+    uint32_t overloadShedViewerPercent = 50;
+    std::string overloadRedirectHostname;
+    SocketBinding controlSocketBinding;
+    SocketBinding mediaSocketBinding;
+    SocketBinding relaySocketBinding;
 
     // Dummy Service Connection Backing Stores
     // "aBcDeFgHiJkLmNoPqRsTuVwXyZ123456"
@@ -113,4 +226,16 @@ private:
      * @brief Takes a hex string of format "010203FF" and converts it to an array of bytes.
      */
     std::vector<std::byte> hexStringToByteArray(std::string hexString);
+
+    /**
+     * @brief Takes a comma separated list of channel IDs such as "1,2,3"
+     */
+    std::vector<ftl_channel_id_t> parseChannelIdList(std::string channelIdList);
+
+    /**
+     * @brief
+     *  Reads the bind address, interface and socket options for one kind of socket from
+     *  variables starting with the given prefix, ex. "FTL_MEDIA"
+     */
+    void loadSocketBinding(const std::string& prefix, SocketBinding& binding);
 };
\ No newline at end of file
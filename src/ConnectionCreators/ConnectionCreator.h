@@ -8,10 +8,14 @@
 #pragma once
 
 #include "../ConnectionTransports/ConnectionTransport.h"
+#include "../Utilities/IpAddress.h"
+#include "../Utilities/Result.h"
 
+#include <cstdint>
 #include <memory>
-#include <netinet/in.h>
 #include <optional>
+#include <span>
+#include <vector>
 
 /**
  * @brief The ConnectionCreator is a factory-pattern style class used to create stateless
@@ -24,6 +28,30 @@ public:
 
     /**
      * @brief Create a ConnectionTransport targeting the provided port and IPv4/v6 addresses.
+     * @param ssrcs RTP SSRCs the remote end will be sending, used by creators that share a
+     *  socket between many connections to route datagrams
      */
-    virtual std::unique_ptr<ConnectionTransport> CreateConnection(int port, in_addr targetAddr) = 0;
+    virtual std::unique_ptr<ConnectionTransport> CreateConnection(
+        int port,
+        const IpAddress& targetAddr,
+        std::span<const uint32_t> ssrcs) = 0;
+
+    /**
+     * @brief If every connection created shares a single port, returns that port.
+     */
+    virtual std::optional<uint16_t> GetSharedPort() const
+    {
+        return std::nullopt;
+    }
+
+    /**
+     * @brief
+     *  Stops receiving on the shared port, returning copies of its OS handles (ex. socket file
+     *  descriptors) so another process can carry on receiving. Creators without a shared port
+     *  have nothing to hand off. The caller owns the returned handles.
+     */
+    virtual Result<std::vector<int>> DetachSharedHandles()
+    {
+        return Result<std::vector<int>>::Success({});
+    }
 };
\ No newline at end of file
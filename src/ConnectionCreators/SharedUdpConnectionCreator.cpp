@@ -0,0 +1,43 @@
+/**
+ * @file SharedUdpConnectionCreator.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "SharedUdpConnectionCreator.h"
+
+#include "../ConnectionTransports/UdpMediaDemuxer.h"
+
+#pragma region Constructor/Destructor
+SharedUdpConnectionCreator::SharedUdpConnectionCreator(uint16_t port, size_t numSockets,
+    SocketBinding binding)
+:
+    demuxer(std::make_shared<UdpMediaDemuxer>(port, numSockets, std::move(binding)))
+{ }
+
+SharedUdpConnectionCreator::SharedUdpConnectionCreator(std::vector<int> adoptedSocketHandles)
+:
+    demuxer(std::make_shared<UdpMediaDemuxer>(std::move(adoptedSocketHandles)))
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region ConnectionCreator implementation
+std::unique_ptr<ConnectionTransport> SharedUdpConnectionCreator::CreateConnection(
+    int port,
+    const IpAddress& targetAddr,
+    std::span<const uint32_t> ssrcs)
+{
+    return demuxer->CreateTransport(targetAddr, ssrcs);
+}
+
+std::optional<uint16_t> SharedUdpConnectionCreator::GetSharedPort() const
+{
+    return demuxer->GetPort();
+}
+
+Result<std::vector<int>> SharedUdpConnectionCreator::DetachSharedHandles()
+{
+    return demuxer->DetachSockets();
+}
+#pragma endregion ConnectionCreator implementation
@@ -0,0 +1,39 @@
+/**
+ * @file SharedUdpConnectionCreator.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ConnectionCreator.h"
+#include "../Utilities/SocketBinding.h"
+
+class UdpMediaDemuxer;
+
+/**
+ * @brief Creates UDP transports that all receive on one shared port
+ */
+class SharedUdpConnectionCreator : public ConnectionCreator
+{
+public:
+    /* Constructor/Destructor */
+    SharedUdpConnectionCreator(uint16_t port, size_t numSockets, SocketBinding binding = {});
+    /**
+     * @brief Receives on bound sockets handed over by another process
+     */
+    SharedUdpConnectionCreator(std::vector<int> adoptedSocketHandles);
+
+    // ConnectionCreator implementation
+    std::unique_ptr<ConnectionTransport> CreateConnection(
+        int port,
+        const IpAddress& targetAddr,
+        std::span<const uint32_t> ssrcs) override;
+    std::optional<uint16_t> GetSharedPort() const override;
+    Result<std::vector<int>> DetachSharedHandles() override;
+
+private:
+    /* Private fields */
+    const std::shared_ptr<UdpMediaDemuxer> demuxer;
+};
@@ -7,28 +7,49 @@
 
 #include "UdpConnectionCreator.h"
 
+#include "../ConnectionTransports/IoUringConnectionTransport.h"
 #include "../ConnectionTransports/NetworkSocketConnectionTransport.h"
 #include "../Utilities/Util.h"
 
 #include <netinet/in.h>
+#include <spdlog/spdlog.h>
 #include <stdexcept>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
+
+#pragma region Constructor/Destructor
+UdpConnectionCreator::UdpConnectionCreator(bool sourceFilterEnabled, SocketBinding binding,
+    bool ioUringEnabled)
+:
+    sourceFilterEnabled(sourceFilterEnabled),
+    binding(std::move(binding)),
+    ioUringEnabled(ioUringEnabled)
+{
+    // Catch a bad address on startup, rather than when the first stream arrives
+    Result<SocketBinding::BindAddress> bindAddress = this->binding.GetBindAddress(0);
+    if (bindAddress.IsError)
+    {
+        throw std::invalid_argument(bindAddress.ErrorMessage);
+    }
+}
+#pragma endregion Constructor/Destructor
 
 #pragma region ConnectionCreator implementation
 std::unique_ptr<ConnectionTransport> UdpConnectionCreator::CreateConnection(
     int port,
-    in_addr targetAddr)
+    const IpAddress& targetAddr,
+    std::span<const uint32_t> ssrcs)
 {
-    // TODO: Allow targeting specific source network interfaces
-    // TODO: IPV6 support
     // Create the UDP socket, then hand it to the UdpConnectionTransport
-    sockaddr_in socketAddress { 0 };
-    socketAddress.sin_family = AF_INET;
-    socketAddress.sin_addr.s_addr = htonl(INADDR_ANY);
-    socketAddress.sin_port = htons(port);
+    const sa_family_t family = targetAddr.GetFamily();
+    Result<SocketBinding::BindAddress> socketAddress = binding.GetBindAddress(port, family);
+    if (socketAddress.IsError)
+    {
+        throw std::runtime_error(socketAddress.ErrorMessage);
+    }
 
-    int socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    int socketHandle = socket(family, SOCK_DGRAM, IPPROTO_UDP);
     if (socketHandle == -1)
     {
         int error = errno;
@@ -37,26 +58,59 @@ std::unique_ptr<ConnectionTransport> UdpConnectionCreator::CreateConnection(
             error, Util::ErrnoToString(error)));
     }
 
+    Result<void> applyResult = binding.Apply(socketHandle, family);
+    if (applyResult.IsError)
+    {
+        close(socketHandle);
+        throw std::runtime_error(applyResult.ErrorMessage);
+    }
+
     int bindResult = bind(
         socketHandle,
-        reinterpret_cast<sockaddr*>(&socketAddress),
-        sizeof(socketAddress));
+        reinterpret_cast<const sockaddr*>(&socketAddress.Value.Address),
+        socketAddress.Value.Length);
     if (bindResult != 0)
     {
         int error = errno;
+        close(socketHandle);
         throw std::runtime_error(fmt::format(
             "Couldn't bind UDP socket. Error {}: {}",
             error, Util::ErrnoToString(error)));
     }
 
-    sockaddr_in target
+    // Exactly one of these is set, IPv6 being left to streamers that only have an IPv6 address
+    const std::optional<sockaddr_in> target = targetAddr.ToIpv4(port);
+    const std::optional<sockaddr_in6> target6 = target.has_value() ?
+        std::nullopt : std::optional(targetAddr.ToIpv6(port));
+    if (sourceFilterEnabled)
     {
-        .sin_family = AF_INET,
-        .sin_port = htons(port),
-        .sin_addr = targetAddr,
-    };
+        // Not fatal, the transport still discards unexpected datagrams on its own
+        Result<void> filterResult = target.has_value() ?
+            NetworkSocketConnectionTransport::AttachSourceFilter(socketHandle, target.value()) :
+            NetworkSocketConnectionTransport::AttachSourceFilter(socketHandle, target6.value());
+        if (filterResult.IsError)
+        {
+            spdlog::warn("Media port {} will filter source addresses in userspace: {}",
+                port, filterResult.ErrorMessage);
+        }
+    }
+
+    if (ioUringEnabled && !isIoUringUnavailable.load(std::memory_order_relaxed))
+    {
+        auto ioUringResult = IoUringConnectionTransport::Create(socketHandle, target, target6);
+        if (!ioUringResult.IsError)
+        {
+            return std::move(ioUringResult.Value);
+        }
+        // Whatever stopped this one will stop the rest, so only say so once
+        if (!isIoUringUnavailable.exchange(true))
+        {
+            spdlog::warn("Media will be read without io_uring: {}", ioUringResult.ErrorMessage);
+        }
+    }
+
     auto result = NetworkSocketConnectionTransport::Nonblocking(
-        NetworkSocketConnectionKind::Udp, socketHandle, target);
+        NetworkSocketConnectionKind::Udp, socketHandle, target, target6);
     if (result.IsError)
     {
         throw std::runtime_error(result.ErrorMessage);
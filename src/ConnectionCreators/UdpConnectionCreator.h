@@ -8,6 +8,9 @@
 #pragma once
 
 #include "ConnectionCreator.h"
+#include "../Utilities/SocketBinding.h"
+
+#include <atomic>
 
 /**
  * @brief Creates UdpConnectionTransports!
@@ -15,6 +18,31 @@
 class UdpConnectionCreator : public ConnectionCreator
 {
 public:
+    /* Constructor/Destructor */
+    /**
+     * @param sourceFilterEnabled
+     *  Whether to attach a kernel socket filter that drops datagrams from anyone but the
+     *  expected peer
+     * @param binding
+     *  address and interface to receive media on, and how to tune each media socket. Media
+     *  from IPv4 and IPv6 streamers alike is received on "::" (or the default of nothing).
+     * @param ioUringEnabled
+     *  Whether to read and write media sockets with io_uring, falling back to plain socket
+     *  calls if the kernel can't
+     */
+    UdpConnectionCreator(bool sourceFilterEnabled = false, SocketBinding binding = {},
+        bool ioUringEnabled = false);
+
     // ConnectionCreator implementation
-    std::unique_ptr<ConnectionTransport> CreateConnection(int port, in_addr targetAddr) override;
+    std::unique_ptr<ConnectionTransport> CreateConnection(
+        int port,
+        const IpAddress& targetAddr,
+        std::span<const uint32_t> ssrcs) override;
+
+private:
+    /* Private fields */
+    const bool sourceFilterEnabled;
+    const SocketBinding binding;
+    const bool ioUringEnabled;
+    std::atomic<bool> isIoUringUnavailable { false };
 };
\ No newline at end of file
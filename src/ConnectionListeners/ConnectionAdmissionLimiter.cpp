@@ -0,0 +1,101 @@
+/**
+ * @file ConnectionAdmissionLimiter.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "ConnectionAdmissionLimiter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#pragma region Constructor/Destructor
+ConnectionAdmissionLimiter::ConnectionAdmissionLimiter(double connectionsPerSecond,
+    uint32_t burst)
+:
+    connectionsPerSecond(connectionsPerSecond),
+    burst(std::max<uint32_t>(burst, 1))
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool ConnectionAdmissionLimiter::TryAdmit(in_addr_t addr,
+    std::chrono::steady_clock::time_point now)
+{
+    return tryAdmit(AddressKey(AF_INET, addr), now);
+}
+
+bool ConnectionAdmissionLimiter::TryAdmit(const in6_addr& addr,
+    std::chrono::steady_clock::time_point now)
+{
+    if (IN6_IS_ADDR_V4MAPPED(&addr))
+    {
+        // An IPv4 peer reaching a dual-stack socket is still the same IPv4 peer
+        in_addr_t ipv4Addr;
+        std::memcpy(&ipv4Addr, &addr.s6_addr[12], sizeof(ipv4Addr));
+        return TryAdmit(ipv4Addr, now);
+    }
+    uint64_t prefix;
+    std::memcpy(&prefix, addr.s6_addr, sizeof(prefix));
+    return tryAdmit(AddressKey(AF_INET6, prefix), now);
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+ConnectionAdmissionLimiter::Stats ConnectionAdmissionLimiter::GetStats()
+{
+    std::scoped_lock lock(mutex);
+    return Stats
+    {
+        .Admitted = admitted,
+        .Rejected = rejected,
+        .TrackedAddresses = buckets.size(),
+    };
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private types
+size_t ConnectionAdmissionLimiter::AddressKeyHash::operator()(const AddressKey& key) const
+{
+    return std::hash<uint64_t>()(key.second) ^ (static_cast<size_t>(key.first) << 1);
+}
+#pragma endregion Private types
+
+#pragma region Private methods
+bool ConnectionAdmissionLimiter::tryAdmit(const AddressKey& key,
+    std::chrono::steady_clock::time_point now)
+{
+    std::unique_lock lock(mutex);
+    auto it = buckets.find(key);
+    if (it == buckets.end())
+    {
+        if (buckets.size() >= nextPurgeSize)
+        {
+            purgeFullBuckets(now, lock);
+        }
+        it = buckets.try_emplace(key, connectionsPerSecond, burst, now).first;
+    }
+
+    if (it->second.TryConsume(now))
+    {
+        ++admitted;
+        return true;
+    }
+    ++rejected;
+    return false;
+}
+
+void ConnectionAdmissionLimiter::purgeFullBuckets(std::chrono::steady_clock::time_point now,
+    const std::unique_lock<std::mutex>& lock)
+{
+    // A full bucket is no different from one we've never seen
+    std::erase_if(buckets,
+        [now](const auto& bucketPair)
+        {
+            return bucketPair.second.IsFull(now);
+        });
+    nextPurgeSize = std::max(MIN_PURGE_SIZE, buckets.size() * 2);
+}
+#pragma endregion Private methods
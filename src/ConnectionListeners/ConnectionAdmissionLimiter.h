@@ -0,0 +1,89 @@
+/**
+ * @file ConnectionAdmissionLimiter.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../Utilities/TokenBucket.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief
+ *  Decides whether to accept new connections with a token bucket per source address, so one
+ *  address flooding us with connections is turned away while everyone else reconnecting at the
+ *  same time still gets in. Thread-safe.
+ */
+class ConnectionAdmissionLimiter
+{
+public:
+    /* Public types */
+    struct Stats
+    {
+        uint64_t Admitted;
+        uint64_t Rejected;
+        size_t TrackedAddresses;
+    };
+
+    /* Constants */
+    // Idle addresses are forgotten whenever more than this many are being tracked
+    static constexpr size_t MIN_PURGE_SIZE = 1024;
+
+    /* Constructor/Destructor */
+    /**
+     * @param connectionsPerSecond how quickly each address earns back connections
+     * @param burst how many connections an address can make at once
+     */
+    ConnectionAdmissionLimiter(double connectionsPerSecond, uint32_t burst);
+
+    /* Public methods */
+    /**
+     * @brief Returns whether a new connection from the given IPv4 address should be accepted
+     */
+    bool TryAdmit(in_addr_t addr,
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+    /**
+     * @brief
+     *  Returns whether a new connection from the given IPv6 address should be accepted. Peers
+     *  are usually handed a whole /64, so every address in one shares a bucket.
+     */
+    bool TryAdmit(const in6_addr& addr,
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    /* Getters/Setters */
+    Stats GetStats();
+
+private:
+    /* Private types */
+    // Address family, and the IPv4 address or IPv6 /64 prefix, so neither can stand in for
+    // the other
+    using AddressKey = std::pair<sa_family_t, uint64_t>;
+    struct AddressKeyHash
+    {
+        size_t operator()(const AddressKey& key) const;
+    };
+
+    /* Private fields */
+    const double connectionsPerSecond;
+    const double burst;
+    std::mutex mutex;
+    std::unordered_map<AddressKey, TokenBucket<>, AddressKeyHash> buckets;
+    size_t nextPurgeSize = MIN_PURGE_SIZE;
+    uint64_t admitted = 0;
+    uint64_t rejected = 0;
+
+    /* Private methods */
+    bool tryAdmit(const AddressKey& key, std::chrono::steady_clock::time_point now);
+    void purgeFullBuckets(std::chrono::steady_clock::time_point now,
+        const std::unique_lock<std::mutex>& lock);
+};
@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include "../Utilities/Result.h"
+
+#include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
 // Forward declarations
 class ConnectionTransport;
@@ -41,4 +45,15 @@ public:
      */
     virtual void SetOnNewConnection(
         std::function<void(std::unique_ptr<ConnectionTransport>)> onNewConnection) = 0;
+
+    /**
+     * @brief
+     *  Stops listening, returning copies of the OS handles (ex. socket file descriptors) being
+     *  listened on so another process can carry on accepting from them. Connections that
+     *  arrive in the meantime wait in the backlog. The caller owns the returned handles.
+     */
+    virtual Result<std::vector<int>> DetachListenHandles()
+    {
+        return Result<std::vector<int>>::Error("This listener can't hand off its handles");
+    }
 };
\ No newline at end of file
@@ -10,28 +10,162 @@
 #include "../ConnectionTransports/NetworkSocketConnectionTransport.h"
 #include "../Utilities/Util.h"
 
-#include <netinet/in.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <poll.h>
 #include <stdexcept>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 #pragma region Constructor/Destructor
 TcpConnectionListener::TcpConnectionListener(
     const int listenPort,
-    const int socketQueueLimit) :
+    const int socketQueueLimit,
+    const size_t numSockets,
+    std::unique_ptr<ConnectionAdmissionLimiter> admissionLimiter,
+    std::vector<int> adoptedListenHandles,
+    SocketBinding binding) :
     listenPort(listenPort),
-    socketQueueLimit(socketQueueLimit)
-{ }
+    socketQueueLimit(socketQueueLimit),
+    numSockets(std::max<size_t>(numSockets, 1)),
+    admissionLimiter(std::move(admissionLimiter)),
+    binding(std::move(binding)),
+    stopEventHandle(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+    listenSocketHandles(std::move(adoptedListenHandles))
+{
+    if (stopEventHandle < 0)
+    {
+        int error = errno;
+        throw std::runtime_error(
+            fmt::format(
+                "Unable to create listener stop event! Error {}: {}",
+                error,
+                Util::ErrnoToString(error)));
+    }
+}
+
+TcpConnectionListener::~TcpConnectionListener()
+{
+    // Adopted sockets we never got around to listening on
+    for (int listenSocketHandle : listenSocketHandles)
+    {
+        close(listenSocketHandle);
+    }
+    close(stopEventHandle);
+}
 #pragma endregion Constructor/Destructor
 
 #pragma region ConnectionTransport implementation
 void TcpConnectionListener::Listen(std::promise<void>&& readyPromise)
 {
-    // TODO IPv6 binding, configurable binding interfaces...
-    sockaddr_in socketAddress = { 0 };
-    socketAddress.sin_family = AF_INET;
-    socketAddress.sin_addr.s_addr = htonl(INADDR_ANY);
-    socketAddress.sin_port = htons(listenPort);
+    std::vector<int> handles;
+    {
+        std::lock_guard lock(listenSocketMutex);
+        if (listenSocketHandles.empty())
+        {
+            try
+            {
+                for (size_t i = 0; i < numSockets; ++i)
+                {
+                    listenSocketHandles.push_back(openListenSocket(i));
+                }
+            }
+            catch (...)
+            {
+                for (int listenSocketHandle : listenSocketHandles)
+                {
+                    close(listenSocketHandle);
+                }
+                listenSocketHandles.clear();
+                throw;
+            }
+        }
+        handles = listenSocketHandles;
+    }
+
+    // Now we begin listening, using this thread for the first socket
+    readyPromise.set_value();
+    {
+        std::vector<std::jthread> acceptThreads;
+        for (size_t i = 1; i < handles.size(); ++i)
+        {
+            acceptThreads.emplace_back(&TcpConnectionListener::acceptLoop, this, handles.at(i));
+        }
+        acceptLoop(handles.front());
+    }
+
+    std::lock_guard lock(listenSocketMutex);
+    for (int listenSocketHandle : listenSocketHandles)
+    {
+        close(listenSocketHandle);
+    }
+    listenSocketHandles.clear();
+}
+
+void TcpConnectionListener::StopListening()
+{
+    // The event is never read, so it stays readable and wakes every accept loop
+    uint64_t value = 1;
+    if (write(stopEventHandle, &value, sizeof(value)) != sizeof(value))
+    {
+        int error = errno;
+        spdlog::error("Unable to signal listener to stop. Error {}: {}", error,
+            Util::ErrnoToString(error));
+    }
+}
+
+void TcpConnectionListener::SetOnNewConnection(
+    std::function<void(std::unique_ptr<ConnectionTransport>)> onNewConnection)
+{
+    this->onNewConnection = onNewConnection;
+}
+
+Result<std::vector<int>> TcpConnectionListener::DetachListenHandles()
+{
+    // Hold the sockets open while we copy them, Listen closes its own once the loops stop
+    std::lock_guard lock(listenSocketMutex);
+    if (listenSocketHandles.empty())
+    {
+        return Result<std::vector<int>>::Error("Listener isn't listening");
+    }
+
+    std::vector<int> detachedHandles;
+    for (int listenSocketHandle : listenSocketHandles)
+    {
+        int detachedHandle = fcntl(listenSocketHandle, F_DUPFD_CLOEXEC, 0);
+        if (detachedHandle < 0)
+        {
+            int error = errno;
+            for (int handle : detachedHandles)
+            {
+                close(handle);
+            }
+            return Result<std::vector<int>>::Error(fmt::format(
+                "Unable to duplicate listen socket. Error {}: {}", error,
+                Util::ErrnoToString(error)));
+        }
+        detachedHandles.push_back(detachedHandle);
+    }
+    StopListening();
+    return Result<std::vector<int>>::Success(std::move(detachedHandles));
+}
+#pragma endregion ConnectionTransport implementation
+
+#pragma region Private methods
+int TcpConnectionListener::openListenSocket(size_t socketIndex)
+{
+    Result<SocketBinding::BindAddress> bindAddress = binding.GetBindAddress(listenPort);
+    if (bindAddress.IsError)
+    {
+        throw std::runtime_error(
+            fmt::format("Unable to listen on {}: {}", binding.Address, bindAddress.ErrorMessage));
+    }
+    const SocketBinding::BindAddress& socketAddress = bindAddress.Value;
 
-    listenSocketHandle = socket(AF_INET, SOCK_STREAM, 0);
+    int listenSocketHandle = socket(socketAddress.GetFamily(),
+        SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (listenSocketHandle < 0)
     {
         int error = errno;
@@ -52,6 +186,7 @@ void TcpConnectionListener::Listen(std::promise<void>&& readyPromise)
         sizeof(reUseOption)) != 0)
     {
         int error = errno;
+        close(listenSocketHandle);
         throw std::runtime_error(
             fmt::format(
                 "Unable to set SO_REUSEADDR on listen socket! Error {}: {}",
@@ -59,86 +194,185 @@ void TcpConnectionListener::Listen(std::promise<void>&& readyPromise)
                 Util::ErrnoToString(error)));
     }
 
-    int bindResult = bind(
+    // Let our other sockets share the port, with the kernel balancing connections between them
+    if ((numSockets > 1) && (setsockopt(
         listenSocketHandle,
-        (const sockaddr*)&socketAddress,
-        sizeof(socketAddress));
-    switch (bindResult)
-    {
-    case 0:
-        break;
-    case EADDRINUSE:
-        throw std::runtime_error("FTL ingest could not bind to socket, "
-            "this address is already in use.");
-    case EACCES:
-        throw std::runtime_error("FTL ingest could not bind to socket, "
-            "access was denied.");
-    default:
-        throw std::runtime_error("FTL ingest could not bind to socket.");
-    }
-    
-    int listenResult = listen(listenSocketHandle, socketQueueLimit);
-    switch (listenResult)
-    {
-    case 0:
-        break;
-    case EADDRINUSE:
-        throw std::runtime_error("FTL ingest could not listen on socket, "
-            "this port is already in use.");
-    default:
-        throw std::runtime_error("FTL ingest could not listen on socket.");
-    }
-
-    // Now we begin listening
-    readyPromise.set_value();
+        SOL_SOCKET,
+        SO_REUSEPORT,
+        &reUseOption,
+        sizeof(reUseOption)) != 0))
+    {
+        int error = errno;
+        close(listenSocketHandle);
+        throw std::runtime_error(
+            fmt::format(
+                "Unable to set SO_REUSEPORT on listen socket! Error {}: {}",
+                error,
+                Util::ErrnoToString(error)));
+    }
+
+    // Set before listening, since accepted connections inherit buffer sizes and busy polling
+    Result<void> applyResult =
+        binding.Apply(listenSocketHandle, socketAddress.GetFamily(), socketIndex);
+    if (applyResult.IsError)
+    {
+        close(listenSocketHandle);
+        throw std::runtime_error(applyResult.ErrorMessage);
+    }
+
+    if (bind(
+        listenSocketHandle,
+        reinterpret_cast<const sockaddr*>(&socketAddress.Address),
+        socketAddress.Length) != 0)
+    {
+        int error = errno;
+        close(listenSocketHandle);
+        switch (error)
+        {
+        case EADDRINUSE:
+            throw std::runtime_error("FTL ingest could not bind to socket, "
+                "this address is already in use.");
+        case EACCES:
+            throw std::runtime_error("FTL ingest could not bind to socket, "
+                "access was denied.");
+        default:
+            throw std::runtime_error("FTL ingest could not bind to socket.");
+        }
+    }
+
+    if (listen(listenSocketHandle, socketQueueLimit) != 0)
+    {
+        int error = errno;
+        close(listenSocketHandle);
+        switch (error)
+        {
+        case EADDRINUSE:
+            throw std::runtime_error("FTL ingest could not listen on socket, "
+                "this port is already in use.");
+        default:
+            throw std::runtime_error("FTL ingest could not listen on socket.");
+        }
+    }
+
+    return listenSocketHandle;
+}
+
+void TcpConnectionListener::acceptLoop(int listenSocketHandle)
+{
+    pollfd pollFds[2] = {
+        { .fd = listenSocketHandle, .events = POLLIN, .revents = 0 },
+        { .fd = stopEventHandle, .events = POLLIN, .revents = 0 },
+    };
     while (true)
     {
-        // Accept incoming connections
-        int connectionHandle = accept(listenSocketHandle, nullptr, nullptr);
-        if (connectionHandle == -1)
+        if (poll(pollFds, 2, -1) < 0)
         {
-            if (errno == EINVAL)
+            if (errno == EINTR)
             {
-                break;
+                continue;
             }
+            int error = errno;
+            spdlog::error("Failed to poll listen socket. Error {}: {}", error,
+                Util::ErrnoToString(error));
+            break;
+        }
+        if ((pollFds[1].revents != 0) || ((pollFds[0].revents & (POLLERR | POLLNVAL)) != 0))
+        {
+            break;
         }
-        else
+
+        // Accept everything that's queued up before going back to sleep
+        while (true)
         {
-            sockaddr_in acceptAddress = { 0 };
+            sockaddr_storage acceptAddress = { 0 };
             socklen_t acceptLen = sizeof(acceptAddress);
-            getpeername(connectionHandle, reinterpret_cast<sockaddr*>(&acceptAddress), &acceptLen);
-            if (onNewConnection)
+            int connectionHandle = accept4(listenSocketHandle,
+                reinterpret_cast<sockaddr*>(&acceptAddress), &acceptLen,
+                (SOCK_NONBLOCK | SOCK_CLOEXEC));
+            if (connectionHandle >= 0)
             {
-                // Create a ConnectionTransport for this new connection
-                auto result = NetworkSocketConnectionTransport::Nonblocking(
-                    NetworkSocketConnectionKind::Tcp,
-                    connectionHandle,
-                    acceptAddress);
-                if (result.IsError)
-                {
-                    spdlog::error(
-                        "Failed to create transport for accepted socket: {}",
-                        result.ErrorMessage);
-                    break;
-                }
-                onNewConnection(std::move(result.Value));
+                onConnectionAccepted(connectionHandle, acceptAddress);
+                continue;
+            }
+
+            int error = errno;
+            if ((error == EAGAIN) || (error == EWOULDBLOCK))
+            {
+                break;
+            }
+            else if ((error == EINTR) || (error == ECONNABORTED) || (error == EPROTO))
+            {
+                // The connection went away before we got to it
+                continue;
             }
-            else
+            else if ((error == EMFILE) || (error == ENFILE) || (error == ENOBUFS) ||
+                (error == ENOMEM))
             {
-                // Warn that we've accepted a connection but nobody was listening!
+                // Leave connections in the backlog until we have room for them
+                spdlog::warn("Unable to accept connection, backing off. Error {}: {}", error,
+                    Util::ErrnoToString(error));
+                std::this_thread::sleep_for(ACCEPT_ERROR_BACKOFF);
+                break;
             }
+            spdlog::error("Failed to accept connection. Error {}: {}", error,
+                Util::ErrnoToString(error));
+            break;
         }
     }
 }
 
-void TcpConnectionListener::StopListening()
+void TcpConnectionListener::onConnectionAccepted(int connectionHandle,
+    const sockaddr_storage& acceptAddress)
 {
-    // TODO
-}
+    const std::optional<sockaddr_in> ipv4Address = SocketBinding::ToIpv4(acceptAddress);
+    std::optional<sockaddr_in6> ipv6Address = std::nullopt;
+    std::string addressString;
+    bool isAdmitted = true;
+    if (ipv4Address.has_value())
+    {
+        addressString = Util::AddrToString(ipv4Address->sin_addr);
+        isAdmitted = !admissionLimiter ||
+            admissionLimiter->TryAdmit(ipv4Address->sin_addr.s_addr);
+    }
+    else
+    {
+        ipv6Address = *reinterpret_cast<const sockaddr_in6*>(&acceptAddress);
+        addressString = Util::AddrToString(ipv6Address->sin6_addr);
+        // Peers are usually handed a whole /64, so that's what we limit together
+        isAdmitted = !admissionLimiter ||
+            admissionLimiter->TryAdmit(ipv6Address->sin6_addr);
+    }
 
-void TcpConnectionListener::SetOnNewConnection(
-    std::function<void(std::unique_ptr<ConnectionTransport>)> onNewConnection)
-{
-    this->onNewConnection = onNewConnection;
+    if (!isAdmitted)
+    {
+        // Turn them away before they cost us a transport or a control connection
+        spdlog::debug("Rejecting connection from {}, it is connecting too often",
+            addressString);
+        close(connectionHandle);
+        return;
+    }
+
+    if (!onNewConnection)
+    {
+        // Nobody is listening for connections
+        spdlog::warn("Accepted a connection, but nothing is handling new connections");
+        close(connectionHandle);
+        return;
+    }
+
+    // Create a ConnectionTransport for this new connection
+    auto result = NetworkSocketConnectionTransport::Nonblocking(
+        NetworkSocketConnectionKind::Tcp,
+        connectionHandle,
+        ipv4Address,
+        ipv6Address);
+    if (result.IsError)
+    {
+        spdlog::error(
+            "Failed to create transport for accepted socket: {}",
+            result.ErrorMessage);
+        return;
+    }
+    onNewConnection(std::move(result.Value));
 }
-#pragma endregion ConnectionTransport implementation
\ No newline at end of file
+#pragma endregion Private methods
@@ -7,32 +7,76 @@
 
 #pragma once
 
+#include "ConnectionAdmissionLimiter.h"
 #include "ConnectionListener.h"
+#include "../Utilities/SocketBinding.h"
 
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
 #include <sys/socket.h>
+#include <vector>
 
 /**
  * @brief The TcpConnectionListener listens for incoming TCP connections and outputs
  * a TcpSocketConnectionTransport instance for each new connection.
  * 
+ * With more than one socket, each is bound to the port with SO_REUSEPORT and accepted from on
+ * its own thread, so the kernel spreads incoming connections (and their backlogs) across them.
+ *
+ * Listening on an IPv6 address accepts IPv4 connections too, which are handed off with their
+ * IPv4 address.
  */
 class TcpConnectionListener : public ConnectionListener
 {
 public:
     /* Constructor/Destructor */
+    /**
+     * @param numSockets number of listen sockets (and accept threads) to bind the port with
+     * @param admissionLimiter if set, turns away connections from addresses connecting too often
+     *  before they're handed off
+     * @param adoptedListenHandles listen sockets handed over by another process to accept from,
+     *  instead of binding new ones
+     * @param binding address and interface to listen on, and options accepted connections
+     *  inherit
+     */
     TcpConnectionListener(
         const int listenPort,
-        const int socketQueueLimit = SOMAXCONN);
+        const int socketQueueLimit = SOMAXCONN,
+        const size_t numSockets = 1,
+        std::unique_ptr<ConnectionAdmissionLimiter> admissionLimiter = nullptr,
+        std::vector<int> adoptedListenHandles = {},
+        SocketBinding binding = {});
+    ~TcpConnectionListener();
 
     /* ConnectionTransport implementation */
     void Listen(std::promise<void>&& readyPromise = std::promise<void>()) override;
     void StopListening() override;
     void SetOnNewConnection(
         std::function<void(std::unique_ptr<ConnectionTransport>)> onNewConnection) override;
+    Result<std::vector<int>> DetachListenHandles() override;
 
 private:
+    /* Constants */
+    // How long to back off accepting when we're out of file handles or memory
+    static constexpr std::chrono::milliseconds ACCEPT_ERROR_BACKOFF{100};
+
+    /* Private fields */
     const int listenPort;
     const int socketQueueLimit;
-    int listenSocketHandle = 0;
+    const size_t numSockets;
+    const std::unique_ptr<ConnectionAdmissionLimiter> admissionLimiter;
+    const SocketBinding binding;
+    // Signalled to wake and stop every accept loop
+    const int stopEventHandle;
     std::function<void(std::unique_ptr<ConnectionTransport>)> onNewConnection;
-};
\ No newline at end of file
+    // Sockets being listened on, closed once every accept loop has stopped
+    std::mutex listenSocketMutex;
+    std::vector<int> listenSocketHandles;
+
+    /* Private methods */
+    int openListenSocket(size_t socketIndex);
+    void acceptLoop(int listenSocketHandle);
+    void onConnectionAccepted(int connectionHandle, const sockaddr_storage& acceptAddress);
+};
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "../Utilities/PacketBuffer.h"
 #include "../Utilities/Result.h"
 
 #include <chrono>
@@ -37,6 +38,37 @@ public:
      */
     virtual std::optional<sockaddr_in6> GetAddr6() = 0;
 
+    /**
+     * @brief
+     *  Gets an OS handle (ex. a socket file descriptor) that can be waited on for readability,
+     *  if the transport has one. Transports without one must be read from their own thread.
+     */
+    virtual std::optional<int> GetPollHandle()
+    {
+        return std::nullopt;
+    }
+
+    /**
+     * @brief
+     *  Gets the CPU the kernel last processed a received packet for this connection on, which
+     *  is usually where the interrupts of the NIC receive queue it arrives on are handled,
+     *  if the transport can tell.
+     */
+    virtual std::optional<int> GetIncomingCpu()
+    {
+        return std::nullopt;
+    }
+
+    /**
+     * @brief
+     *  Gets the kernel's smoothed round trip time estimate for this connection, if the
+     *  transport keeps one (ex. TCP)
+     */
+    virtual std::optional<std::chrono::microseconds> GetRoundTripTime()
+    {
+        return std::nullopt;
+    }
+
     /**
      * @brief
      *  Shuts down the connection.
@@ -44,6 +76,18 @@ public:
      */
     virtual void Stop() = 0;
 
+    /**
+     * @brief
+     *  Stops the transport without closing the connection, handing over its OS handle (ex. a
+     *  socket file descriptor) so another process can carry on with it. Transports sharing
+     *  their handle with other connections just stop, leaving it to the owner of the shared
+     *  handle to hand it over. The caller owns the returned handle.
+     */
+    virtual Result<std::optional<int>> Detach()
+    {
+        return Result<std::optional<int>>::Error("This transport can't be handed off");
+    }
+
     /**
      * @brief
         Read a set of bytes from the transport into the given buffer.
@@ -53,6 +97,40 @@ public:
         std::vector<std::byte>& buffer, 
         std::chrono::milliseconds timeout) = 0;
 
+    /**
+     * @brief
+     *  Read as many discrete messages (ex. UDP datagrams) as are available into the given
+     *  buffers, up to the number of buffers provided, with a single wakeup.
+     *  Buffers that are empty handles or are shared with other owners are first replaced with
+     *  fresh buffers from the default PacketBufferPool, so filled buffers can be handed off
+     *  without copying. Each buffer is resized to the length of the message it received.
+     *  Will timeout if there is nothing to read and return zero messages.
+     *  Transports that can't read in batches fall back to a single Read.
+     * @return the number of buffers that were filled
+     */
+    virtual Result<size_t> ReadBatch(
+        std::span<PacketBuffer> buffers,
+        std::chrono::milliseconds timeout)
+    {
+        if (buffers.empty())
+        {
+            return Result<size_t>::Success(0);
+        }
+
+        std::vector<std::byte> readBuffer;
+        Result<ssize_t> readResult = Read(readBuffer, timeout);
+        if (readResult.IsError)
+        {
+            return Result<size_t>::Error(readResult.ErrorMessage);
+        }
+        if (readResult.Value <= 0)
+        {
+            return Result<size_t>::Success(0);
+        }
+        buffers[0] = PacketBuffer::Copy(readBuffer);
+        return Result<size_t>::Success(1);
+    }
+
     /**
      * @brief Write a set of bytes to the transport
      */
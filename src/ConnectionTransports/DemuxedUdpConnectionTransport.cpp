@@ -0,0 +1,222 @@
+/**
+ * @file DemuxedUdpConnectionTransport.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "DemuxedUdpConnectionTransport.h"
+
+#include "UdpMediaDemuxer.h"
+#include "../Utilities/Util.h"
+
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#pragma region Constructor/Destructor
+DemuxedUdpConnectionTransport::DemuxedUdpConnectionTransport(
+    std::shared_ptr<UdpMediaDemuxer> demuxer,
+    IpAddress targetAddr)
+:
+    demuxer(std::move(demuxer)),
+    eventHandle(eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK))),
+    targetAddr(targetAddr)
+{
+    if (eventHandle == -1)
+    {
+        throw std::runtime_error(fmt::format("Could not create eventfd: {}",
+            Util::ErrnoToString(errno)));
+    }
+}
+
+DemuxedUdpConnectionTransport::~DemuxedUdpConnectionTransport()
+{
+    Stop();
+    close(eventHandle);
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool DemuxedUdpConnectionTransport::Deliver(PacketBuffer datagram, uint16_t fromPort)
+{
+    std::scoped_lock lock(mutex);
+    if (isStopped)
+    {
+        return false;
+    }
+
+    // Replies go back to whichever port the peer is sending from
+    targetPort = fromPort;
+    hasTargetPort = true;
+
+    if (queuedDatagrams.size() >= MAX_QUEUED_DATAGRAMS)
+    {
+        if ((droppedDatagrams++ % MAX_QUEUED_DATAGRAMS) == 0)
+        {
+            spdlog::warn("Dropping datagrams from {}, reader is not keeping up ({} dropped)",
+                targetAddr.ToString(), droppedDatagrams);
+        }
+        return false;
+    }
+
+    if (queuedDatagrams.empty())
+    {
+        signalReadable();
+    }
+    queuedDatagrams.push_back(std::move(datagram));
+    return true;
+}
+#pragma endregion Public methods
+
+#pragma region ConnectionTransport Implementation
+std::optional<sockaddr_in> DemuxedUdpConnectionTransport::GetAddr()
+{
+    std::scoped_lock lock(mutex);
+    return targetAddr.ToIpv4(ntohs(targetPort));
+}
+
+std::optional<sockaddr_in6> DemuxedUdpConnectionTransport::GetAddr6()
+{
+    if (targetAddr.GetFamily() != AF_INET6)
+    {
+        return std::nullopt;
+    }
+    std::scoped_lock lock(mutex);
+    return targetAddr.ToIpv6(ntohs(targetPort));
+}
+
+std::optional<int> DemuxedUdpConnectionTransport::GetPollHandle()
+{
+    return eventHandle;
+}
+
+void DemuxedUdpConnectionTransport::Stop()
+{
+    // Once we're unregistered, the demuxer will never deliver to us again
+    demuxer->Unregister(this);
+
+    std::scoped_lock lock(mutex);
+    if (!isStopped)
+    {
+        isStopped = true;
+        queuedDatagrams.clear();
+        // Wake anyone waiting to read so they notice we've stopped
+        signalReadable();
+    }
+}
+
+Result<std::optional<int>> DemuxedUdpConnectionTransport::Detach()
+{
+    // The shared socket is handed off by the demuxer's owner, along with everyone else's media
+    Stop();
+    return Result<std::optional<int>>::Success(std::nullopt);
+}
+
+Result<ssize_t> DemuxedUdpConnectionTransport::Read(
+    std::vector<std::byte>& buffer,
+    std::chrono::milliseconds timeout)
+{
+    buffer.resize(0);
+    if (!waitForDatagrams(timeout))
+    {
+        return Result<ssize_t>::Error("Transport is stopped");
+    }
+
+    PacketBuffer datagram;
+    if (dequeue(std::span(&datagram, 1)) == 0)
+    {
+        return Result<ssize_t>::Success(0);
+    }
+    buffer.assign(datagram.Bytes().begin(), datagram.Bytes().end());
+    return Result<ssize_t>::Success(buffer.size());
+}
+
+Result<size_t> DemuxedUdpConnectionTransport::ReadBatch(
+    std::span<PacketBuffer> buffers,
+    std::chrono::milliseconds timeout)
+{
+    if (!waitForDatagrams(timeout))
+    {
+        return Result<size_t>::Error("Transport is stopped");
+    }
+    return Result<size_t>::Success(dequeue(buffers));
+}
+
+Result<void> DemuxedUdpConnectionTransport::Write(const std::span<const std::byte>& bytes)
+{
+    uint16_t sendToPort = 0;
+    {
+        std::scoped_lock lock(mutex);
+        if (isStopped)
+        {
+            return Result<void>::Error("Transport is stopped");
+        }
+        if (!hasTargetPort)
+        {
+            return Result<void>::Error("Peer port is not known until it sends us a datagram");
+        }
+        sendToPort = ntohs(targetPort);
+    }
+    return demuxer->SendTo(targetAddr, sendToPort, bytes);
+}
+#pragma endregion ConnectionTransport Implementation
+
+#pragma region Private methods
+void DemuxedUdpConnectionTransport::signalReadable()
+{
+    uint64_t signal = 1;
+    if (write(eventHandle, &signal, sizeof(signal)) == -1)
+    {
+        spdlog::warn("Could not signal demuxed transport: {}", Util::ErrnoToString(errno));
+    }
+}
+
+bool DemuxedUdpConnectionTransport::waitForDatagrams(std::chrono::milliseconds timeout)
+{
+    {
+        std::scoped_lock lock(mutex);
+        if (isStopped)
+        {
+            return false;
+        }
+        if (!queuedDatagrams.empty())
+        {
+            return true;
+        }
+    }
+
+    pollfd pollFd
+    {
+        .fd = eventHandle,
+        .events = POLLIN,
+        .revents = 0,
+    };
+    poll(&pollFd, 1, timeout.count());
+
+    std::scoped_lock lock(mutex);
+    return !isStopped;
+}
+
+size_t DemuxedUdpConnectionTransport::dequeue(std::span<PacketBuffer> buffers)
+{
+    std::scoped_lock lock(mutex);
+    size_t count = 0;
+    while ((count < buffers.size()) && !queuedDatagrams.empty())
+    {
+        buffers[count++] = std::move(queuedDatagrams.front());
+        queuedDatagrams.pop_front();
+    }
+
+    if (queuedDatagrams.empty())
+    {
+        // Nothing left, reset the signal so we aren't woken up again until more arrives
+        uint64_t signal;
+        while (read(eventHandle, &signal, sizeof(signal)) > 0)
+        { }
+    }
+    return count;
+}
+#pragma endregion Private methods
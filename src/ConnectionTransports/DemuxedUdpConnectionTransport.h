@@ -0,0 +1,82 @@
+/**
+ * @file DemuxedUdpConnectionTransport.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ConnectionTransport.h"
+
+#include "../Utilities/IpAddress.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+class UdpMediaDemuxer;
+
+/**
+ * @brief
+ *  A ConnectionTransport for one remote UDP peer whose datagrams arrive on a socket shared
+ *  with many other peers. The UdpMediaDemuxer reading the shared socket routes datagrams to
+ *  this transport, where they are queued until read.
+ */
+class DemuxedUdpConnectionTransport : public ConnectionTransport
+{
+public:
+    /* Constructor/Destructor */
+    DemuxedUdpConnectionTransport(
+        std::shared_ptr<UdpMediaDemuxer> demuxer,
+        IpAddress targetAddr);
+    ~DemuxedUdpConnectionTransport() override;
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Queues a datagram received from our peer to be read from this transport.
+     *  Called by the UdpMediaDemuxer.
+     * @param fromPort port the datagram was sent from, in network byte order
+     * @return false if the datagram was dropped because the queue is full or we're stopped
+     */
+    bool Deliver(PacketBuffer datagram, uint16_t fromPort);
+
+    /* ConnectionTransport Implementation */
+    std::optional<sockaddr_in> GetAddr() override;
+    std::optional<sockaddr_in6> GetAddr6() override;
+    std::optional<int> GetPollHandle() override;
+    void Stop() override;
+    Result<std::optional<int>> Detach() override;
+    Result<ssize_t> Read(
+        std::vector<std::byte>& buffer,
+        std::chrono::milliseconds timeout) override;
+    Result<size_t> ReadBatch(
+        std::span<PacketBuffer> buffers,
+        std::chrono::milliseconds timeout) override;
+    Result<void> Write(const std::span<const std::byte>& bytes) override;
+
+private:
+    /* Constants */
+    // Datagrams beyond this are dropped if the reader falls behind
+    static constexpr size_t MAX_QUEUED_DATAGRAMS = 2048;
+
+    /* Private fields */
+    const std::shared_ptr<UdpMediaDemuxer> demuxer;
+    // Signaled while datagrams are queued, so the transport can be waited on like a socket
+    const int eventHandle;
+    std::mutex mutex;
+    const IpAddress targetAddr;
+    // Port the peer last sent from, in network byte order
+    uint16_t targetPort = 0;
+    bool hasTargetPort = false;
+    bool isStopped = false;
+    std::deque<PacketBuffer> queuedDatagrams;
+    size_t droppedDatagrams = 0;
+
+    /* Private methods */
+    void signalReadable();
+    bool waitForDatagrams(std::chrono::milliseconds timeout);
+    size_t dequeue(std::span<PacketBuffer> buffers);
+};
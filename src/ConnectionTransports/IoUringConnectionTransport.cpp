@@ -0,0 +1,695 @@
+/**
+ * @file IoUringConnectionTransport.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "IoUringConnectionTransport.h"
+
+#include "../Utilities/PacketLatencyTracer.h"
+#include "../Utilities/Util.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    // Everything we need from io_uring, which Linux 6.0 has all of
+    constexpr uint32_t REQUIRED_FEATURES =
+        (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG);
+
+    template<typename T>
+    T* ringField(void* ringMemory, uint32_t offset)
+    {
+        return reinterpret_cast<T*>(static_cast<std::byte*>(ringMemory) + offset);
+    }
+
+    unsigned loadAcquire(unsigned* value)
+    {
+        return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(unsigned* value, unsigned newValue)
+    {
+        std::atomic_ref<unsigned>(*value).store(newValue, std::memory_order_release);
+    }
+}
+
+#pragma region Static methods
+Result<std::unique_ptr<IoUringConnectionTransport>> IoUringConnectionTransport::Create(
+    int socketHandle,
+    std::optional<sockaddr_in> targetAddr,
+    std::optional<sockaddr_in6> targetAddr6)
+{
+    auto transport = std::make_unique<IoUringConnectionTransport>(socketHandle, targetAddr,
+        targetAddr6);
+    Result<void> setUpResult = transport->setUpRing();
+    if (setUpResult.IsError)
+    {
+        // Leave the socket to the caller
+        transport->socketHandle = -1;
+        return Result<std::unique_ptr<IoUringConnectionTransport>>::Error(
+            setUpResult.ErrorMessage);
+    }
+
+    // The same goes for a socket that's already been handed to us open for blocking reads
+    int socketFlags = fcntl(socketHandle, F_GETFL, 0);
+    if ((socketFlags == -1) || (fcntl(socketHandle, F_SETFL, (socketFlags | O_NONBLOCK)) != 0))
+    {
+        int error = errno;
+        transport->socketHandle = -1;
+        return Result<std::unique_ptr<IoUringConnectionTransport>>::Error(fmt::format(
+            "Could not set socket to non-blocking mode. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+    return Result<std::unique_ptr<IoUringConnectionTransport>>::Success(std::move(transport));
+}
+#pragma endregion Static methods
+
+#pragma region Constructor/Destructor
+IoUringConnectionTransport::IoUringConnectionTransport(
+    int socketHandle,
+    std::optional<sockaddr_in> targetAddr,
+    std::optional<sockaddr_in6> targetAddr6)
+:
+    socketHandle(socketHandle),
+    targetAddr(targetAddr),
+    targetAddr6(targetAddr6),
+    expectedAddr(IpAddress::FromSockaddr(targetAddr, targetAddr6)),
+    receiveBuffers(RECEIVE_BUFFER_COUNT)
+{ }
+
+IoUringConnectionTransport::~IoUringConnectionTransport()
+{
+    Stop();
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Getters/Setters
+uint64_t IoUringConnectionTransport::GetDiscardedPacketCount() const
+{
+    return discardedPacketCount.load(std::memory_order_relaxed);
+}
+
+uint64_t IoUringConnectionTransport::GetSyscallCount() const
+{
+    return syscallCount.load(std::memory_order_relaxed);
+}
+#pragma endregion Getters/Setters
+
+#pragma region ConnectionTransport Implementation
+std::optional<sockaddr_in> IoUringConnectionTransport::GetAddr()
+{
+    if (!targetAddr.has_value())
+    {
+        return std::nullopt;
+    }
+    sockaddr_in addr = targetAddr.value();
+    addr.sin_port = targetPort.load(std::memory_order_relaxed);
+    return addr;
+}
+
+std::optional<sockaddr_in6> IoUringConnectionTransport::GetAddr6()
+{
+    if (!targetAddr6.has_value())
+    {
+        return std::nullopt;
+    }
+    sockaddr_in6 addr = targetAddr6.value();
+    addr.sin6_port = targetPort.load(std::memory_order_relaxed);
+    return addr;
+}
+
+std::optional<int> IoUringConnectionTransport::GetPollHandle()
+{
+    return ringHandle;
+}
+
+std::optional<int> IoUringConnectionTransport::GetIncomingCpu()
+{
+    int incomingCpu = -1;
+    socklen_t optionLength = sizeof(incomingCpu);
+    if ((getsockopt(socketHandle, SOL_SOCKET, SO_INCOMING_CPU, &incomingCpu,
+        &optionLength) != 0) || (incomingCpu < 0))
+    {
+        return std::nullopt;
+    }
+    return incomingCpu;
+}
+
+void IoUringConnectionTransport::Stop()
+{
+    std::scoped_lock lock(readMutex, submitMutex);
+    if (!isStopped)
+    {
+        tearDownRing();
+        if (socketHandle >= 0)
+        {
+            shutdown(socketHandle, SHUT_RDWR);
+            close(socketHandle);
+        }
+    }
+    isStopped = true;
+}
+
+Result<std::optional<int>> IoUringConnectionTransport::Detach()
+{
+    // Datagrams the kernel hasn't handed to us yet stay queued on the socket for whoever
+    // takes it next
+    std::scoped_lock lock(readMutex, submitMutex);
+    if (isStopped)
+    {
+        return Result<std::optional<int>>::Error("Transport has already stopped");
+    }
+    tearDownRing();
+    isStopped = true;
+    return Result<std::optional<int>>::Success(socketHandle);
+}
+
+Result<ssize_t> IoUringConnectionTransport::Read(
+    std::vector<std::byte>& buffer, std::chrono::milliseconds timeout)
+{
+    PacketBuffer datagram;
+    Result<size_t> readResult = ReadBatch(std::span<PacketBuffer>(&datagram, 1), timeout);
+    if (readResult.IsError)
+    {
+        buffer.resize(0);
+        return Result<ssize_t>::Error(readResult.ErrorMessage);
+    }
+    if (readResult.Value == 0)
+    {
+        buffer.resize(0);
+        return Result<ssize_t>::Success(0);
+    }
+    buffer.assign(datagram.Bytes().begin(), datagram.Bytes().end());
+    return Result<ssize_t>::Success(datagram.Size());
+}
+
+Result<size_t> IoUringConnectionTransport::ReadBatch(
+    std::span<PacketBuffer> buffers, std::chrono::milliseconds timeout)
+{
+    std::scoped_lock lock(readMutex);
+    if (isStopped)
+    {
+        return Result<size_t>::Error("Transport is stopped");
+    }
+    if (buffers.empty())
+    {
+        return Result<size_t>::Success(0);
+    }
+
+    // Completions that are already waiting don't need the kernel's help to pick up
+    size_t buffersFilled = reapCompletions(buffers);
+    if ((buffersFilled == 0) && !receiveError.has_value())
+    {
+        if (isReceiveArmed && (timeout.count() > 0))
+        {
+            enter(0, 1, IORING_ENTER_GETEVENTS, timeout);
+        }
+        else if ((loadAcquire(submissionFlags) & IORING_SQ_CQ_OVERFLOW) != 0)
+        {
+            // More completions than fit in the queue were held back by the kernel
+            enter(0, 0, IORING_ENTER_GETEVENTS);
+        }
+        buffersFilled = reapCompletions(buffers);
+    }
+
+    if (receiveError.has_value())
+    {
+        return Result<size_t>::Error(fmt::format("Couldn't read from socket. Error {}: {}",
+            receiveError.value(), Util::ErrnoToString(receiveError.value())));
+    }
+    if (!isReceiveArmed)
+    {
+        // We ran out of buffers at some point, now that we've given them back, carry on
+        std::scoped_lock submitLock(submitMutex);
+        Result<void> armResult = armReceive();
+        if (armResult.IsError)
+        {
+            return Result<size_t>::Error(armResult.ErrorMessage);
+        }
+    }
+
+    PacketLatencyTracer::StampReceived(buffers.first(buffersFilled));
+    return Result<size_t>::Success(buffersFilled);
+}
+
+Result<void> IoUringConnectionTransport::Write(const std::span<const std::byte>& bytes)
+{
+    std::scoped_lock lock(submitMutex);
+    if (isStopped)
+    {
+        return Result<void>::Error("Transport is stopped");
+    }
+
+    io_uring_sqe* entry = getSubmissionEntry();
+    if (entry == nullptr)
+    {
+        return Result<void>::Error("Submission queue is full");
+    }
+
+    // The kernel reads our bytes whenever it gets around to sending them, so hang on to a
+    // copy until it tells us it's done
+    auto send = std::make_unique<PendingSend>();
+    send->Bytes = PacketBuffer::Copy(bytes);
+    send->Iov = {
+        .iov_base = const_cast<std::byte*>(send->Bytes.Data()),
+        .iov_len = send->Bytes.Size(),
+    };
+    send->Message.msg_iov = &send->Iov;
+    send->Message.msg_iovlen = 1;
+    if (std::optional<sockaddr_in> addr = GetAddr())
+    {
+        std::memcpy(&send->Addr, &addr.value(), sizeof(addr.value()));
+        send->Message.msg_name = &send->Addr;
+        send->Message.msg_namelen = sizeof(addr.value());
+    }
+    else if (std::optional<sockaddr_in6> addr6 = GetAddr6())
+    {
+        std::memcpy(&send->Addr, &addr6.value(), sizeof(addr6.value()));
+        send->Message.msg_name = &send->Addr;
+        send->Message.msg_namelen = sizeof(addr6.value());
+    }
+
+    entry->opcode = IORING_OP_SENDMSG;
+    entry->fd = socketHandle;
+    entry->addr = reinterpret_cast<uint64_t>(&send->Message);
+    entry->len = 1;
+    entry->user_data = nextSendUserData++;
+    {
+        std::scoped_lock sendLock(sendMutex);
+        pendingSends.emplace(entry->user_data, std::move(send));
+    }
+    return submit(entry);
+}
+#pragma endregion ConnectionTransport Implementation
+
+#pragma region Private methods
+Result<void> IoUringConnectionTransport::setUpRing()
+{
+    io_uring_params params {};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = COMPLETION_ENTRIES;
+    ringHandle = syscall(__NR_io_uring_setup, SUBMISSION_ENTRIES, &params);
+    if (ringHandle < 0)
+    {
+        int error = errno;
+        ringHandle = -1;
+        return Result<void>::Error(fmt::format("Could not set up io_uring. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+    if ((params.features & REQUIRED_FEATURES) != REQUIRED_FEATURES)
+    {
+        return Result<void>::Error("Kernel's io_uring is too old");
+    }
+
+    // The submission and completion rings share one mapping, the entries get their own
+    ringMemorySize = std::max<size_t>(
+        (params.sq_off.array + (params.sq_entries * sizeof(unsigned))),
+        (params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe))));
+    ringMemory = mmap(nullptr, ringMemorySize, (PROT_READ | PROT_WRITE),
+        (MAP_SHARED | MAP_POPULATE), ringHandle, IORING_OFF_SQ_RING);
+    if (ringMemory == MAP_FAILED)
+    {
+        int error = errno;
+        ringMemory = nullptr;
+        return Result<void>::Error(fmt::format("Could not map io_uring. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+    submissionEntriesSize = (params.sq_entries * sizeof(io_uring_sqe));
+    void* entriesMemory = mmap(nullptr, submissionEntriesSize, (PROT_READ | PROT_WRITE),
+        (MAP_SHARED | MAP_POPULATE), ringHandle, IORING_OFF_SQES);
+    if (entriesMemory == MAP_FAILED)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format(
+            "Could not map io_uring submission entries. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+    submissionEntries = static_cast<io_uring_sqe*>(entriesMemory);
+    submissionHead = ringField<unsigned>(ringMemory, params.sq_off.head);
+    submissionTail = ringField<unsigned>(ringMemory, params.sq_off.tail);
+    submissionFlags = ringField<unsigned>(ringMemory, params.sq_off.flags);
+    submissionArray = ringField<unsigned>(ringMemory, params.sq_off.array);
+    submissionMask = *ringField<unsigned>(ringMemory, params.sq_off.ring_mask);
+    completionHead = ringField<unsigned>(ringMemory, params.cq_off.head);
+    completionTail = ringField<unsigned>(ringMemory, params.cq_off.tail);
+    completionEntries = ringField<io_uring_cqe>(ringMemory, params.cq_off.cqes);
+    completionMask = *ringField<unsigned>(ringMemory, params.cq_off.ring_mask);
+
+    // The kernel picks buffers to receive into from a ring of pooled buffers we keep full
+    void* bufferRingMemory = mmap(nullptr, (RECEIVE_BUFFER_COUNT * sizeof(io_uring_buf)),
+        (PROT_READ | PROT_WRITE), (MAP_ANONYMOUS | MAP_PRIVATE), -1, 0);
+    if (bufferRingMemory == MAP_FAILED)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format(
+            "Could not allocate io_uring buffer ring. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+    bufferRing = static_cast<io_uring_buf_ring*>(bufferRingMemory);
+    io_uring_buf_reg bufferRingRegistration
+    {
+        .ring_addr = reinterpret_cast<uint64_t>(bufferRing),
+        .ring_entries = RECEIVE_BUFFER_COUNT,
+        .bgid = RECEIVE_BUFFER_GROUP,
+    };
+    if (syscall(__NR_io_uring_register, ringHandle, IORING_REGISTER_PBUF_RING,
+        &bufferRingRegistration, 1) != 0)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format(
+            "Could not register io_uring buffer ring. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+    isBufferRingRegistered = true;
+    for (uint16_t bufferId = 0; bufferId < RECEIVE_BUFFER_COUNT; ++bufferId)
+    {
+        provideBuffer(bufferId);
+    }
+
+    // Each datagram lands behind a header and its source address, laid out as described here
+    receiveMessage.msg_namelen = sizeof(sockaddr_in6);
+    Result<void> armResult = armReceive();
+    if (armResult.IsError)
+    {
+        return armResult;
+    }
+
+    // Kernels without multishot receives turn ours down straight away
+    reapCompletions({});
+    if (receiveError.has_value() || !isReceiveArmed)
+    {
+        return Result<void>::Error(fmt::format(
+            "Kernel doesn't support multishot io_uring receives. Error {}: {}",
+            receiveError.value_or(0), Util::ErrnoToString(receiveError.value_or(0))));
+    }
+    return Result<void>::Success();
+}
+
+void IoUringConnectionTransport::tearDownRing()
+{
+    if (ringHandle < 0)
+    {
+        return;
+    }
+
+    // The kernel may still be writing into our buffers or reading our writes, so make sure
+    // it's done with them before they go back to the pool
+    const bool isRingMapped = ((ringMemory != nullptr) && (submissionEntries != nullptr));
+    if (isRingMapped && isReceiveArmed)
+    {
+        if (io_uring_sqe* entry = getSubmissionEntry())
+        {
+            entry->opcode = IORING_OP_ASYNC_CANCEL;
+            entry->fd = -1;
+            entry->addr = RECEIVE_USER_DATA;
+            entry->user_data = CANCEL_USER_DATA;
+            submit(entry);
+        }
+    }
+    std::vector<PacketBuffer> discardedBuffers(RECEIVE_BUFFER_COUNT);
+    const auto stopDeadline = std::chrono::steady_clock::now() + STOP_TIMEOUT;
+    while (isRingMapped)
+    {
+        reapCompletions(discardedBuffers);
+        bool hasPendingSends = false;
+        {
+            std::scoped_lock sendLock(sendMutex);
+            hasPendingSends = !pendingSends.empty();
+        }
+        if (!isReceiveArmed && !hasPendingSends)
+        {
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= stopDeadline)
+        {
+            // Leak what the kernel holds rather than risk it writing into reused buffers
+            spdlog::error("io_uring transport didn't stop in time, abandoning its buffers");
+            for (PacketBuffer& buffer : receiveBuffers)
+            {
+                new PacketBuffer(std::move(buffer));
+            }
+            std::scoped_lock sendLock(sendMutex);
+            for (auto& [userData, send] : pendingSends)
+            {
+                send.release();
+            }
+            pendingSends.clear();
+            break;
+        }
+        enter(0, 1, IORING_ENTER_GETEVENTS, std::chrono::milliseconds(10));
+    }
+
+    if (isBufferRingRegistered)
+    {
+        io_uring_buf_reg bufferRingRegistration { .bgid = RECEIVE_BUFFER_GROUP };
+        syscall(__NR_io_uring_register, ringHandle, IORING_UNREGISTER_PBUF_RING,
+            &bufferRingRegistration, 1);
+        isBufferRingRegistered = false;
+    }
+    if (bufferRing != nullptr)
+    {
+        munmap(bufferRing, (RECEIVE_BUFFER_COUNT * sizeof(io_uring_buf)));
+        bufferRing = nullptr;
+    }
+    if (submissionEntries != nullptr)
+    {
+        munmap(submissionEntries, submissionEntriesSize);
+        submissionEntries = nullptr;
+    }
+    if (ringMemory != nullptr)
+    {
+        munmap(ringMemory, ringMemorySize);
+        ringMemory = nullptr;
+    }
+    close(ringHandle);
+    ringHandle = -1;
+    receiveBuffers.clear();
+}
+
+int IoUringConnectionTransport::enter(unsigned toSubmit, unsigned minComplete, unsigned flags,
+    std::optional<std::chrono::milliseconds> timeout)
+{
+    syscallCount.fetch_add(1, std::memory_order_relaxed);
+    if (!timeout.has_value())
+    {
+        return syscall(__NR_io_uring_enter, ringHandle, toSubmit, minComplete, flags, nullptr,
+            0);
+    }
+
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout.value());
+    __kernel_timespec timeoutSpec
+    {
+        .tv_sec = seconds.count(),
+        .tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            timeout.value() - seconds).count(),
+    };
+    io_uring_getevents_arg arg
+    {
+        .sigmask = 0,
+        .sigmask_sz = (_NSIG / 8),
+        .ts = reinterpret_cast<uint64_t>(&timeoutSpec),
+    };
+    // Timing out (ETIME) or being interrupted just means there's nothing to read yet
+    return syscall(__NR_io_uring_enter, ringHandle, toSubmit, minComplete,
+        (flags | IORING_ENTER_EXT_ARG), &arg, sizeof(arg));
+}
+
+io_uring_sqe* IoUringConnectionTransport::getSubmissionEntry()
+{
+    // We submit every entry as soon as it's filled in, so an entry is only still queued if
+    // the kernel hasn't got to it yet
+    const unsigned tail = *submissionTail;
+    if ((tail - loadAcquire(submissionHead)) > submissionMask)
+    {
+        return nullptr;
+    }
+    io_uring_sqe* entry = &submissionEntries[tail & submissionMask];
+    std::memset(entry, 0, sizeof(*entry));
+    return entry;
+}
+
+Result<void> IoUringConnectionTransport::submit(io_uring_sqe* entry)
+{
+    const unsigned tail = *submissionTail;
+    submissionArray[tail & submissionMask] = static_cast<unsigned>(entry - submissionEntries);
+    storeRelease(submissionTail, (tail + 1));
+    while (enter(1, 0, 0) < 0)
+    {
+        int error = errno;
+        if (error != EINTR)
+        {
+            return Result<void>::Error(fmt::format(
+                "Could not submit to io_uring. Error {}: {}", error,
+                Util::ErrnoToString(error)));
+        }
+    }
+    return Result<void>::Success();
+}
+
+Result<void> IoUringConnectionTransport::armReceive()
+{
+    io_uring_sqe* entry = getSubmissionEntry();
+    if (entry == nullptr)
+    {
+        return Result<void>::Error("Submission queue is full");
+    }
+    entry->opcode = IORING_OP_RECVMSG;
+    entry->fd = socketHandle;
+    entry->addr = reinterpret_cast<uint64_t>(&receiveMessage);
+    entry->len = 1;
+    entry->ioprio = IORING_RECV_MULTISHOT;
+    entry->flags = IOSQE_BUFFER_SELECT;
+    entry->buf_group = RECEIVE_BUFFER_GROUP;
+    entry->user_data = RECEIVE_USER_DATA;
+    isReceiveArmed = true;
+    return submit(entry);
+}
+
+void IoUringConnectionTransport::provideBuffer(uint16_t bufferId)
+{
+    PacketBuffer& buffer = receiveBuffers[bufferId];
+    if (!buffer.IsUnique())
+    {
+        buffer = PacketBufferPool::Default().Acquire();
+    }
+    // Entries start at the top of the ring, overlapping its tail. Compiled as C++, the header's
+    // flexible array member is pushed past that, so index them ourselves.
+    io_uring_buf* ringEntries = reinterpret_cast<io_uring_buf*>(bufferRing);
+    io_uring_buf& ringEntry = ringEntries[bufferRingTail & (RECEIVE_BUFFER_COUNT - 1)];
+    ringEntry.addr = reinterpret_cast<uint64_t>(buffer.Data());
+    ringEntry.len = buffer.Capacity();
+    ringEntry.bid = bufferId;
+    ++bufferRingTail;
+    std::atomic_ref<uint16_t>(bufferRing->tail).store(bufferRingTail, std::memory_order_release);
+}
+
+size_t IoUringConnectionTransport::reapCompletions(std::span<PacketBuffer> buffers)
+{
+    size_t buffersFilled = 0;
+    unsigned head = *completionHead;
+    const unsigned tail = loadAcquire(completionTail);
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe& completion = completionEntries[head & completionMask];
+        if (completion.user_data == RECEIVE_USER_DATA)
+        {
+            if ((completion.flags & IORING_CQE_F_BUFFER) != 0)
+            {
+                if (buffersFilled == buffers.size())
+                {
+                    // Leave the rest for the next read
+                    break;
+                }
+                if (takeDatagram(completion, buffers[buffersFilled]))
+                {
+                    ++buffersFilled;
+                }
+            }
+            if ((completion.flags & IORING_CQE_F_MORE) == 0)
+            {
+                isReceiveArmed = false;
+                // Running out of buffers or being cancelled (ex. the thread that armed the
+                // receive has exited) isn't a reason to stop reading
+                if ((completion.res < 0) && (completion.res != -ENOBUFS) &&
+                    (completion.res != -ECANCELED))
+                {
+                    receiveError = -completion.res;
+                }
+            }
+        }
+        else if (completion.user_data >= FIRST_SEND_USER_DATA)
+        {
+            if (completion.res < 0)
+            {
+                spdlog::debug("Couldn't send on io_uring transport. Error {}: {}",
+                    -completion.res, Util::ErrnoToString(-completion.res));
+            }
+            std::scoped_lock sendLock(sendMutex);
+            pendingSends.erase(completion.user_data);
+        }
+    }
+    storeRelease(completionHead, head);
+    return buffersFilled;
+}
+
+bool IoUringConnectionTransport::takeDatagram(const io_uring_cqe& completion,
+    PacketBuffer& buffer)
+{
+    const uint16_t bufferId = static_cast<uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+    PacketBuffer datagram = std::move(receiveBuffers[bufferId]);
+    // Hand the kernel a fresh buffer in its place straight away
+    provideBuffer(bufferId);
+    if (completion.res < static_cast<int>(sizeof(io_uring_recvmsg_out)))
+    {
+        return false;
+    }
+
+    const std::byte* received = datagram.Data();
+    io_uring_recvmsg_out header;
+    std::memcpy(&header, received, sizeof(header));
+    const size_t payloadOffset = (sizeof(header) + receiveMessage.msg_namelen +
+        receiveMessage.msg_controllen);
+    if ((static_cast<size_t>(completion.res) < payloadOffset) ||
+        ((header.flags & MSG_TRUNC) != 0) ||
+        (header.payloadlen != (completion.res - payloadOffset)))
+    {
+        // Too big for the buffer, better dropped than passed on cut short
+        return false;
+    }
+
+    if (expectedAddr.has_value())
+    {
+        sockaddr_storage fromStorage {};
+        std::memcpy(&fromStorage, (received + sizeof(header)),
+            std::min<size_t>(header.namelen, receiveMessage.msg_namelen));
+        std::optional<IpAddress> fromAddr = IpAddress::FromSockaddr(fromStorage);
+        if (fromAddr != expectedAddr)
+        {
+            recordDiscardedPacket(fromAddr);
+            return false;
+        }
+        // Reply to whichever port they're sending from
+        targetPort.store(IpAddress::GetPort(fromStorage), std::memory_order_relaxed);
+    }
+    if (header.payloadlen == 0)
+    {
+        return false;
+    }
+
+    // The payload comes after the address, slide it to the front where readers expect it
+    std::memmove(datagram.Data(), (datagram.Data() + payloadOffset), header.payloadlen);
+    datagram.Resize(header.payloadlen);
+    buffer = std::move(datagram);
+    return true;
+}
+
+void IoUringConnectionTransport::recordDiscardedPacket(const std::optional<IpAddress>& fromAddr)
+{
+    const uint64_t totalPackets = discardedPacketCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // A misbehaving or spoofing peer can send us a lot of junk, so only log a summary
+    // every so often instead of once per datagram.
+    const auto now = std::chrono::steady_clock::now();
+    if ((loggedDiscardedPacketCount != 0) && ((now - lastDiscardLogTime) < DISCARD_LOG_INTERVAL))
+    {
+        return;
+    }
+    spdlog::warn(
+        "Discarded {} packets received from unexpected address(es) such as {}, expected {} "
+        "({} packets total)",
+        (totalPackets - loggedDiscardedPacketCount),
+        fromAddr.has_value() ? fromAddr->ToString() : "UNKNOWN", expectedAddr->ToString(),
+        totalPackets);
+    loggedDiscardedPacketCount = totalPackets;
+    lastDiscardLogTime = now;
+}
+#pragma endregion Private methods
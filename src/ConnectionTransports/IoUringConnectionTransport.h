@@ -0,0 +1,168 @@
+/**
+ * @file IoUringConnectionTransport.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ConnectionTransport.h"
+
+#include "../Utilities/IpAddress.h"
+#include "../Utilities/Result.h"
+
+#include <atomic>
+#include <chrono>
+#include <linux/io_uring.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  Implementation of ConnectionTransport for a UDP socket read with io_uring. A single
+ *  multishot receive keeps pulling datagrams into pooled PacketBuffers handed to the kernel
+ *  through a provided buffer ring, so reading datagrams that have already arrived is just a
+ *  matter of picking up their completions, without a syscall. Writes are sent through the
+ *  same ring. The ring's handle is readable while completions are waiting, so the transport
+ *  can be polled like a socket.
+ *  Needs Linux 6.0 or later, NetworkSocketConnectionTransport works everywhere else.
+ */
+class IoUringConnectionTransport : public ConnectionTransport
+{
+public:
+    /* Static methods */
+    /**
+     * @brief
+     *  Sets up a ring reading the given UDP socket, taking ownership of the socket if it
+     *  succeeds. On failure (ex. the kernel doesn't support everything we need) the socket is
+     *  left open, so the caller can fall back to another transport.
+     * @param targetAddr
+     *  if set, datagrams from other addresses are discarded, and writes are sent to it (on the
+     *  port it last sent from)
+     * @param targetAddr6 the same, for a peer that only has an IPv6 address
+     */
+    static Result<std::unique_ptr<IoUringConnectionTransport>> Create(
+        int socketHandle,
+        std::optional<sockaddr_in> targetAddr = std::nullopt,
+        std::optional<sockaddr_in6> targetAddr6 = std::nullopt);
+
+    /* Constructor/Destructor */
+    IoUringConnectionTransport(int socketHandle, std::optional<sockaddr_in> targetAddr,
+        std::optional<sockaddr_in6> targetAddr6 = std::nullopt);
+    ~IoUringConnectionTransport() override;
+
+    /* Getters/Setters */
+    /**
+     * @brief Number of datagrams discarded after being received from an unexpected address
+     */
+    uint64_t GetDiscardedPacketCount() const;
+    /**
+     * @brief Number of times we've had to enter the kernel, to wait or to submit requests
+     */
+    uint64_t GetSyscallCount() const;
+
+    /* ConnectionTransport Implementation */
+    std::optional<sockaddr_in> GetAddr() override;
+    std::optional<sockaddr_in6> GetAddr6() override;
+    std::optional<int> GetPollHandle() override;
+    std::optional<int> GetIncomingCpu() override;
+    void Stop() override;
+    Result<std::optional<int>> Detach() override;
+    Result<ssize_t> Read(
+        std::vector<std::byte>& buffer,
+        std::chrono::milliseconds timeout) override;
+    Result<size_t> ReadBatch(
+        std::span<PacketBuffer> buffers,
+        std::chrono::milliseconds timeout) override;
+    Result<void> Write(const std::span<const std::byte>& bytes) override;
+
+private:
+    /* Private types */
+    // A write the kernel may still be reading from
+    struct PendingSend
+    {
+        PacketBuffer Bytes;
+        sockaddr_storage Addr {};
+        iovec Iov {};
+        msghdr Message {};
+    };
+
+    /* Private constants */
+    static constexpr unsigned SUBMISSION_ENTRIES = 64;
+    static constexpr unsigned COMPLETION_ENTRIES = 512;
+    // Buffers the kernel can receive into before we pick them up, must be a power of 2
+    static constexpr unsigned RECEIVE_BUFFER_COUNT = 128;
+    static constexpr uint16_t RECEIVE_BUFFER_GROUP = 0;
+    static constexpr uint64_t RECEIVE_USER_DATA = 1;
+    static constexpr uint64_t CANCEL_USER_DATA = 2;
+    // Writes are numbered from here, so they can be told apart from everything else
+    static constexpr uint64_t FIRST_SEND_USER_DATA = 16;
+    // Longest we wait for the kernel to let go of our buffers when stopping
+    static constexpr std::chrono::milliseconds STOP_TIMEOUT { 1000 };
+    // Minimum time between log messages about discarded datagrams
+    static constexpr std::chrono::seconds DISCARD_LOG_INTERVAL { 10 };
+
+    /* Private fields */
+    int socketHandle;
+    const std::optional<sockaddr_in> targetAddr;
+    const std::optional<sockaddr_in6> targetAddr6;
+    // Address of whichever target we have, to compare each datagram's source against
+    const std::optional<IpAddress> expectedAddr;
+    // Port the target last sent from, in network byte order
+    std::atomic<uint16_t> targetPort { 0 };
+    int ringHandle = -1;
+    bool isStopped = false;
+    std::atomic<uint64_t> discardedPacketCount { 0 };
+    std::atomic<uint64_t> syscallCount { 0 };
+    // Ring memory shared with the kernel
+    void* ringMemory = nullptr;
+    size_t ringMemorySize = 0;
+    io_uring_sqe* submissionEntries = nullptr;
+    size_t submissionEntriesSize = 0;
+    unsigned* submissionHead = nullptr;
+    unsigned* submissionTail = nullptr;
+    unsigned* submissionFlags = nullptr;
+    unsigned* submissionArray = nullptr;
+    unsigned submissionMask = 0;
+    unsigned* completionHead = nullptr;
+    unsigned* completionTail = nullptr;
+    io_uring_cqe* completionEntries = nullptr;
+    unsigned completionMask = 0;
+    io_uring_buf_ring* bufferRing = nullptr;
+    bool isBufferRingRegistered = false;
+    // Guards the receive buffers and completion queue
+    std::mutex readMutex;
+    // Buffer handed to the kernel under each buffer ID
+    std::vector<PacketBuffer> receiveBuffers;
+    uint16_t bufferRingTail = 0;
+    bool isReceiveArmed = false;
+    std::optional<int> receiveError;
+    // Header the multishot receive lays out each datagram's address with
+    msghdr receiveMessage {};
+    uint64_t loggedDiscardedPacketCount = 0;
+    std::chrono::steady_clock::time_point lastDiscardLogTime;
+    // Guards the submission queue
+    std::mutex submitMutex;
+    // Guards writes waiting on the kernel, taken after submitMutex
+    std::mutex sendMutex;
+    std::unordered_map<uint64_t, std::unique_ptr<PendingSend>> pendingSends;
+    uint64_t nextSendUserData = FIRST_SEND_USER_DATA;
+
+    /* Private methods */
+    Result<void> setUpRing();
+    void tearDownRing();
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags,
+        std::optional<std::chrono::milliseconds> timeout = std::nullopt);
+    io_uring_sqe* getSubmissionEntry();
+    Result<void> submit(io_uring_sqe* entry);
+    Result<void> armReceive();
+    void provideBuffer(uint16_t bufferId);
+    size_t reapCompletions(std::span<PacketBuffer> buffers);
+    bool takeDatagram(const io_uring_cqe& completion, PacketBuffer& buffer);
+    void recordDiscardedPacket(const std::optional<IpAddress>& fromAddr);
+};
@@ -7,9 +7,16 @@
 
 #include "NetworkSocketConnectionTransport.h"
 
+#include "../Utilities/IpAddress.h"
+#include "../Utilities/PacketLatencyTracer.h"
 #include "../Utilities/Util.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <fcntl.h>
+#include <linux/filter.h>
+#include <netinet/tcp.h>
 #include <poll.h>
 #include <spdlog/spdlog.h>
 #include <stdexcept>
@@ -20,7 +27,8 @@
 Result<std::unique_ptr<NetworkSocketConnectionTransport>> NetworkSocketConnectionTransport::Nonblocking(
     NetworkSocketConnectionKind kind,
     int socketHandle,
-    std::optional<sockaddr_in> targetAddr)
+    std::optional<sockaddr_in> targetAddr,
+    std::optional<sockaddr_in6> targetAddr6)
 {
     // First, set the socket to non-blocking IO mode
     int socketFlags = fcntl(socketHandle, F_GETFL, 0);
@@ -47,19 +55,92 @@ Result<std::unique_ptr<NetworkSocketConnectionTransport>> NetworkSocketConnectio
     }
 
     return Result<std::unique_ptr<NetworkSocketConnectionTransport>>::Success(
-        std::make_unique<NetworkSocketConnectionTransport>(kind, socketHandle, targetAddr)
+        std::make_unique<NetworkSocketConnectionTransport>(kind, socketHandle, targetAddr,
+            targetAddr6)
     );
 }
+
+Result<void> NetworkSocketConnectionTransport::AttachSourceFilter(int socketHandle,
+    const sockaddr_in& targetAddr)
+{
+    // Load the IPv4 source address out of the network header, then accept the whole datagram
+    // if it matches our target or drop it otherwise. BPF loads are in host byte order.
+    const uint32_t expectedAddr = ntohl(targetAddr.sin_addr.s_addr);
+    sock_filter filterCode[]
+    {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_NET_OFF + 12)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, expectedAddr, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+    sock_fprog filterProgram
+    {
+        .len = static_cast<unsigned short>(std::size(filterCode)),
+        .filter = filterCode,
+    };
+    if (setsockopt(socketHandle, SOL_SOCKET, SO_ATTACH_FILTER, &filterProgram,
+        sizeof(filterProgram)) != 0)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format(
+            "Could not attach source filter to socket. Error {}: {}",
+            error,
+            Util::ErrnoToString(error)));
+    }
+
+    return Result<void>::Success();
+}
+
+Result<void> NetworkSocketConnectionTransport::AttachSourceFilter(int socketHandle,
+    const sockaddr_in6& targetAddr)
+{
+    // The IPv6 source address is the four words after the first eight bytes of the network
+    // header. Each word that doesn't match jumps straight to the drop at the end.
+    constexpr uint32_t SOURCE_ADDR_OFFSET = 8;
+    constexpr uint8_t WORD_COUNT = sizeof(in6_addr) / sizeof(uint32_t);
+    std::array<sock_filter, (WORD_COUNT * 2) + 2> filterCode {};
+    for (uint8_t i = 0; i < WORD_COUNT; ++i)
+    {
+        uint32_t expectedWord;
+        std::memcpy(&expectedWord, &targetAddr.sin6_addr.s6_addr[i * sizeof(uint32_t)],
+            sizeof(expectedWord));
+        const uint8_t instructionsToDrop = ((WORD_COUNT - i - 1) * 2) + 1;
+        filterCode[i * 2] = BPF_STMT(BPF_LD | BPF_W | BPF_ABS,
+            static_cast<uint32_t>(SKF_NET_OFF + SOURCE_ADDR_OFFSET + (i * sizeof(uint32_t))));
+        filterCode[(i * 2) + 1] = BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ntohl(expectedWord), 0,
+            instructionsToDrop);
+    }
+    filterCode[WORD_COUNT * 2] = BPF_STMT(BPF_RET | BPF_K, 0xFFFFFFFF);
+    filterCode[(WORD_COUNT * 2) + 1] = BPF_STMT(BPF_RET | BPF_K, 0);
+    sock_fprog filterProgram
+    {
+        .len = static_cast<unsigned short>(filterCode.size()),
+        .filter = filterCode.data(),
+    };
+    if (setsockopt(socketHandle, SOL_SOCKET, SO_ATTACH_FILTER, &filterProgram,
+        sizeof(filterProgram)) != 0)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format(
+            "Could not attach source filter to socket. Error {}: {}",
+            error,
+            Util::ErrnoToString(error)));
+    }
+
+    return Result<void>::Success();
+}
 #pragma endregion Public Members
 
 #pragma region Constructor/Destructor
 NetworkSocketConnectionTransport::NetworkSocketConnectionTransport(
     NetworkSocketConnectionKind kind,
     int socketHandle,
-    std::optional<sockaddr_in> targetAddr) : 
+    std::optional<sockaddr_in> targetAddr,
+    std::optional<sockaddr_in6> targetAddr6) : 
     connectionKind(kind),
     socketHandle(socketHandle),
-    targetAddr(targetAddr)
+    targetAddr(targetAddr),
+    targetAddr6(targetAddr6)
 {
 }
 
@@ -69,6 +150,32 @@ NetworkSocketConnectionTransport::~NetworkSocketConnectionTransport()
 }
 #pragma endregion Constructor/Destructor
 
+#pragma region Public methods
+Result<void> NetworkSocketConnectionTransport::AttachSourceFilter()
+{
+    if (connectionKind != NetworkSocketConnectionKind::Udp)
+    {
+        return Result<void>::Error("Source filters require a UDP transport with a target address");
+    }
+    if (targetAddr.has_value())
+    {
+        return AttachSourceFilter(socketHandle, targetAddr.value());
+    }
+    if (targetAddr6.has_value())
+    {
+        return AttachSourceFilter(socketHandle, targetAddr6.value());
+    }
+    return Result<void>::Error("Source filters require a UDP transport with a target address");
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+uint64_t NetworkSocketConnectionTransport::GetDiscardedPacketCount() const
+{
+    return discardedPacketCount.load(std::memory_order_relaxed);
+}
+#pragma endregion Getters/Setters
+
 #pragma region ConnectionTransport Implementation
 std::optional<sockaddr_in> NetworkSocketConnectionTransport::GetAddr()
 {
@@ -77,8 +184,40 @@ std::optional<sockaddr_in> NetworkSocketConnectionTransport::GetAddr()
 
 std::optional<sockaddr_in6> NetworkSocketConnectionTransport::GetAddr6()
 {
-    // TODO
-    return std::nullopt;
+    return targetAddr6;
+}
+
+std::optional<int> NetworkSocketConnectionTransport::GetPollHandle()
+{
+    return socketHandle;
+}
+
+std::optional<int> NetworkSocketConnectionTransport::GetIncomingCpu()
+{
+    int incomingCpu = -1;
+    socklen_t optionLength = sizeof(incomingCpu);
+    if ((getsockopt(socketHandle, SOL_SOCKET, SO_INCOMING_CPU, &incomingCpu,
+        &optionLength) != 0) || (incomingCpu < 0))
+    {
+        return std::nullopt;
+    }
+    return incomingCpu;
+}
+
+std::optional<std::chrono::microseconds> NetworkSocketConnectionTransport::GetRoundTripTime()
+{
+    if (connectionKind != NetworkSocketConnectionKind::Tcp)
+    {
+        return std::nullopt;
+    }
+    tcp_info info {};
+    socklen_t optionLength = sizeof(info);
+    if ((getsockopt(socketHandle, IPPROTO_TCP, TCP_INFO, &info, &optionLength) != 0) ||
+        (info.tcpi_rtt == 0))
+    {
+        return std::nullopt;
+    }
+    return std::chrono::microseconds(info.tcpi_rtt);
 }
 
 Result<ssize_t> NetworkSocketConnectionTransport::Read(
@@ -114,7 +253,7 @@ Result<ssize_t> NetworkSocketConnectionTransport::Read(
     // Data available for reading?
     if (pollFds[0].revents & POLLIN)
     {
-        sockaddr_in recvFromAddr{};
+        sockaddr_storage recvFromAddr{};
         socklen_t recvFromAddrLen = sizeof(recvFromAddr);
 
         buffer.resize(BUFFER_SIZE);
@@ -167,36 +306,14 @@ Result<ssize_t> NetworkSocketConnectionTransport::Read(
         }
         else if (bytesRead > 0)
         {
-            bool bytesAreFromExpectedAddr = true;
-            if ((connectionKind == NetworkSocketConnectionKind::Udp) && targetAddr.has_value())
-            {
-                // If we're processing UDP packets, make sure the incoming data is coming
-                // from the expected address
-                if (recvFromAddr.sin_addr.s_addr == targetAddr.value().sin_addr.s_addr)
-                {
-                    // Update our outgoing port to match the source
-                    // TODO: Synchronize this to make sure we don't write before we know the
-                    // correct port.
-                    targetAddr.value().sin_port = recvFromAddr.sin_port;
-                }
-                else
-                {
-                    bytesAreFromExpectedAddr = false;
-                }
-            }
-
-            if (bytesAreFromExpectedAddr)
+            if (isFromExpectedAddr(recvFromAddr))
             {
                 buffer.resize(bytesRead);
                 return Result<ssize_t>::Success(bytesRead);
             }
             else
             {
-                spdlog::warn(
-                    "Discarding {} bytes received from unexpected address {}, "
-                    "expected {}",
-                    bytesRead, Util::AddrToString(recvFromAddr.sin_addr),
-                    Util::AddrToString(targetAddr.value().sin_addr));
+                recordDiscardedPackets(1, bytesRead, recvFromAddr);
                 buffer.resize(0);
                 return Result<ssize_t>::Success(0);
             }
@@ -216,6 +333,131 @@ Result<ssize_t> NetworkSocketConnectionTransport::Read(
     }
 }
 
+Result<size_t> NetworkSocketConnectionTransport::ReadBatch(
+    std::span<PacketBuffer> buffers, std::chrono::milliseconds timeout)
+{
+    // Only datagram sockets have message boundaries worth batching on
+    if ((connectionKind != NetworkSocketConnectionKind::Udp) || buffers.empty())
+    {
+        return ConnectionTransport::ReadBatch(buffers, timeout);
+    }
+
+    std::scoped_lock lock(readMutex);
+
+    if (isStopped)
+    {
+        return Result<size_t>::Error("Transport is stopped");
+    }
+
+    pollfd pollFds[]
+    {
+        // Socket read
+        {
+            .fd = socketHandle,
+            .events = POLLIN,
+            .revents = 0,
+        },
+    };
+
+    poll(pollFds, 1, timeout.count());
+
+    // Did the socket get closed?
+    if (((pollFds[0].revents & POLLERR) > 0) || 
+        ((pollFds[0].revents & POLLHUP) > 0) ||
+        ((pollFds[0].revents & POLLNVAL) > 0))
+    {
+        return Result<size_t>::Error("Socket closed");
+    }
+
+    if ((pollFds[0].revents & POLLIN) == 0)
+    {
+        // No data available to read
+        return Result<size_t>::Success(0);
+    }
+
+    const size_t batchSize = std::min(buffers.size(), MAX_BATCH_SIZE);
+    std::array<mmsghdr, MAX_BATCH_SIZE> messages{};
+    std::array<iovec, MAX_BATCH_SIZE> messageIovs{};
+    std::array<sockaddr_storage, MAX_BATCH_SIZE> recvFromAddrs{};
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+        // Never write into a buffer that has been handed off to someone else
+        if (!buffers[i].IsUnique())
+        {
+            buffers[i] = PacketBufferPool::Default().Acquire();
+        }
+        messageIovs[i] = {
+            .iov_base = buffers[i].Data(),
+            .iov_len = buffers[i].Capacity(),
+        };
+        messages[i].msg_hdr.msg_name = &recvFromAddrs[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(recvFromAddrs[i]);
+        messages[i].msg_hdr.msg_iov = &messageIovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int messagesRead = recvmmsg(socketHandle, messages.data(), batchSize, MSG_DONTWAIT, nullptr);
+    if (messagesRead == -1)
+    {
+        int error = errno;
+        if (error == EINVAL)
+        {
+            // This means we've closed the socket
+            return Result<size_t>::Error("Socket is closed");
+        }
+        else if ((error == EAGAIN) || (error == EWOULDBLOCK))
+        {
+            // No data was read.
+            return Result<size_t>::Success(0);
+        }
+        else
+        {
+            // Unexpected error!
+            return Result<size_t>::Error(fmt::format(
+                "Couldn't read from socket. Error {}: {}",
+                error,
+                Util::ErrnoToString(error)));
+        }
+    }
+    PacketLatencyTracer::StampReceived(buffers.first(messagesRead));
+
+    // Compact the datagrams we want to keep at the front of the given buffers, discarding
+    // empty datagrams and those from unexpected addresses.
+    size_t buffersFilled = 0;
+    size_t discardedCount = 0;
+    size_t discardedBytes = 0;
+    std::optional<sockaddr_storage> discardedFromAddr;
+    for (int i = 0; i < messagesRead; ++i)
+    {
+        const size_t bytesRead = messages[i].msg_len;
+        if (bytesRead == 0)
+        {
+            continue;
+        }
+
+        if (!isFromExpectedAddr(recvFromAddrs[i]))
+        {
+            ++discardedCount;
+            discardedBytes += bytesRead;
+            discardedFromAddr = recvFromAddrs[i];
+            continue;
+        }
+
+        buffers[i].Resize(bytesRead);
+        if (buffersFilled != static_cast<size_t>(i))
+        {
+            std::swap(buffers[buffersFilled], buffers[i]);
+        }
+        ++buffersFilled;
+    }
+
+    if (discardedCount > 0)
+    {
+        recordDiscardedPackets(discardedCount, discardedBytes, discardedFromAddr.value());
+    }
+
+    return Result<size_t>::Success(buffersFilled);
+}
 
 Result<void> NetworkSocketConnectionTransport::Write(const std::span<const std::byte>& bytes)
 {
@@ -241,6 +483,18 @@ void NetworkSocketConnectionTransport::Stop()
     // Once we reach this point, we know the socket has finished closing.
     isStopped = true;
 }
+
+Result<std::optional<int>> NetworkSocketConnectionTransport::Detach()
+{
+    // Wait for reads and writes in progress, then leave the socket open for whoever takes it
+    std::scoped_lock lock(readMutex, writeMutex);
+    if (isStopped)
+    {
+        return Result<std::optional<int>>::Error("Transport has already stopped");
+    }
+    isStopped = true;
+    return Result<std::optional<int>>::Success(socketHandle);
+}
 #pragma endregion ConnectionTransport Implementation
 
 #pragma region Private methods
@@ -253,10 +507,69 @@ void NetworkSocketConnectionTransport::closeSocket(int handle)
     }
 }
 
+bool NetworkSocketConnectionTransport::isFromExpectedAddr(const sockaddr_storage& recvFromAddr)
+{
+    if (connectionKind != NetworkSocketConnectionKind::Udp)
+    {
+        return true;
+    }
+
+    // If we're processing UDP packets, make sure the incoming data is coming
+    // from the expected address, then update our outgoing port to match the source
+    // TODO: Synchronize this to make sure we don't write before we know the
+    // correct port.
+    if (targetAddr.has_value())
+    {
+        if (IpAddress::FromSockaddr(recvFromAddr) != IpAddress(targetAddr.value().sin_addr))
+        {
+            return false;
+        }
+        targetAddr.value().sin_port = IpAddress::GetPort(recvFromAddr);
+    }
+    else if (targetAddr6.has_value())
+    {
+        if (IpAddress::FromSockaddr(recvFromAddr) != IpAddress(targetAddr6.value().sin6_addr))
+        {
+            return false;
+        }
+        targetAddr6.value().sin6_port = IpAddress::GetPort(recvFromAddr);
+    }
+
+    return true;
+}
+
+void NetworkSocketConnectionTransport::recordDiscardedPackets(
+    size_t count, size_t bytes, const sockaddr_storage& fromAddr)
+{
+    const uint64_t totalPackets =
+        discardedPacketCount.fetch_add(count, std::memory_order_relaxed) + count;
+    const uint64_t totalBytes =
+        discardedByteCount.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    // A misbehaving or spoofing peer can send us a lot of junk, so only log a summary
+    // every so often instead of once per datagram.
+    const auto now = std::chrono::steady_clock::now();
+    if ((loggedDiscardedPacketCount != 0) && ((now - lastDiscardLogTime) < DISCARD_LOG_INTERVAL))
+    {
+        return;
+    }
+    const std::optional<IpAddress> fromIpAddress = IpAddress::FromSockaddr(fromAddr);
+    const IpAddress expectedAddr = IpAddress::FromSockaddr(targetAddr, targetAddr6).value();
+    spdlog::warn(
+        "Discarded {} packets ({} bytes) received from unexpected address(es) "
+        "such as {}, expected {} ({} packets total)",
+        (totalPackets - loggedDiscardedPacketCount), (totalBytes - loggedDiscardedByteCount),
+        fromIpAddress.has_value() ? fromIpAddress.value().ToString() : "UNKNOWN",
+        expectedAddr.ToString(), totalPackets);
+    loggedDiscardedPacketCount = totalPackets;
+    loggedDiscardedByteCount = totalBytes;
+    lastDiscardLogTime = now;
+}
 
 Result<void> NetworkSocketConnectionTransport::sendData(const std::span<const std::byte>& data)
 {
     sockaddr_in sendToAddr{};
+    sockaddr_in6 sendToAddr6{};
     sockaddr* sendToAddrPtr = nullptr;
     socklen_t sendToAddrLen = 0;
 
@@ -267,6 +580,13 @@ Result<void> NetworkSocketConnectionTransport::sendData(const std::span<const st
         sendToAddrPtr = reinterpret_cast<sockaddr*>(&sendToAddr);
         sendToAddrLen = sizeof(sendToAddr);
     }
+    else if ((connectionKind == NetworkSocketConnectionKind::Udp) &&
+        targetAddr6.has_value())
+    {
+        sendToAddr6 = targetAddr6.value();
+        sendToAddrPtr = reinterpret_cast<sockaddr*>(&sendToAddr6);
+        sendToAddrLen = sizeof(sendToAddr6);
+    }
 
     size_t bytesWritten = 0;
     while (true)
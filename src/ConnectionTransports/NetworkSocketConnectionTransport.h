@@ -12,6 +12,7 @@
 #include "../Utilities/Result.h"
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <list>
@@ -37,38 +38,84 @@ public:
     static Result<std::unique_ptr<NetworkSocketConnectionTransport>> Nonblocking(
         NetworkSocketConnectionKind kind,
         int socketHandle,
-        std::optional<sockaddr_in> targetAddr = std::nullopt);
+        std::optional<sockaddr_in> targetAddr = std::nullopt,
+        std::optional<sockaddr_in6> targetAddr6 = std::nullopt);
+    /**
+     * @brief
+     *  Attaches a classic BPF filter to a UDP socket so the kernel drops datagrams that don't
+     *  come from the given address before they are queued to the socket.
+     */
+    static Result<void> AttachSourceFilter(int socketHandle, const sockaddr_in& targetAddr);
+    static Result<void> AttachSourceFilter(int socketHandle, const sockaddr_in6& targetAddr);
 
     /* Constructor/Destructor */
+    /**
+     * @param targetAddr6 address of a peer that only has an IPv6 address
+     */
     NetworkSocketConnectionTransport(
         NetworkSocketConnectionKind kind,
         int socketHandle,
-        std::optional<sockaddr_in> targetAddr = std::nullopt);
+        std::optional<sockaddr_in> targetAddr = std::nullopt,
+        std::optional<sockaddr_in6> targetAddr6 = std::nullopt);
     virtual ~NetworkSocketConnectionTransport();
 
+    /* Public methods */
+    /**
+     * @brief
+     *  Attaches a source filter for the target address, so the kernel drops datagrams that
+     *  don't come from it rather than this transport waking up to discard them.
+     */
+    Result<void> AttachSourceFilter();
+
+    /* Getters/Setters */
+    /**
+     * @brief Number of datagrams discarded after being received from an unexpected address
+     */
+    uint64_t GetDiscardedPacketCount() const;
+
     /* ConnectionTransport Implementation */
     std::optional<sockaddr_in> GetAddr() override;
     std::optional<sockaddr_in6> GetAddr6() override;
+    std::optional<int> GetPollHandle() override;
+    std::optional<int> GetIncomingCpu() override;
+    std::optional<std::chrono::microseconds> GetRoundTripTime() override;
     void Stop() override;
+    Result<std::optional<int>> Detach() override;
     Result<ssize_t> Read(
         std::vector<std::byte>& buffer,
         std::chrono::milliseconds timeout) override;
+    Result<size_t> ReadBatch(
+        std::span<PacketBuffer> buffers,
+        std::chrono::milliseconds timeout) override;
     Result<void> Write(const std::span<const std::byte>& bytes) override;
 
 private:
     /* Static members */
     static constexpr int BUFFER_SIZE = 2048;
+    // Maximum number of datagrams read by a single recvmmsg call
+    static constexpr size_t MAX_BATCH_SIZE = 64;
+    // Minimum time between log messages about discarded datagrams
+    static constexpr std::chrono::seconds DISCARD_LOG_INTERVAL { 10 };
     static void closeSocket(int handle);
 
     /* Private fields */
     const NetworkSocketConnectionKind connectionKind;
     const int socketHandle = 0;
     std::optional<sockaddr_in> targetAddr = std::nullopt;
+    std::optional<sockaddr_in6> targetAddr6 = std::nullopt;
     bool isStopped = false;
     std::mutex readMutex;
     std::mutex writeMutex;
+    std::atomic<uint64_t> discardedPacketCount { 0 };
+    std::atomic<uint64_t> discardedByteCount { 0 };
+    // Discard stats as of the last log message, guarded by readMutex
+    uint64_t loggedDiscardedPacketCount = 0;
+    uint64_t loggedDiscardedByteCount = 0;
+    std::chrono::steady_clock::time_point lastDiscardLogTime;
 
     /* Private methods */
+    bool isFromExpectedAddr(const sockaddr_storage& recvFromAddr);
+    void recordDiscardedPackets(size_t count, size_t bytes, const sockaddr_storage& fromAddr);
     Result<void> sendData(const std::span<const std::byte>& data);
     void closeConnection();
 };
\ No newline at end of file
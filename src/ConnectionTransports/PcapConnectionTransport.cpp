@@ -0,0 +1,172 @@
+/**
+ * @file PcapConnectionTransport.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "PcapConnectionTransport.h"
+
+#include "../Utilities/PacketLatencyTracer.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+PcapConnectionTransport::PcapConnectionTransport(
+    std::vector<PcapReader::UdpDatagram> datagrams,
+    Timing timing)
+:
+    datagrams(std::move(datagrams)),
+    timing(timing)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Getters/Setters
+bool PcapConnectionTransport::IsFinished()
+{
+    std::scoped_lock lock(mutex);
+    return (nextDatagramIndex >= datagrams.size());
+}
+
+uint64_t PcapConnectionTransport::GetDatagramsRead()
+{
+    std::scoped_lock lock(mutex);
+    return nextDatagramIndex;
+}
+
+uint64_t PcapConnectionTransport::GetDatagramsWritten() const
+{
+    return datagramsWritten.load(std::memory_order_relaxed);
+}
+#pragma endregion Getters/Setters
+
+#pragma region ConnectionTransport Implementation
+std::optional<sockaddr_in> PcapConnectionTransport::GetAddr()
+{
+    return std::nullopt;
+}
+
+std::optional<sockaddr_in6> PcapConnectionTransport::GetAddr6()
+{
+    return std::nullopt;
+}
+
+void PcapConnectionTransport::Stop()
+{
+    {
+        std::scoped_lock lock(mutex);
+        isStopped = true;
+    }
+    // Wake anyone waiting to read so they notice we've stopped
+    stoppedCondition.notify_all();
+}
+
+Result<ssize_t> PcapConnectionTransport::Read(
+    std::vector<std::byte>& buffer,
+    std::chrono::milliseconds timeout)
+{
+    buffer.resize(0);
+    std::unique_lock lock(mutex);
+    if (!waitForDueDatagram(lock, timeout))
+    {
+        return Result<ssize_t>::Error("Transport is stopped");
+    }
+    if ((nextDatagramIndex >= datagrams.size()) ||
+        !isNextDatagramDue(std::chrono::steady_clock::now()))
+    {
+        return Result<ssize_t>::Success(0);
+    }
+    const std::vector<std::byte>& payload = datagrams[nextDatagramIndex++].Payload;
+    buffer.assign(payload.begin(), payload.end());
+    return Result<ssize_t>::Success(buffer.size());
+}
+
+Result<size_t> PcapConnectionTransport::ReadBatch(
+    std::span<PacketBuffer> buffers,
+    std::chrono::milliseconds timeout)
+{
+    size_t count = 0;
+    {
+        std::unique_lock lock(mutex);
+        if (!waitForDueDatagram(lock, timeout))
+        {
+            return Result<size_t>::Error("Transport is stopped");
+        }
+        const auto now = std::chrono::steady_clock::now();
+        while ((count < buffers.size()) && (nextDatagramIndex < datagrams.size()) &&
+            isNextDatagramDue(now))
+        {
+            // Copied like a socket read would, so the replayed bytes are never shared
+            const std::vector<std::byte>& payload = datagrams[nextDatagramIndex++].Payload;
+            PacketBuffer& buffer = buffers[count++];
+            if (buffer && buffer.IsUnique() && (buffer.Capacity() >= payload.size()))
+            {
+                std::copy(payload.begin(), payload.end(), buffer.Data());
+                buffer.Resize(payload.size());
+            }
+            else
+            {
+                buffer = PacketBuffer::Copy(payload);
+            }
+        }
+    }
+    PacketLatencyTracer::StampReceived(buffers.first(count));
+    return Result<size_t>::Success(count);
+}
+
+Result<void> PcapConnectionTransport::Write(const std::span<const std::byte>& bytes)
+{
+    datagramsWritten.fetch_add(1, std::memory_order_relaxed);
+    return Result<void>::Success();
+}
+#pragma endregion ConnectionTransport Implementation
+
+#pragma region Private methods
+bool PcapConnectionTransport::waitForDueDatagram(std::unique_lock<std::mutex>& lock,
+    std::chrono::milliseconds timeout)
+{
+    auto now = std::chrono::steady_clock::now();
+    const auto deadline = now + timeout;
+    if (!playbackStartTime.has_value())
+    {
+        playbackStartTime = now;
+    }
+
+    while (!isStopped)
+    {
+        if ((nextDatagramIndex < datagrams.size()) && isNextDatagramDue(now))
+        {
+            return true;
+        }
+        if (now >= deadline)
+        {
+            // Nothing came due in time
+            return true;
+        }
+
+        // Once every datagram has been read, we sit idle like a quiet socket
+        const auto wakeTime = (nextDatagramIndex < datagrams.size()) ?
+            std::min(deadline, nextDatagramDueTime()) : deadline;
+        stoppedCondition.wait_until(lock, wakeTime,
+            [this]()
+            {
+                return isStopped;
+            });
+        now = std::chrono::steady_clock::now();
+    }
+    return false;
+}
+
+bool PcapConnectionTransport::isNextDatagramDue(std::chrono::steady_clock::time_point now) const
+{
+    return ((timing == Timing::AsFastAsPossible) || (now >= nextDatagramDueTime()));
+}
+
+std::chrono::steady_clock::time_point PcapConnectionTransport::nextDatagramDueTime() const
+{
+    const std::chrono::nanoseconds offset =
+        datagrams[nextDatagramIndex].Timestamp - datagrams.front().Timestamp;
+    return playbackStartTime.value() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+}
+#pragma endregion Private methods
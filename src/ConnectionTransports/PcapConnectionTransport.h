@@ -0,0 +1,88 @@
+/**
+ * @file PcapConnectionTransport.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ConnectionTransport.h"
+
+#include "../Utilities/PcapReader.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief
+ *  A ConnectionTransport that replays UDP datagrams out of a capture, so real traffic can be
+ *  fed through the media path without a network. Datagrams are read either with the spacing
+ *  they were captured with, or as fast as they can be read. Anything written to the
+ *  transport (like NACKs) is only counted. Has no poll handle, so it must be read from its
+ *  own thread.
+ */
+class PcapConnectionTransport : public ConnectionTransport
+{
+public:
+    /* Public types */
+    enum class Timing
+    {
+        // Each datagram is read no earlier than it arrived in the capture, measured from the
+        // first read
+        Original = 0,
+        AsFastAsPossible,
+    };
+
+    /* Constructor/Destructor */
+    /**
+     * @param datagrams datagrams to replay, in the order they were captured
+     */
+    PcapConnectionTransport(std::vector<PcapReader::UdpDatagram> datagrams, Timing timing);
+
+    /* Getters/Setters */
+    /**
+     * @brief Whether every datagram has been read
+     */
+    bool IsFinished();
+    uint64_t GetDatagramsRead();
+    uint64_t GetDatagramsWritten() const;
+
+    /* ConnectionTransport Implementation */
+    std::optional<sockaddr_in> GetAddr() override;
+    std::optional<sockaddr_in6> GetAddr6() override;
+    void Stop() override;
+    Result<ssize_t> Read(
+        std::vector<std::byte>& buffer,
+        std::chrono::milliseconds timeout) override;
+    Result<size_t> ReadBatch(
+        std::span<PacketBuffer> buffers,
+        std::chrono::milliseconds timeout) override;
+    Result<void> Write(const std::span<const std::byte>& bytes) override;
+
+private:
+    /* Private fields */
+    const std::vector<PcapReader::UdpDatagram> datagrams;
+    const Timing timing;
+    std::mutex mutex;
+    std::condition_variable stoppedCondition;
+    bool isStopped = false;
+    size_t nextDatagramIndex = 0;
+    // Set by the first read, datagrams are due relative to it
+    std::optional<std::chrono::steady_clock::time_point> playbackStartTime;
+    std::atomic<uint64_t> datagramsWritten { 0 };
+
+    /* Private methods */
+    /**
+     * @brief Waits up to the timeout for the next datagram to come due
+     * @return false if we've been stopped
+     */
+    bool waitForDueDatagram(std::unique_lock<std::mutex>& lock,
+        std::chrono::milliseconds timeout);
+    bool isNextDatagramDue(std::chrono::steady_clock::time_point now) const;
+    std::chrono::steady_clock::time_point nextDatagramDueTime() const;
+};
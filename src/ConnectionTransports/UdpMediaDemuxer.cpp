@@ -0,0 +1,431 @@
+/**
+ * @file UdpMediaDemuxer.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "UdpMediaDemuxer.h"
+
+#include "DemuxedUdpConnectionTransport.h"
+#include "../Utilities/PacketLatencyTracer.h"
+#include "../Utilities/Util.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#pragma region Constructor/Destructor
+UdpMediaDemuxer::UdpMediaDemuxer(uint16_t port, size_t numSockets, SocketBinding binding)
+:
+    port(port)
+{
+    try
+    {
+        for (size_t i = 0; i < std::max<size_t>(numSockets, 1); ++i)
+        {
+            socketHandles.push_back(openSocket(binding, i));
+        }
+        socketFamily = boundAddress(socketHandles.front()).ss_family;
+    }
+    catch (...)
+    {
+        for (const int& socketHandle : socketHandles)
+        {
+            close(socketHandle);
+        }
+        throw;
+    }
+    startReaders();
+    spdlog::info("Receiving media for all streams on UDP port {} with {} sockets",
+        port, socketHandles.size());
+}
+
+UdpMediaDemuxer::UdpMediaDemuxer(std::vector<int> adoptedSocketHandles)
+:
+    port(adoptedSocketHandles.empty() ? 0 :
+        ntohs(IpAddress::GetPort(boundAddress(adoptedSocketHandles.front())))),
+    socketHandles(std::move(adoptedSocketHandles))
+{
+    if (socketHandles.empty())
+    {
+        throw std::invalid_argument("No media sockets were handed over");
+    }
+    socketFamily = boundAddress(socketHandles.front()).ss_family;
+    startReaders();
+    spdlog::info("Receiving media for all streams on UDP port {} with {} adopted sockets",
+        port, socketHandles.size());
+}
+
+UdpMediaDemuxer::~UdpMediaDemuxer()
+{
+    stopReaders();
+    for (const int& socketHandle : socketHandles)
+    {
+        close(socketHandle);
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+std::unique_ptr<ConnectionTransport> UdpMediaDemuxer::CreateTransport(
+    const IpAddress& targetAddr,
+    std::span<const uint32_t> ssrcs)
+{
+    if ((targetAddr.GetFamily() == AF_INET6) && (socketFamily != AF_INET6))
+    {
+        throw std::runtime_error(fmt::format(
+            "Can't receive media from IPv6 address {} on an IPv4 shared port",
+            targetAddr.ToString()));
+    }
+    auto transport = std::make_unique<DemuxedUdpConnectionTransport>(shared_from_this(),
+        targetAddr);
+
+    std::unique_lock lock(routesMutex);
+    Registration& registration = registrations.try_emplace(transport.get(),
+        Registration { .Addr = targetAddr }).first->second;
+    registration.Ssrcs.assign(ssrcs.begin(), ssrcs.end());
+    for (const uint32_t& ssrc : ssrcs)
+    {
+        routesBySsrc[SsrcKey { .Addr = targetAddr, .Ssrc = ssrc }] = transport.get();
+    }
+    routesByAddr.emplace(targetAddr, transport.get());
+    return transport;
+}
+
+void UdpMediaDemuxer::Unregister(DemuxedUdpConnectionTransport* transport)
+{
+    std::unique_lock lock(routesMutex);
+    auto it = registrations.find(transport);
+    if (it == registrations.end())
+    {
+        return;
+    }
+
+    const Registration& registration = it->second;
+    for (const uint32_t& ssrc : registration.Ssrcs)
+    {
+        auto ssrcIt = routesBySsrc.find(SsrcKey { .Addr = registration.Addr, .Ssrc = ssrc });
+        if ((ssrcIt != routesBySsrc.end()) && (ssrcIt->second == transport))
+        {
+            routesBySsrc.erase(ssrcIt);
+        }
+    }
+    for (const EndpointKey& endpoint : registration.Endpoints)
+    {
+        auto endpointIt = routesByEndpoint.find(endpoint);
+        if ((endpointIt != routesByEndpoint.end()) && (endpointIt->second == transport))
+        {
+            routesByEndpoint.erase(endpointIt);
+        }
+    }
+    auto [addrBegin, addrEnd] = routesByAddr.equal_range(registration.Addr);
+    for (auto addrIt = addrBegin; addrIt != addrEnd; ++addrIt)
+    {
+        if (addrIt->second == transport)
+        {
+            routesByAddr.erase(addrIt);
+            break;
+        }
+    }
+    registrations.erase(it);
+}
+
+Result<void> UdpMediaDemuxer::SendTo(const IpAddress& addr, uint16_t port,
+    std::span<const std::byte> bytes)
+{
+    // Dual-stack sockets reach IPv4 peers through their mapped address
+    sockaddr_storage sendToAddr {};
+    socklen_t sendToAddrLength = 0;
+    if (socketFamily == AF_INET6)
+    {
+        const sockaddr_in6 addr6 = addr.ToIpv6(port);
+        std::memcpy(&sendToAddr, &addr6, sizeof(addr6));
+        sendToAddrLength = sizeof(addr6);
+    }
+    else if (std::optional<sockaddr_in> addr4 = addr.ToIpv4(port))
+    {
+        std::memcpy(&sendToAddr, &addr4.value(), sizeof(addr4.value()));
+        sendToAddrLength = sizeof(addr4.value());
+    }
+    else
+    {
+        return Result<void>::Error(fmt::format("Couldn't send to {} from an IPv4 socket",
+            addr.ToString()));
+    }
+
+    ssize_t result = sendto(socketHandles.front(), bytes.data(), bytes.size(), MSG_DONTWAIT,
+        reinterpret_cast<const sockaddr*>(&sendToAddr), sendToAddrLength);
+    if (result == -1)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format("Couldn't send to {}. Error {}: {}",
+            addr.ToString(), error, Util::ErrnoToString(error)));
+    }
+    return Result<void>::Success();
+}
+Result<std::vector<int>> UdpMediaDemuxer::DetachSockets()
+{
+    // Our own copies stay open so replies (ex. NACKs) can still be sent until we're destroyed
+    stopReaders();
+    std::vector<int> detachedHandles;
+    for (const int& socketHandle : socketHandles)
+    {
+        int detachedHandle = fcntl(socketHandle, F_DUPFD_CLOEXEC, 0);
+        if (detachedHandle < 0)
+        {
+            int error = errno;
+            for (const int& handle : detachedHandles)
+            {
+                close(handle);
+            }
+            return Result<std::vector<int>>::Error(fmt::format(
+                "Unable to duplicate media socket. Error {}: {}", error,
+                Util::ErrnoToString(error)));
+        }
+        detachedHandles.push_back(detachedHandle);
+    }
+    return Result<std::vector<int>>::Success(std::move(detachedHandles));
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+uint16_t UdpMediaDemuxer::GetPort() const
+{
+    return port;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private types
+size_t UdpMediaDemuxer::EndpointKey::Hash::operator()(const EndpointKey& key) const
+{
+    return IpAddress::Hash()(key.Addr) ^ (std::hash<uint16_t>()(key.Port) << 1);
+}
+
+size_t UdpMediaDemuxer::SsrcKey::Hash::operator()(const SsrcKey& key) const
+{
+    return IpAddress::Hash()(key.Addr) ^ (std::hash<uint32_t>()(key.Ssrc) << 1);
+}
+#pragma endregion Private types
+
+#pragma region Private methods
+sockaddr_storage UdpMediaDemuxer::boundAddress(int socketHandle)
+{
+    sockaddr_storage address {};
+    socklen_t addressLength = sizeof(address);
+    if (getsockname(socketHandle, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0)
+    {
+        int error = errno;
+        throw std::runtime_error(fmt::format(
+            "Unable to get port of media socket. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+    return address;
+}
+
+int UdpMediaDemuxer::openSocket(const SocketBinding& binding, size_t socketIndex)
+{
+    Result<SocketBinding::BindAddress> bindAddress = binding.GetBindAddress(port);
+    if (bindAddress.IsError)
+    {
+        throw std::invalid_argument(bindAddress.ErrorMessage);
+    }
+
+    const int family = bindAddress.Value.GetFamily();
+    int socketHandle = socket(family, (SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC), IPPROTO_UDP);
+    if (socketHandle == -1)
+    {
+        int error = errno;
+        throw std::runtime_error(fmt::format(
+            "Couldn't create UDP socket. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+
+    // Let every socket bind the same port, the kernel will balance datagrams between them
+    int reusePort = 1;
+    if (setsockopt(socketHandle, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort)) != 0)
+    {
+        int error = errno;
+        close(socketHandle);
+        throw std::runtime_error(fmt::format(
+            "Couldn't set SO_REUSEPORT on UDP socket. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+
+    Result<void> applyResult = binding.Apply(socketHandle, family, socketIndex);
+    if (applyResult.IsError)
+    {
+        close(socketHandle);
+        throw std::runtime_error(applyResult.ErrorMessage);
+    }
+
+    const SocketBinding::BindAddress& socketAddress = bindAddress.Value;
+    if (bind(socketHandle, reinterpret_cast<const sockaddr*>(&socketAddress.Address),
+        socketAddress.Length) != 0)
+    {
+        int error = errno;
+        close(socketHandle);
+        throw std::runtime_error(fmt::format(
+            "Couldn't bind UDP socket to port {}. Error {}: {}",
+            port, error, Util::ErrnoToString(error)));
+    }
+    return socketHandle;
+}
+
+void UdpMediaDemuxer::startReaders()
+{
+    for (const int& socketHandle : socketHandles)
+    {
+        readerThreads.emplace_back(
+            [this, socketHandle](std::stop_token stopToken)
+            {
+                readerThreadBody(stopToken, socketHandle);
+            });
+    }
+}
+
+void UdpMediaDemuxer::stopReaders()
+{
+    for (auto& thread : readerThreads)
+    {
+        thread.request_stop();
+    }
+    for (auto& thread : readerThreads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    readerThreads.clear();
+}
+
+void UdpMediaDemuxer::readerThreadBody(std::stop_token stopToken, int socketHandle)
+{
+    std::array<PacketBuffer, READ_BATCH_SIZE> buffers;
+    std::array<mmsghdr, READ_BATCH_SIZE> messages;
+    std::array<iovec, READ_BATCH_SIZE> messageIovs;
+    std::array<sockaddr_storage, READ_BATCH_SIZE> fromAddrs;
+    while (!stopToken.stop_requested())
+    {
+        pollfd pollFd
+        {
+            .fd = socketHandle,
+            .events = POLLIN,
+            .revents = 0,
+        };
+        if (poll(&pollFd, 1, READ_POLL_TIMEOUT_MS) <= 0)
+        {
+            continue;
+        }
+
+        for (size_t i = 0; i < READ_BATCH_SIZE; ++i)
+        {
+            // Buffers we routed last time are now owned by their transports
+            if (!buffers[i].IsUnique())
+            {
+                buffers[i] = PacketBufferPool::Default().Acquire();
+            }
+            messageIovs[i] = {
+                .iov_base = buffers[i].Data(),
+                .iov_len = buffers[i].Capacity(),
+            };
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &fromAddrs[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(fromAddrs[i]);
+            messages[i].msg_hdr.msg_iov = &messageIovs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int messagesRead = recvmmsg(socketHandle, messages.data(), READ_BATCH_SIZE,
+            MSG_DONTWAIT, nullptr);
+        if (messagesRead == -1)
+        {
+            int error = errno;
+            if ((error != EAGAIN) && (error != EWOULDBLOCK) && (error != EINTR))
+            {
+                spdlog::error("Couldn't read from shared media socket. Error {}: {}",
+                    error, Util::ErrnoToString(error));
+            }
+            continue;
+        }
+        PacketLatencyTracer::StampReceived(std::span(buffers).first(messagesRead));
+
+        for (int i = 0; i < messagesRead; ++i)
+        {
+            if (messages[i].msg_len == 0)
+            {
+                continue;
+            }
+            buffers[i].Resize(messages[i].msg_len);
+            route(buffers[i], fromAddrs[i]);
+        }
+    }
+}
+
+void UdpMediaDemuxer::route(PacketBuffer datagram, const sockaddr_storage& fromAddr)
+{
+    const std::optional<IpAddress> fromIpAddr = IpAddress::FromSockaddr(fromAddr);
+    if (!fromIpAddr.has_value())
+    {
+        return;
+    }
+    const EndpointKey endpoint
+    {
+        .Addr = fromIpAddr.value(),
+        .Port = IpAddress::GetPort(fromAddr),
+    };
+
+    // Most datagrams come from a peer we've already learned the endpoint of
+    {
+        std::shared_lock lock(routesMutex);
+        auto it = routesByEndpoint.find(endpoint);
+        if (it != routesByEndpoint.end())
+        {
+            it->second->Deliver(std::move(datagram), endpoint.Port);
+            return;
+        }
+    }
+
+    std::unique_lock lock(routesMutex);
+    DemuxedUdpConnectionTransport* transport = nullptr;
+    if (auto it = routesByEndpoint.find(endpoint); it != routesByEndpoint.end())
+    {
+        transport = it->second;
+    }
+    else if (datagram.Size() >= 12)
+    {
+        // Learn the peer's endpoint from the first datagram carrying one of its SSRCs
+        const uint32_t ssrc = ntohl(*reinterpret_cast<const uint32_t*>(datagram.Data() + 8));
+        auto ssrcIt = routesBySsrc.find(SsrcKey { .Addr = endpoint.Addr, .Ssrc = ssrc });
+        if (ssrcIt != routesBySsrc.end())
+        {
+            transport = ssrcIt->second;
+            routesByEndpoint[endpoint] = transport;
+            registrations.at(transport).Endpoints.push_back(endpoint);
+        }
+    }
+    if ((transport == nullptr) && (routesByAddr.count(endpoint.Addr) == 1))
+    {
+        transport = routesByAddr.find(endpoint.Addr)->second;
+    }
+
+    if (transport == nullptr)
+    {
+        if ((unroutedDatagrams++ % 1000) == 0)
+        {
+            spdlog::warn("Discarding datagram from {} with no matching stream ({} discarded)",
+                endpoint.Addr.ToString(), unroutedDatagrams);
+        }
+        return;
+    }
+    transport->Deliver(std::move(datagram), endpoint.Port);
+}
+#pragma endregion Private methods
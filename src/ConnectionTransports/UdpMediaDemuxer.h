@@ -0,0 +1,142 @@
+/**
+ * @file UdpMediaDemuxer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../Utilities/IpAddress.h"
+#include "../Utilities/PacketBuffer.h"
+#include "../Utilities/Result.h"
+#include "../Utilities/SocketBinding.h"
+
+#include <cstdint>
+#include <memory>
+#include <netinet/in.h>
+#include <shared_mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ConnectionTransport;
+class DemuxedUdpConnectionTransport;
+
+/**
+ * @brief
+ *  Receives UDP media for many streams on a single port, using one or more sockets bound with
+ *  SO_REUSEPORT so the kernel spreads datagrams across reader threads.
+ *  Datagrams are routed to a DemuxedUdpConnectionTransport by the source address and port
+ *  they were sent from, which is learned from the first datagram carrying one of the
+ *  transport's RTP SSRCs. Datagrams from an address used by exactly one transport are routed
+ *  to it even before its port is known.
+ */
+class UdpMediaDemuxer : public std::enable_shared_from_this<UdpMediaDemuxer>
+{
+public:
+    /* Constructor/Destructor */
+    /**
+     * @param binding
+     *  address and interface to receive on, and how to tune each socket. Peers that only have
+     *  an IPv6 address can send to "::" or an IPv6 address, everyone else to any address.
+     */
+    UdpMediaDemuxer(uint16_t port, size_t numSockets, SocketBinding binding = {});
+    /**
+     * @brief Receives on sockets handed over by another process, which are already bound
+     */
+    UdpMediaDemuxer(std::vector<int> adoptedSocketHandles);
+    ~UdpMediaDemuxer();
+
+    /* Public methods */
+    /**
+     * @brief Creates a transport receiving the datagrams sent by the given peer
+     * @param ssrcs RTP SSRCs the peer will be sending, used to tell apart peers sharing an
+     *  address
+     */
+    std::unique_ptr<ConnectionTransport> CreateTransport(
+        const IpAddress& targetAddr,
+        std::span<const uint32_t> ssrcs);
+    /**
+     * @brief
+     *  Stops routing datagrams to the given transport. Once this returns, the transport will
+     *  not be delivered to again.
+     */
+    void Unregister(DemuxedUdpConnectionTransport* transport);
+    /**
+     * @param port in host byte order
+     */
+    Result<void> SendTo(const IpAddress& addr, uint16_t port, std::span<const std::byte> bytes);
+    /**
+     * @brief
+     *  Stops reading, returning copies of the shared sockets so another process can carry on
+     *  receiving from them. Datagrams that arrive in the meantime wait in the sockets' queues.
+     *  The caller owns the returned handles.
+     */
+    Result<std::vector<int>> DetachSockets();
+
+    /* Getters/Setters */
+    uint16_t GetPort() const;
+
+private:
+    /* Private types */
+    // Source address and port, in network byte order
+    struct EndpointKey
+    {
+        IpAddress Addr;
+        uint16_t Port;
+
+        bool operator==(const EndpointKey& other) const = default;
+        struct Hash
+        {
+            size_t operator()(const EndpointKey& key) const;
+        };
+    };
+    // Source address and RTP SSRC
+    struct SsrcKey
+    {
+        IpAddress Addr;
+        uint32_t Ssrc;
+
+        bool operator==(const SsrcKey& other) const = default;
+        struct Hash
+        {
+            size_t operator()(const SsrcKey& key) const;
+        };
+    };
+    struct Registration
+    {
+        IpAddress Addr;
+        std::vector<uint32_t> Ssrcs;
+        std::vector<EndpointKey> Endpoints;
+    };
+
+    /* Constants */
+    static constexpr size_t READ_BATCH_SIZE = 64;
+    static constexpr int READ_POLL_TIMEOUT_MS = 200;
+
+    /* Private fields */
+    const uint16_t port;
+    std::vector<int> socketHandles;
+    // AF_INET6 sockets are dual-stack, receiving from IPv4 peers through mapped addresses
+    sa_family_t socketFamily = AF_INET;
+    std::vector<std::jthread> readerThreads;
+    std::shared_mutex routesMutex;
+    std::unordered_map<DemuxedUdpConnectionTransport*, Registration> registrations;
+    std::unordered_map<EndpointKey, DemuxedUdpConnectionTransport*, EndpointKey::Hash>
+        routesByEndpoint;
+    std::unordered_map<SsrcKey, DemuxedUdpConnectionTransport*, SsrcKey::Hash> routesBySsrc;
+    // Keyed by source address
+    std::unordered_multimap<IpAddress, DemuxedUdpConnectionTransport*, IpAddress::Hash>
+        routesByAddr;
+    size_t unroutedDatagrams = 0;
+
+    /* Private methods */
+    static sockaddr_storage boundAddress(int socketHandle);
+    int openSocket(const SocketBinding& binding, size_t socketIndex);
+    void startReaders();
+    void stopReaders();
+    void readerThreadBody(std::stop_token stopToken, int socketHandle);
+    void route(PacketBuffer datagram, const sockaddr_storage& fromAddr);
+};
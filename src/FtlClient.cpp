@@ -9,64 +9,73 @@
 
 #include "Utilities/Util.h"
 
-#include <netdb.h>
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/tcp.h>
 #include <openssl/hmac.h>
+#include <poll.h>
 #include <regex>
 #include <stdexcept>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+namespace
+{
+    // Fills in the address to connect to a peer on the given port (in host byte order) with,
+    // returning its length
+    socklen_t toSockaddr(const IpAddress& address, uint16_t port, sockaddr_storage& sockaddr)
+    {
+        if (std::optional<sockaddr_in> addr = address.ToIpv4(port))
+        {
+            std::memcpy(&sockaddr, &addr.value(), sizeof(sockaddr_in));
+            return sizeof(sockaddr_in);
+        }
+        sockaddr_in6 addr6 = address.ToIpv6(port);
+        std::memcpy(&sockaddr, &addr6, sizeof(addr6));
+        return sizeof(addr6);
+    }
+}
+
 #pragma region Constructor/Destructor
 FtlClient::FtlClient(
     std::string targetHostname,
     ftl_channel_id_t channelId,
-    std::vector<std::byte> streamKey) : 
+    std::vector<std::byte> streamKey,
+    std::shared_ptr<HostnameResolver> resolver,
+    std::shared_ptr<DatagramFanoutQueue> relayGroup,
+    std::chrono::milliseconds pacingInterval,
+    SocketBinding binding) : 
     targetHostname(targetHostname),
     channelId(channelId),
-    streamKey(std::move(streamKey))
+    streamKey(std::move(streamKey)),
+    resolver(std::move(resolver)),
+    relayGroup(std::move(relayGroup)),
+    pacingInterval(pacingInterval),
+    binding(std::move(binding))
 { }
+
+FtlClient::~FtlClient()
+{
+    Stop();
+}
 #pragma endregion Constructor/Destructor
 
 #pragma region Public methods
-Result<void> FtlClient::ConnectAsync(FtlClient::ConnectMetadata metadata)
+std::future<Result<void>> FtlClient::ConnectAsync(FtlClient::ConnectMetadata metadata)
 {
-    // Open a socket for control connection
-    Result<void> openResult = openControlConnection();
-    if (openResult.IsError)
-    {
-        return openResult;
-    }
-
-    // Start a new thread to read incoming data
-    connectionThread = std::thread(&FtlClient::connectionThreadBody, this);
+    std::promise<Result<void>> connectedPromise;
+    std::future<Result<void>> connectedFuture = connectedPromise.get_future();
+
+    // Connect and read incoming data on a new thread
+    std::scoped_lock stoppingLock(stoppingMutex);
+    connectionThread = std::thread(&FtlClient::connectionThreadBody, this, std::move(metadata),
+        std::move(connectedPromise));
+    connectionThreadId = connectionThread.get_id();
     connectionThread.detach();
 
-    // Authenticate the control connection
-    Result<void> authResult = authenticateControlConnection();
-    if (authResult.IsError)
-    {
-        Stop();
-        return authResult;
-    }
-
-    // Request to start our stream
-    Result<void> startResult = sendControlStartStream(metadata);
-    if (startResult.IsError)
-    {
-        Stop();
-        return startResult;
-    }
-
-    // Open media connection
-    Result<void> openMediaResult = openMediaConnection();
-    if (openMediaResult.IsError)
-    {
-        Stop();
-        return openMediaResult;
-    }
-
-    return Result<void>::Success();
+    return connectedFuture;
 }
 
 void FtlClient::Stop()
@@ -74,34 +83,22 @@ void FtlClient::Stop()
     std::unique_lock stoppingLock(stoppingMutex);
     if (!isStopping && !isStopped)
     {
-        // Looks like this connection hasn't stopped yet.
-        // Close the sockets and wait for the connection thread to end.
+        // Looks like this connection hasn't stopped yet. Shut down the sockets so the
+        // connection thread notices, it closes the control socket on its way out.
         isStopping = true;
         if (controlSocketHandle != 0)
         {
             shutdown(controlSocketHandle, SHUT_RDWR);
-            close(controlSocketHandle);
-        }
-        if (mediaSocketHandle != 0)
-        {
-            shutdown(mediaSocketHandle, SHUT_RDWR);
-            close(mediaSocketHandle);
-        }
-
-        // Wait for the connection thread (only if it has actually started)
-        if (connectionThreadEndedFuture.valid())
-        {
-            stoppingLock.unlock(); // Unlock so the connection thread can finish stopping
-            connectionThreadEndedFuture.wait();
         }
+        closeMediaConnection();
     }
-    else if (isStopping && !isStopped)
+
+    // Wait for the connection thread (only if it has actually started, and isn't us)
+    const std::thread::id threadId = connectionThreadId;
+    stoppingLock.unlock(); // Unlock so the connection thread can finish stopping
+    if ((threadId != std::thread::id()) && (threadId != std::this_thread::get_id()))
     {
-        // We're already stopping - just wait for the connnection thread to end.
-        if (connectionThreadEndedFuture.valid()) {
-            stoppingLock.unlock(); // Unlock so the connection thread can finish stopping
-            connectionThreadEndedFuture.wait();
-        }
+        connectionThreadEndedFuture.wait();
     }
 }
 
@@ -110,64 +107,152 @@ void FtlClient::SetOnClosed(std::function<void()> onClosed)
     this->onClosed = onClosed;
 }
 
-void FtlClient::RelayPacket(const std::vector<std::byte>& packet)
+void FtlClient::SetOnMediaBytesReceived(
+    std::function<void(const std::span<const std::byte>& bytes)> onMediaBytesReceived)
 {
-    if (mediaSocketHandle != 0)
+    this->onMediaBytesReceived = onMediaBytesReceived;
+}
+
+void FtlClient::RelayPacket(const PacketBuffer& packet, BoundedPacketQueue::PacketKind kind)
+{
+    if ((relayGroup == nullptr) && isMediaConnected.load(std::memory_order_acquire))
     {
-        size_t writeResult = write(mediaSocketHandle, packet.data(), packet.size());
-        if (writeResult != packet.size())
-        {
-            // TODO: Handle writeResult
-        }
+        mediaSendQueue->Enqueue(packet, kind);
+    }
+}
+
+DatagramSendQueue::Stats FtlClient::GetRelayStats()
+{
+    if (!isMediaConnected.load(std::memory_order_acquire))
+    {
+        return DatagramSendQueue::Stats();
     }
+    if (relayGroup != nullptr)
+    {
+        return relayGroup->GetTargetStats(relayGroupTargetId);
+    }
+    return mediaSendQueue->GetStats();
+}
+
+bool FtlClient::IsClosed()
+{
+    std::scoped_lock stoppingLock(stoppingMutex);
+    return isStopped;
+}
+
+bool FtlClient::IsMediaConnected() const
+{
+    return isMediaConnected.load(std::memory_order_acquire);
 }
 #pragma endregion Public methods
 
 #pragma region Private methods
+Result<void> FtlClient::connectAndStartStream(const FtlClient::ConnectMetadata& metadata)
+{
+    Result<void> openResult = openControlConnection();
+    if (openResult.IsError)
+    {
+        return openResult;
+    }
+
+    Result<void> authResult = authenticateControlConnection();
+    if (authResult.IsError)
+    {
+        return authResult;
+    }
+
+    Result<void> startResult = sendControlStartStream(metadata);
+    if (startResult.IsError)
+    {
+        return startResult;
+    }
+
+    return openMediaConnection();
+}
+
 Result<void> FtlClient::openControlConnection()
 {
     // Look up hostname
-    addrinfo addrHints { 0 };
-    addrHints.ai_family = AF_INET; // TODO: IPV6 support
-    addrHints.ai_socktype = SOCK_STREAM;
-    addrHints.ai_protocol = IPPROTO_TCP;
-    addrinfo* controlAddrInfoPtr = nullptr;
-    int lookupErr = getaddrinfo(
-        targetHostname.c_str(),
-        std::to_string(FTL_CONTROL_PORT).c_str(),
-        &addrHints,
-        &controlAddrInfoPtr);
-    // Store addr lookup in a smart pointer so it is free'd when it goes out of scope
-    std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> controlAddrLookup(
-        controlAddrInfoPtr,
-        &freeaddrinfo);
-    if (lookupErr != 0)
-    {
-        return Result<void>::Error("Error looking up hostname");
+    Result<IpAddress> lookupResult = (resolver != nullptr) ?
+        resolver->Resolve(targetHostname) :
+        HostnameResolver::LookupWithGetAddrInfo(targetHostname);
+    if (lookupResult.IsError)
+    {
+        return Result<void>::Error(lookupResult.ErrorMessage);
     }
+    targetAddr = lookupResult.Value;
+    sockaddr_storage controlAddr {};
+    socklen_t controlAddrLength = toSockaddr(targetAddr, FTL_CONTROL_PORT, controlAddr);
 
     // Attempt to open TCP connection
-    // TODO: Loop through additional addresses on failure. For now, only try the first one.
-    controlSocketHandle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    int connectErr = connect(
+    int socketHandle = socket(targetAddr.GetFamily(),
+        (SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC), IPPROTO_TCP);
+    if (socketHandle < 0)
+    {
+        return Result<void>::Error(
+            fmt::format("Error {} when creating FTL control socket", errno));
+    }
+    {
+        std::lock_guard stoppingLock(stoppingMutex);
+        if (isStopping)
+        {
+            close(socketHandle);
+            return Result<void>::Error("Stopped while connecting");
+        }
+        controlSocketHandle = socketHandle;
+    }
+    Result<void> bindResult = bindSocket(controlSocketHandle, targetAddr.GetFamily());
+    if (bindResult.IsError)
+    {
+        return bindResult;
+    }
+
+    // Our handshake is a series of small request/response exchanges, don't let Nagle hold up
+    // any of them
+    int noDelay = 1;
+    setsockopt(controlSocketHandle, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    int connectErr = ::connect(
         controlSocketHandle,
-        controlAddrLookup->ai_addr,
-        controlAddrLookup->ai_addrlen);
-    if (connectErr != 0)
+        reinterpret_cast<const sockaddr*>(&controlAddr),
+        controlAddrLength);
+    if ((connectErr != 0) && (errno != EINPROGRESS))
     {
-        int error = errno;
-        close(controlSocketHandle);
         return Result<void>::Error(
-            fmt::format("Error {} when opening FTL control connection", error));
+            fmt::format("Error {} when opening FTL control connection", errno));
+    }
+    else if (connectErr != 0)
+    {
+        pollfd pollFd = { .fd = controlSocketHandle, .events = POLLOUT, .revents = 0 };
+        if (poll(&pollFd, 1, CONNECT_TIMEOUT.count()) <= 0)
+        {
+            return Result<void>::Error("Timed out opening FTL control connection");
+        }
+        int socketError = 0;
+        socklen_t socketErrorLength = sizeof(socketError);
+        getsockopt(controlSocketHandle, SOL_SOCKET, SO_ERROR, &socketError, &socketErrorLength);
+        if (socketError != 0)
+        {
+            return Result<void>::Error(
+                fmt::format("Error {} when opening FTL control connection", socketError));
+        }
     }
 
+    // We're connected, go back to blocking IO (reads time out via poll)
+    int socketFlags = fcntl(controlSocketHandle, F_GETFL, 0);
+    fcntl(controlSocketHandle, F_SETFL, (socketFlags & ~O_NONBLOCK));
+
     return Result<void>::Success();
 }
 
 Result<void> FtlClient::authenticateControlConnection()
 {
     // Request HMAC payload and wait for response
-    sendControlMessage("HMAC\r\n\r\n");
+    Result<void> sendResult = sendControlMessage("HMAC\r\n\r\n");
+    if (sendResult.IsError)
+    {
+        return sendResult;
+    }
     Result<FtlClient::FtlResponse> hmacResponse = waitForResponse();
     if (hmacResponse.IsError)
     {
@@ -192,7 +277,11 @@ Result<void> FtlClient::authenticateControlConnection()
 
     // Send authenticated HMAC request
     // format: `CONNECT %d $%s\r\n\r\n` (%d = channelId, %s = hmac hash hex)
-    sendControlMessage(fmt::format("CONNECT {} ${}\r\n\r\n", channelId, hashString));
+    sendResult = sendControlMessage(fmt::format("CONNECT {} ${}\r\n\r\n", channelId, hashString));
+    if (sendResult.IsError)
+    {
+        return sendResult;
+    }
     Result<FtlClient::FtlResponse> authResponse = waitForResponse();
     if (authResponse.IsError)
     {
@@ -206,28 +295,40 @@ Result<void> FtlClient::authenticateControlConnection()
     return Result<void>::Success();
 }
 
-Result<void> FtlClient::sendControlStartStream(FtlClient::ConnectMetadata metadata)
+Result<void> FtlClient::sendControlStartStream(const FtlClient::ConnectMetadata& metadata)
 {
-    // Send stream metadata
-    sendControlMessage(fmt::format(
+    // Send stream metadata, followed by a "." to indicate that we're done providing metadata.
+    // The server doesn't respond to any of it until the ".", so it all goes out in one write.
+    // (It can't go out any earlier - the server drops connections that send metadata before
+    // they're authenticated.)
+    std::string startMessage;
+    auto appendMessage = [&startMessage](const std::string& message)
+        {
+            startMessage.append(message);
+        };
+    appendMessage(fmt::format(
         "ProtocolVersion: {}.{}\r\n\r\n",
         FTL_PROTOCOL_VERSION_MAJOR,
         FTL_PROTOCOL_VERSION_MINOR));
-    sendControlMessage(fmt::format("VendorName: {}\r\n\r\n", metadata.VendorName));
-    sendControlMessage(fmt::format("VendorVersion: {}\r\n\r\n", metadata.VendorVersion));
-    sendControlMessage(fmt::format("Video: {}\r\n\r\n", metadata.HasVideo ? "true" : "false"));
-    sendControlMessage(fmt::format("VideoCodec: {}\r\n\r\n", metadata.VideoCodec));
-    sendControlMessage(fmt::format("VideoHeight: {}\r\n\r\n", metadata.VideoHeight));
-    sendControlMessage(fmt::format("VideoWidth: {}\r\n\r\n", metadata.VideoWidth));
-    sendControlMessage(fmt::format("VideoPayloadType: {}\r\n\r\n", metadata.VideoPayloadType));
-    sendControlMessage(fmt::format("VideoIngestSSRC: {}\r\n\r\n", metadata.VideoIngestSsrc));
-    sendControlMessage(fmt::format("Audio: {}\r\n\r\n", metadata.HasAudio ? "true" : "false"));
-    sendControlMessage(fmt::format("AudioCodec: {}\r\n\r\n", metadata.AudioCodec));
-    sendControlMessage(fmt::format("AudioPayloadType: {}\r\n\r\n", metadata.AudioPayloadType));
-    sendControlMessage(fmt::format("AudioIngestSSRC: {}\r\n\r\n", metadata.AudioIngestSsrc));
-
-    // Indicate that we are done providing metadata and wait for a response.
-    sendControlMessage(".\r\n\r\n");
+    appendMessage(fmt::format("VendorName: {}\r\n\r\n", metadata.VendorName));
+    appendMessage(fmt::format("VendorVersion: {}\r\n\r\n", metadata.VendorVersion));
+    appendMessage(fmt::format("Video: {}\r\n\r\n", metadata.HasVideo ? "true" : "false"));
+    appendMessage(fmt::format("VideoCodec: {}\r\n\r\n", metadata.VideoCodec));
+    appendMessage(fmt::format("VideoHeight: {}\r\n\r\n", metadata.VideoHeight));
+    appendMessage(fmt::format("VideoWidth: {}\r\n\r\n", metadata.VideoWidth));
+    appendMessage(fmt::format("VideoPayloadType: {}\r\n\r\n", metadata.VideoPayloadType));
+    appendMessage(fmt::format("VideoIngestSSRC: {}\r\n\r\n", metadata.VideoIngestSsrc));
+    appendMessage(fmt::format("Audio: {}\r\n\r\n", metadata.HasAudio ? "true" : "false"));
+    appendMessage(fmt::format("AudioCodec: {}\r\n\r\n", metadata.AudioCodec));
+    appendMessage(fmt::format("AudioPayloadType: {}\r\n\r\n", metadata.AudioPayloadType));
+    appendMessage(fmt::format("AudioIngestSSRC: {}\r\n\r\n", metadata.AudioIngestSsrc));
+    appendMessage(".\r\n\r\n");
+
+    Result<void> sendResult = sendControlMessage(startMessage);
+    if (sendResult.IsError)
+    {
+        return sendResult;
+    }
     Result<FtlClient::FtlResponse> metadataResponse = waitForResponse();
     if (metadataResponse.IsError)
     {
@@ -265,131 +366,178 @@ Result<void> FtlClient::sendControlStartStream(FtlClient::ConnectMetadata metada
 
 Result<void> FtlClient::openMediaConnection()
 {
-    // Look up hostname
-    addrinfo addrHints { 0 };
-    addrHints.ai_family = AF_INET; // TODO: IPV6 support
-    addrHints.ai_socktype = SOCK_STREAM;
-    addrHints.ai_protocol = IPPROTO_TCP;
-    addrinfo* addrInfoPtr = nullptr;
-    int lookupErr = getaddrinfo(
-        targetHostname.c_str(),
-        std::to_string(assignedMediaPort).c_str(),
-        &addrHints,
-        &addrInfoPtr);
-    // Store addr lookup in a smart pointer so it is free'd when it goes out of scope
-    std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> addrInfo(
-        addrInfoPtr,
-        &freeaddrinfo);
-    if (lookupErr != 0)
-    {
-        return Result<void>::Error("Error looking up hostname");
-    }
+    // Media goes to the same host we looked up for the control connection
+    sockaddr_storage mediaAddr {};
+    socklen_t mediaAddrLength = toSockaddr(targetAddr, assignedMediaPort, mediaAddr);
 
     // Attempt to open UDP connection
-    // TODO: Loop through additional addresses on failure. For now, only try the first one.
-    mediaSocketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    int connectErr = connect(
-        mediaSocketHandle,
-        addrInfo->ai_addr,
-        addrInfo->ai_addrlen);
+    int socketHandle = socket(targetAddr.GetFamily(), (SOCK_DGRAM | SOCK_CLOEXEC), IPPROTO_UDP);
+    if (socketHandle < 0)
+    {
+        return Result<void>::Error(
+            fmt::format("Error {} when creating FTL media socket", errno));
+    }
+    Result<void> bindResult = bindSocket(socketHandle, targetAddr.GetFamily());
+    if (bindResult.IsError)
+    {
+        close(socketHandle);
+        return bindResult;
+    }
+    int connectErr = ::connect(
+        socketHandle,
+        reinterpret_cast<const sockaddr*>(&mediaAddr),
+        mediaAddrLength);
     if (connectErr != 0)
     {
         int error = errno;
-        close(mediaSocketHandle);
-        mediaSocketHandle = 0;
+        close(socketHandle);
         return Result<void>::Error(
             fmt::format("Error {} when opening FTL media connection", error));
     }
 
+    std::lock_guard stoppingLock(stoppingMutex);
+    if (isStopping)
+    {
+        close(socketHandle);
+        return Result<void>::Error("Stopped while connecting");
+    }
+    mediaSocketHandle = socketHandle;
+    if (relayGroup != nullptr)
+    {
+        relayGroupTargetId = relayGroup->AddTarget(mediaSocketHandle);
+    }
+    else
+    {
+        mediaSendQueue = std::make_unique<DatagramSendQueue>(mediaSocketHandle,
+            DatagramSendQueue::DEFAULT_CAPACITY, pacingInterval);
+    }
+    isMediaConnected.store(true, std::memory_order_release);
+
+    return Result<void>::Success();
+}
+
+Result<void> FtlClient::bindSocket(int socketHandle, int family)
+{
+    Result<void> applyResult = binding.Apply(socketHandle, family);
+    if (applyResult.IsError || binding.Address.empty())
+    {
+        return applyResult;
+    }
+
+    // Pick the address we connect from, leaving the kernel to pick the port
+    Result<SocketBinding::BindAddress> bindAddress = binding.GetBindAddress(0, family);
+    if (bindAddress.IsError)
+    {
+        return Result<void>::Error(bindAddress.ErrorMessage);
+    }
+    if (bind(socketHandle, reinterpret_cast<const sockaddr*>(&bindAddress.Value.Address),
+        bindAddress.Value.Length) != 0)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format("Unable to bind relay socket to {}. Error {}: {}",
+            binding.Address, error, Util::ErrnoToString(error)));
+    }
     return Result<void>::Success();
 }
 
-void FtlClient::connectionThreadBody()
+void FtlClient::connectionThreadBody(FtlClient::ConnectMetadata metadata,
+    std::promise<Result<void>> connectedPromise)
 {
     // We set this promise value after the thread exits so we can properly
     // wait for the thread to exit after stopping the connection.
     connectionThreadEndedPromise.set_value_at_thread_exit();
 
-    std::string receivedBytes;
-    char recvBuffer[512] = {0};
-    int readBytes = 0;
-
-    while (true)
+    Result<void> connectResult = connectAndStartStream(metadata);
+    if (connectResult.IsError)
     {
-        readBytes = read(controlSocketHandle, recvBuffer, sizeof(recvBuffer));
-
-        if (readBytes <= 0)
+        spdlog::warn("Couldn't connect to {} for channel {}: {}", targetHostname, channelId,
+            connectResult.ErrorMessage);
+        if (resolver != nullptr)
         {
-            // TODO: We're closing or something went wrong
-            break;
+            // The host may have moved, look it up again next time
+            resolver->Invalidate(targetHostname);
         }
+        endConnection();
+        connectedPromise.set_value(connectResult);
+        return;
+    }
+    connectedPromise.set_value(Result<void>::Success());
 
-        receivedBytes.insert(receivedBytes.end(), recvBuffer, (recvBuffer + readBytes));
-        size_t requestEndPosition = 
-            receivedBytes.find('\n', (receivedBytes.size() - readBytes));
-        if (requestEndPosition != std::string::npos)
-        {
-            // Pull out the request
-            std::string requestStr(
-                receivedBytes.begin(),
-                (receivedBytes.begin() + requestEndPosition));
-            receivedBytes.erase(
-                receivedBytes.begin(),
-                (receivedBytes.begin() + requestEndPosition + 1)); // + 1 to erase the newline
-
-            // We expect at least a status code
-            if (requestStr.size() < 3)
-            {
-                // TODO: bad request.
-                break;
-            }
+    waitForConnectionClosed();
+    endConnection();
+}
 
-            // Parse the status code (3 digits)
-            uint16_t statusCode = 0;
-            try
+void FtlClient::waitForConnectionClosed()
+{
+    // We don't expect anything else on the control connection, just wait for it to close
+    char recvBuffer[512] = {0};
+    if (!onMediaBytesReceived)
+    {
+        while (read(controlSocketHandle, recvBuffer, sizeof(recvBuffer)) > 0)
+        { }
+        return;
+    }
+
+    // Someone wants to hear what the server sends back on the media connection too
+    std::array<std::byte, 2048> mediaBuffer;
+    std::array<pollfd, 2> pollFds = {{
+        { .fd = controlSocketHandle, .events = POLLIN, .revents = 0 },
+        { .fd = mediaSocketHandle, .events = POLLIN, .revents = 0 },
+    }};
+    while (true)
+    {
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
             {
-                int statusCodeInt = 
-                    std::stoi(std::string(requestStr.begin(), requestStr.begin() + 3));
-                if ((statusCodeInt >= 0) && (statusCodeInt < UINT16_MAX))
-                {
-                    statusCode = static_cast<uint16_t>(statusCodeInt);
-                }
-                else
-                {
-                    // TODO: bad request.
-                    break;
-                }
+                continue;
             }
-            catch (...)
+            return;
+        }
+        if (pollFds[1].revents != 0)
+        {
+            ssize_t readBytes = recv(mediaSocketHandle, mediaBuffer.data(), mediaBuffer.size(),
+                MSG_DONTWAIT);
+            if (readBytes > 0)
             {
-                // TODO: bad request.
-                break;
+                onMediaBytesReceived(std::span<const std::byte>(mediaBuffer.data(), readBytes));
             }
-
-            // Sometimes there's a space before the payload... sometimes there's not. 🤷‍♂️
-            std::string payload;
-            if ((requestStr.size() > 3) && (requestStr.at(3) == ' '))
+            else if ((readBytes == 0) ||
+                ((errno != EINTR) && (errno != EAGAIN) && (errno != ECONNREFUSED)))
             {
-                payload = std::string((requestStr.begin() + 4), requestStr.end());
+                // The media connection has been shut down, stop listening to it
+                pollFds[1].fd = -1;
             }
-            else
+        }
+        if (pollFds[0].revents != 0)
+        {
+            ssize_t readBytes = read(controlSocketHandle, recvBuffer, sizeof(recvBuffer));
+            if ((readBytes == 0) || ((readBytes < 0) && (errno != EINTR)))
             {
-                payload = std::string((requestStr.begin() + 3), requestStr.end());
+                return;
             }
+        }
+    }
+}
 
-            FtlClient::FtlResponse response
-            {
-                .statusCode = statusCode,
-                .payload = payload,
-            };
-            {
-                std::lock_guard<std::mutex> lock(recvResponseMutex);
-                receivedResponses.push(response);
-            }
-            recvResponseConditionVariable.notify_one();
+void FtlClient::closeMediaConnection()
+{
+    if (mediaSocketHandle != 0)
+    {
+        // Stop sending before the socket goes away, so the send queue never writes to a handle
+        // that could have been reused
+        shutdown(mediaSocketHandle, SHUT_RDWR);
+        if (mediaSendQueue != nullptr)
+        {
+            mediaSendQueue->Stop();
         }
+        if (relayGroupTargetId != 0)
+        {
+            relayGroup->RemoveTarget(relayGroupTargetId);
+        }
+        // The connection thread may still be listening to the socket, so it's left for
+        // endConnection to close once the thread is done with it
     }
-    endConnection();
 }
 
 void FtlClient::endConnection()
@@ -400,23 +548,25 @@ void FtlClient::endConnection()
         if (!isStopping)
         {
             // We haven't been asked to stop, so the connection was closed for another reason.
-            // Close the sockets.
             isStopping = true;
-            if (controlSocketHandle != 0)
-            {
-                shutdown(controlSocketHandle, SHUT_RDWR);
-                close(controlSocketHandle);
-            }
-            if (mediaSocketHandle != 0)
-            {
-                shutdown(mediaSocketHandle, SHUT_RDWR);
-                close(mediaSocketHandle);
-            }
+            closeMediaConnection();
 
             // We only callback when we haven't been explicitly told to stop (to avoid feedback loops)
             fireCallback = true;
         }
 
+        if (controlSocketHandle != 0)
+        {
+            shutdown(controlSocketHandle, SHUT_RDWR);
+            close(controlSocketHandle);
+            controlSocketHandle = 0;
+        }
+        if (mediaSocketHandle != 0)
+        {
+            close(mediaSocketHandle);
+            mediaSocketHandle = 0;
+        }
+
         if (!isStopped)
         {
             // By this point, the sockets have been closed.
@@ -430,32 +580,106 @@ void FtlClient::endConnection()
     }
 }
 
-void FtlClient::sendControlMessage(std::string message)
+Result<void> FtlClient::sendControlMessage(const std::string& message)
 {
-    size_t writeResult = write(controlSocketHandle, message.c_str(), message.size());
-    if (writeResult != message.size())
+    size_t bytesSent = 0;
+    while (bytesSent < message.size())
     {
-        // TODO: handle writeResult
+        ssize_t sendResult = send(controlSocketHandle, (message.data() + bytesSent),
+            (message.size() - bytesSent), MSG_NOSIGNAL);
+        if (sendResult < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return Result<void>::Error(
+                fmt::format("Error {} when writing to FTL control connection", errno));
+        }
+        bytesSent += sendResult;
     }
+    return Result<void>::Success();
 }
 
 Result<FtlClient::FtlResponse> FtlClient::waitForResponse(std::chrono::milliseconds timeout)
 {
-    std::unique_lock<std::mutex> lock(recvResponseMutex);
-    recvResponseConditionVariable.wait_for(
-        lock,
-        timeout,
-        [this]() { return !receivedResponses.empty(); });
-    if (receivedResponses.empty())
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true)
+    {
+        size_t responseEndPosition = receivedBytes.find('\n');
+        if (responseEndPosition != std::string::npos)
+        {
+            // Pull out the response
+            std::string responseStr(receivedBytes, 0, responseEndPosition);
+            receivedBytes.erase(0, (responseEndPosition + 1)); // + 1 to erase the newline
+            return parseResponse(responseStr);
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        pollfd pollFd = { .fd = controlSocketHandle, .events = POLLIN, .revents = 0 };
+        if ((remaining.count() <= 0) ||
+            (poll(&pollFd, 1, static_cast<int>(remaining.count())) == 0))
+        {
+            // We've timed out
+            return Result<FtlClient::FtlResponse>::Error(
+                "Timeout expired waiting for a response.");
+        }
+
+        char recvBuffer[512] = {0};
+        ssize_t readBytes = read(controlSocketHandle, recvBuffer, sizeof(recvBuffer));
+        if (readBytes <= 0)
+        {
+            if ((readBytes < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+            return Result<FtlClient::FtlResponse>::Error(
+                "Connection closed waiting for a response.");
+        }
+        receivedBytes.append(recvBuffer, readBytes);
+    }
+}
+
+Result<FtlClient::FtlResponse> FtlClient::parseResponse(const std::string& responseStr)
+{
+    // We expect at least a status code
+    if (responseStr.size() < 3)
     {
-        // We've timed out
-        return Result<FtlClient::FtlResponse>::Error("Timeout expired waiting for a response.");
+        return Result<FtlClient::FtlResponse>::Error("Received a response without a status code.");
+    }
+
+    // Parse the status code (3 digits)
+    uint16_t statusCode = 0;
+    try
+    {
+        int statusCodeInt = std::stoi(std::string(responseStr.begin(), responseStr.begin() + 3));
+        if ((statusCodeInt < 0) || (statusCodeInt >= UINT16_MAX))
+        {
+            return Result<FtlClient::FtlResponse>::Error("Received an invalid status code.");
+        }
+        statusCode = static_cast<uint16_t>(statusCodeInt);
+    }
+    catch (...)
+    {
+        return Result<FtlClient::FtlResponse>::Error("Received an invalid status code.");
+    }
+
+    // Sometimes there's a space before the payload... sometimes there's not. 🤷‍♂️
+    std::string payload;
+    if ((responseStr.size() > 3) && (responseStr.at(3) == ' '))
+    {
+        payload = std::string((responseStr.begin() + 4), responseStr.end());
     }
     else
     {
-        FtlClient::FtlResponse response = receivedResponses.front();
-        receivedResponses.pop();
-        return Result<FtlClient::FtlResponse>::Success(response);
+        payload = std::string((responseStr.begin() + 3), responseStr.end());
     }
+
+    return Result<FtlClient::FtlResponse>::Success(FtlClient::FtlResponse
+        {
+            .statusCode = statusCode,
+            .payload = payload,
+        });
 }
-#pragma endregion
\ No newline at end of file
+#pragma endregion
@@ -7,27 +7,37 @@
 
 #pragma once
 
+#include "Utilities/DatagramFanoutQueue.h"
+#include "Utilities/DatagramSendQueue.h"
 #include "Utilities/FtlTypes.h"
+#include "Utilities/HostnameResolver.h"
+#include "Utilities/IpAddress.h"
 #include "Utilities/Result.h"
+#include "Utilities/SocketBinding.h"
 
 extern "C"
 {
     #include <utils.h>
 }
 
+#include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <netinet/in.h>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
 
 /**
  * @brief A faster-than-light client used to connect to other janus-ftl-plugin instances.
+ *
+ * Connecting happens entirely on the client's own connection thread, so many clients can be
+ * connecting at once without holding up whoever started them.
  */
 class FtlClient
 {
@@ -55,16 +65,36 @@ public:
     };
 
     /* Constructor/Destructor */
+    /**
+     * @param resolver shared cache of hostname lookups, or nullptr to look up every time
+     * @param relayGroup
+     *  if provided, media is sent by the group (which is fed by whoever owns it) rather than
+     *  by a send queue of our own, and RelayPacket does nothing
+     * @param pacingInterval
+     *  most time bursts of relayed packets are spread out over by our own send queue, or 0 to
+     *  send them as fast as the socket takes them
+     * @param binding
+     *  address and interface to connect from, and how to tune our sockets. Sockets take the
+     *  family of the address the target hostname resolves to.
+     */
     FtlClient(
         std::string targetHostname,
         ftl_channel_id_t channelId,
-        std::vector<std::byte> streamKey);
+        std::vector<std::byte> streamKey,
+        std::shared_ptr<HostnameResolver> resolver = nullptr,
+        std::shared_ptr<DatagramFanoutQueue> relayGroup = nullptr,
+        std::chrono::milliseconds pacingInterval = std::chrono::milliseconds(0),
+        SocketBinding binding = {});
+    ~FtlClient();
     
     /* Public methods */
     /**
-     * @brief Starts FTL connection on a new thread.
+     * @brief
+     *  Starts FTL connection on a new thread, returning right away. The returned future is
+     *  fulfilled once the stream has started (or failed to). Packets relayed before then are
+     *  dropped.
      */
-    Result<void> ConnectAsync(FtlClient::ConnectMetadata metadata);
+    std::future<Result<void>> ConnectAsync(FtlClient::ConnectMetadata metadata);
 
     /**
      * @brief Stop the connection (blocks until close is complete)
@@ -77,9 +107,31 @@ public:
     void SetOnClosed(std::function<void()> onClosed);
 
     /**
-     * @brief Relays a packet from an incoming FtlStream
+     * @brief
+     *  Set the callback to be triggered with each datagram the server sends back on the media
+     *  connection, such as NACKs. It's called on the connection thread, and must be set before
+     *  connecting. Without one, nothing sent back is ever read.
+     */
+    void SetOnMediaBytesReceived(
+        std::function<void(const std::span<const std::byte>& bytes)> onMediaBytesReceived);
+
+    /**
+     * @brief
+     *  Queues a packet from an incoming FtlStream to be relayed. Never blocks on the network;
+     *  if the relay falls behind, packets are dropped according to their kind.
+     */
+    void RelayPacket(const PacketBuffer& packet, BoundedPacketQueue::PacketKind kind);
+
+    /* Getters/Setters */
+    DatagramSendQueue::Stats GetRelayStats();
+    /**
+     * @brief Whether the connection has failed to start, or has closed since it started
+     */
+    bool IsClosed();
+    /**
+     * @brief Whether the media connection is open, so relayed packets are being sent
      */
-    void RelayPacket(const std::vector<std::byte>& packet);
+    bool IsMediaConnected() const;
 
 private:
     /* Private structs */
@@ -92,11 +144,17 @@ private:
     /* Private static/constexpr members */
     static constexpr int FTL_PROTOCOL_VERSION_MAJOR = 0;
     static constexpr int FTL_PROTOCOL_VERSION_MINOR = 9;
+    static constexpr std::chrono::milliseconds CONNECT_TIMEOUT{1000};
+    static constexpr std::chrono::milliseconds RESPONSE_TIMEOUT{1000};
 
     /* Private members */
     const std::string targetHostname;
     const ftl_channel_id_t channelId;
     const std::vector<std::byte> streamKey;
+    const std::shared_ptr<HostnameResolver> resolver;
+    const std::shared_ptr<DatagramFanoutQueue> relayGroup;
+    const std::chrono::milliseconds pacingInterval;
+    const SocketBinding binding;
     bool isStopping = false; // Set once close has been called on the sockets and we
                              // are waiting for the connection thread to notice.
     bool isStopped = false;  // Set just before the connection thread exits.
@@ -105,22 +163,36 @@ private:
     std::promise<void> connectionThreadEndedPromise;
     std::future<void> connectionThreadEndedFuture = connectionThreadEndedPromise.get_future();
     std::thread connectionThread;
-    std::mutex recvResponseMutex;
-    std::condition_variable recvResponseConditionVariable;
-    std::queue<FtlResponse> receivedResponses;
+    std::thread::id connectionThreadId;
+    // Bytes read from the control connection that aren't part of a complete response yet,
+    // only touched by the connection thread
+    std::string receivedBytes;
+    IpAddress targetAddr;
     uint16_t assignedMediaPort = 0;
     int mediaSocketHandle = 0;
+    // Created once the media connection is open, and kept until we're destroyed
+    std::unique_ptr<DatagramSendQueue> mediaSendQueue;
+    // Our media socket's target in the relay group, if we're part of one
+    DatagramFanoutQueue::TargetId relayGroupTargetId = 0;
+    std::atomic<bool> isMediaConnected { false };
     // Callbacks
     std::function<void()> onClosed;
+    std::function<void(const std::span<const std::byte>& bytes)> onMediaBytesReceived;
 
     /* Private methods */
+    Result<void> connectAndStartStream(const FtlClient::ConnectMetadata& metadata);
     Result<void> openControlConnection();
     Result<void> authenticateControlConnection();
-    Result<void> sendControlStartStream(FtlClient::ConnectMetadata metadata);
+    Result<void> sendControlStartStream(const FtlClient::ConnectMetadata& metadata);
     Result<void> openMediaConnection();
-    void connectionThreadBody();
+    Result<void> bindSocket(int socketHandle, int family);
+    void connectionThreadBody(FtlClient::ConnectMetadata metadata,
+        std::promise<Result<void>> connectedPromise);
+    void waitForConnectionClosed();
+    void closeMediaConnection();
     void endConnection();
-    void sendControlMessage(std::string message);
+    Result<void> sendControlMessage(const std::string& message);
     Result<FtlClient::FtlResponse> waitForResponse(
-        std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+        std::chrono::milliseconds timeout = RESPONSE_TIMEOUT);
+    static Result<FtlClient::FtlResponse> parseResponse(const std::string& responseStr);
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+/**
+ * @file FtlControlCommandParser.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "FtlControlCommandParser.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr std::string_view HMAC_COMMAND = "HMAC";
+    constexpr std::string_view CONNECT_COMMAND = "CONNECT";
+    constexpr std::string_view DOT_COMMAND = ".";
+    constexpr std::string_view PING_COMMAND = "PING";
+    constexpr std::string_view ATTRIBUTE_SEPARATOR = ": ";
+
+    bool isLowercaseHexDigit(char c)
+    {
+        return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f'));
+    }
+
+    bool isLineBreak(char c)
+    {
+        return (c == '\r') || (c == '\n');
+    }
+}
+
+#pragma region Static methods
+std::optional<size_t> FtlControlCommandParser::FindDelimiter(std::string_view buffer,
+    size_t searchFrom)
+{
+    size_t index = buffer.find(DELIMITER, searchFrom);
+    if (index == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+    return index;
+}
+
+FtlControlCommandParser::CommandKind FtlControlCommandParser::GetCommandKind(
+    std::string_view command)
+{
+    // Attributes are checked before "." and PING, so "PING: x" is an attribute
+    if (command == HMAC_COMMAND)
+    {
+        return CommandKind::Hmac;
+    }
+    else if (command.starts_with(CONNECT_COMMAND))
+    {
+        return CommandKind::Connect;
+    }
+    else if (ParseAttribute(command).has_value())
+    {
+        return CommandKind::Attribute;
+    }
+    else if (command == DOT_COMMAND)
+    {
+        return CommandKind::Dot;
+    }
+    else if (command.starts_with(PING_COMMAND))
+    {
+        return CommandKind::Ping;
+    }
+    return CommandKind::Unknown;
+}
+
+std::optional<FtlControlCommandParser::ConnectArguments> FtlControlCommandParser::ParseConnect(
+    std::string_view command)
+{
+    if (!command.starts_with(CONNECT_COMMAND))
+    {
+        return std::nullopt;
+    }
+    command.remove_prefix(CONNECT_COMMAND.size());
+    if (!command.starts_with(' '))
+    {
+        return std::nullopt;
+    }
+    command.remove_prefix(1);
+
+    size_t channelIdEnd = command.find(' ');
+    if (channelIdEnd == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+    std::optional<ftl_channel_id_t> channelId =
+        ParseUnsigned<ftl_channel_id_t>(command.substr(0, channelIdEnd));
+    if (!channelId.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::string_view hmacHash = command.substr(channelIdEnd + 1);
+    if (!hmacHash.starts_with('$'))
+    {
+        return std::nullopt;
+    }
+    hmacHash.remove_prefix(1);
+    if (hmacHash.empty() || !std::all_of(hmacHash.begin(), hmacHash.end(), isLowercaseHexDigit))
+    {
+        return std::nullopt;
+    }
+
+    return ConnectArguments
+    {
+        .ChannelId = channelId.value(),
+        .HmacHash = hmacHash,
+    };
+}
+
+std::optional<FtlControlCommandParser::Attribute> FtlControlCommandParser::ParseAttribute(
+    std::string_view command)
+{
+    size_t separatorIndex = command.find(ATTRIBUTE_SEPARATOR);
+    if ((separatorIndex == std::string_view::npos) || (separatorIndex == 0) ||
+        ((separatorIndex + ATTRIBUTE_SEPARATOR.size()) >= command.size()) ||
+        std::any_of(command.begin(), command.end(), isLineBreak))
+    {
+        return std::nullopt;
+    }
+
+    return Attribute
+    {
+        .Key = command.substr(0, separatorIndex),
+        .Value = command.substr(separatorIndex + ATTRIBUTE_SEPARATOR.size()),
+    };
+}
+#pragma endregion Static methods
@@ -0,0 +1,93 @@
+/**
+ * @file FtlControlCommandParser.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Utilities/FtlTypes.h"
+
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @brief
+ *  Splits and tokenizes FTL control connection commands in place, without regular expressions
+ *  or allocations. Returned views point into the command that was parsed.
+ */
+class FtlControlCommandParser
+{
+public:
+    /* Public types */
+    enum class CommandKind
+    {
+        Unknown = 0,
+        Hmac,
+        Connect,
+        Attribute,
+        Dot,
+        Ping,
+    };
+
+    struct ConnectArguments
+    {
+        ftl_channel_id_t ChannelId;
+        // Lowercase hex string
+        std::string_view HmacHash;
+    };
+
+    struct Attribute
+    {
+        std::string_view Key;
+        std::string_view Value;
+    };
+
+    /* Constants */
+    static constexpr std::string_view DELIMITER = "\r\n\r\n";
+
+    /* Static methods */
+    /**
+     * @brief Returns the index of the first command delimiter at or after searchFrom, if any
+     */
+    static std::optional<size_t> FindDelimiter(std::string_view buffer, size_t searchFrom = 0);
+
+    /**
+     * @brief
+     *  Works out which kind of command this is (minus its delimiter). Anything starting with
+     *  CONNECT is a CONNECT command, even if its arguments turn out to be malformed.
+     */
+    static CommandKind GetCommandKind(std::string_view command);
+
+    /**
+     * @brief Parses "CONNECT <channel id> $<hmac hash>"
+     */
+    static std::optional<ConnectArguments> ParseConnect(std::string_view command);
+
+    /**
+     * @brief
+     *  Parses "<key>: <value>", splitting at the first ": ". Neither side can be empty or span
+     *  multiple lines.
+     */
+    static std::optional<Attribute> ParseAttribute(std::string_view command);
+
+    /**
+     * @brief Parses a complete decimal value, failing on anything else or on overflow
+     */
+    template<typename T>
+    static std::optional<T> ParseUnsigned(std::string_view value)
+    {
+        T result {};
+        const char* end = value.data() + value.size();
+        auto [ptr, error] = std::from_chars(value.data(), end, result);
+        if (value.empty() || (error != std::errc()) || (ptr != end))
+        {
+            return std::nullopt;
+        }
+        return result;
+    }
+};
@@ -7,25 +7,67 @@
 
 #include <algorithm>
 #include <openssl/hmac.h>
+#include <type_traits>
 
 #include "ConnectionTransports/ConnectionTransport.h"
 #include "FtlControlConnection.h"
+#include "FtlHandoff.h"
 #include "FtlStream.h"
 #include "Utilities/Util.h"
 
-const std::regex FtlControlConnection::CONNECT_PATTERN =
-    std::regex(R"~(CONNECT ([0-9]+) \$([0-9a-f]+))~");
-const std::regex FtlControlConnection::ATTRIBUTE_PATTERN = std::regex(R"~((.+): (.+))~");
-
 #pragma region Constructor/Destructor
 FtlControlConnection::FtlControlConnection(
     FtlControlConnectionManager* connectionManager,
-    std::unique_ptr<ConnectionTransport> transport)
+    std::unique_ptr<ConnectionTransport> transport,
+    std::shared_ptr<EpollReactor> reactor,
+    const FtlStreamHandoff* resumeFrom)
 :
     connectionManager(connectionManager),
     transport(std::move(transport)),
-    thread(std::bind(&FtlControlConnection::threadBody, this, std::placeholders::_1))
+    reactor(std::move(reactor))
+{
+    if (resumeFrom != nullptr)
+    {
+        hmacRequested = true;
+        isAuthenticated = true;
+        isStreaming = true;
+        channelId = resumeFrom->ChannelId;
+        mediaMetadata = resumeFrom->Metadata;
+        commandBuffer = resumeFrom->PendingControlBytes;
+    }
+
+    // Start reading commands, either from a shared reactor or our own thread
+    std::optional<int> pollHandle = this->transport->GetPollHandle();
+    if (this->reactor && pollHandle.has_value())
+    {
+        Result<EpollReactor::RegistrationId> registerResult = this->reactor->Register(
+            pollHandle.value(),
+            [this]() { return readAvailableBytes(std::chrono::milliseconds(0)); },
+            std::bind(&FtlControlConnection::onTransportClosed, this));
+        if (registerResult.IsError)
+        {
+            spdlog::warn("Could not register control connection with reactor, falling back to "
+                "a dedicated thread: {}", registerResult.ErrorMessage);
+        }
+        else
+        {
+            reactorRegistration = registerResult.Value;
+        }
+    }
+    if (!reactorRegistration.has_value())
+    {
+        thread = std::jthread(
+            std::bind(&FtlControlConnection::threadBody, this, std::placeholders::_1));
+    }
+}
+
+FtlControlConnection::~FtlControlConnection()
 {
+    if (reactorRegistration.has_value())
+    {
+        reactor->Unregister(reactorRegistration.value());
+        reactor->WaitUntilUnregistered(reactorRegistration.value());
+    }
 }
 #pragma endregion Constructor/Destructor
 
@@ -35,6 +77,11 @@ ftl_channel_id_t FtlControlConnection::GetChannelId()
     return channelId;
 }
 
+std::optional<std::chrono::microseconds> FtlControlConnection::GetRoundTripTime()
+{
+    return transport->GetRoundTripTime();
+}
+
 std::optional<sockaddr_in> FtlControlConnection::GetAddr()
 {
     return transport->GetAddr();
@@ -75,8 +122,9 @@ void FtlControlConnection::ProvideHmacKey(const std::vector<std::byte>& hmacKey)
     {
         isAuthenticated = true;
         writeToTransport(fmt::format("{}\n", FtlResponseCode::FTL_INGEST_RESP_OK));
-        std::string addrStr = transport->GetAddr().has_value() ? 
-            Util::AddrToString(transport->GetAddr().value().sin_addr) : "UNKNOWN";
+        std::optional<IpAddress> addr = IpAddress::FromSockaddr(transport->GetAddr(),
+            transport->GetAddr6());
+        std::string addrStr = addr.has_value() ? addr.value().ToString() : "UNKNOWN";
         spdlog::info("{} authenticated as Channel {} successfully.", addrStr,
             channelId);
     }
@@ -106,28 +154,82 @@ void FtlControlConnection::TerminateWithResponse(FtlResponseCode responseCode)
     writeToTransport(fmt::format("{}\n", responseCode));
     requestStop();
 }
+
+Result<void> FtlControlConnection::HandOff(FtlStreamHandoff& handoff)
+{
+    isHandingOff = true;
+    if (reactorRegistration.has_value())
+    {
+        reactor->Unregister(reactorRegistration.value());
+        reactor->WaitUntilUnregistered(reactorRegistration.value());
+    }
+    else if (thread.joinable())
+    {
+        thread.request_stop();
+        thread.join();
+    }
+
+    // A connection that can't be handed off closes as it would have if it had been stopped
+    Result<std::optional<int>> detachResult = isStreaming ? transport->Detach() :
+        Result<std::optional<int>>::Error("Only streaming control connections can be handed off");
+    if (!detachResult.IsError && !detachResult.Value.has_value())
+    {
+        detachResult = Result<std::optional<int>>::Error(
+            "Control connection transport has no handle to hand off");
+    }
+    if (detachResult.IsError)
+    {
+        isHandingOff = false;
+        onTransportClosed();
+        return Result<void>::Error(detachResult.ErrorMessage);
+    }
+    handoff.ChannelId = channelId;
+    handoff.Metadata = mediaMetadata;
+    handoff.ControlAddr = transport->GetAddr();
+    handoff.ControlAddr6 = transport->GetAddr6();
+    handoff.PendingControlBytes = commandBuffer;
+    handoff.ControlHandle = detachResult.Value.value();
+    return Result<void>::Success();
+}
 #pragma endregion Public functions
 
 #pragma region Private functions
 
 void FtlControlConnection::threadBody(std::stop_token stopToken)
 {
-    std::vector<std::byte> buffer;
-
     while (!stopToken.stop_requested())
     {
-        auto result = transport->Read(buffer, READ_TIMEOUT);
-        if (result.IsError) {
-            spdlog::error("Failed to read from control connection transport: {}", result.ErrorMessage);
+        if (!readAvailableBytes(READ_TIMEOUT))
+        {
             break;
         }
+    }
 
-        if (result.Value > 0) {
-            onTransportBytesReceived(buffer);
-        }
+    onTransportClosed();
+}
+
+bool FtlControlConnection::readAvailableBytes(std::chrono::milliseconds timeout)
+{
+    auto result = transport->Read(readBuffer, timeout);
+    if (result.IsError) {
+        spdlog::error("Failed to read from control connection transport: {}", result.ErrorMessage);
+        return false;
+    }
+
+    if (result.Value > 0) {
+        onTransportBytesReceived(readBuffer);
     }
+    return true;
+}
 
-    spdlog::debug("Stopping control connection thread for Channel {}", channelId);
+void FtlControlConnection::onTransportClosed()
+{
+    if (isHandingOff)
+    {
+        // The transport lives on in another process
+        return;
+    }
+    spdlog::debug("Stopping control connection for Channel {}", channelId);
 
     // First, stop the transport to let the client know the stream has ended
     transport->Stop();
@@ -146,43 +248,32 @@ void FtlControlConnection::threadBody(std::stop_token stopToken)
 void FtlControlConnection::onTransportBytesReceived(const std::vector<std::byte>& bytes)
 {
     // Tack the new bytes onto the end of our running buffer
-    commandBuffer.reserve(commandBuffer.size() + bytes.size());
-    commandBuffer.insert(commandBuffer.end(), reinterpret_cast<const char*>(bytes.data()),
-        (reinterpret_cast<const char*>(bytes.data()) + bytes.size()));
+    const size_t previousSize = commandBuffer.size();
+    commandBuffer.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
 
-    // Check to see if we've read a complete command
+    // Process every complete command we've read
     // (we only search backwards a little bit, since we've presumably already searched through
     // the previous payloads)
-    int startDelimiterSearchIndex = std::max(0,
-        static_cast<int>(commandBuffer.size() - bytes.size() - DELIMITER_SEQUENCE.size()));
-    size_t delimiterCharactersRead = 0;
-    for (size_t i = startDelimiterSearchIndex; i < commandBuffer.size();)
+    const std::string_view buffer(commandBuffer);
+    const size_t delimiterSize = FtlControlCommandParser::DELIMITER.size();
+    size_t searchFrom = previousSize - std::min(previousSize, (delimiterSize - 1));
+    size_t commandStart = 0;
+    while (std::optional<size_t> delimiterIndex =
+        FtlControlCommandParser::FindDelimiter(buffer, searchFrom))
     {
-        if (commandBuffer.at(i) == DELIMITER_SEQUENCE.at(delimiterCharactersRead))
-        {
-            ++delimiterCharactersRead;
-            if (delimiterCharactersRead >= DELIMITER_SEQUENCE.size())
-            {
-                // We've read a command, split it into its own string (minus the delimiter seq)
-                std::string command(commandBuffer.begin(),
-                    (commandBuffer.begin() + i + 1 - DELIMITER_SEQUENCE.size()));
-
-                // Delete the processed portion of the buffer (including the delimiter seq)
-                commandBuffer.erase(commandBuffer.begin(), (commandBuffer.begin() + i + 1));
-                i = 0;
-                delimiterCharactersRead = 0;
-                processCommand(command);
-            }
-            else
-            {
-                ++i;
-            }
-        }
-        else
-        {
-            delimiterCharactersRead = 0;
-            ++i;
-        }
+        processCommand(buffer.substr(commandStart, (delimiterIndex.value() - commandStart)));
+        commandStart = delimiterIndex.value() + delimiterSize;
+        searchFrom = commandStart;
+    }
+
+    // Delete the processed portion of the buffer (including the delimiter seq)
+    commandBuffer.erase(0, commandStart);
+    if (commandBuffer.size() > MAX_COMMAND_SIZE)
+    {
+        spdlog::warn("Client sent a command longer than {} bytes, disconnecting...",
+            MAX_COMMAND_SIZE);
+        commandBuffer.clear();
+        requestStop();
     }
 }
 
@@ -198,34 +289,39 @@ void FtlControlConnection::writeToTransport(const std::string& str)
 
 void FtlControlConnection::requestStop()
 {
-    thread.request_stop();
+    if (reactorRegistration.has_value())
+    {
+        reactor->Unregister(reactorRegistration.value());
+    }
+    else
+    {
+        thread.request_stop();
+    }
 }
 
-void FtlControlConnection::processCommand(const std::string& command)
+void FtlControlConnection::processCommand(std::string_view command)
 {
-    if (command.compare("HMAC") == 0)
+    switch (FtlControlCommandParser::GetCommandKind(command))
     {
+    case FtlControlCommandParser::CommandKind::Hmac:
         processHmacCommand();
-    }
-    else if (command.substr(0,7).compare("CONNECT") == 0)
-    {
+        break;
+    case FtlControlCommandParser::CommandKind::Connect:
         processConnectCommand(command);
-    }
-    else if (std::regex_match(command, ATTRIBUTE_PATTERN))
-    {
-        processAttributeCommand(command);
-    }
-    else if (command.compare(".") == 0)
-    {
+        break;
+    case FtlControlCommandParser::CommandKind::Attribute:
+        processAttributeCommand(FtlControlCommandParser::ParseAttribute(command).value());
+        break;
+    case FtlControlCommandParser::CommandKind::Dot:
         processDotCommand();
-    }
-    else if (command.substr(0,4).compare("PING") == 0)
-    {
+        break;
+    case FtlControlCommandParser::CommandKind::Ping:
         processPingCommand();
-    }
-    else
-    {
+        break;
+    case FtlControlCommandParser::CommandKind::Unknown:
+    default:
         spdlog::warn("Unknown ingest command: {}", command);
+        break;
     }
 }
 
@@ -239,52 +335,35 @@ void FtlControlConnection::processHmacCommand()
     writeToTransport(fmt::format("{} {}\n", FtlResponseCode::FTL_INGEST_RESP_OK, hmacString));
 }
 
-void FtlControlConnection::processConnectCommand(const std::string& command)
+void FtlControlConnection::processConnectCommand(std::string_view command)
 {
-    std::smatch matches;
-
-    if (std::regex_search(command, matches, CONNECT_PATTERN) && matches.size() == 3)
+    std::optional<FtlControlCommandParser::ConnectArguments> connectArguments =
+        FtlControlCommandParser::ParseConnect(command);
+    if (!connectArguments.has_value())
     {
-        std::string channelIdStr = matches[1].str();
-        std::string hmacHashStr = matches[2].str();
-
-        ftl_channel_id_t requestedChannelId = 0;
-        try
-        {
-            requestedChannelId = static_cast<ftl_channel_id_t>(std::stoul(channelIdStr));
-        }
-        catch(const std::exception& /*e*/)
-        {
-            spdlog::warn("Client provided invalid channel ID value, disconnecting: {}",
-                channelIdStr);
-            requestStop();
-            return;
-        }
-        if (hmacRequested)
-        {
-            spdlog::error("Control connection attempted multiple CONNECT handshakes");
-            requestStop();
-            return;
-        }
-
-        // Store the client's hash and requested channel ID
-        channelId = requestedChannelId;
-        clientHmacHash = Util::HexStringToByteArray(hmacHashStr);
-
-        // Let the FtlControlConnectionManager know that we need an hmac key
-        // to calculate our own hash!
-        hmacRequested = true;
-        connectionManager->ControlConnectionRequestedHmacKey(this, requestedChannelId);
+        spdlog::info("Malformed CONNECT request, disconnecting: {}", command);
+        requestStop();
+        return;
     }
-    else
+    if (hmacRequested)
     {
-        spdlog::info("Malformed CONNECT request, disconnecting: {}", command);
+        spdlog::error("Control connection attempted multiple CONNECT handshakes");
         requestStop();
         return;
     }
+
+    // Store the client's hash and requested channel ID
+    channelId = connectArguments.value().ChannelId;
+    clientHmacHash = Util::HexStringToByteArray(std::string(connectArguments.value().HmacHash));
+
+    // Let the FtlControlConnectionManager know that we need an hmac key
+    // to calculate our own hash!
+    hmacRequested = true;
+    connectionManager->ControlConnectionRequestedHmacKey(this, channelId);
 }
 
-void FtlControlConnection::processAttributeCommand(const std::string& command)
+void FtlControlConnection::processAttributeCommand(
+    const FtlControlCommandParser::Attribute& attribute)
 {
     if (!isAuthenticated)
     {
@@ -300,112 +379,74 @@ void FtlControlConnection::processAttributeCommand(const std::string& command)
         return;
     }
 
-    std::smatch matches;
-
-    if (std::regex_match(command, matches, ATTRIBUTE_PATTERN) &&
-        matches.size() >= 3)
-    {
-        std::string key = matches[1].str();
-        std::string value = matches[2].str();
-
-        if (key.compare("VendorName") == 0)
-        {
-            mediaMetadata.VendorName = value;
-        }
-        else if (key.compare("VendorVersion") == 0)
-        {
-            mediaMetadata.VendorVersion = value;
-        }
-        else if (key.compare("Video") == 0)
-        {
-            mediaMetadata.HasVideo = (value.compare("true") == 0);
-        }
-        else if (key.compare("Audio") == 0)
-        {
-            mediaMetadata.HasAudio = (value.compare("true") == 0);
-        }
-        else if (key.compare("VideoCodec") == 0)
-        {
-            mediaMetadata.VideoCodec = SupportedVideoCodecs::ParseVideoCodec(value);
-        }
-        else if (key.compare("AudioCodec") == 0)
-        {
-            mediaMetadata.AudioCodec = SupportedAudioCodecs::ParseAudioCodec(value);
-        }
-        else if (key.compare("VideoWidth") == 0)
-        {
-            try
-            {
-                mediaMetadata.VideoWidth = std::stoul(value);
-            }
-            catch(const std::exception& /*e*/)
-            {
-                spdlog::warn("Client provided invalid video width value: {}", value);
-            }
-        }
-        else if (key.compare("VideoHeight") == 0)
-        {
-            try
-            {
-                mediaMetadata.VideoHeight = std::stoul(value);
-            }
-            catch(const std::exception& /*e*/)
-            {
-                spdlog::warn("Client provided invalid video height value: {}", value);
-            }
-        }
-        else if (key.compare("VideoIngestSSRC") == 0)
-        {
-            try
-            {
-                mediaMetadata.VideoSsrc = std::stoul(value);
-            }
-            catch(const std::exception& /*e*/)
-            {
-                spdlog::warn("Client provided invalid video ssrc value: {}", value);
-            }
-        }
-        else if (key.compare("AudioIngestSSRC") == 0)
-        {
-            try
-            {
-                mediaMetadata.AudioSsrc = std::stoul(value);
-            }
-            catch(const std::exception& /*e*/)
-            {
-                spdlog::warn("Client provided invalid audio ssrc value: {}", value);
-            }
-        }
-        else if (key.compare("VideoPayloadType") == 0)
+    const std::string_view key = attribute.Key;
+    const std::string_view value = attribute.Value;
+    // Stores a numeric attribute value, or complains about it if it doesn't fit
+    auto assignUnsigned = [value](auto& field, std::string_view description)
         {
-            try
-            {
-                mediaMetadata.VideoPayloadType = std::stoul(value);
-            }
-            catch(const std::exception& /*e*/)
+            auto parsedValue = FtlControlCommandParser::ParseUnsigned<
+                std::remove_reference_t<decltype(field)>>(value);
+            if (parsedValue.has_value())
             {
-                spdlog::warn("Client provided invalid video payload type value: {}", value);
+                field = parsedValue.value();
             }
-        }
-        else if (key.compare("AudioPayloadType") == 0)
-        {
-            try
-            {
-                mediaMetadata.AudioPayloadType = std::stoul(value);
-            }
-            catch(const std::exception& /*e*/)
+            else
             {
-                spdlog::warn("Client provided invalid audio payload type value: {}", value);
+                spdlog::warn("Client provided invalid {} value: {}", description, value);
             }
-        }
-        else
-        {
-            spdlog::warn("Received unrecognized attribute from client: {}: {}", key, value);
-        }
+        };
+
+    if (key == "VendorName")
+    {
+        mediaMetadata.VendorName = value;
+    }
+    else if (key == "VendorVersion")
+    {
+        mediaMetadata.VendorVersion = value;
+    }
+    else if (key == "Video")
+    {
+        mediaMetadata.HasVideo = (value == "true");
+    }
+    else if (key == "Audio")
+    {
+        mediaMetadata.HasAudio = (value == "true");
+    }
+    else if (key == "VideoCodec")
+    {
+        mediaMetadata.VideoCodec = SupportedVideoCodecs::ParseVideoCodec(std::string(value));
+    }
+    else if (key == "AudioCodec")
+    {
+        mediaMetadata.AudioCodec = SupportedAudioCodecs::ParseAudioCodec(std::string(value));
+    }
+    else if (key == "VideoWidth")
+    {
+        assignUnsigned(mediaMetadata.VideoWidth, "video width");
+    }
+    else if (key == "VideoHeight")
+    {
+        assignUnsigned(mediaMetadata.VideoHeight, "video height");
+    }
+    else if (key == "VideoIngestSSRC")
+    {
+        assignUnsigned(mediaMetadata.VideoSsrc, "video ssrc");
+    }
+    else if (key == "AudioIngestSSRC")
+    {
+        assignUnsigned(mediaMetadata.AudioSsrc, "audio ssrc");
+    }
+    else if (key == "VideoPayloadType")
+    {
+        assignUnsigned(mediaMetadata.VideoPayloadType, "video payload type");
+    }
+    else if (key == "AudioPayloadType")
+    {
+        assignUnsigned(mediaMetadata.AudioPayloadType, "audio payload type");
     }
     else
     {
-        spdlog::warn("Received malformed attribute command from client: {}", command);
+        spdlog::warn("Received unrecognized attribute from client: {}: {}", key, value);
     }
 }
 
@@ -446,10 +487,20 @@ void FtlControlConnection::processDotCommand()
         return;
     }
 
-    // HACK: We assume GetAddr() returns a value here.
+    // Media comes from the same address as the control connection
+    std::optional<IpAddress> addr = IpAddress::FromSockaddr(transport->GetAddr(),
+        transport->GetAddr6());
+    if (!addr.has_value())
+    {
+        spdlog::warn("Client attempted to start stream without an address to receive media "
+            "from.");
+        requestStop();
+        return;
+    }
+
     // Tell the FtlControlConnectionManager we want a media port!
     connectionManager->ControlConnectionRequestedMediaPort(this, channelId, mediaMetadata,
-        transport->GetAddr().value().sin_addr);
+        addr.value());
 }
 
 void FtlControlConnection::processPingCommand()
@@ -7,21 +7,27 @@
 
 #pragma once
 
+#include "FtlControlCommandParser.h"
 #include "FtlControlConnectionManager.h"
+#include "Utilities/EpollReactor.h"
 #include "Utilities/FtlTypes.h"
+#include "Utilities/IpAddress.h"
 #include "Utilities/Result.h"
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
 #include <netinet/in.h>
-#include <regex>
 #include <sstream>
+#include <string_view>
 #include <thread>
 
 // Forward declarations
 class ConnectionTransport;
 class FtlStream;
+struct FtlStreamHandoff;
 
 /**
  * @brief Manages incoming FTL control connections
@@ -55,31 +61,54 @@ public:
     };
 
     /* Constructor/Destructor */
+    /**
+     * @param resumeFrom
+     *  a streaming connection handed over by another process to carry on with, which is
+     *  already authenticated and has been assigned its media port
+     */
     FtlControlConnection(
         FtlControlConnectionManager* connectionManager,
-        std::unique_ptr<ConnectionTransport> transport);
+        std::unique_ptr<ConnectionTransport> transport,
+        std::shared_ptr<EpollReactor> reactor = nullptr,
+        const FtlStreamHandoff* resumeFrom = nullptr);
+    ~FtlControlConnection();
 
     /* Getters/Setters */
     ftl_channel_id_t GetChannelId();
     std::optional<sockaddr_in> GetAddr();
+    /**
+     * @brief Round trip time to the client as measured by the connection's transport, if known
+     */
+    std::optional<std::chrono::microseconds> GetRoundTripTime();
     void SetFtlStream(FtlStream* ftlStream);
 
     /* Public functions */
     void ProvideHmacKey(const std::vector<std::byte>& hmacKey);
     void StartMediaPort(uint16_t mediaPort);
     void TerminateWithResponse(FtlResponseCode responseCode = FtlResponseCode::FTL_INGEST_RESP_SERVER_TERMINATE);
+    /**
+     * @brief
+     *  Stops reading without closing the connection or notifying anyone, filling in what
+     *  another process needs to carry on with it. The transport's handle is owned by the
+     *  handoff from then on. If it can't be handed off, the connection is closed as if it
+     *  had stopped.
+     */
+    Result<void> HandOff(FtlStreamHandoff& handoff);
 
 private:
     /* Constants */
-    static constexpr std::array<char, 4> DELIMITER_SEQUENCE = { '\r', '\n', '\r', '\n' };
     static constexpr int HMAC_PAYLOAD_SIZE = 128;
     static constexpr std::chrono::milliseconds READ_TIMEOUT{200};
-    static const std::regex CONNECT_PATTERN;
-    static const std::regex ATTRIBUTE_PATTERN;
+    // Clients that send more than this without finishing a command are disconnected
+    static constexpr size_t MAX_COMMAND_SIZE = 4096;
 
     /* Private fields */
     FtlControlConnectionManager* const connectionManager;
     const std::unique_ptr<ConnectionTransport> transport;
+    // Reactor this connection is read from, if not read from its own thread
+    const std::shared_ptr<EpollReactor> reactor;
+    std::optional<EpollReactor::RegistrationId> reactorRegistration;
+    std::vector<std::byte> readBuffer;
     FtlStream* ftlStream = nullptr;
     bool hmacRequested = false;
     bool isAuthenticated = false;
@@ -90,20 +119,24 @@ private:
     MediaMetadata mediaMetadata {};
     // Command processing
     std::string commandBuffer;
-    // Thread to read and process data from the connection, must be initialized last
+    // Set while handing off, so reading stops without the transport being closed
+    std::atomic<bool> isHandingOff { false };
+    // Thread to read and process data from the connection when a reactor is not in use,
+    // must be initialized last
     std::jthread thread;
 
     /* Private functions */
     void threadBody(std::stop_token stopToken);
+    bool readAvailableBytes(std::chrono::milliseconds timeout);
     void onTransportBytesReceived(const std::vector<std::byte>& bytes);
     void onTransportClosed();
     void writeToTransport(const std::string& str);
     void requestStop();
     // Command processing
-    void processCommand(const std::string& command);
+    void processCommand(std::string_view command);
     void processHmacCommand();
-    void processConnectCommand(const std::string& command);
-    void processAttributeCommand(const std::string& command);
+    void processConnectCommand(std::string_view command);
+    void processAttributeCommand(const FtlControlCommandParser::Attribute& attribute);
     void processDotCommand();
     void processPingCommand();
 };
\ No newline at end of file
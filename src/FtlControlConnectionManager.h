@@ -7,9 +7,8 @@
 
 #pragma once
 
-#include <arpa/inet.h>
-
 #include "Utilities/FtlTypes.h"
+#include "Utilities/IpAddress.h"
 
 // Forward declarations
 class FtlControlConnection;
@@ -37,6 +36,6 @@ public:
      * @brief Called by FtlControlConnection when it needs a media port assigned
      */
     virtual void ControlConnectionRequestedMediaPort(FtlControlConnection* connection,
-        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, in_addr targetAddr) = 0;
+        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, IpAddress targetAddr) = 0;
 
 };
\ No newline at end of file
@@ -0,0 +1,429 @@
+/**
+ * @file FtlHandoff.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "FtlHandoff.h"
+
+#include "Utilities/UnixSocketHandoff.h"
+
+#include <unistd.h>
+
+namespace
+{
+    // Stream message flags, saying which handles came with it (in this order)
+    constexpr uint8_t HAS_CONTROL_HANDLE = 0x01;
+    constexpr uint8_t HAS_MEDIA_HANDLE = 0x02;
+
+    // Which kind of address follows in a stream message, if any
+    constexpr uint8_t NO_ADDR = 0;
+    constexpr uint8_t IPV4_ADDR = 4;
+    constexpr uint8_t IPV6_ADDR = 6;
+
+    /**
+     * @brief Appends values to a message payload in network byte order
+     */
+    class PayloadWriter
+    {
+    public:
+        template<typename T>
+        void Write(T value)
+        {
+            static_assert(std::is_unsigned_v<T>);
+            for (size_t i = sizeof(T); i > 0; --i)
+            {
+                payload.push_back(static_cast<std::byte>((value >> ((i - 1) * 8)) & 0xFF));
+            }
+        }
+
+        void WriteString(const std::string& value)
+        {
+            Write(static_cast<uint16_t>(value.size()));
+            for (const char& c : value)
+            {
+                payload.push_back(static_cast<std::byte>(c));
+            }
+        }
+
+        void WriteAddr(const std::optional<sockaddr_in>& addr,
+            const std::optional<sockaddr_in6>& addr6)
+        {
+            // Already in network byte order
+            if (addr.has_value())
+            {
+                Write(IPV4_ADDR);
+                Write(ntohl(addr.value().sin_addr.s_addr));
+                Write(ntohs(addr.value().sin_port));
+            }
+            else if (addr6.has_value())
+            {
+                Write(IPV6_ADDR);
+                for (const uint8_t& b : addr6.value().sin6_addr.s6_addr)
+                {
+                    Write(b);
+                }
+                Write(ntohs(addr6.value().sin6_port));
+            }
+            else
+            {
+                Write(NO_ADDR);
+            }
+        }
+
+        std::vector<std::byte> Take()
+        {
+            return std::move(payload);
+        }
+
+    private:
+        std::vector<std::byte> payload;
+    };
+
+    /**
+     * @brief Reads back what a PayloadWriter wrote, remembering if it ever ran out of bytes
+     */
+    class PayloadReader
+    {
+    public:
+        PayloadReader(std::span<const std::byte> payload) : payload(payload) { }
+
+        template<typename T>
+        T Read()
+        {
+            static_assert(std::is_unsigned_v<T>);
+            if ((payload.size() - offset) < sizeof(T))
+            {
+                isValid = false;
+                offset = payload.size();
+                return 0;
+            }
+            T value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                value = (value << 8) | static_cast<T>(payload[offset++]);
+            }
+            return value;
+        }
+
+        std::string ReadString()
+        {
+            const uint16_t size = Read<uint16_t>();
+            if ((payload.size() - offset) < size)
+            {
+                isValid = false;
+                offset = payload.size();
+                return {};
+            }
+            std::string value(reinterpret_cast<const char*>(&payload[offset]), size);
+            offset += size;
+            return value;
+        }
+
+        void ReadAddr(std::optional<sockaddr_in>& addr, std::optional<sockaddr_in6>& addr6)
+        {
+            const uint8_t kind = Read<uint8_t>();
+            if (kind == IPV4_ADDR)
+            {
+                addr = sockaddr_in { .sin_family = AF_INET };
+                addr.value().sin_addr.s_addr = htonl(Read<uint32_t>());
+                addr.value().sin_port = htons(Read<uint16_t>());
+            }
+            else if (kind == IPV6_ADDR)
+            {
+                addr6 = sockaddr_in6 { .sin6_family = AF_INET6 };
+                for (uint8_t& b : addr6.value().sin6_addr.s6_addr)
+                {
+                    b = Read<uint8_t>();
+                }
+                addr6.value().sin6_port = htons(Read<uint16_t>());
+            }
+            else if (kind != NO_ADDR)
+            {
+                isValid = false;
+            }
+        }
+
+        bool IsValid() const
+        {
+            return isValid;
+        }
+
+        bool IsAtEnd() const
+        {
+            return offset == payload.size();
+        }
+
+    private:
+        std::span<const std::byte> payload;
+        size_t offset = 0;
+        bool isValid = true;
+    };
+
+    void closeAll(std::span<const int> handles)
+    {
+        for (const int handle : handles)
+        {
+            close(handle);
+        }
+    }
+}
+
+#pragma region Public methods
+Result<void> FtlHandoffProtocol::SendRequest(int socketHandle)
+{
+    PayloadWriter writer;
+    writer.Write(static_cast<uint8_t>(MessageKind::Request));
+    writer.Write(VERSION);
+    return UnixSocketHandoff::Send(socketHandle, writer.Take());
+}
+
+Result<void> FtlHandoffProtocol::ReceiveRequest(int socketHandle,
+    std::chrono::milliseconds timeout)
+{
+    Result<UnixSocketHandoff::Message> message = UnixSocketHandoff::Receive(socketHandle, timeout);
+    if (message.IsError)
+    {
+        return Result<void>::Error(message.ErrorMessage);
+    }
+    closeAll(message.Value.Handles);
+
+    PayloadReader reader(message.Value.Payload);
+    const auto kind = static_cast<MessageKind>(reader.Read<uint8_t>());
+    const uint8_t version = reader.Read<uint8_t>();
+    if (!reader.IsValid() || (kind != MessageKind::Request))
+    {
+        return Result<void>::Error("Expected a handoff request");
+    }
+    if (version != VERSION)
+    {
+        return Result<void>::Error(fmt::format("Handoff was requested with version {}, but "
+            "this process speaks version {}", version, VERSION));
+    }
+    return Result<void>::Success();
+}
+
+Result<void> FtlHandoffProtocol::SendSockets(int socketHandle, const FtlHandoff& handoff)
+{
+    PayloadWriter writer;
+    writer.Write(static_cast<uint8_t>(MessageKind::Sockets));
+    writer.Write(static_cast<uint8_t>(handoff.ControlListenHandles.size()));
+    writer.Write(static_cast<uint8_t>(handoff.MediaHandles.size()));
+    std::vector<int> handles = handoff.ControlListenHandles;
+    handles.insert(handles.end(), handoff.MediaHandles.begin(), handoff.MediaHandles.end());
+    return UnixSocketHandoff::Send(socketHandle, writer.Take(), handles);
+}
+
+Result<FtlHandoff> FtlHandoffProtocol::ReceiveSockets(int socketHandle,
+    std::chrono::milliseconds timeout)
+{
+    Result<UnixSocketHandoff::Message> message = UnixSocketHandoff::Receive(socketHandle, timeout);
+    if (message.IsError)
+    {
+        return Result<FtlHandoff>::Error(message.ErrorMessage);
+    }
+    const std::vector<int>& handles = message.Value.Handles;
+
+    PayloadReader reader(message.Value.Payload);
+    const auto kind = static_cast<MessageKind>(reader.Read<uint8_t>());
+    const uint8_t numControlListenHandles = reader.Read<uint8_t>();
+    const uint8_t numMediaHandles = reader.Read<uint8_t>();
+    if (!reader.IsValid() || !reader.IsAtEnd() || (kind != MessageKind::Sockets) ||
+        (handles.size() != (numControlListenHandles + numMediaHandles)))
+    {
+        closeAll(handles);
+        return Result<FtlHandoff>::Error("Received a malformed socket handoff");
+    }
+    FtlHandoff handoff;
+    handoff.ControlListenHandles.assign(handles.begin(),
+        handles.begin() + numControlListenHandles);
+    handoff.MediaHandles.assign(handles.begin() + numControlListenHandles, handles.end());
+    return Result<FtlHandoff>::Success(std::move(handoff));
+}
+
+Result<void> FtlHandoffProtocol::SendStream(int socketHandle, const FtlStreamHandoff& stream)
+{
+    std::vector<int> handles;
+    if (stream.ControlHandle >= 0)
+    {
+        handles.push_back(stream.ControlHandle);
+    }
+    if (stream.MediaHandle >= 0)
+    {
+        handles.push_back(stream.MediaHandle);
+    }
+    return UnixSocketHandoff::Send(socketHandle, encodeStream(stream), handles);
+}
+
+Result<void> FtlHandoffProtocol::SendDone(int socketHandle)
+{
+    PayloadWriter writer;
+    writer.Write(static_cast<uint8_t>(MessageKind::Done));
+    return UnixSocketHandoff::Send(socketHandle, writer.Take());
+}
+
+Result<std::optional<FtlStreamHandoff>> FtlHandoffProtocol::ReceiveStream(int socketHandle,
+    std::chrono::milliseconds timeout)
+{
+    Result<UnixSocketHandoff::Message> message = UnixSocketHandoff::Receive(socketHandle, timeout);
+    if (message.IsError)
+    {
+        return Result<std::optional<FtlStreamHandoff>>::Error(message.ErrorMessage);
+    }
+    const std::vector<int>& handles = message.Value.Handles;
+
+    PayloadReader reader(message.Value.Payload);
+    switch (static_cast<MessageKind>(reader.Read<uint8_t>()))
+    {
+    case MessageKind::Stream:
+    {
+        Result<FtlStreamHandoff> stream = decodeStream(message.Value.Payload, handles);
+        if (stream.IsError)
+        {
+            closeAll(handles);
+            return Result<std::optional<FtlStreamHandoff>>::Error(stream.ErrorMessage);
+        }
+        return Result<std::optional<FtlStreamHandoff>>::Success(std::move(stream.Value));
+    }
+    case MessageKind::Done:
+        closeAll(handles);
+        return Result<std::optional<FtlStreamHandoff>>::Success(std::nullopt);
+    default:
+        closeAll(handles);
+        return Result<std::optional<FtlStreamHandoff>>::Error(
+            "Received an unexpected handoff message");
+    }
+}
+
+void FtlHandoffProtocol::CloseHandles(FtlHandoff& handoff)
+{
+    closeAll(handoff.ControlListenHandles);
+    handoff.ControlListenHandles.clear();
+    closeAll(handoff.MediaHandles);
+    handoff.MediaHandles.clear();
+}
+
+void FtlHandoffProtocol::CloseHandles(FtlStreamHandoff& stream)
+{
+    if (stream.ControlHandle >= 0)
+    {
+        close(stream.ControlHandle);
+        stream.ControlHandle = -1;
+    }
+    if (stream.MediaHandle >= 0)
+    {
+        close(stream.MediaHandle);
+        stream.MediaHandle = -1;
+    }
+}
+#pragma endregion Public methods
+
+#pragma region Private methods
+std::vector<std::byte> FtlHandoffProtocol::encodeStream(const FtlStreamHandoff& stream)
+{
+    PayloadWriter writer;
+    writer.Write(static_cast<uint8_t>(MessageKind::Stream));
+    writer.Write(stream.ChannelId);
+    writer.Write(stream.StreamId);
+    writer.Write(stream.MediaPort);
+    writer.WriteAddr(stream.ControlAddr, stream.ControlAddr6);
+    writer.WriteAddr(stream.MediaAddr, stream.MediaAddr6);
+
+    const MediaMetadata& metadata = stream.Metadata;
+    writer.WriteString(metadata.VendorName);
+    writer.WriteString(metadata.VendorVersion);
+    writer.Write(static_cast<uint8_t>(metadata.HasVideo));
+    writer.Write(static_cast<uint8_t>(metadata.HasAudio));
+    writer.Write(static_cast<uint8_t>(metadata.VideoCodec));
+    writer.Write(static_cast<uint8_t>(metadata.AudioCodec));
+    writer.Write(metadata.VideoWidth);
+    writer.Write(metadata.VideoHeight);
+    writer.Write(metadata.VideoSsrc);
+    writer.Write(metadata.AudioSsrc);
+    writer.Write(metadata.VideoPayloadType);
+    writer.Write(metadata.AudioPayloadType);
+
+    writer.WriteString(stream.PendingControlBytes);
+    writer.Write(static_cast<uint8_t>(stream.Sequences.size()));
+    for (const FtlSsrcSequenceHandoff& sequence : stream.Sequences)
+    {
+        writer.Write(sequence.Ssrc);
+        writer.Write(sequence.Sequence.MaxSeq);
+        writer.Write(sequence.Sequence.Cycles);
+        writer.Write(sequence.Sequence.BaseSeq);
+        writer.Write(sequence.Sequence.BadSeq);
+        writer.Write(sequence.Sequence.Probation);
+        writer.Write(sequence.Sequence.Received);
+        writer.Write(sequence.Sequence.ReceivedPrior);
+        writer.Write(sequence.Sequence.ExpectedPrior);
+        writer.Write(static_cast<uint8_t>(sequence.Sequence.Initialized));
+    }
+
+    writer.Write(static_cast<uint8_t>(((stream.ControlHandle >= 0) ? HAS_CONTROL_HANDLE : 0) |
+        ((stream.MediaHandle >= 0) ? HAS_MEDIA_HANDLE : 0)));
+    return writer.Take();
+}
+
+Result<FtlStreamHandoff> FtlHandoffProtocol::decodeStream(std::span<const std::byte> payload,
+    std::span<const int> handles)
+{
+    PayloadReader reader(payload);
+    reader.Read<uint8_t>();
+    FtlStreamHandoff stream;
+    stream.ChannelId = reader.Read<uint32_t>();
+    stream.StreamId = reader.Read<uint32_t>();
+    stream.MediaPort = reader.Read<uint16_t>();
+    reader.ReadAddr(stream.ControlAddr, stream.ControlAddr6);
+    reader.ReadAddr(stream.MediaAddr, stream.MediaAddr6);
+
+    MediaMetadata& metadata = stream.Metadata;
+    metadata.VendorName = reader.ReadString();
+    metadata.VendorVersion = reader.ReadString();
+    metadata.HasVideo = (reader.Read<uint8_t>() != 0);
+    metadata.HasAudio = (reader.Read<uint8_t>() != 0);
+    metadata.VideoCodec = static_cast<VideoCodecKind>(reader.Read<uint8_t>());
+    metadata.AudioCodec = static_cast<AudioCodecKind>(reader.Read<uint8_t>());
+    metadata.VideoWidth = reader.Read<uint16_t>();
+    metadata.VideoHeight = reader.Read<uint16_t>();
+    metadata.VideoSsrc = reader.Read<uint32_t>();
+    metadata.AudioSsrc = reader.Read<uint32_t>();
+    metadata.VideoPayloadType = reader.Read<uint8_t>();
+    metadata.AudioPayloadType = reader.Read<uint8_t>();
+
+    stream.PendingControlBytes = reader.ReadString();
+    const uint8_t numSequences = reader.Read<uint8_t>();
+    for (uint8_t i = 0; i < numSequences; ++i)
+    {
+        FtlSsrcSequenceHandoff& sequence = stream.Sequences.emplace_back();
+        sequence.Ssrc = reader.Read<uint32_t>();
+        sequence.Sequence.MaxSeq = reader.Read<uint16_t>();
+        sequence.Sequence.Cycles = reader.Read<uint32_t>();
+        sequence.Sequence.BaseSeq = reader.Read<uint32_t>();
+        sequence.Sequence.BadSeq = reader.Read<uint32_t>();
+        sequence.Sequence.Probation = reader.Read<uint32_t>();
+        sequence.Sequence.Received = reader.Read<uint32_t>();
+        sequence.Sequence.ReceivedPrior = reader.Read<uint32_t>();
+        sequence.Sequence.ExpectedPrior = reader.Read<uint32_t>();
+        sequence.Sequence.Initialized = (reader.Read<uint8_t>() != 0);
+    }
+
+    const uint8_t flags = reader.Read<uint8_t>();
+    const size_t expectedHandles = ((flags & HAS_CONTROL_HANDLE) ? 1 : 0) +
+        ((flags & HAS_MEDIA_HANDLE) ? 1 : 0);
+    if (!reader.IsValid() || !reader.IsAtEnd() || (handles.size() != expectedHandles))
+    {
+        return Result<FtlStreamHandoff>::Error("Received a malformed stream handoff");
+    }
+    size_t handleIndex = 0;
+    if (flags & HAS_CONTROL_HANDLE)
+    {
+        stream.ControlHandle = handles[handleIndex++];
+    }
+    if (flags & HAS_MEDIA_HANDLE)
+    {
+        stream.MediaHandle = handles[handleIndex++];
+    }
+    return Result<FtlStreamHandoff>::Success(std::move(stream));
+}
+#pragma endregion Private methods
@@ -0,0 +1,117 @@
+/**
+ * @file FtlHandoff.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Rtp/ExtendedSequenceCounter.h"
+#include "Utilities/FtlTypes.h"
+#include "Utilities/Result.h"
+
+#include <chrono>
+#include <cstdint>
+#include <netinet/in.h>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Where a stream's media sequence got to on one of its SSRCs
+ */
+struct FtlSsrcSequenceHandoff
+{
+    rtp_ssrc_t Ssrc = 0;
+    ExtendedSequenceCounter::State Sequence;
+};
+
+/**
+ * @brief A live stream being handed from one process to another, along with its sockets
+ */
+struct FtlStreamHandoff
+{
+    ftl_channel_id_t ChannelId = 0;
+    ftl_stream_id_t StreamId = 0;
+    MediaMetadata Metadata {};
+    uint16_t MediaPort = 0;
+    // At most one of each address is set, IPv6 for peers that only have an IPv6 address
+    std::optional<sockaddr_in> ControlAddr;
+    std::optional<sockaddr_in6> ControlAddr6;
+    // Where media is sent from, including the port once it's been learned
+    std::optional<sockaddr_in> MediaAddr;
+    std::optional<sockaddr_in6> MediaAddr6;
+    // Control bytes received that didn't make up a complete command yet
+    std::string PendingControlBytes;
+    std::vector<FtlSsrcSequenceHandoff> Sequences;
+    int ControlHandle = -1;
+    // -1 when the stream's media arrives on a port shared by every stream, which is handed off
+    // with the other sockets (see FtlHandoff::MediaHandles)
+    int MediaHandle = -1;
+};
+
+/**
+ * @brief The sockets an ingest hands over before any of its streams
+ */
+struct FtlHandoff
+{
+    std::vector<int> ControlListenHandles;
+    // Sockets of the port media is shared on, if media ports aren't assigned per stream
+    std::vector<int> MediaHandles;
+};
+
+/**
+ * @brief
+ *  Sends and receives a handoff over a connected UnixSocketHandoff socket.
+ *  The process taking over connects and asks for a handoff. The running process answers with
+ *  its sockets, so its successor can start accepting connections right away, then with each
+ *  stream as soon as it has been stopped, and finally says it's done.
+ */
+class FtlHandoffProtocol
+{
+public:
+    /* Constants */
+    // Bumped whenever the messages change, both ends must agree on it
+    static constexpr uint8_t VERSION = 2;
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT { 10000 };
+
+    /* Public methods */
+    static Result<void> SendRequest(int socketHandle);
+    static Result<void> ReceiveRequest(int socketHandle,
+        std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+    /**
+     * @brief Sends the handoff's sockets. The handles stay open in this process.
+     */
+    static Result<void> SendSockets(int socketHandle, const FtlHandoff& handoff);
+    static Result<FtlHandoff> ReceiveSockets(int socketHandle,
+        std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+    /**
+     * @brief Sends a stream. Its handles stay open in this process.
+     */
+    static Result<void> SendStream(int socketHandle, const FtlStreamHandoff& stream);
+    static Result<void> SendDone(int socketHandle);
+    /**
+     * @return the next stream, or nothing once every stream has been sent
+     */
+    static Result<std::optional<FtlStreamHandoff>> ReceiveStream(int socketHandle,
+        std::chrono::milliseconds timeout = DEFAULT_TIMEOUT);
+    static void CloseHandles(FtlHandoff& handoff);
+    static void CloseHandles(FtlStreamHandoff& stream);
+
+private:
+    /* Private types */
+    enum class MessageKind : uint8_t
+    {
+        Request = 1,
+        Sockets,
+        Stream,
+        Done,
+    };
+
+    /* Private methods */
+    static std::vector<std::byte> encodeStream(const FtlStreamHandoff& stream);
+    static Result<FtlStreamHandoff> decodeStream(std::span<const std::byte> payload,
+        std::span<const int> handles);
+};
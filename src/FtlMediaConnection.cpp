@@ -12,15 +12,21 @@
 
 #include "ConnectionTransports/NetworkSocketConnectionTransport.h"
 #include "FtlControlConnection.h"
+#include "FtlHandoff.h"
 #include "Rtp/RtpPacket.h"
+#include "Utilities/CpuTopology.h"
+#include "Utilities/Util.h"
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <poll.h>
 #include <spdlog/fmt/bin_to_hex.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
 
 #pragma region Constructor/Destructor
 FtlMediaConnection::FtlMediaConnection(
@@ -31,178 +37,472 @@ FtlMediaConnection::FtlMediaConnection(
     const ClosedCallback onClosed,
     const RtpPacketCallback onRtpPacketBytes,
     const uint32_t rollingSizeAvgMs,
-    const bool nackLostPackets)
+    const bool nackLostPackets,
+    const std::shared_ptr<EpollReactor> reactor,
+    const std::shared_ptr<MetricsRegistry> metrics,
+    const size_t maxMemoryBytes,
+    const CpuPlacement placement,
+    const BitrateLimit bitrateLimit,
+    const std::chrono::milliseconds reorderDelay,
+    std::span<const FtlSsrcSequenceHandoff> resumeSequences)
 :
     transport(std::move(transport)),
     mediaMetadata(mediaMetadata),
+    processVideoKeyframe(videoKeyframeProcessorFor(mediaMetadata.VideoCodec)),
     channelId(channelId),
     streamId(streamId),
     onClosed(onClosed),
     onRtpPacketBytes(onRtpPacketBytes),
     rollingSizeAvgMs(rollingSizeAvgMs),
     nackLostPackets(nackLostPackets),
-    thread(std::jthread(std::bind(&FtlMediaConnection::threadBody, this, std::placeholders::_1)))
+    maxMemoryBytes(maxMemoryBytes),
+    placement(placement),
+    reactor(reactor),
+    latencyTracer((PacketLatencyTracer::IS_ENABLED && metrics) ?
+        std::make_unique<PacketLatencyTracer>(metrics, channelId) : nullptr),
+    readBuffers(READ_BATCH_SIZE),
+    bitrateLimit(bitrateLimit)
 {
     // Prepare stream data stores to accept packets from SSRCs specified by control handshake
-    ssrcData.try_emplace(mediaMetadata.AudioSsrc);
-    ssrcData.try_emplace(mediaMetadata.VideoSsrc);
+    ssrcData.try_emplace(mediaMetadata.AudioSsrc, std::chrono::milliseconds(rollingSizeAvgMs));
+    ssrcData.try_emplace(mediaMetadata.VideoSsrc, std::chrono::milliseconds(rollingSizeAvgMs));
+    currentKeyframe = std::make_shared<const FtlKeyframe>(
+        FtlKeyframe { .Codec = mediaMetadata.VideoCodec });
+    if (reorderDelay.count() > 0)
+    {
+        for (auto& [ssrc, data] : ssrcData)
+        {
+            data.ReorderBuffer.emplace(reorderDelay);
+        }
+    }
+    if (bitrateLimit.MaxBitsPerSecond > 0)
+    {
+        bitratePolicer.emplace(bitrateLimit.MaxBitsPerSecond, bitrateLimit.BurstBytes,
+            bitrateLimit.MaxViolations);
+    }
+    for (const FtlSsrcSequenceHandoff& sequence : resumeSequences)
+    {
+        auto it = ssrcData.find(sequence.Ssrc);
+        if (it != ssrcData.end())
+        {
+            it->second.SequenceCounter.SetState(sequence.Sequence);
+        }
+    }
 
     // Record start time
     startTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     steadyStartTime = std::chrono::steady_clock::now();
     spdlog::info("Media stream receiving for Channel {} / Stream {}",
         channelId, streamId);
+
+    // Start reading packets, either from a shared reactor or our own thread
+    std::optional<int> pollHandle = this->transport->GetPollHandle();
+    if (reactor && pollHandle.has_value())
+    {
+        Result<EpollReactor::RegistrationId> registerResult = reactor->Register(
+            pollHandle.value(),
+            [this]()
+            {
+                const bool isReading = readAvailablePackets(std::chrono::milliseconds(0));
+                processDueNacks();
+                return isReading;
+            },
+            std::bind(&FtlMediaConnection::onTransportStopped, this),
+            placement.NumaNode);
+        if (registerResult.IsError)
+        {
+            spdlog::warn("Could not register Channel {} / Stream {} media connection with "
+                "reactor, falling back to a dedicated thread: {}",
+                channelId, streamId, registerResult.ErrorMessage);
+        }
+        else
+        {
+            reactorRegistration = registerResult.Value;
+            Result<void> timerResult = nackLostPackets ? startNackTimer() : Result<void>::Success();
+            if (timerResult.IsError)
+            {
+                spdlog::warn("Channel {} / Stream {} will only send NACKs as packets arrive: {}",
+                    channelId, streamId, timerResult.ErrorMessage);
+            }
+        }
+    }
+    if (!reactorRegistration.has_value())
+    {
+        thread = std::jthread(
+            std::bind(&FtlMediaConnection::threadBody, this, std::placeholders::_1));
+    }
+}
+
+FtlMediaConnection::~FtlMediaConnection()
+{
+    if (reactorRegistration.has_value())
+    {
+        reactor->Unregister(reactorRegistration.value());
+        reactor->WaitUntilUnregistered(reactorRegistration.value());
+    }
+    stopNackTimer();
 }
 #pragma endregion
 
 #pragma region Public methods
 void FtlMediaConnection::RequestStop()
 {
-    thread.request_stop();
+    if (reactorRegistration.has_value())
+    {
+        reactor->Unregister(reactorRegistration.value());
+    }
+    else
+    {
+        thread.request_stop();
+    }
+    if (nackTimerRegistration.has_value())
+    {
+        reactor->Unregister(nackTimerRegistration.value());
+    }
+}
+
+Result<void> FtlMediaConnection::HandOff(FtlStreamHandoff& handoff)
+{
+    isHandingOff = true;
+    if (reactorRegistration.has_value())
+    {
+        reactor->Unregister(reactorRegistration.value());
+        reactor->WaitUntilUnregistered(reactorRegistration.value());
+    }
+    else if (thread.joinable())
+    {
+        thread.request_stop();
+        thread.join();
+    }
+    stopNackTimer();
+
+    // A connection that can't be handed off closes as it would have if it had been stopped
+    Result<std::optional<int>> detachResult = transport->Detach();
+    if (detachResult.IsError)
+    {
+        isHandingOff = false;
+        onTransportStopped();
+        return Result<void>::Error(detachResult.ErrorMessage);
+    }
+
+    // Nothing is reading anymore, but stats may still be being read
+    std::unique_lock lock(dataMutex);
+    handoff.MediaHandle = detachResult.Value.value_or(-1);
+    handoff.MediaAddr = transport->GetAddr();
+    handoff.MediaAddr6 = transport->GetAddr6();
+    handoff.Sequences.clear();
+    for (const auto& [ssrc, data] : ssrcData)
+    {
+        handoff.Sequences.push_back(FtlSsrcSequenceHandoff {
+            .Ssrc = ssrc,
+            .Sequence = data.SequenceCounter.GetState(),
+        });
+    }
+    spdlog::info("Handed off media connection for Channel {} / Stream {}", channelId, streamId);
+    return Result<void>::Success();
+}
+
+void FtlMediaConnection::SeedRoundTripTime(std::chrono::microseconds roundTripTime)
+{
+    std::unique_lock lock(dataMutex);
+    if (!this->roundTripTime.HasSamples())
+    {
+        addRoundTripSample(roundTripTime, lock);
+    }
 }
 
 FtlStreamStats FtlMediaConnection::GetStats()
 {
-    std::shared_lock lock(dataMutex);
+    // Stats are read without dataMutex so we never hold up packet processing
     FtlStreamStats stats { 0 };
-    uint32_t bytesReceived = 0;
+    uint64_t bytesReceived = 0;
+    const auto steadyNow = std::chrono::steady_clock::now();
     stats.StartTime = startTime;
     stats.DurationSeconds = std::chrono::duration_cast<std::chrono::seconds>(
-        std::chrono::steady_clock::now() - steadyStartTime).count();
+        steadyNow - steadyStartTime).count();
     for (const auto& dataPair : ssrcData)
     {
         const SsrcData& data = dataPair.second;
-        stats.PacketsReceived += data.PacketsReceived;
-        stats.PacketsNacked += data.PacketsNacked;
-        stats.PacketsLost += data.PacketsLost;
-        for (const auto& bytesPair : dataPair.second.RollingBytesReceivedByTime)
-        {
-            bytesReceived += bytesPair.second;
-        }
+        stats.PacketsReceived += data.PacketsReceived.load(std::memory_order_relaxed);
+        stats.PacketsNacked += data.PacketsNacked.load(std::memory_order_relaxed);
+        stats.PacketsLost += data.PacketsLost.load(std::memory_order_relaxed);
+        stats.BytesReceived += data.BytesReceived.load(std::memory_order_relaxed);
+        stats.PacketsBuffered += data.PacketsBuffered.load(std::memory_order_relaxed);
+        stats.PacketBufferCapacity += PACKET_BUFFER_SIZE;
+        stats.NacksQueued += data.NacksQueued.load(std::memory_order_relaxed);
+        stats.NacksOutstanding += data.NacksOutstanding.load(std::memory_order_relaxed);
+        stats.SenderReportedPackets +=
+            data.SenderReportedPackets.load(std::memory_order_relaxed);
+        stats.PacketsDroppedLate += data.PacketsDroppedLate.load(std::memory_order_relaxed);
+        stats.DuplicatePacketsDropped +=
+            data.DuplicatePacketsDropped.load(std::memory_order_relaxed);
+        bytesReceived += data.RollingBytesReceived.GetSum(steadyNow);
     }
     stats.RollingAverageBitrateBps = (bytesReceived * 8) / (rollingSizeAvgMs / 1000.0f);
+    stats.MemoryBytes = memoryBytes.load(std::memory_order_relaxed);
+    stats.MemoryBudgetBytes = maxMemoryBytes;
+    stats.KeyframesDropped = keyframesDropped.load(std::memory_order_relaxed);
+    stats.PacketsOverBitrateLimit = packetsOverBitrateLimit.load(std::memory_order_relaxed);
+    stats.RoundTripTimeMs = roundTripTimeMs.load(std::memory_order_relaxed);
+    const ThreadPlacement::Snapshot readerSnapshot = readerPlacement.Get();
+    stats.ReaderThreadId = readerSnapshot.ThreadId;
+    stats.ReaderCpu = readerSnapshot.Cpu;
 
     return stats;
 }
 
-Result<FtlKeyframe> FtlMediaConnection::GetKeyframe()
+Result<std::shared_ptr<const FtlKeyframe>> FtlMediaConnection::GetKeyframe()
 {
-    std::shared_lock lock(dataMutex);
-    // Return the last available keyframe for the default video ssrc
-    if (ssrcData.count(mediaMetadata.VideoSsrc) <= 0)
-    {
-        return Result<FtlKeyframe>::Error(
-            fmt::format("No ssrc data available for video ssrc {}", mediaMetadata.VideoSsrc));
-    }
-    
-    std::list<RtpPacket>& currentKeyframePackets =
-        ssrcData.at(mediaMetadata.VideoSsrc).CurrentKeyframePackets;
-    
-    FtlKeyframe keyframe { mediaMetadata.VideoCodec };
-    std::transform(
-        currentKeyframePackets.begin(),
-        currentKeyframePackets.end(),
-        std::back_inserter(keyframe.Packets),
-        [](const RtpPacket& packet) -> std::vector<std::byte> { return packet.Bytes; });
-    return Result<FtlKeyframe>::Success(keyframe);
+    std::scoped_lock lock(keyframeMutex);
+    return Result<std::shared_ptr<const FtlKeyframe>>::Success(currentKeyframe);
 }
 #pragma endregion
 
 #pragma region Private methods
 void FtlMediaConnection::threadBody(std::stop_token stopToken)
 {
-    std::vector<std::byte> buffer;
+    std::vector<int> cpus = threadCpusOnNode(placement.NumaNode);
+    if (cpus.empty())
+    {
+        // Staying within the configured CPUs matters more than the node
+        cpus = placement.ThreadCpus;
+    }
+    if (!cpus.empty())
+    {
+        Result<void> pinResult = CpuTopology::PinCurrentThread(cpus);
+        if (pinResult.IsError)
+        {
+            spdlog::warn("Channel {} / Stream {} media thread could not be pinned: {}",
+                channelId, streamId, pinResult.ErrorMessage);
+        }
+    }
 
+    // Reads don't wait past the next NACK deadline, so NACKs are sent on time even when the
+    // stream has gone quiet
+    std::optional<std::chrono::steady_clock::time_point> nackDeadline;
     while (!stopToken.stop_requested())
     {
-        auto result = transport->Read(buffer, READ_TIMEOUT);
-        if (result.IsError) {
-            spdlog::error("Failed to read from media connection transport: {}",
-                result.ErrorMessage);
+        std::chrono::milliseconds timeout = READ_TIMEOUT;
+        if (nackDeadline.has_value())
+        {
+            timeout = std::clamp(std::chrono::ceil<std::chrono::milliseconds>(
+                nackDeadline.value() - std::chrono::steady_clock::now()),
+                std::chrono::milliseconds(0), READ_TIMEOUT);
+        }
+        if (!readAvailablePackets(timeout))
+        {
             break;
         }
+        nackDeadline = processDueNacks();
+    }
 
-        if (result.Value > 0) {
-            onBytesReceived(buffer);
-        }
+    onTransportStopped();
+}
+
+bool FtlMediaConnection::readAvailablePackets(std::chrono::milliseconds timeout)
+{
+    // Drain as many packets as are queued on the transport with each wakeup
+    auto result = transport->ReadBatch(readBuffers, timeout);
+    if (result.IsError) {
+        spdlog::error("Failed to read from media connection transport: {}",
+            result.ErrorMessage);
+        return false;
     }
 
-    spdlog::debug("Stopping media connection thread for Channel {} / Stream {}",
-        channelId, streamId);
-    transport->Stop();
-    if (onClosed)
+    if (result.Value > 0)
     {
-        onClosed(*this);
+        readerPlacement.Record();
+    }
+    for (size_t i = 0; i < result.Value; ++i)
+    {
+        onBytesReceived(readBuffers[i]);
+    }
+    if ((result.Value > 0) && placement.FollowRxCpu && !hasFollowedRxCpu)
+    {
+        hasFollowedRxCpu = true;
+        followRxCpu();
     }
+    return true;
 }
 
-void FtlMediaConnection::onBytesReceived(const std::vector<std::byte>& bytes)
+Result<void> FtlMediaConnection::startNackTimer()
 {
-    if (bytes.size() < 12)
+    nackTimerHandle = timerfd_create(CLOCK_MONOTONIC, (TFD_NONBLOCK | TFD_CLOEXEC));
+    if (nackTimerHandle == -1)
     {
-        // This packet is too small to have an RTP header.
-        spdlog::warn(
-            "Channel {} / stream {} received non-RTP packet of size {} (< 12 bytes). Discarding...",
-            channelId, streamId, bytes.size());
-        return;
+        int error = errno;
+        return Result<void>::Error(fmt::format("Could not create timerfd. Error {}: {}", error,
+            Util::ErrnoToString(error)));
     }
+    Result<EpollReactor::RegistrationId> registerResult = reactor->Register(
+        nackTimerHandle,
+        [this]()
+        {
+            uint64_t expirations;
+            while (read(nackTimerHandle, &expirations, sizeof(expirations)) > 0)
+            { }
+            processDueNacks();
+            return true;
+        },
+        []() { },
+        placement.NumaNode);
+    if (registerResult.IsError)
+    {
+        close(nackTimerHandle);
+        nackTimerHandle = -1;
+        return Result<void>::Error(registerResult.ErrorMessage);
+    }
+    nackTimerRegistration = registerResult.Value;
+    return Result<void>::Success();
+}
 
-    processRtpPacketBytes(bytes);
+void FtlMediaConnection::stopNackTimer()
+{
+    if (nackTimerRegistration.has_value())
+    {
+        reactor->Unregister(nackTimerRegistration.value());
+        reactor->WaitUntilUnregistered(nackTimerRegistration.value());
+        nackTimerRegistration.reset();
+    }
+    if (nackTimerHandle != -1)
+    {
+        close(nackTimerHandle);
+        nackTimerHandle = -1;
+    }
 }
 
-std::set<rtp_extended_sequence_num_t> FtlMediaConnection::insertPacketInSequenceOrder(
-    std::list<RtpPacket>& packetList, const RtpPacket& packet)
+std::optional<std::chrono::steady_clock::time_point> FtlMediaConnection::processDueNacks()
 {
-    const auto seqNum = packet.ExtendedSequenceNum;
-    std::set<rtp_extended_sequence_num_t> missingSequences;
-    // If the list is empty, just add it and we're done.
-    if (packetList.size() == 0)
+    if (!nackLostPackets)
     {
-        packetList.push_back(packet);
-        return missingSequences;
+        return std::nullopt;
     }
-    // Insert the packet into list according to sequence number
-    bool wasInserted = false;
-    for (auto it = packetList.rbegin(); it != packetList.rend(); it++)
+    std::unique_lock lock(dataMutex);
+    const auto now = std::chrono::steady_clock::now();
+    if (nackDeadline.has_value() && (nackDeadline.value() <= now))
     {
-        const RtpPacket& cachedPacket = *it;
-        const auto cachedSeqNum = cachedPacket.ExtendedSequenceNum;
+        for (auto& [ssrc, data] : ssrcData)
+        {
+            processNacks(ssrc, now, lock);
+            data.NacksQueued.store(data.NackQueue.Count(), std::memory_order_relaxed);
+            data.NacksOutstanding.store(data.NackedSequences.Count(), std::memory_order_relaxed);
+        }
+    }
 
-        if (seqNum > cachedSeqNum)
+    if ((nackTimerHandle != -1) && (nackDeadline != armedNackDeadline))
+    {
+        // A zeroed expiry disarms the timer
+        itimerspec expiry {};
+        if (nackDeadline.has_value())
         {
-            // If there are any gaps between the sequence numbers, mark them as missing.
-            if (seqNum - 1 != cachedSeqNum)
-            {
-                for (rtp_extended_sequence_num_t missingSeqNum = (cachedSeqNum + 1);
-                    (missingSeqNum < seqNum); missingSeqNum++)
-                {
-                    missingSequences.insert(missingSeqNum);
-                }
-            }
-            packetList.insert(it.base(), packet);
-            wasInserted = true;
-            break;
+            const auto sinceEpoch = nackDeadline->time_since_epoch();
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+            expiry.it_value.tv_sec = seconds.count();
+            expiry.it_value.tv_nsec =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch - seconds).count();
         }
+        if (timerfd_settime(nackTimerHandle, TFD_TIMER_ABSTIME, &expiry, nullptr) == 0)
+        {
+            armedNackDeadline = nackDeadline;
+        }
+    }
+    return nackDeadline;
+}
+
+std::vector<int> FtlMediaConnection::threadCpusOnNode(std::optional<int> numaNode) const
+{
+    if (!numaNode.has_value())
+    {
+        return placement.ThreadCpus;
+    }
+    std::vector<int> nodeCpus = CpuTopology::GetNumaNodeCpus(numaNode.value());
+    if (placement.ThreadCpus.empty())
+    {
+        return nodeCpus;
     }
+    std::erase_if(nodeCpus,
+        [this](int cpu)
+        {
+            return (std::find(placement.ThreadCpus.begin(), placement.ThreadCpus.end(), cpu) ==
+                placement.ThreadCpus.end());
+        });
+    return nodeCpus;
+}
 
-    if (!wasInserted)
+void FtlMediaConnection::followRxCpu()
+{
+    std::optional<int> rxCpu = transport->GetIncomingCpu();
+    if (!rxCpu.has_value())
     {
-        // The packet's sequence number was older than the whole list - insert at the very front.
-        const auto firstSeqNum = packetList.front().ExtendedSequenceNum;
+        return;
+    }
 
-        // Mark in-between packets missing.
-        for (rtp_extended_sequence_num_t missingSeqNum = (seqNum + 1);
-            (missingSeqNum < firstSeqNum); missingSeqNum++)
+    int numaNode = CpuTopology::GetNumaNode(rxCpu.value());
+    if (reactorRegistration.has_value())
+    {
+        // The move happens once we've returned to the reactor
+        Result<int> moveResult = reactor->MoveNearCpu(reactorRegistration.value(), rxCpu.value());
+        if (moveResult.IsError)
         {
-            missingSequences.insert(missingSeqNum);
+            spdlog::debug("Channel {} / Stream {} can't follow RX CPU {}: {}",
+                channelId, streamId, rxCpu.value(), moveResult.ErrorMessage);
+            return;
+        }
+        numaNode = moveResult.Value;
+    }
+    else
+    {
+        const std::vector<int> cpus = threadCpusOnNode(numaNode);
+        if (cpus.empty() || CpuTopology::PinCurrentThread(cpus).IsError)
+        {
+            return;
         }
-        packetList.push_front(packet);
     }
 
-    return missingSequences;
+    if ((numaNode != CpuTopology::UNKNOWN_NUMA_NODE) && (numaNode != placement.NumaNode) &&
+        placement.OnNumaNodeChanged)
+    {
+        spdlog::info("Channel {} / Stream {} is now read on NUMA node {}, near RX CPU {}",
+            channelId, streamId, numaNode, rxCpu.value());
+        placement.OnNumaNodeChanged(numaNode);
+    }
 }
 
-void FtlMediaConnection::processRtpPacketBytes(const std::vector<std::byte>& packetBytes)
+void FtlMediaConnection::onTransportStopped()
+{
+    if (isHandingOff)
+    {
+        // The transport lives on in another process
+        return;
+    }
+    spdlog::debug("Stopping media connection for Channel {} / Stream {}",
+        channelId, streamId);
+    if (nackTimerRegistration.has_value())
+    {
+        reactor->Unregister(nackTimerRegistration.value());
+    }
+    transport->Stop();
+    if (onClosed)
+    {
+        onClosed(*this);
+    }
+}
+
+void FtlMediaConnection::onBytesReceived(const PacketBuffer& bytes)
+{
+    if (bytes.Size() < 12)
+    {
+        // This packet is too small to have an RTP header.
+        spdlog::warn(
+            "Channel {} / stream {} received non-RTP packet of size {} (< 12 bytes). Discarding...",
+            channelId, streamId, bytes.Size());
+        return;
+    }
+
+    processRtpPacketBytes(bytes);
+}
+
+void FtlMediaConnection::processRtpPacketBytes(const PacketBuffer& packetBytes)
 {
     const RtpHeader* rtpHeader = RtpPacket::GetRtpHeader(packetBytes);
     rtp_ssrc_t ssrc = ntohl(rtpHeader->Ssrc);
@@ -211,13 +511,34 @@ void FtlMediaConnection::processRtpPacketBytes(const std::vector<std::byte>& pac
     if ((ssrc == mediaMetadata.AudioSsrc) || 
         (ssrc == mediaMetadata.VideoSsrc))
     {
+        // Media packets are parsed once here, and every later stage reads the parsed fields
+        const std::optional<RtpPacketFields> fields = RtpPacket::ParseFields(packetBytes);
+        if (!fields.has_value())
+        {
+            spdlog::debug("Channel {} / stream {} received malformed RTP packet of size {}, "
+                "discarding", channelId, streamId, packetBytes.Size());
+            return;
+        }
+
         std::unique_lock lock(dataMutex);
 
-        std::optional<RtpPacket> rtpPacket = parseMediaPacket(packetBytes, lock);
+        std::optional<RtpPacket> rtpPacket =
+            parseMediaPacket(packetBytes, fields.value(), lock);
         if (rtpPacket)
         {
-            processRtpPacketSequencing(rtpPacket.value(), lock);
-            processAudioVideoRtpPacket(rtpPacket.value(), lock);
+            const auto now = std::chrono::steady_clock::now();
+            processRtpPacketSequencing(rtpPacket.value(), now, lock);
+            if (latencyTracer)
+            {
+                latencyTracer->Record(PacketLatencyTracer::Stage::Sequenced, packetBytes);
+            }
+            // Packets over the limit are still sequenced, so they aren't NACKed, but they go
+            // no further
+            if (policeBitrate(rtpPacket.value(), lock))
+            {
+                processAudioVideoRtpPacket(rtpPacket.value(), now, lock);
+            }
+            releaseReorderedPackets(now, lock);
         }
     }
     else
@@ -245,17 +566,17 @@ void FtlMediaConnection::processRtpPacketBytes(const std::vector<std::byte>& pac
 }
 
 std::optional<RtpPacket> FtlMediaConnection::parseMediaPacket(
-    const std::vector<std::byte>& packetBytes,
+    const PacketBuffer& packetBytes,
+    const RtpPacketFields& fields,
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
-    const RtpHeader* rtpHeader = RtpPacket::GetRtpHeader(packetBytes);
-    const rtp_ssrc_t ssrc = ntohl(rtpHeader->Ssrc);
-    const rtp_sequence_num_t seqNum = ntohs(rtpHeader->SequenceNumber);
+    const rtp_ssrc_t ssrc = fields.Ssrc;
+    const rtp_sequence_num_t seqNum = fields.SequenceNum;
 
     if (ssrcData.count(ssrc) <= 0)
     {
-        const rtp_payload_type_t payloadType = ntohs(rtpHeader->Type);
-        spdlog::warn("Received RTP payload type {} with unexpected ssrc {}", payloadType, ssrc);
+        spdlog::warn("Received RTP payload type {} with unexpected ssrc {}", fields.PayloadType,
+            ssrc);
         return std::nullopt;
     }
 
@@ -265,7 +586,7 @@ std::optional<RtpPacket> FtlMediaConnection::parseMediaPacket(
     // We should ignore these until we see our first video packet show up.
     if ((ssrc == mediaMetadata.AudioSsrc) &&
         (ssrcData.count(mediaMetadata.VideoSsrc) > 0) &&
-        (ssrcData.at(mediaMetadata.VideoSsrc).CircularPacketBuffer.size() <= 0))
+        (ssrcData.at(mediaMetadata.VideoSsrc).CircularPacketBuffer.Empty()))
     {
         return std::nullopt;
     }
@@ -276,206 +597,243 @@ std::optional<RtpPacket> FtlMediaConnection::parseMediaPacket(
         spdlog::trace("Invalid RTP sequence number {} for ssrc {}, extended to {}",
             seqNum, ssrc, extendedSeqNum);
     }
-    return RtpPacket(packetBytes, extendedSeqNum);
+    return RtpPacket(packetBytes, fields, extendedSeqNum);
 }
 
 void FtlMediaConnection::processRtpPacketSequencing(const RtpPacket& rtpPacket,
+    const std::chrono::steady_clock::time_point now,
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
-    const RtpHeader* rtpHeader = rtpPacket.Header();
-    const rtp_ssrc_t ssrc = ntohl(rtpHeader->Ssrc);
+    const rtp_ssrc_t ssrc = rtpPacket.Fields.Ssrc;
 
     if (ssrcData.count(ssrc) <= 0)
     {
-        const rtp_payload_type_t payloadType = ntohs(rtpHeader->Type);
-        spdlog::warn("Received RTP payload type {} with unexpected ssrc {}", payloadType, ssrc);
+        spdlog::warn("Received RTP payload type {} with unexpected ssrc {}",
+            rtpPacket.Fields.PayloadType, ssrc);
         return;
     }
 
     SsrcData& data = ssrcData.at(ssrc);
 
+    // A packet we've NACKed once is most likely its retransmission, which times the round
+    // trip. Packets NACKed more than once can't tell us which NACK they answer.
+    const size_t nackSlot = (rtpPacket.ExtendedSequenceNum % RtpSequenceBitmap::WINDOW_SIZE);
+    if (data.NackedSequences.Test(rtpPacket.ExtendedSequenceNum) &&
+        (data.NackCounts[nackSlot] == 1))
+    {
+        addRoundTripSample(std::chrono::duration_cast<std::chrono::microseconds>(
+            now - data.NackTimes[nackSlot]), dataLock);
+    }
+
     // If this sequence is marked as missing anywhere, un-mark it.
-    data.NackQueue.erase(rtpPacket.ExtendedSequenceNum);
-    data.NackedSequences.erase(rtpPacket.ExtendedSequenceNum);
+    data.NackQueue.Reset(rtpPacket.ExtendedSequenceNum);
+    data.NackedSequences.Reset(rtpPacket.ExtendedSequenceNum);
 
     // Tally up the size of the packet
     data.PacketsReceived++;
-    std::chrono::time_point<std::chrono::steady_clock> steadyNow = std::chrono::steady_clock::now();
-    if (data.RollingBytesReceivedByTime.count(steadyNow) > 0)
-    {
-        data.RollingBytesReceivedByTime.at(steadyNow) += rtpPacket.Bytes.size();
-    }
-    else
-    {
-        data.RollingBytesReceivedByTime.try_emplace(steadyNow, rtpPacket.Bytes.size());
-    }
-    // Trim any packets that are too old
-    for (auto it = data.RollingBytesReceivedByTime.begin();
-        it != data.RollingBytesReceivedByTime.end();)
-    {
-        uint32_t msDelta = 
-            std::chrono::duration_cast<std::chrono::milliseconds>(steadyNow - it->first).count();
-        if (msDelta > rollingSizeAvgMs)
-        {
-            it = data.RollingBytesReceivedByTime.erase(it);
-        }
-        else
-        {
-            // Map is sorted in ascending order - so we can break early
-            break;
-        }
-    }
-
-    // Insert the packet into the buffer in sequence number order
-    std::set<rtp_extended_sequence_num_t> missingSequences =
-        insertPacketInSequenceOrder(data.CircularPacketBuffer, rtpPacket);
+    data.BytesReceived.fetch_add(rtpPacket.Bytes.Size(), std::memory_order_relaxed);
+    data.RollingBytesReceived.Add(rtpPacket.Bytes.Size());
 
-    // Trim circular packet buffer to stay within buffer size limit
-    while (data.CircularPacketBuffer.size() > PACKET_BUFFER_SIZE)
-    {
-        data.CircularPacketBuffer.pop_front();
-    }
+    // Insert the packet into the buffer by sequence number
+    RtpPacketRingBuffer::MissingSequenceRange missingSequences =
+        data.CircularPacketBuffer.Insert(rtpPacket);
 
     // Keep the sending of NACKs behind a feature toggle for now
     // https://github.com/Glimesh/janus-ftl-plugin/issues/95
     if (nackLostPackets)
     {
-        updateNackQueue(data, rtpPacket.ExtendedSequenceNum, missingSequences, dataLock);
-        processNacks(ssrc, dataLock);
+        updateNackQueue(data, rtpPacket.ExtendedSequenceNum, missingSequences, now, dataLock);
+        processNacks(ssrc, now, dataLock);
     }
+
+    data.PacketsBuffered.store(data.CircularPacketBuffer.Size(), std::memory_order_relaxed);
+    data.NacksQueued.store(data.NackQueue.Count(), std::memory_order_relaxed);
+    data.NacksOutstanding.store(data.NackedSequences.Count(), std::memory_order_relaxed);
 }
 
 void FtlMediaConnection::processRtpPacketKeyframe(const RtpPacket& rtpPacket,
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
-    const RtpHeader* rtpHeader = rtpPacket.Header();
-    // Is this a video packet?
-    if (ntohl(rtpHeader->Ssrc) == mediaMetadata.VideoSsrc)
+    // Is this a video packet we know how to process keyframes for?
+    if ((rtpPacket.Fields.Ssrc == mediaMetadata.VideoSsrc) && (processVideoKeyframe != nullptr))
     {
-        switch (mediaMetadata.VideoCodec)
-        {
-        case VideoCodecKind::H264:
-            processRtpH264PacketKeyframe(rtpPacket, dataLock);
-            break;
-        case VideoCodecKind::Unsupported:
-        default:
-            // We don't know how to process keyframes for this video codec.
-            break;
-        }
+        (this->*processVideoKeyframe)(rtpPacket, dataLock);
     }
 }
 
-void FtlMediaConnection::processRtpH264PacketKeyframe(const RtpPacket& rtpPacket,
+FtlMediaConnection::VideoKeyframeProcessor FtlMediaConnection::videoKeyframeProcessorFor(
+    VideoCodecKind codec)
+{
+    VideoKeyframeProcessor processor = nullptr;
+    SupportedVideoCodecList::Visit(codec,
+        [&processor](auto codecTag)
+        {
+            processor = &FtlMediaConnection::processVideoPacketKeyframe<decltype(codecTag)::value>;
+        });
+    return processor;
+}
+
+template<VideoCodecKind Codec>
+void FtlMediaConnection::processVideoPacketKeyframe(const RtpPacket& rtpPacket,
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
-    const RtpHeader* rtpHeader = rtpPacket.Header();
-    const rtp_ssrc_t ssrc = ntohl(rtpHeader->Ssrc);
+    const rtp_ssrc_t ssrc = rtpPacket.Fields.Ssrc;
     if (ssrcData.count(ssrc) <= 0)
     {
-        spdlog::warn("Couldn't process H264 keyframes for unknown ssrc {}", ssrc);
+        spdlog::warn("Couldn't process {} keyframes for unknown ssrc {}",
+            SupportedVideoCodecs::VideoCodecString(Codec), ssrc);
         return;
     }
     SsrcData& data = ssrcData.at(ssrc);
 
-    // Is this packet part of a keyframe?
-    std::span<const std::byte> packetPayload = rtpPacket.Payload();
-    if (packetPayload.size() < 2)
+    // Parameter sets may arrive alone or aggregated with others
+    VideoCodecTraits<Codec>::ForEachParameterSet(rtpPacket.Payload(),
+        [this, &dataLock](std::span<const std::byte> parameterSet)
+        {
+            processVideoParameterSet<Codec>(parameterSet, dataLock);
+        });
+
+    const bool isKeyframeComplete = data.KeyframeAssembler.Add(rtpPacket);
+    const size_t heldBytes = measureMemoryBytes(dataLock);
+    if ((maxMemoryBytes > 0) && (heldBytes > maxMemoryBytes))
     {
+        // Rather than let a runaway access unit grow toward our budget, give up on it. The
+        // current keyframe stays, since it fit.
+        data.KeyframeAssembler.Abandon();
+        measureMemoryBytes(dataLock);
+        if (keyframesDropped.fetch_add(1, std::memory_order_relaxed) == 0)
+        {
+            spdlog::warn("Channel {} / Stream {} keyframe would take it over its {} byte "
+                "memory budget, dropping it", channelId, streamId, maxMemoryBytes);
+        }
         return;
     }
-    bool isKeyframePart = false;
-    uint8_t nalType = (static_cast<uint8_t>(packetPayload[0]) & 0b00011111);
-    if ((nalType == 7) || (nalType == 8)) // Sequence Parameter Set / Picture Parameter Set
+    if (!isKeyframeComplete)
     {
-        // SPS often precedes an IDR (Instantaneous Decoder Refresh) aka Keyframe
-        // and provides information on how to decode it. We should keep this around.
-        isKeyframePart = true;
+        return;
     }
-    else if (nalType == 5) // IDR
+
+    // Publish the completed keyframe. Packets share their buffers, so this doesn't copy any
+    // packet data.
+    auto keyframe = std::make_shared<FtlKeyframe>(FtlKeyframe {
+        .Codec = mediaMetadata.VideoCodec,
+        .Generation = ++lastKeyframeGeneration,
+        .CapturedTime = std::chrono::steady_clock::now(),
+        .Packets = data.KeyframeAssembler.GetKeyframePackets(),
+        .Parameters = videoParameters,
+    });
+    spdlog::debug("{} keyframe packets recorded @ timestamp {}", keyframe->Packets.size(),
+        rtpPacket.Fields.Timestamp);
+    currentKeyframeBytes = 0;
+    for (const PacketBuffer& packet : keyframe->Packets)
     {
-        // Managed to fit an entire IDR into one packet!
-        isKeyframePart = true;
+        currentKeyframeBytes += packet.Capacity();
     }
-    // See https://tools.ietf.org/html/rfc3984#section-5.8
-    else if (nalType == 28 || nalType == 29) // Fragmentation unit (FU-A)
+    std::scoped_lock lock(keyframeMutex);
+    currentKeyframe = std::move(keyframe);
+}
+
+size_t FtlMediaConnection::measureMemoryBytes(const std::unique_lock<std::shared_mutex>& dataLock)
+{
+    size_t totalBytes = currentKeyframeBytes;
+    for (const auto& [ssrc, data] : ssrcData)
     {
-        uint8_t fragmentType = (static_cast<uint8_t>(packetPayload[1]) & 0b00011111);
-        if ((fragmentType == 7) || // Fragment of SPS
-            (fragmentType == 5))   // Fragment of IDR
+        totalBytes += data.CircularPacketBuffer.GetHeldBytes();
+        totalBytes += data.KeyframeAssembler.GetHeldBytes();
+        if (data.ReorderBuffer.has_value())
         {
-            isKeyframePart = true;
+            totalBytes += data.ReorderBuffer->GetHeldBytes();
         }
     }
+    memoryBytes.store(totalBytes, std::memory_order_relaxed);
+    return totalBytes;
+}
 
-    if (!isKeyframePart)
+template<VideoCodecKind Codec>
+void FtlMediaConnection::processVideoParameterSet(std::span<const std::byte> parameterSet,
+    const std::unique_lock<std::shared_mutex>& dataLock)
+{
+    // Streamers repeat the same parameters with every keyframe, so only parse them when they
+    // change
+    if (std::equal(parameterSet.begin(), parameterSet.end(), lastParameterSetPayload.begin(),
+        lastParameterSetPayload.end()))
     {
         return;
     }
+    lastParameterSetPayload.assign(parameterSet.begin(), parameterSet.end());
 
-    if (data.PendingKeyframePackets.size() <= 0)
+    Result<VideoParameters> parameters =
+        VideoCodecTraits<Codec>::ParseParameterSet(parameterSet);
+    if (parameters.IsError)
     {
-        insertPacketInSequenceOrder(data.PendingKeyframePackets, rtpPacket);
+        spdlog::warn("Couldn't parse parameter set for Channel {} / Stream {}: {}", channelId,
+            streamId, parameters.ErrorMessage);
+        return;
     }
-    else
+    if (videoParameters == parameters.Value)
     {
-        const RtpPacket& firstPacket = data.PendingKeyframePackets.front();
-        const RtpHeader* firstHeader = firstPacket.Header();
-        rtp_timestamp_t lastTimestamp = ntohl(firstHeader->Timestamp);
-        rtp_timestamp_t currentTimestamp = ntohl(rtpHeader->Timestamp);
-        if (lastTimestamp == currentTimestamp)
-        {
-            insertPacketInSequenceOrder(data.PendingKeyframePackets, rtpPacket);
-        }
-        else
-        {
-            spdlog::debug("{} keyframe packets recorded @ timestamp {}",
-                data.PendingKeyframePackets.size(), currentTimestamp);
-            data.CurrentKeyframePackets.swap(data.PendingKeyframePackets);
-            data.PendingKeyframePackets.clear();
-            data.PendingKeyframePackets.push_back(rtpPacket);
-        }
+        return;
     }
+    videoParameters = parameters.Value;
+    spdlog::info("Channel {} / Stream {} video is {}x{} @ {:.2f}fps, profile {} level {}",
+        channelId, streamId, videoParameters->Width, videoParameters->Height,
+        videoParameters->FrameRate.value_or(0), videoParameters->ProfileIdc,
+        videoParameters->LevelIdc);
+
+    // Make the new parameters visible right away rather than waiting for this keyframe to be
+    // published. The keyframe itself hasn't changed, so it keeps its generation.
+    std::scoped_lock lock(keyframeMutex);
+    auto keyframe = std::make_shared<FtlKeyframe>(*currentKeyframe);
+    keyframe->Parameters = videoParameters;
+    currentKeyframe = std::move(keyframe);
 }
 
 void FtlMediaConnection::updateNackQueue(
     SsrcData& data,
     const rtp_extended_sequence_num_t extendedSeqNum,
-    const std::set<rtp_extended_sequence_num_t>& missingSequences,
+    const RtpPacketRingBuffer::MissingSequenceRange& missingSequences,
+    const std::chrono::steady_clock::time_point now,
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
-    rtp_extended_sequence_num_t lastSequence = data.CircularPacketBuffer.back().ExtendedSequenceNum;
-    if (missingSequences.size() == 0)
+    rtp_extended_sequence_num_t lastSequence = data.CircularPacketBuffer.NewestSequenceNum();
+
+    // Keep the NACK windows in step with the packet buffer. NACK'd packets that fall out of the
+    // window without being re-sent are lost.
+    data.PacketsLost += data.NackedSequences.Advance(lastSequence);
+    data.NackQueue.Advance(lastSequence);
+
+    if (missingSequences.Count == 0)
     {
-        data.PacketsSinceLastMissedSequence++;
+        return;
     }
-    else if (missingSequences.size() > (MAX_PACKETS_BEFORE_NACK * 2))
+    if (missingSequences.Count > MAX_MISSING_PACKETS_TO_NACK)
     {
         spdlog::warn("At least {} packets were lost before current sequence {} - ignoring and "
             "waiting for stream to stabilize...",
-            missingSequences.size(), extendedSeqNum);
-        data.PacketsSinceLastMissedSequence = 0;
-        data.PacketsLost += missingSequences.size();
+            missingSequences.Count, extendedSeqNum);
+        data.PacketsLost += missingSequences.Count;
+        return;
     }
-    else
+
+    // Missing packets wait a moment before being NACKed, in case they were only reordered
+    int missingPacketCount = 0;
+    for (rtp_extended_sequence_num_t missingSeq = missingSequences.First;
+        missingSeq < (missingSequences.First + missingSequences.Count); ++missingSeq)
     {
-        // Only nack packets if they're reasonably new, and haven't already been nack'd
-        int missingPacketCount = 0;
-        for (const auto& missingSeq : missingSequences)
+        if (!data.NackedSequences.Test(missingSeq) && data.NackQueue.Set(missingSeq))
         {
-            if ((data.NackedSequences.count(missingSeq) <= 0) &&
-                (lastSequence - missingSeq < NACK_TIMEOUT_SEQUENCE_DELTA))
-            {
-                data.NackQueue.insert(missingSeq);
-                ++missingPacketCount;
-            }
+            const size_t slot = (missingSeq % RtpSequenceBitmap::WINDOW_SIZE);
+            data.MissingTimes[slot] = now;
+            data.NackCounts[slot] = 0;
+            ++missingPacketCount;
         }
-        spdlog::debug("Marking {} packets missing since sequence {}",
-            missingPacketCount, extendedSeqNum);
-        data.PacketsSinceLastMissedSequence = 0;
     }
+    spdlog::debug("Marking {} packets missing since sequence {}",
+        missingPacketCount, extendedSeqNum);
 }
 
 void FtlMediaConnection::processNacks(const rtp_ssrc_t ssrc,
+    const std::chrono::steady_clock::time_point now,
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
     if (ssrcData.count(ssrc) <= 0)
@@ -484,66 +842,112 @@ void FtlMediaConnection::processNacks(const rtp_ssrc_t ssrc,
         return;
     }
     SsrcData& data = ssrcData.at(ssrc);
-    rtp_extended_sequence_num_t lastSequence = data.CircularPacketBuffer.back().ExtendedSequenceNum;
-    
-    // First, toss any old NACK'd packets that we haven't received and mark them lost.
-    for (auto it = data.NackedSequences.begin(); it != data.NackedSequences.end();)
-    {
-        const rtp_extended_sequence_num_t& nackedSeq = *it;
-        if (lastSequence - nackedSeq > NACK_TIMEOUT_SEQUENCE_DELTA)
+    data.NackDeadline.reset();
+    const auto updateDeadline =
+        [&data](std::chrono::steady_clock::time_point deadline)
         {
-            data.PacketsLost++;
-            it = data.NackedSequences.erase(it);
-        }
-        else
-        {
-            break;
-        }
-    }
-
-    // If enough packets have been marked as missing, or enough time has passed, send NACKs
-    if ((data.NackQueue.size() >= MAX_PACKETS_BEFORE_NACK) ||
-        ((data.NackQueue.size() > 0) &&
-            (data.PacketsSinceLastMissedSequence >= MAX_PACKETS_BEFORE_NACK)))
+            data.NackDeadline = std::min(data.NackDeadline.value_or(deadline), deadline);
+        };
+    if (data.NackQueue.Empty() && data.NackedSequences.Empty())
     {
-        spdlog::debug(fmt::format("Sending NACKs for sequences {}",
-            fmt::join(data.NackQueue, ", ")));
+        updateNackDeadline(dataLock);
+        return;
+    }
+    const rtp_extended_sequence_num_t lastSequence =
+        data.CircularPacketBuffer.NewestSequenceNum();
+    const std::chrono::microseconds smoothedRtt = roundTripTime.GetSmoothedRtt();
+    const std::chrono::microseconds retransmitTimeout = roundTripTime.GetRetransmitTimeout();
+    // Long enough for a reordered packet to turn up, but never a big share of the round trip
+    const std::chrono::microseconds reorderDelay =
+        std::min(smoothedRtt / 4, MAX_NACK_REORDER_DELAY);
 
-        // Mark packets as NACK'd
-        data.NackedSequences.insert(data.NackQueue.begin(), data.NackQueue.end());
-        data.PacketsNacked += data.NackQueue.size();
+    // NACKs that haven't been answered within the retransmit timeout are sent again, unless
+    // a retransmission would arrive too late to be of any use
+    data.NackedSequences.ForEach(
+        [&](rtp_extended_sequence_num_t nackedSeq)
+        {
+            const size_t slot = (nackedSeq % RtpSequenceBitmap::WINDOW_SIZE);
+            if ((now - data.NackTimes[slot]) < retransmitTimeout)
+            {
+                updateDeadline(data.NackTimes[slot] + retransmitTimeout);
+                return;
+            }
+            data.NackedSequences.Reset(nackedSeq);
+            if ((data.NackCounts[slot] >= MAX_NACKS_PER_PACKET) ||
+                ((now + smoothedRtt - data.MissingTimes[slot]) > MAX_RECOVERY_TIME))
+            {
+                data.PacketsLost++;
+                return;
+            }
+            data.NackQueue.Set(nackedSeq);
+        });
 
-        // Send the NACK request packets
-        while (data.NackQueue.size() > 0)
+    // Mark packets as NACK'd, and send a NACK request for each run of sequences that fits in
+    // a single PID + BLP pair
+    size_t sentCount = 0;
+    std::optional<rtp_extended_sequence_num_t> firstSeq;
+    uint16_t followingLostPacketsBitmask = 0;
+    data.NackQueue.ForEach(
+        [&](rtp_extended_sequence_num_t seq)
         {
-            auto it = data.NackQueue.begin();
-            rtp_extended_sequence_num_t firstSeq = *it;
-            uint16_t followingLostPacketsBitmask = 0;
-            spdlog::debug("FIRST SEQ {}", firstSeq);
-            it++;
-            while (true)
+            const size_t slot = (seq % RtpSequenceBitmap::WINDOW_SIZE);
+            if ((data.NackCounts[slot] == 0) && ((now - data.MissingTimes[slot]) < reorderDelay) &&
+                ((lastSequence - seq) < MAX_NACK_REORDER_DISTANCE))
             {
-                if (it == data.NackQueue.end())
-                {
-                    break;
-                }
-
-                rtp_extended_sequence_num_t nextSeq = *it;
-                if ((nextSeq - firstSeq) > 15)
-                {
-                    break;
-                }
-                spdlog::debug("SUB SEQ {}", nextSeq);
-                followingLostPacketsBitmask |= (0x1 << ((nextSeq - firstSeq) - 1));
-                it = data.NackQueue.erase(it);
+                updateDeadline(data.MissingTimes[slot] + reorderDelay);
+                return;
             }
-            data.NackQueue.erase(firstSeq);
+            data.NackQueue.Reset(seq);
+            if (data.NackCounts[slot]++ == 0)
+            {
+                data.PacketsNacked++;
+            }
+            data.NackTimes[slot] = now;
+            data.NackedSequences.Set(seq);
+            updateDeadline(now + retransmitTimeout);
+            ++sentCount;
 
-            sendNack(ssrc, firstSeq, followingLostPacketsBitmask, dataLock);
+            if (firstSeq.has_value() && ((seq - firstSeq.value()) <= 15))
+            {
+                followingLostPacketsBitmask |= (0x1 << ((seq - firstSeq.value()) - 1));
+                return;
+            }
+            if (firstSeq.has_value())
+            {
+                sendNack(ssrc, firstSeq.value(), followingLostPacketsBitmask, dataLock);
+            }
+            firstSeq = seq;
+            followingLostPacketsBitmask = 0;
+        });
+    if (firstSeq.has_value())
+    {
+        spdlog::debug("Sending NACKs for {} sequences", sentCount);
+        sendNack(ssrc, firstSeq.value(), followingLostPacketsBitmask, dataLock);
+    }
+    updateNackDeadline(dataLock);
+}
+
+void FtlMediaConnection::updateNackDeadline(const std::unique_lock<std::shared_mutex>& dataLock)
+{
+    nackDeadline.reset();
+    for (const auto& [ssrc, data] : ssrcData)
+    {
+        if (data.NackDeadline.has_value())
+        {
+            nackDeadline = std::min(nackDeadline.value_or(data.NackDeadline.value()),
+                data.NackDeadline.value());
         }
     }
 }
 
+void FtlMediaConnection::addRoundTripSample(std::chrono::microseconds sample,
+    const std::unique_lock<std::shared_mutex>& dataLock)
+{
+    roundTripTime.AddSample(sample);
+    roundTripTimeMs.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+        roundTripTime.GetSmoothedRtt()).count(), std::memory_order_relaxed);
+}
+
 void FtlMediaConnection::sendNack(const rtp_ssrc_t ssrc, const rtp_sequence_num_t packetId,
         const uint16_t followingLostPacketsBitmask,
         const std::unique_lock<std::shared_mutex>& dataLock)
@@ -572,42 +976,118 @@ void FtlMediaConnection::sendNack(const rtp_ssrc_t ssrc, const rtp_sequence_num_
         spdlog::to_hex(nackBytes.begin(), nackBytes.end()));
 }
 
+bool FtlMediaConnection::policeBitrate(const RtpPacket& rtpPacket,
+    const std::unique_lock<std::shared_mutex>& dataLock)
+{
+    if (!bitratePolicer.has_value())
+    {
+        return true;
+    }
+
+    switch (bitratePolicer->Police(std::chrono::steady_clock::now(), rtpPacket.Bytes.Size()))
+    {
+    case BitratePolicer<>::Verdict::Accept:
+        return true;
+    case BitratePolicer<>::Verdict::Exceeded:
+        spdlog::info("Channel {} / Stream {} went over its limit of {}bps {} times. "
+            "Stopping the stream...", channelId, streamId, bitrateLimit.MaxBitsPerSecond,
+            bitratePolicer->GetViolations());
+        if (bitrateLimit.OnExceeded)
+        {
+            bitrateLimit.OnExceeded();
+        }
+        break;
+    case BitratePolicer<>::Verdict::Drop:
+        break;
+    }
+    packetsOverBitrateLimit.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
 void FtlMediaConnection::processAudioVideoRtpPacket(const RtpPacket& rtpPacket,
+    const std::chrono::steady_clock::time_point now,
     std::unique_lock<std::shared_mutex>& dataLock)
 {
     processRtpPacketKeyframe(rtpPacket, dataLock);
 
+    SsrcData& data = ssrcData.at(rtpPacket.Fields.Ssrc);
+    if (!data.ReorderBuffer.has_value())
+    {
+        fanOutRtpPacket(rtpPacket);
+        return;
+    }
+
+    // Keyframes are captured as packets arrive, since the assembler puts them in order itself,
+    // but viewers are only sent packets once the packets before them have been
+    const RtpReorderBuffer::InsertResult insertResult = data.ReorderBuffer->Insert(rtpPacket,
+        now,
+        [this](const RtpPacket& packet) { fanOutRtpPacket(packet); });
+    switch (insertResult)
+    {
+    case RtpReorderBuffer::InsertResult::Accepted:
+        break;
+    case RtpReorderBuffer::InsertResult::Duplicate:
+        data.DuplicatePacketsDropped.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case RtpReorderBuffer::InsertResult::Late:
+        data.PacketsDroppedLate.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+}
+
+void FtlMediaConnection::releaseReorderedPackets(const std::chrono::steady_clock::time_point now,
+    const std::unique_lock<std::shared_mutex>& dataLock)
+{
+    for (auto& [ssrc, data] : ssrcData)
+    {
+        if (data.ReorderBuffer.has_value())
+        {
+            data.ReorderBuffer->ReleaseReady(now,
+                [this](const RtpPacket& packet) { fanOutRtpPacket(packet); });
+        }
+    }
+}
+
+void FtlMediaConnection::fanOutRtpPacket(const RtpPacket& rtpPacket)
+{
     if (onRtpPacketBytes)
     {
         onRtpPacketBytes(rtpPacket.Bytes);
     }
 }
 
-void FtlMediaConnection::handlePing(const std::vector<std::byte>& packetBytes)
+void FtlMediaConnection::handlePing(const PacketBuffer& packetBytes)
 {
-    // FTL client is trying to measure round trip time (RTT), pong back the same packet
+    // FTL client is trying to measure round trip time (RTT), pong back the same packet. The
+    // ping only carries the client's own clock, so we time the round trip from NACKs instead.
     transport->Write(packetBytes);
 }
 
-void FtlMediaConnection::handleSenderReport(const std::vector<std::byte>& packetBytes)
+void FtlMediaConnection::handleSenderReport(const PacketBuffer& packetBytes)
 {
     // We expect this packet to be 28 bytes big.
-    if (packetBytes.size() != 28)
+    if (packetBytes.Size() != sizeof(RtcpSenderReportPacket))
+    {
+        spdlog::warn("Invalid sender report packet of length {} (expect {})", packetBytes.Size(),
+            sizeof(RtcpSenderReportPacket));
+        if (packetBytes.Size() < sizeof(RtcpSenderReportPacket))
+        {
+            return;
+        }
+    }
+    RtcpSenderReportPacket report;
+    std::memcpy(&report, packetBytes.Data(), sizeof(report));
+    const rtp_ssrc_t ssrc = ntohl(report.Ssrc);
+    auto it = ssrcData.find(ssrc);
+    if (it == ssrcData.end())
     {
-        spdlog::warn("Invalid sender report packet of length {} (expect 28)", packetBytes.size());
+        spdlog::debug("Received sender report for unexpected ssrc {}", ssrc);
+        return;
     }
-    // char* packet = reinterpret_cast<char*>(rtpHeader);
-    // uint32_t ssrc              = ntohl(*reinterpret_cast<uint32_t*>(packet + 4));
-    // uint32_t ntpTimestampHigh  = ntohl(*reinterpret_cast<uint32_t*>(packet + 8));
-    // uint32_t ntpTimestampLow   = ntohl(*reinterpret_cast<uint32_t*>(packet + 12));
-    // uint32_t rtpTimestamp      = ntohl(*reinterpret_cast<uint32_t*>(packet + 16));
-    // uint32_t senderPacketCount = ntohl(*reinterpret_cast<uint32_t*>(packet + 20));
-    // uint32_t senderOctetCount  = ntohl(*reinterpret_cast<uint32_t*>(packet + 24));
-
-    // uint64_t ntpTimestamp = (static_cast<uint64_t>(ntpTimestampHigh) << 32) | 
-    //     static_cast<uint64_t>(ntpTimestampLow);
 
-    // TODO: We don't do anything with this information right now, but we ought to log
-    // it away somewhere.
+    // Only the sender's own counts are of use, no report blocks come along with them
+    const uint32_t senderPacketCount = ntohl(report.SenderPacketCount);
+    it->second.SenderReportedPackets.store(senderPacketCount, std::memory_order_relaxed);
+    spdlog::trace("Sender report for ssrc {}: {} packets, {} bytes, RTP timestamp {}", ssrc,
+        senderPacketCount, ntohl(report.SenderOctetCount), ntohl(report.RtpTimestamp));
 }
-#pragma endregion
\ No newline at end of file
@@ -10,24 +10,74 @@
 #pragma once
 
 #include "Rtp/ExtendedSequenceCounter.h"
+#include "Rtp/H264KeyframeAssembler.h"
 #include "Rtp/RtpPacket.h"
+#include "Rtp/RtpPacketRingBuffer.h"
+#include "Rtp/RtpReorderBuffer.h"
+#include "Rtp/RtpSequenceBitmap.h"
+#include "Utilities/BitratePolicer.h"
+#include "Utilities/EpollReactor.h"
 #include "Utilities/FtlTypes.h"
+#include "Utilities/PacketLatencyTracer.h"
 #include "Utilities/Result.h"
+#include "Utilities/RollingByteCounter.h"
+#include "Utilities/RttEstimator.h"
+#include "Utilities/ThreadPlacement.h"
+#include "VideoCodecTraits.h"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <list>
-#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <set>
-#include <set>
 #include <shared_mutex>
+#include <span>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
 class ConnectionTransport;
 class FtlControlConnection;
+struct FtlSsrcSequenceHandoff;
+struct FtlStreamHandoff;
+
+/**
+ * @brief
+ *  Where the threads reading a stream's packets should run. Declared outside of
+ *  FtlMediaConnection so it's complete in time to be defaulted in its constructor.
+ */
+struct FtlMediaCpuPlacement
+{
+    // NUMA node to read on, if the reactor or our own thread can be kept on it
+    std::optional<int> NumaNode;
+    // CPUs our own thread is pinned to when a reactor is not in use, or empty for any
+    std::vector<int> ThreadCpus;
+    // Whether to move reading onto the NUMA node packets are being received on, once the
+    // first packets have arrived
+    bool FollowRxCpu = false;
+    // Called when reading moves to a different NUMA node
+    std::function<void(int numaNode)> OnNumaNodeChanged;
+};
+
+/**
+ * @brief
+ *  Bitrate a stream's media packets are policed to as they're received, declared alongside
+ *  FtlMediaCpuPlacement for the same reason.
+ */
+struct FtlMediaBitrateLimit
+{
+    // Most bits per second the stream may average, or 0 for no limit
+    uint32_t MaxBitsPerSecond = 0;
+    // Most bytes the stream may send above its average at once, or 0 for one second's worth
+    size_t BurstBytes = 0;
+    // Packets over the limit before the stream is stopped, or 0 to only drop them
+    uint32_t MaxViolations = 0;
+    // Called once the stream has gone over its limit MaxViolations times in quick succession
+    std::function<void()> OnExceeded;
+};
 
 /**
  * @brief Manages the FTL media stream, accepting incoming RTP packets.
@@ -37,9 +87,30 @@ class FtlMediaConnection
 public:
     /* Public types */
     using ClosedCallback = std::function<void(FtlMediaConnection&)>;
-    using RtpPacketCallback = std::function<void(const std::vector<std::byte>&)>;
+    using RtpPacketCallback = std::function<void(const PacketBuffer&)>;
+    using CpuPlacement = FtlMediaCpuPlacement;
+    using BitrateLimit = FtlMediaBitrateLimit;
+
+    /* Constants */
+    static constexpr size_t DEFAULT_MAX_MEMORY_BYTES = 4 * 1024 * 1024;
 
     /* Constructor/Destructor */
+    /**
+     * @param maxMemoryBytes
+     *  most packet buffer capacity the stream's retransmit buffers, the keyframe being captured,
+     *  and the current keyframe can hold between them, or 0 for no limit. Keyframes that would
+     *  take the stream over it aren't captured.
+     * @param placement where packets should be read
+     * @param bitrateLimit
+     *  bitrate media packets are held to. Packets over it are dropped before they're captured
+     *  in keyframes or fanned out.
+     * @param reorderDelay
+     *  most time media packets are held for the packets before them to show up, so they're
+     *  fanned out in sequence order, or 0 to fan them out as soon as they arrive
+     * @param resumeSequences
+     *  where the sequences of a stream handed over by another process got to, so packets
+     *  carry on being counted (and lost packets NACKed) from there
+     */
     FtlMediaConnection(
         std::unique_ptr<ConnectionTransport> transport,
         const MediaMetadata mediaMetadata,
@@ -48,31 +119,86 @@ public:
         const ClosedCallback onClosed,
         const RtpPacketCallback onRtpPacket,
         const uint32_t rollingSizeAvgMs = 2000,
-        const bool nackLostPackets = true);
+        const bool nackLostPackets = true,
+        const std::shared_ptr<EpollReactor> reactor = nullptr,
+        const std::shared_ptr<MetricsRegistry> metrics = nullptr,
+        const size_t maxMemoryBytes = DEFAULT_MAX_MEMORY_BYTES,
+        const CpuPlacement placement = {},
+        const BitrateLimit bitrateLimit = {},
+        const std::chrono::milliseconds reorderDelay = std::chrono::milliseconds(0),
+        std::span<const FtlSsrcSequenceHandoff> resumeSequences = {});
+    ~FtlMediaConnection();
 
     /* Public methods */
     void RequestStop();
+    /**
+     * @brief
+     *  Stops reading without closing the connection or calling onClosed, filling in what
+     *  another process needs to carry on receiving the stream: its sequences, and the
+     *  transport's handle and address. The handle is owned by the handoff from then on.
+     *  If it can't be handed off, the connection is closed as if it had stopped.
+     */
+    Result<void> HandOff(FtlStreamHandoff& handoff);
+    /**
+     * @brief
+     *  Starts the round trip estimate NACKs are timed by off from one measured elsewhere,
+     *  such as on the control connection, if it hasn't been measured from NACKs yet
+     */
+    void SeedRoundTripTime(std::chrono::microseconds roundTripTime);
 
     /* Getters/Setters */
+    /**
+     * @brief Reads the latest stream counters without waiting on packet processing
+     */
     FtlStreamStats GetStats();
-    Result<FtlKeyframe> GetKeyframe();
+    /**
+     * @brief
+     *  Returns the most recently captured keyframe. Keyframes are immutable once published,
+     *  so the returned snapshot can be held onto without copying.
+     */
+    Result<std::shared_ptr<const FtlKeyframe>> GetKeyframe();
 
 private:
     /* Private types */
+    using VideoKeyframeProcessor = void (FtlMediaConnection::*)(const RtpPacket& rtpPacket,
+        const std::unique_lock<std::shared_mutex>& dataLock);
+
     struct SsrcData
     {
-        uint32_t PacketsReceived = 0;
-        uint32_t PacketsNacked = 0;
-        uint32_t PacketsLost = 0;
-        size_t PacketsSinceLastMissedSequence = 0;
-        std::list<RtpPacket> CircularPacketBuffer;
-        std::map<std::chrono::time_point<std::chrono::steady_clock>, uint16_t> 
-            RollingBytesReceivedByTime;
-        std::set<rtp_extended_sequence_num_t> NackQueue;
-        std::set<rtp_extended_sequence_num_t> NackedSequences;
-        std::list<RtpPacket> CurrentKeyframePackets;
-        std::list<RtpPacket> PendingKeyframePackets;
+        SsrcData(std::chrono::milliseconds rollingWindow)
+        :
+            RollingBytesReceived(rollingWindow, BITRATE_BUCKET_DURATION)
+        { }
+
+        // Counters are only written with dataMutex held, but may be read without it
+        std::atomic<uint32_t> PacketsReceived { 0 };
+        std::atomic<uint32_t> PacketsNacked { 0 };
+        std::atomic<uint32_t> PacketsLost { 0 };
+        std::atomic<uint64_t> BytesReceived { 0 };
+        // Mirror the packet buffer and NACK bitmaps, which can't be read without dataMutex
+        std::atomic<uint32_t> PacketsBuffered { 0 };
+        std::atomic<uint32_t> NacksQueued { 0 };
+        std::atomic<uint32_t> NacksOutstanding { 0 };
+        std::atomic<uint32_t> SenderReportedPackets { 0 };
+        std::atomic<uint32_t> PacketsDroppedLate { 0 };
+        std::atomic<uint32_t> DuplicatePacketsDropped { 0 };
+        RtpPacketRingBuffer CircularPacketBuffer { PACKET_BUFFER_SIZE };
+        RollingByteCounter RollingBytesReceived;
+        RtpSequenceBitmap NackQueue;
+        RtpSequenceBitmap NackedSequences;
+        // Indexed by sequence within the NACK window: when each sequence in NackQueue or
+        // NackedSequences went missing, when it was last NACKed, and how many times
+        std::array<std::chrono::steady_clock::time_point, RtpSequenceBitmap::WINDOW_SIZE>
+            MissingTimes {};
+        std::array<std::chrono::steady_clock::time_point, RtpSequenceBitmap::WINDOW_SIZE>
+            NackTimes {};
+        std::array<uint8_t, RtpSequenceBitmap::WINDOW_SIZE> NackCounts {};
+        // When processNacks next has something to send or give up on, if anything
+        std::optional<std::chrono::steady_clock::time_point> NackDeadline;
+        H264KeyframeAssembler KeyframeAssembler { KEYFRAME_BUFFER_SIZE };
         ExtendedSequenceCounter SequenceCounter;
+        // Only set if packets are held to be fanned out in order
+        std::optional<RtpReorderBuffer> ReorderBuffer;
     };
 
     /* Constants */
@@ -81,53 +207,170 @@ private:
     static constexpr rtp_payload_type_t  FTL_PAYLOAD_TYPE_SENDER_REPORT = 200;
     static constexpr rtp_payload_type_t  FTL_PAYLOAD_TYPE_PING          = 250;
     static constexpr size_t              PACKET_BUFFER_SIZE             = 128;
-    static constexpr size_t              MAX_PACKETS_BEFORE_NACK        = 16;
-    static constexpr size_t              NACK_TIMEOUT_SEQUENCE_DELTA    = 128;
+    static constexpr size_t              KEYFRAME_BUFFER_SIZE           = 1024;
+    // Bigger gaps than this are waited out rather than NACKed
+    static constexpr size_t              MAX_MISSING_PACKETS_TO_NACK    = 32;
+    // Times a missing packet is NACKed before it's given up on
+    static constexpr uint8_t             MAX_NACKS_PER_PACKET           = 3;
+    // Most a missing packet waits for a reordered copy to show up before it's NACKed, in time
+    // and in packets received since
+    static constexpr std::chrono::microseconds MAX_NACK_REORDER_DELAY { 20000 };
+    static constexpr size_t              MAX_NACK_REORDER_DISTANCE      = 32;
+    // Packets that can't be recovered within this long of going missing are given up on
+    static constexpr std::chrono::milliseconds MAX_RECOVERY_TIME { 1000 };
+    static constexpr size_t              READ_BATCH_SIZE                = 32;
     static constexpr std::chrono::milliseconds READ_TIMEOUT{200};
+    static constexpr std::chrono::milliseconds BITRATE_BUCKET_DURATION{10};
 
     /* Private members */
     const std::unique_ptr<ConnectionTransport> transport;
     const MediaMetadata mediaMetadata;
+    // Bound to the stream's video codec up front, or null if we can't process its keyframes
+    const VideoKeyframeProcessor processVideoKeyframe;
     const ftl_channel_id_t channelId;
     const ftl_stream_id_t streamId;
     const ClosedCallback onClosed;
     const RtpPacketCallback onRtpPacketBytes;
     const uint32_t rollingSizeAvgMs;
     const bool nackLostPackets;
+    const size_t maxMemoryBytes;
+    const CpuPlacement placement;
+    // Only touched by whichever thread is reading packets
+    bool hasFollowedRxCpu = false;
+    // Reactor this connection is read from, if not read from its own thread
+    const std::shared_ptr<EpollReactor> reactor;
+    std::optional<EpollReactor::RegistrationId> reactorRegistration;
+    // Wakes the reactor for NACKs that come due while no packets are arriving, only set up
+    // if a reactor is in use
+    int nackTimerHandle = -1;
+    std::optional<EpollReactor::RegistrationId> nackTimerRegistration;
+    // Null unless packet latency tracing is compiled in and metrics are being served
+    const std::unique_ptr<PacketLatencyTracer> latencyTracer;
+    std::vector<PacketBuffer> readBuffers;
+    // Whichever thread last read packets, whether our own or one of the reactor's
+    ThreadPlacement readerPlacement;
     // Stream data
     std::shared_mutex dataMutex;
     time_t startTime { 0 };
     std::chrono::time_point<std::chrono::steady_clock> steadyStartTime;
+    // Entries are only added on construction, so the map itself can be read without dataMutex
     std::unordered_map<rtp_ssrc_t, SsrcData> ssrcData;
-    // Thread to read and process packets from the connection, must be initialized last
+    // Latest complete keyframe, published under its own lock so readers don't touch dataMutex
+    std::mutex keyframeMutex;
+    std::shared_ptr<const FtlKeyframe> currentKeyframe;
+    uint64_t lastKeyframeGeneration = 0;
+    // Packet buffer capacity held by the current keyframe
+    size_t currentKeyframeBytes = 0;
+    // Counted against maxMemoryBytes. Packets held in more than one place, like the newest
+    // packets of a keyframe that are also in the retransmit buffer, count once for each.
+    std::atomic<uint64_t> memoryBytes { 0 };
+    std::atomic<uint32_t> keyframesDropped { 0 };
+    // Only set if a bitrate limit was given
+    const BitrateLimit bitrateLimit;
+    std::optional<BitratePolicer<>> bitratePolicer;
+    std::atomic<uint32_t> packetsOverBitrateLimit { 0 };
+    // Round trip to the streamer, timed by NACKs answered with a retransmission. Guarded by
+    // dataMutex, and mirrored for stats.
+    RttEstimator roundTripTime;
+    std::atomic<uint32_t> roundTripTimeMs { 0 };
+    // Earliest NackDeadline of any SSRC, and what nackTimerHandle was last armed for. Guarded
+    // by dataMutex.
+    std::optional<std::chrono::steady_clock::time_point> nackDeadline;
+    std::optional<std::chrono::steady_clock::time_point> armedNackDeadline;
+    // Set while handing off, so reading stops without the transport being closed
+    std::atomic<bool> isHandingOff { false };
+    // Parameters read from the stream's most recent parameter set
+    std::vector<std::byte> lastParameterSetPayload;
+    std::optional<VideoParameters> videoParameters;
+    // Thread to read and process packets from the connection when a reactor is not in use,
+    // must be initialized last
     std::jthread thread;
 
     /* Private methods */
     void threadBody(std::stop_token stopToken);
-    void onBytesReceived(const std::vector<std::byte>& bytes);
+    bool readAvailablePackets(std::chrono::milliseconds timeout);
+    /**
+     * @brief
+     *  Sets up nackTimerHandle and registers it with the reactor, so NACKs don't wait on the
+     *  next packet to arrive
+     */
+    Result<void> startNackTimer();
+    void stopNackTimer();
+    /**
+     * @brief
+     *  Runs processNacks for every SSRC if any NACKs have come due since packets were last
+     *  processed, and arms nackTimerHandle for the next deadline if it's set up
+     * @return when processNacks next needs to run, if it does
+     */
+    std::optional<std::chrono::steady_clock::time_point> processDueNacks();
+    /**
+     * @brief
+     *  CPUs our own thread should run on to be on the given NUMA node, or empty if none of
+     *  the CPUs we're allowed are on it
+     */
+    std::vector<int> threadCpusOnNode(std::optional<int> numaNode) const;
+    void followRxCpu();
+    void onTransportStopped();
+    void onBytesReceived(const PacketBuffer& bytes);
     // Packet processing
-    std::set<rtp_extended_sequence_num_t> insertPacketInSequenceOrder(
-        std::list<RtpPacket>& packetList, const RtpPacket& rtpPacket);
-    void processRtpPacketBytes(const std::vector<std::byte>& packetBytes);
-    std::optional<RtpPacket> parseMediaPacket(const std::vector<std::byte>& packetBytes,
-        const std::unique_lock<std::shared_mutex>& dataLock);
+    void processRtpPacketBytes(const PacketBuffer& packetBytes);
+    std::optional<RtpPacket> parseMediaPacket(const PacketBuffer& packetBytes,
+        const RtpPacketFields& fields, const std::unique_lock<std::shared_mutex>& dataLock);
     void processRtpPacketSequencing(const RtpPacket& packet,
+        const std::chrono::steady_clock::time_point now,
         const std::unique_lock<std::shared_mutex>& dataLock);
     void processRtpPacketKeyframe(const RtpPacket& rtpPacket,
         const std::unique_lock<std::shared_mutex>& dataLock);
-    void processRtpH264PacketKeyframe(const RtpPacket& rtpPacket,
+    static VideoKeyframeProcessor videoKeyframeProcessorFor(VideoCodecKind codec);
+    template<VideoCodecKind Codec>
+    void processVideoPacketKeyframe(const RtpPacket& rtpPacket,
+        const std::unique_lock<std::shared_mutex>& dataLock);
+    /**
+     * @brief Adds up the packet buffers the stream holds, and mirrors it for stats
+     */
+    size_t measureMemoryBytes(const std::unique_lock<std::shared_mutex>& dataLock);
+    template<VideoCodecKind Codec>
+    void processVideoParameterSet(std::span<const std::byte> parameterSet,
         const std::unique_lock<std::shared_mutex>& dataLock);
     void updateNackQueue(
         SsrcData& data,
         const rtp_extended_sequence_num_t extendedSeqNum,
-        const std::set<rtp_extended_sequence_num_t>& missingSequences,
+        const RtpPacketRingBuffer::MissingSequenceRange& missingSequences,
+        const std::chrono::steady_clock::time_point now,
+        const std::unique_lock<std::shared_mutex>& dataLock);
+    /**
+     * @brief
+     *  Sends NACKs for missing packets that have waited long enough for a reordered copy,
+     *  and again for NACKed packets still missing a retransmit timeout later, giving up on
+     *  packets that have been NACKed too often or could no longer arrive in time to matter.
+     *  Runs as packets of the SSRC arrive, and from processDueNacks once the SSRC's
+     *  NackDeadline (which it updates, along with nackDeadline) has passed.
+     */
+    void processNacks(const rtp_ssrc_t ssrc, const std::chrono::steady_clock::time_point now,
+        const std::unique_lock<std::shared_mutex>& dataLock);
+    void updateNackDeadline(const std::unique_lock<std::shared_mutex>& dataLock);
+    void addRoundTripSample(std::chrono::microseconds sample,
         const std::unique_lock<std::shared_mutex>& dataLock);
-    void processNacks(const rtp_ssrc_t ssrc, const std::unique_lock<std::shared_mutex>& dataLock);
     void sendNack(const rtp_ssrc_t ssrc, const rtp_sequence_num_t packetId,
         const uint16_t followingLostPacketsBitmask,
         const std::unique_lock<std::shared_mutex>& dataLock);
+    /**
+     * @brief Whether the packet fits within the stream's bitrate limit
+     */
+    bool policeBitrate(const RtpPacket& rtpPacket,
+        const std::unique_lock<std::shared_mutex>& dataLock);
     void processAudioVideoRtpPacket(const RtpPacket& rtpPacket,
+        const std::chrono::steady_clock::time_point now,
         std::unique_lock<std::shared_mutex>& dataLock);
-    void handlePing(const std::vector<std::byte>& packetBytes);
-    void handleSenderReport(const std::vector<std::byte>& packetBytes);
+    /**
+     * @brief
+     *  Fans out packets held for reordering that have waited long enough, on every SSRC.
+     *  Runs as packets arrive, so packets are never held more than a packet longer than the
+     *  reorder delay while media keeps arriving.
+     */
+    void releaseReorderedPackets(const std::chrono::steady_clock::time_point now,
+        const std::unique_lock<std::shared_mutex>& dataLock);
+    void fanOutRtpPacket(const RtpPacket& rtpPacket);
+    void handlePing(const PacketBuffer& packetBytes);
+    void handleSenderReport(const PacketBuffer& packetBytes);
 };
\ No newline at end of file
@@ -9,10 +9,14 @@
 
 #include "ConnectionCreators/ConnectionCreator.h"
 #include "ConnectionListeners/ConnectionListener.h"
+#include "ConnectionTransports/NetworkSocketConnectionTransport.h"
 #include "FtlControlConnection.h"
 #include "FtlStream.h"
 #include "Utilities/Util.h"
 
+#include <array>
+#include <exception>
+
 #pragma region Constructor/Destructor
 FtlServer::FtlServer(
     std::unique_ptr<ConnectionListener> ingestControlListener,
@@ -22,6 +26,13 @@ FtlServer::FtlServer(
     StreamEndedCallback onStreamEnded,
     uint32_t rollingSizeAvgMs,
     bool nackLostPackets,
+    size_t maxStreamMemoryBytes,
+    std::chrono::milliseconds mediaReorderDelay,
+    std::shared_ptr<EpollReactor> connectionReactor,
+    FtlMediaConnection::CpuPlacement mediaPlacement,
+    FtlMediaConnection::BitrateLimit mediaBitrateLimit,
+    std::shared_ptr<MetricsRegistry> metrics,
+    size_t asyncWorkerThreads,
     uint16_t minMediaPort,
     uint16_t maxMediaPort)
 :
@@ -34,7 +45,18 @@ FtlServer::FtlServer(
     maxMediaPort(maxMediaPort),
     rollingSizeAvgMs(rollingSizeAvgMs),
     nackLostPackets(nackLostPackets),
-    eventQueueThread(std::jthread(&FtlServer::eventQueueThreadBody, this))
+    maxStreamMemoryBytes(maxStreamMemoryBytes),
+    mediaReorderDelay(mediaReorderDelay),
+    connectionReactor(std::move(connectionReactor)),
+    mediaPlacement(std::move(mediaPlacement)),
+    mediaBitrateLimit(std::move(mediaBitrateLimit)),
+    metrics(std::move(metrics)),
+    asyncCallExecutor(asyncWorkerThreads),
+    eventQueueThread(
+        [this](std::stop_token stopToken)
+        {
+            eventQueueThreadBody(stopToken);
+        })
 {
     // Bind event listeners
     eventQueue.appendListener(FtlServerEventKind::StopStream,
@@ -151,7 +173,7 @@ void FtlServer::ControlConnectionRequestedHmacKey(FtlControlConnection* connecti
 }
 
 void FtlServer::ControlConnectionRequestedMediaPort(FtlControlConnection* connection,
-    ftl_channel_id_t channelId, MediaMetadata mediaMetadata, in_addr targetAddr)
+    ftl_channel_id_t channelId, MediaMetadata mediaMetadata, IpAddress targetAddr)
 {
     spdlog::debug("FtlServer::ControlConnectionRequestedMediaPort queueing "
         "ControlRequestMediaPort event");
@@ -166,7 +188,8 @@ void FtlServer::ControlConnectionRequestedMediaPort(FtlControlConnection* connec
             }));
 }
 
-void FtlServer::StopStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId)
+void FtlServer::StopStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId,
+    bool dispatchStreamEnded)
 {
     spdlog::debug("FtlServer::StopStream queueing StopStream event");
     eventQueue.enqueue(FtlServerEventKind::StopStream,
@@ -175,16 +198,185 @@ void FtlServer::StopStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId)
             {
                 .ChannelId = channelId,
                 .StreamId = streamId,
+                .DispatchStreamEnded = dispatchStreamEnded,
             }));
 }
 
+Result<FtlHandoff> FtlServer::HandOffSockets()
+{
+    // Nothing is stopped unless new connections can carry on being accepted somewhere
+    Result<std::vector<int>> listenResult = ingestControlListener->DetachListenHandles();
+    if (listenResult.IsError)
+    {
+        return Result<FtlHandoff>::Error(listenResult.ErrorMessage);
+    }
+    FtlHandoff handoff;
+    handoff.ControlListenHandles = std::move(listenResult.Value);
+    Result<std::vector<int>> mediaResult = mediaConnectionCreator->DetachSharedHandles();
+    if (mediaResult.IsError)
+    {
+        FtlHandoffProtocol::CloseHandles(handoff);
+        return Result<FtlHandoff>::Error(mediaResult.ErrorMessage);
+    }
+    handoff.MediaHandles = std::move(mediaResult.Value);
+    return Result<FtlHandoff>::Success(std::move(handoff));
+}
+
+void FtlServer::HandOffStreams(const std::function<void(FtlStreamHandoff&)>& onStreamHandedOff)
+{
+    // Streams are handed off without our lock, since their readers may be waiting on it
+    std::vector<std::pair<std::shared_ptr<FtlStream>, uint16_t>> streams;
+    {
+        std::shared_lock lock(streamDataMutex);
+        for (const auto& pair : activeStreams)
+        {
+            streams.emplace_back(pair.second.Stream, pair.second.MediaPort);
+        }
+    }
+    for (const auto& [stream, mediaPort] : streams)
+    {
+        FtlStreamHandoff streamHandoff;
+        streamHandoff.MediaPort = mediaPort;
+        Result<void> streamResult = stream->HandOff(streamHandoff);
+        if (streamResult.IsError)
+        {
+            // The stream has stopped, and will be removed like any other
+            spdlog::warn("Channel {} / Stream {} couldn't be handed off: {}",
+                stream->GetChannelId(), stream->GetStreamId(), streamResult.ErrorMessage);
+            continue;
+        }
+
+        {
+            std::unique_lock lock(streamDataMutex);
+            if (activeStreams.count(stream.get()) > 0)
+            {
+                removeStreamRecord(stream.get(), lock);
+            }
+        }
+        onStreamHandedOff(streamHandoff);
+    }
+}
+
+Result<void> FtlServer::AdoptStream(FtlStreamHandoff& handoff,
+    std::shared_ptr<RtpPacketSink> packetSink)
+{
+    // Media for every stream on a shared port arrives on the sockets handed off with the
+    // server, so we need to have adopted them
+    const std::optional<uint16_t> sharedPort = mediaConnectionCreator->GetSharedPort();
+    if ((handoff.MediaHandle < 0) && (sharedPort != handoff.MediaPort))
+    {
+        FtlHandoffProtocol::CloseHandles(handoff);
+        return Result<void>::Error(fmt::format(
+            "Stream's media is received on shared port {}, which we aren't receiving on",
+            handoff.MediaPort));
+    }
+    if (handoff.ControlHandle < 0)
+    {
+        FtlHandoffProtocol::CloseHandles(handoff);
+        return Result<void>::Error("Stream was handed off without its control connection");
+    }
+
+    // Transports take ownership of the handles, closing them if they fail
+    auto controlResult = NetworkSocketConnectionTransport::Nonblocking(
+        NetworkSocketConnectionKind::Tcp,
+        std::exchange(handoff.ControlHandle, -1),
+        handoff.ControlAddr,
+        handoff.ControlAddr6);
+    if (controlResult.IsError)
+    {
+        FtlHandoffProtocol::CloseHandles(handoff);
+        return Result<void>::Error(controlResult.ErrorMessage);
+    }
+    std::unique_ptr<ConnectionTransport> mediaTransport;
+    if (handoff.MediaHandle >= 0)
+    {
+        auto mediaResult = NetworkSocketConnectionTransport::Nonblocking(
+            NetworkSocketConnectionKind::Udp,
+            std::exchange(handoff.MediaHandle, -1),
+            handoff.MediaAddr,
+            handoff.MediaAddr6);
+        if (mediaResult.IsError)
+        {
+            return Result<void>::Error(mediaResult.ErrorMessage);
+        }
+        mediaTransport = std::move(mediaResult.Value);
+    }
+    else
+    {
+        const std::optional<IpAddress> mediaAddr =
+            IpAddress::FromSockaddr(handoff.MediaAddr, handoff.MediaAddr6);
+        if (!mediaAddr.has_value())
+        {
+            return Result<void>::Error("Stream was handed off without its media address");
+        }
+        const std::array<uint32_t, 2> ssrcs {
+            handoff.Metadata.AudioSsrc,
+            handoff.Metadata.VideoSsrc,
+        };
+        try
+        {
+            mediaTransport = mediaConnectionCreator->CreateConnection(handoff.MediaPort,
+                mediaAddr.value(), ssrcs);
+        }
+        catch (const std::exception& e)
+        {
+            return Result<void>::Error(e.what());
+        }
+    }
+
+    auto control = std::make_shared<FtlControlConnection>(this,
+        std::move(controlResult.Value), connectionReactor, &handoff);
+    auto stream = std::make_shared<FtlStream>(
+        std::move(control),
+        handoff.StreamId,
+        std::bind(&FtlServer::onStreamClosed, this, std::placeholders::_1),
+        rollingSizeAvgMs,
+        nackLostPackets,
+        maxStreamMemoryBytes,
+        mediaReorderDelay,
+        connectionReactor,
+        metrics);
+
+    // Record the stream before media is read, so it's found if it closes right away
+    {
+        std::unique_lock lock(streamDataMutex);
+        if (!sharedPort.has_value())
+        {
+            usedMediaPorts.insert(handoff.MediaPort);
+        }
+        activeStreams.try_emplace(stream.get(), stream, handoff.MediaPort);
+    }
+    Result<void> resumeResult = stream->ResumeMediaConnection(
+        std::move(mediaTransport),
+        handoff,
+        [packetSink](const PacketBuffer& packet)
+        {
+            packetSink->SendRtpPacket(packet);
+        },
+        streamPlacement(packetSink),
+        streamBitrateLimit(handoff.ChannelId, handoff.StreamId));
+    if (resumeResult.IsError)
+    {
+        std::unique_lock lock(streamDataMutex);
+        removeStreamRecord(stream.get(), lock);
+        return resumeResult;
+    }
+
+    const std::optional<IpAddress> controlAddr =
+        IpAddress::FromSockaddr(handoff.ControlAddr, handoff.ControlAddr6);
+    spdlog::info("{} FtlStream carried on streaming Channel {} / Stream {} on port {}",
+        controlAddr.has_value() ? controlAddr.value().ToString() : "UNKNOWN",
+        handoff.ChannelId, handoff.StreamId, handoff.MediaPort);
+    return Result<void>::Success();
+}
+
 std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>,
-    std::pair<FtlStreamStats, FtlKeyframe>>>
+    std::pair<FtlStreamStats, std::shared_ptr<const FtlKeyframe>>>>
     FtlServer::GetAllStatsAndKeyframes()
 {
     std::shared_lock lock(streamDataMutex);
     std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>,
-        std::pair<FtlStreamStats, FtlKeyframe>>>
+        std::pair<FtlStreamStats, std::shared_ptr<const FtlKeyframe>>>>
         returnVal;
     for (const auto& pair : activeStreams)
     {
@@ -212,6 +404,25 @@ std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>,
     return returnVal;
 }
 
+std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>, FtlStreamStats>>
+    FtlServer::GetAllStats()
+{
+    std::shared_lock lock(streamDataMutex);
+    std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>, FtlStreamStats>> returnVal;
+    for (const auto& pair : activeStreams)
+    {
+        const std::shared_ptr<FtlStream>& stream = pair.second.Stream;
+        const auto stats = stream->GetStats();
+        if (stats.IsError)
+        {
+            continue;
+        }
+        returnVal.emplace_back(std::make_pair(stream->GetChannelId(), stream->GetStreamId()),
+            stats.Value);
+    }
+    return returnVal;
+}
+
 Result<FtlStreamStats> FtlServer::GetStats(ftl_channel_id_t channelId,
     ftl_stream_id_t streamId)
 {
@@ -226,6 +437,11 @@ Result<FtlStreamStats> FtlServer::GetStats(ftl_channel_id_t channelId,
     }
     return Result<FtlStreamStats>::Error("Stream does not exist.");
 }
+
+TaskExecutor::Stats FtlServer::GetAsyncCallStats()
+{
+    return asyncCallExecutor.GetStats();
+}
 #pragma endregion Public functions
 
 #pragma region Private functions
@@ -234,10 +450,16 @@ void FtlServer::ingestThreadBody(std::promise<void>&& readyPromise)
     ingestControlListener->Listen(std::move(readyPromise));
 }
 
-void FtlServer::eventQueueThreadBody()
+void FtlServer::eventQueueThreadBody(std::stop_token stopToken)
 {
     spdlog::debug("FtlServer::eventQueueThreadBody starting event queue...");
-    const std::stop_token stopToken = eventQueueThread.get_stop_token();
+
+    // Post an empty event to wake us up when we're asked to stop
+    std::stop_callback wakeOnStop(stopToken,
+        [this]()
+        {
+            eventQueue.enqueue(FtlServerEventKind::Unknown, nullptr);
+        });
 
     // Process event queue until we're asked to stop
     spdlog::debug("FtlServer::eventQueueThreadBody waiting for events...");
@@ -247,55 +469,66 @@ void FtlServer::eventQueueThreadBody()
         {
             break;
         }
-        eventQueue.waitFor(EVENT_QUEUE_WAIT_TIME);
-        eventQueue.process();
 
-        // Close any pending control connections that have taken too long to start
-        for (auto it = pendingControlConnections.begin(); it != pendingControlConnections.end();)
+        // Events are handled as soon as they're posted. Otherwise we only need to wake up when
+        // a pending control connection's authentication deadline passes.
+        if (std::optional<std::chrono::steady_clock::time_point> nextDeadline =
+            controlConnectionAuthDeadlines.GetNextDeadline())
         {
-            if ((std::chrono::steady_clock::now() - it->second.second) > CONNECTION_AUTH_TIMEOUT)
-            {
-                // Keep a reference alive until we've finished stopping the connection
-                std::shared_ptr<FtlControlConnection> expiredControlConnection = 
-                    std::move(it->second.first);
-                std::string addrString = expiredControlConnection->GetAddr().has_value() ?
-                    Util::AddrToString(expiredControlConnection->GetAddr().value().sin_addr) :
-                        "UNKNOWN";
-                spdlog::info("{} didn't authenticate within {}ms, closing", addrString,
-                    std::chrono::duration_cast<std::chrono::milliseconds>(
-                        CONNECTION_AUTH_TIMEOUT).count());
-                it = pendingControlConnections.erase(it);
-                dispatchAsyncCall(
-                    [connection = std::move(expiredControlConnection)]() mutable
-                    {
-                        connection->TerminateWithResponse();
-                    });
-            }
-            else
-            {
-                ++it;
-            }
+            eventQueue.waitFor(std::max(std::chrono::steady_clock::duration::zero(),
+                nextDeadline.value() - std::chrono::steady_clock::now()));
         }
+        else
+        {
+            eventQueue.wait();
+        }
+        eventQueue.process();
+
+        closeUnauthenticatedControlConnections();
+    }
+}
 
-        // Clean up references to old finished threads
-        for (auto i = asyncProcessingThreads.begin(); i != asyncProcessingThreads.end();)
+void FtlServer::closeUnauthenticatedControlConnections()
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (FtlControlConnection* connection : controlConnectionAuthDeadlines.PopExpired(now))
+    {
+        // Connections that have since authenticated or closed are no longer pending. A new
+        // connection may also have been allocated at the same address, so check its own time.
+        auto it = pendingControlConnections.find(connection);
+        if ((it == pendingControlConnections.end()) ||
+            ((now - it->second.second) < CONNECTION_AUTH_TIMEOUT))
         {
-            auto status = i->second.wait_for(std::chrono::milliseconds(0));
-            if (status == std::future_status::ready)
-            {
-                i = asyncProcessingThreads.erase(i);
-            }
-            else
-            {
-                ++i;
-            }
+            continue;
         }
+
+        // Keep a reference alive until we've finished stopping the connection
+        std::shared_ptr<FtlControlConnection> expiredControlConnection = 
+            std::move(it->second.first);
+        std::string addrString = expiredControlConnection->GetAddr().has_value() ?
+            Util::AddrToString(expiredControlConnection->GetAddr().value().sin_addr) :
+                "UNKNOWN";
+        spdlog::info("{} didn't authenticate within {}ms, closing", addrString,
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                CONNECTION_AUTH_TIMEOUT).count());
+        pendingControlConnections.erase(it);
+        dispatchAsyncCall(
+            [connection = std::move(expiredControlConnection)]() mutable
+            {
+                connection->TerminateWithResponse();
+            });
     }
 }
 
 Result<uint16_t> FtlServer::reserveMediaPort(
     const std::unique_lock<std::shared_mutex>& dataLock)
 {
+    // All streams can use the same port when media connections share one
+    if (std::optional<uint16_t> sharedPort = mediaConnectionCreator->GetSharedPort())
+    {
+        return Result<uint16_t>::Success(sharedPort.value());
+    }
+
     for (uint16_t i = minMediaPort; i <= maxMediaPort; ++i)
     {
         if (usedMediaPorts.count(i) <= 0)
@@ -322,6 +555,34 @@ void FtlServer::removeStreamRecord(FtlStream* stream,
     activeStreams.erase(stream);
 }
 
+FtlMediaConnection::CpuPlacement FtlServer::streamPlacement(
+    const std::shared_ptr<RtpPacketSink>& packetSink) const
+{
+    // Read the stream on the same NUMA node its packets will be sent out from
+    FtlMediaConnection::CpuPlacement placement = mediaPlacement;
+    placement.NumaNode = packetSink->GetNumaNode();
+    placement.OnNumaNodeChanged =
+        [packetSink](int numaNode)
+        {
+            packetSink->SetNumaNode(numaNode);
+        };
+    return placement;
+}
+
+FtlMediaConnection::BitrateLimit FtlServer::streamBitrateLimit(ftl_channel_id_t channelId,
+    ftl_stream_id_t streamId)
+{
+    // Streams that keep going over their bitrate limit are stopped right away, rather than on
+    // the next metadata report
+    FtlMediaConnection::BitrateLimit bitrateLimit = mediaBitrateLimit;
+    bitrateLimit.OnExceeded =
+        [this, channelId, streamId]()
+        {
+            StopStream(channelId, streamId, true);
+        };
+    return bitrateLimit;
+}
+
 void FtlServer::onNewControlConnection(std::unique_ptr<ConnectionTransport>&& connection)
 {
     spdlog::debug("FtlServer::onNewControlConnection queueing NewControlConnection event");
@@ -362,6 +623,10 @@ void FtlServer::eventStopStream(std::shared_ptr<FtlServerStopStreamEvent> event)
                 {
                     streamRef->RequestStop();
                 });
+            if (event->DispatchStreamEnded)
+            {
+                dispatchOnStreamEnded(event->ChannelId, event->StreamId);
+            }
             streamFound = true;
             break;
         }
@@ -380,11 +645,13 @@ void FtlServer::eventNewControlConnection(std::shared_ptr<FtlServerNewControlCon
     std::string addrString = connection->GetAddr().has_value() ? 
         Util::AddrToString(connection->GetAddr().value().sin_addr) : "UNKNOWN";
     auto ingestControlConnection = std::make_shared<FtlControlConnection>(this,
-        std::move(connection));
+        std::move(connection), connectionReactor);
+    const auto now = std::chrono::steady_clock::now();
+    controlConnectionAuthDeadlines.Push(now + CONNECTION_AUTH_TIMEOUT,
+        ingestControlConnection.get());
     pendingControlConnections.emplace(std::piecewise_construct,
         std::forward_as_tuple(ingestControlConnection.get()),
-        std::forward_as_tuple(std::move(ingestControlConnection),
-            std::chrono::steady_clock::now()));
+        std::forward_as_tuple(std::move(ingestControlConnection), now));
     spdlog::info("New FTL control connection is pending from {}", addrString);
 }
 
@@ -478,8 +745,8 @@ void FtlServer::eventControlRequestMediaPort(
     spdlog::debug(
         "FtlServer::eventControlRequestMediaPort processing ControlRequestMediaPort event...");
 
-    // Spin up a new processing thread to handle the response from the onStreamStarted callback
-    // so we don't hold up our own event queue.
+    // Handle the response from the onStreamStarted callback on a worker so we don't hold up
+    // our own event queue.
     dispatchAsyncCall(
         [this, event]()
         {
@@ -566,23 +833,53 @@ void FtlServer::eventStreamIdAssigned(std::shared_ptr<FtlServerStreamIdAssignedE
     dispatchAsyncCall(
         [this, event, control = std::move(control), mediaPort, rtpPacketSink]() mutable
         {
-            std::unique_ptr<ConnectionTransport> mediaTransport = 
-                mediaConnectionCreator->CreateConnection(mediaPort, event->TargetAddr);
+            const std::array<uint32_t, 2> ssrcs {
+                event->Metadata.AudioSsrc,
+                event->Metadata.VideoSsrc,
+            };
+            std::unique_ptr<ConnectionTransport> mediaTransport;
+            try
+            {
+                mediaTransport =
+                    mediaConnectionCreator->CreateConnection(mediaPort, event->TargetAddr, ssrcs);
+            }
+            catch (const std::exception& e)
+            {
+                spdlog::error("Couldn't receive media for Channel {} / Stream {} on port {}: {}",
+                    event->ChannelId, event->StreamId, mediaPort, e.what());
+                eventQueue.enqueue(FtlServerEventKind::StreamStartFailed,
+                    std::shared_ptr<FtlServerStreamStartFailedEvent>(
+                        new FtlServerStreamStartFailedEvent
+                        {
+                            .FailureResult = Result<void>::Error(e.what()),
+                            .ChannelId = event->ChannelId,
+                            .StreamId = event->StreamId,
+                            .MediaPort = mediaPort,
+                            .TargetAddr = event->TargetAddr,
+                        }));
+                return;
+            }
             auto stream = std::make_shared<FtlStream>(
                 std::move(control),
                 event->StreamId,
                 std::bind(&FtlServer::onStreamClosed, this, std::placeholders::_1),
                 rollingSizeAvgMs,
-                nackLostPackets);
+                nackLostPackets,
+                maxStreamMemoryBytes,
+                mediaReorderDelay,
+                connectionReactor,
+                metrics);
 
             Result<void> streamStartResult = stream->StartMediaConnection(
                 std::move(mediaTransport),
                 mediaPort,
                 event->Metadata,
-                [rtpPacketSink](const std::vector<std::byte> packet)
+                [rtpPacketSink](const PacketBuffer& packet)
                 {
                     rtpPacketSink->SendRtpPacket(packet);
-                });
+                },
+                streamPlacement(rtpPacketSink),
+                streamBitrateLimit(event->ChannelId, event->StreamId));
             if (streamStartResult.IsError)
             {
                 // Here, we purposefully drop the FtlStream reference since we're done using it.
@@ -641,7 +938,7 @@ void FtlServer::eventStreamStarted(std::shared_ptr<FtlServerStreamStartedEvent>
     spdlog::debug("FtlServer::eventStreamStarted processing StreamStarted event...");
     activeStreams.try_emplace(event->Stream.get(), event->Stream, event->MediaPort);
     spdlog::info("{} FtlStream started streaming Channel {} / Stream {} on port {}", 
-        Util::AddrToString(event->TargetAddr), event->ChannelId, event->StreamId, event->MediaPort);
+        event->TargetAddr.ToString(), event->ChannelId, event->StreamId, event->MediaPort);
 }
 
 void FtlServer::eventStreamStartFailed(std::shared_ptr<FtlServerStreamStartFailedEvent> event)
@@ -680,7 +977,7 @@ void FtlServer::eventStreamClosed(std::shared_ptr<FtlServerStreamClosedEvent> ev
 
 void FtlServer::dispatchOnStreamEnded(ftl_channel_id_t channelId, ftl_stream_id_t streamId)
 {
-    // Dispatch call to onStreamEnded on a separate thread to avoid blocking our event queue
+    // Dispatch call to onStreamEnded on a worker to avoid blocking our event queue
     dispatchAsyncCall([this, channelId, streamId]()
         {
             onStreamEnded(channelId, streamId);
@@ -9,11 +9,16 @@
 
 #include "FtlControlConnectionManager.h"
 #include "FtlControlConnection.h"
+#include "FtlHandoff.h"
 #include "FtlStream.h"
 #include "RtpPacketSink.h"
+#include "Utilities/DeadlineQueue.h"
 #include "Utilities/FtlTypes.h"
+#include "Utilities/IpAddress.h"
 #include "Utilities/Result.h"
+#include "Utilities/TaskExecutor.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <eventpp/eventqueue.h>
 #include <eventpp/utilities/argumentadapter.h>
@@ -23,6 +28,7 @@
 #include <memory>
 #include <netinet/in.h>
 #include <shared_mutex>
+#include <stop_token>
 #include <unordered_set>
 #include <unordered_map>
 #include <thread>
@@ -31,6 +37,7 @@
 class ConnectionCreator;
 class ConnectionListener;
 class ConnectionTransport;
+class EpollReactor;
 
 /**
  * @brief FtlServer manages ingest control and media connections, exposing the relevant stream
@@ -60,6 +67,13 @@ public:
         StreamEndedCallback onStreamEnded,
         uint32_t rollingSizeAvgMs,
         bool nackLostPackets,
+        size_t maxStreamMemoryBytes,
+        std::chrono::milliseconds mediaReorderDelay,
+        std::shared_ptr<EpollReactor> connectionReactor,
+        FtlMediaConnection::CpuPlacement mediaPlacement = {},
+        FtlMediaConnection::BitrateLimit mediaBitrateLimit = {},
+        std::shared_ptr<MetricsRegistry> metrics = nullptr,
+        size_t asyncWorkerThreads = DEFAULT_ASYNC_WORKER_THREADS,
         uint16_t minMediaPort = DEFAULT_MEDIA_MIN_PORT,
         uint16_t maxMediaPort = DEFAULT_MEDIA_MAX_PORT);
     ~FtlServer() = default;
@@ -80,27 +94,66 @@ public:
     void ControlConnectionRequestedHmacKey(FtlControlConnection* connection,
         ftl_channel_id_t channelId) override;
     void ControlConnectionRequestedMediaPort(FtlControlConnection* connection,
-        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, in_addr targetAddr) override;
+        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, IpAddress targetAddr) override;
 
     /**
      * @brief Stops the stream with the specified channel ID and stream ID.
-     * This will not fire the StreamEnded callback.
+     * This will not fire the StreamEnded callback unless dispatchStreamEnded is set, in which
+     * case it's only fired if the stream hadn't already been stopped.
      */
-    void StopStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId);
+    void StopStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId,
+        bool dispatchStreamEnded = false);
+
+    /**
+     * @brief
+     *  Stops accepting control connections, handing the control listen sockets and any shared
+     *  media sockets to another process that carries on ingesting. Nothing is stopped if the
+     *  listen sockets can't be handed off. The caller owns the handles in the returned handoff.
+     */
+    Result<FtlHandoff> HandOffSockets();
+
+    /**
+     * @brief
+     *  Hands each active stream's connections and state to another process, one by one.
+     *  Handed off streams are removed without firing the StreamEnded callback, and the
+     *  callback given owns the handles of each. Streams that haven't finished starting are
+     *  left to carry on here, and those that can't be handed off are stopped.
+     */
+    void HandOffStreams(const std::function<void(FtlStreamHandoff&)>& onStreamHandedOff);
+
+    /**
+     * @brief
+     *  Carries on with a stream handed over by another process, taking ownership of its
+     *  handles. Its media is sent to the given sink, just like a stream started by the
+     *  StreamStarted callback.
+     */
+    Result<void> AdoptStream(FtlStreamHandoff& handoff, std::shared_ptr<RtpPacketSink> packetSink);
 
     /**
      * @brief Retrieves stats for all active streams
      */
     std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>,
-        std::pair<FtlStreamStats, FtlKeyframe>>>
+        std::pair<FtlStreamStats, std::shared_ptr<const FtlKeyframe>>>>
         GetAllStatsAndKeyframes();
 
+    /**
+     * @brief Retrieves stats for all active streams, without their keyframes
+     */
+    std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>, FtlStreamStats>>
+        GetAllStats();
+
     /**
      * @brief Retrieves stats for the given stream
      */
     Result<FtlStreamStats> GetStats(ftl_channel_id_t channelId,
         ftl_stream_id_t streamId);
 
+    /**
+     * @brief Retrieves queue depth and latency of the workers that run callbacks and other
+     * calls that would otherwise block the event queue
+     */
+    TaskExecutor::Stats GetAsyncCallStats();
+
 private:
     /* Private types */
     struct FtlStreamRecord
@@ -133,6 +186,7 @@ private:
     {
         ftl_channel_id_t ChannelId;
         ftl_stream_id_t StreamId;
+        bool DispatchStreamEnded;
     };
     struct FtlServerNewControlConnectionEvent : public FtlServerEvent
     {
@@ -157,7 +211,7 @@ private:
         FtlControlConnection* Connection;
         ftl_channel_id_t ChannelId;
         MediaMetadata Metadata;
-        in_addr TargetAddr;
+        IpAddress TargetAddr;
     };
     struct FtlServerTerminateControlConnectionEvent : public FtlServerEvent
     {
@@ -170,7 +224,7 @@ private:
         ftl_channel_id_t ChannelId;
         ftl_stream_id_t StreamId;
         MediaMetadata Metadata;
-        in_addr TargetAddr;
+        IpAddress TargetAddr;
         std::shared_ptr<RtpPacketSink> PacketSink;
     };
     struct FtlServerStreamStartedEvent : public FtlServerEvent
@@ -179,7 +233,7 @@ private:
         ftl_channel_id_t ChannelId;
         ftl_stream_id_t StreamId;
         uint16_t MediaPort;
-        in_addr TargetAddr;
+        IpAddress TargetAddr;
     };
     struct FtlServerStreamStartFailedEvent : public FtlServerEvent
     {
@@ -187,7 +241,7 @@ private:
         ftl_channel_id_t ChannelId;
         ftl_stream_id_t StreamId;
         uint16_t MediaPort;
-        in_addr TargetAddr;
+        IpAddress TargetAddr;
     };
     struct FtlServerStreamClosedEvent : public FtlServerEvent
     {
@@ -197,10 +251,9 @@ private:
     /* Constants */
     static constexpr uint16_t DEFAULT_MEDIA_MIN_PORT = 9000;
     static constexpr uint16_t DEFAULT_MEDIA_MAX_PORT = 10000;
+    static constexpr size_t DEFAULT_ASYNC_WORKER_THREADS = 8;
     static constexpr std::chrono::milliseconds CONNECTION_AUTH_TIMEOUT
         = std::chrono::milliseconds(5000);
-    static constexpr std::chrono::milliseconds EVENT_QUEUE_WAIT_TIME
-        = std::chrono::milliseconds(32);
 
     /* Private fields */
     // Connection managers
@@ -217,10 +270,24 @@ private:
     uint32_t rollingSizeAvgMs;
     // Feature toggles
     bool nackLostPackets;
-    // Event queue
-    const std::jthread eventQueueThread;
+    size_t maxStreamMemoryBytes;
+    // Most time media packets are held to be fanned out in order, or 0 to not hold them
+    const std::chrono::milliseconds mediaReorderDelay;
+    // Shared reactor for reading connections, or null to read each from its own thread
+    const std::shared_ptr<EpollReactor> connectionReactor;
+    // Where media connections are read, before each stream's NUMA node is filled in
+    const FtlMediaConnection::CpuPlacement mediaPlacement;
+    const FtlMediaConnection::BitrateLimit mediaBitrateLimit;
+    // Where streams record packet latencies, or null if metrics aren't being served
+    const std::shared_ptr<MetricsRegistry> metrics;
+    // Event queue, declared before the executor and thread that use it so it outlives them
     eventpp::EventQueue<FtlServerEventKind, void (std::shared_ptr<FtlServerEvent>)> eventQueue;
-    std::list<std::pair<std::jthread, std::future<void>>> asyncProcessingThreads;
+    // Runs calls that would block the event queue
+    TaskExecutor asyncCallExecutor;
+    // When each pending control connection must have authenticated by, only used by the
+    // event queue thread
+    DeadlineQueue<FtlControlConnection*> controlConnectionAuthDeadlines;
+    const std::jthread eventQueueThread;
     // Misc fields
     bool isStopping { false };
     std::mutex stoppingMutex;
@@ -236,14 +303,19 @@ private:
 
     /* Private functions */
     void ingestThreadBody(std::promise<void>&& readyPromise);
-    void eventQueueThreadBody();
+    void eventQueueThreadBody(std::stop_token stopToken);
+    void closeUnauthenticatedControlConnections();
     Result<uint16_t> reserveMediaPort(const std::unique_lock<std::shared_mutex>& dataLock);
     void removeStreamRecord(FtlStream* stream, const std::unique_lock<std::shared_mutex>& dataLock);
+    FtlMediaConnection::CpuPlacement streamPlacement(
+        const std::shared_ptr<RtpPacketSink>& packetSink) const;
+    FtlMediaConnection::BitrateLimit streamBitrateLimit(ftl_channel_id_t channelId,
+        ftl_stream_id_t streamId);
     // Callback handlers
     void onNewControlConnection(std::unique_ptr<ConnectionTransport>&& connection);
     void onStreamClosed(FtlStream* stream);
     void onStreamRtpPacket(ftl_channel_id_t channelId, ftl_stream_id_t streamId,
-        const std::vector<std::byte>& packet);
+        const PacketBuffer& packet);
     // Event queue listeners
     void eventStopStream(std::shared_ptr<FtlServerStopStreamEvent> event);
     void eventNewControlConnection(std::shared_ptr<FtlServerNewControlConnectionEvent> event);
@@ -264,18 +336,13 @@ private:
     template<typename Callable>
     void dispatchAsyncCall(Callable call)
     {
-        // Dispatch this call on a separate thread, but keep track of the thread so
-        // we can properly join it when it has finished (or we're being destructed)
-        std::promise<void> threadPromise;
-        std::future<void> threadFuture = threadPromise.get_future();
-        asyncProcessingThreads.emplace_back(
-            std::piecewise_construct,
-            std::forward_as_tuple(
-                [call = std::move(call), threadPromise = std::move(threadPromise)]() mutable
-                {
-                    call();
-                    threadPromise.set_value();
-                }),
-            std::forward_as_tuple(std::move(threadFuture)));
+        // Run this call on one of our workers so it doesn't hold up the event queue. Results are
+        // posted back to the event queue by the call itself. std::function needs to be
+        // copyable, so calls that capture move-only state are shared instead.
+        asyncCallExecutor.Submit(
+            [call = std::make_shared<Callable>(std::move(call))]() mutable
+            {
+                (*call)();
+            });
     }
 };
\ No newline at end of file
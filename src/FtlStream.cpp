@@ -9,6 +9,7 @@
 
 #include "ConnectionTransports/ConnectionTransport.h"
 #include "FtlControlConnection.h"
+#include "FtlHandoff.h"
 #include "Rtp/RtpPacket.h"
 
 #include <assert.h>
@@ -26,13 +27,21 @@ FtlStream::FtlStream(
     const ftl_stream_id_t streamId,
     const ClosedCallback onClosed,
     const uint32_t rollingSizeAvgMs,
-    const bool nackLostPackets)
+    const bool nackLostPackets,
+    const size_t maxMemoryBytes,
+    const std::chrono::milliseconds reorderDelay,
+    const std::shared_ptr<EpollReactor> reactor,
+    const std::shared_ptr<MetricsRegistry> metrics)
 :
     controlConnection(std::move(controlConnection)),
     streamId(streamId),
     onClosed(onClosed),
     rollingSizeAvgMs(rollingSizeAvgMs),
-    nackLostPackets(nackLostPackets)
+    nackLostPackets(nackLostPackets),
+    maxMemoryBytes(maxMemoryBytes),
+    reorderDelay(reorderDelay),
+    reactor(reactor),
+    metrics(metrics)
 {
     // Bind to FtlStream
     this->controlConnection->SetFtlStream(this);
@@ -44,32 +53,76 @@ Result<void> FtlStream::StartMediaConnection(
         std::unique_ptr<ConnectionTransport> mediaTransport,
         const uint16_t mediaPort,
         const MediaMetadata mediaMetadata,
-        const FtlMediaConnection::RtpPacketCallback onRtpPacket)
+        const FtlMediaConnection::RtpPacketCallback onRtpPacket,
+        const FtlMediaConnection::CpuPlacement placement,
+        const FtlMediaConnection::BitrateLimit bitrateLimit)
 {
     std::scoped_lock lock(mutex);
 
-    if (mediaConnection)
+    Result<void> startResult = startMediaConnection(std::move(mediaTransport), mediaMetadata,
+        onRtpPacket, placement, bitrateLimit, {}, lock);
+    if (startResult.IsError)
     {
-        return Result<void>::Error("Media connection already started");
+        return startResult;
     }
 
-    mediaConnection = std::make_unique<FtlMediaConnection>(
-        std::move(mediaTransport),
-        mediaMetadata,
-        GetChannelId(),
-        GetStreamId(),
-        std::bind(&FtlStream::onMediaConnectionClosed, this),
-        onRtpPacket,
-        rollingSizeAvgMs,
-        nackLostPackets
-    );
-
     // Send media port to control connection
     controlConnection->StartMediaPort(mediaPort);
 
     return Result<void>::Success();
 }
 
+Result<void> FtlStream::ResumeMediaConnection(
+    std::unique_ptr<ConnectionTransport> mediaTransport,
+    const FtlStreamHandoff& handoff,
+    const FtlMediaConnection::RtpPacketCallback onRtpPacket,
+    const FtlMediaConnection::CpuPlacement placement,
+    const FtlMediaConnection::BitrateLimit bitrateLimit)
+{
+    std::scoped_lock lock(mutex);
+    return startMediaConnection(std::move(mediaTransport), handoff.Metadata, onRtpPacket,
+        placement, bitrateLimit, handoff.Sequences, lock);
+}
+
+Result<void> FtlStream::HandOff(FtlStreamHandoff& handoff)
+{
+    {
+        std::scoped_lock lock(mutex);
+        if (closed)
+        {
+            return Result<void>::Error("Stream has already stopped");
+        }
+        if (!mediaConnection)
+        {
+            return Result<void>::Error("Stream media connection has not been started");
+        }
+        // Nothing else can stop us while we're handing off
+        closed = true;
+    }
+
+    // We can't hold our lock while the connections stop reading, since they take it when they
+    // close on their own
+    handoff.StreamId = streamId;
+    Result<void> handoffResult = mediaConnection->HandOff(handoff);
+    if (!handoffResult.IsError)
+    {
+        handoffResult = controlConnection->HandOff(handoff);
+    }
+    if (handoffResult.IsError)
+    {
+        FtlHandoffProtocol::CloseHandles(handoff);
+        {
+            std::scoped_lock lock(mutex);
+            closed = false;
+        }
+        RequestStop();
+        return handoffResult;
+    }
+
+    spdlog::info("Handed off FTL channel {} / stream {}", handoff.ChannelId, streamId);
+    return Result<void>::Success();
+}
+
 void FtlStream::RequestStop()
 {
     std::scoped_lock lock(mutex);
@@ -135,7 +188,7 @@ Result<FtlStreamStats> FtlStream::GetStats()
     }
 }
 
-Result<FtlKeyframe> FtlStream::GetKeyframe()
+Result<std::shared_ptr<const FtlKeyframe>> FtlStream::GetKeyframe()
 {
     std::scoped_lock lock(mutex);
     
@@ -145,12 +198,55 @@ Result<FtlKeyframe> FtlStream::GetKeyframe()
     }
     else
     {
-        return Result<FtlKeyframe>::Error("Stream media connection has not been started");
+        return Result<std::shared_ptr<const FtlKeyframe>>::Error(
+            "Stream media connection has not been started");
     }
 }
 #pragma endregion
 
 #pragma region Private methods
+Result<void> FtlStream::startMediaConnection(
+    std::unique_ptr<ConnectionTransport> mediaTransport,
+    const MediaMetadata& mediaMetadata,
+    const FtlMediaConnection::RtpPacketCallback& onRtpPacket,
+    const FtlMediaConnection::CpuPlacement& placement,
+    const FtlMediaConnection::BitrateLimit& bitrateLimit,
+    std::span<const FtlSsrcSequenceHandoff> resumeSequences,
+    const std::scoped_lock<std::mutex>& lock)
+{
+    if (mediaConnection)
+    {
+        return Result<void>::Error("Media connection already started");
+    }
+
+    mediaConnection = std::make_unique<FtlMediaConnection>(
+        std::move(mediaTransport),
+        mediaMetadata,
+        GetChannelId(),
+        GetStreamId(),
+        std::bind(&FtlStream::onMediaConnectionClosed, this),
+        onRtpPacket,
+        rollingSizeAvgMs,
+        nackLostPackets,
+        reactor,
+        metrics,
+        maxMemoryBytes,
+        placement,
+        bitrateLimit,
+        reorderDelay,
+        resumeSequences
+    );
+    // By now the control connection has been around long enough to have a fair idea of the
+    // round trip, which NACKs are timed by until they can time it themselves
+    if (std::optional<std::chrono::microseconds> controlRtt =
+        controlConnection->GetRoundTripTime())
+    {
+        mediaConnection->SeedRoundTripTime(controlRtt.value());
+    }
+
+    return Result<void>::Success();
+}
+
 void FtlStream::onMediaConnectionClosed()
 {
     {
@@ -26,6 +26,7 @@
 
 class ConnectionTransport;
 class FtlControlConnection;
+struct FtlStreamHandoff;
 
 /**
  * @brief Manages the FTL media stream, accepting incoming RTP packets.
@@ -42,15 +43,39 @@ public:
         const ftl_stream_id_t streamId,
         const ClosedCallback onClosed,
         const uint32_t rollingSizeAvgMs,
-        const bool nackLostPackets);
+        const bool nackLostPackets,
+        const size_t maxMemoryBytes,
+        const std::chrono::milliseconds reorderDelay,
+        const std::shared_ptr<EpollReactor> reactor = nullptr,
+        const std::shared_ptr<MetricsRegistry> metrics = nullptr);
 
     /* Public methods */
     Result<void> StartMediaConnection(
         std::unique_ptr<ConnectionTransport> mediaTransport,
         const uint16_t mediaPort,
         const MediaMetadata mediaMetadata,
-        const FtlMediaConnection::RtpPacketCallback onRtpPacket
+        const FtlMediaConnection::RtpPacketCallback onRtpPacket,
+        const FtlMediaConnection::CpuPlacement placement = {},
+        const FtlMediaConnection::BitrateLimit bitrateLimit = {}
     );
+    /**
+     * @brief
+     *  Carries on receiving media for a stream handed over by another process, which has
+     *  already told the client which port to send it to
+     */
+    Result<void> ResumeMediaConnection(
+        std::unique_ptr<ConnectionTransport> mediaTransport,
+        const FtlStreamHandoff& handoff,
+        const FtlMediaConnection::RtpPacketCallback onRtpPacket,
+        const FtlMediaConnection::CpuPlacement placement = {},
+        const FtlMediaConnection::BitrateLimit bitrateLimit = {});
+    /**
+     * @brief
+     *  Stops the stream without closing its connections or calling onClosed, filling in what
+     *  another process needs to carry on with it. If it can't be handed off, the stream is
+     *  stopped instead.
+     */
+    Result<void> HandOff(FtlStreamHandoff& handoff);
     void RequestStop();
     void ControlConnectionStopped(FtlControlConnection* controlConnection);
 
@@ -58,7 +83,7 @@ public:
     ftl_channel_id_t GetChannelId() const;
     ftl_stream_id_t GetStreamId() const;
     Result<FtlStreamStats> GetStats();
-    Result<FtlKeyframe> GetKeyframe();
+    Result<std::shared_ptr<const FtlKeyframe>> GetKeyframe();
 
 private:
     /* Private members */
@@ -68,10 +93,22 @@ private:
     const ClosedCallback onClosed;
     const uint32_t rollingSizeAvgMs;
     const bool nackLostPackets;
+    const size_t maxMemoryBytes;
+    const std::chrono::milliseconds reorderDelay;
+    const std::shared_ptr<EpollReactor> reactor;
+    const std::shared_ptr<MetricsRegistry> metrics;
     bool closed = false;
     std::mutex mutex;
 
     /* Private methods */
+    Result<void> startMediaConnection(
+        std::unique_ptr<ConnectionTransport> mediaTransport,
+        const MediaMetadata& mediaMetadata,
+        const FtlMediaConnection::RtpPacketCallback& onRtpPacket,
+        const FtlMediaConnection::CpuPlacement& placement,
+        const FtlMediaConnection::BitrateLimit& bitrateLimit,
+        std::span<const FtlSsrcSequenceHandoff> resumeSequences,
+        const std::scoped_lock<std::mutex>& lock);
     void onControlConnectionClosed();
     void onMediaConnectionClosed();
 };
\ No newline at end of file
@@ -10,8 +10,13 @@
 
 #include "Configuration.h"
 #include "ConnectionCreators/ConnectionCreator.h"
+#include "ConnectionCreators/SharedUdpConnectionCreator.h"
+#include "ConnectionCreators/UdpConnectionCreator.h"
+#include "ConnectionListeners/ConnectionAdmissionLimiter.h"
 #include "ConnectionListeners/ConnectionListener.h"
+#include "ConnectionListeners/TcpConnectionListener.h"
 #include "FtlClient.h"
+#include "FtlHandoff.h"
 #include "FtlServer.h"
 #include "JanusFtl.h"
 #include "VideoDecoders/H264VideoDecoder.h"
@@ -19,9 +24,17 @@
 #include "ServiceConnections/EdgeNodeServiceConnection.h"
 #include "ServiceConnections/GlimeshServiceConnection.h"
 #include "ServiceConnections/RestServiceConnection.h"
+#include "Utilities/CpuTopology.h"
+#include "Utilities/EpollReactor.h"
 #include "Utilities/JanssonPtr.h"
+#include "Utilities/PacketBuffer.h"
+#include "Utilities/UnixSocketHandoff.h"
+#include "VideoCodecTraits.h"
 
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
+#include <unistd.h>
 
 extern "C"
 {
@@ -52,13 +65,113 @@ JanusFtl::JanusFtl(
     maxAllowedBitsPerSecond = configuration->GetMaxAllowedBitsPerSecond();
     rollingSizeAvgMs = configuration->GetRollingSizeAvgMs();
     metadataReportInterval = configuration->GetServiceConnectionMetadataReportInterval();
+    thumbnailInterval = configuration->GetServiceConnectionThumbnailInterval();
+    metadataReportPolicy = std::make_unique<MetadataReportPolicy>(MetadataReportPolicy::Policy
+        {
+            .HeartbeatInterval = configuration->GetServiceConnectionMetadataHeartbeatInterval(),
+            .BitrateChangeThreshold =
+                (configuration->GetServiceConnectionMetadataBitrateChangePercent() / 100.0),
+        });
     watchdog = std::make_unique<Watchdog>(configuration->GetServiceConnectionMetadataReportInterval());
+    if (configuration->GetMetricsPort() != 0)
+    {
+        metrics = std::make_shared<MetricsRegistry>();
+    }
 
     initVideoDecoders();
 
-    initOrchestratorConnection();
-
     initServiceConnection();
+
+    // Otherwise we start taking connections straight away, and only streams wait on the
+    // service being ready
+    if (!configuration->IsBackgroundInitEnabled())
+    {
+        connectServices();
+    }
+
+    initEdgeRelaySubscriptions();
+
+    std::shared_ptr<EpollReactor> connectionReactor = nullptr;
+    if (configuration->IsConnectionReactorEnabled())
+    {
+        connectionReactor = std::make_shared<EpollReactor>(
+            configuration->GetConnectionReactorThreads(),
+            configuration->GetConnectionReactorCpus());
+    }
+
+    if (configuration->IsViewerFanoutEnabled())
+    {
+        viewerFanoutPool = std::make_shared<FanoutWorkerPool>(
+            configuration->GetViewerFanoutThreads(),
+            configuration->GetViewerFanoutCpus());
+    }
+
+    if (configuration->IsNumaStreamPlacementEnabled())
+    {
+        initStreamNumaNodes();
+    }
+
+    nodeLoadEstimator = std::make_unique<NodeLoadEstimator>(NodeCapacity
+        {
+            .MaxViewers = configuration->GetNodeMaxViewers(),
+            .MaxEgressBitsPerSecond = configuration->GetNodeMaxEgressBitsPerSecond(),
+            .MaxFanoutQueueDepth = (viewerFanoutPool != nullptr) ?
+                FanoutWorkerPool::MAX_QUEUED_PACKETS_PER_WORKER : 0,
+        });
+
+    initOverloadController();
+
+    // Take over from an instance that's already running, if there is one
+    int predecessorHandle = -1;
+    std::optional<FtlHandoff> handoff = receiveHandoffSockets(predecessorHandle);
+
+    if (handoff.has_value() || (configuration->GetControlListenSockets() > 1) ||
+        (configuration->GetControlAdmissionPerMinute() > 0) ||
+        !configuration->GetControlSocketBinding().IsDefault())
+    {
+        std::unique_ptr<ConnectionAdmissionLimiter> admissionLimiter = nullptr;
+        if (configuration->GetControlAdmissionPerMinute() > 0)
+        {
+            admissionLimiter = std::make_unique<ConnectionAdmissionLimiter>(
+                (configuration->GetControlAdmissionPerMinute() / 60.0),
+                configuration->GetControlAdmissionBurst());
+        }
+        ingestControlListener = std::make_unique<TcpConnectionListener>(
+            FtlClient::FTL_CONTROL_PORT, SOMAXCONN, configuration->GetControlListenSockets(),
+            std::move(admissionLimiter),
+            handoff.has_value() ? std::exchange(handoff->ControlListenHandles, {}) :
+                std::vector<int> {},
+            configuration->GetControlSocketBinding());
+    }
+
+    if ((configuration->GetMediaSharedPort() != 0) && handoff.has_value() &&
+        !handoff->MediaHandles.empty())
+    {
+        mediaConnectionCreator = std::make_unique<SharedUdpConnectionCreator>(
+            std::exchange(handoff->MediaHandles, {}));
+    }
+    else if (configuration->GetMediaSharedPort() != 0)
+    {
+        mediaConnectionCreator = std::make_unique<SharedUdpConnectionCreator>(
+            configuration->GetMediaSharedPort(), configuration->GetMediaSharedPortSockets(),
+            configuration->GetMediaSocketBinding());
+    }
+    if (handoff.has_value() && !handoff->MediaHandles.empty())
+    {
+        // Shared media sockets we've no use for, since we aren't configured with a shared port
+        spdlog::warn("Closing {} handed off media sockets, FTL_MEDIA_SHARED_PORT isn't set",
+            handoff->MediaHandles.size());
+        FtlHandoffProtocol::CloseHandles(handoff.value());
+    }
+    else if ((configuration->GetMediaSharedPort() == 0) &&
+        (configuration->IsMediaSourceFilterEnabled() ||
+            configuration->IsMediaIoUringEnabled() ||
+            !configuration->GetMediaSocketBinding().IsDefault()))
+    {
+        mediaConnectionCreator = std::make_unique<UdpConnectionCreator>(
+            configuration->IsMediaSourceFilterEnabled(), configuration->GetMediaSocketBinding(),
+            configuration->IsMediaIoUringEnabled());
+    }
     
     ftlServer = std::make_unique<FtlServer>(std::move(ingestControlListener),
         std::move(mediaConnectionCreator),
@@ -68,12 +181,43 @@ JanusFtl::JanusFtl(
         std::bind(&JanusFtl::ftlServerStreamEnded, this, std::placeholders::_1,
             std::placeholders::_2),
         configuration->GetRollingSizeAvgMs(),
-        configuration->IsNackLostPacketsEnabled());
+        configuration->IsNackLostPacketsEnabled(),
+        configuration->GetStreamMaxMemoryBytes(),
+        configuration->GetMediaReorderDelay(),
+        connectionReactor,
+        FtlMediaConnection::CpuPlacement
+        {
+            .ThreadCpus = configuration->GetMediaThreadCpus(),
+            .FollowRxCpu = configuration->IsMediaFollowRxCpuEnabled(),
+        },
+        FtlMediaConnection::BitrateLimit
+        {
+            .MaxBitsPerSecond = configuration->GetMaxAllowedBitsPerSecond(),
+            .BurstBytes = configuration->GetMaxAllowedBitrateBurstBytes(),
+            .MaxViolations = configuration->GetMaxAllowedBitrateViolations(),
+        },
+        metrics,
+        configuration->GetIngestCallbackThreads());
 
     ftlServer->StartAsync();
 
+    if (predecessorHandle >= 0)
+    {
+        adoptHandedOffStreams(predecessorHandle);
+    }
+
     initServiceReportThread();
 
+    initMetricsServer();
+
+    initHandoffListener();
+
+    if (configuration->IsBackgroundInitEnabled())
+    {
+        spdlog::info("FTL plugin initialized, connecting to services in the background...");
+        serviceInitThread = std::thread(&JanusFtl::connectServicesInBackground, this);
+        return;
+    }
     spdlog::info("FTL plugin initialized!");
     watchdog->Ready();
 }
@@ -86,7 +230,20 @@ JanusFtl::~JanusFtl()
         isStopping = true;
     }
     threadShutdownConditionVariable.notify_all();
+    if (serviceInitThread.joinable())
+    {
+        serviceInitThread.join();
+    }
     serviceReportThreadEndedFuture.wait();
+    if (overloadThread.joinable())
+    {
+        overloadThread.join();
+    }
+    if (handoffThread.joinable())
+    {
+        handoffThread.join();
+    }
+    stopMetricsServer();
     // TODO: Remove all mountpoints, kill threads, sessions, etc.
     ftlServer->Stop();
 }
@@ -95,21 +252,15 @@ JanusFtl::~JanusFtl()
 #pragma region Public plugin methods
 void JanusFtl::CreateSession(janus_plugin_session* handle, int* error)
 {
-    std::unique_lock lock(streamDataMutex);
-    auto session = std::make_unique<JanusSession>(handle, janusCore);
-    handle->plugin_handle = session.get();
-    sessions[handle] = ActiveSession
-    {
-        .WatchingChannelId = std::nullopt,
-        .Session = std::move(session),
-    };
+    auto activeSession = std::make_shared<ActiveSession>();
+    activeSession->Session = std::make_unique<JanusSession>(handle, janusCore);
+    handle->plugin_handle = activeSession->Session.get();
+    sessions.Insert(handle, std::move(activeSession));
 }
 
 struct janus_plugin_result* JanusFtl::HandleMessage(janus_plugin_session* handle, char* transaction,
     json_t* message, json_t* jsep)
 {
-    std::unique_lock lock(streamDataMutex);
-
     JsonPtr messagePtr(message);
     JsonPtr jsepPtr(jsep);
 
@@ -123,14 +274,16 @@ struct janus_plugin_result* JanusFtl::HandleMessage(janus_plugin_session* handle
     }
 
     // Look up the session
-    if (sessions.count(handle) <= 0)
+    std::shared_ptr<ActiveSession> activeSession = sessions.Find(handle);
+    if (activeSession == nullptr)
     {
         spdlog::error("No sessions associated with incoming handle");
         return generateMessageErrorResponse(
             FTL_PLUGIN_ERROR_UNKNOWN,
             "No sessions associated with this handle.");
     }
-    ActiveSession& session = sessions[handle];
+    std::unique_lock sessionLock(activeSession->Mutex);
+    ActiveSession& session = *activeSession;
 
     // Do we have a message?
     if (messagePtr.get() == nullptr)
@@ -172,23 +325,78 @@ struct janus_plugin_result* JanusFtl::HandleMessage(janus_plugin_session* handle
 
 json_t* JanusFtl::HandleAdminMessage(json_t* message)
 {
-    // TODO: Parse and handle the message.
-    return json_object();
+    // Janus keeps ownership of the message
+    if ((message == nullptr) || !json_is_object(message))
+    {
+        return generateAdminErrorResponse(FTL_PLUGIN_ERROR_INVALID_JSON,
+            "Error parsing JSON message.");
+    }
+    const char* requestText = json_string_value(json_object_get(message, "request"));
+    if (requestText == nullptr)
+    {
+        return generateAdminErrorResponse(FTL_PLUGIN_ERROR_MISSING_ELEMENT,
+            "Expected 'request' property.");
+    }
+
+    if (std::strcmp(requestText, "list_streams") == 0)
+    {
+        json_t* response = json_object();
+        json_object_set_new(response, "streams", describeStreams(std::nullopt));
+        json_object_set_new(response, "fanout_workers", describeFanoutWorkers());
+        return response;
+    }
+    else if (std::strcmp(requestText, "stream_info") == 0)
+    {
+        json_t* channelIdJs = json_object_get(message, "channel_id");
+        if ((channelIdJs == nullptr) || !json_is_integer(channelIdJs))
+        {
+            return generateAdminErrorResponse(FTL_PLUGIN_ERROR_MISSING_ELEMENT,
+                "Expected 'channel_id' property.");
+        }
+        JsonPtr streams(describeStreams(json_integer_value(channelIdJs)));
+        if (json_array_size(streams.get()) == 0)
+        {
+            return generateAdminErrorResponse(FTL_PLUGIN_ERROR_NO_SUCH_STREAM,
+                "No stream is active on that channel.");
+        }
+        return json_incref(json_array_get(streams.get(), 0));
+    }
+    else
+    {
+        spdlog::warn("Unknown admin request '{}'", requestText);
+        return generateAdminErrorResponse(FTL_PLUGIN_ERROR_INVALID_REQUEST, "Unknown request.");
+    }
 }
 
 void JanusFtl::SetupMedia(janus_plugin_session* handle)
 {
-    std::shared_lock lock(streamDataMutex);
     spdlog::info("SetupMedia");
 
-    if (sessions.count(handle) <= 0)
+    std::shared_ptr<ActiveSession> session = sessions.Find(handle);
+    if (session == nullptr)
     {
         spdlog::error("No session associated with this handle");
         return;
     }
-    ActiveSession& session = sessions[handle];
+    std::unique_lock sessionLock(session->Mutex);
 
-    session.Session->SetIsStarted(true);
+    session->Session->SetIsStarted(true);
+
+    // Start the viewer off with the latest keyframe so they aren't staring at a black screen
+    // until the next one comes along
+    if (session->WatchingChannelId.has_value())
+    {
+        std::shared_ptr<JanusStream> stream;
+        if (LockedChannel channel = lockChannel(session->WatchingChannelId.value(), false);
+            channel.State != nullptr)
+        {
+            stream = channel.State->Stream;
+        }
+        if (stream != nullptr)
+        {
+            stream->SendKeyframeBurst(session->Session.get());
+        }
+    }
 }
 
 void JanusFtl::IncomingRtp(janus_plugin_session* handle, janus_plugin_rtp* packet)
@@ -247,25 +455,30 @@ void JanusFtl::HangUpMedia(janus_plugin_session* handle)
 
 void JanusFtl::DestroySession(janus_plugin_session* handle, int* error)
 {
-    std::unique_lock lock(streamDataMutex);
-    if (sessions.count(handle) == 0)
+    std::shared_ptr<ActiveSession> session = sessions.Remove(handle);
+    if (session == nullptr)
     {
         spdlog::error("DestroySession: No session associated with this handle");
         *error = -2;
         return;
     }
 
-    ActiveSession& session = sessions[handle];
-    if (session.WatchingChannelId.has_value())
+    std::unique_lock sessionLock(session->Mutex);
+    if (session->WatchingChannelId.has_value())
     {
         bool orchestratorUnsubscribe = false;
-        ftl_channel_id_t channelId = session.WatchingChannelId.value();
+        ftl_channel_id_t channelId = session->WatchingChannelId.value();
+        LockedChannel channel = lockChannel(channelId, false);
+        if (channel.State == nullptr)
+        {
+            return;
+        }
 
         // If session is watching an active stream, remove it
-        if (streams.count(channelId) > 0)
+        if (channel.State->Stream != nullptr)
         {
-            std::shared_ptr<JanusStream>& watchingStream = streams[channelId];
-            watchingStream->RemoveViewerSession(session.Session.get());
+            const std::shared_ptr<JanusStream>& watchingStream = channel.State->Stream;
+            watchingStream->RemoveViewerSession(session->Session.get());
 
             // If we're an Edge node and there are no more viewers for this channel, we can
             // unsubscribe.
@@ -277,114 +490,133 @@ void JanusFtl::DestroySession(janus_plugin_session* handle, int* error)
         }
 
         // If session is pending on an inactive stream, remove it
-        if ((pendingViewerSessions.count(channelId) > 0) &&
-            (pendingViewerSessions[channelId].count(session.Session.get()) > 0))
+        if (channel.State->PendingViewerSessions.erase(session->Session.get()) > 0)
         {
-            pendingViewerSessions[channelId].erase(session.Session.get());
-
             // If this was the last pending viewer for this channel, unsubscribe.
-            if (pendingViewerSessions[channelId].size() == 0)
+            if (channel.State->PendingViewerSessions.empty() &&
+                (configuration->GetNodeKind() == NodeKind::Edge))
             {
-                if (configuration->GetNodeKind() == NodeKind::Edge)
-                {
-                    orchestratorUnsubscribe = true;
-                }
-                pendingViewerSessions.erase(channelId);
+                orchestratorUnsubscribe = true;
             }
         }
 
-        // Unsubscribe for relays on this channel if this session was the last viewer
-        if (orchestratorUnsubscribe)
+        // Unsubscribe for relays on this channel if this session was the last viewer, unless
+        // we're keeping the relay around for a while. This is done under the channel lock so it
+        // can't be reordered with a new viewer's subscription.
+        std::vector<ftl_channel_id_t> evictedRelays;
+        if (orchestratorUnsubscribe && !prewarmChannelIds.contains(channelId))
         {
-            // Remove temporary stream key
-            const auto& edgeServiceConnection = 
-                std::dynamic_pointer_cast<EdgeNodeServiceConnection>(serviceConnection);
-            if (edgeServiceConnection == nullptr)
+            if (lingeringRelays == nullptr)
+            {
+                spdlog::info("Last viewer for channel {} has disconnected - unsubscribing...",
+                    channelId);
+                unsubscribeFromChannel(channelId);
+            }
+            else
             {
-                throw std::runtime_error(
-                    "Unexpected service connection type - expected EdgeNodeServiceConnection.");
+                spdlog::info("Last viewer for channel {} has disconnected - relay lingering...",
+                    channelId);
+                evictedRelays = lingeringRelays->Add(channelId,
+                    getRelayBitrate(channelId, *channel.State));
             }
-            edgeServiceConnection->ClearStreamKey(channelId);
+        }
 
-            spdlog::info("Last viewer for channel {} has disconnected - unsubscribing...",
-                channelId);
-            orchestrationClient->SendChannelSubscription(ConnectionSubscriptionPayload
-                {
-                    .IsSubscribe = false,
-                    .ChannelId = channelId,
-                });
+        channel.Lock.unlock();
+        retireChannelIfUnused(channelId);
+        for (const ftl_channel_id_t& evictedChannelId : evictedRelays)
+        {
+            unsubscribeIfUnused(evictedChannelId);
         }
     }
 
     // TODO: hang up media
-    sessions.erase(handle);
 }
 
 json_t* JanusFtl::QuerySession(janus_plugin_session* handle)
 {
-    // TODO
-    return json_object();
+    std::shared_ptr<ActiveSession> activeSession = sessions.Find(handle);
+    if (activeSession == nullptr)
+    {
+        return nullptr;
+    }
+    std::unique_lock sessionLock(activeSession->Mutex);
+    json_t* info = json_object();
+    json_object_set_new(info, "watching_channel_id",
+        activeSession->WatchingChannelId.has_value() ?
+            json_integer(activeSession->WatchingChannelId.value()) : json_null());
+    json_object_set_new(info, "started", json_boolean(activeSession->Session->GetIsStarted()));
+    json_object_set_new(info, "sdp_session_id",
+        json_integer(activeSession->Session->GetSdpSessionId()));
+    json_object_set_new(info, "sdp_version",
+        json_integer(activeSession->Session->GetSdpVersion()));
+    return info;
 }
 #pragma endregion
 
 #pragma region Private methods
 Result<std::vector<std::byte>> JanusFtl::ftlServerRequestKey(ftl_channel_id_t channelId)
 {
-    return serviceConnection->GetHmacKey(channelId);
+    Result<void> readyResult = awaitServiceReady();
+    if (readyResult.IsError)
+    {
+        return Result<std::vector<std::byte>>::Error(readyResult.ErrorMessage);
+    }
+    if (hmacKeyCache != nullptr)
+    {
+        return hmacKeyCache->GetHmacKey(channelId);
+    }
+    return asyncServiceConnection->GetHmacKey(channelId).get();
 }
 
 Result<FtlServer::StartedStreamInfo> JanusFtl::ftlServerStreamStarted(
     ftl_channel_id_t channelId,
     MediaMetadata mediaMetadata)
 {
-    std::unique_lock lock(streamDataMutex);
-
-    // Attempt to start the stream on the service connection
-    Result<ftl_stream_id_t> startResult = serviceConnection->StartStream(channelId);
+    // Attempt to start the stream on the service connection. This is a network round-trip
+    // (with retries), so it happens before taking the channel's lock to avoid stalling its
+    // viewers and the report thread behind it.
+    Result<void> readyResult = awaitServiceReady();
+    if (readyResult.IsError)
+    {
+        return Result<FtlServer::StartedStreamInfo>::Error(readyResult.ErrorMessage);
+    }
+    Result<ftl_stream_id_t> startResult = asyncServiceConnection->StartStream(channelId).get();
     if (startResult.IsError)
     {
         return Result<FtlServer::StartedStreamInfo>::Error(startResult.ErrorMessage);
     }
     ftl_stream_id_t streamId = startResult.Value;
+    auto stream = std::make_shared<JanusStream>(channelId, streamId, mediaMetadata,
+        viewerFanoutPool, configuration->IsRelayKeyframeBurstEnabled(),
+        configuration->IsRelayGroupEnabled(), configuration->GetRelayPacingInterval(), metrics,
+        nextStreamNumaNode(), startRecording(channelId, streamId, mediaMetadata),
+        overloadController);
+
+    LockedChannel channel = lockChannel(channelId, true);
 
     // Stop any existing streams on this channel
-    if (streams.count(channelId) > 0)
+    if (channel.State->Stream != nullptr)
     {
-        const auto& stream = streams.at(channelId);
+        ftl_stream_id_t existingStreamId = channel.State->Stream->GetStreamId();
         spdlog::info("Existing Stream {} exists for Channel {} - stopping...",
-            stream->GetStreamId(), channelId);
-        ftlServer->StopStream(stream->GetChannelId(), stream->GetStreamId());
-        endStream(stream->GetChannelId(), stream->GetStreamId(), lock);
+            existingStreamId, channelId);
+        ftlServer->StopStream(channelId, existingStreamId);
+        endStream(channelId, existingStreamId, *channel.State, channel.Lock);
     }
 
     // Insert new stream
-    auto stream = std::make_shared<JanusStream>(channelId, streamId, mediaMetadata);
-    streams[channelId] = stream;
+    channel.State->Stream = stream;
 
     // Move any pending viewer sessions over
-    if (pendingViewerSessions.count(channelId) > 0)
+    for (JanusSession* pendingSession : channel.State->PendingViewerSessions)
     {
-        for (const auto& pendingSession : pendingViewerSessions[channelId])
-        {
-            stream->AddViewerSession(pendingSession);
-            sendJsep(sessions[pendingSession->GetJanusPluginSessionHandle()], *stream, nullptr);
-        }
-        pendingViewerSessions.erase(channelId);
+        stream->AddViewerSession(pendingSession);
+        sendJsep(*pendingSession, *stream, nullptr);
     }
+    channel.State->PendingViewerSessions.clear();
     // TODO: Notify viewer sessions
 
-    // If we are configured as an Ingest node, notify the Orchestrator that a stream has started.
-    if ((configuration->GetNodeKind() == NodeKind::Ingest) && (orchestrationClient != nullptr))
-    {
-        spdlog::info("Publishing channel {} / stream {} to Orchestrator...", channelId,
-            streamId);
-        orchestrationClient->SendStreamPublish(ConnectionPublishPayload
-            {
-                .IsPublish = true,
-                .ChannelId = channelId,
-                .StreamId = streamId,
-            });
-    }
+    publishStream(channelId, streamId);
 
     spdlog::info("Registered new stream: Channel {} / Stream {}.", channelId, streamId);
 
@@ -396,14 +628,43 @@ Result<FtlServer::StartedStreamInfo> JanusFtl::ftlServerStreamStarted(
 
 void JanusFtl::ftlServerStreamEnded(ftl_channel_id_t channelId, ftl_stream_id_t streamId)
 {
-    std::unique_lock lock(streamDataMutex);
-    endStream(channelId, streamId, lock);
+    LockedChannel channel = lockChannel(channelId, false);
+    if (channel.State == nullptr)
+    {
+        spdlog::error("Received stream ended from unknown channel {} / stream {}", channelId,
+            streamId);
+        return;
+    }
+    endStream(channelId, streamId, *channel.State, channel.Lock);
+    channel.Lock.unlock();
+    retireChannelIfUnused(channelId);
 }
 
 void JanusFtl::initVideoDecoders()
 {
-    // H264
-    videoDecoders.try_emplace(VideoCodecKind::H264, std::make_unique<H264VideoDecoder>());
+    std::unordered_map<VideoCodecKind, ThumbnailWorkerPool::DecoderFactory> decoderFactories;
+    const VideoDecoder::JpegOptions jpegOptions
+    {
+        .MaxWidth = configuration->GetServiceThumbnailMaxWidth(),
+        .MaxHeight = configuration->GetServiceThumbnailMaxHeight(),
+        .Quality = configuration->GetServiceThumbnailQuality(),
+    };
+
+    const std::string hardwareDevice = configuration->GetServiceThumbnailHardwareDevice();
+
+    SupportedVideoCodecList::ForEach(
+        [&decoderFactories, &jpegOptions, &hardwareDevice](auto codecTag)
+        {
+            using Decoder = typename VideoCodecTraits<decltype(codecTag)::value>::Decoder;
+            decoderFactories.try_emplace(codecTag.value,
+                [jpegOptions, hardwareDevice]() -> std::unique_ptr<VideoDecoder>
+                {
+                    return std::make_unique<Decoder>(jpegOptions, hardwareDevice);
+                });
+        });
+
+    thumbnailPool = std::make_unique<ThumbnailWorkerPool>(std::move(decoderFactories),
+        configuration->GetServiceThumbnailThreads(), metrics);
 }
 
 void JanusFtl::initOrchestratorConnection()
@@ -482,7 +743,152 @@ void JanusFtl::initServiceConnection()
         }
     }
 
+    asyncServiceConnection = std::make_unique<AsyncServiceConnection>(serviceConnection,
+        configuration->GetServiceIoThreads(), metrics);
+
+    // Edge nodes provision and clear keys as relays come and go, so they can't be cached
+    if ((configuration->GetServiceHmacKeyCacheTtl() > std::chrono::milliseconds(0)) &&
+        (configuration->GetNodeKind() != NodeKind::Edge))
+    {
+        hmacKeyCache = std::make_unique<HmacKeyCache>(
+            [this](ftl_channel_id_t channelId)
+            {
+                return asyncServiceConnection->GetHmacKey(channelId).get();
+            },
+            configuration->GetServiceHmacKeyCacheTtl(),
+            configuration->GetServiceHmacKeyNegativeCacheTtl());
+    }
+}
+
+void JanusFtl::connectServices()
+{
+    initOrchestratorConnection();
+    {
+        std::lock_guard lock(orchestratorConnectMutex);
+        isOrchestratorConnected = true;
+        for (const auto& send : deferredOrchestratorMessages)
+        {
+            if (orchestrationClient != nullptr)
+            {
+                send(*orchestrationClient);
+            }
+        }
+        deferredOrchestratorMessages.clear();
+    }
+
     serviceConnection->Init();
+    serviceReadyPromise.set_value();
+}
+
+void JanusFtl::connectServicesInBackground()
+{
+    try
+    {
+        connectServices();
+    }
+    catch (const std::exception& e)
+    {
+        // Without telling the watchdog we're ready, it restarts us for another try
+        spdlog::critical("Couldn't connect to services, not accepting streams: {}", e.what());
+        serviceReadyPromise.set_exception(std::current_exception());
+        return;
+    }
+    spdlog::info("Connected to services, accepting streams");
+    watchdog->Ready();
+}
+
+Result<void> JanusFtl::awaitServiceReady()
+{
+    try
+    {
+        serviceReady.get();
+    }
+    catch (const std::exception& e)
+    {
+        return Result<void>::Error(
+            fmt::format("Service connection couldn't be started: {}", e.what()));
+    }
+    return Result<void>::Success();
+}
+
+void JanusFtl::sendToOrchestrator(std::function<void(FtlConnection&)> send)
+{
+    std::lock_guard lock(orchestratorConnectMutex);
+    if (!isOrchestratorConnected)
+    {
+        deferredOrchestratorMessages.push_back(std::move(send));
+        return;
+    }
+    if (orchestrationClient != nullptr)
+    {
+        send(*orchestrationClient);
+    }
+}
+
+void JanusFtl::initEdgeRelaySubscriptions()
+{
+    if (configuration->GetNodeKind() != NodeKind::Edge)
+    {
+        return;
+    }
+
+    if (configuration->GetEdgeRelayLingerTime().count() > 0)
+    {
+        lingeringRelays = std::make_unique<LingerList<ftl_channel_id_t>>(
+            configuration->GetEdgeRelayLingerTime(),
+            configuration->GetEdgeRelayLingerMaxBitsPerSecond());
+    }
+
+    for (const ftl_channel_id_t& channelId : configuration->GetEdgePrewarmChannelIds())
+    {
+        if (!prewarmChannelIds.insert(channelId).second)
+        {
+            continue;
+        }
+        spdlog::info("Prewarming channel {} - subscribing...", channelId);
+        {
+            LockedChannel channel = lockChannel(channelId, true);
+            subscribeToChannel(channelId);
+        }
+        retireChannelIfUnused(channelId);
+    }
+}
+
+void JanusFtl::initStreamNumaNodes()
+{
+    // Streams can only be kept on the nodes our pinned threads are on
+    std::vector<int> pinnedCpus = configuration->GetMediaThreadCpus();
+    if (configuration->IsConnectionReactorEnabled())
+    {
+        const std::vector<int> reactorCpus = configuration->GetConnectionReactorCpus();
+        pinnedCpus.insert(pinnedCpus.end(), reactorCpus.begin(), reactorCpus.end());
+    }
+    if (configuration->IsViewerFanoutEnabled())
+    {
+        const std::vector<int> fanoutCpus = configuration->GetViewerFanoutCpus();
+        pinnedCpus.insert(pinnedCpus.end(), fanoutCpus.begin(), fanoutCpus.end());
+    }
+
+    for (const int cpu : pinnedCpus)
+    {
+        const int numaNode = CpuTopology::GetNumaNode(cpu);
+        if ((numaNode != CpuTopology::UNKNOWN_NUMA_NODE) &&
+            (std::find(streamNumaNodes.begin(), streamNumaNodes.end(), numaNode) ==
+                streamNumaNodes.end()))
+        {
+            streamNumaNodes.push_back(numaNode);
+        }
+    }
+    std::sort(streamNumaNodes.begin(), streamNumaNodes.end());
+
+    if (streamNumaNodes.empty())
+    {
+        spdlog::warn("NUMA stream placement is enabled, but no reactor, fanout, or media "
+            "thread CPUs are configured - streams will not be placed");
+        return;
+    }
+    spdlog::info("Placing streams on NUMA nodes {}",
+        CpuTopology::FormatCpuList(streamNumaNodes));
 }
 
 void JanusFtl::initServiceReportThread()
@@ -496,62 +902,426 @@ void JanusFtl::initServiceReportThread()
     serviceReportThread.detach();
 }
 
-void JanusFtl::serviceReportThreadBody(std::promise<void>&& threadEndedPromise)
+void JanusFtl::initOverloadController()
 {
-    threadEndedPromise.set_value_at_thread_exit();
-    std::unique_lock lock(threadShutdownMutex);
-
-    while (true)
+    const OverloadController::Policy policy
     {
-        watchdog->IAmAlive();
+        .MaxFanoutQueueDepth = (viewerFanoutPool != nullptr) ?
+            configuration->GetOverloadMaxFanoutQueueDepth() : 0,
+        .MaxFanoutLatency = configuration->GetOverloadMaxFanoutLatency(),
+        .SustainFor = configuration->GetOverloadSustainTime(),
+        .RecoverAfter = configuration->GetOverloadRecoverTime(),
+        .ShedViewerFraction = (configuration->GetOverloadShedViewerPercent() / 100.0),
+    };
+    if ((policy.MaxFanoutQueueDepth == 0) && (policy.MaxFanoutLatency.count() <= 0))
+    {
+        if (configuration->GetOverloadMaxFanoutQueueDepth() > 0)
+        {
+            spdlog::warn("FTL_OVERLOAD_MAXFANOUTQUEUEDEPTH is set, but viewer fanout workers "
+                "aren't enabled - overload shedding is off");
+        }
+        return;
+    }
+    overloadController = std::make_shared<OverloadController>(policy);
+    overloadThread = std::thread(&JanusFtl::overloadThreadBody, this);
+}
 
-        threadShutdownConditionVariable.wait_for(lock, metadataReportInterval);
+void JanusFtl::overloadThreadBody()
+{
+    // Sleeps rather than waiting on threadShutdownMutex, which the service report thread
+    // holds while it works
+    OverloadController::Level level = OverloadController::Level::Normal;
+    while (!isStopping)
+    {
+        std::this_thread::sleep_for(OVERLOAD_SAMPLE_INTERVAL);
 
-        if (isStopping)
+        const size_t fanoutQueueDepth = (viewerFanoutPool != nullptr) ?
+            viewerFanoutPool->GetMaxQueueDepth() : 0;
+        const OverloadController::Level previousLevel = level;
+        level = overloadController->Sample(fanoutQueueDepth, std::chrono::steady_clock::now());
+        if (level == previousLevel)
         {
-            break;
+            continue;
         }
-
-        // Quickly gather data from active streams while under lock (defer reporting to avoid
-        // holding up other threads)
-        std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>,
-            std::pair<FtlStreamStats, FtlKeyframe>>> statsAndKeyframes = 
-                ftlServer->GetAllStatsAndKeyframes();
-        std::unordered_map<ftl_channel_id_t, MediaMetadata> metadataByChannel;
-        std::unordered_map<ftl_channel_id_t, uint32_t> viewersByChannel;
-        std::unique_lock lock(streamDataMutex);
-        for (const auto& streamInfo : statsAndKeyframes)
+        switch (level)
         {
-            const ftl_channel_id_t& channelId = streamInfo.first.first;
-            if (streams.count(channelId) <= 0)
+        case OverloadController::Level::Normal:
+            spdlog::info("Viewer fanout has recovered, accepting new viewers again");
+            break;
+        case OverloadController::Level::RejectingViewers:
+            if (previousLevel == OverloadController::Level::Normal)
             {
-                continue;
+                spdlog::warn("Viewer fanout is falling behind ({} packets queued), rejecting "
+                    "new viewers", fanoutQueueDepth);
+            }
+            else
+            {
+                spdlog::info("Viewer fanout is recovering, sending viewers full video again");
             }
-            metadataByChannel.try_emplace(channelId, streams.at(channelId)->GetMetadata());
-            viewersByChannel.try_emplace(channelId, streams.at(channelId)->GetViewerCount());
+            break;
+        case OverloadController::Level::SheddingVideo:
+            spdlog::warn("Viewer fanout is still falling behind ({} packets queued), dropping "
+                "non-keyframe video for the newest viewers", fanoutQueueDepth);
+            break;
         }
-        lock.unlock();
+    }
+}
 
-        // Now coalesce all of the stream data and report it to the ServiceConnection
-        std::list<std::pair<ftl_channel_id_t, ftl_stream_id_t>> streamsStopped;
-        for (const auto& streamInfo : statsAndKeyframes)
-        {
-            const ftl_channel_id_t& channelId = streamInfo.first.first;
-            const ftl_stream_id_t& streamId = streamInfo.first.second;
-            const FtlStreamStats& stats = streamInfo.second.first;
-            const FtlKeyframe& keyframe = streamInfo.second.second;
+void JanusFtl::initMetricsServer()
+{
+    if (metrics == nullptr)
+    {
+        return;
+    }
 
-            // Has this stream exceeded the maximum allowed bandwidth?
-            if ((maxAllowedBitsPerSecond > 0) && 
-                (stats.RollingAverageBitrateBps > maxAllowedBitsPerSecond))
-            {
-                spdlog::info("Channel {} / Stream {} is averaging {}bps, exceeding the limit of "
-                    "{}bps. Stopping the stream...", channelId, streamId,
-                    stats.RollingAverageBitrateBps, maxAllowedBitsPerSecond);
-                ftlServer->StopStream(channelId, streamId);
-                streamsStopped.emplace_back(channelId, streamId);
-                continue;
-            }
+    metrics->AddCollector(
+        [this](MetricsRegistry::Writer& writer)
+        {
+            collectIngestMetrics(writer);
+        });
+
+    const uint16_t port = configuration->GetMetricsPort();
+    metricsServer = std::make_unique<httplib::Server>();
+    metricsServer->Get("/metrics",
+        [this](const httplib::Request&, httplib::Response& response)
+        {
+            response.set_content(metrics->Render(), "text/plain; version=0.0.4");
+        });
+    if (!metricsServer->bind_to_port("0.0.0.0", port))
+    {
+        throw std::runtime_error(fmt::format("Could not listen for metrics on port {}", port));
+    }
+    metricsServerThread = std::thread(
+        [this]()
+        {
+            metricsServer->listen_after_bind();
+        });
+    spdlog::info("Serving metrics on port {}", port);
+}
+
+void JanusFtl::stopMetricsServer()
+{
+    if (metricsServer == nullptr)
+    {
+        return;
+    }
+    metricsServer->stop();
+    if (metricsServerThread.joinable())
+    {
+        metricsServerThread.join();
+    }
+}
+
+std::optional<FtlHandoff> JanusFtl::receiveHandoffSockets(int& predecessorHandle)
+{
+    predecessorHandle = -1;
+    const std::string path = configuration->GetHandoffSocketPath();
+    if (path.empty())
+    {
+        return std::nullopt;
+    }
+    Result<int> connectResult = UnixSocketHandoff::Connect(path);
+    if (connectResult.IsError)
+    {
+        // Nothing is running for us to take over from
+        spdlog::info("Starting without a handoff: {}", connectResult.ErrorMessage);
+        return std::nullopt;
+    }
+
+    const int socketHandle = connectResult.Value;
+    Result<void> requestResult = FtlHandoffProtocol::SendRequest(socketHandle);
+    if (requestResult.IsError)
+    {
+        spdlog::error("Couldn't request a handoff, starting without one: {}",
+            requestResult.ErrorMessage);
+        close(socketHandle);
+        return std::nullopt;
+    }
+    Result<FtlHandoff> receiveResult = FtlHandoffProtocol::ReceiveSockets(socketHandle);
+    if (receiveResult.IsError)
+    {
+        spdlog::error("Couldn't receive a handoff, starting without one: {}",
+            receiveResult.ErrorMessage);
+        close(socketHandle);
+        return std::nullopt;
+    }
+    spdlog::info("Taking over {} control sockets and {} media sockets",
+        receiveResult.Value.ControlListenHandles.size(), receiveResult.Value.MediaHandles.size());
+    predecessorHandle = socketHandle;
+    return std::move(receiveResult.Value);
+}
+
+void JanusFtl::adoptHandedOffStreams(int predecessorHandle)
+{
+    // Streams arrive as our predecessor stops each one, so they're taken over right away
+    size_t numStreams = 0;
+    while (true)
+    {
+        Result<std::optional<FtlStreamHandoff>> receiveResult =
+            FtlHandoffProtocol::ReceiveStream(predecessorHandle);
+        if (receiveResult.IsError)
+        {
+            spdlog::error("Stopped receiving handed off streams: {}",
+                receiveResult.ErrorMessage);
+            break;
+        }
+        if (!receiveResult.Value.has_value())
+        {
+            break;
+        }
+
+        FtlStreamHandoff& streamHandoff = receiveResult.Value.value();
+        const ftl_channel_id_t channelId = streamHandoff.ChannelId;
+        const ftl_stream_id_t streamId = streamHandoff.StreamId;
+        // The service already knows about the stream, it carries on with the same ID
+        auto stream = std::make_shared<JanusStream>(channelId, streamId, streamHandoff.Metadata,
+            viewerFanoutPool, configuration->IsRelayKeyframeBurstEnabled(),
+            configuration->IsRelayGroupEnabled(), configuration->GetRelayPacingInterval(),
+            metrics, nextStreamNumaNode(),
+            startRecording(channelId, streamId, streamHandoff.Metadata),
+            overloadController);
+        {
+            LockedChannel channel = lockChannel(channelId, true);
+            channel.State->Stream = stream;
+        }
+        publishStream(channelId, streamId);
+
+        Result<void> adoptResult = ftlServer->AdoptStream(streamHandoff, stream);
+        if (adoptResult.IsError)
+        {
+            spdlog::error("Couldn't carry on with handed off Channel {} / Stream {}: {}",
+                channelId, streamId, adoptResult.ErrorMessage);
+            ftlServerStreamEnded(channelId, streamId);
+            continue;
+        }
+        spdlog::info("Took over stream: Channel {} / Stream {}.", channelId, streamId);
+        ++numStreams;
+    }
+    close(predecessorHandle);
+    spdlog::info("Took over {} streams", numStreams);
+}
+
+void JanusFtl::initHandoffListener()
+{
+    const std::string path = configuration->GetHandoffSocketPath();
+    if (path.empty())
+    {
+        return;
+    }
+    Result<int> listenResult = UnixSocketHandoff::Listen(path);
+    if (listenResult.IsError)
+    {
+        spdlog::error("Won't be able to hand off to a successor: {}", listenResult.ErrorMessage);
+        return;
+    }
+    handoffListenHandle = listenResult.Value;
+    handoffThread = std::thread(&JanusFtl::handoffThreadBody, this);
+    spdlog::info("Waiting for a successor to hand off to on {}", path);
+}
+
+void JanusFtl::handoffThreadBody()
+{
+    while (!isStopping)
+    {
+        Result<std::optional<int>> acceptResult =
+            UnixSocketHandoff::Accept(handoffListenHandle, HANDOFF_ACCEPT_TIMEOUT);
+        if (acceptResult.IsError)
+        {
+            spdlog::error("Stopped waiting for a successor: {}", acceptResult.ErrorMessage);
+            break;
+        }
+        if (!acceptResult.Value.has_value())
+        {
+            continue;
+        }
+
+        const int socketHandle = acceptResult.Value.value();
+        const bool isHandedOff = handOffToSuccessor(socketHandle);
+        close(socketHandle);
+        if (isHandedOff)
+        {
+            break;
+        }
+    }
+    // The path now belongs to our successor, so it's left in place
+    close(handoffListenHandle);
+}
+
+bool JanusFtl::handOffToSuccessor(int socketHandle)
+{
+    Result<void> requestResult = FtlHandoffProtocol::ReceiveRequest(socketHandle);
+    if (requestResult.IsError)
+    {
+        spdlog::warn("Ignoring handoff connection: {}", requestResult.ErrorMessage);
+        return false;
+    }
+    Result<FtlHandoff> socketsResult = ftlServer->HandOffSockets();
+    if (socketsResult.IsError)
+    {
+        spdlog::error("Couldn't hand off to successor: {}", socketsResult.ErrorMessage);
+        return false;
+    }
+    // Our successor serves metrics on the same port
+    stopMetricsServer();
+    Result<void> sendResult = FtlHandoffProtocol::SendSockets(socketHandle, socketsResult.Value);
+    FtlHandoffProtocol::CloseHandles(socketsResult.Value);
+    if (sendResult.IsError)
+    {
+        // We've stopped accepting connections, but streams we already have carry on here
+        spdlog::error("Couldn't hand off sockets to successor: {}", sendResult.ErrorMessage);
+        return true;
+    }
+
+    // Streams carry on in our successor, so they only end here. If it has gone away, the
+    // streamers will have to reconnect to it.
+    size_t numStreams = 0;
+    ftlServer->HandOffStreams(
+        [this, socketHandle, &sendResult, &numStreams](FtlStreamHandoff& streamHandoff)
+        {
+            {
+                LockedChannel channel = lockChannel(streamHandoff.ChannelId, false);
+                if (channel.State != nullptr)
+                {
+                    endStream(streamHandoff.ChannelId, streamHandoff.StreamId, *channel.State,
+                        channel.Lock, true);
+                }
+            }
+            retireChannelIfUnused(streamHandoff.ChannelId);
+            if (!sendResult.IsError)
+            {
+                sendResult = FtlHandoffProtocol::SendStream(socketHandle, streamHandoff);
+                numStreams += sendResult.IsError ? 0 : 1;
+            }
+            FtlHandoffProtocol::CloseHandles(streamHandoff);
+        });
+    if (!sendResult.IsError)
+    {
+        sendResult = FtlHandoffProtocol::SendDone(socketHandle);
+    }
+
+    if (sendResult.IsError)
+    {
+        spdlog::error("Handoff to successor failed after {} streams: {}", numStreams,
+            sendResult.ErrorMessage);
+        return true;
+    }
+    spdlog::info("Handed off {} streams to successor, no longer ingesting", numStreams);
+    return true;
+}
+
+void JanusFtl::serviceReportThreadBody(std::promise<void>&& threadEndedPromise)
+{
+    threadEndedPromise.set_value_at_thread_exit();
+    std::unique_lock lock(threadShutdownMutex);
+    // Reports go to the service without waiting on it, so one slow report doesn't hold up
+    // everything else this thread does. Only one report is sent at a time.
+    std::optional<PendingMetadataReport> pendingReport;
+    std::unordered_map<ftl_stream_id_t, std::vector<uint8_t>> jpegsByStream;
+
+    while (true)
+    {
+        watchdog->IAmAlive();
+
+        threadShutdownConditionVariable.wait_for(lock, metadataReportInterval);
+
+        if (isStopping)
+        {
+            break;
+        }
+
+        std::list<std::pair<ftl_channel_id_t, ftl_stream_id_t>> streamsStopped;
+        if (pendingReport.has_value() &&
+            (pendingReport->Results.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready))
+        {
+            processMetadataReportResults(*pendingReport, streamsStopped);
+            pendingReport.reset();
+        }
+
+        const TaskExecutor::Stats asyncCallStats = ftlServer->GetAsyncCallStats();
+        spdlog::debug("Ingest callbacks: {} queued (peak {}), {} completed, mean wait {}us, "
+            "max wait {}us, mean run {}us, max run {}us", asyncCallStats.QueuedTasks,
+            asyncCallStats.PeakQueuedTasks, asyncCallStats.CompletedTasks,
+            (asyncCallStats.CompletedTasks > 0) ?
+                (asyncCallStats.TotalQueueLatency.count() / asyncCallStats.CompletedTasks) : 0,
+            asyncCallStats.MaxQueueLatency.count(),
+            (asyncCallStats.CompletedTasks > 0) ?
+                (asyncCallStats.TotalRunTime.count() / asyncCallStats.CompletedTasks) : 0,
+            asyncCallStats.MaxRunTime.count());
+
+        unsubscribeExpiredRelays();
+
+        // Quickly gather data from active streams while under lock (defer reporting to avoid
+        // holding up other threads)
+        std::list<std::pair<std::pair<ftl_channel_id_t, ftl_stream_id_t>,
+            std::pair<FtlStreamStats, std::shared_ptr<const FtlKeyframe>>>> statsAndKeyframes = 
+                ftlServer->GetAllStatsAndKeyframes();
+        std::unordered_map<ftl_channel_id_t, MediaMetadata> metadataByChannel;
+        std::unordered_map<ftl_channel_id_t, uint32_t> viewersByChannel;
+        std::unordered_map<ftl_channel_id_t, uint32_t> relaysByChannel;
+        std::unordered_map<ftl_channel_id_t, uint64_t> bitrateByChannel;
+        for (const auto& streamInfo : statsAndKeyframes)
+        {
+            const ftl_channel_id_t& channelId = streamInfo.first.first;
+            LockedChannel channel = lockChannel(channelId, false);
+            if ((channel.State == nullptr) || (channel.State->Stream == nullptr))
+            {
+                continue;
+            }
+            channel.State->Stream->RemoveClosedRelays();
+            metadataByChannel.try_emplace(channelId, channel.State->Stream->GetMetadata());
+            viewersByChannel.try_emplace(channelId, channel.State->Stream->GetViewerCount());
+            relaysByChannel.try_emplace(channelId, channel.State->Stream->GetRelayCount());
+            bitrateByChannel.try_emplace(channelId,
+                streamInfo.second.first.RollingAverageBitrateBps);
+        }
+
+        reportNodeLoad(bitrateByChannel, viewersByChannel, relaysByChannel);
+
+        // Pick up any keyframes the thumbnail pool has finished decoding since the last cycle
+        for (auto& result : thumbnailPool->CollectResults())
+        {
+            auto stateIt = reportedKeyframeStates.find(result.StreamId);
+            if (stateIt == reportedKeyframeStates.end())
+            {
+                // This stream has gone away in the meantime
+                continue;
+            }
+            if (!result.IsSuccess)
+            {
+                spdlog::warn("Couldn't decode keyframe for channel {} / stream {}: {}",
+                    result.ChannelId, result.StreamId, result.ErrorMessage);
+                continue;
+            }
+            stateIt->second.VideoWidth = result.VideoWidth;
+            stateIt->second.VideoHeight = result.VideoHeight;
+            if (result.JpegBytes.size() > 0)
+            {
+                jpegsByStream.insert_or_assign(result.StreamId, std::move(result.JpegBytes));
+            }
+        }
+
+        // Now coalesce all of the stream data and report it to the ServiceConnection
+        std::vector<std::pair<ftl_stream_id_t, StreamMetadata>> metadataUpdates;
+        std::vector<std::pair<ftl_channel_id_t, ftl_stream_id_t>> updatedStreams;
+        for (const auto& streamInfo : statsAndKeyframes)
+        {
+            const ftl_channel_id_t& channelId = streamInfo.first.first;
+            const ftl_stream_id_t& streamId = streamInfo.first.second;
+            const FtlStreamStats& stats = streamInfo.second.first;
+            const FtlKeyframe& keyframe = *streamInfo.second.second;
+
+            // Has this stream exceeded the maximum allowed bandwidth?
+            if ((maxAllowedBitsPerSecond > 0) && 
+                (stats.RollingAverageBitrateBps > maxAllowedBitsPerSecond))
+            {
+                spdlog::info("Channel {} / Stream {} is averaging {}bps, exceeding the limit of "
+                    "{}bps. Stopping the stream...", channelId, streamId,
+                    stats.RollingAverageBitrateBps, maxAllowedBitsPerSecond);
+                ftlServer->StopStream(channelId, streamId);
+                streamsStopped.emplace_back(channelId, streamId);
+                continue;
+            }
 
             if ((viewersByChannel.count(channelId) <= 0) ||
                 (metadataByChannel.count(channelId) <= 0))
@@ -561,29 +1331,58 @@ void JanusFtl::serviceReportThreadBody(std::promise<void>&& threadEndedPromise)
             const MediaMetadata& mediaMetadata = metadataByChannel.at(channelId);
             const uint32_t& numActiveViewers = viewersByChannel.at(channelId);
 
-            // Fallback width/height values, usually wrong
-            uint16_t videoWidth = mediaMetadata.VideoWidth;
-            uint16_t videoHeight = mediaMetadata.VideoHeight;
+            // Keyframes are only decoded when they change, and previews are only generated once
+            // per thumbnail interval, so an unchanged keyframe costs nothing to report.
+            // If the stream's parameter sets told us its dimensions, we don't need to decode
+            // anything for them at all.
+            ReportedKeyframeState& keyframeState = reportedKeyframeStates[streamId];
+            const auto now = std::chrono::steady_clock::now();
+            const bool isKeyframeChanged = !keyframe.Parameters.has_value() &&
+                (keyframe.Generation != keyframeState.DecodedGeneration);
+            const bool isThumbnailDue =
+                (keyframe.Generation != keyframeState.ThumbnailGeneration) &&
+                ((keyframeState.ThumbnailGeneration == 0) ||
+                    ((now - keyframeState.LastThumbnailTime) >= thumbnailInterval));
 
             // Do we have a videodecoder available for this stream's codec?
-            if ((keyframe.Packets.size() > 0) && (videoDecoders.count(keyframe.Codec) > 0))
+            // Decoding happens on the thumbnail pool, and its results are picked up by a later
+            // report cycle.
+            if ((keyframe.Packets.size() > 0) && thumbnailPool->IsCodecSupported(keyframe.Codec) &&
+                (isKeyframeChanged || isThumbnailDue))
             {
-                try
+                bool isEnqueued = thumbnailPool->Enqueue(ThumbnailWorkerPool::Job
+                    {
+                        .ChannelId = channelId,
+                        .StreamId = streamId,
+                        .Keyframe = streamInfo.second.second,
+                        .GenerateJpeg = isThumbnailDue,
+                    });
+                // If the pool is full, we'll try again next cycle
+                if (isEnqueued)
                 {
-                    // Read correct video dimensions
-                    std::pair<uint16_t, uint16_t> widthHeight =
-                        videoDecoders.at(keyframe.Codec)->ReadVideoDimensions(keyframe.Packets);
-
-                    videoWidth = widthHeight.first;
-                    videoHeight = widthHeight.second;
-                }
-                catch (const PreviewGenerationFailedException& e)
-                {
-                    spdlog::warn("Couldn't read stream video size for channel {} / stream {}: {}",
-                        channelId, streamId, e.what());
+                    keyframeState.DecodedGeneration = keyframe.Generation;
+                    if (isThumbnailDue)
+                    {
+                        keyframeState.ThumbnailGeneration = keyframe.Generation;
+                        keyframeState.LastThumbnailTime = now;
+                    }
                 }
             }
 
+            // Read correct video dimensions, falling back to the usually wrong metadata values
+            uint16_t videoWidth = mediaMetadata.VideoWidth;
+            uint16_t videoHeight = mediaMetadata.VideoHeight;
+            if (keyframe.Parameters.has_value())
+            {
+                videoWidth = keyframe.Parameters->Width;
+                videoHeight = keyframe.Parameters->Height;
+            }
+            else if ((keyframeState.VideoWidth > 0) && (keyframeState.VideoHeight > 0))
+            {
+                videoWidth = keyframeState.VideoWidth;
+                videoHeight = keyframeState.VideoHeight;
+            }
+
             StreamMetadata metadata
             {
                 .ingestServerHostname = configuration->GetMyHostname(),
@@ -593,7 +1392,8 @@ void JanusFtl::serviceReportThreadBody(std::promise<void>&& threadEndedPromise)
                 .numPacketsReceived = stats.PacketsReceived,
                 .numPacketsNacked = stats.PacketsNacked,
                 .numPacketsLost = stats.PacketsLost,
-                .streamerToIngestPingMs = 0, // TODO
+                .streamerToIngestPingMs = static_cast<uint16_t>(std::min<uint32_t>(
+                    stats.RoundTripTimeMs, std::numeric_limits<uint16_t>::max())),
                 .streamerClientVendorName = mediaMetadata.VendorName,
                 .streamerClientVendorVersion = mediaMetadata.VendorVersion,
                 .videoCodec = SupportedVideoCodecs::VideoCodecString(mediaMetadata.VideoCodec),
@@ -601,67 +1401,440 @@ void JanusFtl::serviceReportThreadBody(std::promise<void>&& threadEndedPromise)
                 .videoWidth = videoWidth,
                 .videoHeight = videoHeight,
             };
-            Result<ServiceConnection::ServiceResponse> updateResult =
-                serviceConnection->UpdateStreamMetadata(streamId, metadata);
-            // Check if the request failed, or the service wants to end this stream
-            if (updateResult.IsError || 
-                (updateResult.Value == ServiceConnection::ServiceResponse::EndStream))
+            // Previews only go out alongside a report, so a stream with one waiting is always
+            // reported
+            if ((jpegsByStream.count(streamId) <= 0) &&
+                !metadataReportPolicy->ShouldReport(streamId, metadata, now))
             {
-                if (updateResult.IsError)
-                {
-                    spdlog::info("Service metadata update for Channel {} / Stream {} failed, "
-                        "ending stream: {}", channelId, streamId, updateResult.ErrorMessage);
-                }
-                else
-                {
-                    spdlog::info("Service requested to end Channel {} / Stream {}. "
-                        "Stopping the stream...", channelId, streamId);
-                }
-
-                ftlServer->StopStream(channelId, streamId);
-                streamsStopped.emplace_back(channelId, streamId);
                 continue;
             }
+            metadataUpdates.emplace_back(streamId, std::move(metadata));
+            updatedStreams.emplace_back(channelId, streamId);
+        }
 
-            // Do we have a videodecoder available for this stream's codec?
-            if ((keyframe.Packets.size() > 0) && (videoDecoders.count(keyframe.Codec) > 0))
+        // Report every stream's metadata together, so the service connection can batch them.
+        // If the service is still working on the last report, skip this one rather than
+        // queueing up reports behind it.
+        if (pendingReport.has_value())
+        {
+            spdlog::warn("Service connection is still processing the previous metadata report, "
+                "skipping this one");
+        }
+        else if (!metadataUpdates.empty())
+        {
+            spdlog::debug("Reporting metadata for {} of {} streams", metadataUpdates.size(),
+                statsAndKeyframes.size());
+            const auto reportTime = std::chrono::steady_clock::now();
+            for (const auto& [streamId, metadata] : metadataUpdates)
             {
-                try
-                {
-                    std::vector<uint8_t> jpegBytes =
-                        videoDecoders.at(keyframe.Codec)->GenerateJpegImage(keyframe.Packets);
-                    serviceConnection->SendJpegPreviewImage(streamId, jpegBytes);
-                }
-                catch (const PreviewGenerationFailedException& e)
-                {
-                    spdlog::warn("Couldn't generate preview for channel {} / stream {}: {}",
-                        channelId, streamId, e.what());
-                }
+                metadataReportPolicy->Reported(streamId, metadata, reportTime);
+            }
+            PendingMetadataReport report
+            {
+                .Results = asyncServiceConnection->UpdateStreamMetadataBatch(
+                    std::move(metadataUpdates)),
+                .Streams = std::move(updatedStreams),
+                .JpegsByStream = std::move(jpegsByStream),
+            };
+            jpegsByStream.clear();
+
+            // A healthy service responds well within a report interval, so usually we can deal
+            // with the results right away
+            if (report.Results.wait_for(metadataReportInterval) == std::future_status::ready)
+            {
+                processMetadataReportResults(report, streamsStopped);
+            }
+            else
+            {
+                pendingReport = std::move(report);
             }
         }
 
-        // Acquire lock and clean up any streams that were stopped
+        // Forget keyframe and report state for streams that have gone away
+        std::erase_if(reportedKeyframeStates,
+            [this, &statsAndKeyframes](const auto& keyframeStatePair)
+            {
+                const bool isGone = std::none_of(statsAndKeyframes.begin(),
+                    statsAndKeyframes.end(),
+                    [&keyframeStatePair](const auto& streamInfo)
+                    {
+                        return (streamInfo.first.second == keyframeStatePair.first);
+                    });
+                if (isGone)
+                {
+                    metadataReportPolicy->RemoveStream(keyframeStatePair.first);
+                }
+                return isGone;
+            });
+
+        // Clean up any streams that were stopped
         // We do this last to avoid locking while calling FtlStream::Stop(), since this call could
         // wind up waiting forever on the connection thread due to it taking a lock in the
         // JanusFtl::ftlServerRtpPacket callback
-        lock.lock();
         for (const auto& channelStreamPair : streamsStopped)
         {
-            endStream(channelStreamPair.first, channelStreamPair.second, lock);
+            ftlServerStreamEnded(channelStreamPair.first, channelStreamPair.second);
         }
     }
 }
 
+void JanusFtl::processMetadataReportResults(PendingMetadataReport& report,
+    std::list<std::pair<ftl_channel_id_t, ftl_stream_id_t>>& streamsStopped)
+{
+    std::vector<Result<ServiceConnection::ServiceResponse>> updateResults = report.Results.get();
+    for (size_t i = 0; i < std::min(updateResults.size(), report.Streams.size()); ++i)
+    {
+        const auto& [channelId, streamId] = report.Streams.at(i);
+        const Result<ServiceConnection::ServiceResponse>& updateResult = updateResults.at(i);
+        // Check if the request failed, or the service wants to end this stream
+        if (updateResult.IsError || 
+            (updateResult.Value == ServiceConnection::ServiceResponse::EndStream))
+        {
+            if (updateResult.IsError)
+            {
+                spdlog::info("Service metadata update for Channel {} / Stream {} failed, "
+                    "ending stream: {}", channelId, streamId, updateResult.ErrorMessage);
+            }
+            else
+            {
+                spdlog::info("Service requested to end Channel {} / Stream {}. "
+                    "Stopping the stream...", channelId, streamId);
+            }
+
+            ftlServer->StopStream(channelId, streamId);
+            streamsStopped.emplace_back(channelId, streamId);
+            continue;
+        }
+
+        auto jpegIt = report.JpegsByStream.find(streamId);
+        if (jpegIt != report.JpegsByStream.end())
+        {
+            // Nothing depends on the upload, so don't wait for it
+            asyncServiceConnection->SendJpegPreviewImage(streamId, std::move(jpegIt->second));
+        }
+    }
+}
+
+void JanusFtl::reportNodeLoad(
+    const std::unordered_map<ftl_channel_id_t, uint64_t>& bitrateByChannel,
+    const std::unordered_map<ftl_channel_id_t, uint32_t>& viewersByChannel,
+    const std::unordered_map<ftl_channel_id_t, uint32_t>& relaysByChannel)
+{
+    NodeLoad load
+    {
+        .StreamCount = static_cast<uint32_t>(bitrateByChannel.size()),
+        .CpuUtilization = cpuUsageSampler.Sample(),
+        .FanoutQueueDepth = (viewerFanoutPool != nullptr) ?
+            viewerFanoutPool->GetMaxQueueDepth() : 0,
+    };
+    // Every viewer and relay gets its own copy of the stream
+    for (const auto& [channelId, bitrate] : bitrateByChannel)
+    {
+        auto viewersIt = viewersByChannel.find(channelId);
+        auto relaysIt = relaysByChannel.find(channelId);
+        const uint32_t numViewers = (viewersIt != viewersByChannel.end()) ? viewersIt->second : 0;
+        const uint32_t numRelays = (relaysIt != relaysByChannel.end()) ? relaysIt->second : 0;
+        load.ViewerCount += numViewers;
+        load.RelayCount += numRelays;
+        load.EgressBitsPerSecond += bitrate * (numViewers + numRelays);
+    }
+
+    const uint32_t currentLoad = nodeLoadEstimator->Estimate(load);
+    spdlog::debug("Node load {}/{}: {} streams, {} viewers, {} relays, {}bps egress, {:.0f}% CPU, "
+        "{} packets in busiest fanout queue", currentLoad, NodeLoadEstimator::MAXIMUM_LOAD,
+        load.StreamCount, load.ViewerCount, load.RelayCount, load.EgressBitsPerSecond,
+        (load.CpuUtilization * 100), load.FanoutQueueDepth);
+
+    sendToOrchestrator(
+        [currentLoad](FtlConnection& orchestrator)
+        {
+            orchestrator.SendNodeState(ConnectionNodeStatePayload
+                {
+                    .CurrentLoad = currentLoad,
+                    .MaximumLoad = NodeLoadEstimator::MAXIMUM_LOAD,
+                });
+        });
+}
+
+void JanusFtl::collectIngestMetrics(MetricsRegistry::Writer& writer)
+{
+    for (const auto& [streamIds, stats] : ftlServer->GetAllStats())
+    {
+        const MetricLabels labels
+        {
+            { "channel", std::to_string(streamIds.first) },
+            { "stream", std::to_string(streamIds.second) },
+        };
+        writer.Counter("ftl_ingest_packets_received_total", "Media packets received for a stream",
+            labels, stats.PacketsReceived);
+        writer.Counter("ftl_ingest_bytes_received_total", "Media bytes received for a stream",
+            labels, stats.BytesReceived);
+        writer.Counter("ftl_ingest_packets_lost_total", "Media packets lost for a stream",
+            labels, stats.PacketsLost);
+        writer.Counter("ftl_ingest_packets_nacked_total", "Media packets NACKed for a stream",
+            labels, stats.PacketsNacked);
+        writer.Gauge("ftl_ingest_bitrate_bits_per_second",
+            "Rolling average media bitrate received for a stream", labels,
+            stats.RollingAverageBitrateBps);
+        writer.Gauge("ftl_ingest_memory_bytes",
+            "Packet buffer capacity a stream holds against its memory budget", labels,
+            stats.MemoryBytes);
+        writer.Counter("ftl_ingest_keyframes_dropped_total",
+            "Keyframes not captured because they'd take a stream over its memory budget",
+            labels, stats.KeyframesDropped);
+        writer.Counter("ftl_ingest_packets_over_bitrate_limit_total",
+            "Media packets dropped because they'd take a stream over its bitrate limit",
+            labels, stats.PacketsOverBitrateLimit);
+        writer.Counter("ftl_ingest_packets_dropped_late_total",
+            "Media packets that arrived after the packets following them were fanned out",
+            labels, stats.PacketsDroppedLate);
+        writer.Counter("ftl_ingest_duplicate_packets_dropped_total",
+            "Copies of media packets that had already been fanned out or held for reordering",
+            labels, stats.DuplicatePacketsDropped);
+        writer.Gauge("ftl_ingest_round_trip_seconds",
+            "Smoothed round trip time to a stream's streamer, NACKs are timed by it", labels,
+            stats.RoundTripTimeMs / 1000.0);
+    }
+
+    if (viewerFanoutPool != nullptr)
+    {
+        writer.Gauge("ftl_viewer_fanout_max_queued_packets",
+            "Packets waiting in the busiest viewer fanout worker's queue", {},
+            viewerFanoutPool->GetMaxQueueDepth());
+        writer.Counter("ftl_viewer_fanout_dropped_packets_total",
+            "Packets dropped because a viewer fanout worker fell behind", {},
+            viewerFanoutPool->GetDroppedPacketCount());
+    }
+    writer.Gauge("ftl_service_pending_calls", "Service connection calls waiting for a thread",
+        {}, asyncServiceConnection->GetPendingCallCount());
+
+    for (const PacketBufferPool::Stats& poolStats : PacketBufferPool::GetSizeClassStats())
+    {
+        const MetricLabels labels
+        {
+            { "buffer_bytes", std::to_string(poolStats.BufferCapacity) },
+        };
+        writer.Counter("ftl_packet_pool_hits_total",
+            "Packet buffers acquired without allocating", labels, poolStats.Hits);
+        writer.Counter("ftl_packet_pool_misses_total",
+            "Packet buffers acquired that needed another slab allocated", labels,
+            poolStats.Misses);
+        writer.Gauge("ftl_packet_pool_buffers", "Packet buffers allocated in a pool's slabs",
+            labels, poolStats.AllocatedBuffers);
+        writer.Gauge("ftl_packet_pool_buffers_in_use", "Packet buffers acquired and not released",
+            labels, poolStats.BuffersInUse);
+        writer.Gauge("ftl_packet_pool_peak_buffers_in_use",
+            "Most packet buffers in use at once", labels, poolStats.PeakBuffersInUse);
+    }
+    if (overloadController != nullptr)
+    {
+        writer.Gauge("ftl_overload_level",
+            "0 when healthy, 1 while rejecting new viewers, 2 while also shedding video", {},
+            static_cast<uint8_t>(overloadController->GetLevel()));
+        writer.Counter("ftl_overload_rejected_viewers_total",
+            "Watch requests turned away because the node was overloaded", {},
+            overloadController->GetRejectedViewerCount());
+        writer.Counter("ftl_overload_shed_video_packets_total",
+            "Non-keyframe video packets not sent to a viewer because the node was overloaded",
+            {}, overloadController->GetShedVideoPacketCount());
+    }
+    writer.Counter("ftl_packet_pool_unpooled_buffers_total",
+        "Packet buffers too big for any pool, allocated on their own", {},
+        PacketBufferPool::GetUnpooledBufferCount());
+}
+
+JanusFtl::LockedChannel JanusFtl::lockChannel(ftl_channel_id_t channelId, bool createIfMissing)
+{
+    while (true)
+    {
+        std::shared_ptr<ChannelState> state = createIfMissing ?
+            channels.GetOrCreate(channelId) : channels.Find(channelId);
+        if (state == nullptr)
+        {
+            return LockedChannel {};
+        }
+        std::unique_lock lock(state->Mutex);
+        // The record may have been retired while we were waiting on its lock
+        if (!state->IsRetired)
+        {
+            return LockedChannel
+            {
+                .State = std::move(state),
+                .Lock = std::move(lock),
+            };
+        }
+    }
+}
+
+void JanusFtl::retireChannelIfUnused(ftl_channel_id_t channelId)
+{
+    // Must not be called while holding the channel's lock, since the map's lock is taken first
+    channels.RemoveIf(channelId,
+        [](ChannelState& channel)
+        {
+            std::lock_guard lock(channel.Mutex);
+            channel.IsRetired =
+                ((channel.Stream == nullptr) && channel.PendingViewerSessions.empty());
+            return channel.IsRetired;
+        });
+}
+
+void JanusFtl::subscribeToChannel(ftl_channel_id_t channelId)
+{
+    // Generate a new stream key for incoming relay of this channel
+    const auto& edgeServiceConnection = 
+        std::dynamic_pointer_cast<EdgeNodeServiceConnection>(serviceConnection);
+    if (edgeServiceConnection == nullptr)
+    {
+        throw std::runtime_error(
+            "Unexpected service connection type - expected EdgeNodeServiceConnection.");
+    }
+    std::vector<std::byte> streamKey = edgeServiceConnection->ProvisionStreamKey(channelId);
+
+    // Subscribe for relay of this stream
+    sendToOrchestrator(
+        [channelId, streamKey](FtlConnection& orchestrator)
+        {
+            orchestrator.SendChannelSubscription(ConnectionSubscriptionPayload
+                {
+                    .IsSubscribe = true,
+                    .ChannelId = channelId,
+                    .StreamKey = streamKey,
+                });
+        });
+}
+
+void JanusFtl::unsubscribeFromChannel(ftl_channel_id_t channelId)
+{
+    // Remove temporary stream key
+    const auto& edgeServiceConnection = 
+        std::dynamic_pointer_cast<EdgeNodeServiceConnection>(serviceConnection);
+    if (edgeServiceConnection == nullptr)
+    {
+        throw std::runtime_error(
+            "Unexpected service connection type - expected EdgeNodeServiceConnection.");
+    }
+    edgeServiceConnection->ClearStreamKey(channelId);
+
+    sendToOrchestrator(
+        [channelId](FtlConnection& orchestrator)
+        {
+            orchestrator.SendChannelSubscription(ConnectionSubscriptionPayload
+                {
+                    .IsSubscribe = false,
+                    .ChannelId = channelId,
+                });
+        });
+}
+
+void JanusFtl::unsubscribeIfUnused(ftl_channel_id_t channelId)
+{
+    // Must not be called while holding the channel's lock
+    {
+        LockedChannel channel = lockChannel(channelId, true);
+        // Viewers may have come back since the relay stopped lingering, or it may have started
+        // lingering again
+        const bool isWatched = !channel.State->PendingViewerSessions.empty() ||
+            ((channel.State->Stream != nullptr) && (channel.State->Stream->GetViewerCount() > 0));
+        if (!isWatched && !lingeringRelays->Contains(channelId))
+        {
+            spdlog::info("Relay for channel {} is no longer lingering - unsubscribing...",
+                channelId);
+            unsubscribeFromChannel(channelId);
+        }
+    }
+    retireChannelIfUnused(channelId);
+}
+
+uint64_t JanusFtl::getRelayBitrate(ftl_channel_id_t channelId, const ChannelState& channel)
+{
+    // Relays that haven't started streaming yet are free to keep around
+    if (channel.Stream == nullptr)
+    {
+        return 0;
+    }
+    Result<FtlStreamStats> stats = ftlServer->GetStats(channelId, channel.Stream->GetStreamId());
+    if (stats.IsError)
+    {
+        return 0;
+    }
+    return stats.Value.RollingAverageBitrateBps;
+}
+
+void JanusFtl::unsubscribeExpiredRelays()
+{
+    if (lingeringRelays == nullptr)
+    {
+        return;
+    }
+    for (const ftl_channel_id_t& channelId : lingeringRelays->RemoveExpired())
+    {
+        unsubscribeIfUnused(channelId);
+    }
+}
+
+std::optional<int> JanusFtl::nextStreamNumaNode()
+{
+    if (streamNumaNodes.empty())
+    {
+        return std::nullopt;
+    }
+    return streamNumaNodes.at(nextStreamNumaNodeIndex++ % streamNumaNodes.size());
+}
+
+std::unique_ptr<StreamRecorder> JanusFtl::startRecording(ftl_channel_id_t channelId,
+    ftl_stream_id_t streamId, const MediaMetadata& mediaMetadata)
+{
+    const std::string recordingDirectory = configuration->GetRecordingDirectory();
+    if (recordingDirectory.empty())
+    {
+        return nullptr;
+    }
+    Result<std::unique_ptr<StreamRecorder>> startResult = StreamRecorder::Start(
+        recordingDirectory, channelId, streamId, mediaMetadata,
+        configuration->GetRecordingSegmentBytes(),
+        configuration->IsRecordingRotateOnKeyframeEnabled());
+    if (startResult.IsError)
+    {
+        // The stream goes ahead regardless
+        spdlog::error("Couldn't record channel {} / stream {}: {}", channelId, streamId,
+            startResult.ErrorMessage);
+        return nullptr;
+    }
+    return std::move(startResult.Value);
+}
+
+void JanusFtl::publishStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId)
+{
+    // If we are configured as an Ingest node, notify the Orchestrator that a stream has started.
+    if (configuration->GetNodeKind() == NodeKind::Ingest)
+    {
+        spdlog::info("Publishing channel {} / stream {} to Orchestrator...", channelId,
+            streamId);
+        sendToOrchestrator(
+            [channelId, streamId](FtlConnection& orchestrator)
+            {
+                orchestrator.SendStreamPublish(ConnectionPublishPayload
+                    {
+                        .IsPublish = true,
+                        .ChannelId = channelId,
+                        .StreamId = streamId,
+                    });
+            });
+    }
+}
+
 void JanusFtl::endStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId,
-    const std::unique_lock<std::shared_mutex>& streamDataLock)
+    ChannelState& channel, const std::unique_lock<std::mutex>& channelLock, bool isHandedOff)
 {
-    if (streams.count(channelId) <= 0)
+    if (channel.Stream == nullptr)
     {
         spdlog::error("Received stream ended from unknown channel {} / stream {}", channelId,
             streamId);
         return;
     }
-    const std::shared_ptr<JanusStream>& stream = streams.at(channelId);
+    // Hold on to the stream, since it's removed from the channel below
+    const std::shared_ptr<JanusStream> stream = channel.Stream;
     if (stream->GetStreamId() != streamId)
     {
         spdlog::error("Stream ended from channel {} had unexpected stream id {}, expected {}",
@@ -671,29 +1844,46 @@ void JanusFtl::endStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId,
 
     // Reset any existing viewers to a pending state
     auto viewerSessions = stream->RemoveAllViewerSessions();
-    pendingViewerSessions[channelId].insert(viewerSessions.begin(), viewerSessions.end());
+    channel.PendingViewerSessions.insert(viewerSessions.begin(), viewerSessions.end());
     // TODO: Tell viewers stream is offline.
 
     // If we are configured as an Ingest node, notify the Orchestrator that a stream has ended.
-    if ((configuration->GetNodeKind() == NodeKind::Ingest) && (orchestrationClient != nullptr))
+    // Our successor has published streams that were handed off to it.
+    if (!isHandedOff && (configuration->GetNodeKind() == NodeKind::Ingest))
     {
         spdlog::info("Unpublishing channel {} / stream {} from Orchestrator",
             stream->GetChannelId(), stream->GetStreamId());
-        orchestrationClient->SendStreamPublish(ConnectionPublishPayload
+        sendToOrchestrator(
+            [channelId = stream->GetChannelId(), streamId = stream->GetStreamId()](
+                FtlConnection& orchestrator)
             {
-                .IsPublish = false,
-                .ChannelId = stream->GetChannelId(),
-                .StreamId = stream->GetStreamId(),
+                orchestrator.SendStreamPublish(ConnectionPublishPayload
+                    {
+                        .IsPublish = false,
+                        .ChannelId = channelId,
+                        .StreamId = streamId,
+                    });
             });
     }
 
     stream->StopRelays();
 
+    channel.Stream.reset();
+    if (isHandedOff)
+    {
+        spdlog::info("Stream handed off. Channel {} / stream {}", channelId, streamId);
+        return;
+    }
+
     spdlog::info("Stream ended. Channel {} / stream {}",
         stream->GetChannelId(), stream->GetStreamId());
 
-    serviceConnection->EndStream(streamId);
-    streams.erase(channelId);
+    // Nothing here depends on the service's response, so don't hold up the caller for it
+    asyncServiceConnection->EndStream(streamId);
+    if (hmacKeyCache != nullptr)
+    {
+        hmacKeyCache->Invalidate(channelId);
+    }
 }
 
 void JanusFtl::handlePsfbRtcpPacket(janus_plugin_session* handle, janus_rtcp_header* packet)
@@ -702,7 +1892,27 @@ void JanusFtl::handlePsfbRtcpPacket(janus_plugin_session* handle, janus_rtcp_hea
     {
     case 1:
     {
-        // PLI - send keyframe?
+        // PLI - we can't ask the streamer for a keyframe, so resend the one we have cached
+        std::shared_ptr<ActiveSession> session = sessions.Find(handle);
+        if (session == nullptr)
+        {
+            break;
+        }
+        std::unique_lock sessionLock(session->Mutex);
+        if (!session->WatchingChannelId.has_value())
+        {
+            break;
+        }
+        std::shared_ptr<JanusStream> stream;
+        if (LockedChannel channel = lockChannel(session->WatchingChannelId.value(), false);
+            channel.State != nullptr)
+        {
+            stream = channel.State->Stream;
+        }
+        if (stream != nullptr)
+        {
+            stream->SendKeyframeBurst(session->Session.get());
+        }
         break;
     }
     default:
@@ -719,11 +1929,32 @@ janus_plugin_result* JanusFtl::generateMessageErrorResponse(int errorCode, std::
     return janus_plugin_result_new(JANUS_PLUGIN_OK, NULL, event);
 }
 
+janus_plugin_result* JanusFtl::generateOverloadedErrorResponse()
+{
+    // A hint for clients to try watching from somewhere else, or here again later
+    json_t* redirect = json_object();
+    json_object_set_new(redirect, "reason", json_string("overloaded"));
+    json_object_set_new(redirect, "retryAfterMs",
+        json_integer(overloadController->GetRecoverAfter().count()));
+    const std::string redirectHostname = configuration->GetOverloadRedirectHostname();
+    if (!redirectHostname.empty())
+    {
+        json_object_set_new(redirect, "hostname", json_string(redirectHostname.c_str()));
+    }
+
+    json_t *event = json_object();
+    json_object_set_new(event, "streaming", json_string("event"));
+    json_object_set_new(event, "error_code", json_integer(FTL_PLUGIN_ERROR_OVERLOADED));
+    json_object_set_new(event, "error", json_string("Node is overloaded, try again elsewhere."));
+    json_object_set_new(event, "redirect", redirect);
+    return janus_plugin_result_new(JANUS_PLUGIN_OK, NULL, event);
+}
+
 janus_plugin_result* JanusFtl::handleWatchMessage(ActiveSession& session, JsonPtr message,
     char* transaction)
 {
-    // We are already holding a unique lock on streamDataMutex
-    
+    // We are already holding the session's lock
+
     json_t* channelIdJs = json_object_get(message.get(), "channelId");
     if ((channelIdJs == nullptr) || !json_is_integer(channelIdJs))
     {
@@ -733,50 +1964,49 @@ janus_plugin_result* JanusFtl::handleWatchMessage(ActiveSession& session, JsonPt
     }
     uint32_t channelId = json_integer_value(channelIdJs);
 
+    // Viewers can ask for just the audio, and are then never sent video at all
+    json_t* audioOnlyJs = json_object_get(message.get(), "audioOnly");
+    if ((audioOnlyJs != nullptr) && !json_is_boolean(audioOnlyJs))
+    {
+        return generateMessageErrorResponse(
+            FTL_PLUGIN_ERROR_INVALID_REQUEST,
+            "Expected 'audioOnly' property to have a boolean value.");
+    }
+    const bool isAudioOnly = (audioOnlyJs != nullptr) && json_is_true(audioOnlyJs);
+
+    // Turn new viewers away while fanout is falling behind, rather than slowing every viewer
+    if ((overloadController != nullptr) && !overloadController->IsAcceptingViewers())
+    {
+        spdlog::info("Rejecting request to watch channel {}, node is overloaded", channelId);
+        overloadController->RecordRejectedViewer();
+        return generateOverloadedErrorResponse();
+    }
+
     // Look up the stream associated with given channel ID
-    spdlog::info("Request to watch channel {}", channelId);
+    spdlog::info("Request to watch channel {}{}", channelId, isAudioOnly ? " (audio only)" : "");
     session.WatchingChannelId = channelId;
-    if (streams.count(channelId) <= 0)
+    session.Session->SetIsAudioOnly(isAudioOnly);
+    LockedChannel channel = lockChannel(channelId, true);
+    // A viewer coming back to a lingering relay keeps it from being unsubscribed
+    const bool wasLingering = (lingeringRelays != nullptr) && lingeringRelays->Remove(channelId);
+    if (channel.State->Stream == nullptr)
     {
         // This channel doesn't have a stream running!
-        int pendingViewers = 0;
-        if (pendingViewerSessions.count(channelId) > 0)
-        {
-            pendingViewers = pendingViewerSessions[channelId].size();
-        }
+        size_t pendingViewers = channel.State->PendingViewerSessions.size();
 
-        // If we're an Edge node and this is a first viewer for a given channel,
-        // request that this channel be relayed to us.
-        if ((configuration->GetNodeKind() == NodeKind::Edge) && (pendingViewers == 0))
+        // If we're an Edge node and this is a first viewer for a given channel we aren't
+        // already subscribed to, request that this channel be relayed to us.
+        if ((configuration->GetNodeKind() == NodeKind::Edge) && (pendingViewers == 0) &&
+            !wasLingering && !prewarmChannelIds.contains(channelId))
         {
-            // Generate a new stream key for incoming relay of this channel
-            const auto& edgeServiceConnection = 
-                std::dynamic_pointer_cast<EdgeNodeServiceConnection>(serviceConnection);
-            if (edgeServiceConnection == nullptr)
-            {
-                throw std::runtime_error(
-                    "Unexpected service connection type - expected EdgeNodeServiceConnection.");
-            }
-            std::vector<std::byte> streamKey = edgeServiceConnection->ProvisionStreamKey(channelId);
-
-            // Subscribe for relay of this stream
             spdlog::info("First viewer for channel {} - subscribing...",
                channelId);
-            orchestrationClient->SendChannelSubscription(ConnectionSubscriptionPayload
-                {
-                    .IsSubscribe = true,
-                    .ChannelId = channelId,
-                    .StreamKey = streamKey,
-                });
+            subscribeToChannel(channelId);
         }
 
         // Add this session to a pending viewership list.
         spdlog::info("No current stream for channel {} - viewer session is pending.", channelId);
-        if (pendingViewerSessions.count(channelId) <= 0)
-        {
-            pendingViewerSessions.insert_or_assign(channelId, std::unordered_set<JanusSession*>());
-        }
-        pendingViewerSessions[channelId].insert(session.Session.get());
+        channel.State->PendingViewerSessions.insert(session.Session.get());
 
         // Tell the client that we're pending an active stream
         JsonPtr eventPtr(json_object());
@@ -796,7 +2026,7 @@ janus_plugin_result* JanusFtl::handleWatchMessage(ActiveSession& session, JsonPt
     }
 
     // Otherwise, we've got a live stream!
-    auto& stream = streams.at(channelId);
+    const std::shared_ptr<JanusStream>& stream = channel.State->Stream;
 
     // TODO allow user to request ICE restart (new offer)
 
@@ -806,7 +2036,7 @@ janus_plugin_result* JanusFtl::handleWatchMessage(ActiveSession& session, JsonPt
     stream->AddViewerSession(session.Session.get());
 
     // Send the JSEP to initiate the media connection
-    sendJsep(session, *stream, transaction);
+    sendJsep(*session.Session, *stream, transaction);
 
     return janus_plugin_result_new(JANUS_PLUGIN_OK_WAIT, NULL, NULL);
 }
@@ -817,7 +2047,160 @@ janus_plugin_result* JanusFtl::handleStartMessage(ActiveSession& session, JsonPt
     return janus_plugin_result_new(JANUS_PLUGIN_OK_WAIT, NULL, NULL);
 }
 
-int JanusFtl::sendJsep(const ActiveSession& session, const JanusStream& stream, char* transaction)
+json_t* JanusFtl::generateAdminErrorResponse(int errorCode, std::string errorMessage)
+{
+    json_t* response = json_object();
+    json_object_set_new(response, "error_code", json_integer(errorCode));
+    json_object_set_new(response, "error", json_string(errorMessage.c_str()));
+    return response;
+}
+
+json_t* JanusFtl::describeStreams(std::optional<ftl_channel_id_t> onlyChannelId)
+{
+    // Streams we ingest have stats of their own; streams relayed to us only have viewers
+    std::unordered_map<ftl_channel_id_t,
+        std::pair<FtlStreamStats, std::shared_ptr<const FtlKeyframe>>> ingestByChannel;
+    for (auto& streamInfo : ftlServer->GetAllStatsAndKeyframes())
+    {
+        ingestByChannel.try_emplace(streamInfo.first.first, std::move(streamInfo.second));
+    }
+
+    std::vector<ftl_channel_id_t> channelIds = onlyChannelId.has_value() ?
+        std::vector<ftl_channel_id_t> { onlyChannelId.value() } : channels.GetKeys();
+    std::sort(channelIds.begin(), channelIds.end());
+    const auto steadyNow = std::chrono::steady_clock::now();
+    json_t* streams = json_array();
+    for (const ftl_channel_id_t channelId : channelIds)
+    {
+        std::shared_ptr<JanusStream> stream;
+        {
+            LockedChannel channel = lockChannel(channelId, false);
+            if ((channel.State == nullptr) || (channel.State->Stream == nullptr))
+            {
+                continue;
+            }
+            stream = channel.State->Stream;
+        }
+
+        json_t* streamJs = json_object();
+        json_object_set_new(streamJs, "channel_id", json_integer(channelId));
+        json_object_set_new(streamJs, "stream_id", json_integer(stream->GetStreamId()));
+        json_object_set_new(streamJs, "viewers", json_integer(stream->GetViewerCount()));
+
+        json_t* shardsJs = json_array();
+        for (const JanusStream::ShardStats& shard : stream->GetShardStats())
+        {
+            json_t* shardJs = json_object();
+            json_object_set_new(shardJs, "viewers", json_integer(shard.ViewerCount));
+            json_object_set_new(shardJs, "audio_only_viewers",
+                json_integer(shard.AudioOnlyViewerCount));
+            json_object_set_new(shardJs, "fanout_worker", shard.FanoutWorkerIndex.has_value() ?
+                json_integer(shard.FanoutWorkerIndex.value()) : json_null());
+            json_array_append_new(shardsJs, shardJs);
+        }
+        json_object_set_new(streamJs, "shards", shardsJs);
+
+        json_t* relaysJs = json_array();
+        for (const JanusStream::RelayStats& relay : stream->GetRelayStats())
+        {
+            json_t* relayJs = json_object();
+            json_object_set_new(relayJs, "target", json_string(relay.TargetHostname.c_str()));
+            json_object_set_new(relayJs, "queued_packets",
+                json_integer(relay.Queue.QueuedPackets));
+            json_object_set_new(relayJs, "sent_packets", json_integer(relay.Queue.SentPackets));
+            json_object_set_new(relayJs, "dropped_packets",
+                json_integer(relay.Queue.DroppedPackets));
+            json_array_append_new(relaysJs, relayJs);
+        }
+        json_object_set_new(streamJs, "relays", relaysJs);
+
+        auto ingestIt = ingestByChannel.find(channelId);
+        if (ingestIt == ingestByChannel.end())
+        {
+            json_object_set_new(streamJs, "ingest", json_null());
+            json_object_set_new(streamJs, "keyframe", json_null());
+            json_array_append_new(streams, streamJs);
+            continue;
+        }
+        const FtlStreamStats& stats = ingestIt->second.first;
+        json_t* ingestJs = json_object();
+        json_object_set_new(ingestJs, "duration_seconds", json_integer(stats.DurationSeconds));
+        json_object_set_new(ingestJs, "bitrate_bps", json_integer(stats.RollingAverageBitrateBps));
+        json_object_set_new(ingestJs, "packets_received", json_integer(stats.PacketsReceived));
+        json_object_set_new(ingestJs, "packets_nacked", json_integer(stats.PacketsNacked));
+        json_object_set_new(ingestJs, "packets_lost", json_integer(stats.PacketsLost));
+        json_object_set_new(ingestJs, "bytes_received", json_integer(stats.BytesReceived));
+        json_object_set_new(ingestJs, "packet_buffer", json_pack("{sIsI}",
+            "buffered", static_cast<json_int_t>(stats.PacketsBuffered),
+            "capacity", static_cast<json_int_t>(stats.PacketBufferCapacity)));
+        json_object_set_new(ingestJs, "nacks", json_pack("{sIsI}",
+            "queued", static_cast<json_int_t>(stats.NacksQueued),
+            "outstanding", static_cast<json_int_t>(stats.NacksOutstanding)));
+        json_object_set_new(ingestJs, "memory", json_pack("{sIsIsI}",
+            "bytes", static_cast<json_int_t>(stats.MemoryBytes),
+            "budget_bytes", static_cast<json_int_t>(stats.MemoryBudgetBytes),
+            "keyframes_dropped", static_cast<json_int_t>(stats.KeyframesDropped)));
+        json_object_set_new(ingestJs, "packets_over_bitrate_limit",
+            json_integer(stats.PacketsOverBitrateLimit));
+        json_object_set_new(ingestJs, "rtt_ms", json_integer(stats.RoundTripTimeMs));
+        json_object_set_new(ingestJs, "sender_reported_packets",
+            json_integer(stats.SenderReportedPackets));
+        json_object_set_new(ingestJs, "reorder", json_pack("{sIsI}",
+            "packets_dropped_late", static_cast<json_int_t>(stats.PacketsDroppedLate),
+            "duplicate_packets_dropped", static_cast<json_int_t>(stats.DuplicatePacketsDropped)));
+        json_object_set_new(ingestJs, "reader", json_pack("{sIsI}",
+            "thread_id", static_cast<json_int_t>(stats.ReaderThreadId),
+            "cpu", static_cast<json_int_t>(stats.ReaderCpu)));
+        json_object_set_new(streamJs, "ingest", ingestJs);
+
+        const std::shared_ptr<const FtlKeyframe>& keyframe = ingestIt->second.second;
+        if ((keyframe == nullptr) || (keyframe->Generation == 0))
+        {
+            json_object_set_new(streamJs, "keyframe", json_null());
+        }
+        else
+        {
+            size_t keyframeBytes = 0;
+            for (const PacketBuffer& packet : keyframe->Packets)
+            {
+                keyframeBytes += packet.Size();
+            }
+            json_t* keyframeJs = json_object();
+            json_object_set_new(keyframeJs, "generation", json_integer(keyframe->Generation));
+            json_object_set_new(keyframeJs, "packets", json_integer(keyframe->Packets.size()));
+            json_object_set_new(keyframeJs, "bytes", json_integer(keyframeBytes));
+            json_object_set_new(keyframeJs, "age_ms", json_integer(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    steadyNow - keyframe->CapturedTime).count()));
+            json_object_set_new(streamJs, "keyframe", keyframeJs);
+        }
+        json_array_append_new(streams, streamJs);
+    }
+    return streams;
+}
+
+json_t* JanusFtl::describeFanoutWorkers()
+{
+    json_t* workers = json_array();
+    if (viewerFanoutPool == nullptr)
+    {
+        return workers;
+    }
+    const std::vector<ThreadPlacement::Snapshot> placements =
+        viewerFanoutPool->GetWorkerPlacements();
+    const std::vector<int> numaNodes = viewerFanoutPool->GetWorkerNumaNodes();
+    for (size_t i = 0; i < placements.size(); ++i)
+    {
+        json_array_append_new(workers, json_pack("{sIsIsIsI}",
+            "worker", static_cast<json_int_t>(i),
+            "thread_id", static_cast<json_int_t>(placements[i].ThreadId),
+            "cpu", static_cast<json_int_t>(placements[i].Cpu),
+            "numa_node", static_cast<json_int_t>(numaNodes.at(i))));
+    }
+    return workers;
+}
+
+int JanusFtl::sendJsep(const JanusSession& session, const JanusStream& stream, char* transaction)
 {
     // Prepare JSEP payload
     std::string sdpOffer = generateSdpOffer(session, stream);
@@ -832,14 +2215,14 @@ int JanusFtl::sendJsep(const ActiveSession& session, const JanusStream& stream,
 
     // Push response
     return janusCore->push_event(
-        session.Session->GetJanusPluginSessionHandle(),
+        session.GetJanusPluginSessionHandle(),
         pluginHandle,
         transaction,
         eventPtr.get(),
         jsepPtr.get());
 }
 
-std::string JanusFtl::generateSdpOffer(const ActiveSession& session, const JanusStream& stream)
+std::string JanusFtl::generateSdpOffer(const JanusSession& session, const JanusStream& stream)
 {
     // https://tools.ietf.org/html/rfc4566
 
@@ -848,7 +2231,7 @@ std::string JanusFtl::generateSdpOffer(const ActiveSession& session, const Janus
     // Session description
     offerStream <<  
         "v=0\r\n" <<
-        "o=- " << session.Session->GetSdpSessionId() << " " << session.Session->GetSdpVersion() << " IN IP4 127.0.0.1\r\n" <<
+        "o=- " << session.GetSdpSessionId() << " " << session.GetSdpVersion() << " IN IP4 127.0.0.1\r\n" <<
         "s=Channel " << stream.GetChannelId() << "\r\n";
 
     // Audio media description
@@ -866,8 +2249,8 @@ std::string JanusFtl::generateSdpOffer(const ActiveSession& session, const Janus
             "a=extmap:1 urn:ietf:params:rtp-hdrext:sdes:mid\r\n";
     }
 
-    // Video media description
-    if (stream.GetMetadata().HasVideo)
+    // Video media description, left out entirely for audio-only viewers
+    if (stream.GetMetadata().HasVideo && !session.GetIsAudioOnly())
     {
         std::string videoPayloadType = std::to_string(stream.GetMetadata().VideoPayloadType);
         std::string videoCodec = 
@@ -913,7 +2296,7 @@ ConnectionResult JanusFtl::onOrchestratorOutro(ConnectionOutroPayload payload)
 
 ConnectionResult JanusFtl::onOrchestratorStreamRelay(ConnectionRelayPayload payload)
 {
-    std::unique_lock lock(streamDataMutex);
+    LockedChannel channel = lockChannel(payload.ChannelId, false);
     if (payload.IsStartRelay)
     {
         spdlog::info("Start Stream Relay request from Orchestrator: "
@@ -921,7 +2304,7 @@ ConnectionResult JanusFtl::onOrchestratorStreamRelay(ConnectionRelayPayload payl
             payload.TargetHostname);
 
         // Do we have an active stream?
-        if (!streams.contains(payload.ChannelId))
+        if ((channel.State == nullptr) || (channel.State->Stream == nullptr))
         {
             spdlog::error("Orchestrator requested a relay for channel that is not streaming."
                 "Target hostname: {}, Channel ID: {}", payload.TargetHostname, payload.ChannelId);
@@ -930,12 +2313,14 @@ ConnectionResult JanusFtl::onOrchestratorStreamRelay(ConnectionRelayPayload payl
                     .IsSuccess = false,
                 };
         }
-        auto& stream = streams.at(payload.ChannelId);
+        const std::shared_ptr<JanusStream>& stream = channel.State->Stream;
 
-        // Start the relay now!
+        // Start the relay now! It connects on its own thread, so relays to several targets
+        // start up side by side. If it fails, the report thread takes it back out.
         auto relayClient = std::make_unique<FtlClient>(payload.TargetHostname, payload.ChannelId,
-            payload.StreamKey);
-        Result<void> connectResult = relayClient->ConnectAsync(FtlClient::ConnectMetadata
+            payload.StreamKey, relayHostnameResolver, stream->GetRelayGroup(),
+            configuration->GetRelayPacingInterval(), configuration->GetRelaySocketBinding());
+        relayClient->ConnectAsync(FtlClient::ConnectMetadata
             {
                 .VendorName = "janus-ftl-plugin",
                 .VendorVersion = "0.0.0", // TODO: Versioning
@@ -952,16 +2337,6 @@ ConnectionResult JanusFtl::onOrchestratorStreamRelay(ConnectionRelayPayload payl
                 .AudioPayloadType = stream->GetMetadata().AudioPayloadType,
                 .AudioIngestSsrc = stream->GetMetadata().AudioSsrc,
             });
-        if (connectResult.IsError)
-        {
-            spdlog::error("Failed to connect to relay target {} for channel {}: {}",
-                payload.TargetHostname, payload.ChannelId, connectResult.ErrorMessage);
-            return ConnectionResult
-                {
-                    .IsSuccess = false,
-                };
-        }
-
         stream->AddRelayClient(payload.TargetHostname, std::move(relayClient));
         
         return ConnectionResult
@@ -977,13 +2352,13 @@ ConnectionResult JanusFtl::onOrchestratorStreamRelay(ConnectionRelayPayload payl
 
             
         // Do we have an active stream?
-        if (!streams.contains(payload.ChannelId))
+        if ((channel.State == nullptr) || (channel.State->Stream == nullptr))
         {
             spdlog::warn("Orchestrator requested to stop a relay for channel that is not streaming."
                 "Target hostname: {}, Channel ID: {}", payload.TargetHostname, payload.ChannelId);
             return ConnectionResult { .IsSuccess = true };
         }
-        auto& stream = streams.at(payload.ChannelId);
+        const std::shared_ptr<JanusStream>& stream = channel.State->Stream;
         if (stream->GetStreamId() != payload.StreamId)
         {
             spdlog::warn("Orchestrator requested to stop a relay for a stream that no longer exists: "
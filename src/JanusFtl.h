@@ -15,12 +15,21 @@
 #include "FtlServer.h"
 #include "JanusSession.h"
 #include "JanusStream.h"
+#include "ServiceConnections/AsyncServiceConnection.h"
+#include "ServiceConnections/HmacKeyCache.h"
+#include "ServiceConnections/MetadataReportPolicy.h"
 #include "ServiceConnections/ServiceConnection.h"
+#include "Utilities/FanoutWorkerPool.h"
 #include "Utilities/FtlTypes.h"
 #include "Utilities/JanssonPtr.h"
+#include "Utilities/LingerList.h"
+#include "Utilities/Metrics.h"
+#include "Utilities/NodeLoadEstimator.h"
+#include "Utilities/OverloadController.h"
 #include "Utilities/Result.h"
+#include "Utilities/StripedMap.h"
 #include "Utilities/Watchdog.h"
-#include "VideoDecoders/VideoDecoder.h"
+#include "VideoDecoders/ThumbnailWorkerPool.h"
 
 extern "C"
 {
@@ -29,15 +38,18 @@ extern "C"
 }
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <FtlOrchestrationClient.h>
+#include <functional>
 #include <future>
+#include <httplib.h>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
-#include <shared_mutex>
 #include <thread>
 
 // Forward declarations
@@ -56,6 +68,7 @@ public:
     static const unsigned int FTL_PLUGIN_ERROR_INVALID_REQUEST   = 452;
     static const unsigned int FTL_PLUGIN_ERROR_MISSING_ELEMENT   = 453;
     static const unsigned int FTL_PLUGIN_ERROR_NO_SUCH_STREAM    = 455;
+    static const unsigned int FTL_PLUGIN_ERROR_OVERLOADED        = 456;
     static const unsigned int FTL_PLUGIN_ERROR_UNKNOWN           = 470;
 
     /* Constructor/Destructor */
@@ -87,9 +100,64 @@ private:
     /* Private types */
     struct ActiveSession
     {
+        // Guards WatchingChannelId. Always taken before the lock of any ChannelState.
+        std::mutex Mutex;
         std::optional<ftl_channel_id_t> WatchingChannelId;
         std::unique_ptr<JanusSession> Session;
     };
+    /**
+     * @brief The stream and viewers of a single channel, guarded by the channel's own lock
+     */
+    struct ChannelState
+    {
+        std::mutex Mutex;
+        std::shared_ptr<JanusStream> Stream;
+        // Viewers waiting for this channel to start streaming
+        std::unordered_set<JanusSession*> PendingViewerSessions;
+        // Set once an unused record has been removed from the channel map, after which it must
+        // be looked up again
+        bool IsRetired = false;
+    };
+    /**
+     * @brief A ChannelState (or null if there isn't one) along with a held lock on it
+     */
+    struct LockedChannel
+    {
+        std::shared_ptr<ChannelState> State;
+        std::unique_lock<std::mutex> Lock;
+    };
+    /**
+     * @brief What the service report thread has already learned from a stream's keyframes
+     */
+    struct ReportedKeyframeState
+    {
+        // Generation of the keyframe last queued for decoding, 0 if none has been queued
+        uint64_t DecodedGeneration = 0;
+        // Dimensions of the most recently decoded keyframe, 0 if none has been decoded
+        uint16_t VideoWidth = 0;
+        uint16_t VideoHeight = 0;
+        // Generation of the keyframe last queued for a preview, 0 if none has been queued
+        uint64_t ThumbnailGeneration = 0;
+        std::chrono::steady_clock::time_point LastThumbnailTime;
+    };
+
+    /**
+     * @brief A metadata report that has been sent to the service, awaiting its results
+     */
+    struct PendingMetadataReport
+    {
+        std::future<std::vector<Result<ServiceConnection::ServiceResponse>>> Results;
+        // Channel and stream of each update, in the order they were sent
+        std::vector<std::pair<ftl_channel_id_t, ftl_stream_id_t>> Streams;
+        // Previews to send for streams that are still live once the report succeeds
+        std::unordered_map<ftl_stream_id_t, std::vector<uint8_t>> JpegsByStream;
+    };
+
+    /* Constants */
+    // How often the handoff thread checks whether we're stopping while waiting for a successor
+    static constexpr std::chrono::milliseconds HANDOFF_ACCEPT_TIMEOUT { 200 };
+    // How often the overload thread samples viewer fanout
+    static constexpr std::chrono::milliseconds OVERLOAD_SAMPLE_INTERVAL { 250 };
 
     /* Private fields */
     janus_plugin* pluginHandle;
@@ -98,21 +166,68 @@ private:
     std::unique_ptr<Configuration> configuration;
     std::shared_ptr<FtlConnection> orchestrationClient;
     std::shared_ptr<ServiceConnection> serviceConnection;
-    std::unordered_map<VideoCodecKind, std::unique_ptr<VideoDecoder>> videoDecoders;
+    // Makes calls to the service connection on its own threads
+    std::unique_ptr<AsyncServiceConnection> asyncServiceConnection;
+    // Caches HMAC keys from the service connection, or null if caching is disabled
+    std::unique_ptr<HmacKeyCache> hmacKeyCache;
+    // Decodes keyframes for dimensions and previews off of the service report thread
+    std::unique_ptr<ThumbnailWorkerPool> thumbnailPool;
+    // Metrics served over HTTP, or null if metrics are disabled
+    std::shared_ptr<MetricsRegistry> metrics;
+    std::unique_ptr<httplib::Server> metricsServer;
+    std::thread metricsServerThread;
     uint32_t maxAllowedBitsPerSecond = 0;
     uint32_t rollingSizeAvgMs = 2000;
     std::chrono::milliseconds metadataReportInterval = std::chrono::milliseconds::min();
+    std::chrono::milliseconds thumbnailInterval = std::chrono::milliseconds::min();
     std::atomic<bool> isStopping = false;
     std::thread serviceReportThread;
     std::future<void> serviceReportThreadEndedFuture;
     std::mutex threadShutdownMutex;
     std::condition_variable threadShutdownConditionVariable;
+    // Waits for a successor to hand live streams off to, if a handoff socket is configured
+    int handoffListenHandle = -1;
+    std::thread handoffThread;
+    // Connects to the service and Orchestrator when they're set up in the background
+    std::thread serviceInitThread;
+    // Ready once the service connection can be used, holding the exception if it couldn't be
+    std::promise<void> serviceReadyPromise;
+    std::shared_future<void> serviceReady = serviceReadyPromise.get_future().share();
+    // Guards orchestrationClient being connected, and messages waiting for it to be
+    std::mutex orchestratorConnectMutex;
+    bool isOrchestratorConnected = false;
+    // Sent in order once the Orchestrator is connected, dropped if there isn't one
+    std::vector<std::function<void(FtlConnection&)>> deferredOrchestratorMessages;
     std::unique_ptr<Watchdog> watchdog;
-    // Stream/Session/Relay data
-    std::shared_mutex streamDataMutex; // Covers shared access to streams and sessions
-    std::unordered_map<ftl_channel_id_t, std::shared_ptr<JanusStream>> streams;
-    std::unordered_map<janus_plugin_session*, ActiveSession> sessions;
-    std::unordered_map<ftl_channel_id_t, std::unordered_set<JanusSession*>> pendingViewerSessions;
+    // Only accessed by the service report thread
+    std::unordered_map<ftl_stream_id_t, ReportedKeyframeState> reportedKeyframeStates;
+    // Picks which streams are worth reporting each cycle, only accessed by the service report
+    // thread
+    std::unique_ptr<MetadataReportPolicy> metadataReportPolicy;
+    // Shared by every stream to send packets to viewers, or null to send on the ingest thread
+    std::shared_ptr<FanoutWorkerPool> viewerFanoutPool;
+    // NUMA nodes new streams are placed on in turn, or empty to leave streams unplaced
+    std::vector<int> streamNumaNodes;
+    std::atomic<size_t> nextStreamNumaNodeIndex { 0 };
+    // Turns this node's load into the figure reported to the Orchestrator
+    std::unique_ptr<NodeLoadEstimator> nodeLoadEstimator;
+    // Only accessed by the service report thread
+    CpuUsageSampler cpuUsageSampler;
+    // Sheds viewers when fanout falls behind, or null if overload shedding is off
+    std::shared_ptr<OverloadController> overloadController;
+    std::thread overloadThread;
+    // Shared by relay clients, so relaying to the same edges again doesn't wait on DNS
+    const std::shared_ptr<HostnameResolver> relayHostnameResolver =
+        std::make_shared<HostnameResolver>();
+    // Channels an Edge node is still subscribed to after their last viewer left, or null if we
+    // unsubscribe right away. Locked after any channel's lock.
+    std::unique_ptr<LingerList<ftl_channel_id_t>> lingeringRelays;
+    // Channels an Edge node stays subscribed to whether or not anyone is watching
+    std::unordered_set<ftl_channel_id_t> prewarmChannelIds;
+    // Stream/Session/Relay data, locked per channel and per session so that traffic on one
+    // channel doesn't hold up any other
+    StripedMap<ftl_channel_id_t, ChannelState> channels;
+    StripedMap<janus_plugin_session*, ActiveSession> sessions;
 
     /* Private methods */
     // FtlServer Callbacks
@@ -124,22 +239,88 @@ private:
     void initVideoDecoders();
     void initOrchestratorConnection();
     void initServiceConnection();
+    /**
+     * @brief Connects to the Orchestrator and service, which may wait on them to respond
+     */
+    void connectServices();
+    void connectServicesInBackground();
+    /**
+     * @brief Waits for the service connection to be ready, if it's being set up in the background
+     */
+    Result<void> awaitServiceReady();
+    /**
+     * @brief
+     *  Sends a message to the Orchestrator, if there is one, holding it until the Orchestrator
+     *  is connected if it's still being connected in the background
+     */
+    void sendToOrchestrator(std::function<void(FtlConnection&)> send);
+    void initEdgeRelaySubscriptions();
+    void initStreamNumaNodes();
     void initServiceReportThread();
+    void initOverloadController();
+    void overloadThreadBody();
+    void initMetricsServer();
+    void stopMetricsServer();
+    // Handing off to and taking over from other instances
+    /**
+     * @param predecessorHandle
+     *  set to the connection streams are then received on if the sockets were handed over,
+     *  which adoptHandedOffStreams closes
+     */
+    std::optional<FtlHandoff> receiveHandoffSockets(int& predecessorHandle);
+    void adoptHandedOffStreams(int predecessorHandle);
+    void initHandoffListener();
+    void handoffThreadBody();
+    bool handOffToSuccessor(int socketHandle);
     // Service report thread body
     void serviceReportThreadBody(std::promise<void>&& threadEndedPromise);
+    void processMetadataReportResults(PendingMetadataReport& report,
+        std::list<std::pair<ftl_channel_id_t, ftl_stream_id_t>>& streamsStopped);
+    void reportNodeLoad(const std::unordered_map<ftl_channel_id_t, uint64_t>& bitrateByChannel,
+        const std::unordered_map<ftl_channel_id_t, uint32_t>& viewersByChannel,
+        const std::unordered_map<ftl_channel_id_t, uint32_t>& relaysByChannel);
+    // Metrics
+    void collectIngestMetrics(MetricsRegistry::Writer& writer);
+    // Channel handling
+    LockedChannel lockChannel(ftl_channel_id_t channelId, bool createIfMissing);
+    void retireChannelIfUnused(ftl_channel_id_t channelId);
+    // Edge relay subscriptions, sent while holding the channel's lock
+    void subscribeToChannel(ftl_channel_id_t channelId);
+    void unsubscribeFromChannel(ftl_channel_id_t channelId);
+    void unsubscribeIfUnused(ftl_channel_id_t channelId);
+    uint64_t getRelayBitrate(ftl_channel_id_t channelId, const ChannelState& channel);
+    void unsubscribeExpiredRelays();
     // Stream handling
-    void endStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId,
-        const std::unique_lock<std::shared_mutex>& streamDataLock);
+    std::optional<int> nextStreamNumaNode();
+    /**
+     * @brief Starts recording a stream, if recording is configured and can be started
+     */
+    std::unique_ptr<StreamRecorder> startRecording(ftl_channel_id_t channelId,
+        ftl_stream_id_t streamId, const MediaMetadata& mediaMetadata);
+    void publishStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId);
+    /**
+     * @param isHandedOff
+     *  whether the stream lives on in another instance, in which case it only ends here
+     *  without the Orchestrator or service being told
+     */
+    void endStream(ftl_channel_id_t channelId, ftl_stream_id_t streamId, ChannelState& channel,
+        const std::unique_lock<std::mutex>& channelLock, bool isHandedOff = false);
     // Packet handling
     void handlePsfbRtcpPacket(janus_plugin_session* handle, janus_rtcp_header* packet);
     // Message handling
     janus_plugin_result* generateMessageErrorResponse(int errorCode, std::string errorMessage);
+    janus_plugin_result* generateOverloadedErrorResponse();
     janus_plugin_result* handleWatchMessage(ActiveSession& session, JsonPtr message,
         char* transaction);
     janus_plugin_result* handleStartMessage(ActiveSession& session, JsonPtr message,
         char* transaction);
-    int sendJsep(const ActiveSession& session, const JanusStream& stream, char* transaction);
-    std::string generateSdpOffer(const ActiveSession& session, const JanusStream& stream);
+    int sendJsep(const JanusSession& session, const JanusStream& stream, char* transaction);
+    // Admin message handling, which only reads stats that are kept without locks on the
+    // packet path
+    json_t* generateAdminErrorResponse(int errorCode, std::string errorMessage);
+    json_t* describeStreams(std::optional<ftl_channel_id_t> onlyChannelId);
+    json_t* describeFanoutWorkers();
+    std::string generateSdpOffer(const JanusSession& session, const JanusStream& stream);
     // Orchestrator message handling
     void onOrchestratorConnectionClosed();
     ConnectionResult onOrchestratorIntro(ConnectionIntroPayload payload);
@@ -10,6 +10,8 @@
 
 #include "JanusSession.h"
 
+#include "Rtp/RtpPacket.h"
+
 extern "C"
 {
     #include <rtp.h>
@@ -26,26 +28,78 @@ JanusSession::JanusSession(janus_plugin_session* handle, janus_callbacks* janusC
 #pragma endregion
 
 #pragma region Public methods
-void JanusSession::SendRtpPacket(const std::vector<std::byte>& packet,
-    const MediaMetadata& mediaMetadata)
+void JanusSession::SendRtpPacket(PreparedRtpPacket& packet)
+{
+    if (!isStarted || !packet.IsValid())
+    {
+        return;
+    }
+
+    std::unique_lock sendLock(sendMutex);
+    if (packet.IsVideo() && lastBurstSequence.has_value())
+    {
+        const rtp_sequence_num_t sequence = packet.GetSequenceNum();
+        if (static_cast<int16_t>(sequence - lastBurstSequence.value()) <= 0)
+        {
+            // Already sent as part of the burst
+            return;
+        }
+        lastBurstSequence = std::nullopt;
+    }
+    relayPacket(packet, sendLock);
+}
+
+void JanusSession::SendKeyframeBurst(const std::vector<PacketBuffer>& packets,
+    rtp_payload_type_t videoPayloadType)
 {
-    if (!isStarted)
+    if (!isStarted || packets.empty())
+    {
+        return;
+    }
+
+    std::unique_lock sendLock(sendMutex);
+    const auto now = std::chrono::steady_clock::now();
+    if (lastKeyframeBurstTime.has_value() &&
+        ((now - lastKeyframeBurstTime.value()) < KEYFRAME_BURST_MIN_INTERVAL))
     {
         return;
     }
-    
-    // Sadly, we can't avoid a copy here because the janus_plugin_rtp struct doesn't take a
-    // const buffer. So allocate some storage to copy.
-    std::byte packetBuffer[2048] { std::byte(0) };
-    std::copy(packet.begin(), packet.end(), packetBuffer);
-
-    const janus_rtp_header* rtpHeader = reinterpret_cast<janus_rtp_header*>(&packetBuffer[0]);
-    bool isVideoPacket = (rtpHeader->type == mediaMetadata.VideoPayloadType);
+    lastKeyframeBurstTime = now;
+
+    // The burst jumps back in time from anything we've already sent, so renumber it to
+    // follow on from that. Live packets continue on from the burst with the same offset.
+    if (videoRewriter.HasSentPackets())
+    {
+        videoRewriter.Rebase(KEYFRAME_BURST_TIMESTAMP_STEP);
+    }
+    for (const PacketBuffer& packet : packets)
+    {
+        PreparedRtpPacket preparedPacket(packet, videoPayloadType);
+        if (preparedPacket.IsValid())
+        {
+            relayPacket(preparedPacket, sendLock);
+        }
+    }
+    lastBurstSequence = RtpPacket::GetRtpSequence(packets.back());
+}
+#pragma endregion
+
+#pragma region Private methods
+void JanusSession::relayPacket(PreparedRtpPacket& packet,
+    const std::unique_lock<std::mutex>& sendLock)
+{
+    // The janus_plugin_rtp struct doesn't take a const buffer, so we hand it the prepared
+    // packet's mutable copy, which is shared with every other viewer of this packet.
+    std::span<std::byte> packetBytes = packet.MutableBytes();
+    if (packet.IsVideo())
+    {
+        videoRewriter.Rewrite(packetBytes);
+    }
     janus_plugin_rtp janusRtp = 
     {
-        .video = isVideoPacket,
-        .buffer = reinterpret_cast<char*>(&packetBuffer[0]),
-        .length = static_cast<uint16_t>(packet.size())
+        .video = packet.IsVideo(),
+        .buffer = reinterpret_cast<char*>(packetBytes.data()),
+        .length = packet.GetLength()
     };
     janus_plugin_rtp_extensions_reset(&janusRtp.extensions);
     if (handle->gateway_handle != nullptr)
@@ -66,6 +120,16 @@ void JanusSession::SetIsStarted(bool value)
     isStarted = value;
 }
 
+bool JanusSession::GetIsAudioOnly() const
+{
+    return isAudioOnly;
+}
+
+void JanusSession::SetIsAudioOnly(bool value)
+{
+    isAudioOnly = value;
+}
+
 janus_plugin_session* JanusSession::GetJanusPluginSessionHandle() const
 {
     return handle;
@@ -11,8 +11,14 @@
 #pragma once
 
 #include "FtlStream.h"
+#include "Rtp/PreparedRtpPacket.h"
+#include "Rtp/RtpHeaderRewriter.h"
 #include "Utilities/FtlTypes.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 extern "C"
@@ -27,21 +33,52 @@ public:
     JanusSession(janus_plugin_session* handle, janus_callbacks* janusCore);
 
     /* Public methods */
-    void SendRtpPacket(const std::vector<std::byte>& packet, const MediaMetadata& mediaMetadata);
+    void SendRtpPacket(PreparedRtpPacket& packet);
+    /**
+     * @brief
+     *  Sends cached video packets starting from the latest keyframe, so the viewer can start
+     *  decoding without waiting for the next one. Live video packets that were already in the
+     *  burst are skipped afterwards. If video has already been sent, the burst and everything
+     *  after it are renumbered to follow on from it. Bursts closer together than
+     *  KEYFRAME_BURST_MIN_INTERVAL are ignored.
+     */
+    void SendKeyframeBurst(const std::vector<PacketBuffer>& packets,
+        rtp_payload_type_t videoPayloadType);
     void ResetRtpSwitchingContext();
     
     /* Getters/setters */
     bool GetIsStarted() const;
     void SetIsStarted(bool value);
+    /**
+     * @brief Whether this viewer only wants audio, and is never sent video
+     */
+    bool GetIsAudioOnly() const;
+    void SetIsAudioOnly(bool value);
     janus_plugin_session* GetJanusPluginSessionHandle() const;
     int64_t GetSdpSessionId() const;
     int64_t GetSdpVersion() const;
 
 private:
-    bool isStarted = false;
+    /* Constants */
+    static constexpr std::chrono::milliseconds KEYFRAME_BURST_MIN_INTERVAL { 3000 };
+    // Gap left between the last video frame sent and a burst, in 90kHz units (one 30fps frame)
+    static constexpr rtp_timestamp_t KEYFRAME_BURST_TIMESTAMP_STEP = 3000;
+
+    /* Private fields */
+    std::atomic<bool> isStarted = false;
+    std::atomic<bool> isAudioOnly = false;
     bool isStopping = false;
     janus_plugin_session* handle;
     janus_callbacks* janusCore;
     int64_t sdpSessionId;
     int64_t sdpVersion;
+    // Guards everything below, which is touched by both live delivery and keyframe bursts
+    std::mutex sendMutex;
+    RtpHeaderRewriter videoRewriter;
+    // Last sequence number sent in a keyframe burst, until live video catches up to it
+    std::optional<rtp_sequence_num_t> lastBurstSequence;
+    std::optional<std::chrono::steady_clock::time_point> lastKeyframeBurstTime;
+
+    /* Private methods */
+    void relayPacket(PreparedRtpPacket& packet, const std::unique_lock<std::mutex>& sendLock);
 };
\ No newline at end of file
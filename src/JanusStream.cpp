@@ -7,107 +7,397 @@
 
 #include "JanusStream.h"
 
+#include "Rtp/RtpPacket.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
 #pragma region Constructor/Destructor
 JanusStream::JanusStream(
     ftl_channel_id_t channelId,
     ftl_stream_id_t streamId,
-    MediaMetadata mediaMetadata) :
+    MediaMetadata mediaMetadata,
+    std::shared_ptr<FanoutWorkerPool> fanoutPool,
+    bool relayKeyframeBurst,
+    bool useRelayGroup,
+    std::chrono::milliseconds relayPacingInterval,
+    std::shared_ptr<MetricsRegistry> metrics,
+    std::optional<int> numaNode,
+    std::unique_ptr<StreamRecorder> recorder,
+    std::shared_ptr<OverloadController> overloadController) :
     channelId(channelId),
     streamId(streamId),
-    mediaMetadata(mediaMetadata)
-{ }
+    mediaMetadata(mediaMetadata),
+    isKeyframePayload(GetKeyframePayloadDetector(mediaMetadata.VideoCodec)),
+    fanoutPool(fanoutPool),
+    relayKeyframeBurst(relayKeyframeBurst),
+    relayGroup(useRelayGroup ?
+        std::make_shared<DatagramFanoutQueue>(DatagramFanoutQueue::DEFAULT_CAPACITY,
+            relayKeyframeBurst, relayPacingInterval) :
+        nullptr),
+    numaNode(numaNode),
+    metrics(std::move(metrics)),
+    recorder(std::move(recorder)),
+    overloadController(std::move(overloadController))
+{
+    if (this->metrics != nullptr)
+    {
+        viewerFanoutDuration = this->metrics->AddHistogram("ftl_viewer_fanout_seconds",
+            "Time taken to send a packet to each viewer in a fanout shard",
+            { { "channel", std::to_string(channelId) } });
+        relayCollectorId = this->metrics->AddCollector(
+            [this](MetricsRegistry::Writer& writer)
+            {
+                collectRelayMetrics(writer);
+                collectRecordingMetrics(writer);
+            });
+        if constexpr (PacketLatencyTracer::IS_ENABLED)
+        {
+            latencyTracer = std::make_unique<PacketLatencyTracer>(this->metrics, channelId);
+        }
+    }
+
+
+    if (fanoutPool == nullptr)
+    {
+        viewerShards.push_back(std::make_unique<ViewerShard>());
+        return;
+    }
+
+    // One shard per worker, so a busy stream can use every worker in the pool
+    const std::vector<int> workerNumaNodes = fanoutPool->GetWorkerNumaNodes();
+    for (size_t i = 0; i < fanoutPool->GetWorkerCount(); ++i)
+    {
+        auto shard = std::make_unique<ViewerShard>();
+        ViewerShard& shardRef = *shard;
+        shard->FanoutRegistration = fanoutPool->Register(
+            [this, &shardRef](const PacketBuffer& packet)
+            {
+                sendToShard(shardRef, packet);
+            });
+        shard->NumaNode = workerNumaNodes.at(fanoutPool->GetWorkerIndex(shard->FanoutRegistration));
+        viewerShards.push_back(std::move(shard));
+    }
+    relayFanoutRegistration = fanoutPool->Register(
+        [this](const PacketBuffer& packet)
+        {
+            sendToRelays(packet);
+        });
+}
+
+JanusStream::~JanusStream()
+{
+    if (metrics != nullptr)
+    {
+        metrics->RemoveCollector(relayCollectorId);
+    }
+    if (fanoutPool != nullptr)
+    {
+        // Make sure no worker is still delivering to us before our shards are destroyed
+        for (const auto& shard : viewerShards)
+        {
+            fanoutPool->Unregister(shard->FanoutRegistration);
+        }
+        fanoutPool->Unregister(relayFanoutRegistration);
+    }
+}
 #pragma endregion
 
 #pragma region Public methods
-void JanusStream::SendRtpPacket(const std::vector<std::byte>& packet)
+void JanusStream::SendRtpPacket(const PacketBuffer& packet)
+{
+    if (latencyTracer != nullptr)
+    {
+        latencyTracer->Record(PacketLatencyTracer::Stage::FanoutQueued, packet);
+    }
+    const BoundedPacketQueue::PacketKind kind = packetKind(packet);
+    if (kind != BoundedPacketQueue::PacketKind::Independent)
+    {
+        std::lock_guard lock(gopCacheMutex);
+        gopCache.Add(packet, (kind == BoundedPacketQueue::PacketKind::Keyframe));
+    }
+    if (recorder != nullptr)
+    {
+        // Only queues the packet, the disk is written from the recorder's own thread
+        recorder->SendRtpPacket(packet);
+    }
+
+    if (fanoutPool == nullptr)
+    {
+        sendToShard(*viewerShards.front(), packet);
+        sendToRelays(packet);
+        return;
+    }
+
+    // Each enqueue only shares a reference to the packet, workers do the actual sending.
+    // Shards with nobody but audio-only viewers are left out of video fanout entirely.
+    const bool isVideo = (kind != BoundedPacketQueue::PacketKind::Independent);
+    for (const auto& shard : viewerShards)
+    {
+        if ((shard->SessionCount.load(std::memory_order_relaxed) > 0) ||
+            (!isVideo && (shard->AudioOnlySessionCount.load(std::memory_order_relaxed) > 0)))
+        {
+            fanoutPool->Enqueue(shard->FanoutRegistration, packet);
+        }
+    }
+    if (relayGroup != nullptr)
+    {
+        // Already just a single enqueue, no need to hand it to a worker first
+        sendToRelays(packet);
+    }
+    else if (relayCount.load(std::memory_order_relaxed) > 0)
+    {
+        fanoutPool->Enqueue(relayFanoutRegistration, packet);
+    }
+}
+
+std::optional<int> JanusStream::GetNumaNode() const
 {
-    std::lock_guard lock(mutex);
+    std::lock_guard lock(viewerMembershipMutex);
+    return numaNode;
+}
 
-    for (const auto& session : viewerSessions)
+void JanusStream::SetNumaNode(int numaNode)
+{
+    std::lock_guard lock(viewerMembershipMutex);
+    if (this->numaNode == numaNode)
     {
-        session->SendRtpPacket(packet, mediaMetadata);
+        return;
     }
+    this->numaNode = numaNode;
 
-    for (const auto& relay : relays)
+    // Move existing viewers over too, so all of the stream's fanout stays on one node. Each is
+    // added to its new shard before leaving its old one, so while it moves it may be sent the
+    // same packet twice, but never misses one.
+    for (auto& sessionShard : viewerSessionShards)
     {
-        relay.Client->RelayPacket(packet);
+        JanusSession* session = sessionShard.first;
+        ViewerMembership& membership = sessionShard.second;
+        if (membership.Shard->NumaNode == numaNode)
+        {
+            continue;
+        }
+        ViewerShard* targetShard = emptiestShard();
+        if (targetShard->NumaNode != numaNode)
+        {
+            // No fanout workers on the node
+            return;
+        }
+        addToShard(*targetShard, session, membership.IsAudioOnly);
+        removeFromShard(*membership.Shard, session, membership.IsAudioOnly);
+        membership.Shard = targetShard;
     }
 }
 
 void JanusStream::AddViewerSession(JanusSession* session)
 {
-    std::lock_guard lock(mutex);
-    viewerSessions.insert(session);
+    std::lock_guard lock(viewerMembershipMutex);
+    if (viewerSessionShards.count(session) > 0)
+    {
+        return;
+    }
+
+    // Keep the shards balanced by placing new viewers in the emptiest one
+    ViewerShard* targetShard = emptiestShard();
+    const bool isAudioOnly = session->GetIsAudioOnly();
+    addToShard(*targetShard, session, isAudioOnly);
+    viewerSessionShards.emplace(session,
+        ViewerMembership { .Shard = targetShard, .IsAudioOnly = isAudioOnly });
 }
 
 size_t JanusStream::RemoveViewerSession(JanusSession* session)
 {
-    std::lock_guard lock(mutex);
-    return viewerSessions.erase(session);
+    std::lock_guard lock(viewerMembershipMutex);
+    auto it = viewerSessionShards.find(session);
+    if (it == viewerSessionShards.end())
+    {
+        return 0;
+    }
+
+    // Waits for any in-progress delivery to the shard, so the session is safe to destroy
+    removeFromShard(*it->second.Shard, session, it->second.IsAudioOnly);
+    viewerSessionShards.erase(it);
+    return 1;
 }
 
 std::unordered_set<JanusSession*> JanusStream::RemoveAllViewerSessions()
 {
-    std::lock_guard lock(mutex);
+    std::lock_guard lock(viewerMembershipMutex);
     std::unordered_set<JanusSession*> removedSessions;
-    viewerSessions.swap(removedSessions);
+    for (const auto& shard : viewerShards)
+    {
+        for (auto* sessionList : { &shard->Sessions, &shard->AudioOnlySessions })
+        {
+            sessionList->Update(
+                [&removedSessions](std::vector<JanusSession*>& sessions)
+                {
+                    removedSessions.insert(sessions.begin(), sessions.end());
+                    sessions.clear();
+                });
+        }
+        shard->SessionCount.store(0, std::memory_order_relaxed);
+        shard->AudioOnlySessionCount.store(0, std::memory_order_relaxed);
+    }
+    viewerSessionShards.clear();
     return removedSessions;
 }
 
 size_t JanusStream::GetViewerCount() const
 {
-    std::lock_guard lock(mutex);
-    return viewerSessions.size();
+    size_t viewerCount = 0;
+    for (const auto& shard : viewerShards)
+    {
+        viewerCount += shardViewerCount(*shard);
+    }
+    return viewerCount;
+}
+
+std::vector<JanusStream::ShardStats> JanusStream::GetShardStats() const
+{
+    std::vector<ShardStats> shardStats;
+    shardStats.reserve(viewerShards.size());
+    for (const auto& shard : viewerShards)
+    {
+        shardStats.push_back(ShardStats {
+            .ViewerCount = shardViewerCount(*shard),
+            .AudioOnlyViewerCount = shard->AudioOnlySessionCount.load(std::memory_order_relaxed),
+            .FanoutWorkerIndex = (fanoutPool != nullptr) ?
+                std::optional(fanoutPool->GetWorkerIndex(shard->FanoutRegistration)) :
+                std::nullopt,
+        });
+    }
+    return shardStats;
+}
+
+void JanusStream::SendKeyframeBurst(JanusSession* session)
+{
+    if (session->GetIsAudioOnly())
+    {
+        return;
+    }
+    std::vector<PacketBuffer> packets;
+    {
+        std::lock_guard lock(gopCacheMutex);
+        packets = gopCache.Snapshot();
+    }
+    session->SendKeyframeBurst(packets, mediaMetadata.VideoPayloadType);
 }
 
 void JanusStream::AddRelayClient(const std::string targetHostname,
     std::unique_ptr<FtlClient> client)
 {
-    std::lock_guard lock(mutex);
-    relays.push_back(Relay { .TargetHostname = targetHostname, .Client = std::move(client) });
+    auto relay = std::make_shared<Relay>(
+        Relay
+        {
+            .TargetHostname = targetHostname,
+            .Client = std::move(client),
+            // The relay group starts new relays at the latest keyframe itself
+            .IsAwaitingKeyframeBurst = (relayKeyframeBurst && (relayGroup == nullptr)),
+        });
+    size_t numRelays = relays.Update(
+        [&relay](std::vector<std::shared_ptr<Relay>>& relayList)
+        {
+            relayList.push_back(std::move(relay));
+            return relayList.size();
+        });
+    relayCount.store(numRelays, std::memory_order_relaxed);
 }
 
 size_t JanusStream::StopRelay(const std::string& targetHostname)
 {
-    std::list<Relay> removedRelays;
-    {
-        std::lock_guard lock(mutex);
-        for (auto it = relays.begin();
-            it != relays.end();)
+    std::vector<std::shared_ptr<Relay>> removedRelays;
+    size_t numRelays = relays.Update(
+        [&removedRelays, &targetHostname](std::vector<std::shared_ptr<Relay>>& relayList)
         {
-            if (it->TargetHostname == targetHostname)
+            for (auto it = relayList.begin();
+                it != relayList.end();)
             {
-                removedRelays.push_back(std::move(*it));
-                it = relays.erase(it);
+                if ((*it)->TargetHostname == targetHostname)
+                {
+                    removedRelays.push_back(std::move(*it));
+                    it = relayList.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
             }
-            else
-            {
-                ++it;
-            }
-        }
-    }
-    for (Relay& relay : removedRelays)
+            return relayList.size();
+        });
+    relayCount.store(numRelays, std::memory_order_relaxed);
+    for (const auto& relay : removedRelays)
     {
         spdlog::info("Stopping relay for channel {} / stream {} -> {}...",
-            channelId, streamId, relay.TargetHostname);
-         relay.Client->Stop();
+            channelId, streamId, relay->TargetHostname);
+        relay->Client->Stop();
     }
     return removedRelays.size();
 }
 
 void JanusStream::StopRelays()
 {
-    std::list<Relay> removedRelays;
+    std::vector<std::shared_ptr<Relay>> removedRelays;
+    relays.Update(
+        [&removedRelays](std::vector<std::shared_ptr<Relay>>& relayList)
+        {
+            relayList.swap(removedRelays);
+        });
+    relayCount.store(0, std::memory_order_relaxed);
+    for (const auto& relay : removedRelays)
     {
-        std::lock_guard lock(mutex);
-        relays.swap(removedRelays);
+        spdlog::info("Stopping relay for channel {} / stream {} -> {}...",
+            channelId, streamId, relay->TargetHostname);
+        relay->Client->Stop();
     }
+}
+
+size_t JanusStream::RemoveClosedRelays()
+{
+    std::vector<std::shared_ptr<Relay>> removedRelays;
+    size_t numRelays = relays.Update(
+        [&removedRelays](std::vector<std::shared_ptr<Relay>>& relayList)
+        {
+            std::erase_if(relayList,
+                [&removedRelays](std::shared_ptr<Relay>& relay)
+                {
+                    if (!relay->Client->IsClosed())
+                    {
+                        return false;
+                    }
+                    removedRelays.push_back(relay);
+                    return true;
+                });
+            return relayList.size();
+        });
+    relayCount.store(numRelays, std::memory_order_relaxed);
     for (const auto& relay : removedRelays)
     {
-        spdlog::info("Stopping relay for channel {} / stream {} -> {}...",
-            channelId, streamId, relay.TargetHostname);
-        relay.Client->Stop();
+        spdlog::info("Relay for channel {} / stream {} -> {} has closed, removing it...",
+            channelId, streamId, relay->TargetHostname);
+        relay->Client->Stop();
     }
+    return removedRelays.size();
+}
+
+size_t JanusStream::GetRelayCount() const
+{
+    return relayCount.load(std::memory_order_relaxed);
+}
+
+std::vector<JanusStream::RelayStats> JanusStream::GetRelayStats() const
+{
+    std::shared_ptr<const std::vector<std::shared_ptr<Relay>>> currentRelays = relays.Read();
+    std::vector<RelayStats> relayStats;
+    relayStats.reserve(currentRelays->size());
+    for (const auto& relay : *currentRelays)
+    {
+        relayStats.push_back(RelayStats {
+            .TargetHostname = relay->TargetHostname,
+            .Queue = relay->Client->GetRelayStats(),
+        });
+    }
+    return relayStats;
 }
 
 #pragma endregion
@@ -126,5 +416,282 @@ MediaMetadata JanusStream::GetMetadata() const
 {
     return mediaMetadata;
 }
+std::shared_ptr<DatagramFanoutQueue> JanusStream::GetRelayGroup() const
+{
+    return relayGroup;
+}
+
+#pragma endregion
+
+#pragma region Private methods
+JanusStream::ViewerShard* JanusStream::emptiestShard()
+{
+    ViewerShard* targetShard = nullptr;
+    bool isTargetOnNode = false;
+    for (const auto& shard : viewerShards)
+    {
+        const bool isOnNode = (shard->NumaNode == numaNode);
+        if ((targetShard == nullptr) || (isOnNode && !isTargetOnNode) ||
+            ((isOnNode == isTargetOnNode) &&
+                (shardViewerCount(*shard) < shardViewerCount(*targetShard))))
+        {
+            targetShard = shard.get();
+            isTargetOnNode = isOnNode;
+        }
+    }
+    return targetShard;
+}
+
+size_t JanusStream::shardViewerCount(const ViewerShard& shard)
+{
+    return shard.SessionCount.load(std::memory_order_relaxed) +
+        shard.AudioOnlySessionCount.load(std::memory_order_relaxed);
+}
+
+void JanusStream::addToShard(ViewerShard& shard, JanusSession* session, bool isAudioOnly)
+{
+    size_t shardSize = (isAudioOnly ? shard.AudioOnlySessions : shard.Sessions).Update(
+        [session](std::vector<JanusSession*>& sessions)
+        {
+            sessions.push_back(session);
+            return sessions.size();
+        });
+    (isAudioOnly ? shard.AudioOnlySessionCount : shard.SessionCount).store(shardSize,
+        std::memory_order_relaxed);
+}
+
+void JanusStream::removeFromShard(ViewerShard& shard, JanusSession* session, bool isAudioOnly)
+{
+    size_t shardSize = (isAudioOnly ? shard.AudioOnlySessions : shard.Sessions).Update(
+        [session](std::vector<JanusSession*>& sessions)
+        {
+            std::erase(sessions, session);
+            return sessions.size();
+        });
+    (isAudioOnly ? shard.AudioOnlySessionCount : shard.SessionCount).store(shardSize,
+        std::memory_order_relaxed);
+}
+
+void JanusStream::sendToShard(ViewerShard& shard, const PacketBuffer& packet)
+{
+    std::shared_ptr<const std::vector<JanusSession*>> sessions = shard.Sessions.Read();
+    // Audio-only viewers are only looked at for audio packets
+    std::shared_ptr<const std::vector<JanusSession*>> audioOnlySessions;
+    if ((shard.AudioOnlySessionCount.load(std::memory_order_relaxed) > 0) &&
+        !isVideoPacket(packet))
+    {
+        audioOnlySessions = shard.AudioOnlySessions.Read();
+    }
+    // Prepared once per shard rather than per viewer, so every viewer shares the same copy
+    if (sessions->empty() && ((audioOnlySessions == nullptr) || audioOnlySessions->empty()))
+    {
+        return;
+    }
+    if (latencyTracer != nullptr)
+    {
+        latencyTracer->Record(PacketLatencyTracer::Stage::ViewerSend, packet);
+    }
+    const bool isTimed = ((viewerFanoutDuration != nullptr) || (overloadController != nullptr));
+    const auto startTime = isTimed ?
+        std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    const bool isShedding = (overloadController != nullptr) &&
+        updateShedSessions(shard, packet, *sessions);
+    PreparedRtpPacket preparedPacket(packet, mediaMetadata.VideoPayloadType);
+    size_t shedSessionCount = 0;
+    for (JanusSession* session : *sessions)
+    {
+        if (isShedding && shard.ShedSessions.contains(session))
+        {
+            ++shedSessionCount;
+            continue;
+        }
+        session->SendRtpPacket(preparedPacket);
+    }
+    if (shedSessionCount > 0)
+    {
+        overloadController->RecordShedVideoPackets(shedSessionCount);
+    }
+    if (audioOnlySessions != nullptr)
+    {
+        for (JanusSession* session : *audioOnlySessions)
+        {
+            session->SendRtpPacket(preparedPacket);
+        }
+    }
+    if (isTimed)
+    {
+        const auto duration = (std::chrono::steady_clock::now() - startTime);
+        if (viewerFanoutDuration != nullptr)
+        {
+            viewerFanoutDuration->ObserveDuration(duration);
+        }
+        if (overloadController != nullptr)
+        {
+            overloadController->RecordFanoutLatency(duration);
+        }
+    }
+}
+
+bool JanusStream::updateShedSessions(ViewerShard& shard, const PacketBuffer& packet,
+    const std::vector<JanusSession*>& sessions)
+{
+    if (!isVideoPacket(packet))
+    {
+        return false;
+    }
+    const bool isOverloaded = overloadController->IsSheddingVideo();
+    if (packetKind(packet) == BoundedPacketQueue::PacketKind::Keyframe)
+    {
+        // Everyone gets keyframes, and they're the only place a shed viewer can pick full
+        // video back up, since they can decode from here on
+        shard.ShedSessions.clear();
+        if (isOverloaded)
+        {
+            shedNewestSessions(shard, sessions);
+        }
+        return false;
+    }
+    if (isOverloaded && shard.ShedSessions.empty())
+    {
+        // Overload started partway through a GOP. Viewers can go without video from any
+        // point, they just freeze until the next keyframe.
+        shedNewestSessions(shard, sessions);
+    }
+    return !shard.ShedSessions.empty();
+}
+
+void JanusStream::shedNewestSessions(ViewerShard& shard,
+    const std::vector<JanusSession*>& sessions)
+{
+    // Sessions are in the order they joined, so the newest viewers are shed first
+    const size_t shedCount = overloadController->GetShedViewerCount(sessions.size());
+    shard.ShedSessions.insert((sessions.end() - shedCount), sessions.end());
+}
+
+void JanusStream::sendToRelays(const PacketBuffer& packet)
+{
+    if ((latencyTracer != nullptr) && (relayCount.load(std::memory_order_relaxed) > 0))
+    {
+        latencyTracer->Record(PacketLatencyTracer::Stage::RelaySend, packet);
+    }
+    if (relayGroup != nullptr)
+    {
+        // Queued once however many relays there are, even none, so the first relay can start
+        // from the latest keyframe
+        relayGroup->Enqueue(packet, packetKind(packet));
+        return;
+    }
+
+    std::shared_ptr<const std::vector<std::shared_ptr<Relay>>> currentRelays = relays.Read();
+    // Each relay queues the packet to be sent on its own thread, so a slow relay only holds
+    // itself up
+    const BoundedPacketQueue::PacketKind kind = packetKind(packet);
+    // Taken at most once per packet, and only if a relay needs it
+    std::optional<std::vector<PacketBuffer>> gopSnapshot;
+    for (const auto& relay : *currentRelays)
+    {
+        // Packets relayed before the media connection opens are dropped, so put off the
+        // burst until then. It goes out just ahead of a video packet so that it can end right
+        // where the live packets pick up.
+        if (relay->IsAwaitingKeyframeBurst && relay->Client->IsMediaConnected() &&
+            (kind != BoundedPacketQueue::PacketKind::Independent))
+        {
+            relay->IsAwaitingKeyframeBurst = false;
+            sendKeyframeBurstToRelay(*relay, packet, gopSnapshot);
+        }
+        relay->Client->RelayPacket(packet, kind);
+    }
+}
+
+void JanusStream::sendKeyframeBurstToRelay(Relay& relay, const PacketBuffer& nextPacket,
+    std::optional<std::vector<PacketBuffer>>& gopSnapshot)
+{
+    if (!gopSnapshot.has_value())
+    {
+        std::lock_guard lock(gopCacheMutex);
+        gopSnapshot = gopCache.Snapshot();
+    }
+
+    // Packets are added to the cache before they're sent on, so the next packet should be in
+    // there, possibly followed by packets that haven't been relayed yet. Relay everything up to
+    // it, keeping the original sequence numbers so the relay carries on seamlessly. If a new
+    // keyframe has already replaced the cached one, the relay waits on that keyframe instead.
+    auto nextPacketIt = std::find_if(gopSnapshot->begin(), gopSnapshot->end(),
+        [&nextPacket](const PacketBuffer& cachedPacket)
+        {
+            return (cachedPacket.Data() == nextPacket.Data());
+        });
+    if ((nextPacketIt == gopSnapshot->end()) || (nextPacketIt == gopSnapshot->begin()))
+    {
+        return;
+    }
+    spdlog::info("Sending {} cached packets to new relay for channel {} / stream {} -> {}",
+        std::distance(gopSnapshot->begin(), nextPacketIt), channelId, streamId,
+        relay.TargetHostname);
+    for (auto it = gopSnapshot->begin(); it != nextPacketIt; ++it)
+    {
+        relay.Client->RelayPacket(*it, packetKind(*it));
+    }
+}
+
+bool JanusStream::isVideoPacket(const PacketBuffer& packet) const
+{
+    // RTP header is 12 bytes
+    return (packet.Size() >= 12) &&
+        (RtpPacket::GetRtpHeader(packet)->Type == mediaMetadata.VideoPayloadType);
+}
+
+BoundedPacketQueue::PacketKind JanusStream::packetKind(const PacketBuffer& packet) const
+{
+    if (!isVideoPacket(packet))
+    {
+        return BoundedPacketQueue::PacketKind::Independent;
+    }
+    if (isKeyframePayload(RtpPacket::GetRtpPayload(packet)))
+    {
+        return BoundedPacketQueue::PacketKind::Keyframe;
+    }
+    return BoundedPacketQueue::PacketKind::Dependent;
+}
+
+void JanusStream::collectRelayMetrics(MetricsRegistry::Writer& writer)
+{
+    for (const RelayStats& relay : GetRelayStats())
+    {
+        const MetricLabels labels
+        {
+            { "channel", std::to_string(channelId) },
+            { "target", relay.TargetHostname },
+        };
+        writer.Gauge("ftl_relay_queued_packets", "Packets waiting to be sent to a relay",
+            labels, relay.Queue.QueuedPackets);
+        writer.Counter("ftl_relay_sent_packets_total", "Packets sent to a relay", labels,
+            relay.Queue.SentPackets);
+        writer.Counter("ftl_relay_dropped_packets_total",
+            "Packets dropped because a relay fell behind", labels, relay.Queue.DroppedPackets);
+    }
+}
+
+void JanusStream::collectRecordingMetrics(MetricsRegistry::Writer& writer)
+{
+    if (recorder == nullptr)
+    {
+        return;
+    }
+    const StreamRecorder::Stats stats = recorder->GetStats();
+    const MetricLabels labels { { "channel", std::to_string(channelId) } };
+    writer.Gauge("ftl_recording_queued_packets", "Packets waiting to be written to a recording",
+        labels, stats.QueuedPackets);
+    writer.Counter("ftl_recording_packets_total", "Packets written to a recording", labels,
+        stats.RecordedPackets);
+    writer.Counter("ftl_recording_bytes_total", "Bytes written to a recording", labels,
+        stats.RecordedBytes);
+    writer.Counter("ftl_recording_dropped_packets_total",
+        "Packets dropped because a recording fell behind", labels, stats.DroppedPackets);
+    writer.Counter("ftl_recording_write_errors_total",
+        "Packets or writes lost to errors writing a recording", labels, stats.WriteErrors);
+    writer.Counter("ftl_recording_segments_total", "Recording segments started", labels,
+        stats.Segments);
+}
 
 #pragma endregion
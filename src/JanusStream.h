@@ -9,51 +9,223 @@
 
 #include "FtlClient.h"
 #include "JanusSession.h"
+#include "Rtp/GopCache.h"
 #include "RtpPacketSink.h"
+#include "StreamRecorder.h"
+#include "Utilities/DatagramFanoutQueue.h"
+#include "Utilities/DatagramSendQueue.h"
+#include "Utilities/FanoutWorkerPool.h"
 #include "Utilities/FtlTypes.h"
+#include "Utilities/Metrics.h"
+#include "Utilities/OverloadController.h"
+#include "Utilities/PacketLatencyTracer.h"
+#include "Utilities/RcuValue.h"
+#include "VideoCodecTraits.h"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 class JanusStream : public RtpPacketSink
 {
 public:
+    /* Public types */
+    struct ShardStats
+    {
+        // Every viewer in the shard, including audio-only ones
+        size_t ViewerCount = 0;
+        size_t AudioOnlyViewerCount = 0;
+        // Fanout worker that delivers to this shard, or empty if packets are delivered inline
+        std::optional<size_t> FanoutWorkerIndex;
+    };
+
+    struct RelayStats
+    {
+        std::string TargetHostname;
+        DatagramSendQueue::Stats Queue;
+    };
+
     /* Constructor/Destructor */
+    /**
+     * @param fanoutPool
+     *  if provided, viewers are sharded across the pool's workers and packets are delivered
+     *  on those workers; otherwise packets are delivered inline by SendRtpPacket
+     * @param relayKeyframeBurst
+     *  whether new relays are sent everything since the latest keyframe before live packets
+     * @param useRelayGroup
+     *  whether packets are queued once for every relay and sent by a single relay group
+     *  thread, rather than queued for each relay's own sending thread
+     * @param relayPacingInterval
+     *  most time bursts of packets, like keyframes, are spread out over when they're sent to
+     *  relays, or 0 to send them as fast as each relay's socket takes them
+     * @param metrics where to report fanout times and relay queues, if anywhere
+     * @param numaNode
+     *  NUMA node viewers should preferably be delivered to from, when the fanout pool has
+     *  workers pinned to it
+     * @param recorder if provided, every packet is also handed to it to be recorded
+     * @param overloadController
+     *  if provided, told how long fanout takes, and consulted on whether to shed viewers' video
+     */
     JanusStream(
         ftl_channel_id_t channelId,
         ftl_stream_id_t streamId,
-        MediaMetadata mediaMetadata);
+        MediaMetadata mediaMetadata,
+        std::shared_ptr<FanoutWorkerPool> fanoutPool = nullptr,
+        bool relayKeyframeBurst = false,
+        bool useRelayGroup = false,
+        std::chrono::milliseconds relayPacingInterval = std::chrono::milliseconds(0),
+        std::shared_ptr<MetricsRegistry> metrics = nullptr,
+        std::optional<int> numaNode = std::nullopt,
+        std::unique_ptr<StreamRecorder> recorder = nullptr,
+        std::shared_ptr<OverloadController> overloadController = nullptr);
+    ~JanusStream();
 
     /* Public methods */
-    void SendRtpPacket(const std::vector<std::byte>& packet) override;
+    void SendRtpPacket(const PacketBuffer& packet) override;
+    std::optional<int> GetNumaNode() const override;
+    /**
+     * @brief Moves viewers onto fanout workers on the given NUMA node, if there are any
+     */
+    void SetNumaNode(int numaNode) override;
 
     // Session methods
+    /**
+     * @brief Adds a viewer, who is only ever sent video if they're not audio-only
+     */
     void AddViewerSession(JanusSession* session);
     size_t RemoveViewerSession(JanusSession* session);
     std::unordered_set<JanusSession*> RemoveAllViewerSessions();
     size_t GetViewerCount() const;
+    /**
+     * @brief Viewer counts and fanout workers of each shard, read without taking any locks
+     */
+    std::vector<ShardStats> GetShardStats() const;
+    /**
+     * @brief Sends the given viewer everything since the latest keyframe, if we have it
+     */
+    void SendKeyframeBurst(JanusSession* session);
 
     // Relay client methods
     void AddRelayClient(const std::string targetHostname, std::unique_ptr<FtlClient> client);
     size_t StopRelay(const std::string& targetHostname);
     void StopRelays();
+    /**
+     * @brief Removes relays that failed to connect or have been disconnected since
+     */
+    size_t RemoveClosedRelays();
+    size_t GetRelayCount() const;
+    std::vector<RelayStats> GetRelayStats() const;
 
     /* Getters/Setters */
     ftl_channel_id_t GetChannelId() const;
     ftl_stream_id_t GetStreamId() const;
     MediaMetadata GetMetadata() const;
+    /**
+     * @brief The group relay clients of this stream should send through, or null if none
+     */
+    std::shared_ptr<DatagramFanoutQueue> GetRelayGroup() const;
 
 private:
+    /* Private types */
     struct Relay
     {
         std::string TargetHostname;
         std::unique_ptr<FtlClient> Client;
+        // Only touched while sending to relays
+        bool IsAwaitingKeyframeBurst = false;
     };
 
+    /**
+     * @brief A subset of this stream's viewers, all delivered to by the same fanout worker
+     */
+    struct ViewerShard
+    {
+        // Removing a session waits for in-flight deliveries, so it's never delivered to after
+        RcuValue<std::vector<JanusSession*>> Sessions;
+        // Kept apart from the others so video is delivered without ever looking at them
+        RcuValue<std::vector<JanusSession*>> AudioOnlySessions;
+        // Mirror the sizes of the session lists so ingest can skip empty shards without a
+        // snapshot
+        std::atomic<size_t> SessionCount { 0 };
+        std::atomic<size_t> AudioOnlySessionCount { 0 };
+        FanoutWorkerPool::RegistrationId FanoutRegistration = 0;
+        // NUMA node of the worker delivering to this shard, if known
+        int NumaNode = -1;
+        // Viewers going without non-keyframe video until the next keyframe, only touched by
+        // whichever thread delivers to the shard. Chosen at keyframes rather than by position,
+        // so viewers leaving never moves someone else back onto video partway through a GOP.
+        // Viewers who have since left linger until then, and are never dereferenced.
+        std::unordered_set<const JanusSession*> ShedSessions;
+    };
+
+    struct ViewerMembership
+    {
+        ViewerShard* Shard = nullptr;
+        bool IsAudioOnly = false;
+    };
+
+    /* Private fields */
     ftl_channel_id_t channelId;
     ftl_stream_id_t streamId;
     MediaMetadata mediaMetadata;
-    std::unordered_set<JanusSession*> viewerSessions;
-    std::list<Relay> relays;
-    mutable std::mutex mutex;
+    // Bound to the stream's video codec up front, so classifying packets never checks it
+    const KeyframePayloadDetector isKeyframePayload;
+    const std::shared_ptr<FanoutWorkerPool> fanoutPool;
+    const bool relayKeyframeBurst;
+    const std::shared_ptr<DatagramFanoutQueue> relayGroup;
+    std::vector<std::unique_ptr<ViewerShard>> viewerShards;
+    // Which shard each viewer session lives in, guarded by viewerMembershipMutex
+    std::unordered_map<JanusSession*, ViewerMembership> viewerSessionShards;
+    // Only taken to change viewer membership, never on the packet path
+    mutable std::mutex viewerMembershipMutex;
+    // Node new viewers are placed on, guarded by viewerMembershipMutex
+    std::optional<int> numaNode;
+    RcuValue<std::vector<std::shared_ptr<Relay>>> relays;
+    std::atomic<size_t> relayCount { 0 };
+    FanoutWorkerPool::RegistrationId relayFanoutRegistration = 0;
+    // Only held briefly, to add a packet or take a snapshot
+    std::mutex gopCacheMutex;
+    GopCache gopCache;
+    const std::shared_ptr<MetricsRegistry> metrics;
+    // Time taken to send a packet to every viewer in a shard, or null if not recorded
+    std::shared_ptr<MetricHistogram> viewerFanoutDuration;
+    MetricsRegistry::CollectorId relayCollectorId = 0;
+    // Null unless packet latency tracing is compiled in and metrics are being served
+    std::unique_ptr<PacketLatencyTracer> latencyTracer;
+    // Null unless the stream is being recorded
+    const std::unique_ptr<StreamRecorder> recorder;
+    // Null unless the node sheds load when fanout falls behind
+    const std::shared_ptr<OverloadController> overloadController;
+
+    /* Private methods */
+    /**
+     * @brief
+     *  The emptiest shard, preferring ones on our NUMA node. Must be called with
+     *  viewerMembershipMutex held.
+     */
+    ViewerShard* emptiestShard();
+    static size_t shardViewerCount(const ViewerShard& shard);
+    static void addToShard(ViewerShard& shard, JanusSession* session, bool isAudioOnly);
+    static void removeFromShard(ViewerShard& shard, JanusSession* session, bool isAudioOnly);
+    void sendToShard(ViewerShard& shard, const PacketBuffer& packet);
+    void sendToRelays(const PacketBuffer& packet);
+    void sendKeyframeBurstToRelay(Relay& relay, const PacketBuffer& nextPacket,
+        std::optional<std::vector<PacketBuffer>>& gopSnapshot);
+    bool isVideoPacket(const PacketBuffer& packet) const;
+    BoundedPacketQueue::PacketKind packetKind(const PacketBuffer& packet) const;
+    /**
+     * @brief
+     *  Updates which of the shard's sessions are shed because the node is overloaded, and
+     *  returns whether they go without this packet, which is only ever non-keyframe video
+     */
+    bool updateShedSessions(ViewerShard& shard, const PacketBuffer& packet,
+        const std::vector<JanusSession*>& sessions);
+    void shedNewestSessions(ViewerShard& shard, const std::vector<JanusSession*>& sessions);
+    void collectRelayMetrics(MetricsRegistry::Writer& writer);
+    void collectRecordingMetrics(MetricsRegistry::Writer& writer);
 };
@@ -16,6 +16,35 @@ bool ExtendedSequenceCounter::Extend(rtp_sequence_num_t seq, rtp_extended_sequen
     return valid;
 }
 
+ExtendedSequenceCounter::State ExtendedSequenceCounter::GetState() const
+{
+    return State
+    {
+        .MaxSeq = maxSeq,
+        .Cycles = cycles,
+        .BaseSeq = baseSeq,
+        .BadSeq = badSeq,
+        .Probation = probation,
+        .Received = received,
+        .ReceivedPrior = receivedPrior,
+        .ExpectedPrior = expectedPrior,
+        .Initialized = initialized,
+    };
+}
+
+void ExtendedSequenceCounter::SetState(const State& state)
+{
+    maxSeq = state.MaxSeq;
+    cycles = state.Cycles;
+    baseSeq = state.BaseSeq;
+    badSeq = state.BadSeq;
+    probation = state.Probation;
+    received = state.Received;
+    receivedPrior = state.ReceivedPrior;
+    expectedPrior = state.ExpectedPrior;
+    initialized = state.Initialized;
+}
+
 bool ExtendedSequenceCounter::UpdateState(rtp_sequence_num_t seq)
 {
     if (!initialized)
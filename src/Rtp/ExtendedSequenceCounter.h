@@ -21,7 +21,27 @@ typedef uint64_t rtp_extended_sequence_num_t;
 class ExtendedSequenceCounter
 {
 public:
+    /**
+     * @brief Everything the counter has learned about a sequence, so it can be carried on
+     */
+    struct State
+    {
+        rtp_sequence_num_t MaxSeq = 0;
+        uint32_t Cycles = 0;
+        uint32_t BaseSeq = 0;
+        uint32_t BadSeq = 0;
+        uint32_t Probation = 0;
+        uint32_t Received = 0;
+        uint32_t ReceivedPrior = 0;
+        uint32_t ExpectedPrior = 0;
+        bool Initialized = false;
+
+        bool operator==(const State&) const = default;
+    };
+
     bool Extend(rtp_sequence_num_t seq, rtp_extended_sequence_num_t* extendedSeq);
+    State GetState() const;
+    void SetState(const State& state);
 
     friend std::ostream& operator<<(std::ostream & out, const ExtendedSequenceCounter& point);
 private:
@@ -29,9 +49,9 @@ private:
     const int MAX_MISORDER = 100;
     const int MIN_SEQUENTIAL = 2;
 
-    rtp_sequence_num_t maxSeq;
+    rtp_sequence_num_t maxSeq = 0;
     uint32_t cycles = 0;
-    uint32_t baseSeq;
+    uint32_t baseSeq = 0;
     uint32_t badSeq = RTP_SEQ_MOD + 1;
     uint32_t probation = MIN_SEQUENTIAL;
     uint32_t received = 0;
@@ -0,0 +1,73 @@
+/**
+ * @file GopCache.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "GopCache.h"
+
+#include "RtpPacket.h"
+
+#include <netinet/in.h>
+
+#pragma region Constructor/Destructor
+GopCache::GopCache(size_t maxPackets) : maxPackets(maxPackets)
+{
+    packets.reserve(maxPackets);
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void GopCache::Add(const PacketBuffer& packet, bool isKeyframePacket)
+{
+    // RTP header is 12 bytes
+    if (packet.Size() < 12)
+    {
+        return;
+    }
+    const rtp_timestamp_t timestamp = ntohl(RtpPacket::GetRtpHeader(packet)->Timestamp);
+
+    if (isKeyframePacket && (packets.empty() || (timestamp != keyframeTimestamp)))
+    {
+        // A new keyframe makes everything before it unnecessary
+        packets.clear();
+        keyframeTimestamp = timestamp;
+    }
+    else if (packets.empty())
+    {
+        // Nothing to decode this against until we see a keyframe
+        return;
+    }
+
+    if (packets.size() >= maxPackets)
+    {
+        // A partial group would leave a gap between the cached packets and live ones
+        packets.clear();
+        return;
+    }
+    packets.push_back(packet);
+}
+
+std::vector<PacketBuffer> GopCache::Snapshot() const
+{
+    return packets;
+}
+
+void GopCache::Clear()
+{
+    packets.clear();
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool GopCache::Empty() const
+{
+    return packets.empty();
+}
+
+size_t GopCache::Size() const
+{
+    return packets.size();
+}
+#pragma endregion Getters/Setters
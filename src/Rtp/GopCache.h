@@ -0,0 +1,54 @@
+/**
+ * @file GopCache.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "../Utilities/PacketBuffer.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief
+ *  Holds a stream's video packets from the start of the most recent keyframe onward (a group
+ *  of pictures), so a new viewer can be sent everything it needs to start decoding right away
+ *  instead of waiting on the next keyframe. Not thread-safe.
+ */
+class GopCache
+{
+public:
+    /* Constants */
+    static constexpr size_t DEFAULT_MAX_PACKETS = 4096;
+
+    /* Constructor/Destructor */
+    GopCache(size_t maxPackets = DEFAULT_MAX_PACKETS);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Adds a video packet, in the order it was received. A keyframe packet with a new
+     *  timestamp starts a new group of pictures; anything else extends the current one.
+     *  If a group grows beyond the maximum size it is discarded until the next keyframe.
+     */
+    void Add(const PacketBuffer& packet, bool isKeyframePacket);
+    /**
+     * @brief Returns references to every packet in the current group of pictures, in order
+     */
+    std::vector<PacketBuffer> Snapshot() const;
+    void Clear();
+
+    /* Getters/Setters */
+    bool Empty() const;
+    size_t Size() const;
+
+private:
+    /* Private fields */
+    const size_t maxPackets;
+    std::vector<PacketBuffer> packets;
+    rtp_timestamp_t keyframeTimestamp = 0;
+};
@@ -0,0 +1,170 @@
+/**
+ * @file H264KeyframeAssembler.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "H264KeyframeAssembler.h"
+
+#include "H264Rtp.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+H264KeyframeAssembler::H264KeyframeAssembler(size_t maxPackets)
+:
+    packets(maxPackets)
+{
+    skippedSequenceNums.reserve(maxPackets);
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool H264KeyframeAssembler::Add(const RtpPacket& packet)
+{
+    const rtp_timestamp_t packetTimestamp = packet.Fields.Timestamp;
+    const rtp_extended_sequence_num_t sequenceNum = packet.ExtendedSequenceNum;
+    if (timestamp != packetTimestamp)
+    {
+        const bool isStarted = (!packets.Empty() || !skippedSequenceNums.empty());
+        if (isStarted && (sequenceNum < firstSequenceNum))
+        {
+            // A straggler from an earlier access unit
+            return false;
+        }
+        startAccessUnit(packetTimestamp);
+    }
+    if (isComplete || isAbandoned)
+    {
+        return false;
+    }
+
+    const std::span<const std::byte> payload = packet.Payload();
+    const uint8_t nalType = packet.Fields.NalType;
+    if ((nalType == H264Rtp::NAL_TYPE_FU_A) || (nalType == H264Rtp::NAL_TYPE_FU_B))
+    {
+        // Only the first fragment is needed to know what is being fragmented
+        if ((payload.size() >= 2) && (static_cast<uint8_t>(payload[1]) & 0b10000000))
+        {
+            recordNalType(H264Rtp::NalType(payload[1]));
+        }
+    }
+    else
+    {
+        H264Rtp::ForEachNalUnit(payload,
+            [this](std::span<const std::byte> nalUnit)
+            {
+                recordNalType(H264Rtp::NalType(nalUnit[0]));
+            });
+    }
+
+    if (packets.Empty() && !H264Rtp::IsKeyframePayload(payload))
+    {
+        if (std::find(skippedSequenceNums.begin(), skippedSequenceNums.end(), sequenceNum) ==
+            skippedSequenceNums.end())
+        {
+            skippedSequenceNums.push_back(sequenceNum);
+        }
+    }
+    else
+    {
+        packets.Insert(packet);
+    }
+
+    const bool isFirst = ((packets.Size() + skippedSequenceNums.size()) == 1);
+    firstSequenceNum = isFirst ? sequenceNum : std::min(firstSequenceNum, sequenceNum);
+    if (packet.Fields.IsMarker)
+    {
+        markerSequenceNum = sequenceNum;
+    }
+
+    isComplete = checkComplete();
+    return isComplete;
+}
+
+std::list<PacketBuffer> H264KeyframeAssembler::GetKeyframePackets() const
+{
+    std::list<PacketBuffer> keyframePackets;
+    packets.ForEach(
+        [&keyframePackets](const RtpPacket& packet)
+        {
+            if (H264Rtp::IsKeyframePayload(packet.Payload()))
+            {
+                keyframePackets.push_back(packet.Bytes);
+            }
+        });
+    return keyframePackets;
+}
+
+void H264KeyframeAssembler::Abandon()
+{
+    packets.Release();
+    skippedSequenceNums.clear();
+    // We won't see where this access unit ends, so the next one can't be checked against it
+    markerSequenceNum.reset();
+    isAbandoned = true;
+}
+
+void H264KeyframeAssembler::Clear()
+{
+    packets.Release();
+    skippedSequenceNums.clear();
+    timestamp.reset();
+    markerSequenceNum.reset();
+    previousMarkerSequenceNum.reset();
+    hasSps = hasPps = hasIdr = isComplete = isAbandoned = false;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t H264KeyframeAssembler::GetHeldBytes() const
+{
+    return packets.GetHeldBytes();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void H264KeyframeAssembler::startAccessUnit(rtp_timestamp_t newTimestamp)
+{
+    previousMarkerSequenceNum = markerSequenceNum;
+    // Completed keyframes hold their own references, so there's no reason to keep ours around
+    packets.Release();
+    skippedSequenceNums.clear();
+    timestamp = newTimestamp;
+    markerSequenceNum.reset();
+    hasSps = hasPps = hasIdr = isComplete = isAbandoned = false;
+}
+
+void H264KeyframeAssembler::recordNalType(uint8_t nalType)
+{
+    hasSps = (hasSps || (nalType == H264Rtp::NAL_TYPE_SPS));
+    hasPps = (hasPps || (nalType == H264Rtp::NAL_TYPE_PPS));
+    hasIdr = (hasIdr || (nalType == H264Rtp::NAL_TYPE_IDR));
+}
+
+bool H264KeyframeAssembler::checkComplete() const
+{
+    if (!markerSequenceNum.has_value() || !hasSps || !hasPps || !hasIdr)
+    {
+        return false;
+    }
+
+    // If we know where the previous access unit ended, make sure nothing was lost from the
+    // start of this one. Otherwise we rely on the SPS and PPS leading the access unit.
+    if (previousMarkerSequenceNum.has_value() &&
+        (firstSequenceNum != (previousMarkerSequenceNum.value() + 1)))
+    {
+        return false;
+    }
+
+    // Every sequence number up to the marker bit must be accounted for
+    if ((markerSequenceNum.value() < firstSequenceNum) ||
+        (packets.NewestSequenceNum() > markerSequenceNum.value()))
+    {
+        return false;
+    }
+    const size_t expectedCount = (markerSequenceNum.value() - firstSequenceNum + 1);
+    return ((packets.Size() + skippedSequenceNums.size()) == expectedCount);
+}
+#pragma endregion Private methods
@@ -0,0 +1,85 @@
+/**
+ * @file H264KeyframeAssembler.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "RtpPacket.h"
+#include "RtpPacketRingBuffer.h"
+#include "Types.h"
+#include "../Utilities/PacketBuffer.h"
+
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief
+ *  Follows an H264 RTP stream one access unit (all packets sharing a timestamp) at a time and
+ *  recognizes when a keyframe has been captured in full: its SPS, PPS and every IDR slice,
+ *  with no sequence gaps from the start of the access unit up to its marker bit. Aggregated
+ *  (STAP-A) and fragmented (FU-A) NAL units are understood. Not thread-safe.
+ */
+class H264KeyframeAssembler
+{
+public:
+    /* Constants */
+    static constexpr size_t DEFAULT_MAX_PACKETS = 1024;
+
+    /* Constructor/Destructor */
+    H264KeyframeAssembler(size_t maxPackets = DEFAULT_MAX_PACKETS);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Adds a video packet. Packets may arrive out of order within an access unit, but a
+     *  packet with a new timestamp ends the current one.
+     * @return true if this packet completed a keyframe, which can then be read with
+     *  GetKeyframePackets. Late or duplicate packets for a completed keyframe are ignored.
+     */
+    bool Add(const RtpPacket& packet);
+    /**
+     * @brief Returns references to the keyframe packets of the current access unit, in order
+     */
+    std::list<PacketBuffer> GetKeyframePackets() const;
+    /**
+     * @brief
+     *  Lets go of the packets held for the current access unit and ignores the rest of it, so
+     *  it can't complete a keyframe
+     */
+    void Abandon();
+    void Clear();
+
+    /* Getters/Setters */
+    /**
+     * @brief Capacity of the packet buffers held for the current access unit
+     */
+    size_t GetHeldBytes() const;
+
+private:
+    /* Private fields */
+    // Packets from the first keyframe NAL unit of the access unit onward
+    RtpPacketRingBuffer packets;
+    // Packets seen before any keyframe NAL unit, such as delimiters and SEI. Only their
+    // sequence numbers are kept, so non-keyframe access units don't hold on to packet buffers.
+    std::vector<rtp_extended_sequence_num_t> skippedSequenceNums;
+    std::optional<rtp_timestamp_t> timestamp;
+    rtp_extended_sequence_num_t firstSequenceNum = 0;
+    std::optional<rtp_extended_sequence_num_t> markerSequenceNum;
+    // End of the previous access unit, if its marker bit was seen
+    std::optional<rtp_extended_sequence_num_t> previousMarkerSequenceNum;
+    bool hasSps = false;
+    bool hasPps = false;
+    bool hasIdr = false;
+    bool isComplete = false;
+    bool isAbandoned = false;
+
+    /* Private methods */
+    void startAccessUnit(rtp_timestamp_t newTimestamp);
+    void recordNalType(uint8_t nalType);
+    bool checkComplete() const;
+};
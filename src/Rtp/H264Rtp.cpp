@@ -0,0 +1,108 @@
+/**
+ * @file H264Rtp.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "H264Rtp.h"
+
+#include <algorithm>
+
+#pragma region Static utility methods
+bool H264Rtp::IsKeyframePayload(std::span<const std::byte> rtpPayload)
+{
+    if (rtpPayload.size() < 2)
+    {
+        return false;
+    }
+
+    uint8_t nalType = NalType(rtpPayload[0]);
+    // See https://tools.ietf.org/html/rfc3984#section-5.8
+    if ((nalType == NAL_TYPE_FU_A) || (nalType == NAL_TYPE_FU_B))
+    {
+        return isKeyframeNalType(NalType(rtpPayload[1]));
+    }
+
+    // Some encoders aggregate the SPS and PPS (and sometimes small IDR slices) into one packet
+    bool isKeyframe = false;
+    ForEachNalUnit(rtpPayload,
+        [&isKeyframe](std::span<const std::byte> nalUnit)
+        {
+            isKeyframe = (isKeyframe || isKeyframeNalType(NalType(nalUnit[0])));
+        });
+    return isKeyframe;
+}
+
+size_t H264Rtp::AnnexBSize(std::span<const std::byte> rtpPayload)
+{
+    if (rtpPayload.size() < 2)
+    {
+        // Invalid packet payload
+        return 0;
+    }
+
+    uint8_t nalType = NalType(rtpPayload[0]);
+    if (nalType == NAL_TYPE_FU_A)
+    {
+        // The FU indicator and header are replaced by a start code and the original NAL header,
+        // but only on the first fragment
+        bool isStart = (static_cast<uint8_t>(rtpPayload[1]) & 0b10000000);
+        return (isStart ? (START_CODE.size() + 1) : 0) + (rtpPayload.size() - 2);
+    }
+
+    size_t size = 0;
+    ForEachNalUnit(rtpPayload,
+        [&size](std::span<const std::byte> nalUnit)
+        {
+            size += START_CODE.size() + nalUnit.size();
+        });
+    return size;
+}
+
+size_t H264Rtp::WriteAnnexB(std::span<const std::byte> rtpPayload, std::span<std::byte> output)
+{
+    const size_t size = AnnexBSize(rtpPayload);
+    if ((size == 0) || (output.size() < size))
+    {
+        return 0;
+    }
+
+    auto out = output.begin();
+    uint8_t nalType = NalType(rtpPayload[0]);
+    if (nalType == NAL_TYPE_FU_A)
+    {
+        // For fragmented types, start bits are special, they have some extra data in the NAL
+        // header that we need to include.
+        bool isStart = (static_cast<uint8_t>(rtpPayload[1]) & 0b10000000);
+        if (isStart)
+        {
+            out = std::copy(START_CODE.begin(), START_CODE.end(), out);
+            // Write the re-constructed header
+            *out++ = (rtpPayload[0] & std::byte(0b11100000)) |
+                (rtpPayload[1] & std::byte(0b00011111));
+        }
+        std::copy(rtpPayload.begin() + 2, rtpPayload.end(), out);
+    }
+    else
+    {
+        ForEachNalUnit(rtpPayload,
+            [&out](std::span<const std::byte> nalUnit)
+            {
+                out = std::copy(START_CODE.begin(), START_CODE.end(), out);
+                out = std::copy(nalUnit.begin(), nalUnit.end(), out);
+            });
+    }
+
+    return size;
+}
+#pragma endregion Static utility methods
+
+#pragma region Private methods
+bool H264Rtp::isKeyframeNalType(uint8_t nalType)
+{
+    // SPS and PPS precede an IDR (Instantaneous Decoder Refresh) aka Keyframe and provide
+    // information on how to decode it. We should keep these around.
+    return ((nalType == NAL_TYPE_IDR) || (nalType == NAL_TYPE_SPS) || (nalType == NAL_TYPE_PPS));
+}
+#pragma endregion Private methods
@@ -0,0 +1,106 @@
+/**
+ * @file H264Rtp.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief Utilities for inspecting H264 payloads carried over RTP (RFC 6184)
+ */
+class H264Rtp
+{
+public:
+    /* Constants */
+    static constexpr uint8_t NAL_TYPE_IDR = 5;
+    static constexpr uint8_t NAL_TYPE_SPS = 7;
+    static constexpr uint8_t NAL_TYPE_PPS = 8;
+    static constexpr uint8_t NAL_TYPE_STAP_A = 24;
+    static constexpr uint8_t NAL_TYPE_FU_A = 28;
+    static constexpr uint8_t NAL_TYPE_FU_B = 29;
+
+    /* Static utility methods */
+    static uint8_t NalType(std::byte nalHeader)
+    {
+        return (static_cast<uint8_t>(nalHeader) & 0b00011111);
+    }
+
+    /**
+     * @brief
+     *  Invokes the given callable with every whole NAL unit carried by an RTP payload: the
+     *  payload itself for a single NAL unit packet, or each NAL unit in a STAP-A aggregate.
+     *  Fragmented NAL units are skipped.
+     */
+    template<typename Callable>
+    static void ForEachNalUnit(std::span<const std::byte> rtpPayload, Callable call)
+    {
+        if (rtpPayload.empty())
+        {
+            return;
+        }
+
+        const uint8_t nalType = NalType(rtpPayload[0]);
+        if (nalType == NAL_TYPE_STAP_A)
+        {
+            // Each aggregated NAL unit is preceded by its 16-bit size
+            size_t offset = 1;
+            while ((offset + 2) <= rtpPayload.size())
+            {
+                const size_t nalSize = (static_cast<size_t>(rtpPayload[offset]) << 8) |
+                    static_cast<size_t>(rtpPayload[offset + 1]);
+                offset += 2;
+                if ((nalSize == 0) || ((offset + nalSize) > rtpPayload.size()))
+                {
+                    break;
+                }
+                call(rtpPayload.subspan(offset, nalSize));
+                offset += nalSize;
+            }
+        }
+        else if ((nalType != NAL_TYPE_FU_A) && (nalType != NAL_TYPE_FU_B))
+        {
+            call(rtpPayload);
+        }
+    }
+
+    /**
+     * @brief
+     *  Whether the given RTP payload carries part of a keyframe: an SPS, a PPS, an IDR slice,
+     *  a fragment of one of these, or an aggregate containing one of these.
+     */
+    static bool IsKeyframePayload(std::span<const std::byte> rtpPayload);
+
+    /**
+     * @brief
+     *  The number of bytes WriteAnnexB will write for the given RTP payload, so a whole
+     *  bitstream can be sized before any of it is written.
+     */
+    static size_t AnnexBSize(std::span<const std::byte> rtpPayload);
+
+    /**
+     * @brief
+     *  Writes the NAL unit data carried by the given RTP payload as an Annex B byte stream,
+     *  prefixing each NAL unit with a start code, unpacking aggregates and reassembling
+     *  fragmented NAL units.
+     * @param output buffer of at least AnnexBSize(rtpPayload) bytes
+     * @return the number of bytes written
+     */
+    static size_t WriteAnnexB(std::span<const std::byte> rtpPayload, std::span<std::byte> output);
+
+private:
+    /* Constants */
+    static constexpr std::array<std::byte, 3> START_CODE
+    {
+        std::byte(0x00), std::byte(0x00), std::byte(0x01),
+    };
+
+    /* Private methods */
+    static bool isKeyframeNalType(uint8_t nalType);
+};
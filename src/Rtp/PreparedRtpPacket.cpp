@@ -0,0 +1,97 @@
+/**
+ * @file PreparedRtpPacket.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "PreparedRtpPacket.h"
+
+#include "RtpPacket.h"
+
+#include <algorithm>
+#include <netinet/in.h>
+
+#pragma region Constructor/Destructor
+PreparedRtpPacket::PreparedRtpPacket(
+    const PacketBuffer& packet,
+    rtp_payload_type_t videoPayloadType)
+:
+    original(packet),
+    isValid((packet.Size() >= RTP_FIXED_HEADER_SIZE) && (packet.Size() <= MAX_PACKET_SIZE))
+{
+    if (isValid)
+    {
+        const RtpHeader* rtpHeader = RtpPacket::GetRtpHeader(original);
+        isVideo = (rtpHeader->Type == videoPayloadType);
+        sequenceNum = ntohs(rtpHeader->SequenceNumber);
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+std::span<std::byte> PreparedRtpPacket::MutableBytes()
+{
+    if (!isValid)
+    {
+        return std::span<std::byte>();
+    }
+
+    // The copy is made lazily, so packets nobody ends up receiving cost nothing
+    if (!mutableCopy)
+    {
+        mutableCopy = PacketBuffer::Copy(original);
+        ++copyCount;
+    }
+    else if (isMutableCopyModified())
+    {
+        std::copy(original.Bytes().begin(), original.Bytes().end(), mutableCopy.Data());
+        ++copyCount;
+    }
+
+    return std::span<std::byte>(mutableCopy.Data(), mutableCopy.Size());
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool PreparedRtpPacket::IsValid() const
+{
+    return isValid;
+}
+
+bool PreparedRtpPacket::IsVideo() const
+{
+    return isVideo;
+}
+
+rtp_sequence_num_t PreparedRtpPacket::GetSequenceNum() const
+{
+    return sequenceNum;
+}
+
+uint16_t PreparedRtpPacket::GetLength() const
+{
+    return static_cast<uint16_t>(original.Size());
+}
+
+const PacketBuffer& PreparedRtpPacket::GetOriginal() const
+{
+    return original;
+}
+
+size_t PreparedRtpPacket::GetCopyCount() const
+{
+    return copyCount;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+bool PreparedRtpPacket::isMutableCopyModified() const
+{
+    // Receivers that rewrite anything rewrite header fields (sequence numbers, SSRCs and the
+    // like), so comparing the fixed header is a cheap stand-in for comparing the whole packet.
+    return !std::equal(
+        original.Data(), (original.Data() + RTP_FIXED_HEADER_SIZE),
+        mutableCopy.Data());
+}
+#pragma endregion Private methods
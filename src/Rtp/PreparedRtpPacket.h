@@ -0,0 +1,74 @@
+/**
+ * @file PreparedRtpPacket.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "../Utilities/PacketBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief
+ *  An RTP packet prepared once to be sent to many receivers. Receivers that need a mutable
+ *  buffer (such as Janus) all share a single private copy of the packet, which is only
+ *  restored from the original if a receiver is seen to have modified it.
+ *  Not thread-safe; each delivering thread should prepare its own.
+ */
+class PreparedRtpPacket
+{
+public:
+    /* Constants */
+    // Largest packet we'll hand to a receiver
+    static constexpr size_t MAX_PACKET_SIZE = 2048;
+    static constexpr size_t RTP_FIXED_HEADER_SIZE = 12;
+
+    /* Constructor/Destructor */
+    PreparedRtpPacket(const PacketBuffer& packet, rtp_payload_type_t videoPayloadType);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Returns the shared mutable copy of the packet. If the receiver of the previous call
+     *  modified the RTP header, the copy is restored from the original packet first.
+     */
+    std::span<std::byte> MutableBytes();
+
+    /* Getters/Setters */
+    /**
+     * @brief Whether the packet has a full RTP header and fits within MAX_PACKET_SIZE
+     */
+    bool IsValid() const;
+    bool IsVideo() const;
+    /**
+     * @brief The packet's original sequence number, read once for every receiver
+     */
+    rtp_sequence_num_t GetSequenceNum() const;
+    uint16_t GetLength() const;
+    /**
+     * @brief The packet as it was received, which is never modified
+     */
+    const PacketBuffer& GetOriginal() const;
+    /**
+     * @brief Number of times the mutable copy has been made or restored from the original
+     */
+    size_t GetCopyCount() const;
+
+private:
+    /* Private fields */
+    const PacketBuffer original;
+    PacketBuffer mutableCopy;
+    bool isValid = false;
+    bool isVideo = false;
+    rtp_sequence_num_t sequenceNum = 0;
+    size_t copyCount = 0;
+
+    /* Private methods */
+    bool isMutableCopyModified() const;
+};
@@ -0,0 +1,59 @@
+/**
+ * @file RtpHeaderRewriter.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RtpHeaderRewriter.h"
+
+#include <netinet/in.h>
+
+#pragma region Public methods
+void RtpHeaderRewriter::Rewrite(std::span<std::byte> packet)
+{
+    // RTP header is 12 bytes
+    if (packet.size() < 12)
+    {
+        return;
+    }
+    RtpHeader* header = reinterpret_cast<RtpHeader*>(packet.data());
+    const rtp_sequence_num_t sequence = ntohs(header->SequenceNumber);
+    const rtp_timestamp_t timestamp = ntohl(header->Timestamp);
+
+    if (isRebasePending && hasSentPackets)
+    {
+        // Unsigned arithmetic wraps around just like RTP sequence numbers and timestamps do
+        sequenceOffset = static_cast<rtp_sequence_num_t>(lastSequence + 1 - sequence);
+        timestampOffset = (lastTimestamp + rebaseTimestampStep - timestamp);
+    }
+    isRebasePending = false;
+
+    lastSequence = static_cast<rtp_sequence_num_t>(sequence + sequenceOffset);
+    lastTimestamp = (timestamp + timestampOffset);
+    hasSentPackets = true;
+    if (!IsPassthrough())
+    {
+        header->SequenceNumber = htons(lastSequence);
+        header->Timestamp = htonl(lastTimestamp);
+    }
+}
+
+void RtpHeaderRewriter::Rebase(rtp_timestamp_t timestampStep)
+{
+    isRebasePending = true;
+    rebaseTimestampStep = timestampStep;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool RtpHeaderRewriter::HasSentPackets() const
+{
+    return hasSentPackets;
+}
+
+bool RtpHeaderRewriter::IsPassthrough() const
+{
+    return (sequenceOffset == 0) && (timestampOffset == 0);
+}
+#pragma endregion Getters/Setters
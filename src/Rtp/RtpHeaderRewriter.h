@@ -0,0 +1,54 @@
+/**
+ * @file RtpHeaderRewriter.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief
+ *  Rewrites the sequence numbers and timestamps of outgoing RTP packets from a single source
+ *  so they stay continuous for the receiver, even when the packets being sent jump back in
+ *  time (ex. when resending cached packets). Packets pass through untouched until the first
+ *  rebase. Not thread-safe.
+ */
+class RtpHeaderRewriter
+{
+public:
+    /* Public methods */
+    /**
+     * @brief Rewrites an outgoing packet's header in place, if it needs rewriting
+     */
+    void Rewrite(std::span<std::byte> packet);
+    /**
+     * @brief
+     *  Makes the next packet rewritten follow directly on from the last packet sent, whatever
+     *  its original numbering, with its timestamp advanced by the given step.
+     */
+    void Rebase(rtp_timestamp_t timestampStep);
+
+    /* Getters/Setters */
+    bool HasSentPackets() const;
+    /**
+     * @brief Whether packets are currently being passed through without changes
+     */
+    bool IsPassthrough() const;
+
+private:
+    /* Private fields */
+    bool hasSentPackets = false;
+    bool isRebasePending = false;
+    rtp_timestamp_t rebaseTimestampStep = 0;
+    rtp_sequence_num_t sequenceOffset = 0;
+    rtp_timestamp_t timestampOffset = 0;
+    rtp_sequence_num_t lastSequence = 0;
+    rtp_timestamp_t lastTimestamp = 0;
+};
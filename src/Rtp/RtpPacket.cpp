@@ -7,20 +7,21 @@
 
 #include "RtpPacket.h"
 
+#include <limits>
 #include <netinet/in.h>
 
 #pragma region Static utility methods
-const RtpHeader* RtpPacket::GetRtpHeader(const std::vector<std::byte>& rtpPacket)
+const RtpHeader* RtpPacket::GetRtpHeader(std::span<const std::byte> rtpPacket)
 {
     return reinterpret_cast<const RtpHeader*>(rtpPacket.data());
 }
 
-const rtp_sequence_num_t RtpPacket::GetRtpSequence(const std::vector<std::byte>& rtpPacket)
+const rtp_sequence_num_t RtpPacket::GetRtpSequence(std::span<const std::byte> rtpPacket)
 {
     return ntohs(GetRtpHeader(rtpPacket)->SequenceNumber);
 }
 
-const std::span<const std::byte> RtpPacket::GetRtpPayload(const std::vector<std::byte>& rtpPacket)
+const std::span<const std::byte> RtpPacket::GetRtpPayload(std::span<const std::byte> rtpPacket)
 {
     if (rtpPacket.size() < 12)
     {
@@ -52,39 +53,98 @@ const std::span<const std::byte> RtpPacket::GetRtpPayload(const std::vector<std:
     }
 
     // Check for invalid size
-    if ((rtpPacket.size() - payloadIndex) <= 0)
+    if (rtpPacket.size() <= payloadIndex)
     {
         return std::span<std::byte>();
     }
 
-    return std::span(rtpPacket.begin() + payloadIndex, rtpPacket.end());
+    return rtpPacket.subspan(payloadIndex);
+}
+
+std::optional<RtpPacketFields> RtpPacket::ParseFields(std::span<const std::byte> rtpPacket)
+{
+    if ((rtpPacket.size() < RTP_FIXED_HEADER_SIZE) ||
+        (rtpPacket.size() > std::numeric_limits<uint16_t>::max()))
+    {
+        return std::nullopt;
+    }
+    const RtpHeader* rtpHeader = GetRtpHeader(rtpPacket);
+    if (rtpHeader->Version != 2)
+    {
+        return std::nullopt;
+    }
+
+    // 4 bytes for every Csrc
+    size_t payloadOffset = RTP_FIXED_HEADER_SIZE + (rtpHeader->CsrcCount * 4);
+    if (rtpHeader->Extension > 0)
+    {
+        if (rtpPacket.size() < (payloadOffset + 4))
+        {
+            return std::nullopt;
+        }
+        const RtpHeaderExtension* extension =
+            reinterpret_cast<const RtpHeaderExtension*>(rtpPacket.data() + payloadOffset);
+        // Extension header is 4 bytes, extension length is in 32-bit words
+        payloadOffset += 4 + (ntohs(extension->Length) * 4);
+    }
+    if (rtpPacket.size() < payloadOffset)
+    {
+        return std::nullopt;
+    }
+
+    // The last byte of a padded packet counts the padding, itself included
+    size_t payloadEnd = rtpPacket.size();
+    if (rtpHeader->Padding > 0)
+    {
+        const size_t paddingSize = static_cast<uint8_t>(rtpPacket.back());
+        if ((paddingSize == 0) || ((payloadEnd - payloadOffset) < paddingSize))
+        {
+            return std::nullopt;
+        }
+        payloadEnd -= paddingSize;
+    }
+
+    return RtpPacketFields {
+        .Ssrc = ntohl(rtpHeader->Ssrc),
+        .SequenceNum = ntohs(rtpHeader->SequenceNumber),
+        .Timestamp = ntohl(rtpHeader->Timestamp),
+        .PayloadType = static_cast<rtp_payload_type_t>(rtpHeader->Type),
+        .IsMarker = (rtpHeader->MarkerBit > 0),
+        .PayloadOffset = static_cast<uint16_t>(payloadOffset),
+        .PayloadSize = static_cast<uint16_t>(payloadEnd - payloadOffset),
+        .NalType = (payloadEnd > payloadOffset) ?
+            static_cast<uint8_t>(static_cast<uint8_t>(rtpPacket[payloadOffset]) & 0x1F) :
+            static_cast<uint8_t>(0),
+    };
 }
 #pragma endregion Static utility methods
 
 #pragma region Constructor/Destructor
 RtpPacket::RtpPacket(
-    const std::vector<std::byte>& bytes,
+    PacketBuffer bytes,
+    const RtpPacketFields& fields,
     const rtp_extended_sequence_num_t extendedSequenceNum)
 :
-    Bytes(bytes),
+    Bytes(std::move(bytes)),
+    Fields(fields),
     ExtendedSequenceNum(extendedSequenceNum)
 {
 }
-#pragma endregion Constructor/Destructor
 
-#pragma region Public methods
-const RtpHeader* RtpPacket::Header() const
-{
-    return RtpPacket::GetRtpHeader(Bytes);
-}
-
-const rtp_sequence_num_t RtpPacket::SequenceNum() const
+RtpPacket::RtpPacket(
+    PacketBuffer bytes,
+    const rtp_extended_sequence_num_t extendedSequenceNum)
+:
+    Bytes(std::move(bytes)),
+    Fields(ParseFields(Bytes).value_or(RtpPacketFields {})),
+    ExtendedSequenceNum(extendedSequenceNum)
 {
-    return RtpPacket::GetRtpSequence(Bytes);
 }
+#pragma endregion Constructor/Destructor
 
+#pragma region Public methods
 const std::span<const std::byte> RtpPacket::Payload() const
 {
-    return RtpPacket::GetRtpPayload(Bytes);
+    return Bytes.Bytes().subspan(Fields.PayloadOffset, Fields.PayloadSize);
 }
 #pragma endregion Public methods
\ No newline at end of file
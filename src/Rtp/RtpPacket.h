@@ -8,11 +8,30 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <vector>
 
 #include "Types.h"
 #include "ExtendedSequenceCounter.h"
+#include "../Utilities/PacketBuffer.h"
+
+/**
+ * @brief The fields of an RTP packet's header, read out and validated once
+ */
+struct RtpPacketFields
+{
+    rtp_ssrc_t Ssrc = 0;
+    rtp_sequence_num_t SequenceNum = 0;
+    rtp_timestamp_t Timestamp = 0;
+    rtp_payload_type_t PayloadType = 0;
+    bool IsMarker = false;
+    // Where the payload sits after any CSRCs and header extension, and before any padding
+    uint16_t PayloadOffset = 0;
+    uint16_t PayloadSize = 0;
+    // Low 5 bits of the first payload byte, which is the NAL unit type if this is H264 video
+    uint8_t NalType = 0;
+};
 
 /**
  * @brief RTP Class providing a bunch of RTP packet related utilities!
@@ -20,22 +39,39 @@
 class RtpPacket
 {
 public:
+    /* Constants */
+    static constexpr size_t RTP_FIXED_HEADER_SIZE = 12;
+
     /* Static utility methods */
-    static const RtpHeader* GetRtpHeader(const std::vector<std::byte>& rtpPacket);
-    static const rtp_sequence_num_t GetRtpSequence(const std::vector<std::byte>& rtpPacket);
-    static const std::span<const std::byte> GetRtpPayload(const std::vector<std::byte>& rtpPacket);
+    static const RtpHeader* GetRtpHeader(std::span<const std::byte> rtpPacket);
+    static const rtp_sequence_num_t GetRtpSequence(std::span<const std::byte> rtpPacket);
+    static const std::span<const std::byte> GetRtpPayload(std::span<const std::byte> rtpPacket);
+    /**
+     * @brief
+     *  Reads the fields out of an RTP packet's header, or returns nullopt if it isn't a
+     *  version 2 packet whose CSRCs, header extension and padding fit within it
+     */
+    static std::optional<RtpPacketFields> ParseFields(std::span<const std::byte> rtpPacket);
 
     /* Constructor/Destructor */
     RtpPacket(
-        const std::vector<std::byte>& bytes,
+        PacketBuffer bytes,
+        const RtpPacketFields& fields,
+        const rtp_extended_sequence_num_t extendedSequenceNum);
+    /**
+     * @brief Parses the packet's fields, leaving them zeroed if it isn't a valid RTP packet
+     */
+    RtpPacket(
+        PacketBuffer bytes,
         const rtp_extended_sequence_num_t extendedSequenceNum);
 
     /* Public fields */
-    const std::vector<std::byte> Bytes;
-    const rtp_extended_sequence_num_t ExtendedSequenceNum;
+    // Not const, so that packets can be copy-assigned into re-usable buffer slots.
+    // Copying a packet shares its bytes rather than copying them.
+    PacketBuffer Bytes;
+    RtpPacketFields Fields;
+    rtp_extended_sequence_num_t ExtendedSequenceNum;
 
     /* Public methods */
-    const RtpHeader* Header() const;
-    const rtp_sequence_num_t SequenceNum() const;
     const std::span<const std::byte> Payload() const;
 };
\ No newline at end of file
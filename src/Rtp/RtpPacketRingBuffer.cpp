@@ -0,0 +1,213 @@
+/**
+ * @file RtpPacketRingBuffer.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RtpPacketRingBuffer.h"
+
+#include <stdexcept>
+#include <utility>
+
+#pragma region Constructor/Destructor
+RtpPacketRingBuffer::RtpPacketRingBuffer(size_t capacity)
+:
+    slots(capacity),
+    slotGenerations(capacity, 0)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("RtpPacketRingBuffer capacity must be greater than zero");
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+RtpPacketRingBuffer::MissingSequenceRange RtpPacketRingBuffer::Insert(const RtpPacket& packet)
+{
+    const rtp_extended_sequence_num_t seqNum = packet.ExtendedSequenceNum;
+
+    if (size == 0)
+    {
+        newestSequenceNum = seqNum;
+        storeInSlot(packet);
+        size = 1;
+        return MissingSequenceRange {};
+    }
+
+    if (seqNum > newestSequenceNum)
+    {
+        MissingSequenceRange missing {
+            .First = (newestSequenceNum + 1),
+            .Count = static_cast<size_t>(seqNum - newestSequenceNum - 1),
+        };
+
+        // Evict the packets that fall out of the window as it advances
+        const rtp_extended_sequence_num_t newWindowStart =
+            ((seqNum + 1) >= slots.size()) ? (seqNum + 1 - slots.size()) : 0;
+        for (rtp_extended_sequence_num_t evictSeq = windowStart();
+            (evictSeq < newWindowStart) && (evictSeq <= newestSequenceNum); ++evictSeq)
+        {
+            if (isSlotOccupied(evictSeq))
+            {
+                --size;
+            }
+        }
+
+        newestSequenceNum = seqNum;
+        storeInSlot(packet);
+        ++size;
+        return missing;
+    }
+
+    if (!isInWindow(seqNum))
+    {
+        // Too old to fit in the window, discard
+        return MissingSequenceRange {};
+    }
+
+    if (!isSlotOccupied(seqNum))
+    {
+        ++size;
+    }
+    storeInSlot(packet);
+    return MissingSequenceRange {};
+}
+
+bool RtpPacketRingBuffer::Remove(rtp_extended_sequence_num_t sequenceNum)
+{
+    if (!isSlotOccupied(sequenceNum))
+    {
+        return false;
+    }
+    releaseSlot(sequenceNum % slots.size());
+    --size;
+    return true;
+}
+
+void RtpPacketRingBuffer::Clear()
+{
+    ++generation;
+    newestSequenceNum = 0;
+    size = 0;
+}
+
+void RtpPacketRingBuffer::Release()
+{
+    // Slots are only filled within the window unless the buffer was cleared without being
+    // released, so there's usually no need to walk every slot
+    if (size > 0)
+    {
+        for (rtp_extended_sequence_num_t seq = windowStart(); seq <= newestSequenceNum; ++seq)
+        {
+            releaseSlot(seq % slots.size());
+        }
+    }
+    for (size_t index = 0; (heldBytes > 0) && (index < slots.size()); ++index)
+    {
+        releaseSlot(index);
+    }
+    Clear();
+}
+
+void RtpPacketRingBuffer::Swap(RtpPacketRingBuffer& other)
+{
+    std::swap(slots, other.slots);
+    std::swap(slotGenerations, other.slotGenerations);
+    std::swap(generation, other.generation);
+    std::swap(newestSequenceNum, other.newestSequenceNum);
+    std::swap(size, other.size);
+    std::swap(heldBytes, other.heldBytes);
+}
+
+bool RtpPacketRingBuffer::Contains(rtp_extended_sequence_num_t sequenceNum) const
+{
+    return isSlotOccupied(sequenceNum);
+}
+
+const RtpPacket* RtpPacketRingBuffer::Get(rtp_extended_sequence_num_t sequenceNum) const
+{
+    if (!isSlotOccupied(sequenceNum))
+    {
+        return nullptr;
+    }
+    return &slots[sequenceNum % slots.size()].value();
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool RtpPacketRingBuffer::Empty() const
+{
+    return (size == 0);
+}
+
+size_t RtpPacketRingBuffer::Size() const
+{
+    return size;
+}
+
+size_t RtpPacketRingBuffer::Capacity() const
+{
+    return slots.size();
+}
+
+rtp_extended_sequence_num_t RtpPacketRingBuffer::NewestSequenceNum() const
+{
+    return newestSequenceNum;
+}
+
+size_t RtpPacketRingBuffer::GetHeldBytes() const
+{
+    return heldBytes;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+rtp_extended_sequence_num_t RtpPacketRingBuffer::windowStart() const
+{
+    return ((newestSequenceNum + 1) >= slots.size()) ? (newestSequenceNum + 1 - slots.size()) : 0;
+}
+
+bool RtpPacketRingBuffer::isInWindow(rtp_extended_sequence_num_t sequenceNum) const
+{
+    return (size > 0) && (sequenceNum <= newestSequenceNum) && (sequenceNum >= windowStart());
+}
+
+bool RtpPacketRingBuffer::isSlotOccupied(rtp_extended_sequence_num_t sequenceNum) const
+{
+    if (!isInWindow(sequenceNum))
+    {
+        return false;
+    }
+    const size_t index = sequenceNum % slots.size();
+    return (slotGenerations[index] == generation) && slots[index].has_value() &&
+        (slots[index]->ExtendedSequenceNum == sequenceNum);
+}
+
+void RtpPacketRingBuffer::storeInSlot(const RtpPacket& packet)
+{
+    const size_t index = packet.ExtendedSequenceNum % slots.size();
+    heldBytes += packet.Bytes.Capacity();
+    if (slots[index].has_value())
+    {
+        heldBytes -= slots[index]->Bytes.Capacity();
+        // Copy-assign into the existing slot; this only shares the packet's buffer
+        slots[index].value() = packet;
+    }
+    else
+    {
+        slots[index].emplace(packet);
+    }
+    slotGenerations[index] = generation;
+}
+
+void RtpPacketRingBuffer::releaseSlot(size_t index)
+{
+    if (slots[index].has_value())
+    {
+        heldBytes -= slots[index]->Bytes.Capacity();
+        slots[index].reset();
+    }
+}
+#pragma endregion Private methods
@@ -0,0 +1,120 @@
+/**
+ * @file RtpPacketRingBuffer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ExtendedSequenceCounter.h"
+#include "RtpPacket.h"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief
+ *  A fixed-capacity buffer of RTP packets indexed by extended sequence number, holding the
+ *  packets within a sliding window of the newest `capacity` sequence numbers.
+ *  Insertion and gap detection are O(1), and slots are reused so packets can be stored
+ *  without allocating once the buffer has warmed up.
+ */
+class RtpPacketRingBuffer
+{
+public:
+    /* Public types */
+    /**
+     * @brief A contiguous range of sequence numbers that have not been received
+     */
+    struct MissingSequenceRange
+    {
+        rtp_extended_sequence_num_t First = 0;
+        size_t Count = 0;
+    };
+
+    /* Constructor/Destructor */
+    RtpPacketRingBuffer(size_t capacity);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Stores a packet in the buffer, advancing the window if it is the newest packet seen.
+     *  Packets older than the window are discarded.
+     * @return the range of sequence numbers skipped between the previous newest packet and this
+     *  one, if this packet is the newest packet seen.
+     */
+    MissingSequenceRange Insert(const RtpPacket& packet);
+    /**
+     * @brief
+     *  Removes a packet from the buffer, letting go of its packet buffer. The window stays
+     *  where it is.
+     * @return false if the packet wasn't stored
+     */
+    bool Remove(rtp_extended_sequence_num_t sequenceNum);
+    /**
+     * @brief Removes all packets from the buffer, retaining allocated storage for re-use
+     */
+    void Clear();
+    /**
+     * @brief
+     *  Removes all packets from the buffer and lets go of their packet buffers, so they can go
+     *  back to their pool. Clear leaves them referenced until their slots are reused.
+     */
+    void Release();
+    void Swap(RtpPacketRingBuffer& other);
+    bool Contains(rtp_extended_sequence_num_t sequenceNum) const;
+    const RtpPacket* Get(rtp_extended_sequence_num_t sequenceNum) const;
+
+    /**
+     * @brief Invokes the given callable with each stored packet, in sequence order
+     */
+    template<typename Callable>
+    void ForEach(Callable call) const
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        for (rtp_extended_sequence_num_t seq = windowStart(); seq <= newestSequenceNum; ++seq)
+        {
+            if (const RtpPacket* packet = Get(seq))
+            {
+                call(*packet);
+            }
+        }
+    }
+
+    /* Getters/Setters */
+    bool Empty() const;
+    size_t Size() const;
+    size_t Capacity() const;
+    /**
+     * @brief The highest sequence number seen. Only valid when the buffer is not empty.
+     */
+    rtp_extended_sequence_num_t NewestSequenceNum() const;
+    /**
+     * @brief
+     *  Capacity of the packet buffers the slots hold references to, including packets that
+     *  were cleared or fell out of the window but whose slots haven't been reused yet
+     */
+    size_t GetHeldBytes() const;
+
+private:
+    /* Private fields */
+    std::vector<std::optional<RtpPacket>> slots;
+    // Generation each slot was last written in, so Clear doesn't need to touch every slot
+    std::vector<uint32_t> slotGenerations;
+    uint32_t generation = 0;
+    rtp_extended_sequence_num_t newestSequenceNum = 0;
+    size_t size = 0;
+    size_t heldBytes = 0;
+
+    /* Private methods */
+    rtp_extended_sequence_num_t windowStart() const;
+    bool isInWindow(rtp_extended_sequence_num_t sequenceNum) const;
+    bool isSlotOccupied(rtp_extended_sequence_num_t sequenceNum) const;
+    void storeInSlot(const RtpPacket& packet);
+    void releaseSlot(size_t index);
+};
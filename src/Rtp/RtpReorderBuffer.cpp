@@ -0,0 +1,98 @@
+/**
+ * @file RtpReorderBuffer.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RtpReorderBuffer.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+RtpReorderBuffer::RtpReorderBuffer(std::chrono::microseconds delay, size_t capacity)
+:
+    delay(delay),
+    packets(capacity),
+    arrivalTimes(capacity)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Getters/Setters
+std::chrono::microseconds RtpReorderBuffer::GetDelay() const
+{
+    return delay;
+}
+
+size_t RtpReorderBuffer::Size() const
+{
+    return packets.Size();
+}
+
+size_t RtpReorderBuffer::GetHeldBytes() const
+{
+    return packets.GetHeldBytes();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+RtpReorderBuffer::InsertResult RtpReorderBuffer::admit(rtp_extended_sequence_num_t sequenceNum)
+{
+    if (!nextSequenceNum.has_value())
+    {
+        nextSequenceNum = sequenceNum;
+        return InsertResult::Accepted;
+    }
+    if (sequenceNum < nextSequenceNum.value())
+    {
+        if (skippedSequences.Test(sequenceNum))
+        {
+            // A second copy would only be a duplicate
+            skippedSequences.Reset(sequenceNum);
+            return InsertResult::Late;
+        }
+        return InsertResult::Duplicate;
+    }
+    if (packets.Contains(sequenceNum))
+    {
+        return InsertResult::Duplicate;
+    }
+    return InsertResult::Accepted;
+}
+
+std::optional<rtp_extended_sequence_num_t> RtpReorderBuffer::newestExpired(
+    std::chrono::steady_clock::time_point now) const
+{
+    // Held packets only ever lie between the next sequence and the newest one
+    if (packets.Empty())
+    {
+        return std::nullopt;
+    }
+    for (rtp_extended_sequence_num_t sequenceNum = packets.NewestSequenceNum();
+        sequenceNum >= nextSequenceNum.value(); --sequenceNum)
+    {
+        if (packets.Contains(sequenceNum) &&
+            ((now - arrivalTimes[sequenceNum % arrivalTimes.size()]) >= delay))
+        {
+            return sequenceNum;
+        }
+        if (sequenceNum == 0)
+        {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+void RtpReorderBuffer::markSkipped(rtp_extended_sequence_num_t first,
+    rtp_extended_sequence_num_t end)
+{
+    // Only the newest sequences fit, older ones would fall straight out again
+    first = std::max(first, (end > RtpSequenceBitmap::WINDOW_SIZE) ?
+        (end - RtpSequenceBitmap::WINDOW_SIZE) : rtp_extended_sequence_num_t { 0 });
+    for (rtp_extended_sequence_num_t sequenceNum = first; sequenceNum < end; ++sequenceNum)
+    {
+        skippedSequences.Set(sequenceNum);
+    }
+}
+#pragma endregion Private methods
@@ -0,0 +1,181 @@
+/**
+ * @file RtpReorderBuffer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "RtpPacket.h"
+#include "RtpPacketRingBuffer.h"
+#include "RtpSequenceBitmap.h"
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief
+ *  Holds an SSRC's packets for a short while so they can be released in sequence order.
+ *  Packets go out as soon as the packets before them have, or once they've been held for the
+ *  reorder delay, giving up on whatever is still missing before them. Copies of packets that
+ *  have already been seen are dropped, as are packets that show up after they were given up on.
+ *  Deadlines are only checked when the buffer is called into.
+ */
+class RtpReorderBuffer
+{
+public:
+    /* Public types */
+    enum class InsertResult
+    {
+        // Held until it can go out in order, or already released if it was next
+        Accepted,
+        // A copy of a packet that has already been held or released
+        Duplicate,
+        // Arrived after the packets following it were released without it
+        Late,
+    };
+
+    /* Constants */
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+    // Packets this far behind the next one to be released mean the sender started counting
+    // again, rather than having been reordered
+    static constexpr size_t RESTART_DISTANCE = RtpSequenceBitmap::WINDOW_SIZE;
+
+    /* Constructor/Destructor */
+    /**
+     * @param capacity
+     *  most packets held at once. Packets further ahead of the next one to be released push
+     *  the packets before them out early.
+     */
+    RtpReorderBuffer(std::chrono::microseconds delay, size_t capacity = DEFAULT_CAPACITY);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Holds on to the packet, then calls the given callable with each packet that's ready to
+     *  go out, in sequence order. Packets are let go of once the callable returns.
+     */
+    template<typename Callable>
+    InsertResult Insert(const RtpPacket& packet, std::chrono::steady_clock::time_point now,
+        Callable release)
+    {
+        const rtp_extended_sequence_num_t sequenceNum = packet.ExtendedSequenceNum;
+        if (nextSequenceNum.has_value() &&
+            ((sequenceNum + RESTART_DISTANCE) < nextSequenceNum.value()))
+        {
+            Flush(release);
+            nextSequenceNum.reset();
+            skippedSequences.Clear();
+        }
+        const InsertResult result = admit(sequenceNum);
+        if (result != InsertResult::Accepted)
+        {
+            return result;
+        }
+
+        if (sequenceNum >= (nextSequenceNum.value() + packets.Capacity()))
+        {
+            skipTo(sequenceNum + 1 - packets.Capacity(), release);
+        }
+        packets.Insert(packet);
+        arrivalTimes[sequenceNum % arrivalTimes.size()] = now;
+        ReleaseReady(now, release);
+        return InsertResult::Accepted;
+    }
+
+    /**
+     * @brief
+     *  Calls the given callable with each packet that's next in sequence or has been held for
+     *  the reorder delay, in sequence order
+     */
+    template<typename Callable>
+    void ReleaseReady(std::chrono::steady_clock::time_point now, Callable release)
+    {
+        releaseInOrder(release);
+        if (std::optional<rtp_extended_sequence_num_t> expired = newestExpired(now))
+        {
+            skipTo(expired.value() + 1, release);
+            releaseInOrder(release);
+        }
+    }
+
+    /**
+     * @brief Calls the given callable with every packet held, in sequence order
+     */
+    template<typename Callable>
+    void Flush(Callable release)
+    {
+        if (!packets.Empty())
+        {
+            skipTo(packets.NewestSequenceNum() + 1, release);
+        }
+    }
+
+    /* Getters/Setters */
+    std::chrono::microseconds GetDelay() const;
+    size_t Size() const;
+    /**
+     * @brief Capacity of the packet buffers of the packets being held
+     */
+    size_t GetHeldBytes() const;
+
+private:
+    /* Private fields */
+    const std::chrono::microseconds delay;
+    RtpPacketRingBuffer packets;
+    // Indexed like the packets they belong to
+    std::vector<std::chrono::steady_clock::time_point> arrivalTimes;
+    // Unset until the first packet arrives
+    std::optional<rtp_extended_sequence_num_t> nextSequenceNum;
+    // Sequences given up on, so copies showing up afterwards can be told apart from duplicates
+    RtpSequenceBitmap skippedSequences;
+
+    /* Private methods */
+    InsertResult admit(rtp_extended_sequence_num_t sequenceNum);
+    /**
+     * @brief The newest packet held that has waited out the delay, if any
+     */
+    std::optional<rtp_extended_sequence_num_t> newestExpired(
+        std::chrono::steady_clock::time_point now) const;
+    void markSkipped(rtp_extended_sequence_num_t first, rtp_extended_sequence_num_t end);
+
+    template<typename Callable>
+    void releaseInOrder(Callable& release)
+    {
+        while (const RtpPacket* packet = packets.Get(nextSequenceNum.value_or(0)))
+        {
+            release(*packet);
+            packets.Remove(nextSequenceNum.value());
+            ++nextSequenceNum.value();
+        }
+    }
+
+    /**
+     * @brief Releases every packet held before the given sequence, skipping any missing
+     */
+    template<typename Callable>
+    void skipTo(rtp_extended_sequence_num_t end, Callable& release)
+    {
+        rtp_extended_sequence_num_t& sequenceNum = nextSequenceNum.value();
+        for (; (sequenceNum < end) && !packets.Empty(); ++sequenceNum)
+        {
+            if (const RtpPacket* packet = packets.Get(sequenceNum))
+            {
+                release(*packet);
+                packets.Remove(sequenceNum);
+            }
+            else
+            {
+                skippedSequences.Set(sequenceNum);
+            }
+        }
+        if (sequenceNum < end)
+        {
+            markSkipped(sequenceNum, end);
+            sequenceNum = end;
+        }
+    }
+};
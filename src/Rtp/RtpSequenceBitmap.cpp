@@ -0,0 +1,113 @@
+/**
+ * @file RtpSequenceBitmap.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RtpSequenceBitmap.h"
+
+#pragma region Public methods
+size_t RtpSequenceBitmap::Advance(rtp_extended_sequence_num_t sequenceNum)
+{
+    if (sequenceNum <= newestSequenceNum)
+    {
+        return 0;
+    }
+
+    size_t dropped = 0;
+    if ((sequenceNum - newestSequenceNum) >= WINDOW_SIZE)
+    {
+        dropped = Count();
+        Clear();
+    }
+    else
+    {
+        // The bits for the new sequences are shared with the old sequences leaving the window
+        for (rtp_extended_sequence_num_t seq = (newestSequenceNum + 1); seq <= sequenceNum; ++seq)
+        {
+            const size_t bitIndex = (seq % WINDOW_SIZE);
+            const uint64_t mask = (uint64_t { 1 } << (bitIndex % WORD_BITS));
+            uint64_t& word = words[bitIndex / WORD_BITS];
+            if ((word & mask) != 0)
+            {
+                ++dropped;
+                word &= ~mask;
+            }
+        }
+    }
+    newestSequenceNum = sequenceNum;
+    return dropped;
+}
+
+bool RtpSequenceBitmap::Set(rtp_extended_sequence_num_t sequenceNum)
+{
+    Advance(sequenceNum);
+    if (!isInWindow(sequenceNum))
+    {
+        return false;
+    }
+    const size_t bitIndex = (sequenceNum % WINDOW_SIZE);
+    words[bitIndex / WORD_BITS] |= (uint64_t { 1 } << (bitIndex % WORD_BITS));
+    return true;
+}
+
+void RtpSequenceBitmap::Reset(rtp_extended_sequence_num_t sequenceNum)
+{
+    if (!isInWindow(sequenceNum))
+    {
+        return;
+    }
+    const size_t bitIndex = (sequenceNum % WINDOW_SIZE);
+    words[bitIndex / WORD_BITS] &= ~(uint64_t { 1 } << (bitIndex % WORD_BITS));
+}
+
+void RtpSequenceBitmap::Clear()
+{
+    words.fill(0);
+}
+
+bool RtpSequenceBitmap::Test(rtp_extended_sequence_num_t sequenceNum) const
+{
+    if (!isInWindow(sequenceNum))
+    {
+        return false;
+    }
+    const size_t bitIndex = (sequenceNum % WINDOW_SIZE);
+    return ((words[bitIndex / WORD_BITS] >> (bitIndex % WORD_BITS)) & 1) != 0;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool RtpSequenceBitmap::Empty() const
+{
+    return std::all_of(words.begin(), words.end(), [](uint64_t word) { return word == 0; });
+}
+
+size_t RtpSequenceBitmap::Count() const
+{
+    size_t count = 0;
+    for (const uint64_t& word : words)
+    {
+        count += std::popcount(word);
+    }
+    return count;
+}
+
+rtp_extended_sequence_num_t RtpSequenceBitmap::NewestSequenceNum() const
+{
+    return newestSequenceNum;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+rtp_extended_sequence_num_t RtpSequenceBitmap::windowStart() const
+{
+    return (newestSequenceNum >= (WINDOW_SIZE - 1)) ? (newestSequenceNum - WINDOW_SIZE + 1) : 0;
+}
+
+bool RtpSequenceBitmap::isInWindow(rtp_extended_sequence_num_t sequenceNum) const
+{
+    return (sequenceNum >= windowStart()) && (sequenceNum <= newestSequenceNum);
+}
+#pragma endregion Private methods
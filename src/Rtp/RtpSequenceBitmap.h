@@ -0,0 +1,100 @@
+/**
+ * @file RtpSequenceBitmap.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ExtendedSequenceCounter.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief
+ *  A fixed-size set of extended sequence numbers within a sliding window ending at the newest
+ *  sequence number seen, stored as a ring of bits. Marking, clearing and scanning sequences
+ *  never allocates.
+ */
+class RtpSequenceBitmap
+{
+public:
+    /* Constants */
+    static constexpr size_t WINDOW_SIZE = 256;
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Moves the window forward so that it ends at the given sequence number, clearing any
+     *  sequences that fall out of it. Has no effect if the window is already past it.
+     * @return the number of marked sequences that fell out of the window
+     */
+    size_t Advance(rtp_extended_sequence_num_t sequenceNum);
+    /**
+     * @brief Marks a sequence, advancing the window if necessary
+     * @return false if the sequence is too old to fit in the window
+     */
+    bool Set(rtp_extended_sequence_num_t sequenceNum);
+    /**
+     * @brief Un-marks a sequence. Sequences outside of the window are ignored.
+     */
+    void Reset(rtp_extended_sequence_num_t sequenceNum);
+    void Clear();
+    bool Test(rtp_extended_sequence_num_t sequenceNum) const;
+
+    /**
+     * @brief
+     *  Invokes the given callable with each marked sequence number, in ascending order.
+     *  The callable may Reset sequences while iterating.
+     */
+    template<typename Callable>
+    void ForEach(Callable call) const
+    {
+        rtp_extended_sequence_num_t seq = windowStart();
+        while (seq <= newestSequenceNum)
+        {
+            // Scan a word at a time, up to the end of the word or the window
+            const size_t bitIndex = (seq % WINDOW_SIZE);
+            const size_t bitOffset = (bitIndex % WORD_BITS);
+            const size_t chunkSize = std::min<rtp_extended_sequence_num_t>(
+                (WORD_BITS - bitOffset), (newestSequenceNum - seq + 1));
+            uint64_t bits = (words[bitIndex / WORD_BITS] >> bitOffset);
+            if (chunkSize < WORD_BITS)
+            {
+                bits &= ((uint64_t { 1 } << chunkSize) - 1);
+            }
+            while (bits != 0)
+            {
+                call(seq + std::countr_zero(bits));
+                bits &= (bits - 1);
+            }
+            seq += chunkSize;
+        }
+    }
+
+    /* Getters/Setters */
+    bool Empty() const;
+    size_t Count() const;
+    /**
+     * @brief The newest sequence number the window ends at
+     */
+    rtp_extended_sequence_num_t NewestSequenceNum() const;
+
+private:
+    /* Constants */
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t WORD_COUNT = (WINDOW_SIZE / WORD_BITS);
+
+    /* Private fields */
+    std::array<uint64_t, WORD_COUNT> words {};
+    rtp_extended_sequence_num_t newestSequenceNum = 0;
+
+    /* Private methods */
+    rtp_extended_sequence_num_t windowStart() const;
+    bool isInWindow(rtp_extended_sequence_num_t sequenceNum) const;
+};
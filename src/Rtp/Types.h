@@ -86,6 +86,20 @@ struct RtcpHeader
     uint16_t Length:16;
 };
 
+// See https://tools.ietf.org/html/rfc3550#section-6.4.1, FTL clients send these without any
+// report blocks
+struct RtcpSenderReportPacket
+{
+    RtcpHeader Header;
+    uint32_t Ssrc;
+    uint32_t NtpTimestampHigh;
+    uint32_t NtpTimestampLow;
+    uint32_t RtpTimestamp;
+    uint32_t SenderPacketCount;
+    uint32_t SenderOctetCount;
+};
+static_assert(sizeof(RtcpSenderReportPacket) == 28);
+
 struct RtcpFeedbackPacket
 {
     RtcpHeader Header;
@@ -7,7 +7,9 @@
 
 #pragma once
 
-#include <vector>
+#include "Utilities/PacketBuffer.h"
+
+#include <optional>
 
 class RtpPacketSink
 {
@@ -15,5 +17,19 @@ public:
     virtual ~RtpPacketSink() {};
 
     /* Public methods */
-    virtual void SendRtpPacket(const std::vector<std::byte>& packet) = 0;
+    virtual void SendRtpPacket(const PacketBuffer& packet) = 0;
+
+    /* Getters/Setters */
+    /**
+     * @brief NUMA node packets should preferably be received on, if the sink has one
+     */
+    virtual std::optional<int> GetNumaNode() const
+    {
+        return std::nullopt;
+    }
+    /**
+     * @brief Called when packets start being received on a different NUMA node
+     */
+    virtual void SetNumaNode(int numaNode)
+    { }
 };
@@ -0,0 +1,181 @@
+/**
+ * @file AsyncServiceConnection.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "AsyncServiceConnection.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+AsyncServiceConnection::AsyncServiceConnection(
+    std::shared_ptr<ServiceConnection> serviceConnection,
+    size_t numThreads,
+    const std::shared_ptr<MetricsRegistry>& metrics)
+:
+    serviceConnection(std::move(serviceConnection))
+{
+    if (metrics != nullptr)
+    {
+        auto addCallDuration = [&metrics](const std::string& method)
+        {
+            return metrics->AddHistogram("ftl_service_call_seconds",
+                "Time taken by calls to the service connection", { { "method", method } });
+        };
+        getHmacKeyDuration = addCallDuration("GetHmacKey");
+        startStreamDuration = addCallDuration("StartStream");
+        updateStreamMetadataBatchDuration = addCallDuration("UpdateStreamMetadataBatch");
+        endStreamDuration = addCallDuration("EndStream");
+        sendJpegPreviewImageDuration = addCallDuration("SendJpegPreviewImage");
+    }
+
+    for (size_t i = 0; i < std::max<size_t>(1, numThreads); ++i)
+    {
+        threads.emplace_back(
+            [this](std::stop_token stopToken)
+            {
+                threadBody(stopToken);
+            });
+    }
+}
+
+AsyncServiceConnection::~AsyncServiceConnection()
+{
+    for (auto& thread : threads)
+    {
+        thread.request_stop();
+    }
+    for (auto& thread : threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    // Nobody is left to run these, but their callers may still be waiting on them
+    for (auto& pendingCall : pendingCalls)
+    {
+        pendingCall.Fail("Service connection is shutting down");
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+std::future<Result<std::vector<std::byte>>> AsyncServiceConnection::GetHmacKey(
+    ftl_channel_id_t channelId)
+{
+    return submit<Result<std::vector<std::byte>>>(
+        [channelId](ServiceConnection& connection)
+        {
+            return connection.GetHmacKey(channelId);
+        },
+        [](const std::string& message)
+        {
+            return Result<std::vector<std::byte>>::Error(message);
+        },
+        getHmacKeyDuration);
+}
+
+std::future<Result<ftl_stream_id_t>> AsyncServiceConnection::StartStream(
+    ftl_channel_id_t channelId)
+{
+    return submit<Result<ftl_stream_id_t>>(
+        [channelId](ServiceConnection& connection)
+        {
+            return connection.StartStream(channelId);
+        },
+        [](const std::string& message)
+        {
+            return Result<ftl_stream_id_t>::Error(message);
+        },
+        startStreamDuration);
+}
+
+std::future<std::vector<Result<ServiceConnection::ServiceResponse>>>
+    AsyncServiceConnection::UpdateStreamMetadataBatch(
+        std::vector<std::pair<ftl_stream_id_t, StreamMetadata>> updates)
+{
+    const size_t numUpdates = updates.size();
+    return submit<std::vector<Result<ServiceConnection::ServiceResponse>>>(
+        [updates = std::move(updates)](ServiceConnection& connection)
+        {
+            return connection.UpdateStreamMetadataBatch(updates);
+        },
+        [numUpdates](const std::string& message)
+        {
+            return std::vector<Result<ServiceConnection::ServiceResponse>>(numUpdates,
+                Result<ServiceConnection::ServiceResponse>::Error(message));
+        },
+        updateStreamMetadataBatchDuration);
+}
+
+std::future<Result<void>> AsyncServiceConnection::EndStream(ftl_stream_id_t streamId)
+{
+    return submit<Result<void>>(
+        [streamId](ServiceConnection& connection)
+        {
+            return connection.EndStream(streamId);
+        },
+        [](const std::string& message)
+        {
+            return Result<void>::Error(message);
+        },
+        endStreamDuration);
+}
+
+std::future<Result<void>> AsyncServiceConnection::SendJpegPreviewImage(
+    ftl_stream_id_t streamId, std::vector<uint8_t> jpegData)
+{
+    return submit<Result<void>>(
+        [streamId, jpegData = std::move(jpegData)](ServiceConnection& connection)
+        {
+            return connection.SendJpegPreviewImage(streamId, jpegData);
+        },
+        [](const std::string& message)
+        {
+            return Result<void>::Error(message);
+        },
+        sendJpegPreviewImageDuration);
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t AsyncServiceConnection::GetPendingCallCount()
+{
+    std::scoped_lock lock(mutex);
+    return pendingCalls.size();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void AsyncServiceConnection::threadBody(std::stop_token stopToken)
+{
+    std::unique_lock lock(mutex);
+    while (!stopToken.stop_requested())
+    {
+        if (!callCondition.wait(lock, stopToken, [this]() { return !pendingCalls.empty(); }))
+        {
+            break;
+        }
+
+        PendingCall pendingCall = std::move(pendingCalls.front());
+        pendingCalls.pop_front();
+        lock.unlock();
+        pendingCall.Run();
+        lock.lock();
+    }
+}
+
+void AsyncServiceConnection::recordCallDuration(
+    const std::shared_ptr<MetricHistogram>& callDuration,
+    std::chrono::steady_clock::time_point startTime)
+{
+    if (callDuration != nullptr)
+    {
+        callDuration->ObserveDuration(std::chrono::steady_clock::now() - startTime);
+    }
+}
+#pragma endregion Private methods
@@ -0,0 +1,143 @@
+/**
+ * @file AsyncServiceConnection.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "ServiceConnection.h"
+#include "../Utilities/Metrics.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief
+ *  Runs calls to a ServiceConnection on a dedicated set of I/O threads, so that a slow or
+ *  unavailable service only delays the results of those calls rather than the threads making
+ *  them. Every call returns a future that is always fulfilled: failures, including exceptions
+ *  thrown by the service connection, are reported as error results.
+ */
+class AsyncServiceConnection
+{
+public:
+    /* Constants */
+    static constexpr size_t MAX_PENDING_CALLS = 1024;
+
+    /* Constructor/Destructor */
+    /**
+     * @param metrics where to record how long each kind of call takes, if anywhere
+     */
+    AsyncServiceConnection(std::shared_ptr<ServiceConnection> serviceConnection,
+        size_t numThreads = 1, const std::shared_ptr<MetricsRegistry>& metrics = nullptr);
+    /**
+     * @brief Waits for in-progress calls to finish, and fails any that haven't started
+     */
+    ~AsyncServiceConnection();
+
+    /* Public methods */
+    std::future<Result<std::vector<std::byte>>> GetHmacKey(ftl_channel_id_t channelId);
+    std::future<Result<ftl_stream_id_t>> StartStream(ftl_channel_id_t channelId);
+    std::future<std::vector<Result<ServiceConnection::ServiceResponse>>>
+        UpdateStreamMetadataBatch(std::vector<std::pair<ftl_stream_id_t, StreamMetadata>> updates);
+    std::future<Result<void>> EndStream(ftl_stream_id_t streamId);
+    std::future<Result<void>> SendJpegPreviewImage(ftl_stream_id_t streamId,
+        std::vector<uint8_t> jpegData);
+
+    /* Getters/Setters */
+    size_t GetPendingCallCount();
+
+private:
+    /* Private types */
+    struct PendingCall
+    {
+        std::function<void()> Run;
+        std::function<void(const std::string&)> Fail;
+    };
+
+    /* Private fields */
+    const std::shared_ptr<ServiceConnection> serviceConnection;
+    // Time each kind of call spends running, or null if not recorded
+    std::shared_ptr<MetricHistogram> getHmacKeyDuration;
+    std::shared_ptr<MetricHistogram> startStreamDuration;
+    std::shared_ptr<MetricHistogram> updateStreamMetadataBatchDuration;
+    std::shared_ptr<MetricHistogram> endStreamDuration;
+    std::shared_ptr<MetricHistogram> sendJpegPreviewImageDuration;
+    std::mutex mutex;
+    std::condition_variable_any callCondition;
+    std::list<PendingCall> pendingCalls;
+    std::vector<std::jthread> threads;
+
+    /* Private methods */
+    void threadBody(std::stop_token stopToken);
+    static void recordCallDuration(const std::shared_ptr<MetricHistogram>& callDuration,
+        std::chrono::steady_clock::time_point startTime);
+    /**
+     * @brief
+     *  Queues a call to run on an I/O thread
+     * @param call invoked with the service connection to produce the result
+     * @param makeError produces the result to report if the call fails
+     * @param callDuration records how long the call takes to run, if not null
+     */
+    template<typename T, typename Callable, typename ErrorCallable>
+    std::future<T> submit(Callable call, ErrorCallable makeError,
+        const std::shared_ptr<MetricHistogram>& callDuration)
+    {
+        auto promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+        PendingCall pendingCall
+        {
+            .Run = [this, promise, call = std::move(call), makeError, callDuration]() mutable
+                {
+                    const auto startTime = std::chrono::steady_clock::now();
+                    try
+                    {
+                        T result = call(*serviceConnection);
+                        recordCallDuration(callDuration, startTime);
+                        promise->set_value(std::move(result));
+                    }
+                    catch (const std::exception& e)
+                    {
+                        recordCallDuration(callDuration, startTime);
+                        promise->set_value(makeError(e.what()));
+                    }
+                },
+            .Fail = [promise, makeError](const std::string& message)
+                {
+                    promise->set_value(makeError(message));
+                },
+        };
+
+        bool isQueued = false;
+        {
+            std::scoped_lock lock(mutex);
+            if (pendingCalls.size() < MAX_PENDING_CALLS)
+            {
+                pendingCalls.push_back(std::move(pendingCall));
+                isQueued = true;
+            }
+        }
+        if (isQueued)
+        {
+            callCondition.notify_one();
+        }
+        else
+        {
+            pendingCall.Fail("Too many service calls are pending");
+        }
+        return future;
+    }
+};
@@ -31,6 +31,8 @@ public:
     Result<ftl_stream_id_t> StartStream(ftl_channel_id_t channelId) override;
     Result<ServiceResponse> UpdateStreamMetadata(ftl_stream_id_t streamId,
         StreamMetadata metadata) override;
+    std::vector<Result<ServiceResponse>> UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates) override;
     Result<void> EndStream(ftl_stream_id_t streamId) override;
     Result<void> SendJpegPreviewImage(ftl_stream_id_t streamId,
         std::vector<uint8_t> jpegData) override;
@@ -60,6 +60,19 @@ Result<ServiceConnection::ServiceResponse> EdgeNodeServiceConnection::UpdateStre
     return Result<ServiceResponse>::Success(ServiceResponse::Ok);
 }
 
+std::vector<Result<ServiceConnection::ServiceResponse>>
+    EdgeNodeServiceConnection::UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates)
+{
+    std::vector<Result<ServiceResponse>> results;
+    results.reserve(updates.size());
+    for (const auto& [streamId, metadata] : updates)
+    {
+        results.push_back(UpdateStreamMetadata(streamId, metadata));
+    }
+    return results;
+}
+
 Result<void> EdgeNodeServiceConnection::EndStream(ftl_stream_id_t streamId)
 {
     return Result<void>::Success();
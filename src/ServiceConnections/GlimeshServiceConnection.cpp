@@ -12,7 +12,10 @@
 
 #include "../Utilities/FtlTypes.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <jansson.h>
+#include <optional>
 #include <string.h>
 
 #pragma region Constructor/Destructor
@@ -25,7 +28,8 @@ GlimeshServiceConnection::GlimeshServiceConnection(
     baseUri(fmt::format("{}://{}:{}", (useHttps ? "https" : "http"), hostname, port)),
     hostname(hostname),
     clientId(clientId),
-    clientSecret(clientSecret)
+    clientSecret(clientSecret),
+    httpClients([this]() { return createHttpClient(); })
 { }
 #pragma endregion
 
@@ -35,7 +39,7 @@ void GlimeshServiceConnection::Init()
     spdlog::info("Using Glimesh Service Connection @ {}", baseUri);
 
     // Try to auth
-    ensureAuth(*getHttpClient());
+    ensureAuth(*httpClients.Acquire());
 }
 
 Result<std::vector<std::byte>> GlimeshServiceConnection::GetHmacKey(uint32_t channelId)
@@ -93,76 +97,44 @@ Result<ftl_stream_id_t> GlimeshServiceConnection::StartStream(ftl_channel_id_t c
 Result<ServiceConnection::ServiceResponse> GlimeshServiceConnection::UpdateStreamMetadata(
     ftl_stream_id_t streamId, StreamMetadata metadata)
 {
-    // TODO: channelId -> streamId
-    std::stringstream query;
-    query << "mutation($streamId: ID!, $streamMetadata: StreamMetadataInput!) " << 
-        "{ logStreamMetadata(streamId: $streamId, metadata: $streamMetadata) { id } }";
-
-    // Create a json object to contain query variables
-    JsonPtr queryVariables(json_pack(
-        "{s:i, s:{s:s, s:s, s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:s, s:s, s:s, s:i, s:i}}",
-        "streamId",          streamId,
-        "streamMetadata", 
-        "audioCodec",        metadata.audioCodec.c_str(),
-        "ingestServer",      metadata.ingestServerHostname.c_str(),
-        "ingestViewers",     metadata.numActiveViewers,
-        "lostPackets",       metadata.numPacketsLost,
-        "nackPackets",       metadata.numPacketsNacked,
-        "recvPackets",       metadata.numPacketsReceived,
-        "sourceBitrate",     metadata.currentSourceBitrateBps,
-        "sourcePing",        metadata.streamerToIngestPingMs,
-        "streamTimeSeconds", metadata.streamTimeSeconds,
-        "vendorName",        metadata.streamerClientVendorName.c_str(),
-        "vendorVersion",     metadata.streamerClientVendorVersion.c_str(),
-        "videoCodec",        metadata.videoCodec.c_str(),
-        "videoHeight",       metadata.videoHeight,
-        "videoWidth",        metadata.videoWidth
-    ));
-
-    JsonPtr queryResult = runGraphQlQuery(query.str(), std::move(queryVariables));
+    return UpdateStreamMetadataBatch({ { streamId, std::move(metadata) } }).front();
+}
 
-    // Check for GraphQL errors.
-    json_t* errorsData = json_object_get(queryResult.get(), "errors");
-    if (errorsData != nullptr)
+std::vector<Result<ServiceConnection::ServiceResponse>>
+    GlimeshServiceConnection::UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates)
+{
+    std::vector<Result<ServiceResponse>> results;
+    results.reserve(updates.size());
+    for (size_t batchStart = 0; batchStart < updates.size();
+        batchStart += MAX_METADATA_BATCH_SIZE)
     {
-        // Try to extract the error message(s) so we can at least log it(them)
-        if (!json_is_array(errorsData))
+        const size_t batchSize = std::min(MAX_METADATA_BATCH_SIZE, (updates.size() - batchStart));
+
+        // Each stream gets its own aliased mutation (s0, s1, ...) so that one request can
+        // update every stream in the batch
+        std::stringstream variableDefinitions;
+        std::stringstream mutations;
+        JsonPtr queryVariables(json_object());
+        for (size_t i = 0; i < batchSize; ++i)
         {
-            return Result<ServiceResponse>::Error(
-                "Received GraphQL error of an unexpected format.");
-        }
-        size_t errorCount = json_array_size(errorsData);
-        for (size_t i = 0; i < errorCount; ++i)
-        {
-            json_t* errorData = json_array_get(errorsData, i);
-            json_t* errorMessageData = json_object_get(errorData, "message");
-            if ((errorMessageData != nullptr) && json_is_string(errorMessageData))
-            {
-                spdlog::info("UpdateStreamMetadata received GraphQL error: {}",
-                    json_string_value(errorMessageData));
-            }
+            const auto& [streamId, metadata] = updates.at(batchStart + i);
+            variableDefinitions << ((i > 0) ? ", " : "") << "$streamId" << i << ": ID!, " <<
+                "$streamMetadata" << i << ": StreamMetadataInput!";
+            mutations << " s" << i << ": logStreamMetadata(streamId: $streamId" << i <<
+                ", metadata: $streamMetadata" << i << ") { id }";
+            json_object_set_new(queryVariables.get(), fmt::format("streamId{}", i).c_str(),
+                json_integer(streamId));
+            json_object_set_new(queryVariables.get(), fmt::format("streamMetadata{}", i).c_str(),
+                packStreamMetadata(metadata).release());
         }
-        // Right now, we assume that an error means the stream has been shut down by the service.
-        return Result<ServiceResponse>::Success(ServiceResponse::EndStream);
-    }
+        std::stringstream query;
+        query << "mutation(" << variableDefinitions.str() << ") {" << mutations.str() << " }";
 
-    json_t* jsonData = json_object_get(queryResult.get(), "data");
-    if (jsonData != nullptr)
-    {
-        json_t* jsonStream = json_object_get(jsonData, "logStreamMetadata");
-        if (jsonStream != nullptr)
-        {
-            json_t* jsonStreamId = json_object_get(jsonStream, "id");
-            if (jsonStreamId != nullptr)
-            {
-                // uint32_t updatedStreamId = json_integer_value(jsonStreamId);
-                // TOTO: Handle error case
-                return Result<ServiceResponse>::Success(ServiceResponse::Ok);
-            }
-        }
+        JsonPtr queryResult = runGraphQlQuery(query.str(), std::move(queryVariables));
+        processMetadataBatchResult(queryResult, batchSize, results);
     }
-
-    return Result<ServiceResponse>::Error("Error updating stream metadata.");
+    return results;
 }
 
 Result<void> GlimeshServiceConnection::EndStream(ftl_stream_id_t streamId)
@@ -215,8 +187,102 @@ Result<void> GlimeshServiceConnection::SendJpegPreviewImage(
 #pragma endregion
 
 #pragma region Private methods
-std::unique_ptr<httplib::Client> GlimeshServiceConnection::getHttpClient() {
+JsonPtr GlimeshServiceConnection::packStreamMetadata(const StreamMetadata& metadata)
+{
+    return JsonPtr(json_pack(
+        "{s:s, s:s, s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:s, s:s, s:s, s:i, s:i}",
+        "audioCodec",        metadata.audioCodec.c_str(),
+        "ingestServer",      metadata.ingestServerHostname.c_str(),
+        "ingestViewers",     metadata.numActiveViewers,
+        "lostPackets",       metadata.numPacketsLost,
+        "nackPackets",       metadata.numPacketsNacked,
+        "recvPackets",       metadata.numPacketsReceived,
+        "sourceBitrate",     metadata.currentSourceBitrateBps,
+        "sourcePing",        metadata.streamerToIngestPingMs,
+        "streamTimeSeconds", metadata.streamTimeSeconds,
+        "vendorName",        metadata.streamerClientVendorName.c_str(),
+        "vendorVersion",     metadata.streamerClientVendorVersion.c_str(),
+        "videoCodec",        metadata.videoCodec.c_str(),
+        "videoHeight",       metadata.videoHeight,
+        "videoWidth",        metadata.videoWidth
+    ));
+}
+
+void GlimeshServiceConnection::processMetadataBatchResult(const JsonPtr& queryResult,
+    size_t batchSize, std::vector<Result<ServiceResponse>>& results)
+{
+    // Check for GraphQL errors. Errors name the alias of the mutation they came from in their
+    // path, so they can be attributed to a single stream.
+    std::vector<bool> isStreamErrored(batchSize, false);
+    json_t* errorsData = json_object_get(queryResult.get(), "errors");
+    if (errorsData != nullptr)
+    {
+        // Try to extract the error message(s) so we can at least log it(them)
+        if (!json_is_array(errorsData))
+        {
+            for (size_t i = 0; i < batchSize; ++i)
+            {
+                results.push_back(Result<ServiceResponse>::Error(
+                    "Received GraphQL error of an unexpected format."));
+            }
+            return;
+        }
+        size_t errorCount = json_array_size(errorsData);
+        for (size_t i = 0; i < errorCount; ++i)
+        {
+            json_t* errorData = json_array_get(errorsData, i);
+            json_t* errorMessageData = json_object_get(errorData, "message");
+            if ((errorMessageData != nullptr) && json_is_string(errorMessageData))
+            {
+                spdlog::info("UpdateStreamMetadata received GraphQL error: {}",
+                    json_string_value(errorMessageData));
+            }
+
+            json_t* aliasData = json_array_get(json_object_get(errorData, "path"), 0);
+            size_t aliasIndex = batchSize;
+            if ((aliasData != nullptr) && json_is_string(aliasData) &&
+                (json_string_value(aliasData)[0] == 's'))
+            {
+                aliasIndex = std::strtoul(json_string_value(aliasData) + 1, nullptr, 10);
+            }
+            if (aliasIndex < batchSize)
+            {
+                isStreamErrored[aliasIndex] = true;
+            }
+            else
+            {
+                // We can't tell which stream this error is for, so it applies to all of them
+                isStreamErrored.assign(batchSize, true);
+            }
+        }
+    }
+
+    json_t* jsonData = json_object_get(queryResult.get(), "data");
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+        if (isStreamErrored[i])
+        {
+            // Right now, we assume that an error means the stream has been shut down by the
+            // service.
+            results.push_back(Result<ServiceResponse>::Success(ServiceResponse::EndStream));
+            continue;
+        }
+
+        json_t* jsonStream = json_object_get(jsonData, fmt::format("s{}", i).c_str());
+        if (json_object_get(jsonStream, "id") != nullptr)
+        {
+            results.push_back(Result<ServiceResponse>::Success(ServiceResponse::Ok));
+        }
+        else
+        {
+            results.push_back(Result<ServiceResponse>::Error("Error updating stream metadata."));
+        }
+    }
+}
+
+std::unique_ptr<httplib::Client> GlimeshServiceConnection::createHttpClient() {
     auto client = std::make_unique<httplib::Client>(baseUri.c_str());
+    client->set_keep_alive(true);
     client->set_socket_options([this](socket_t sock) {
         // TODO: Remove once yhirose/cpp-httplib#873 is resolved
         struct timeval tv{};
@@ -300,11 +366,6 @@ JsonPtr GlimeshServiceConnection::runGraphQlQuery(
     JsonPtr variables,
     httplib::MultipartFormDataItems fileData)
 {
-    std::unique_ptr<httplib::Client> httpClient = getHttpClient();
-
-    // Make sure we have a valid access token
-    ensureAuth(*httpClient);
-
     std::string queryString;
 
     // If we're doing a file upload, we pack this all into a multipart request
@@ -329,46 +390,43 @@ JsonPtr GlimeshServiceConnection::runGraphQlQuery(
     }
 
     // Make the request, and retry if necessary
-    int numRetries = 0;
+    RetryBackoff backoff(RETRY_POLICY);
     while (true)
     {
-        JsonPtr result = nullptr;
+        ClientPool<httplib::Client>::Lease httpClient = httpClients.Acquire();
 
-        // If we're doing files, use a multipart http request
-        if (fileData.size() > 0)
-        {
-            httplib::Result response = httpClient->Post("/api", fileData);
-            result = processGraphQlResponse(response);
-        }
-        // otherwise, stick with post body
-        else
-        {
-            httplib::Result response = httpClient->Post("/api", queryString, "application/json");
-            result = processGraphQlResponse(response);
-        }
+        // Make sure we have a valid access token
+        ensureAuth(*httpClient);
 
+        // If we're doing files, use a multipart http request, otherwise stick with post body
+        httplib::Result response = (fileData.size() > 0) ?
+            httpClient->Post("/api", fileData) :
+            httpClient->Post("/api", queryString, "application/json");
+        JsonPtr result = processGraphQlResponse(response);
         if (result != nullptr)
         {
             return result;
         }
-
-        if (numRetries < MAX_RETRIES)
+        // A client whose request never got a response may be left with a broken connection
+        if (!response)
         {
-            spdlog::warn("Attempt {} / {}: Glimesh GraphQL query failed. "
-                "Retrying in {} ms...", (numRetries + 1), MAX_RETRIES, TIME_BETWEEN_RETRIES_MS);
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(TIME_BETWEEN_RETRIES_MS));
-            ++numRetries;
+            httpClient.Discard();
         }
-        else
+
+        // Back off, but don't keep trying past the request's deadline
+        std::optional<std::chrono::milliseconds> retryDelay = backoff.NextDelay();
+        if (!retryDelay.has_value())
         {
             break;
         }
+        spdlog::warn("Attempt {}: Glimesh GraphQL query failed. Retrying in {} ms...",
+            backoff.GetRetryCount(), retryDelay->count());
+        std::this_thread::sleep_for(retryDelay.value());
     }
     
-    // We've exceeded our retry limit
+    // We've run out of time
     spdlog::error("Aborting Glimesh GraphQL query after {} failed attempts.",
-        MAX_RETRIES);
+        (backoff.GetRetryCount() + 1));
 
     throw ServiceConnectionCommunicationFailedException("Glimesh GraphQL query failed.");
 }
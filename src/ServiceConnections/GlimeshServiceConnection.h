@@ -11,7 +11,9 @@
 #pragma once
 
 #include "ServiceConnection.h"
+#include "../Utilities/ClientPool.h"
 #include "../Utilities/JanssonPtr.h"
+#include "../Utilities/RetryBackoff.h"
 
 #include <chrono>
 #include <ctime>
@@ -42,15 +44,19 @@ public:
     Result<ftl_stream_id_t> StartStream(ftl_channel_id_t channelId) override;
     Result<ServiceResponse> UpdateStreamMetadata(ftl_stream_id_t streamId,
         StreamMetadata metadata) override;
+    std::vector<Result<ServiceResponse>> UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates) override;
     Result<void> EndStream(ftl_stream_id_t streamId) override;
     Result<void> SendJpegPreviewImage(ftl_stream_id_t streamId,
         std::vector<uint8_t> jpegData) override;
 
 private:
     /* Private members */
-    const int MAX_RETRIES = 10;
-    const int TIME_BETWEEN_RETRIES_MS = 3000;
+    // Failed requests are retried with increasing delays for up to this long in total
+    const RetryBackoff::Policy RETRY_POLICY { .Timeout = std::chrono::milliseconds(30000) };
     const int DEFAULT_SOCKET_RECEIVE_TIMEOUT_SEC = 1;
+    // Streams updated per metadata request, to keep requests a reasonable size
+    static constexpr size_t MAX_METADATA_BATCH_SIZE = 50;
     std::string baseUri;
     std::string hostname;
     std::string clientId;
@@ -58,11 +64,16 @@ private:
     std::string accessToken;
     std::time_t accessTokenExpirationTime;
     std::mutex authMutex;
+    // Keep-alive clients, so requests don't each pay for a new connection and TLS handshake
+    ClientPool<httplib::Client> httpClients;
 
     /* Private methods */
-    std::unique_ptr<httplib::Client> getHttpClient();
+    std::unique_ptr<httplib::Client> createHttpClient();
     void ensureAuth(httplib::Client& httpClient);
     JsonPtr runGraphQlQuery(std::string query, JsonPtr variables = nullptr, httplib::MultipartFormDataItems fileData = httplib::MultipartFormDataItems());
     JsonPtr processGraphQlResponse(const httplib::Result& result);
+    JsonPtr packStreamMetadata(const StreamMetadata& metadata);
+    void processMetadataBatchResult(const JsonPtr& queryResult, size_t batchSize,
+        std::vector<Result<ServiceResponse>>& results);
     tm parseIso8601DateTime(std::string dateTimeString);
 };
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file HmacKeyCache.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "HmacKeyCache.h"
+
+#include <algorithm>
+#include <exception>
+
+#pragma region Constructor/Destructor
+HmacKeyCache::HmacKeyCache(KeyFetcher fetchKey, std::chrono::milliseconds ttl,
+    std::chrono::milliseconds negativeTtl)
+:
+    fetchKey(std::move(fetchKey)),
+    ttl(ttl),
+    negativeTtl(negativeTtl)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+Result<std::vector<std::byte>> HmacKeyCache::GetHmacKey(ftl_channel_id_t channelId)
+{
+    std::unique_lock lock(mutex);
+    auto it = entries.find(channelId);
+    if (it != entries.end())
+    {
+        const Entry& entry = it->second;
+        if (!entry.ExpiryTime.has_value() ||
+            (std::chrono::steady_clock::now() < entry.ExpiryTime.value()))
+        {
+            // Either cached, or someone else is already asking the service for it
+            std::shared_future<Result<std::vector<std::byte>>> key = entry.Key;
+            lock.unlock();
+            return key.get();
+        }
+        entries.erase(it);
+    }
+
+    // We're the first to ask, so look the key up and let anyone else who asks in the meantime
+    // wait on our result
+    std::promise<Result<std::vector<std::byte>>> keyPromise;
+    const uint64_t generation = nextGeneration++;
+    entries.insert_or_assign(channelId, Entry
+        {
+            .Key = keyPromise.get_future().share(),
+            .ExpiryTime = std::nullopt,
+            .Generation = generation,
+        });
+    if (entries.size() >= nextPurgeSize)
+    {
+        purgeExpiredEntries(std::chrono::steady_clock::now(), lock);
+    }
+    lock.unlock();
+
+    Result<std::vector<std::byte>> keyResult;
+    try
+    {
+        keyResult = fetchKey(channelId);
+    }
+    catch (const std::exception& e)
+    {
+        keyResult = Result<std::vector<std::byte>>::Error(e.what());
+    }
+    keyPromise.set_value(keyResult);
+
+    lock.lock();
+    it = entries.find(channelId);
+    if ((it != entries.end()) && (it->second.Generation == generation))
+    {
+        const std::chrono::milliseconds entryTtl = keyResult.IsError ? negativeTtl : ttl;
+        if (entryTtl > std::chrono::milliseconds(0))
+        {
+            it->second.ExpiryTime = std::chrono::steady_clock::now() + entryTtl;
+        }
+        else
+        {
+            entries.erase(it);
+        }
+    }
+    return keyResult;
+}
+
+void HmacKeyCache::Invalidate(ftl_channel_id_t channelId)
+{
+    std::scoped_lock lock(mutex);
+    entries.erase(channelId);
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t HmacKeyCache::GetSize()
+{
+    std::scoped_lock lock(mutex);
+    return entries.size();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void HmacKeyCache::purgeExpiredEntries(std::chrono::steady_clock::time_point now,
+    const std::unique_lock<std::mutex>& lock)
+{
+    std::erase_if(entries,
+        [now](const auto& entryPair)
+        {
+            const Entry& entry = entryPair.second;
+            return (entry.ExpiryTime.has_value() && (now >= entry.ExpiryTime.value()));
+        });
+    // Don't sweep again until the cache has grown well past what's still live
+    nextPurgeSize = std::max(MIN_PURGE_SIZE, entries.size() * 2);
+}
+#pragma endregion Private methods
@@ -0,0 +1,90 @@
+/**
+ * @file HmacKeyCache.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../Utilities/FtlTypes.h"
+#include "../Utilities/Result.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  Remembers HMAC keys fetched from the service for a while, so a wave of streamers
+ *  reconnecting at once doesn't turn into a wave of key requests. Failed lookups (such as for
+ *  unknown channels) are remembered too, for their own, usually shorter, time. Concurrent
+ *  lookups for the same channel share a single request to the service.
+ */
+class HmacKeyCache
+{
+public:
+    /* Public types */
+    using KeyFetcher = std::function<Result<std::vector<std::byte>>(ftl_channel_id_t)>;
+
+    /* Constants */
+    // Expired entries are swept out whenever the cache grows past this many
+    static constexpr size_t MIN_PURGE_SIZE = 256;
+
+    /* Constructor/Destructor */
+    /**
+     * @param fetchKey looks up a key from the service, called without any locks held
+     * @param ttl how long fetched keys are kept
+     * @param negativeTtl how long failed lookups are kept, or zero to not keep them at all
+     */
+    HmacKeyCache(KeyFetcher fetchKey, std::chrono::milliseconds ttl,
+        std::chrono::milliseconds negativeTtl);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Returns the cached key for the given channel, joining a lookup that's already in progress
+     *  or starting a new one if there's nothing cached
+     */
+    Result<std::vector<std::byte>> GetHmacKey(ftl_channel_id_t channelId);
+
+    /**
+     * @brief
+     *  Forgets anything cached for the given channel, so the next lookup goes to the service. A
+     *  lookup that's in progress is still shared with its callers, but isn't cached.
+     */
+    void Invalidate(ftl_channel_id_t channelId);
+
+    /* Getters/Setters */
+    size_t GetSize();
+
+private:
+    /* Private types */
+    struct Entry
+    {
+        std::shared_future<Result<std::vector<std::byte>>> Key;
+        // Unset while the lookup is in progress
+        std::optional<std::chrono::steady_clock::time_point> ExpiryTime;
+        // Tells lookups apart, so a lookup can tell its entry hasn't been replaced
+        uint64_t Generation = 0;
+    };
+
+    /* Private fields */
+    const KeyFetcher fetchKey;
+    const std::chrono::milliseconds ttl;
+    const std::chrono::milliseconds negativeTtl;
+    std::mutex mutex;
+    std::unordered_map<ftl_channel_id_t, Entry> entries;
+    uint64_t nextGeneration = 1;
+    size_t nextPurgeSize = MIN_PURGE_SIZE;
+
+    /* Private methods */
+    void purgeExpiredEntries(std::chrono::steady_clock::time_point now,
+        const std::unique_lock<std::mutex>& lock);
+};
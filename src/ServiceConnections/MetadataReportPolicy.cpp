@@ -0,0 +1,90 @@
+/**
+ * @file MetadataReportPolicy.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "MetadataReportPolicy.h"
+
+#include <algorithm>
+#include <cmath>
+
+#pragma region Constructor/Destructor
+MetadataReportPolicy::MetadataReportPolicy(Policy policy, uint32_t seed)
+:
+    policy(policy),
+    randomEngine(seed)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool MetadataReportPolicy::ShouldReport(ftl_stream_id_t streamId,
+    const StreamMetadata& metadata, Clock::time_point now) const
+{
+    if (policy.HeartbeatInterval.count() <= 0)
+    {
+        return true;
+    }
+    auto streamIt = reportedStreams.find(streamId);
+    if (streamIt == reportedStreams.end())
+    {
+        return true;
+    }
+    return ((now >= streamIt->second.NextHeartbeat) ||
+        isMeaningfulChange(streamIt->second.Metadata, metadata));
+}
+
+void MetadataReportPolicy::Reported(ftl_stream_id_t streamId, const StreamMetadata& metadata,
+    Clock::time_point now)
+{
+    if (policy.HeartbeatInterval.count() <= 0)
+    {
+        return;
+    }
+    // Only ever brought forward, so the service never goes longer than the interval
+    // without hearing about a stream
+    std::uniform_real_distribution<double> jitterDistribution(0.0,
+        std::clamp(policy.HeartbeatJitter, 0.0, 1.0));
+    const auto heartbeatDelay = std::chrono::duration_cast<Clock::duration>(
+        policy.HeartbeatInterval * (1.0 - jitterDistribution(randomEngine)));
+    reportedStreams.insert_or_assign(streamId, ReportedStream
+        {
+            .Metadata = metadata,
+            .NextHeartbeat = (now + heartbeatDelay),
+        });
+}
+
+void MetadataReportPolicy::RemoveStream(ftl_stream_id_t streamId)
+{
+    reportedStreams.erase(streamId);
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t MetadataReportPolicy::GetStreamCount() const
+{
+    return reportedStreams.size();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+bool MetadataReportPolicy::isMeaningfulChange(const StreamMetadata& reported,
+    const StreamMetadata& current) const
+{
+    // Durations and packet counts go up every report, they alone aren't worth one
+    if ((current.numActiveViewers != reported.numActiveViewers) ||
+        (current.numPacketsLost > reported.numPacketsLost) ||
+        (current.videoWidth != reported.videoWidth) ||
+        (current.videoHeight != reported.videoHeight) ||
+        (current.videoCodec != reported.videoCodec) ||
+        (current.audioCodec != reported.audioCodec))
+    {
+        return true;
+    }
+    const double bitrateChange = std::abs(static_cast<double>(current.currentSourceBitrateBps) -
+        static_cast<double>(reported.currentSourceBitrateBps));
+    return (bitrateChange > 0) &&
+        (bitrateChange >= (policy.BitrateChangeThreshold * reported.currentSourceBitrateBps));
+}
+#pragma endregion Private methods
@@ -0,0 +1,78 @@
+/**
+ * @file MetadataReportPolicy.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../Utilities/FtlTypes.h"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+
+/**
+ * @brief
+ *  Decides which streams' metadata is worth sending to the service each report cycle. A
+ *  stream is reported when something the service cares about has meaningfully changed since
+ *  its last report, such as its viewer count, its bitrate moving by more than a threshold,
+ *  or new packet loss, and otherwise only as a heartbeat. Heartbeats are jittered so streams
+ *  that started together don't keep being reported together. Not thread-safe.
+ */
+class MetadataReportPolicy
+{
+public:
+    /* Public types */
+    using Clock = std::chrono::steady_clock;
+
+    struct Policy
+    {
+        // Longest a stream goes without being reported, or 0 to report every stream every time
+        std::chrono::milliseconds HeartbeatInterval { 0 };
+        // Change in bitrate, as a fraction of the last one reported, that's worth reporting
+        double BitrateChangeThreshold = 0.1;
+        // Most each heartbeat is brought forward by, as a fraction of the interval
+        double HeartbeatJitter = 0.2;
+    };
+
+    /* Constructor/Destructor */
+    MetadataReportPolicy(Policy policy, uint32_t seed = std::random_device()());
+
+    /* Public methods */
+    /**
+     * @brief Whether the given stream's metadata should be sent to the service now
+     */
+    bool ShouldReport(ftl_stream_id_t streamId, const StreamMetadata& metadata,
+        Clock::time_point now) const;
+    /**
+     * @brief Notes that the given metadata has been sent, pushing the next heartbeat back
+     */
+    void Reported(ftl_stream_id_t streamId, const StreamMetadata& metadata,
+        Clock::time_point now);
+    /**
+     * @brief Forgets a stream that has gone away
+     */
+    void RemoveStream(ftl_stream_id_t streamId);
+
+    /* Getters/Setters */
+    size_t GetStreamCount() const;
+
+private:
+    /* Private types */
+    struct ReportedStream
+    {
+        StreamMetadata Metadata;
+        Clock::time_point NextHeartbeat;
+    };
+
+    /* Private fields */
+    const Policy policy;
+    std::mt19937 randomEngine;
+    std::unordered_map<ftl_stream_id_t, ReportedStream> reportedStreams;
+
+    /* Private methods */
+    bool isMeaningfulChange(const StreamMetadata& reported, const StreamMetadata& current) const;
+};
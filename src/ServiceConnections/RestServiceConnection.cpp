@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <jansson.h>
+#include <optional>
 #include <sstream>
 
 #pragma region Constructor/Destructor
@@ -27,7 +28,8 @@ RestServiceConnection::RestServiceConnection(
     baseUri(fmt::format("{}://{}:{}", (useHttps ? "https" : "http"), hostname, port)),
     hostname(hostname),
     pathBase(pathBase),
-    authToken(authToken)
+    authToken(authToken),
+    httpClients([this]() { return createHttpClientWithAuth(); })
 {
     // Ensure our path base has a starting slash and ending slash
     if (this->pathBase.size() > 0)
@@ -99,29 +101,56 @@ Result<ftl_stream_id_t> RestServiceConnection::StartStream(ftl_channel_id_t chan
 Result<ServiceConnection::ServiceResponse> RestServiceConnection::UpdateStreamMetadata(
     ftl_stream_id_t streamId, StreamMetadata metadata)
 {
-    JsonPtr streamMetadata(json_pack(
-        "{s:s, s:s, s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:s, s:s, s:s, s:i, s:i}",
-        "audioCodec",        metadata.audioCodec.c_str(),
-        "ingestServer",      metadata.ingestServerHostname.c_str(),
-        "ingestViewers",     metadata.numActiveViewers,
-        "lostPackets",       metadata.numPacketsLost,
-        "nackPackets",       metadata.numPacketsNacked,
-        "recvPackets",       metadata.numPacketsReceived,
-        "sourceBitrate",     metadata.currentSourceBitrateBps,
-        "sourcePing",        metadata.streamerToIngestPingMs,
-        "streamTimeSeconds", metadata.streamTimeSeconds,
-        "vendorName",        metadata.streamerClientVendorName.c_str(),
-        "vendorVersion",     metadata.streamerClientVendorVersion.c_str(),
-        "videoCodec",        metadata.videoCodec.c_str(),
-        "videoHeight",       metadata.videoHeight,
-        "videoWidth",        metadata.videoWidth
-    ));
-
-    runPostRequest(fmt::format("metadata/{}", streamId), std::move(streamMetadata));
+    runPostRequest(fmt::format("metadata/{}", streamId), packStreamMetadata(metadata));
     return Result<ServiceConnection::ServiceResponse>::Success(
         ServiceConnection::ServiceResponse::Ok);
 }
 
+std::vector<Result<ServiceConnection::ServiceResponse>>
+    RestServiceConnection::UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates)
+{
+    std::vector<Result<ServiceResponse>> results;
+    results.reserve(updates.size());
+    if (updates.empty())
+    {
+        return results;
+    }
+
+    if (isMetadataBatchSupported)
+    {
+        JsonPtr batch(json_array());
+        for (const auto& [streamId, metadata] : updates)
+        {
+            JsonPtr streamMetadata = packStreamMetadata(metadata);
+            json_object_set_new(streamMetadata.get(), "streamId",
+                json_string(std::to_string(streamId).c_str()));
+            json_array_append_new(batch.get(), streamMetadata.release());
+        }
+
+        httplib::Result response = runPostRequest("metadata", std::move(batch));
+        if ((response->status != 404) && (response->status != 405))
+        {
+            for (size_t i = 0; i < updates.size(); ++i)
+            {
+                results.push_back(Result<ServiceResponse>::Success(ServiceResponse::Ok));
+            }
+            return results;
+        }
+
+        // Older services only know about updating one stream at a time
+        spdlog::info("REST service does not support batched metadata updates, falling back to "
+            "one request per stream");
+        isMetadataBatchSupported = false;
+    }
+
+    for (const auto& [streamId, metadata] : updates)
+    {
+        results.push_back(UpdateStreamMetadata(streamId, metadata));
+    }
+    return results;
+}
+
 Result<void> RestServiceConnection::EndStream(ftl_stream_id_t streamId)
 {
     runPostRequest(fmt::format("end/{}", streamId));
@@ -151,8 +180,30 @@ Result<void> RestServiceConnection::SendJpegPreviewImage(
 #pragma endregion
 
 #pragma region Private methods
-std::unique_ptr<httplib::Client> RestServiceConnection::getHttpClientWithAuth() {
+JsonPtr RestServiceConnection::packStreamMetadata(const StreamMetadata& metadata)
+{
+    return JsonPtr(json_pack(
+        "{s:s, s:s, s:i, s:i, s:i, s:i, s:i, s:i, s:i, s:s, s:s, s:s, s:i, s:i}",
+        "audioCodec",        metadata.audioCodec.c_str(),
+        "ingestServer",      metadata.ingestServerHostname.c_str(),
+        "ingestViewers",     metadata.numActiveViewers,
+        "lostPackets",       metadata.numPacketsLost,
+        "nackPackets",       metadata.numPacketsNacked,
+        "recvPackets",       metadata.numPacketsReceived,
+        "sourceBitrate",     metadata.currentSourceBitrateBps,
+        "sourcePing",        metadata.streamerToIngestPingMs,
+        "streamTimeSeconds", metadata.streamTimeSeconds,
+        "vendorName",        metadata.streamerClientVendorName.c_str(),
+        "vendorVersion",     metadata.streamerClientVendorVersion.c_str(),
+        "videoCodec",        metadata.videoCodec.c_str(),
+        "videoHeight",       metadata.videoHeight,
+        "videoWidth",        metadata.videoWidth
+    ));
+}
+
+std::unique_ptr<httplib::Client> RestServiceConnection::createHttpClientWithAuth() {
     auto httpClient = std::make_unique<httplib::Client>(baseUri.c_str());
+    httpClient->set_keep_alive(true);
     httpClient->set_socket_options([this](socket_t sock) {
         // TODO: Remove once yhirose/cpp-httplib#873 is resolved
         struct timeval tv{};
@@ -182,36 +233,37 @@ std::string RestServiceConnection::relativeToAbsolutePath(std::string relativePa
 
 httplib::Result RestServiceConnection::runGetRequest(std::string path)
 {
-    std::unique_ptr<httplib::Client> httpClient = getHttpClientWithAuth();
-
     // Make the request, and retry if necessary
-    int numRetries = 0;
+    RetryBackoff backoff(RETRY_POLICY);
     while (true)
     {
+        ClientPool<httplib::Client>::Lease httpClient = httpClients.Acquire();
         std::string absolutePath = relativeToAbsolutePath(path);
         httplib::Result response = httpClient->Get(absolutePath.c_str());
         if (response && response.error() == httplib::Error::Success && response->status < 500)
         {
             return response;
         }
-
-        if (numRetries < MAX_RETRIES)
+        // A client whose request never got a response may be left with a broken connection
+        if (!response)
         {
-            spdlog::warn("Attempt {} / {}: REST GET request failed. "
-                "Retrying in {} ms...", (numRetries + 1), MAX_RETRIES, TIME_BETWEEN_RETRIES_MS);
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(TIME_BETWEEN_RETRIES_MS));
-            ++numRetries;
+            httpClient.Discard();
         }
-        else
+
+        // Back off, but don't keep trying past the request's deadline
+        std::optional<std::chrono::milliseconds> retryDelay = backoff.NextDelay();
+        if (!retryDelay.has_value())
         {
             break;
         }
+        spdlog::warn("Attempt {}: REST GET request failed. Retrying in {} ms...",
+            backoff.GetRetryCount(), retryDelay->count());
+        std::this_thread::sleep_for(retryDelay.value());
     }
 
-    // We've exceeded our retry limit
+    // We've run out of time
     spdlog::error("Aborting REST GET request after {} failed attempts.",
-        MAX_RETRIES);
+        (backoff.GetRetryCount() + 1));
 
     throw ServiceConnectionCommunicationFailedException("REST GET request failed.");
 }
@@ -219,12 +271,11 @@ httplib::Result RestServiceConnection::runGetRequest(std::string path)
 httplib::Result RestServiceConnection::runPostRequest(std::string path, JsonPtr body,
     httplib::MultipartFormDataItems fileData)
 {
-    std::unique_ptr<httplib::Client> httpClient = getHttpClientWithAuth();
-
     // Make the request, and retry if necessary
-    int numRetries = 0;
+    RetryBackoff backoff(RETRY_POLICY);
     while (true)
     {
+        ClientPool<httplib::Client>::Lease httpClient = httpClients.Acquire();
         std::string absolutePath = relativeToAbsolutePath(path);
         httplib::Result response = [&]
         {
@@ -249,24 +300,26 @@ httplib::Result RestServiceConnection::runPostRequest(std::string path, JsonPtr
         {
             return response;
         }
-
-        if (numRetries < MAX_RETRIES)
+        // A client whose request never got a response may be left with a broken connection
+        if (!response)
         {
-            spdlog::warn("Attempt {} / {}: REST POST request failed. "
-                "Retrying in {} ms...", (numRetries + 1), MAX_RETRIES, TIME_BETWEEN_RETRIES_MS);
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(TIME_BETWEEN_RETRIES_MS));
-            ++numRetries;
+            httpClient.Discard();
         }
-        else
+
+        // Back off, but don't keep trying past the request's deadline
+        std::optional<std::chrono::milliseconds> retryDelay = backoff.NextDelay();
+        if (!retryDelay.has_value())
         {
             break;
         }
+        spdlog::warn("Attempt {}: REST POST request failed. Retrying in {} ms...",
+            backoff.GetRetryCount(), retryDelay->count());
+        std::this_thread::sleep_for(retryDelay.value());
     }
 
-    // We've exceeded our retry limit
+    // We've run out of time
     spdlog::error("Aborting REST POST request after {} failed attempts.",
-        MAX_RETRIES);
+        (backoff.GetRetryCount() + 1));
 
     throw ServiceConnectionCommunicationFailedException("REST POST request failed.");
 }
@@ -11,8 +11,11 @@
 #pragma once
 
 #include "ServiceConnection.h"
+#include "../Utilities/ClientPool.h"
 #include "../Utilities/JanssonPtr.h"
+#include "../Utilities/RetryBackoff.h"
 
+#include <atomic>
 #include <httplib.h>
 #include <string>
 
@@ -38,22 +41,29 @@ public:
     Result<ftl_stream_id_t> StartStream(ftl_channel_id_t channelId) override;
     Result<ServiceResponse> UpdateStreamMetadata(ftl_stream_id_t streamId,
         StreamMetadata metadata) override;
+    std::vector<Result<ServiceResponse>> UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates) override;
     Result<void> EndStream(ftl_stream_id_t streamId) override;
     Result<void> SendJpegPreviewImage(ftl_stream_id_t streamId,
         std::vector<uint8_t> jpegData) override;
 
 private:
     /* Private members */
-    const int MAX_RETRIES = 5;
-    const int TIME_BETWEEN_RETRIES_MS = 3000;
+    // Failed requests are retried with increasing delays for up to this long in total
+    const RetryBackoff::Policy RETRY_POLICY { .Timeout = std::chrono::milliseconds(15000) };
     const int DEFAULT_SOCKET_RECEIVE_TIMEOUT_SEC = 1;
     std::string baseUri;
     std::string hostname;
     std::string pathBase;
     std::string authToken;
+    // Keep-alive clients, so requests don't each pay for a new connection and TLS handshake
+    ClientPool<httplib::Client> httpClients;
+    // Cleared if the service doesn't know the batched metadata route
+    std::atomic<bool> isMetadataBatchSupported { true };
 
     /* Private methods */
-    std::unique_ptr<httplib::Client> getHttpClientWithAuth();
+    std::unique_ptr<httplib::Client> createHttpClientWithAuth();
+    JsonPtr packStreamMetadata(const StreamMetadata& metadata);
     std::string relativeToAbsolutePath(std::string relativePath);
     httplib::Result runGetRequest(std::string path);
     httplib::Result runPostRequest(std::string path, JsonPtr body = nullptr,
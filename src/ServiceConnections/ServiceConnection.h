@@ -14,6 +14,7 @@
 #include "../Utilities/Result.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -66,6 +67,17 @@ public:
     virtual Result<ServiceResponse> UpdateStreamMetadata(ftl_stream_id_t streamId,
         StreamMetadata metadata) = 0;
 
+    /**
+     * @brief
+     *  Updates the service with metadata about several streams at once, in as few requests
+     *  as the service allows
+     * 
+     * @param updates IDs of streams to update, with the metadata of each
+     * @return a result for each update, in the same order as the updates
+     */
+    virtual std::vector<Result<ServiceResponse>> UpdateStreamMetadataBatch(
+        const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates) = 0;
+
     /**
      * @brief Marks the given stream ID as ended on the service
      * 
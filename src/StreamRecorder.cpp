@@ -0,0 +1,383 @@
+/**
+ * @file StreamRecorder.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "StreamRecorder.h"
+
+#include "Rtp/RtpPacket.h"
+#include "Utilities/Util.h"
+
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+namespace
+{
+    void writeUint16(std::byte* bytes, uint16_t value)
+    {
+        // Network byte order
+        bytes[0] = std::byte((value >> 8) & 0xFF);
+        bytes[1] = std::byte(value & 0xFF);
+    }
+
+    // The header IPv4 would send our datagram with, from and to the loopback address
+    std::array<std::byte, 20> ipv4Header(size_t datagramSize)
+    {
+        std::array<std::byte, 20> header {};
+        header[0] = std::byte(0x45);
+        writeUint16(&header[2], static_cast<uint16_t>(header.size() + datagramSize));
+        // Don't fragment
+        header[6] = std::byte(0x40);
+        header[8] = std::byte(64);
+        header[9] = std::byte(17);
+        for (size_t address : { 12, 16 })
+        {
+            header[address] = std::byte(127);
+            header[address + 3] = std::byte(1);
+        }
+
+        uint32_t checksum = 0;
+        for (size_t i = 0; i < header.size(); i += 2)
+        {
+            checksum += (static_cast<uint32_t>(header[i]) << 8) |
+                static_cast<uint32_t>(header[i + 1]);
+        }
+        checksum = (checksum & 0xFFFF) + (checksum >> 16);
+        checksum = (checksum & 0xFFFF) + (checksum >> 16);
+        writeUint16(&header[10], static_cast<uint16_t>(~checksum));
+        return header;
+    }
+}
+
+#pragma region Static methods
+Result<std::unique_ptr<StreamRecorder>> StreamRecorder::Start(
+    const std::filesystem::path& directory,
+    ftl_channel_id_t channelId,
+    ftl_stream_id_t streamId,
+    MediaMetadata mediaMetadata,
+    uint64_t maxSegmentBytes,
+    bool rotateOnKeyframe,
+    size_t queueCapacity)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        return Result<std::unique_ptr<StreamRecorder>>::Error(fmt::format(
+            "Couldn't create recording directory {}: {}", directory.string(), error.message()));
+    }
+
+    // Streams handed off to a new instance keep their IDs, so the start time keeps their
+    // recordings apart
+    const int64_t startSeconds = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::unique_ptr<StreamRecorder> recorder(new StreamRecorder(
+        (directory / fmt::format("{}-{}-{}", channelId, streamId, startSeconds)),
+        mediaMetadata, maxSegmentBytes, rotateOnKeyframe, queueCapacity));
+
+    // Open the first segment up front, so a directory we can't write to is noticed now
+    Result<void> openResult = recorder->openSegment();
+    if (openResult.IsError)
+    {
+        return Result<std::unique_ptr<StreamRecorder>>::Error(openResult.ErrorMessage);
+    }
+    StreamRecorder& recorderRef = *recorder;
+    recorder->writerThread = std::jthread([&recorderRef]() { recorderRef.writerThreadBody(); });
+    return Result<std::unique_ptr<StreamRecorder>>::Success(std::move(recorder));
+}
+#pragma endregion Static methods
+
+#pragma region Constructor/Destructor
+StreamRecorder::StreamRecorder(std::filesystem::path segmentPathPrefix,
+    MediaMetadata mediaMetadata, uint64_t maxSegmentBytes, bool rotateOnKeyframe,
+    size_t queueCapacity)
+:
+    segmentPathPrefix(std::move(segmentPathPrefix)),
+    mediaMetadata(mediaMetadata),
+    isKeyframePayload(GetKeyframePayloadDetector(mediaMetadata.VideoCodec)),
+    maxSegmentBytes(maxSegmentBytes),
+    rotateOnKeyframe(rotateOnKeyframe),
+    steadyToUnixOffset(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()) -
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())),
+    queue(queueCapacity),
+    writeBuffer(static_cast<std::byte*>(
+        std::aligned_alloc(WRITE_BUFFER_ALIGNMENT, WRITE_BUFFER_SIZE)))
+{ }
+
+StreamRecorder::~StreamRecorder()
+{
+    Stop();
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void StreamRecorder::SendRtpPacket(const PacketBuffer& packet)
+{
+    {
+        std::lock_guard lock(queueMutex);
+        if (isStopping || !queue.Push(packet, packetKind(packet)))
+        {
+            return;
+        }
+    }
+    queueCondition.notify_one();
+}
+
+void StreamRecorder::Stop()
+{
+    {
+        std::lock_guard lock(queueMutex);
+        isStopping = true;
+    }
+    queueCondition.notify_one();
+    if (writerThread.joinable())
+    {
+        writerThread.join();
+    }
+    else
+    {
+        // Never got as far as starting to write
+        closeSegment();
+    }
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+StreamRecorder::Stats StreamRecorder::GetStats()
+{
+    std::lock_guard lock(queueMutex);
+    const BoundedPacketQueue::Stats queueStats = queue.GetStats();
+    return Stats
+    {
+        .RecordedPackets = recordedPackets.load(),
+        .RecordedBytes = recordedBytes.load(),
+        .DroppedPackets = queueStats.DroppedPackets,
+        .Overflows = queueStats.Overflows,
+        .WriteErrors = writeErrors.load(),
+        .Segments = segmentCount.load(),
+        .QueuedPackets = queue.Size(),
+    };
+}
+
+std::filesystem::path StreamRecorder::GetSegmentPathPrefix() const
+{
+    return segmentPathPrefix;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void StreamRecorder::AlignedFree::operator()(std::byte* buffer) const
+{
+    std::free(buffer);
+}
+
+void StreamRecorder::writerThreadBody()
+{
+    std::array<PacketBuffer, MAX_BATCH_SIZE> batch;
+    while (true)
+    {
+        size_t batchSize = 0;
+        {
+            std::unique_lock lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return (isStopping || !queue.Empty()); });
+            batchSize = queue.PopFront(batch);
+            if ((batchSize == 0) && isStopping)
+            {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            writePacket(batch[i]);
+            // Let go of the packet so its buffer can be reused
+            batch[i].Reset();
+        }
+    }
+    closeSegment();
+}
+
+void StreamRecorder::writePacket(const PacketBuffer& packet)
+{
+    // Note where each keyframe starts, packets of the same keyframe share a timestamp
+    bool isNewKeyframe = false;
+    if (packetKind(packet) == BoundedPacketQueue::PacketKind::Keyframe)
+    {
+        const uint32_t timestamp = ntohl(RtpPacket::GetRtpHeader(packet)->Timestamp);
+        isNewKeyframe = (lastKeyframeTimestamp != timestamp);
+        lastKeyframeTimestamp = timestamp;
+    }
+
+    // Streams without video have no keyframes to wait for
+    const bool isAtSplitPoint = (isNewKeyframe || !rotateOnKeyframe || !mediaMetadata.HasVideo);
+    if ((segmentHandle >= 0) && (maxSegmentBytes > 0) &&
+        (((segmentBytes >= maxSegmentBytes) && isAtSplitPoint) ||
+            (segmentBytes >= (maxSegmentBytes * 2))))
+    {
+        closeSegment();
+        Result<void> openResult = openSegment();
+        if (openResult.IsError)
+        {
+            // Nothing more gets recorded, but the stream carries on
+            spdlog::error("Couldn't start next recording segment, recording stopped: {}",
+                openResult.ErrorMessage);
+        }
+    }
+    if (segmentHandle < 0)
+    {
+        ++writeErrors;
+        return;
+    }
+
+    const std::chrono::nanoseconds time = captureTime(packet);
+    if (isNewKeyframe && segmentIndex.is_open())
+    {
+        segmentIndex << segmentBytes << ' ' << time.count() << ' ' <<
+            lastKeyframeTimestamp.value() << '\n';
+    }
+
+    const size_t datagramSize = (UDP_HEADER_SIZE + packet.Size());
+    const size_t frameSize = (IPV4_HEADER_SIZE + datagramSize);
+    // Frames never straddle a write, so the disk only sees whole frames and big writes
+    if ((writeBufferUsed + PCAP_RECORD_HEADER_SIZE + frameSize) > WRITE_BUFFER_SIZE)
+    {
+        flushWriteBuffer();
+    }
+    std::array<uint32_t, 4> recordHeader
+    {
+        static_cast<uint32_t>(time.count() / 1000000000),
+        static_cast<uint32_t>(time.count() % 1000000000),
+        static_cast<uint32_t>(frameSize),
+        static_cast<uint32_t>(frameSize),
+    };
+    append(std::as_bytes(std::span(recordHeader)));
+    append(ipv4Header(datagramSize));
+    std::array<std::byte, UDP_HEADER_SIZE> udpHeader {};
+    writeUint16(&udpHeader[0], RECORDED_PORT);
+    writeUint16(&udpHeader[2], RECORDED_PORT);
+    writeUint16(&udpHeader[4], static_cast<uint16_t>(datagramSize));
+    append(udpHeader);
+    append(packet.Bytes());
+
+    ++recordedPackets;
+    recordedBytes += (PCAP_RECORD_HEADER_SIZE + frameSize);
+}
+
+Result<void> StreamRecorder::openSegment()
+{
+    const std::string segmentPath = fmt::format("{}-{:04}", segmentPathPrefix.string(),
+        segmentCount.load());
+    segmentHandle = open((segmentPath + SEGMENT_EXTENSION).c_str(),
+        (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC), 0644);
+    if (segmentHandle < 0)
+    {
+        return Result<void>::Error(fmt::format("Couldn't open recording segment {}{}: {}",
+            segmentPath, SEGMENT_EXTENSION, Util::ErrnoToString(errno)));
+    }
+    segmentIndex.open(segmentPath + INDEX_EXTENSION, (std::ios::out | std::ios::trunc));
+    ++segmentCount;
+    segmentBytes = 0;
+
+    // Segments are Wireshark-compatible captures timestamped to the nanosecond
+    std::array<uint32_t, 6> globalHeader
+    {
+        PCAP_MAGIC_NANOSECONDS,
+        // Major version 2, minor version 4
+        (2 | (4 << 16)),
+        // Times are UTC, to whatever accuracy the clock has
+        0,
+        0,
+        // Longest frame we'll ever write
+        (IPV4_HEADER_SIZE + UDP_HEADER_SIZE + UINT16_MAX),
+        PCAP_LINK_TYPE_RAW,
+    };
+    append(std::as_bytes(std::span(globalHeader)));
+    spdlog::info("Recording to {}{}", segmentPath, SEGMENT_EXTENSION);
+    return Result<void>::Success();
+}
+
+void StreamRecorder::closeSegment()
+{
+    if (segmentHandle < 0)
+    {
+        return;
+    }
+    flushWriteBuffer();
+    if (close(segmentHandle) != 0)
+    {
+        ++writeErrors;
+    }
+    segmentHandle = -1;
+    segmentIndex.close();
+}
+
+void StreamRecorder::flushWriteBuffer()
+{
+    size_t written = 0;
+    while (written < writeBufferUsed)
+    {
+        const ssize_t result = write(segmentHandle, (writeBuffer.get() + written),
+            (writeBufferUsed - written));
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // Whatever didn't make it is lost, but later writes may still succeed
+            spdlog::warn("Couldn't write {} bytes of recording {}: {}",
+                (writeBufferUsed - written), segmentPathPrefix.string(),
+                Util::ErrnoToString(errno));
+            ++writeErrors;
+            break;
+        }
+        written += result;
+    }
+    writeBufferUsed = 0;
+}
+
+void StreamRecorder::append(std::span<const std::byte> bytes)
+{
+    std::memcpy((writeBuffer.get() + writeBufferUsed), bytes.data(), bytes.size());
+    writeBufferUsed += bytes.size();
+    segmentBytes += bytes.size();
+}
+
+std::chrono::nanoseconds StreamRecorder::captureTime(const PacketBuffer& packet) const
+{
+    std::chrono::steady_clock::time_point receiveTime = packet.GetReceiveTime();
+    if (receiveTime.time_since_epoch().count() == 0)
+    {
+        // Whoever read the packet didn't note when
+        receiveTime = std::chrono::steady_clock::now();
+    }
+    return (std::chrono::duration_cast<std::chrono::nanoseconds>(
+        receiveTime.time_since_epoch()) + steadyToUnixOffset);
+}
+
+BoundedPacketQueue::PacketKind StreamRecorder::packetKind(const PacketBuffer& packet) const
+{
+    // RTP header is 12 bytes
+    if ((packet.Size() < 12) ||
+        (RtpPacket::GetRtpHeader(packet)->Type != mediaMetadata.VideoPayloadType))
+    {
+        return BoundedPacketQueue::PacketKind::Independent;
+    }
+    if (isKeyframePayload(RtpPacket::GetRtpPayload(packet)))
+    {
+        return BoundedPacketQueue::PacketKind::Keyframe;
+    }
+    return BoundedPacketQueue::PacketKind::Dependent;
+}
+#pragma endregion Private methods
@@ -0,0 +1,165 @@
+/**
+ * @file StreamRecorder.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "RtpPacketSink.h"
+#include "Utilities/BoundedPacketQueue.h"
+#include "Utilities/FtlTypes.h"
+#include "Utilities/Result.h"
+#include "VideoCodecTraits.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+
+/**
+ * @brief
+ *  Records a stream's RTP packets to disk without ever making ingest wait on the disk.
+ *  Packets are queued by reference in a BoundedPacketQueue and written out by a dedicated
+ *  thread, which gathers them into a large aligned buffer so the disk sees big sequential
+ *  writes. A recorder that falls behind drops packets the same way a slow relay does, rather
+ *  than holding ingest up.
+ *
+ *  Recordings are split into segments, each a classic pcap capture of raw IPv4 UDP datagrams
+ *  so they can be fed straight back into the replay tool or opened in Wireshark, alongside a
+ *  text index of where each keyframe starts. Segments are rotated once they reach a size,
+ *  preferably at a keyframe so every segment can be decoded on its own.
+ */
+class StreamRecorder : public RtpPacketSink
+{
+public:
+    /* Public types */
+    struct Stats
+    {
+        uint64_t RecordedPackets = 0;
+        // Including capture headers
+        uint64_t RecordedBytes = 0;
+        uint64_t DroppedPackets = 0;
+        uint64_t Overflows = 0;
+        uint64_t WriteErrors = 0;
+        // Segments started, including the one being written
+        uint64_t Segments = 0;
+        // Packets waiting to be written
+        size_t QueuedPackets = 0;
+    };
+
+    /* Constants */
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 8192;
+    static constexpr uint64_t DEFAULT_MAX_SEGMENT_BYTES = 256 * 1024 * 1024;
+    static constexpr size_t WRITE_BUFFER_SIZE = 1024 * 1024;
+    static constexpr size_t WRITE_BUFFER_ALIGNMENT = 4096;
+    // Datagrams are recorded as if they were sent from and to this port
+    static constexpr uint16_t RECORDED_PORT = 8084;
+    static constexpr const char* SEGMENT_EXTENSION = ".pcap";
+    static constexpr const char* INDEX_EXTENSION = ".index";
+
+    /* Static methods */
+    /**
+     * @brief Creates the recording directory if needed and starts a stream's first segment
+     * @param maxSegmentBytes size segments are rotated at, or 0 to never rotate them
+     * @param rotateOnKeyframe
+     *  whether segments holding video are rotated at the first keyframe after they reach
+     *  maxSegmentBytes, rather than at exactly that size. Segments are rotated regardless
+     *  once they reach twice the size.
+     */
+    static Result<std::unique_ptr<StreamRecorder>> Start(
+        const std::filesystem::path& directory,
+        ftl_channel_id_t channelId,
+        ftl_stream_id_t streamId,
+        MediaMetadata mediaMetadata,
+        uint64_t maxSegmentBytes = DEFAULT_MAX_SEGMENT_BYTES,
+        bool rotateOnKeyframe = true,
+        size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+
+    /* Constructor/Destructor */
+    ~StreamRecorder();
+
+    /* Public methods */
+    /**
+     * @brief Queues a packet to be recorded. Never blocks on the disk.
+     */
+    void SendRtpPacket(const PacketBuffer& packet) override;
+    /**
+     * @brief
+     *  Writes out everything already queued and closes the current segment. Packets sent
+     *  afterwards are ignored. Blocks until the writer thread has finished.
+     */
+    void Stop();
+
+    /* Getters/Setters */
+    Stats GetStats();
+    /**
+     * @brief Path segments of this recording are written to, less their index and extension
+     */
+    std::filesystem::path GetSegmentPathPrefix() const;
+
+private:
+    /* Private types */
+    struct AlignedFree
+    {
+        void operator()(std::byte* buffer) const;
+    };
+
+    /* Private constants */
+    static constexpr uint32_t PCAP_MAGIC_NANOSECONDS = 0xA1B23C4D;
+    static constexpr uint32_t PCAP_LINK_TYPE_RAW = 101;
+    static constexpr size_t PCAP_GLOBAL_HEADER_SIZE = 24;
+    static constexpr size_t PCAP_RECORD_HEADER_SIZE = 16;
+    static constexpr size_t IPV4_HEADER_SIZE = 20;
+    static constexpr size_t UDP_HEADER_SIZE = 8;
+    static constexpr size_t MAX_BATCH_SIZE = 256;
+
+    /* Private fields */
+    const std::filesystem::path segmentPathPrefix;
+    const MediaMetadata mediaMetadata;
+    const KeyframePayloadDetector isKeyframePayload;
+    const uint64_t maxSegmentBytes;
+    const bool rotateOnKeyframe;
+    // Converts the steady clock packets are stamped with to time since the Unix epoch
+    const std::chrono::nanoseconds steadyToUnixOffset;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    BoundedPacketQueue queue;
+    bool isStopping = false;
+    std::atomic<uint64_t> recordedPackets { 0 };
+    std::atomic<uint64_t> recordedBytes { 0 };
+    std::atomic<uint64_t> writeErrors { 0 };
+    std::atomic<uint64_t> segmentCount { 0 };
+    // Everything below is only touched by the writer thread once it's started
+    std::unique_ptr<std::byte, AlignedFree> writeBuffer;
+    size_t writeBufferUsed = 0;
+    int segmentHandle = -1;
+    std::ofstream segmentIndex;
+    // Bytes in the current segment, including those still buffered
+    uint64_t segmentBytes = 0;
+    std::optional<uint32_t> lastKeyframeTimestamp;
+    std::jthread writerThread;
+
+    /* Constructor/Destructor */
+    StreamRecorder(std::filesystem::path segmentPathPrefix, MediaMetadata mediaMetadata,
+        uint64_t maxSegmentBytes, bool rotateOnKeyframe, size_t queueCapacity);
+
+    /* Private methods */
+    void writerThreadBody();
+    void writePacket(const PacketBuffer& packet);
+    Result<void> openSegment();
+    void closeSegment();
+    void flushWriteBuffer();
+    void append(std::span<const std::byte> bytes);
+    std::chrono::nanoseconds captureTime(const PacketBuffer& packet) const;
+    BoundedPacketQueue::PacketKind packetKind(const PacketBuffer& packet) const;
+};
@@ -0,0 +1,104 @@
+/**
+ * @file BitratePolicer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "TokenBucket.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief
+ *  Polices a stream's bitrate one packet at a time. Packets that don't fit in a token bucket
+ *  of the allowed rate are violations, and a run of violations without a long enough break
+ *  between them means the stream is persistently over its limit, rather than just spiking
+ *  (ex. on a large keyframe). Not thread-safe.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class BitratePolicer
+{
+public:
+    /* Public types */
+    using TimePoint = typename Clock::time_point;
+    enum class Verdict
+    {
+        // Packet is within the limit
+        Accept,
+        // Packet is over the limit, and should be dropped
+        Drop,
+        // Packet is over the limit, and the stream has gone over it too many times. Only
+        // returned once, packets over the limit after it are dropped.
+        Exceeded,
+    };
+
+    /* Constants */
+    // Violations this far apart are treated as separate spikes, and aren't counted together
+    static constexpr std::chrono::seconds VIOLATION_RESET_INTERVAL { 1 };
+
+    /* Constructor/Destructor */
+    /**
+     * @param maxBitsPerSecond most bits per second the stream may average
+     * @param burstBytes
+     *  most bytes the stream may send above its average at once, or 0 for one second's worth
+     * @param maxViolations
+     *  packets over the limit before the stream is treated as having exceeded it, or 0 to only
+     *  ever drop them
+     */
+    BitratePolicer(uint32_t maxBitsPerSecond, size_t burstBytes, uint32_t maxViolations,
+        TimePoint now = Clock::now())
+    :
+        bucket(maxBitsPerSecond / 8.0,
+            (burstBytes > 0) ? static_cast<double>(burstBytes) : (maxBitsPerSecond / 8.0), now),
+        maxViolations(maxViolations)
+    { }
+
+    /* Public methods */
+    Verdict Police(TimePoint now, size_t packetBytes)
+    {
+        if (bucket.TryConsume(now, static_cast<double>(packetBytes)))
+        {
+            return Verdict::Accept;
+        }
+
+        if ((violations > 0) && ((now - lastViolationTime) >= VIOLATION_RESET_INTERVAL))
+        {
+            violations = 0;
+        }
+        ++violations;
+        lastViolationTime = now;
+        if (!hasExceeded && (maxViolations > 0) && (violations >= maxViolations))
+        {
+            hasExceeded = true;
+            return Verdict::Exceeded;
+        }
+        return Verdict::Drop;
+    }
+
+    /* Getters/Setters */
+    /**
+     * @brief Violations counted towards the limit so far
+     */
+    uint32_t GetViolations() const
+    {
+        return violations;
+    }
+
+    bool HasExceeded() const
+    {
+        return hasExceeded;
+    }
+
+private:
+    /* Private fields */
+    TokenBucket<Clock> bucket;
+    const uint32_t maxViolations;
+    uint32_t violations = 0;
+    TimePoint lastViolationTime;
+    bool hasExceeded = false;
+};
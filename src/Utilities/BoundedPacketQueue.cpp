@@ -0,0 +1,115 @@
+/**
+ * @file BoundedPacketQueue.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "BoundedPacketQueue.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+BoundedPacketQueue::BoundedPacketQueue(size_t capacity)
+:
+    capacity(std::max<size_t>(capacity, 1))
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool BoundedPacketQueue::Push(PacketBuffer packet, PacketKind kind)
+{
+    if (entries.size() >= capacity)
+    {
+        ++stats.Overflows;
+        makeRoom();
+    }
+
+    if (kind == PacketKind::Keyframe)
+    {
+        hasSeenKeyframe = true;
+        isAwaitingKeyframe = false;
+    }
+    else if ((kind == PacketKind::Dependent) && isAwaitingKeyframe)
+    {
+        ++stats.DroppedPackets;
+        return false;
+    }
+
+    entries.push_back(Entry { .Packet = std::move(packet), .Kind = kind });
+    ++stats.EnqueuedPackets;
+    return true;
+}
+
+size_t BoundedPacketQueue::PopFront(std::span<PacketBuffer> buffers)
+{
+    const size_t numPopped = std::min(buffers.size(), entries.size());
+    for (size_t i = 0; i < numPopped; ++i)
+    {
+        buffers[i] = std::move(entries.front().Packet);
+        entries.pop_front();
+    }
+    return numPopped;
+}
+
+void BoundedPacketQueue::Clear()
+{
+    entries.clear();
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool BoundedPacketQueue::Empty() const
+{
+    return entries.empty();
+}
+
+size_t BoundedPacketQueue::Size() const
+{
+    return entries.size();
+}
+
+size_t BoundedPacketQueue::Capacity() const
+{
+    return capacity;
+}
+
+bool BoundedPacketQueue::IsAwaitingKeyframe() const
+{
+    return isAwaitingKeyframe;
+}
+
+BoundedPacketQueue::Stats BoundedPacketQueue::GetStats() const
+{
+    return stats;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void BoundedPacketQueue::makeRoom()
+{
+    // Once we have to drop anything, queued dependent packets are only useful up to the gap
+    // we're about to make, so shed all of them and wait for the next keyframe.
+    const size_t dependentDropped = std::erase_if(entries,
+        [](const Entry& entry) { return (entry.Kind == PacketKind::Dependent); });
+    stats.DroppedPackets += dependentDropped;
+    if ((dependentDropped > 0) && hasSeenKeyframe)
+    {
+        isAwaitingKeyframe = true;
+    }
+    if (entries.size() < capacity)
+    {
+        return;
+    }
+
+    // Still full - give up the oldest independent packet, or failing that the oldest packet
+    auto dropIt = std::find_if(entries.begin(), entries.end(),
+        [](const Entry& entry) { return (entry.Kind == PacketKind::Independent); });
+    if (dropIt == entries.end())
+    {
+        dropIt = entries.begin();
+    }
+    entries.erase(dropIt);
+    ++stats.DroppedPackets;
+}
+#pragma endregion Private methods
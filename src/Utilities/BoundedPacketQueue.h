@@ -0,0 +1,93 @@
+/**
+ * @file BoundedPacketQueue.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "PacketBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+/**
+ * @brief
+ *  A fixed-capacity FIFO of outgoing media packets that knows which packets a decoder can do
+ *  without. When it overflows it sheds packets that depend on earlier ones, and then refuses
+ *  further dependent packets until the next keyframe, since they couldn't be decoded anyway.
+ *  Not thread-safe.
+ */
+class BoundedPacketQueue
+{
+public:
+    /* Public types */
+    enum class PacketKind
+    {
+        // Can be decoded on its own, such as audio
+        Independent = 0,
+        // Depends on earlier packets, such as video predicted from a previous frame
+        Dependent,
+        // Starts a new chain of dependent packets
+        Keyframe,
+    };
+
+    struct Stats
+    {
+        uint64_t EnqueuedPackets = 0;
+        uint64_t DroppedPackets = 0;
+        // Number of times a packet arrived to find the queue full
+        uint64_t Overflows = 0;
+    };
+
+    /* Constructor/Destructor */
+    BoundedPacketQueue(size_t capacity);
+
+    /* Public methods */
+    /**
+     * @brief Adds a packet to the back of the queue, making room if necessary
+     * @return false if the packet was dropped instead
+     */
+    bool Push(PacketBuffer packet, PacketKind kind);
+    /**
+     * @brief Moves up to buffers.size() packets from the front of the queue into buffers
+     * @return number of packets moved
+     */
+    size_t PopFront(std::span<PacketBuffer> buffers);
+    /**
+     * @brief Discards every queued packet without counting them as dropped
+     */
+    void Clear();
+
+    /* Getters/Setters */
+    bool Empty() const;
+    size_t Size() const;
+    size_t Capacity() const;
+    /**
+     * @brief Whether dependent packets are being dropped until the next keyframe
+     */
+    bool IsAwaitingKeyframe() const;
+    Stats GetStats() const;
+
+private:
+    /* Private types */
+    struct Entry
+    {
+        PacketBuffer Packet;
+        PacketKind Kind;
+    };
+
+    /* Private fields */
+    const size_t capacity;
+    std::deque<Entry> entries;
+    // Streams without keyframes (or codecs we can't spot them in) should never wait on one
+    bool hasSeenKeyframe = false;
+    bool isAwaitingKeyframe = false;
+    Stats stats;
+
+    /* Private methods */
+    void makeRoom();
+};
@@ -0,0 +1,144 @@
+/**
+ * @file ClientPool.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief
+ *  Keeps idle, connected clients (such as keep-alive HTTP clients) around so they can be
+ *  reused rather than reconnecting for every request. Each client is leased to one caller at
+ *  a time, so clients themselves don't need to be thread-safe. The pool must outlive every
+ *  lease taken from it.
+ */
+template<typename T>
+class ClientPool
+{
+public:
+    /* Public types */
+    using ClientFactory = std::function<std::unique_ptr<T>()>;
+
+    /**
+     * @brief
+     *  Exclusive use of a client until destroyed, at which point the client goes back to the
+     *  pool unless it has been discarded.
+     */
+    class Lease
+    {
+    public:
+        Lease(ClientPool* pool, std::unique_ptr<T> client) :
+            pool(pool),
+            client(std::move(client))
+        { }
+
+        Lease(Lease&& other) = default;
+        Lease& operator=(Lease&& other) = delete;
+
+        ~Lease()
+        {
+            if ((pool != nullptr) && (client != nullptr))
+            {
+                pool->release(std::move(client));
+            }
+        }
+
+        T* operator->() const
+        {
+            return client.get();
+        }
+
+        T& operator*() const
+        {
+            return *client;
+        }
+
+        /**
+         * @brief
+         *  Throws the client away instead of returning it to the pool, for when its
+         *  connection may be in a bad state.
+         */
+        void Discard()
+        {
+            client.reset();
+        }
+
+    private:
+        ClientPool* pool;
+        std::unique_ptr<T> client;
+    };
+
+    /* Constants */
+    static constexpr size_t DEFAULT_MAX_IDLE_CLIENTS = 8;
+
+    /* Constructor/Destructor */
+    ClientPool(ClientFactory factory, size_t maxIdleClients = DEFAULT_MAX_IDLE_CLIENTS) :
+        factory(std::move(factory)),
+        maxIdleClients(maxIdleClients)
+    { }
+
+    /* Public methods */
+    /**
+     * @brief Leases the most recently used idle client, or creates a new one if none are idle
+     */
+    Lease Acquire()
+    {
+        {
+            std::scoped_lock lock(mutex);
+            if (!idleClients.empty())
+            {
+                std::unique_ptr<T> client = std::move(idleClients.back());
+                idleClients.pop_back();
+                return Lease(this, std::move(client));
+            }
+        }
+        // Connecting can be slow, so don't hold the lock while creating a client
+        return Lease(this, factory());
+    }
+
+    /**
+     * @brief Throws away every idle client. Leased clients are still returned afterwards.
+     */
+    void Clear()
+    {
+        std::vector<std::unique_ptr<T>> clients;
+        {
+            std::scoped_lock lock(mutex);
+            std::swap(clients, idleClients);
+        }
+    }
+
+    /* Getters/Setters */
+    size_t GetIdleCount()
+    {
+        std::scoped_lock lock(mutex);
+        return idleClients.size();
+    }
+
+private:
+    /* Private fields */
+    const ClientFactory factory;
+    const size_t maxIdleClients;
+    std::mutex mutex;
+    // Most recently used last, so the warmest connections are reused first
+    std::vector<std::unique_ptr<T>> idleClients;
+
+    /* Private methods */
+    void release(std::unique_ptr<T> client)
+    {
+        std::scoped_lock lock(mutex);
+        if (idleClients.size() < maxIdleClients)
+        {
+            idleClients.push_back(std::move(client));
+        }
+    }
+};
@@ -0,0 +1,159 @@
+/**
+ * @file CpuTopology.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "CpuTopology.h"
+
+#include "Util.h"
+
+#include <algorithm>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <stdexcept>
+
+#pragma region Public methods
+std::vector<int> CpuTopology::ParseCpuList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    std::stringstream listStream(cpuList);
+    std::string entry;
+    while (std::getline(listStream, entry, ','))
+    {
+        entry.erase(std::remove_if(entry.begin(), entry.end(), ::isspace), entry.end());
+        if (entry.empty())
+        {
+            continue;
+        }
+
+        // std::stoi would happily accept "1x" or "-1", so check for digits ourselves
+        const size_t dashPos = entry.find('-');
+        const std::string first = entry.substr(0, dashPos);
+        const std::string last = (dashPos == std::string::npos) ?
+            first : entry.substr(dashPos + 1);
+        const auto isNumber = [](const std::string& value)
+            {
+                return !value.empty() && std::all_of(value.begin(), value.end(), ::isdigit);
+            };
+        if (!isNumber(first) || !isNumber(last))
+        {
+            throw std::invalid_argument(fmt::format("Invalid CPU list entry '{}'", entry));
+        }
+        const int firstCpu = std::stoi(first);
+        const int lastCpu = std::stoi(last);
+        if (lastCpu < firstCpu)
+        {
+            throw std::invalid_argument(fmt::format("Invalid CPU range '{}'", entry));
+        }
+        if (lastCpu >= CPU_SETSIZE)
+        {
+            throw std::invalid_argument(fmt::format("CPU {} is out of range", lastCpu));
+        }
+
+        for (int cpu = firstCpu; cpu <= lastCpu; ++cpu)
+        {
+            if (std::find(cpus.begin(), cpus.end(), cpu) == cpus.end())
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+
+    return cpus;
+}
+
+std::string CpuTopology::FormatCpuList(std::span<const int> cpus)
+{
+    std::string cpuList;
+    size_t runStart = 0;
+    for (size_t i = 0; i < cpus.size(); ++i)
+    {
+        // Keep extending the run while CPUs are consecutive
+        if (((i + 1) < cpus.size()) && (cpus[i + 1] == (cpus[i] + 1)))
+        {
+            continue;
+        }
+        if (!cpuList.empty())
+        {
+            cpuList += ",";
+        }
+        cpuList += (runStart == i) ? std::to_string(cpus[i]) :
+            fmt::format("{}-{}", cpus[runStart], cpus[i]);
+        runStart = i + 1;
+    }
+    return cpuList;
+}
+
+int CpuTopology::GetNumaNode(int cpu, const std::filesystem::path& sysfsPath)
+{
+    if (cpu < 0)
+    {
+        return UNKNOWN_NUMA_NODE;
+    }
+
+    // Each CPU's directory links to the node it belongs to, ex. cpu/cpu3/node1
+    std::error_code error;
+    const std::filesystem::path cpuPath = sysfsPath / "cpu" / fmt::format("cpu{}", cpu);
+    std::filesystem::directory_iterator entries(cpuPath, error);
+    if (error)
+    {
+        return UNKNOWN_NUMA_NODE;
+    }
+    for (const std::filesystem::directory_entry& entry : entries)
+    {
+        const std::string name = entry.path().filename().string();
+        if ((name.size() > 4) && name.starts_with("node") &&
+            std::all_of(name.begin() + 4, name.end(), ::isdigit))
+        {
+            return std::stoi(name.substr(4));
+        }
+    }
+    return 0;
+}
+
+std::vector<int> CpuTopology::GetNumaNodeCpus(int numaNode,
+    const std::filesystem::path& sysfsPath)
+{
+    if (numaNode < 0)
+    {
+        return {};
+    }
+
+    std::ifstream cpuListFile(sysfsPath / "node" / fmt::format("node{}", numaNode) / "cpulist");
+    std::string cpuList;
+    if (!cpuListFile || !std::getline(cpuListFile, cpuList))
+    {
+        return {};
+    }
+    try
+    {
+        return ParseCpuList(cpuList);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return {};
+    }
+}
+
+Result<void> CpuTopology::PinCurrentThread(std::span<const int> cpus)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const int cpu : cpus)
+    {
+        CPU_SET(cpu, &cpuSet);
+    }
+    const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (error != 0)
+    {
+        return Result<void>::Error(fmt::format("Could not pin thread to CPUs {}. Error {}: {}",
+            FormatCpuList(cpus), error, Util::ErrnoToString(error)));
+    }
+    return Result<void>::Success();
+}
+#pragma endregion Public methods
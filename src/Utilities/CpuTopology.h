@@ -0,0 +1,61 @@
+/**
+ * @file CpuTopology.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief
+ *  Helpers for pinning threads to CPUs and finding out which NUMA node a CPU belongs to,
+ *  so work on multi-socket machines can be kept close to the memory and NIC it touches.
+ */
+class CpuTopology
+{
+public:
+    /* Constants */
+    static constexpr int UNKNOWN_NUMA_NODE = -1;
+    static inline const std::filesystem::path DEFAULT_SYSFS_PATH = "/sys/devices/system";
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Parses a CPU list in the kernel's format (ex. "0-3,8,10-11"), as used by taskset and
+     *  /sys/devices/system/node/node0/cpulist. Throws std::invalid_argument if malformed.
+     * @return CPUs in the order they were listed, without duplicates
+     */
+    static std::vector<int> ParseCpuList(const std::string& cpuList);
+
+    /**
+     * @brief Formats CPUs back into the kernel's list format, for logging
+     */
+    static std::string FormatCpuList(std::span<const int> cpus);
+
+    /**
+     * @brief
+     *  NUMA node the given CPU belongs to. Machines the kernel doesn't report any NUMA nodes
+     *  for are treated as a single node 0.
+     * @return UNKNOWN_NUMA_NODE if the CPU doesn't exist
+     */
+    static int GetNumaNode(int cpu, const std::filesystem::path& sysfsPath = DEFAULT_SYSFS_PATH);
+
+    /**
+     * @brief CPUs belonging to the given NUMA node, or empty if it doesn't exist
+     */
+    static std::vector<int> GetNumaNodeCpus(int numaNode,
+        const std::filesystem::path& sysfsPath = DEFAULT_SYSFS_PATH);
+
+    /**
+     * @brief Restricts the calling thread to running on the given CPUs
+     */
+    static Result<void> PinCurrentThread(std::span<const int> cpus);
+};
@@ -0,0 +1,445 @@
+/**
+ * @file DatagramFanoutQueue.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "DatagramFanoutQueue.h"
+
+#include "Util.h"
+
+#include <algorithm>
+#include <array>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#pragma region Constructor/Destructor
+DatagramFanoutQueue::DatagramFanoutQueue(size_t capacity, bool startTargetsAtKeyframe,
+    std::chrono::milliseconds pacingInterval)
+:
+    capacity(std::max<size_t>(capacity, 1)),
+    startTargetsAtKeyframe(startTargetsAtKeyframe),
+    wakeHandle(eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK))),
+    ring(this->capacity),
+    pacer((pacingInterval.count() > 0) ?
+        std::make_optional<EgressPacer>(pacingInterval) : std::nullopt)
+{
+    if (wakeHandle == -1)
+    {
+        throw std::runtime_error(fmt::format("Could not create eventfd: {}",
+            Util::ErrnoToString(errno)));
+    }
+    senderThread = std::jthread([this](std::stop_token stopToken)
+        {
+            senderThreadBody(stopToken);
+        });
+}
+
+DatagramFanoutQueue::~DatagramFanoutQueue()
+{
+    Stop();
+    close(wakeHandle);
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool DatagramFanoutQueue::Enqueue(const PacketBuffer& packet,
+    BoundedPacketQueue::PacketKind kind)
+{
+    bool shouldWake = false;
+    {
+        std::scoped_lock lock(ringMutex);
+        if (isStopped)
+        {
+            return false;
+        }
+        ring[nextPosition % capacity] = Entry { .Packet = packet, .Kind = kind };
+        ++nextPosition;
+        if (pacer.has_value())
+        {
+            pacer->AddQueued(packet.Size(), EgressPacer::Clock::now());
+        }
+        hasSeenKeyframe |= (kind == BoundedPacketQueue::PacketKind::Keyframe);
+        // Only pay for a wakeup when the sender has run out of things to do
+        shouldWake = isSenderWaiting;
+        isSenderWaiting = false;
+    }
+    if (shouldWake)
+    {
+        wake();
+    }
+    return true;
+}
+
+DatagramFanoutQueue::TargetId DatagramFanoutQueue::AddTarget(int socketHandle)
+{
+    std::scoped_lock targetsLock(targetsMutex);
+    std::unique_lock ringLock(ringMutex);
+    const TargetId targetId = nextTargetId++;
+    targets.try_emplace(targetId, Target
+        {
+            .SocketHandle = socketHandle,
+            .NextPosition = startTargetsAtKeyframe ?
+                findKeyframeStart(ringLock) : releasedPosition(ringLock),
+        });
+    isSenderWaiting = false;
+    ringLock.unlock();
+    wake();
+    return targetId;
+}
+
+void DatagramFanoutQueue::RemoveTarget(TargetId targetId)
+{
+    // The sender holds this lock while it sends, so once we have it the socket is free
+    std::scoped_lock targetsLock(targetsMutex);
+    targets.erase(targetId);
+}
+
+void DatagramFanoutQueue::Stop()
+{
+    {
+        std::scoped_lock lock(ringMutex);
+        isStopped = true;
+    }
+    senderThread.request_stop();
+    wake();
+    if (senderThread.joinable())
+    {
+        senderThread.join();
+    }
+    std::scoped_lock lock(ringMutex);
+    ring.assign(capacity, Entry());
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+DatagramSendQueue::Stats DatagramFanoutQueue::GetTargetStats(TargetId targetId)
+{
+    std::scoped_lock targetsLock(targetsMutex);
+    auto it = targets.find(targetId);
+    if (it == targets.end())
+    {
+        return DatagramSendQueue::Stats();
+    }
+    DatagramSendQueue::Stats stats = it->second.Stats;
+    std::scoped_lock ringLock(ringMutex);
+    // Anything the ring has lapped is already counted as dropped
+    stats.QueuedPackets = std::min<uint64_t>((nextPosition - it->second.NextPosition), capacity);
+    return stats;
+}
+
+size_t DatagramFanoutQueue::GetTargetCount()
+{
+    std::scoped_lock targetsLock(targetsMutex);
+    return targets.size();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void DatagramFanoutQueue::senderThreadBody(std::stop_token stopToken)
+{
+    std::vector<pollfd> pollFds;
+    std::vector<TargetId> pollTargetIds;
+    while (!stopToken.stop_requested())
+    {
+        bool madeProgress = false;
+        bool hasTargets = false;
+        uint64_t roundEndPosition = 0;
+        std::optional<EgressPacer::Clock::duration> pacingDelay;
+        pollFds.assign(1, pollfd { .fd = wakeHandle, .events = POLLIN, .revents = 0 });
+        pollTargetIds.clear();
+        {
+            std::scoped_lock targetsLock(targetsMutex);
+            {
+                std::unique_lock ringLock(ringMutex);
+                if (isStopped)
+                {
+                    break;
+                }
+                pacingDelay = releasePacedPackets(ringLock);
+                for (auto& [targetId, target] : targets)
+                {
+                    fillBatch(target, ringLock);
+                }
+                roundEndPosition = nextPosition;
+            }
+            hasTargets = !targets.empty();
+
+            for (auto& [targetId, target] : targets)
+            {
+                if (!target.IsBlocked && !target.Batch.empty())
+                {
+                    madeProgress |= sendBatch(target);
+                }
+                else if (!target.IsBlocked && (target.NextPosition != target.BatchEndPosition))
+                {
+                    // Everything taken from the ring was skipped, with nothing left to send
+                    target.NextPosition = target.BatchEndPosition;
+                    target.IsAwaitingKeyframe = target.BatchEndAwaitingKeyframe;
+                    target.Stats.DroppedPackets += target.BatchSkipped;
+                    madeProgress = true;
+                }
+                if (target.IsBlocked)
+                {
+                    pollFds.push_back(
+                        pollfd { .fd = target.SocketHandle, .events = POLLOUT, .revents = 0 });
+                    pollTargetIds.push_back(targetId);
+                }
+            }
+        }
+
+        if (madeProgress && (pollFds.size() == 1))
+        {
+            continue;
+        }
+
+        // If nobody got anywhere, wait for a new packet or for a blocked target to drain,
+        // checking in periodically in case we've been asked to stop. Without any targets, new
+        // packets can wait too (adding a target wakes us). Otherwise just check whether any
+        // blocked targets can be picked back up.
+        int pollTimeoutMs = 0;
+        if (!madeProgress)
+        {
+            std::scoped_lock ringLock(ringMutex);
+            if (((nextPosition == roundEndPosition) || !hasTargets) && !isStopped)
+            {
+                isSenderWaiting = hasTargets;
+                pollTimeoutMs = 200;
+                // Packets held back by the pacer are due sooner than that
+                if (pacingDelay.has_value() && hasTargets)
+                {
+                    pollTimeoutMs = std::clamp<int>(std::chrono::ceil<std::chrono::milliseconds>(
+                        pacingDelay.value()).count(), 1, pollTimeoutMs);
+                }
+            }
+        }
+        if (poll(pollFds.data(), pollFds.size(), pollTimeoutMs) > 0)
+        {
+            if (pollFds[0].revents != 0)
+            {
+                eventfd_t wakeCount;
+                eventfd_read(wakeHandle, &wakeCount);
+            }
+            std::scoped_lock targetsLock(targetsMutex);
+            for (size_t i = 1; i < pollFds.size(); ++i)
+            {
+                auto it = targets.find(pollTargetIds[i - 1]);
+                if ((it != targets.end()) && (pollFds[i].revents != 0))
+                {
+                    it->second.IsBlocked = false;
+                }
+            }
+        }
+        {
+            std::scoped_lock ringLock(ringMutex);
+            isSenderWaiting = false;
+        }
+    }
+}
+
+void DatagramFanoutQueue::fillBatch(Target& target, const std::unique_lock<std::mutex>& ringLock)
+{
+    // Whatever the ring laps is gone, whether or not the target was ready for it. A target
+    // still working through its last batch picks up the ring again where that batch ends.
+    const uint64_t oldestPosition = (nextPosition > capacity) ? (nextPosition - capacity) : 0;
+    const bool hasBatch = !target.Batch.empty();
+    uint64_t& resumePosition = hasBatch ? target.BatchEndPosition : target.NextPosition;
+    if (resumePosition < oldestPosition)
+    {
+        target.Stats.DroppedPackets += (oldestPosition - resumePosition);
+        ++target.Stats.Overflows;
+        resumePosition = oldestPosition;
+        (hasBatch ? target.BatchEndAwaitingKeyframe : target.IsAwaitingKeyframe) =
+            hasSeenKeyframe;
+    }
+    if (target.IsBlocked || hasBatch)
+    {
+        return;
+    }
+
+    bool isAwaitingKeyframe = target.IsAwaitingKeyframe;
+    uint64_t skipped = 0;
+    uint64_t position = target.NextPosition;
+    const uint64_t endPosition = releasedPosition(ringLock);
+    for (; (position < endPosition) && (target.Batch.size() < MAX_BATCH_SIZE); ++position)
+    {
+        const Entry& entry = ring[position % capacity];
+        if (entry.Kind == BoundedPacketQueue::PacketKind::Keyframe)
+        {
+            if (isAwaitingKeyframe)
+            {
+                target.Batch.push_back(BatchEntry
+                    {
+                        .Packet = entry.Packet,
+                        .Position = position,
+                        .WasAwaitingKeyframe = true,
+                        .SkippedBefore = skipped,
+                    });
+                isAwaitingKeyframe = false;
+                continue;
+            }
+        }
+        else if ((entry.Kind == BoundedPacketQueue::PacketKind::Dependent) && isAwaitingKeyframe)
+        {
+            ++skipped;
+            continue;
+        }
+        target.Batch.push_back(BatchEntry
+            {
+                .Packet = entry.Packet,
+                .Position = position,
+                .WasAwaitingKeyframe = isAwaitingKeyframe,
+                .SkippedBefore = skipped,
+            });
+    }
+    target.BatchEndPosition = position;
+    target.BatchEndAwaitingKeyframe = isAwaitingKeyframe;
+    target.BatchSkipped = skipped;
+}
+
+bool DatagramFanoutQueue::sendBatch(Target& target)
+{
+    std::array<mmsghdr, MAX_BATCH_SIZE> messages{};
+    std::array<iovec, MAX_BATCH_SIZE> messageIovs{};
+    for (size_t i = 0; i < target.Batch.size(); ++i)
+    {
+        messageIovs[i] = {
+            .iov_base = target.Batch[i].Packet.Data(),
+            .iov_len = target.Batch[i].Packet.Size(),
+        };
+        messages[i].msg_hdr.msg_iov = &messageIovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t numConsumed = 0;
+    int messagesSent = sendmmsg(target.SocketHandle, messages.data(), target.Batch.size(),
+        MSG_DONTWAIT);
+    if (messagesSent >= 0)
+    {
+        target.Stats.SentPackets += messagesSent;
+        numConsumed = messagesSent;
+    }
+    else
+    {
+        int error = errno;
+        if ((error == EAGAIN) || (error == EWOULDBLOCK))
+        {
+            target.IsBlocked = true;
+            return false;
+        }
+        else if (error == EINTR)
+        {
+            return false;
+        }
+
+        // Something's wrong with the first datagram or the peer (ex. ICMP port
+        // unreachable), so skip past the first datagram rather than retry it forever.
+        if ((++target.Stats.SendErrors % 1000) == 1)
+        {
+            spdlog::warn("Couldn't send datagram ({} errors so far). Error {}: {}",
+                target.Stats.SendErrors, error, Util::ErrnoToString(error));
+        }
+        numConsumed = 1;
+    }
+
+    if (numConsumed >= target.Batch.size())
+    {
+        target.NextPosition = target.BatchEndPosition;
+        target.IsAwaitingKeyframe = target.BatchEndAwaitingKeyframe;
+        target.Stats.DroppedPackets += target.BatchSkipped;
+        target.Batch.clear();
+    }
+    else
+    {
+        // Pick up from the first unsent packet next time, keeping the rest of the batch
+        const BatchEntry& nextEntry = target.Batch[numConsumed];
+        target.NextPosition = nextEntry.Position;
+        target.IsAwaitingKeyframe = nextEntry.WasAwaitingKeyframe;
+        target.Stats.DroppedPackets += nextEntry.SkippedBefore;
+        target.BatchSkipped -= nextEntry.SkippedBefore;
+        for (BatchEntry& entry : target.Batch)
+        {
+            entry.SkippedBefore -= nextEntry.SkippedBefore;
+        }
+        target.Batch.erase(target.Batch.begin(), (target.Batch.begin() + numConsumed));
+        // The socket took less than we gave it, so its buffer is probably full
+        target.IsBlocked = (messagesSent >= 0);
+    }
+    return (numConsumed > 0);
+}
+
+std::optional<EgressPacer::Clock::duration> DatagramFanoutQueue::releasePacedPackets(
+    const std::unique_lock<std::mutex>& ringLock)
+{
+    if (!pacer.has_value())
+    {
+        return std::nullopt;
+    }
+
+    // Packets the ring has lapped are gone before they were ever let out
+    const uint64_t oldestPosition = (nextPosition > capacity) ? (nextPosition - capacity) : 0;
+    pacedPosition = std::max(pacedPosition, oldestPosition);
+    const auto now = EgressPacer::Clock::now();
+    while (pacedPosition < nextPosition)
+    {
+        const EgressPacer::Clock::duration delay = pacer->GetDelay(now);
+        if (delay > EgressPacer::Clock::duration::zero())
+        {
+            return delay;
+        }
+        pacer->AddSent(ring[pacedPosition % capacity].Packet.Size(), now);
+        ++pacedPosition;
+    }
+    return std::nullopt;
+}
+
+uint64_t DatagramFanoutQueue::releasedPosition(const std::unique_lock<std::mutex>& ringLock) const
+{
+    return pacer.has_value() ? pacedPosition : nextPosition;
+}
+
+uint64_t DatagramFanoutQueue::findKeyframeStart(
+    const std::unique_lock<std::mutex>& ringLock) const
+{
+    const uint64_t oldestPosition = (nextPosition > capacity) ? (nextPosition - capacity) : 0;
+    uint64_t position = nextPosition;
+    while ((position > oldestPosition) &&
+        (ring[(position - 1) % capacity].Kind != BoundedPacketQueue::PacketKind::Keyframe))
+    {
+        --position;
+    }
+    if (position == oldestPosition)
+    {
+        // No keyframe in the ring
+        return nextPosition;
+    }
+
+    // Walk back to the first packet of the keyframe, stepping over any audio along the way
+    uint64_t keyframeStart = position - 1;
+    while ((position > oldestPosition) &&
+        (ring[(position - 1) % capacity].Kind != BoundedPacketQueue::PacketKind::Dependent))
+    {
+        --position;
+        if (ring[position % capacity].Kind == BoundedPacketQueue::PacketKind::Keyframe)
+        {
+            keyframeStart = position;
+        }
+    }
+    if ((position == oldestPosition) && (oldestPosition > 0))
+    {
+        // The start of the keyframe may have been overwritten already
+        return nextPosition;
+    }
+    return keyframeStart;
+}
+
+void DatagramFanoutQueue::wake()
+{
+    eventfd_write(wakeHandle, 1);
+}
+#pragma endregion Private methods
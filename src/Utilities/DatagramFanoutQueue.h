@@ -0,0 +1,163 @@
+/**
+ * @file DatagramFanoutQueue.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "BoundedPacketQueue.h"
+#include "DatagramSendQueue.h"
+#include "EgressPacer.h"
+#include "PacketBuffer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  Sends the same datagrams to any number of connected sockets from a single thread. Each
+ *  packet is queued once in a ring shared by every target, and each target reads from the ring
+ *  at its own pace, in batches sent with sendmmsg. A target that stops draining only holds
+ *  itself up: once the ring laps it, it skips ahead and drops dependent packets until the next
+ *  keyframe, the same as a BoundedPacketQueue would. Packets can be paced by an EgressPacer
+ *  before any target sees them, so every target gets bursts spread out the same way.
+ *  Sockets are not owned by the queue, and must stay open until their target is removed.
+ */
+class DatagramFanoutQueue
+{
+public:
+    /* Public types */
+    using TargetId = uint64_t;
+
+    /* Constants */
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+    // Maximum number of datagrams sent to one target by a single sendmmsg call
+    static constexpr size_t MAX_BATCH_SIZE = DatagramSendQueue::MAX_BATCH_SIZE;
+
+    /* Constructor/Destructor */
+    /**
+     * @param capacity number of packets the shared ring holds
+     * @param startTargetsAtKeyframe
+     *  whether new targets start with the ring's packets since its latest keyframe, rather than
+     *  with the next packet queued
+     * @param pacingInterval
+     *  most time bursts of packets are spread out over, or 0 to send packets as fast as each
+     *  target's socket takes them
+     */
+    DatagramFanoutQueue(size_t capacity = DEFAULT_CAPACITY, bool startTargetsAtKeyframe = false,
+        std::chrono::milliseconds pacingInterval = std::chrono::milliseconds(0));
+    ~DatagramFanoutQueue();
+
+    /* Public methods */
+    /**
+     * @brief Queues a packet to be sent to every target. Never blocks on a socket.
+     * @return false if the queue has been stopped
+     */
+    bool Enqueue(const PacketBuffer& packet, BoundedPacketQueue::PacketKind kind);
+    TargetId AddTarget(int socketHandle);
+    /**
+     * @brief Stops sending to a target. Once this returns, its socket is no longer used.
+     */
+    void RemoveTarget(TargetId targetId);
+    /**
+     * @brief Stops the sending thread, discarding anything still queued. Blocks until stopped.
+     */
+    void Stop();
+
+    /* Getters/Setters */
+    DatagramSendQueue::Stats GetTargetStats(TargetId targetId);
+    size_t GetTargetCount();
+
+private:
+    /* Private types */
+    struct Entry
+    {
+        PacketBuffer Packet;
+        BoundedPacketQueue::PacketKind Kind;
+    };
+
+    struct BatchEntry
+    {
+        PacketBuffer Packet;
+        // Position of the packet in the ring
+        uint64_t Position;
+        // Target state from just before this packet, to resume from if it isn't sent
+        bool WasAwaitingKeyframe;
+        uint64_t SkippedBefore;
+    };
+
+    struct Target
+    {
+        int SocketHandle;
+        // Position in the ring of the next packet to consider sending
+        uint64_t NextPosition;
+        bool IsAwaitingKeyframe = false;
+        // Set when the socket's buffer is full, until it becomes writable again
+        bool IsBlocked = false;
+        DatagramSendQueue::Stats Stats;
+        // Packets taken from the ring for the batch being sent, and where the batch leaves off
+        std::vector<BatchEntry> Batch;
+        uint64_t BatchEndPosition = 0;
+        bool BatchEndAwaitingKeyframe = false;
+        uint64_t BatchSkipped = 0;
+    };
+
+    /* Private fields */
+    const size_t capacity;
+    const bool startTargetsAtKeyframe;
+    const int wakeHandle;
+    // Guards the ring, and is never held while sending
+    std::mutex ringMutex;
+    std::vector<Entry> ring;
+    // Position of the next packet to be queued, which is stored at ring[position % capacity]
+    uint64_t nextPosition = 0;
+    // Only set if packets are paced, in which case targets are only sent the packets before
+    // pacedPosition
+    std::optional<EgressPacer> pacer;
+    uint64_t pacedPosition = 0;
+    // Streams without keyframes (or codecs we can't spot them in) should never wait on one
+    bool hasSeenKeyframe = false;
+    bool isSenderWaiting = false;
+    bool isStopped = false;
+    // Guards the targets, and is held by the sender thread while it sends to them
+    std::mutex targetsMutex;
+    std::unordered_map<TargetId, Target> targets;
+    TargetId nextTargetId = 1;
+    std::jthread senderThread;
+
+    /* Private methods */
+    void senderThreadBody(std::stop_token stopToken);
+    /**
+     * @brief Takes the target's next batch of packets from the ring. Called under ringMutex.
+     */
+    void fillBatch(Target& target, const std::unique_lock<std::mutex>& ringLock);
+    /**
+     * @brief
+     *  Lets out as many packets as the pacer allows right now. Called under ringMutex.
+     * @return how long until the pacer lets out the next packet, if any are waiting on it
+     */
+    std::optional<EgressPacer::Clock::duration> releasePacedPackets(
+        const std::unique_lock<std::mutex>& ringLock);
+    /**
+     * @brief Position targets can be sent packets up to. Called under ringMutex.
+     */
+    uint64_t releasedPosition(const std::unique_lock<std::mutex>& ringLock) const;
+    /**
+     * @brief Sends as much of the target's batch as its socket will take right now
+     * @return whether the target got any further through the ring
+     */
+    bool sendBatch(Target& target);
+    /**
+     * @brief Finds where the latest keyframe in the ring starts. Called under ringMutex.
+     */
+    uint64_t findKeyframeStart(const std::unique_lock<std::mutex>& ringLock) const;
+    void wake();
+};
@@ -0,0 +1,204 @@
+/**
+ * @file DatagramSendQueue.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "DatagramSendQueue.h"
+
+#include "Util.h"
+
+#include <array>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+
+#pragma region Constructor/Destructor
+DatagramSendQueue::DatagramSendQueue(int socketHandle, size_t capacity,
+    std::chrono::milliseconds pacingInterval)
+:
+    socketHandle(socketHandle),
+    queue(capacity),
+    pacer((pacingInterval.count() > 0) ?
+        std::make_optional<EgressPacer>(pacingInterval) : std::nullopt),
+    senderThread([this](std::stop_token stopToken) { senderThreadBody(stopToken); })
+{ }
+
+DatagramSendQueue::~DatagramSendQueue()
+{
+    Stop();
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool DatagramSendQueue::Enqueue(const PacketBuffer& packet, BoundedPacketQueue::PacketKind kind)
+{
+    {
+        std::scoped_lock lock(queueMutex);
+        if (isStopped || !queue.Push(packet, kind))
+        {
+            return false;
+        }
+        if (pacer.has_value())
+        {
+            pacer->AddQueued(packet.Size(), EgressPacer::Clock::now());
+        }
+    }
+    queueCondition.notify_one();
+    return true;
+}
+
+void DatagramSendQueue::Stop()
+{
+    {
+        std::scoped_lock lock(queueMutex);
+        isStopped = true;
+        queue.Clear();
+    }
+    senderThread.request_stop();
+    if (senderThread.joinable())
+    {
+        senderThread.join();
+    }
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+DatagramSendQueue::Stats DatagramSendQueue::GetStats()
+{
+    std::scoped_lock lock(queueMutex);
+    BoundedPacketQueue::Stats queueStats = queue.GetStats();
+    return Stats
+    {
+        .SentPackets = sentPackets,
+        .DroppedPackets = queueStats.DroppedPackets,
+        .Overflows = queueStats.Overflows,
+        .SendErrors = sendErrors,
+        .QueuedPackets = queue.Size(),
+    };
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void DatagramSendQueue::senderThreadBody(std::stop_token stopToken)
+{
+    std::array<PacketBuffer, MAX_BATCH_SIZE> batch;
+    while (!stopToken.stop_requested())
+    {
+        size_t batchSize = 0;
+        {
+            std::unique_lock lock(queueMutex);
+            if (!queueCondition.wait(lock, stopToken, [this]() { return !queue.Empty(); }))
+            {
+                break;
+            }
+            batchSize = pacer.has_value() ?
+                popPacedBatch(batch, lock, stopToken) : queue.PopFront(batch);
+        }
+
+        size_t batchSent = 0;
+        while ((batchSent < batchSize) && !stopToken.stop_requested())
+        {
+            batchSent += sendBatch(
+                std::span<PacketBuffer>(batch).subspan(batchSent, (batchSize - batchSent)));
+        }
+
+        // Let go of the packets so their buffers can be reused
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            batch[i].Reset();
+        }
+    }
+}
+
+size_t DatagramSendQueue::popPacedBatch(std::span<PacketBuffer> batch,
+    std::unique_lock<std::mutex>& lock, std::stop_token stopToken)
+{
+    size_t batchSize = 0;
+    while ((batchSize < batch.size()) && !queue.Empty())
+    {
+        const auto now = EgressPacer::Clock::now();
+        const EgressPacer::Clock::duration delay = pacer->GetDelay(now);
+        if (delay > EgressPacer::Clock::duration::zero())
+        {
+            if (batchSize > 0)
+            {
+                break;
+            }
+            // Nothing new can jump the queue, so there's nothing to wake up early for but
+            // being stopped
+            queueCondition.wait_for(lock, stopToken, delay, []() { return false; });
+            if (stopToken.stop_requested())
+            {
+                return 0;
+            }
+            continue;
+        }
+        if (queue.PopFront(batch.subspan(batchSize, 1)) > 0)
+        {
+            pacer->AddSent(batch[batchSize].Size(), now);
+            ++batchSize;
+        }
+    }
+    return batchSize;
+}
+
+size_t DatagramSendQueue::sendBatch(std::span<PacketBuffer> batch)
+{
+    std::array<mmsghdr, MAX_BATCH_SIZE> messages{};
+    std::array<iovec, MAX_BATCH_SIZE> messageIovs{};
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        messageIovs[i] = {
+            .iov_base = batch[i].Data(),
+            .iov_len = batch[i].Size(),
+        };
+        messages[i].msg_hdr.msg_iov = &messageIovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int messagesSent = sendmmsg(socketHandle, messages.data(), batch.size(), MSG_DONTWAIT);
+    if (messagesSent >= 0)
+    {
+        std::scoped_lock lock(queueMutex);
+        sentPackets += messagesSent;
+        return messagesSent;
+    }
+
+    int error = errno;
+    if ((error == EAGAIN) || (error == EWOULDBLOCK))
+    {
+        // The socket buffer is full. Wait for it to drain, then try again, checking in
+        // periodically in case we've been asked to stop.
+        pollfd writePollFds[]
+        {
+            {
+                .fd = socketHandle,
+                .events = POLLOUT,
+                .revents = 0,
+            }
+        };
+        poll(writePollFds, 1, 200 /*ms*/);
+        return 0;
+    }
+    else if (error == EINTR)
+    {
+        return 0;
+    }
+
+    // Something's wrong with the first datagram or the peer (ex. ICMP port unreachable),
+    // so skip past the first datagram rather than retry it forever.
+    uint64_t errorCount = 0;
+    {
+        std::scoped_lock lock(queueMutex);
+        errorCount = ++sendErrors;
+    }
+    if ((errorCount % 1000) == 1)
+    {
+        spdlog::warn("Couldn't send datagram ({} errors so far). Error {}: {}",
+            errorCount, error, Util::ErrnoToString(error));
+    }
+    return 1;
+}
+#pragma endregion Private methods
@@ -0,0 +1,100 @@
+/**
+ * @file DatagramSendQueue.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "BoundedPacketQueue.h"
+#include "EgressPacer.h"
+#include "PacketBuffer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+/**
+ * @brief
+ *  Sends datagrams on a connected socket from a dedicated thread, so a slow or distant peer
+ *  can't stall whoever is producing packets for it. Packets are queued in a
+ *  BoundedPacketQueue and drained in batches with sendmmsg, optionally paced by an EgressPacer
+ *  so bursts don't leave at line rate.
+ *  The socket is not owned by the queue, and must stay open until the queue is stopped.
+ */
+class DatagramSendQueue
+{
+public:
+    /* Constants */
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+    // Maximum number of datagrams sent by a single sendmmsg call
+    static constexpr size_t MAX_BATCH_SIZE = 64;
+
+    /* Public types */
+    struct Stats
+    {
+        uint64_t SentPackets = 0;
+        uint64_t DroppedPackets = 0;
+        uint64_t Overflows = 0;
+        uint64_t SendErrors = 0;
+        // Packets waiting to be sent
+        size_t QueuedPackets = 0;
+    };
+
+    /* Constructor/Destructor */
+    /**
+     * @param pacingInterval
+     *  most time bursts of packets are spread out over, or 0 to send packets as fast as the
+     *  socket takes them
+     */
+    DatagramSendQueue(int socketHandle, size_t capacity = DEFAULT_CAPACITY,
+        std::chrono::milliseconds pacingInterval = std::chrono::milliseconds(0));
+    ~DatagramSendQueue();
+
+    /* Public methods */
+    /**
+     * @brief Queues a packet to be sent. Never blocks on the socket.
+     * @return false if the packet was dropped
+     */
+    bool Enqueue(const PacketBuffer& packet, BoundedPacketQueue::PacketKind kind);
+    /**
+     * @brief Stops the sending thread, discarding anything still queued. Blocks until stopped.
+     */
+    void Stop();
+
+    /* Getters/Setters */
+    Stats GetStats();
+
+private:
+    /* Private fields */
+    const int socketHandle;
+    std::mutex queueMutex;
+    std::condition_variable_any queueCondition;
+    BoundedPacketQueue queue;
+    // Only set if packets are paced, and guarded by queueMutex
+    std::optional<EgressPacer> pacer;
+    bool isStopped = false;
+    // Only written by the sender thread, read under queueMutex
+    uint64_t sentPackets = 0;
+    uint64_t sendErrors = 0;
+    std::jthread senderThread;
+
+    /* Private methods */
+    void senderThreadBody(std::stop_token stopToken);
+    /**
+     * @brief
+     *  Takes as many packets as may be sent right now from the queue, waiting until the pacer
+     *  lets at least one go. Called under queueMutex.
+     * @return number of packets taken, or 0 if we've been asked to stop
+     */
+    size_t popPacedBatch(std::span<PacketBuffer> batch, std::unique_lock<std::mutex>& lock,
+        std::stop_token stopToken);
+    /**
+     * @return number of datagrams sent, or skipped past because they could not be sent
+     */
+    size_t sendBatch(std::span<PacketBuffer> batch);
+};
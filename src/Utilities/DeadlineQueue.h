@@ -0,0 +1,100 @@
+/**
+ * @file DeadlineQueue.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief
+ *  Keeps values ordered by deadline in a min-heap, so a thread can sleep until exactly the
+ *  next deadline instead of periodically sweeping everything it's waiting on. Values can't be
+ *  removed early - owners should check an expired value is still relevant before acting on it.
+ *  Not thread-safe.
+ */
+template<typename T, typename Clock = std::chrono::steady_clock>
+class DeadlineQueue
+{
+public:
+    /* Public types */
+    using TimePoint = typename Clock::time_point;
+
+    /* Public methods */
+    void Push(TimePoint deadline, T value)
+    {
+        entries.emplace_back(deadline, sequence++, std::move(value));
+        std::push_heap(entries.begin(), entries.end(), std::greater<Entry>());
+    }
+
+    /**
+     * @brief Removes and returns every value whose deadline is at or before the given time,
+     * earliest deadline first
+     */
+    std::vector<T> PopExpired(TimePoint now)
+    {
+        std::vector<T> expired;
+        while (!entries.empty() && (entries.front().Deadline <= now))
+        {
+            std::pop_heap(entries.begin(), entries.end(), std::greater<Entry>());
+            expired.push_back(std::move(entries.back().Value));
+            entries.pop_back();
+        }
+        return expired;
+    }
+
+    /* Getters/Setters */
+    /**
+     * @brief Returns the earliest deadline, or nullopt if nothing is waiting
+     */
+    std::optional<TimePoint> GetNextDeadline() const
+    {
+        if (entries.empty())
+        {
+            return std::nullopt;
+        }
+        return entries.front().Deadline;
+    }
+
+    size_t GetSize() const
+    {
+        return entries.size();
+    }
+
+private:
+    /* Private types */
+    struct Entry
+    {
+        Entry(TimePoint deadline, uint64_t sequence, T value) :
+            Deadline(deadline),
+            Sequence(sequence),
+            Value(std::move(value))
+        { }
+
+        TimePoint Deadline;
+        // Keeps values with the same deadline in the order they were pushed
+        uint64_t Sequence;
+        T Value;
+
+        bool operator>(const Entry& other) const
+        {
+            return (Deadline != other.Deadline) ?
+                (Deadline > other.Deadline) : (Sequence > other.Sequence);
+        }
+    };
+
+    /* Private fields */
+    // Min-heap on deadline
+    std::vector<Entry> entries;
+    uint64_t sequence = 0;
+};
@@ -0,0 +1,84 @@
+/**
+ * @file EgressPacer.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "EgressPacer.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+EgressPacer::EgressPacer(std::chrono::milliseconds interval,
+    std::chrono::milliseconds bitrateWindow, Clock::time_point now)
+:
+    interval(std::max(interval, std::chrono::milliseconds(1))),
+    bitrateWindow(std::max(bitrateWindow, std::chrono::milliseconds(1))),
+    queuedBytes(this->bitrateWindow),
+    // Bursts are counted for longer than they take to send, so the rate doesn't drop off
+    // before the end of one goes out
+    recentlyQueuedBytes((this->interval * 2),
+        std::max(this->interval / 10, std::chrono::milliseconds(1))),
+    lastRefillTime(now)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void EgressPacer::AddQueued(size_t bytes, Clock::time_point now)
+{
+    // Catch the budget up at the rate it was refilling at before this packet
+    refill(now);
+    queuedBytes.Add(bytes, now);
+    recentlyQueuedBytes.Add(bytes, now);
+}
+
+void EgressPacer::AddSent(size_t bytes, Clock::time_point now)
+{
+    refill(now);
+    budgetBytes -= bytes;
+}
+
+EgressPacer::Clock::duration EgressPacer::GetDelay(Clock::time_point now)
+{
+    refill(now);
+    if (budgetBytes > 0)
+    {
+        return Clock::duration::zero();
+    }
+    const std::chrono::duration<double> untilPositive(-budgetBytes / GetBytesPerSecond(now));
+    return (std::chrono::duration_cast<Clock::duration>(untilPositive) + Clock::duration(1));
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+std::chrono::milliseconds EgressPacer::GetInterval() const
+{
+    return interval;
+}
+
+double EgressPacer::GetBytesPerSecond(Clock::time_point now) const
+{
+    const double windowSeconds = std::chrono::duration<double>(bitrateWindow).count();
+    const double intervalSeconds = std::chrono::duration<double>(interval).count();
+    const double averageRate = (queuedBytes.GetSum(now) / windowSeconds);
+    const double burstRate = (recentlyQueuedBytes.GetSum(now) / intervalSeconds);
+    // Never so slow that a burst's worth takes longer than an interval to go out
+    const double minimumRate = (BURST_BYTES / intervalSeconds);
+    return std::max({ (averageRate * PACING_HEADROOM), burstRate, minimumRate });
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void EgressPacer::refill(Clock::time_point now)
+{
+    if (now <= lastRefillTime)
+    {
+        return;
+    }
+    const std::chrono::duration<double> elapsed = (now - lastRefillTime);
+    budgetBytes = std::min<double>(BURST_BYTES,
+        budgetBytes + (elapsed.count() * GetBytesPerSecond(now)));
+    lastRefillTime = now;
+}
+#pragma endregion Private methods
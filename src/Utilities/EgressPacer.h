@@ -0,0 +1,78 @@
+/**
+ * @file EgressPacer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "RollingByteCounter.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief
+ *  Spreads bursts of outgoing packets, like keyframes, out over time instead of sending them
+ *  at line rate. Packets are sent at a rate driven by the rolling bitrate of what's been
+ *  queued, with headroom so steady streams never fall behind, and raised to whatever it takes
+ *  for a burst to go out within one pacing interval of being queued.
+ *  A few packets' worth may always go out back to back. Not thread-safe.
+ */
+class EgressPacer
+{
+public:
+    /* Public types */
+    using Clock = RollingByteCounter::Clock;
+
+    /* Constants */
+    static constexpr std::chrono::milliseconds DEFAULT_BITRATE_WINDOW { 1000 };
+    // Multiple of the rolling bitrate packets are sent at, at the least
+    static constexpr double PACING_HEADROOM = 2.0;
+    static constexpr size_t BURST_BYTES = 4 * 1500;
+
+    /* Constructor/Destructor */
+    /**
+     * @param interval most time a burst is spread out over
+     * @param bitrateWindow length of time the bitrate is averaged over
+     */
+    EgressPacer(std::chrono::milliseconds interval,
+        std::chrono::milliseconds bitrateWindow = DEFAULT_BITRATE_WINDOW,
+        Clock::time_point now = Clock::now());
+
+    /* Public methods */
+    /**
+     * @brief Counts a packet that's been queued to be sent towards the rate
+     */
+    void AddQueued(size_t bytes, Clock::time_point now);
+    /**
+     * @brief Spends a packet's worth of the budget, once it's been let out
+     */
+    void AddSent(size_t bytes, Clock::time_point now);
+    /**
+     * @brief How long until the next packet may be sent, or zero if it may be sent now
+     */
+    Clock::duration GetDelay(Clock::time_point now);
+
+    /* Getters/Setters */
+    std::chrono::milliseconds GetInterval() const;
+    /**
+     * @brief The rate packets are currently being sent at
+     */
+    double GetBytesPerSecond(Clock::time_point now) const;
+
+private:
+    /* Private fields */
+    const std::chrono::milliseconds interval;
+    const std::chrono::milliseconds bitrateWindow;
+    RollingByteCounter queuedBytes;
+    RollingByteCounter recentlyQueuedBytes;
+    // Bytes that may be sent before waiting, which goes negative once a packet overspends it
+    double budgetBytes = BURST_BYTES;
+    Clock::time_point lastRefillTime;
+
+    /* Private methods */
+    void refill(Clock::time_point now);
+};
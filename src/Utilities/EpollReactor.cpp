@@ -0,0 +1,442 @@
+/**
+ * @file EpollReactor.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "EpollReactor.h"
+
+#include "CpuTopology.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <array>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#pragma region Constructor/Destructor
+EpollReactor::EpollReactor(size_t numWorkers, std::vector<int> cpus)
+{
+    if (numWorkers == 0)
+    {
+        numWorkers = cpus.empty() ?
+            std::max(1u, std::thread::hardware_concurrency()) : cpus.size();
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        auto worker = std::make_unique<Worker>();
+        if (!cpus.empty())
+        {
+            worker->Cpu = cpus.at(i % cpus.size());
+            worker->NumaNode = CpuTopology::GetNumaNode(worker->Cpu);
+        }
+        worker->EpollHandle = epoll_create1(EPOLL_CLOEXEC);
+        if (worker->EpollHandle == -1)
+        {
+            throw std::runtime_error(fmt::format("Could not create epoll instance: {}",
+                Util::ErrnoToString(errno)));
+        }
+        worker->WakeHandle = eventfd(0, (EFD_CLOEXEC | EFD_NONBLOCK));
+        if (worker->WakeHandle == -1)
+        {
+            close(worker->EpollHandle);
+            throw std::runtime_error(fmt::format("Could not create eventfd: {}",
+                Util::ErrnoToString(errno)));
+        }
+        epoll_event wakeEvent
+        {
+            .events = EPOLLIN,
+            .data = { .u64 = WAKE_EVENT_ID },
+        };
+        epoll_ctl(worker->EpollHandle, EPOLL_CTL_ADD, worker->WakeHandle, &wakeEvent);
+
+        Worker& workerRef = *worker;
+        worker->Thread = std::jthread(
+            [this, &workerRef](std::stop_token stopToken)
+            {
+                if (workerRef.Cpu >= 0)
+                {
+                    const std::array<int, 1> workerCpus { workerRef.Cpu };
+                    Result<void> pinResult = CpuTopology::PinCurrentThread(workerCpus);
+                    if (pinResult.IsError)
+                    {
+                        spdlog::warn("Reactor worker could not be pinned: {}",
+                            pinResult.ErrorMessage);
+                    }
+                }
+                workerThreadBody(stopToken, workerRef);
+            });
+        workers.push_back(std::move(worker));
+    }
+
+    if (cpus.empty())
+    {
+        spdlog::info("Started connection reactor with {} worker threads", workers.size());
+    }
+    else
+    {
+        spdlog::info("Started connection reactor with {} worker threads pinned to CPUs {}",
+            workers.size(), CpuTopology::FormatCpuList(cpus));
+    }
+}
+
+EpollReactor::~EpollReactor()
+{
+    for (auto& worker : workers)
+    {
+        worker->Thread.request_stop();
+        wakeWorker(*worker);
+    }
+    for (auto& worker : workers)
+    {
+        if (worker->Thread.joinable())
+        {
+            worker->Thread.join();
+        }
+        close(worker->WakeHandle);
+        close(worker->EpollHandle);
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+Result<EpollReactor::RegistrationId> EpollReactor::Register(
+    int handle,
+    ReadableCallback onReadable,
+    UnregisteredCallback onUnregistered,
+    std::optional<int> numaNode)
+{
+    const RegistrationId id = nextRegistrationId++;
+    const size_t workerIndex = chooseWorker(id, numaNode);
+    Worker& worker = *workers.at(workerIndex);
+
+    auto registration = std::make_shared<Registration>();
+    registration->Handle = handle;
+    registration->OnReadable = std::move(onReadable);
+    registration->OnUnregistered = std::move(onUnregistered);
+    registration->Unregistered = registration->UnregisteredPromise.get_future().share();
+
+    std::unique_lock placementLock(registrationWorkersMutex);
+    std::scoped_lock lock(worker.Mutex);
+    worker.Registrations.emplace(id, registration);
+    epoll_event event
+    {
+        .events = EPOLLIN,
+        .data = { .u64 = id },
+    };
+    if (epoll_ctl(worker.EpollHandle, EPOLL_CTL_ADD, handle, &event) == -1)
+    {
+        int error = errno;
+        worker.Registrations.erase(id);
+        return Result<RegistrationId>::Error(fmt::format(
+            "Could not add handle {} to epoll instance. Error {}: {}",
+            handle, error, Util::ErrnoToString(error)));
+    }
+    registrationWorkers.emplace(id, workerIndex);
+
+    return Result<RegistrationId>::Success(id);
+}
+
+void EpollReactor::Unregister(RegistrationId id)
+{
+    std::shared_lock placementLock(registrationWorkersMutex);
+    Worker* worker = workerForRegistration(id);
+    if (worker == nullptr)
+    {
+        return;
+    }
+    {
+        std::scoped_lock lock(worker->Mutex);
+        auto it = worker->Registrations.find(id);
+        if ((it == worker->Registrations.end()) || it->second->IsUnregistering)
+        {
+            return;
+        }
+        it->second->IsUnregistering = true;
+        worker->PendingUnregistrations.push_back(id);
+    }
+    wakeWorker(*worker);
+}
+
+void EpollReactor::WaitUntilUnregistered(RegistrationId id)
+{
+    std::shared_future<void> unregistered;
+    std::thread::id workerThreadId;
+    {
+        std::shared_lock placementLock(registrationWorkersMutex);
+        Worker* worker = workerForRegistration(id);
+        if (worker == nullptr)
+        {
+            return;
+        }
+        std::scoped_lock lock(worker->Mutex);
+        auto it = worker->Registrations.find(id);
+        if (it == worker->Registrations.end())
+        {
+            return;
+        }
+        unregistered = it->second->Unregistered;
+        workerThreadId = worker->Thread.get_id();
+    }
+
+    if (std::this_thread::get_id() == workerThreadId)
+    {
+        spdlog::error("Reactor registration {} cannot wait for itself to be unregistered", id);
+        return;
+    }
+    unregistered.wait();
+}
+
+Result<int> EpollReactor::MoveNearCpu(RegistrationId id, int cpu)
+{
+    // A worker pinned to the CPU itself is best, otherwise any on the same node will do
+    std::optional<size_t> targetIndex;
+    const int numaNode = CpuTopology::GetNumaNode(cpu);
+    std::vector<size_t> nodeWorkerIndexes;
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        if (workers[i]->Cpu == cpu)
+        {
+            targetIndex = i;
+            break;
+        }
+        if ((numaNode != CpuTopology::UNKNOWN_NUMA_NODE) && (workers[i]->NumaNode == numaNode))
+        {
+            nodeWorkerIndexes.push_back(i);
+        }
+    }
+    if (!targetIndex.has_value())
+    {
+        if (nodeWorkerIndexes.empty())
+        {
+            return Result<int>::Error(fmt::format(
+                "No reactor worker is pinned to a CPU on NUMA node {} (CPU {})", numaNode, cpu));
+        }
+        targetIndex = nodeWorkerIndexes.at(id % nodeWorkerIndexes.size());
+    }
+
+    std::shared_lock placementLock(registrationWorkersMutex);
+    auto indexIt = registrationWorkers.find(id);
+    if (indexIt == registrationWorkers.end())
+    {
+        return Result<int>::Error(fmt::format("Reactor registration {} does not exist", id));
+    }
+    Worker& worker = *workers.at(indexIt->second);
+    const bool isTargetOnCpu = (workers[targetIndex.value()]->Cpu == cpu);
+    if ((indexIt->second == targetIndex.value()) || (worker.Cpu == cpu) ||
+        (!isTargetOnCpu && (worker.NumaNode == numaNode)))
+    {
+        // Already as close as it can get
+        return Result<int>::Success(worker.NumaNode);
+    }
+    {
+        std::scoped_lock lock(worker.Mutex);
+        worker.PendingMoves.emplace_back(id, targetIndex.value());
+    }
+    wakeWorker(worker);
+    return Result<int>::Success(workers[targetIndex.value()]->NumaNode);
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t EpollReactor::GetWorkerCount() const
+{
+    return workers.size();
+}
+
+std::optional<int> EpollReactor::GetNumaNode(RegistrationId id)
+{
+    std::shared_lock placementLock(registrationWorkersMutex);
+    Worker* worker = workerForRegistration(id);
+    if (worker == nullptr)
+    {
+        return std::nullopt;
+    }
+    return worker->NumaNode;
+}
+
+std::vector<int> EpollReactor::GetWorkerNumaNodes() const
+{
+    std::vector<int> numaNodes;
+    numaNodes.reserve(workers.size());
+    for (const auto& worker : workers)
+    {
+        numaNodes.push_back(worker->NumaNode);
+    }
+    return numaNodes;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+size_t EpollReactor::chooseWorker(RegistrationId id, std::optional<int> numaNode) const
+{
+    // Registrations are assigned to workers round-robin by ID, among those on the node
+    // they'd like to be on if there are any
+    if (numaNode.has_value() && (numaNode.value() != CpuTopology::UNKNOWN_NUMA_NODE))
+    {
+        std::vector<size_t> nodeWorkerIndexes;
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            if (workers[i]->NumaNode == numaNode.value())
+            {
+                nodeWorkerIndexes.push_back(i);
+            }
+        }
+        if (!nodeWorkerIndexes.empty())
+        {
+            return nodeWorkerIndexes.at(id % nodeWorkerIndexes.size());
+        }
+    }
+    return (id % workers.size());
+}
+
+EpollReactor::Worker* EpollReactor::workerForRegistration(RegistrationId id)
+{
+    // Callers must hold registrationWorkersMutex
+    auto it = registrationWorkers.find(id);
+    if (it == registrationWorkers.end())
+    {
+        return nullptr;
+    }
+    return workers.at(it->second).get();
+}
+void EpollReactor::workerThreadBody(std::stop_token stopToken, Worker& worker)
+{
+    std::array<epoll_event, MAX_EVENTS_PER_WAIT> events;
+    while (!stopToken.stop_requested())
+    {
+        int numEvents = epoll_wait(worker.EpollHandle, events.data(), events.size(), -1);
+        if (numEvents == -1)
+        {
+            int error = errno;
+            if (error == EINTR)
+            {
+                continue;
+            }
+            spdlog::error("Reactor worker failed waiting for events. Error {}: {}",
+                error, Util::ErrnoToString(error));
+            break;
+        }
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const RegistrationId id = events[i].data.u64;
+            if (id == WAKE_EVENT_ID)
+            {
+                uint64_t wakeCount;
+                while (read(worker.WakeHandle, &wakeCount, sizeof(wakeCount)) > 0)
+                { }
+                continue;
+            }
+
+            std::shared_ptr<Registration> registration;
+            {
+                std::scoped_lock lock(worker.Mutex);
+                auto it = worker.Registrations.find(id);
+                if ((it == worker.Registrations.end()) || it->second->IsUnregistering)
+                {
+                    continue;
+                }
+                registration = it->second;
+            }
+
+            // Errors and hang-ups are surfaced to the callback through its next read
+            if (!registration->OnReadable())
+            {
+                Unregister(id);
+            }
+        }
+
+        processPendingUnregistrations(worker);
+        processPendingMoves(worker);
+    }
+
+    // Make sure nobody is left waiting on registrations that will never be processed
+    processPendingUnregistrations(worker);
+}
+
+void EpollReactor::processPendingUnregistrations(Worker& worker)
+{
+    std::vector<std::pair<RegistrationId, std::shared_ptr<Registration>>> unregistered;
+    {
+        std::scoped_lock lock(worker.Mutex);
+        for (const RegistrationId& id : worker.PendingUnregistrations)
+        {
+            auto it = worker.Registrations.find(id);
+            if (it != worker.Registrations.end())
+            {
+                epoll_ctl(worker.EpollHandle, EPOLL_CTL_DEL, it->second->Handle, nullptr);
+                unregistered.emplace_back(id, it->second);
+            }
+        }
+        worker.PendingUnregistrations.clear();
+    }
+
+    // Callbacks are run without the worker lock held, since they may call back into the reactor
+    for (auto& [id, registration] : unregistered)
+    {
+        if (registration->OnUnregistered)
+        {
+            registration->OnUnregistered();
+        }
+        {
+            std::scoped_lock lock(worker.Mutex);
+            worker.Registrations.erase(id);
+        }
+        registration->UnregisteredPromise.set_value();
+        std::unique_lock placementLock(registrationWorkersMutex);
+        registrationWorkers.erase(id);
+    }
+}
+
+void EpollReactor::processPendingMoves(Worker& worker)
+{
+    std::vector<std::pair<RegistrationId, size_t>> moves;
+    {
+        std::scoped_lock lock(worker.Mutex);
+        moves.swap(worker.PendingMoves);
+    }
+
+    // We're in between callbacks, so nothing of ours is running while it changes hands
+    for (const auto& [id, targetIndex] : moves)
+    {
+        std::unique_lock placementLock(registrationWorkersMutex);
+        Worker& targetWorker = *workers.at(targetIndex);
+        std::scoped_lock lock(worker.Mutex, targetWorker.Mutex);
+        auto it = worker.Registrations.find(id);
+        if ((it == worker.Registrations.end()) || it->second->IsUnregistering)
+        {
+            continue;
+        }
+        epoll_event event
+        {
+            .events = EPOLLIN,
+            .data = { .u64 = id },
+        };
+        if (epoll_ctl(targetWorker.EpollHandle, EPOLL_CTL_ADD, it->second->Handle, &event) == -1)
+        {
+            spdlog::warn("Could not move reactor registration {} to another worker: {}",
+                id, Util::ErrnoToString(errno));
+            continue;
+        }
+        epoll_ctl(worker.EpollHandle, EPOLL_CTL_DEL, it->second->Handle, nullptr);
+        targetWorker.Registrations.emplace(id, std::move(it->second));
+        worker.Registrations.erase(it);
+        registrationWorkers[id] = targetIndex;
+    }
+}
+
+void EpollReactor::wakeWorker(Worker& worker)
+{
+    uint64_t wakeCount = 1;
+    if (write(worker.WakeHandle, &wakeCount, sizeof(wakeCount)) == -1)
+    {
+        spdlog::warn("Could not wake reactor worker: {}", Util::ErrnoToString(errno));
+    }
+}
+#pragma endregion Private methods
@@ -0,0 +1,158 @@
+/**
+ * @file EpollReactor.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  A small, fixed pool of epoll worker threads that wait on many OS handles at once and
+ *  dispatch readability events to registered callbacks.
+ *  Each registration is owned by exactly one worker, so callbacks for a given handle are never
+ *  run concurrently with each other.
+ */
+class EpollReactor
+{
+public:
+    /* Public types */
+    using RegistrationId = uint64_t;
+    /**
+     * @brief Called on a worker thread when the handle is readable.
+     * Return false to stop watching the handle.
+     */
+    using ReadableCallback = std::function<bool()>;
+    /**
+     * @brief Called on a worker thread once the handle is no longer being watched.
+     */
+    using UnregisteredCallback = std::function<void()>;
+
+    /* Constructor/Destructor */
+    /**
+     * @param numWorkers
+     *  number of worker threads, or 0 to use one per hardware thread (or one per CPU, if CPUs
+     *  are given)
+     * @param cpus
+     *  CPUs to pin workers to, each worker taking the next CPU in turn, or empty to leave
+     *  workers wherever the OS schedules them
+     */
+    EpollReactor(size_t numWorkers = 0, std::vector<int> cpus = {});
+    ~EpollReactor();
+
+    /* Public methods */
+    /**
+     * @brief Starts watching the given handle for readability.
+     * @param numaNode
+     *  NUMA node the handle would preferably be watched from; ignored if no worker is pinned
+     *  to a CPU on it
+     */
+    Result<RegistrationId> Register(
+        int handle,
+        ReadableCallback onReadable,
+        UnregisteredCallback onUnregistered,
+        std::optional<int> numaNode = std::nullopt);
+
+    /**
+     * @brief
+     *  Stops watching the handle of the given registration. Does not block; the registration's
+     *  UnregisteredCallback will be called on its worker thread once it has been removed.
+     *  Unregistering a registration more than once has no effect.
+     */
+    void Unregister(RegistrationId id);
+
+    /**
+     * @brief
+     *  Blocks until the given registration has been removed and its UnregisteredCallback has
+     *  returned. Must not be called from the registration's own callbacks.
+     */
+    void WaitUntilUnregistered(RegistrationId id);
+
+    /**
+     * @brief
+     *  Moves a registration to the worker pinned closest to the given CPU: the one pinned to
+     *  it if there is one, otherwise one pinned to another CPU on its NUMA node. Does not
+     *  block; the move happens on the registration's current worker in between callbacks, so
+     *  it's safe to call from the registration's own callbacks.
+     * @return the NUMA node the registration is moving to
+     */
+    Result<int> MoveNearCpu(RegistrationId id, int cpu);
+
+    /* Getters/Setters */
+    size_t GetWorkerCount() const;
+    /**
+     * @brief
+     *  NUMA node of the worker currently watching a registration, or
+     *  CpuTopology::UNKNOWN_NUMA_NODE if that worker isn't pinned
+     */
+    std::optional<int> GetNumaNode(RegistrationId id);
+    /**
+     * @brief NUMA node of each worker, indexed by worker
+     */
+    std::vector<int> GetWorkerNumaNodes() const;
+
+private:
+    /* Private types */
+    struct Registration
+    {
+        int Handle;
+        ReadableCallback OnReadable;
+        UnregisteredCallback OnUnregistered;
+        bool IsUnregistering = false;
+        std::promise<void> UnregisteredPromise;
+        std::shared_future<void> Unregistered;
+    };
+
+    struct Worker
+    {
+        int EpollHandle = -1;
+        int WakeHandle = -1;
+        // CPU this worker is pinned to and its NUMA node, unknown if not pinned
+        int Cpu = -1;
+        int NumaNode = -1;
+        std::mutex Mutex;
+        std::unordered_map<RegistrationId, std::shared_ptr<Registration>> Registrations;
+        std::vector<RegistrationId> PendingUnregistrations;
+        // Registrations to hand to other workers, paired with the index of the worker
+        std::vector<std::pair<RegistrationId, size_t>> PendingMoves;
+        std::jthread Thread;
+    };
+
+    /* Constants */
+    static constexpr RegistrationId WAKE_EVENT_ID = 0;
+    static constexpr int MAX_EVENTS_PER_WAIT = 64;
+
+    /* Private fields */
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<RegistrationId> nextRegistrationId { 1 };
+    // Index of the worker each registration lives on. The lock is held shared for as long as
+    // a registration's worker is being used, so the registration can't move in the meantime.
+    std::shared_mutex registrationWorkersMutex;
+    std::unordered_map<RegistrationId, size_t> registrationWorkers;
+
+    /* Private methods */
+    /**
+     * @brief Picks a worker for a registration, preferring ones on the given NUMA node
+     */
+    size_t chooseWorker(RegistrationId id, std::optional<int> numaNode) const;
+    Worker* workerForRegistration(RegistrationId id);
+    void workerThreadBody(std::stop_token stopToken, Worker& worker);
+    void processPendingUnregistrations(Worker& worker);
+    void processPendingMoves(Worker& worker);
+    void wakeWorker(Worker& worker);
+};
@@ -0,0 +1,226 @@
+/**
+ * @file FanoutWorkerPool.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "FanoutWorkerPool.h"
+
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <array>
+#include <spdlog/spdlog.h>
+
+#pragma region Constructor/Destructor
+FanoutWorkerPool::FanoutWorkerPool(size_t numWorkers, std::vector<int> cpus)
+{
+    if (numWorkers == 0)
+    {
+        numWorkers = cpus.empty() ?
+            std::max(1u, std::thread::hardware_concurrency()) : cpus.size();
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        auto worker = std::make_unique<Worker>();
+        if (!cpus.empty())
+        {
+            worker->Cpu = cpus.at(i % cpus.size());
+            worker->NumaNode = CpuTopology::GetNumaNode(worker->Cpu);
+        }
+        Worker& workerRef = *worker;
+        worker->Thread = std::jthread(
+            [this, &workerRef](std::stop_token stopToken)
+            {
+                if (workerRef.Cpu >= 0)
+                {
+                    const std::array<int, 1> workerCpus { workerRef.Cpu };
+                    Result<void> pinResult = CpuTopology::PinCurrentThread(workerCpus);
+                    if (pinResult.IsError)
+                    {
+                        spdlog::warn("Viewer fanout worker could not be pinned: {}",
+                            pinResult.ErrorMessage);
+                    }
+                }
+                workerThreadBody(stopToken, workerRef);
+            });
+        workers.push_back(std::move(worker));
+    }
+
+    if (cpus.empty())
+    {
+        spdlog::info("Started viewer fanout pool with {} worker threads", workers.size());
+    }
+    else
+    {
+        spdlog::info("Started viewer fanout pool with {} worker threads pinned to CPUs {}",
+            workers.size(), CpuTopology::FormatCpuList(cpus));
+    }
+}
+
+FanoutWorkerPool::~FanoutWorkerPool()
+{
+    for (auto& worker : workers)
+    {
+        worker->Thread.request_stop();
+    }
+    for (auto& worker : workers)
+    {
+        if (worker->Thread.joinable())
+        {
+            worker->Thread.join();
+        }
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+FanoutWorkerPool::RegistrationId FanoutWorkerPool::Register(DeliverCallback deliver)
+{
+    const RegistrationId id = nextRegistrationId++;
+    Worker& worker = workerForRegistration(id);
+
+    auto registration = std::make_shared<Registration>();
+    registration->Deliver = std::move(deliver);
+
+    std::scoped_lock lock(worker.Mutex);
+    worker.Registrations.emplace(id, std::move(registration));
+    return id;
+}
+
+void FanoutWorkerPool::Unregister(RegistrationId id)
+{
+    Worker& worker = workerForRegistration(id);
+    std::shared_ptr<Registration> registration;
+    {
+        std::scoped_lock lock(worker.Mutex);
+        auto it = worker.Registrations.find(id);
+        if (it == worker.Registrations.end())
+        {
+            return;
+        }
+        registration = std::move(it->second);
+        worker.Registrations.erase(it);
+    }
+
+    // Packets still in the queue keep the registration alive, but will see it's been removed
+    std::scoped_lock deliverLock(registration->DeliverMutex);
+    registration->IsUnregistered = true;
+}
+
+bool FanoutWorkerPool::Enqueue(RegistrationId id, const PacketBuffer& packet)
+{
+    Worker& worker = workerForRegistration(id);
+    {
+        std::scoped_lock lock(worker.Mutex);
+        auto it = worker.Registrations.find(id);
+        if (it == worker.Registrations.end())
+        {
+            return false;
+        }
+        if (worker.Queue.size() >= MAX_QUEUED_PACKETS_PER_WORKER)
+        {
+            uint64_t dropped = droppedPacketCount.fetch_add(1, std::memory_order_relaxed);
+            if ((dropped % 1000) == 0)
+            {
+                spdlog::warn("Viewer fanout worker is falling behind, dropped {} packets so far",
+                    (dropped + 1));
+            }
+            return false;
+        }
+        worker.Queue.push_back(QueuedPacket { .Target = it->second, .Packet = packet });
+    }
+    worker.QueueCondition.notify_one();
+    return true;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t FanoutWorkerPool::GetWorkerCount() const
+{
+    return workers.size();
+}
+
+uint64_t FanoutWorkerPool::GetDroppedPacketCount() const
+{
+    return droppedPacketCount.load(std::memory_order_relaxed);
+}
+
+size_t FanoutWorkerPool::GetMaxQueueDepth()
+{
+    size_t maxQueueDepth = 0;
+    for (const auto& worker : workers)
+    {
+        std::scoped_lock lock(worker->Mutex);
+        maxQueueDepth = std::max(maxQueueDepth, worker->Queue.size());
+    }
+    return maxQueueDepth;
+}
+
+size_t FanoutWorkerPool::GetWorkerIndex(RegistrationId id) const
+{
+    return (id % workers.size());
+}
+
+std::vector<ThreadPlacement::Snapshot> FanoutWorkerPool::GetWorkerPlacements() const
+{
+    std::vector<ThreadPlacement::Snapshot> placements;
+    placements.reserve(workers.size());
+    for (const auto& worker : workers)
+    {
+        placements.push_back(worker->Placement.Get());
+    }
+    return placements;
+}
+
+std::vector<int> FanoutWorkerPool::GetWorkerNumaNodes() const
+{
+    std::vector<int> numaNodes;
+    numaNodes.reserve(workers.size());
+    for (const auto& worker : workers)
+    {
+        numaNodes.push_back(worker->NumaNode);
+    }
+    return numaNodes;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+FanoutWorkerPool::Worker& FanoutWorkerPool::workerForRegistration(RegistrationId id)
+{
+    // Registrations are assigned to workers round-robin by ID
+    return *workers.at(GetWorkerIndex(id));
+}
+
+void FanoutWorkerPool::workerThreadBody(std::stop_token stopToken, Worker& worker)
+{
+    std::deque<QueuedPacket> packets;
+    while (!stopToken.stop_requested())
+    {
+        {
+            std::unique_lock lock(worker.Mutex);
+            if (!worker.QueueCondition.wait(lock, stopToken,
+                [&worker]() { return !worker.Queue.empty(); }))
+            {
+                break;
+            }
+            // Take everything that's queued at once so ingest isn't contending with us on
+            // every packet
+            packets.swap(worker.Queue);
+        }
+        worker.Placement.Record();
+
+        for (QueuedPacket& queuedPacket : packets)
+        {
+            std::scoped_lock deliverLock(queuedPacket.Target->DeliverMutex);
+            if (!queuedPacket.Target->IsUnregistered)
+            {
+                queuedPacket.Target->Deliver(queuedPacket.Packet);
+            }
+        }
+        packets.clear();
+    }
+}
+#pragma endregion Private methods
@@ -0,0 +1,140 @@
+/**
+ * @file FanoutWorkerPool.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "PacketBuffer.h"
+#include "ThreadPlacement.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  A fixed pool of worker threads that deliver packets to registered fanout targets, so
+ *  sending a packet to many receivers can be spread across cores instead of being done
+ *  inline by whoever received it.
+ *  Each registration is owned by exactly one worker, so packets enqueued for a registration
+ *  are delivered in order and never concurrently with each other.
+ */
+class FanoutWorkerPool
+{
+public:
+    /* Public types */
+    using RegistrationId = uint64_t;
+    /**
+     * @brief Called on a worker thread with each packet enqueued for a registration
+     */
+    using DeliverCallback = std::function<void(const PacketBuffer& packet)>;
+
+    /* Constants */
+    // Packets queued per worker beyond this are dropped rather than growing without bound
+    static constexpr size_t MAX_QUEUED_PACKETS_PER_WORKER = 8192;
+
+    /* Constructor/Destructor */
+    /**
+     * @param numWorkers
+     *  number of worker threads, or 0 to use one per hardware thread (or one per CPU, if CPUs
+     *  are given)
+     * @param cpus
+     *  CPUs to pin workers to, each worker taking the next CPU in turn, or empty to leave
+     *  workers wherever the OS schedules them
+     */
+    FanoutWorkerPool(size_t numWorkers = 0, std::vector<int> cpus = {});
+    ~FanoutWorkerPool();
+
+    /* Public methods */
+    /**
+     * @brief Registers a target that packets can be enqueued for
+     */
+    RegistrationId Register(DeliverCallback deliver);
+
+    /**
+     * @brief
+     *  Removes a registration, discarding any packets still queued for it. Blocks until any
+     *  delivery to the registration already in progress has returned, so once this returns the
+     *  callback will never be called again. Must not be called from a delivery callback.
+     */
+    void Unregister(RegistrationId id);
+
+    /**
+     * @brief Queues a packet to be delivered to a registration on its worker thread
+     * @return false if the registration does not exist or the worker's queue is full
+     */
+    bool Enqueue(RegistrationId id, const PacketBuffer& packet);
+
+    /* Getters/Setters */
+    size_t GetWorkerCount() const;
+    /**
+     * @brief Number of packets dropped because a worker's queue was full
+     */
+    uint64_t GetDroppedPacketCount() const;
+    /**
+     * @brief Number of packets waiting in the queue of whichever worker is furthest behind
+     */
+    size_t GetMaxQueueDepth();
+    /**
+     * @brief Index of the worker that delivers to a registration
+     */
+    size_t GetWorkerIndex(RegistrationId id) const;
+    /**
+     * @brief Thread and CPU each worker last delivered packets from, indexed by worker
+     */
+    std::vector<ThreadPlacement::Snapshot> GetWorkerPlacements() const;
+    /**
+     * @brief
+     *  NUMA node of the CPU each worker is pinned to, indexed by worker, or
+     *  CpuTopology::UNKNOWN_NUMA_NODE for workers that aren't pinned
+     */
+    std::vector<int> GetWorkerNumaNodes() const;
+
+private:
+    /* Private types */
+    struct Registration
+    {
+        DeliverCallback Deliver;
+        // Held while delivering, so unregistration can wait out in-flight deliveries
+        std::mutex DeliverMutex;
+        bool IsUnregistered = false;
+    };
+
+    struct QueuedPacket
+    {
+        std::shared_ptr<Registration> Target;
+        PacketBuffer Packet;
+    };
+
+    struct Worker
+    {
+        std::mutex Mutex;
+        std::condition_variable_any QueueCondition;
+        std::unordered_map<RegistrationId, std::shared_ptr<Registration>> Registrations;
+        std::deque<QueuedPacket> Queue;
+        // CPU this worker is pinned to and its NUMA node, unknown if not pinned
+        int Cpu = -1;
+        int NumaNode = -1;
+        ThreadPlacement Placement;
+        std::jthread Thread;
+    };
+
+    /* Private fields */
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<RegistrationId> nextRegistrationId { 0 };
+    std::atomic<uint64_t> droppedPacketCount { 0 };
+
+    /* Private methods */
+    Worker& workerForRegistration(RegistrationId id);
+    void workerThreadBody(std::stop_token stopToken, Worker& worker);
+};
@@ -12,14 +12,17 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "../Rtp/Types.h"
+#include "PacketBuffer.h"
 
 #pragma region Typedefs for various number values
 /* FTL data types */
@@ -170,12 +173,59 @@ struct FtlStreamStats
     uint32_t PacketsReceived;
     uint32_t PacketsNacked;
     uint32_t PacketsLost;
+    uint64_t BytesReceived;
+    // Packets held for retransmission, summed across the stream's SSRCs
+    uint32_t PacketsBuffered;
+    uint32_t PacketBufferCapacity;
+    // Missing packets waiting to be NACKed, and those NACKed but not yet received
+    uint32_t NacksQueued;
+    uint32_t NacksOutstanding;
+    // Packet buffer capacity the stream holds against its budget (0 for no limit), and
+    // keyframes that weren't captured because they'd have gone over it
+    uint64_t MemoryBytes;
+    uint64_t MemoryBudgetBytes;
+    uint32_t KeyframesDropped;
+    // Media packets dropped because they'd have taken the stream over its bitrate limit
+    uint32_t PacketsOverBitrateLimit;
+    // Smoothed round trip time to the streamer, or 0 if it hasn't been measured yet
+    uint32_t RoundTripTimeMs;
+    // Media packets the streamer says it has sent, as of its latest sender reports
+    uint32_t SenderReportedPackets;
+    // Media packets the reorder stage dropped for arriving after the packets following them
+    // had gone out without them, or for being copies of packets already seen
+    uint32_t PacketsDroppedLate;
+    uint32_t DuplicatePacketsDropped;
+    // Thread that last read media packets, and the CPU it was on at the time
+    int32_t ReaderThreadId = 0;
+    int32_t ReaderCpu = -1;
+};
+
+/**
+ * @brief Video stream properties read from the codec's own parameter sets
+ */
+struct VideoParameters
+{
+    uint16_t Width = 0;
+    uint16_t Height = 0;
+    uint8_t ProfileIdc = 0;
+    uint8_t LevelIdc = 0;
+    // Only known if the stream signals its timing
+    std::optional<double> FrameRate;
+
+    bool operator==(const VideoParameters&) const = default;
 };
 
 struct FtlKeyframe
 {
     VideoCodecKind Codec;
-    std::list<std::vector<std::byte>> Packets;
+    // Increases each time a new keyframe is captured for a stream, 0 if none has been captured
+    uint64_t Generation = 0;
+    // When the keyframe was captured, unset if none has been
+    std::chrono::steady_clock::time_point CapturedTime;
+    // Shares the buffers of the packets it was assembled from
+    std::list<PacketBuffer> Packets;
+    // Parameters from the most recent parameter set seen on the stream, if it could be parsed
+    std::optional<VideoParameters> Parameters;
 };
 
 #pragma endregion FTL/RTP Types
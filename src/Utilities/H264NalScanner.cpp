@@ -0,0 +1,152 @@
+/**
+ * @file H264NalScanner.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "H264NalScanner.h"
+
+#include <bit>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    constexpr uint8_t START_CODE_LAST_BYTE = 0x01;
+    constexpr uint8_t EMULATION_PREVENTION_BYTE = 0x03;
+
+#if defined(__AVX2__)
+    constexpr size_t BLOCK_SIZE = 32;
+    constexpr uint32_t BITS_PER_BYTE = 1;
+
+    /**
+     * @brief A mask of the bytes in the block that begin a 00 00 pair, one bit per byte
+     */
+    uint64_t zeroPairMask(const std::byte* block)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+        const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 1));
+        const __m256i pairs = _mm256_and_si256(_mm256_cmpeq_epi8(first, zero),
+            _mm256_cmpeq_epi8(second, zero));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(pairs));
+    }
+#elif defined(__SSE2__)
+    constexpr size_t BLOCK_SIZE = 16;
+    constexpr uint32_t BITS_PER_BYTE = 1;
+
+    uint64_t zeroPairMask(const std::byte* block)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 1));
+        const __m128i pairs = _mm_and_si128(_mm_cmpeq_epi8(first, zero),
+            _mm_cmpeq_epi8(second, zero));
+        return static_cast<uint32_t>(_mm_movemask_epi8(pairs));
+    }
+#elif defined(__ARM_NEON)
+    constexpr size_t BLOCK_SIZE = 16;
+    // NEON has no movemask, so each byte's comparison is narrowed down to a nibble instead
+    constexpr uint32_t BITS_PER_BYTE = 4;
+
+    uint64_t zeroPairMask(const std::byte* block)
+    {
+        const uint8x16_t zero = vdupq_n_u8(0);
+        const uint8x16_t first = vld1q_u8(reinterpret_cast<const uint8_t*>(block));
+        const uint8x16_t second = vld1q_u8(reinterpret_cast<const uint8_t*>(block + 1));
+        const uint8x16_t pairs = vandq_u8(vceqq_u8(first, zero), vceqq_u8(second, zero));
+        const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(pairs), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+    }
+#endif
+}
+
+#pragma region Static methods
+size_t H264NalScanner::FindStartCode(std::span<const std::byte> bytes, size_t offset)
+{
+    return findZeroZero(bytes, offset, START_CODE_LAST_BYTE);
+}
+
+size_t H264NalScanner::FindEmulationPreventionByte(std::span<const std::byte> bytes,
+    size_t offset)
+{
+    const size_t index = findZeroZero(bytes, offset, EMULATION_PREVENTION_BYTE);
+    return (index < bytes.size()) ? (index + 2) : bytes.size();
+}
+
+void H264NalScanner::AppendUnescaped(std::span<const std::byte> escaped,
+    std::vector<uint8_t>& rbsp)
+{
+    rbsp.reserve(rbsp.size() + escaped.size());
+    size_t offset = 0;
+    while (offset < escaped.size())
+    {
+        const size_t escapeIndex = FindEmulationPreventionByte(escaped, offset);
+        const auto run = escaped.subspan(offset, (escapeIndex - offset));
+        const auto runBytes = reinterpret_cast<const uint8_t*>(run.data());
+        rbsp.insert(rbsp.end(), runBytes, (runBytes + run.size()));
+        // Zeroes counted toward the next escape start after the one we've skipped
+        offset = (escapeIndex + 1);
+    }
+}
+
+const char* H264NalScanner::GetImplementationName()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+size_t H264NalScanner::FindZeroZeroScalar(std::span<const std::byte> bytes, size_t offset,
+    uint8_t followingByte)
+{
+    for (size_t i = offset; (i + 2) < bytes.size(); ++i)
+    {
+        if ((bytes[i] == std::byte(0)) && (bytes[i + 1] == std::byte(0)) &&
+            (bytes[i + 2] == std::byte(followingByte)))
+        {
+            return i;
+        }
+    }
+    return bytes.size();
+}
+#pragma endregion Static methods
+
+#pragma region Private methods
+size_t H264NalScanner::findZeroZero(std::span<const std::byte> bytes, size_t offset,
+    uint8_t followingByte)
+{
+    size_t i = offset;
+#if defined(__AVX2__) || defined(__SSE2__) || defined(__ARM_NEON)
+    // Each block's pairs are read one byte past it, and their following bytes two past it
+    while ((i + BLOCK_SIZE + 2) <= bytes.size())
+    {
+        uint64_t mask = zeroPairMask(bytes.data() + i);
+        while (mask != 0)
+        {
+            const size_t pairIndex = (i + (std::countr_zero(mask) / BITS_PER_BYTE));
+            if (bytes[pairIndex + 2] == std::byte(followingByte))
+            {
+                return pairIndex;
+            }
+            // Clear every bit belonging to this byte
+            mask &= ~(((uint64_t { 1 } << BITS_PER_BYTE) - 1) <<
+                ((pairIndex - i) * BITS_PER_BYTE));
+        }
+        i += BLOCK_SIZE;
+    }
+#endif
+    return FindZeroZeroScalar(bytes, i, followingByte);
+}
+#pragma endregion Private methods
@@ -0,0 +1,66 @@
+/**
+ * @file H264NalScanner.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief
+ *  Finds the byte patterns H264 bitstreams are delimited and escaped with: start codes
+ *  (00 00 01) between Annex B NAL units, and emulation prevention bytes (the 03 of 00 00 03)
+ *  within them. Scans SIMD-register-sized blocks at a time where the target supports it
+ *  (AVX2, SSE2 or NEON), and falls back to a byte-by-byte scan elsewhere.
+ */
+class H264NalScanner
+{
+public:
+    /* Static methods */
+    /**
+     * @brief
+     *  Finds the first three-byte start code at or after offset, so a four-byte start code is
+     *  found at its second byte
+     * @return the index of the start code's first byte, or bytes.size() if there are none
+     */
+    static size_t FindStartCode(std::span<const std::byte> bytes, size_t offset = 0);
+
+    /**
+     * @brief Finds the first emulation prevention byte at or after offset
+     * @return the index of the 03 byte, or bytes.size() if there are none
+     */
+    static size_t FindEmulationPreventionByte(std::span<const std::byte> bytes,
+        size_t offset = 0);
+
+    /**
+     * @brief
+     *  Appends a NAL unit's payload to rbsp with its emulation prevention bytes stripped,
+     *  giving the raw byte sequence its syntax elements are read from
+     */
+    static void AppendUnescaped(std::span<const std::byte> escaped, std::vector<uint8_t>& rbsp);
+
+    /**
+     * @brief Which scan this build of the scanner uses, for benchmarks and logging
+     */
+    static const char* GetImplementationName();
+
+    /**
+     * @brief
+     *  Finds the first 00 00 followed by the given byte at or after offset, byte by byte. The
+     *  reference the vectorized scan is checked and benchmarked against.
+     * @return the index of the first 00, or bytes.size() if there are none
+     */
+    static size_t FindZeroZeroScalar(std::span<const std::byte> bytes, size_t offset,
+        uint8_t followingByte);
+
+private:
+    /* Private methods */
+    static size_t findZeroZero(std::span<const std::byte> bytes, size_t offset,
+        uint8_t followingByte);
+};
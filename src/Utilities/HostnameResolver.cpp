@@ -0,0 +1,89 @@
+/**
+ * @file HostnameResolver.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "HostnameResolver.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#pragma region Constructor/Destructor
+HostnameResolver::HostnameResolver(std::chrono::milliseconds ttl, Lookup lookup)
+:
+    ttl(ttl),
+    lookup(lookup ? std::move(lookup) : &HostnameResolver::LookupWithGetAddrInfo)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+Result<IpAddress> HostnameResolver::Resolve(const std::string& hostname)
+{
+    {
+        std::scoped_lock lock(mutex);
+        auto it = entries.find(hostname);
+        if (it != entries.end())
+        {
+            if (std::chrono::steady_clock::now() < it->second.ExpiryTime)
+            {
+                return Result<IpAddress>::Success(it->second.Addr);
+            }
+            entries.erase(it);
+        }
+    }
+
+    Result<IpAddress> result = lookup(hostname);
+    if (!result.IsError && (ttl > std::chrono::milliseconds(0)))
+    {
+        std::scoped_lock lock(mutex);
+        entries.insert_or_assign(hostname, Entry
+            {
+                .Addr = result.Value,
+                .ExpiryTime = std::chrono::steady_clock::now() + ttl,
+            });
+    }
+    return result;
+}
+
+void HostnameResolver::Invalidate(const std::string& hostname)
+{
+    std::scoped_lock lock(mutex);
+    entries.erase(hostname);
+}
+#pragma endregion Public methods
+
+#pragma region Static methods
+Result<IpAddress> HostnameResolver::LookupWithGetAddrInfo(const std::string& hostname)
+{
+    addrinfo addrHints { 0 };
+    addrHints.ai_family = AF_UNSPEC;
+    addrHints.ai_socktype = SOCK_STREAM;
+    addrHints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addrInfoPtr = nullptr;
+    int lookupErr = getaddrinfo(hostname.c_str(), nullptr, &addrHints, &addrInfoPtr);
+    // Store addr lookup in a smart pointer so it is free'd when it goes out of scope
+    std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> addrInfo(addrInfoPtr, &freeaddrinfo);
+    if ((lookupErr != 0) || (addrInfo == nullptr))
+    {
+        return Result<IpAddress>::Error(
+            fmt::format("Error looking up hostname {}: {}", hostname, gai_strerror(lookupErr)));
+    }
+
+    // TODO: Try additional addresses on failure. For now, only use the first one.
+    sockaddr_storage addr {};
+    std::memcpy(&addr, addrInfo->ai_addr,
+        std::min<size_t>(addrInfo->ai_addrlen, sizeof(addr)));
+    std::optional<IpAddress> address = IpAddress::FromSockaddr(addr);
+    if (!address.has_value())
+    {
+        return Result<IpAddress>::Error(
+            fmt::format("Hostname {} resolved to an unsupported address family", hostname));
+    }
+    return Result<IpAddress>::Success(address.value());
+}
+#pragma endregion Static methods
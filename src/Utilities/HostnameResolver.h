@@ -0,0 +1,69 @@
+/**
+ * @file HostnameResolver.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "IpAddress.h"
+#include "Result.h"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief
+ *  Looks up IPv4 or IPv6 addresses for hostnames, remembering successful lookups for a while so
+ *  connecting to the same host again (or for another relay) doesn't wait on DNS. Thread-safe;
+ *  lookups run without holding any locks.
+ */
+class HostnameResolver
+{
+public:
+    /* Public types */
+    using Lookup = std::function<Result<IpAddress>(const std::string& hostname)>;
+
+    /* Constants */
+    static constexpr std::chrono::milliseconds DEFAULT_TTL{30000};
+
+    /* Constructor/Destructor */
+    /**
+     * @param lookup resolves a hostname, defaults to getaddrinfo
+     */
+    HostnameResolver(std::chrono::milliseconds ttl = DEFAULT_TTL, Lookup lookup = nullptr);
+
+    /* Public methods */
+    Result<IpAddress> Resolve(const std::string& hostname);
+
+    /**
+     * @brief Forgets the cached address for a hostname, such as after failing to connect to it
+     */
+    void Invalidate(const std::string& hostname);
+
+    /* Static methods */
+    /**
+     * @brief
+     *  The first address getaddrinfo gives for a hostname, of either family. Its address
+     *  sorting puts families we have no route to last.
+     */
+    static Result<IpAddress> LookupWithGetAddrInfo(const std::string& hostname);
+
+private:
+    /* Private types */
+    struct Entry
+    {
+        IpAddress Addr;
+        std::chrono::steady_clock::time_point ExpiryTime;
+    };
+
+    /* Private fields */
+    const std::chrono::milliseconds ttl;
+    const Lookup lookup;
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+};
@@ -0,0 +1,148 @@
+/**
+ * @file IpAddress.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "IpAddress.h"
+
+#include "Util.h"
+
+#include <cstring>
+#include <functional>
+
+#pragma region Public types
+size_t IpAddress::Hash::operator()(const IpAddress& address) const
+{
+    uint64_t high;
+    uint64_t low;
+    std::memcpy(&high, address.bytes.data(), sizeof(high));
+    std::memcpy(&low, (address.bytes.data() + sizeof(high)), sizeof(low));
+    return std::hash<uint64_t>()(high ^ (low * 0x9E3779B97F4A7C15ull)) ^
+        (static_cast<size_t>(address.family) << 1);
+}
+#pragma endregion Public types
+
+#pragma region Constructor/Destructor
+IpAddress::IpAddress()
+:
+    family(AF_INET)
+{ }
+
+IpAddress::IpAddress(in_addr address)
+:
+    family(AF_INET)
+{
+    std::memcpy(bytes.data(), &address, sizeof(address));
+}
+
+IpAddress::IpAddress(const in6_addr& address)
+:
+    family(AF_INET6)
+{
+    if (IN6_IS_ADDR_V4MAPPED(&address))
+    {
+        // The IPv4 address is the last four bytes of ::ffff:a.b.c.d
+        family = AF_INET;
+        std::memcpy(bytes.data(), &address.s6_addr[12], sizeof(in_addr));
+        return;
+    }
+    std::memcpy(bytes.data(), &address, sizeof(address));
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Static methods
+std::optional<IpAddress> IpAddress::FromSockaddr(const sockaddr_storage& address)
+{
+    switch (address.ss_family)
+    {
+    case AF_INET:
+        return IpAddress(reinterpret_cast<const sockaddr_in&>(address).sin_addr);
+    case AF_INET6:
+        return IpAddress(reinterpret_cast<const sockaddr_in6&>(address).sin6_addr);
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<IpAddress> IpAddress::FromSockaddr(const std::optional<sockaddr_in>& address,
+    const std::optional<sockaddr_in6>& address6)
+{
+    if (address.has_value())
+    {
+        return IpAddress(address.value().sin_addr);
+    }
+    if (address6.has_value())
+    {
+        return IpAddress(address6.value().sin6_addr);
+    }
+    return std::nullopt;
+}
+
+uint16_t IpAddress::GetPort(const sockaddr_storage& address)
+{
+    switch (address.ss_family)
+    {
+    case AF_INET:
+        return reinterpret_cast<const sockaddr_in&>(address).sin_port;
+    case AF_INET6:
+        return reinterpret_cast<const sockaddr_in6&>(address).sin6_port;
+    default:
+        return 0;
+    }
+}
+#pragma endregion Static methods
+
+#pragma region Public methods
+std::string IpAddress::ToString() const
+{
+    if (family == AF_INET)
+    {
+        return Util::AddrToString(ToIpv4(0).value().sin_addr);
+    }
+    return Util::AddrToString(ToIpv6(0).sin6_addr);
+}
+
+std::optional<sockaddr_in> IpAddress::ToIpv4(uint16_t port) const
+{
+    if (family != AF_INET)
+    {
+        return std::nullopt;
+    }
+    sockaddr_in address
+    {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+    };
+    std::memcpy(&address.sin_addr, bytes.data(), sizeof(address.sin_addr));
+    return address;
+}
+
+sockaddr_in6 IpAddress::ToIpv6(uint16_t port) const
+{
+    sockaddr_in6 address
+    {
+        .sin6_family = AF_INET6,
+        .sin6_port = htons(port),
+    };
+    if (family == AF_INET)
+    {
+        address.sin6_addr.s6_addr[10] = 0xFF;
+        address.sin6_addr.s6_addr[11] = 0xFF;
+        std::memcpy(&address.sin6_addr.s6_addr[12], bytes.data(), sizeof(in_addr));
+    }
+    else
+    {
+        std::memcpy(&address.sin6_addr, bytes.data(), sizeof(address.sin6_addr));
+    }
+    return address;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+sa_family_t IpAddress::GetFamily() const
+{
+    return family;
+}
+#pragma endregion Getters/Setters
@@ -0,0 +1,80 @@
+/**
+ * @file IpAddress.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+
+/**
+ * @brief
+ *  The address of an IPv4 or IPv6 peer, without a port. IPv4 peers that reach a dual-stack
+ *  socket through an IPv4-mapped IPv6 address are held as the IPv4 address they map, so a
+ *  peer compares equal however it reached us.
+ */
+class IpAddress
+{
+public:
+    /* Public types */
+    struct Hash
+    {
+        size_t operator()(const IpAddress& address) const;
+    };
+
+    /* Constructor/Destructor */
+    /**
+     * @brief The unspecified IPv4 address, 0.0.0.0
+     */
+    IpAddress();
+    explicit IpAddress(in_addr address);
+    explicit IpAddress(const in6_addr& address);
+
+    /* Static methods */
+    /**
+     * @brief The address of an IPv4 or IPv6 socket address, or nothing for other families
+     */
+    static std::optional<IpAddress> FromSockaddr(const sockaddr_storage& address);
+    /**
+     * @brief
+     *  The address of whichever of an IPv4 and an IPv6 socket address is set (ex. by
+     *  ConnectionTransport::GetAddr and GetAddr6), preferring IPv4
+     */
+    static std::optional<IpAddress> FromSockaddr(const std::optional<sockaddr_in>& address,
+        const std::optional<sockaddr_in6>& address6);
+    /**
+     * @brief The port of an IPv4 or IPv6 socket address, in network byte order
+     */
+    static uint16_t GetPort(const sockaddr_storage& address);
+
+    /* Public methods */
+    bool operator==(const IpAddress& other) const = default;
+    std::string ToString() const;
+    /**
+     * @brief This address with the given port (in host byte order), if it's an IPv4 address
+     */
+    std::optional<sockaddr_in> ToIpv4(uint16_t port) const;
+    /**
+     * @brief
+     *  This address with the given port (in host byte order) for an IPv6 socket, IPv4
+     *  addresses being mapped so they can be reached from a dual-stack socket
+     */
+    sockaddr_in6 ToIpv6(uint16_t port) const;
+
+    /* Getters/Setters */
+    sa_family_t GetFamily() const;
+
+private:
+    /* Private fields */
+    sa_family_t family;
+    // Network byte order, IPv4 addresses taking up the first four bytes
+    std::array<uint8_t, 16> bytes {};
+};
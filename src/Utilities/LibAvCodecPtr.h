@@ -49,6 +49,22 @@ typedef
         AVFrame,
         AVFrameUnref> AVFramePtr;
 
+// RAII Pointer for AVBufferRef
+struct AVBufferRefUnref
+{
+    void operator() (AVBufferRef* buffer)
+    {
+        if (buffer != nullptr)
+        {
+            av_buffer_unref(&buffer);
+        }
+    }
+};
+typedef
+    std::unique_ptr<
+        AVBufferRef,
+        AVBufferRefUnref> AVBufferRefPtr;
+
 // RAII Pointer for AVPacket
 struct AVPacketUnref
 {
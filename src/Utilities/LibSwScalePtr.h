@@ -0,0 +1,31 @@
+/**
+ * @file LibSwScalePtr.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @brief RAII smart pointer wrappers for libswscale pointers
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+#pragma once
+
+#include <memory>
+
+extern "C"
+{
+    #include <libswscale/swscale.h>
+}
+
+// RAII Pointer for SwsContext
+struct SwsContextFree
+{
+    void operator() (SwsContext* context)
+    {
+        if (context != nullptr)
+        {
+            sws_freeContext(context);
+        }
+    }
+};
+typedef
+    std::unique_ptr<
+        SwsContext,
+        SwsContextFree> SwsContextPtr;
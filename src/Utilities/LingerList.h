@@ -0,0 +1,139 @@
+/**
+ * @file LingerList.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  Keeps track of things that are no longer in use but are being kept around for a while in
+ *  case they're wanted again. Each entry has a cost, and once the total cost of every entry goes
+ *  over budget the entries that have lingered longest are evicted first. Thread-safe.
+ */
+template<typename TKey, typename Clock = std::chrono::steady_clock>
+class LingerList
+{
+public:
+    /* Public types */
+    using TimePoint = typename Clock::time_point;
+
+    /* Constructor/Destructor */
+    /**
+     * @param lingerTime how long an entry lingers before it expires
+     * @param costBudget most total cost of lingering entries, or 0 for no limit
+     */
+    LingerList(std::chrono::milliseconds lingerTime, uint64_t costBudget) :
+        lingerTime(lingerTime),
+        costBudget(costBudget)
+    { }
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Starts the given key lingering (starting it over if it already is), returning any keys
+     *  that were evicted to bring the total cost back within budget. This can include the given
+     *  key itself if it costs more than the whole budget.
+     */
+    std::vector<TKey> Add(const TKey& key, uint64_t cost, TimePoint now = Clock::now())
+    {
+        std::scoped_lock lock(mutex);
+        removeEntry(key);
+        entries.push_back(Entry { .Key = key, .Cost = cost, .ExpiresAt = now + lingerTime });
+        entriesByKey.try_emplace(key, std::prev(entries.end()));
+        totalCost += cost;
+
+        std::vector<TKey> evicted;
+        while ((costBudget > 0) && (totalCost > costBudget) && !entries.empty())
+        {
+            evicted.push_back(entries.front().Key);
+            removeEntry(entries.front().Key);
+        }
+        return evicted;
+    }
+
+    /**
+     * @brief Stops the given key lingering, returning whether it was
+     */
+    bool Remove(const TKey& key)
+    {
+        std::scoped_lock lock(mutex);
+        return removeEntry(key);
+    }
+
+    /**
+     * @brief Removes and returns every key that has finished lingering
+     */
+    std::vector<TKey> RemoveExpired(TimePoint now = Clock::now())
+    {
+        std::scoped_lock lock(mutex);
+        // Every entry lingers for the same time, so they expire in the order they were added
+        std::vector<TKey> expired;
+        while (!entries.empty() && (entries.front().ExpiresAt <= now))
+        {
+            expired.push_back(entries.front().Key);
+            removeEntry(entries.front().Key);
+        }
+        return expired;
+    }
+
+    /* Getters/Setters */
+    bool Contains(const TKey& key)
+    {
+        std::scoped_lock lock(mutex);
+        return entriesByKey.contains(key);
+    }
+
+    size_t GetSize()
+    {
+        std::scoped_lock lock(mutex);
+        return entries.size();
+    }
+
+    uint64_t GetTotalCost()
+    {
+        std::scoped_lock lock(mutex);
+        return totalCost;
+    }
+
+private:
+    /* Private types */
+    struct Entry
+    {
+        TKey Key;
+        uint64_t Cost;
+        TimePoint ExpiresAt;
+    };
+
+    /* Private fields */
+    const std::chrono::milliseconds lingerTime;
+    const uint64_t costBudget;
+    std::mutex mutex;
+    // Ordered from the entry that has lingered longest to the most recently added
+    std::list<Entry> entries;
+    std::unordered_map<TKey, typename std::list<Entry>::iterator> entriesByKey;
+    uint64_t totalCost = 0;
+
+    /* Private methods */
+    bool removeEntry(const TKey& key)
+    {
+        auto it = entriesByKey.find(key);
+        if (it == entriesByKey.end())
+        {
+            return false;
+        }
+        totalCost -= it->second->Cost;
+        entries.erase(it->second);
+        entriesByKey.erase(it);
+        return true;
+    }
+};
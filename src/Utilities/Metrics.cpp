@@ -0,0 +1,366 @@
+/**
+ * @file Metrics.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fmt/core.h>
+#include <stdexcept>
+
+#pragma region MetricCounter
+void MetricCounter::Increment(uint64_t amount)
+{
+    value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t MetricCounter::GetValue() const
+{
+    return value.load(std::memory_order_relaxed);
+}
+#pragma endregion MetricCounter
+
+#pragma region MetricGauge
+void MetricGauge::Add(double amount)
+{
+    value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void MetricGauge::Set(double newValue)
+{
+    value.store(newValue, std::memory_order_relaxed);
+}
+
+double MetricGauge::GetValue() const
+{
+    return value.load(std::memory_order_relaxed);
+}
+#pragma endregion MetricGauge
+
+#pragma region MetricHistogram
+namespace
+{
+    /**
+     * @brief Spreads threads across histogram shards in the order they first observe a value
+     */
+    size_t currentThreadShard()
+    {
+        static std::atomic<size_t> nextThreadShard { 0 };
+        thread_local const size_t threadShard =
+            nextThreadShard.fetch_add(1, std::memory_order_relaxed) % MetricHistogram::NUM_SHARDS;
+        return threadShard;
+    }
+}
+
+MetricHistogram::MetricHistogram(std::vector<double> bucketBounds)
+:
+    bucketBounds(std::move(bucketBounds)),
+    linesPerShard((this->bucketBounds.size() + COUNTS_PER_LINE) / COUNTS_PER_LINE),
+    countLines(std::make_unique<CountLine[]>(NUM_SHARDS * linesPerShard)),
+    sums(std::make_unique<ShardSum[]>(NUM_SHARDS))
+{
+    if (!std::is_sorted(this->bucketBounds.begin(), this->bucketBounds.end()))
+    {
+        throw std::invalid_argument("Histogram bucket bounds must be in ascending order");
+    }
+}
+
+void MetricHistogram::Observe(double value)
+{
+    // Bounds are inclusive, and anything past the last one lands in the extra bucket at the end
+    const size_t bucketIndex = std::lower_bound(bucketBounds.begin(), bucketBounds.end(), value) -
+        bucketBounds.begin();
+    const size_t shard = currentThreadShard();
+    bucketCount(shard, bucketIndex).fetch_add(1, std::memory_order_relaxed);
+    sums[shard].Value.fetch_add(value, std::memory_order_relaxed);
+}
+
+void MetricHistogram::ObserveDuration(std::chrono::nanoseconds duration)
+{
+    Observe(std::chrono::duration<double>(duration).count());
+}
+
+const std::vector<double>& MetricHistogram::GetBucketBounds() const
+{
+    return bucketBounds;
+}
+
+MetricHistogram::Snapshot MetricHistogram::GetSnapshot() const
+{
+    // Counting from the buckets keeps the count consistent with them, even if a value is
+    // observed while we read
+    Snapshot snapshot;
+    snapshot.BucketCounts.assign(bucketBounds.size() + 1, 0);
+    for (size_t shard = 0; shard < NUM_SHARDS; ++shard)
+    {
+        for (size_t i = 0; i < snapshot.BucketCounts.size(); ++i)
+        {
+            const uint64_t count = bucketCount(shard, i).load(std::memory_order_relaxed);
+            snapshot.BucketCounts[i] += count;
+            snapshot.Count += count;
+        }
+        snapshot.Sum += sums[shard].Value.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+std::atomic<uint64_t>& MetricHistogram::bucketCount(size_t shard, size_t bucketIndex) const
+{
+    CountLine& line = countLines[(shard * linesPerShard) + (bucketIndex / COUNTS_PER_LINE)];
+    return line.Counts[bucketIndex % COUNTS_PER_LINE];
+}
+#pragma endregion MetricHistogram
+
+#pragma region MetricsRegistry::Writer
+MetricsRegistry::Writer::Writer(MetricsRegistry& registry)
+:
+    registry(registry)
+{ }
+
+void MetricsRegistry::Writer::Counter(const std::string& name, const std::string& help,
+    const MetricLabels& labels, uint64_t value)
+{
+    registry.getFamily(MetricType::Counter, name, help).CollectedSamples +=
+        fmt::format("{}{} {}\n", name, formatLabels(labels), value);
+}
+
+void MetricsRegistry::Writer::Gauge(const std::string& name, const std::string& help,
+    const MetricLabels& labels, double value)
+{
+    registry.getFamily(MetricType::Gauge, name, help).CollectedSamples +=
+        fmt::format("{}{} {}\n", name, formatLabels(labels), formatValue(value));
+}
+#pragma endregion MetricsRegistry::Writer
+
+#pragma region MetricsRegistry
+std::shared_ptr<MetricCounter> MetricsRegistry::AddCounter(const std::string& name,
+    const std::string& help, MetricLabels labels)
+{
+    return addSeries<MetricCounter>(MetricType::Counter, name, help, std::move(labels));
+}
+
+std::shared_ptr<MetricGauge> MetricsRegistry::AddGauge(const std::string& name,
+    const std::string& help, MetricLabels labels)
+{
+    return addSeries<MetricGauge>(MetricType::Gauge, name, help, std::move(labels));
+}
+
+std::shared_ptr<MetricHistogram> MetricsRegistry::AddHistogram(const std::string& name,
+    const std::string& help, MetricLabels labels, std::vector<double> bucketBounds)
+{
+    return addSeries<MetricHistogram>(MetricType::Histogram, name, help, std::move(labels),
+        std::move(bucketBounds));
+}
+
+MetricsRegistry::CollectorId MetricsRegistry::AddCollector(Collector collector)
+{
+    std::scoped_lock lock(mutex);
+    const CollectorId collectorId = nextCollectorId++;
+    collectors.try_emplace(collectorId, std::move(collector));
+    return collectorId;
+}
+
+void MetricsRegistry::RemoveCollector(CollectorId collectorId)
+{
+    // Collectors are only called with this lock held, so once we have it none is running
+    std::scoped_lock lock(mutex);
+    collectors.erase(collectorId);
+}
+
+std::string MetricsRegistry::Render()
+{
+    std::scoped_lock lock(mutex);
+    Writer writer(*this);
+    for (auto& [collectorId, collector] : collectors)
+    {
+        collector(writer);
+    }
+
+    std::string output;
+    for (auto& [name, family] : families)
+    {
+        std::string samples = std::move(family.CollectedSamples);
+        family.CollectedSamples.clear();
+        std::erase_if(family.SeriesList,
+            [](const Series& series)
+            {
+                return series.Metric.expired();
+            });
+        for (const Series& series : family.SeriesList)
+        {
+            std::shared_ptr<void> metric = series.Metric.lock();
+            if (metric == nullptr)
+            {
+                continue;
+            }
+            switch (family.Type)
+            {
+            case MetricType::Counter:
+                samples += fmt::format("{}{} {}\n", name, formatLabels(series.Labels),
+                    std::static_pointer_cast<MetricCounter>(metric)->GetValue());
+                break;
+            case MetricType::Gauge:
+                samples += fmt::format("{}{} {}\n", name, formatLabels(series.Labels),
+                    formatValue(std::static_pointer_cast<MetricGauge>(metric)->GetValue()));
+                break;
+            case MetricType::Histogram:
+            {
+                const auto histogram = std::static_pointer_cast<MetricHistogram>(metric);
+                const std::vector<double>& bounds = histogram->GetBucketBounds();
+                const MetricHistogram::Snapshot snapshot = histogram->GetSnapshot();
+                // Prometheus buckets count everything at or below their bound
+                uint64_t cumulativeCount = 0;
+                for (size_t i = 0; i < snapshot.BucketCounts.size(); ++i)
+                {
+                    cumulativeCount += snapshot.BucketCounts[i];
+                    samples += fmt::format("{}_bucket{} {}\n", name,
+                        formatLabels(series.Labels, "le",
+                            (i < bounds.size()) ? formatValue(bounds[i]) : "+Inf"),
+                        cumulativeCount);
+                }
+                samples += fmt::format("{}_sum{} {}\n", name, formatLabels(series.Labels),
+                    formatValue(snapshot.Sum));
+                samples += fmt::format("{}_count{} {}\n", name, formatLabels(series.Labels),
+                    snapshot.Count);
+                break;
+            }
+            }
+        }
+
+        if (samples.empty())
+        {
+            continue;
+        }
+        output += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, family.Help, name,
+            typeName(family.Type));
+        output += samples;
+    }
+
+    // Forget metrics nobody is reporting anymore
+    std::erase_if(families,
+        [](const auto& familyPair)
+        {
+            return familyPair.second.SeriesList.empty();
+        });
+    return output;
+}
+#pragma endregion MetricsRegistry
+
+#pragma region Private methods
+template<typename TMetric, typename... TArgs>
+std::shared_ptr<TMetric> MetricsRegistry::addSeries(MetricType type, const std::string& name,
+    const std::string& help, MetricLabels labels, TArgs&&... metricArgs)
+{
+    std::scoped_lock lock(mutex);
+    Family& family = getFamily(type, name, help);
+    for (Series& series : family.SeriesList)
+    {
+        if (series.Labels != labels)
+        {
+            continue;
+        }
+        if (std::shared_ptr<void> existing = series.Metric.lock())
+        {
+            return std::static_pointer_cast<TMetric>(existing);
+        }
+        auto metric = std::make_shared<TMetric>(std::forward<TArgs>(metricArgs)...);
+        series.Metric = metric;
+        return metric;
+    }
+
+    auto metric = std::make_shared<TMetric>(std::forward<TArgs>(metricArgs)...);
+    family.SeriesList.push_back(Series { .Labels = std::move(labels), .Metric = metric });
+    return metric;
+}
+
+MetricsRegistry::Family& MetricsRegistry::getFamily(MetricType type, const std::string& name,
+    const std::string& help)
+{
+    auto [it, isInserted] = families.try_emplace(name, Family { .Help = help, .Type = type });
+    if (it->second.Type != type)
+    {
+        throw std::invalid_argument(fmt::format("Metric {} is a {}, not a {}", name,
+            typeName(it->second.Type), typeName(type)));
+    }
+    return it->second;
+}
+
+std::string MetricsRegistry::typeName(MetricType type)
+{
+    switch (type)
+    {
+    case MetricType::Counter:
+        return "counter";
+    case MetricType::Gauge:
+        return "gauge";
+    case MetricType::Histogram:
+    default:
+        return "histogram";
+    }
+}
+
+std::string MetricsRegistry::formatLabels(const MetricLabels& labels,
+    const std::string& extraName, const std::string& extraValue)
+{
+    if (labels.empty() && extraName.empty())
+    {
+        return "";
+    }
+
+    std::string formatted = "{";
+    auto appendLabel = [&formatted](const std::string& name, const std::string& value)
+    {
+        if (formatted.size() > 1)
+        {
+            formatted += ',';
+        }
+        formatted += name;
+        formatted += "=\"";
+        for (const char c : value)
+        {
+            switch (c)
+            {
+            case '\\':
+                formatted += "\\\\";
+                break;
+            case '"':
+                formatted += "\\\"";
+                break;
+            case '\n':
+                formatted += "\\n";
+                break;
+            default:
+                formatted += c;
+            }
+        }
+        formatted += '"';
+    };
+    for (const auto& [name, value] : labels)
+    {
+        appendLabel(name, value);
+    }
+    if (!extraName.empty())
+    {
+        appendLabel(extraName, extraValue);
+    }
+    formatted += '}';
+    return formatted;
+}
+
+std::string MetricsRegistry::formatValue(double value)
+{
+    if (std::isnan(value))
+    {
+        return "NaN";
+    }
+    if (std::isinf(value))
+    {
+        return (value > 0) ? "+Inf" : "-Inf";
+    }
+    return fmt::format("{}", value);
+}
+#pragma endregion Private methods
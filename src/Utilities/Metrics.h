@@ -0,0 +1,236 @@
+/**
+ * @file Metrics.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Label names and values that tell apart the series of a metric, e.g. { { "channel", "1" } }
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief A count that only ever goes up. Updating it never takes a lock.
+ */
+class MetricCounter
+{
+public:
+    /* Public methods */
+    void Increment(uint64_t amount = 1);
+
+    /* Getters/Setters */
+    uint64_t GetValue() const;
+
+private:
+    /* Private fields */
+    std::atomic<uint64_t> value { 0 };
+};
+
+/**
+ * @brief A value that can go up and down. Updating it never takes a lock.
+ */
+class MetricGauge
+{
+public:
+    /* Public methods */
+    void Add(double amount);
+
+    /* Getters/Setters */
+    void Set(double newValue);
+    double GetValue() const;
+
+private:
+    /* Private fields */
+    std::atomic<double> value { 0 };
+};
+
+/**
+ * @brief
+ *  Counts observed values into fixed buckets. Each thread observes into its own shard of the
+ *  buckets, so threads recording at packet rates don't fight over the same cache lines.
+ *  Observing a value never takes a lock.
+ */
+class MetricHistogram
+{
+public:
+    /* Public types */
+    struct Snapshot
+    {
+        // Number of observations in each bucket, plus one more for those above every bound
+        std::vector<uint64_t> BucketCounts;
+        double Sum = 0;
+        uint64_t Count = 0;
+    };
+
+    /* Constants */
+    // Threads beyond this many share shards
+    static constexpr size_t NUM_SHARDS = 16;
+
+    /* Constructor/Destructor */
+    /**
+     * @param bucketBounds upper bound of each bucket, in ascending order
+     */
+    MetricHistogram(std::vector<double> bucketBounds);
+
+    /* Public methods */
+    void Observe(double value);
+    /**
+     * @brief Observes a duration in seconds, the unit Prometheus expects
+     */
+    void ObserveDuration(std::chrono::nanoseconds duration);
+
+    /* Getters/Setters */
+    const std::vector<double>& GetBucketBounds() const;
+    Snapshot GetSnapshot() const;
+
+private:
+    /* Private types */
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t COUNTS_PER_LINE = CACHE_LINE_SIZE / sizeof(std::atomic<uint64_t>);
+
+    struct alignas(CACHE_LINE_SIZE) CountLine
+    {
+        std::atomic<uint64_t> Counts[COUNTS_PER_LINE] {};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ShardSum
+    {
+        std::atomic<double> Value { 0 };
+    };
+
+    /* Private fields */
+    const std::vector<double> bucketBounds;
+    // Cache lines of bucket counts that make up each shard
+    const size_t linesPerShard;
+    std::unique_ptr<CountLine[]> countLines;
+    std::unique_ptr<ShardSum[]> sums;
+
+    /* Private methods */
+    std::atomic<uint64_t>& bucketCount(size_t shard, size_t bucketIndex) const;
+};
+
+/**
+ * @brief
+ *  Hands out named metrics and renders every one of them in the Prometheus text format.
+ *  The registry only keeps weak references, so a series stops being reported once whoever
+ *  added it lets go of it. Values that are already kept somewhere else can be reported by a
+ *  collector instead, which is called each time the metrics are rendered. Thread-safe.
+ */
+class MetricsRegistry
+{
+public:
+    /* Public types */
+    using CollectorId = uint64_t;
+
+    /**
+     * @brief Receives the values reported by a collector
+     */
+    class Writer
+    {
+    public:
+        void Counter(const std::string& name, const std::string& help,
+            const MetricLabels& labels, uint64_t value);
+        void Gauge(const std::string& name, const std::string& help,
+            const MetricLabels& labels, double value);
+
+    private:
+        friend class MetricsRegistry;
+        Writer(MetricsRegistry& registry);
+        MetricsRegistry& registry;
+    };
+
+    using Collector = std::function<void(Writer&)>;
+
+    /* Constants */
+    // Upper bounds in seconds, from tens of microseconds for packet handling up to the seconds
+    // a slow service call can take
+    static inline const std::vector<double> DEFAULT_DURATION_BUCKETS
+    {
+        0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+        0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10,
+    };
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Adds a series to the named metric, or returns the existing one with the same labels.
+     *  Throws if the metric was already added as a different type.
+     */
+    std::shared_ptr<MetricCounter> AddCounter(const std::string& name, const std::string& help,
+        MetricLabels labels = {});
+    std::shared_ptr<MetricGauge> AddGauge(const std::string& name, const std::string& help,
+        MetricLabels labels = {});
+    std::shared_ptr<MetricHistogram> AddHistogram(const std::string& name,
+        const std::string& help, MetricLabels labels = {},
+        std::vector<double> bucketBounds = DEFAULT_DURATION_BUCKETS);
+    /**
+     * @brief
+     *  Adds a collector to be called each time metrics are rendered. Collectors are called
+     *  while the registry is locked, so they must not call back into it.
+     */
+    CollectorId AddCollector(Collector collector);
+    /**
+     * @brief Removes a collector. Once this returns, the collector is no longer being called.
+     */
+    void RemoveCollector(CollectorId collectorId);
+    /**
+     * @brief Renders every metric in the Prometheus text exposition format
+     */
+    std::string Render();
+
+private:
+    /* Private types */
+    enum class MetricType
+    {
+        Counter,
+        Gauge,
+        Histogram,
+    };
+
+    struct Series
+    {
+        MetricLabels Labels;
+        std::weak_ptr<void> Metric;
+    };
+
+    struct Family
+    {
+        std::string Help;
+        MetricType Type;
+        std::vector<Series> SeriesList;
+        // Samples written by collectors during the current render
+        std::string CollectedSamples;
+    };
+
+    /* Private fields */
+    std::mutex mutex;
+    // Ordered by name, so metrics always render in the same order
+    std::map<std::string, Family> families;
+    std::map<CollectorId, Collector> collectors;
+    CollectorId nextCollectorId = 1;
+
+    /* Private methods */
+    template<typename TMetric, typename... TArgs>
+    std::shared_ptr<TMetric> addSeries(MetricType type, const std::string& name,
+        const std::string& help, MetricLabels labels, TArgs&&... metricArgs);
+    /**
+     * @brief Returns the named family, adding it if needed. Called with mutex held.
+     */
+    Family& getFamily(MetricType type, const std::string& name, const std::string& help);
+    static std::string typeName(MetricType type);
+    static std::string formatLabels(const MetricLabels& labels,
+        const std::string& extraName = "", const std::string& extraValue = "");
+    static std::string formatValue(double value);
+};
@@ -0,0 +1,75 @@
+/**
+ * @file NodeLoadEstimator.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "NodeLoadEstimator.h"
+
+#include <algorithm>
+#include <sys/resource.h>
+#include <thread>
+
+#pragma region NodeLoadEstimator
+NodeLoadEstimator::NodeLoadEstimator(NodeCapacity capacity)
+:
+    capacity(capacity)
+{ }
+
+uint32_t NodeLoadEstimator::Estimate(const NodeLoad& load) const
+{
+    double utilization = load.CpuUtilization;
+    if (capacity.MaxViewers > 0)
+    {
+        utilization = std::max(utilization,
+            (static_cast<double>(load.ViewerCount) / capacity.MaxViewers));
+    }
+    if (capacity.MaxEgressBitsPerSecond > 0)
+    {
+        utilization = std::max(utilization,
+            (static_cast<double>(load.EgressBitsPerSecond) / capacity.MaxEgressBitsPerSecond));
+    }
+    if (capacity.MaxFanoutQueueDepth > 0)
+    {
+        utilization = std::max(utilization,
+            (static_cast<double>(load.FanoutQueueDepth) / capacity.MaxFanoutQueueDepth));
+    }
+    return static_cast<uint32_t>(std::clamp(utilization, 0.0, 1.0) * MAXIMUM_LOAD);
+}
+#pragma endregion NodeLoadEstimator
+
+#pragma region CpuUsageSampler
+CpuUsageSampler::CpuUsageSampler()
+:
+    numCores(std::max(1u, std::thread::hardware_concurrency())),
+    lastSampleTime(std::chrono::steady_clock::now()),
+    lastCpuTime(getProcessCpuTime())
+{ }
+
+double CpuUsageSampler::Sample()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const std::chrono::microseconds cpuTime = getProcessCpuTime();
+    const std::chrono::duration<double> elapsed = now - lastSampleTime;
+    const std::chrono::duration<double> cpuElapsed = cpuTime - lastCpuTime;
+    lastSampleTime = now;
+    lastCpuTime = cpuTime;
+    if (elapsed.count() <= 0)
+    {
+        return 0.0;
+    }
+    return std::clamp((cpuElapsed.count() / (elapsed.count() * numCores)), 0.0, 1.0);
+}
+
+std::chrono::microseconds CpuUsageSampler::getProcessCpuTime()
+{
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    const auto toMicroseconds = [](const timeval& time)
+        {
+            return std::chrono::seconds(time.tv_sec) + std::chrono::microseconds(time.tv_usec);
+        };
+    return toMicroseconds(usage.ru_utime) + toMicroseconds(usage.ru_stime);
+}
+#pragma endregion CpuUsageSampler
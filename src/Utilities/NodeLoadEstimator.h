@@ -0,0 +1,92 @@
+/**
+ * @file NodeLoadEstimator.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief How busy this node is at the moment
+ */
+struct NodeLoad
+{
+    uint32_t ViewerCount = 0;
+    uint32_t RelayCount = 0;
+    uint32_t StreamCount = 0;
+    // Media sent to viewers and relays
+    uint64_t EgressBitsPerSecond = 0;
+    // Share of all of the machine's cores used by this process, from 0 to 1
+    double CpuUtilization = 0.0;
+    // Packets waiting in the busiest viewer fanout worker's queue
+    size_t FanoutQueueDepth = 0;
+};
+
+/**
+ * @brief How much load this node can take, 0 for anything that isn't limited
+ */
+struct NodeCapacity
+{
+    uint32_t MaxViewers = 0;
+    uint64_t MaxEgressBitsPerSecond = 0;
+    size_t MaxFanoutQueueDepth = 0;
+};
+
+/**
+ * @brief
+ *  Boils a NodeLoad down to the single load figure the Orchestrator compares nodes by. The
+ *  node is as loaded as its most saturated resource, since that's the one that will give out
+ *  first.
+ */
+class NodeLoadEstimator
+{
+public:
+    /* Constants */
+    // Load reported for a node that is completely saturated
+    static constexpr uint32_t MAXIMUM_LOAD = 1000;
+
+    /* Constructor/Destructor */
+    NodeLoadEstimator(NodeCapacity capacity);
+
+    /* Public methods */
+    /**
+     * @brief Returns the load out of MAXIMUM_LOAD, capped at MAXIMUM_LOAD
+     */
+    uint32_t Estimate(const NodeLoad& load) const;
+
+private:
+    /* Private fields */
+    const NodeCapacity capacity;
+};
+
+/**
+ * @brief
+ *  Measures how much CPU time this process uses between samples, as a share of every core on
+ *  the machine. Not thread-safe.
+ */
+class CpuUsageSampler
+{
+public:
+    /* Constructor/Destructor */
+    CpuUsageSampler();
+
+    /* Public methods */
+    /**
+     * @brief Returns the CPU utilization since the last sample (or since we were created)
+     */
+    double Sample();
+
+private:
+    /* Private fields */
+    const unsigned int numCores;
+    std::chrono::steady_clock::time_point lastSampleTime;
+    std::chrono::microseconds lastCpuTime;
+
+    /* Private methods */
+    static std::chrono::microseconds getProcessCpuTime();
+};
@@ -0,0 +1,123 @@
+/**
+ * @file OverloadController.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "OverloadController.h"
+
+#include <algorithm>
+#include <cmath>
+
+#pragma region Constructor/Destructor
+OverloadController::OverloadController(Policy policy)
+:
+    policy(policy)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void OverloadController::RecordFanoutLatency(std::chrono::nanoseconds latency)
+{
+    // Only written when a new maximum is seen, so fanout threads rarely contend here
+    int64_t currentMax = maxFanoutLatencyNs.load(std::memory_order_relaxed);
+    while ((latency.count() > currentMax) &&
+        !maxFanoutLatencyNs.compare_exchange_weak(currentMax, latency.count(),
+            std::memory_order_relaxed))
+    { }
+}
+
+OverloadController::Level OverloadController::Sample(size_t fanoutQueueDepth,
+    Clock::time_point now)
+{
+    const std::chrono::nanoseconds maxFanoutLatency(
+        maxFanoutLatencyNs.exchange(0, std::memory_order_relaxed));
+    const bool isOverloaded =
+        ((policy.MaxFanoutQueueDepth > 0) && (fanoutQueueDepth >= policy.MaxFanoutQueueDepth)) ||
+        ((policy.MaxFanoutLatency.count() > 0) && (maxFanoutLatency >= policy.MaxFanoutLatency));
+
+    Level currentLevel = level.load(std::memory_order_relaxed);
+    if (isOverloaded)
+    {
+        healthySince.reset();
+        if (!overloadedSince.has_value())
+        {
+            overloadedSince = now;
+        }
+        if (((now - overloadedSince.value()) >= policy.SustainFor) &&
+            (currentLevel != Level::SheddingVideo))
+        {
+            currentLevel = static_cast<Level>(static_cast<uint8_t>(currentLevel) + 1);
+            // Each level gets its own chance to relieve the node before the next
+            overloadedSince = now;
+        }
+    }
+    else
+    {
+        overloadedSince.reset();
+        if (!healthySince.has_value())
+        {
+            healthySince = now;
+        }
+        if (((now - healthySince.value()) >= policy.RecoverAfter) &&
+            (currentLevel != Level::Normal))
+        {
+            currentLevel = static_cast<Level>(static_cast<uint8_t>(currentLevel) - 1);
+            healthySince = now;
+        }
+    }
+    level.store(currentLevel, std::memory_order_relaxed);
+    return currentLevel;
+}
+
+void OverloadController::RecordRejectedViewer()
+{
+    rejectedViewers.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OverloadController::RecordShedVideoPackets(uint64_t count)
+{
+    shedVideoPackets.fetch_add(count, std::memory_order_relaxed);
+}
+
+size_t OverloadController::GetShedViewerCount(size_t viewerCount) const
+{
+    // Rounded up, so even a stream with a single viewer gives something back
+    const double shedViewers =
+        std::ceil(viewerCount * std::clamp(policy.ShedViewerFraction, 0.0, 1.0));
+    return std::min(static_cast<size_t>(shedViewers), viewerCount);
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+OverloadController::Level OverloadController::GetLevel() const
+{
+    return level.load(std::memory_order_relaxed);
+}
+
+bool OverloadController::IsAcceptingViewers() const
+{
+    return (GetLevel() == Level::Normal);
+}
+
+bool OverloadController::IsSheddingVideo() const
+{
+    return (GetLevel() == Level::SheddingVideo);
+}
+
+std::chrono::milliseconds OverloadController::GetRecoverAfter() const
+{
+    return policy.RecoverAfter;
+}
+
+uint64_t OverloadController::GetRejectedViewerCount() const
+{
+    return rejectedViewers.load(std::memory_order_relaxed);
+}
+
+uint64_t OverloadController::GetShedVideoPacketCount() const
+{
+    return shedVideoPackets.load(std::memory_order_relaxed);
+}
+#pragma endregion Getters/Setters
@@ -0,0 +1,93 @@
+/**
+ * @file OverloadController.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief
+ *  Decides how a node sheds load when viewer fanout can't keep up, so the node degrades
+ *  gracefully rather than letting every viewer and ingest fall behind with it. Fed periodic
+ *  samples of the busiest fanout queue, and the slowest fanout of a packet since the last
+ *  sample, it steps up a level each time overload lasts long enough: first rejecting new
+ *  viewers, then dropping non-keyframe video for the newest viewers too. It steps back down
+ *  a level at a time once the node has been healthy for long enough.
+ *  Levels and counters can be read from any thread, but only one thread should sample.
+ */
+class OverloadController
+{
+public:
+    /* Public types */
+    using Clock = std::chrono::steady_clock;
+
+    enum class Level : uint8_t
+    {
+        Normal = 0,
+        RejectingViewers = 1,
+        SheddingVideo = 2,
+    };
+
+    struct Policy
+    {
+        // Busiest fanout queue depth that counts as overloaded, or 0 to ignore queue depth
+        size_t MaxFanoutQueueDepth = 0;
+        // Slowest fanout of a packet that counts as overloaded, or 0 to ignore fanout time
+        std::chrono::milliseconds MaxFanoutLatency { 0 };
+        // How long overload has to last before stepping up a level
+        std::chrono::milliseconds SustainFor { 2000 };
+        // How long the node has to be healthy before stepping back down a level
+        std::chrono::milliseconds RecoverAfter { 10000 };
+        // Share of each stream's newest viewers whose non-keyframe video is dropped
+        double ShedViewerFraction = 0.5;
+    };
+
+    /* Constructor/Destructor */
+    OverloadController(Policy policy);
+
+    /* Public methods */
+    /**
+     * @brief Notes how long a packet took to fan out, cheap enough to call for every packet
+     */
+    void RecordFanoutLatency(std::chrono::nanoseconds latency);
+    /**
+     * @brief
+     *  Takes a sample of the node's fanout, along with the slowest fanout recorded since the
+     *  last sample, and moves between levels if it's time to
+     * @return the level the node is now at
+     */
+    Level Sample(size_t fanoutQueueDepth, Clock::time_point now);
+    void RecordRejectedViewer();
+    void RecordShedVideoPackets(uint64_t count);
+    /**
+     * @brief How many of the given number of viewers get their non-keyframe video dropped
+     */
+    size_t GetShedViewerCount(size_t viewerCount) const;
+
+    /* Getters/Setters */
+    Level GetLevel() const;
+    bool IsAcceptingViewers() const;
+    bool IsSheddingVideo() const;
+    std::chrono::milliseconds GetRecoverAfter() const;
+    uint64_t GetRejectedViewerCount() const;
+    uint64_t GetShedVideoPacketCount() const;
+
+private:
+    /* Private fields */
+    const Policy policy;
+    std::atomic<Level> level { Level::Normal };
+    std::atomic<int64_t> maxFanoutLatencyNs { 0 };
+    std::atomic<uint64_t> rejectedViewers { 0 };
+    std::atomic<uint64_t> shedVideoPackets { 0 };
+    // Only touched by the sampling thread
+    std::optional<Clock::time_point> overloadedSince;
+    std::optional<Clock::time_point> healthySince;
+};
@@ -0,0 +1,394 @@
+/**
+ * @file PacketBuffer.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "PacketBuffer.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+    // Set once this thread's pool caches have started being destroyed, so buffers released
+    // by later thread-local destructors go straight back to their pool
+    thread_local bool threadCachesDestroyed = false;
+
+    // Block headers are padded so the buffer data that follows them is suitably aligned
+    constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+    constexpr size_t alignedSize(size_t size)
+    {
+        return ((size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT) * BLOCK_ALIGNMENT;
+    }
+}
+
+#pragma region PacketBuffer
+PacketBuffer PacketBuffer::Copy(std::span<const std::byte> bytes)
+{
+    PacketBuffer buffer;
+    if (PacketBufferPool* pool = PacketBufferPool::ForSize(bytes.size()))
+    {
+        buffer = pool->Acquire();
+    }
+    else
+    {
+        // Too big for any pool, give it an allocation of its own
+        PacketBufferPool::unpooledBuffers.fetch_add(1, std::memory_order_relaxed);
+        auto storage = new std::byte[alignedSize(sizeof(Block)) + bytes.size()];
+        Block* block = new (storage) Block();
+        block->Capacity = bytes.size();
+        buffer = PacketBuffer(block);
+    }
+    std::copy(bytes.begin(), bytes.end(), buffer.Data());
+    buffer.Resize(bytes.size());
+    return buffer;
+}
+
+PacketBuffer::PacketBuffer(Block* block) : block(block)
+{ }
+
+PacketBuffer::PacketBuffer(const PacketBuffer& other) : block(other.block)
+{
+    if (block != nullptr)
+    {
+        block->RefCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PacketBuffer::PacketBuffer(PacketBuffer&& other) noexcept : block(other.block)
+{
+    other.block = nullptr;
+}
+
+PacketBuffer& PacketBuffer::operator=(const PacketBuffer& other)
+{
+    if (this != &other)
+    {
+        PacketBuffer copy(other);
+        std::swap(block, copy.block);
+    }
+    return *this;
+}
+
+PacketBuffer& PacketBuffer::operator=(PacketBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        Reset();
+        block = other.block;
+        other.block = nullptr;
+    }
+    return *this;
+}
+
+PacketBuffer::~PacketBuffer()
+{
+    Reset();
+}
+
+void PacketBuffer::Resize(size_t size)
+{
+    if ((block == nullptr) || (size > block->Capacity))
+    {
+        throw std::out_of_range("PacketBuffer cannot be resized beyond its capacity");
+    }
+    block->Size = size;
+}
+
+void PacketBuffer::Reset()
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+
+    if (block->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (block->Pool != nullptr)
+        {
+            block->Pool->release(block);
+        }
+        else
+        {
+            block->~Block();
+            delete[] reinterpret_cast<std::byte*>(block);
+        }
+    }
+    block = nullptr;
+}
+
+std::span<const std::byte> PacketBuffer::Bytes() const
+{
+    if (block == nullptr)
+    {
+        return std::span<const std::byte>();
+    }
+    return std::span<const std::byte>(blockData(block), block->Size);
+}
+
+std::byte* PacketBuffer::Data()
+{
+    return (block == nullptr) ? nullptr : blockData(block);
+}
+
+const std::byte* PacketBuffer::Data() const
+{
+    return (block == nullptr) ? nullptr : blockData(block);
+}
+
+size_t PacketBuffer::Size() const
+{
+    return (block == nullptr) ? 0 : block->Size;
+}
+
+size_t PacketBuffer::Capacity() const
+{
+    return (block == nullptr) ? 0 : block->Capacity;
+}
+
+bool PacketBuffer::Empty() const
+{
+    return (Size() == 0);
+}
+
+bool PacketBuffer::IsUnique() const
+{
+    return (block != nullptr) && (block->RefCount.load(std::memory_order_acquire) == 1);
+}
+
+std::chrono::steady_clock::time_point PacketBuffer::GetReceiveTime() const
+{
+    return (block == nullptr) ? std::chrono::steady_clock::time_point() : block->ReceiveTime;
+}
+
+void PacketBuffer::SetReceiveTime(std::chrono::steady_clock::time_point receiveTime)
+{
+    if (block != nullptr)
+    {
+        block->ReceiveTime = receiveTime;
+    }
+}
+
+PacketBuffer::operator bool() const
+{
+    return (block != nullptr);
+}
+
+PacketBuffer::operator std::span<const std::byte>() const
+{
+    return Bytes();
+}
+
+std::byte* PacketBuffer::blockData(Block* block)
+{
+    return reinterpret_cast<std::byte*>(block) + alignedSize(sizeof(Block));
+}
+#pragma endregion PacketBuffer
+
+#pragma region PacketBufferPool
+PacketBufferPool& PacketBufferPool::Default()
+{
+    return *sizeClasses().front();
+}
+
+PacketBufferPool* PacketBufferPool::ForSize(size_t size)
+{
+    for (PacketBufferPool* pool : sizeClasses())
+    {
+        if (size <= pool->GetBufferCapacity())
+        {
+            return pool;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<PacketBufferPool::Stats> PacketBufferPool::GetSizeClassStats()
+{
+    std::vector<Stats> stats;
+    stats.reserve(NUM_SIZE_CLASSES);
+    for (PacketBufferPool* pool : sizeClasses())
+    {
+        stats.push_back(pool->GetStats());
+    }
+    return stats;
+}
+
+uint64_t PacketBufferPool::GetUnpooledBufferCount()
+{
+    return unpooledBuffers.load(std::memory_order_relaxed);
+}
+
+PacketBufferPool::PacketBufferPool(size_t bufferCapacity, size_t buffersPerSlab)
+:
+    PacketBufferPool(bufferCapacity, buffersPerSlab, std::nullopt)
+{ }
+
+PacketBufferPool::PacketBufferPool(size_t bufferCapacity, size_t buffersPerSlab,
+    std::optional<size_t> sizeClass)
+:
+    bufferCapacity(bufferCapacity),
+    buffersPerSlab(std::max<size_t>(buffersPerSlab, 1)),
+    sizeClass(sizeClass),
+    threadCacheBuffers(sizeClass.has_value() ?
+        std::max<size_t>((THREAD_CACHE_BYTES / std::max<size_t>(bufferCapacity, 1)), 1) : 0)
+{ }
+
+PacketBuffer PacketBufferPool::Acquire()
+{
+    acquiredBuffers.fetch_add(1, std::memory_order_relaxed);
+    PacketBuffer::Block* block = nullptr;
+    if (ThreadCache* cache = threadCache())
+    {
+        if (cache->Blocks.empty())
+        {
+            // Take half a cache's worth at once, leaving room for buffers released here
+            std::scoped_lock lock(mutex);
+            block = takeFreeBlock(&cache->Blocks, (threadCacheBuffers / 2));
+        }
+        else
+        {
+            block = cache->Blocks.back();
+            cache->Blocks.pop_back();
+        }
+    }
+    else
+    {
+        std::scoped_lock lock(mutex);
+        block = takeFreeBlock();
+    }
+    block->RefCount.store(1, std::memory_order_relaxed);
+    block->Size = 0;
+    block->ReceiveTime = std::chrono::steady_clock::time_point();
+    return PacketBuffer(block);
+}
+
+size_t PacketBufferPool::GetBufferCapacity() const
+{
+    return bufferCapacity;
+}
+
+PacketBufferPool::Stats PacketBufferPool::GetStats()
+{
+    std::scoped_lock lock(mutex);
+    // Released before acquired, so a buffer racing through both is never counted negative
+    const uint64_t released = releasedBuffers.load(std::memory_order_relaxed);
+    const uint64_t acquired = acquiredBuffers.load(std::memory_order_relaxed);
+    return Stats
+    {
+        .BufferCapacity = bufferCapacity,
+        .Hits = (acquired - std::min(misses, acquired)),
+        .Misses = misses,
+        .AllocatedBuffers = (slabs.size() * buffersPerSlab),
+        .BuffersInUse = (acquired - std::min(released, acquired)),
+        .PeakBuffersInUse = peakBuffersInUse,
+    };
+}
+
+PacketBufferPool::ThreadCache::~ThreadCache()
+{
+    threadCachesDestroyed = true;
+    if ((Pool != nullptr) && !Blocks.empty())
+    {
+        std::scoped_lock lock(Pool->mutex);
+        Pool->freeBlocks.insert(Pool->freeBlocks.end(), Blocks.begin(), Blocks.end());
+    }
+}
+
+const std::array<PacketBufferPool*, PacketBufferPool::NUM_SIZE_CLASSES>&
+    PacketBufferPool::sizeClasses()
+{
+    // Intentionally leaked, since buffers may still be released by other threads during
+    // static destruction.
+    static const std::array<PacketBufferPool*, NUM_SIZE_CLASSES> pools
+    {
+        new PacketBufferPool(DEFAULT_BUFFER_CAPACITY, DEFAULT_BUFFERS_PER_SLAB, 0),
+        new PacketBufferPool(LARGE_BUFFER_CAPACITY, LARGE_BUFFERS_PER_SLAB, 1),
+    };
+    return pools;
+}
+
+PacketBufferPool::ThreadCache* PacketBufferPool::threadCache()
+{
+    if (!sizeClass.has_value() || threadCachesDestroyed)
+    {
+        return nullptr;
+    }
+    thread_local std::array<ThreadCache, NUM_SIZE_CLASSES> threadCaches;
+    ThreadCache& cache = threadCaches[sizeClass.value()];
+    if (cache.Pool == nullptr)
+    {
+        cache.Pool = this;
+        cache.Blocks.reserve(threadCacheBuffers + 1);
+    }
+    return &cache;
+}
+
+size_t PacketBufferPool::blockStride() const
+{
+    return alignedSize(sizeof(PacketBuffer::Block)) + alignedSize(bufferCapacity);
+}
+
+PacketBuffer::Block* PacketBufferPool::takeFreeBlock(
+    std::vector<PacketBuffer::Block*>* refill, size_t refillCount)
+{
+    if (freeBlocks.empty())
+    {
+        allocateSlab();
+        ++misses;
+    }
+    PacketBuffer::Block* block = freeBlocks.back();
+    freeBlocks.pop_back();
+    if (refill != nullptr)
+    {
+        const size_t count = std::min(refillCount, freeBlocks.size());
+        refill->insert(refill->end(), (freeBlocks.end() - count), freeBlocks.end());
+        freeBlocks.resize(freeBlocks.size() - count);
+    }
+
+    const uint64_t released = releasedBuffers.load(std::memory_order_relaxed);
+    const uint64_t acquired = acquiredBuffers.load(std::memory_order_relaxed);
+    peakBuffersInUse = std::max(peakBuffersInUse, (acquired - std::min(released, acquired)));
+    return block;
+}
+
+void PacketBufferPool::allocateSlab()
+{
+    const size_t stride = blockStride();
+    auto slab = std::make_unique<std::byte[]>(stride * buffersPerSlab);
+    freeBlocks.reserve(freeBlocks.size() + buffersPerSlab);
+    for (size_t i = 0; i < buffersPerSlab; ++i)
+    {
+        auto block = new (slab.get() + (i * stride)) PacketBuffer::Block();
+        block->Capacity = bufferCapacity;
+        block->Pool = this;
+        freeBlocks.push_back(block);
+    }
+    slabs.push_back(std::move(slab));
+}
+
+void PacketBufferPool::release(PacketBuffer::Block* block)
+{
+    releasedBuffers.fetch_add(1, std::memory_order_relaxed);
+    if (ThreadCache* cache = threadCache())
+    {
+        cache->Blocks.push_back(block);
+        if (cache->Blocks.size() > threadCacheBuffers)
+        {
+            // Spill half back so buffers released by one thread and acquired by another
+            // don't pile up here
+            const size_t count = (cache->Blocks.size() / 2);
+            std::scoped_lock lock(mutex);
+            freeBlocks.insert(freeBlocks.end(), (cache->Blocks.end() - count),
+                cache->Blocks.end());
+            cache->Blocks.resize(cache->Blocks.size() - count);
+        }
+        return;
+    }
+    std::scoped_lock lock(mutex);
+    freeBlocks.push_back(block);
+}
+#pragma endregion PacketBufferPool
@@ -0,0 +1,225 @@
+/**
+ * @file PacketBuffer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+class PacketBufferPool;
+
+/**
+ * @brief
+ *  A reference-counted handle to a fixed-capacity byte buffer, usually allocated from a
+ *  PacketBufferPool. Copying a PacketBuffer shares the underlying bytes rather than copying
+ *  them, so a single received packet can be handed to many consumers without copies.
+ *  The contents of a buffer should not be modified once it has been shared.
+ */
+class PacketBuffer
+{
+public:
+    /* Static methods */
+    /**
+     * @brief Allocates a buffer from the default pool holding a copy of the given bytes
+     */
+    static PacketBuffer Copy(std::span<const std::byte> bytes);
+
+    /* Constructor/Destructor */
+    PacketBuffer() = default;
+    PacketBuffer(const PacketBuffer& other);
+    PacketBuffer(PacketBuffer&& other) noexcept;
+    PacketBuffer& operator=(const PacketBuffer& other);
+    PacketBuffer& operator=(PacketBuffer&& other) noexcept;
+    ~PacketBuffer();
+
+    /* Public methods */
+    /**
+     * @brief Sets the number of valid bytes in the buffer, up to its capacity
+     */
+    void Resize(size_t size);
+    /**
+     * @brief Releases this handle's reference to the underlying buffer
+     */
+    void Reset();
+
+    /* Getters/Setters */
+    std::span<const std::byte> Bytes() const;
+    std::byte* Data();
+    const std::byte* Data() const;
+    size_t Size() const;
+    size_t Capacity() const;
+    bool Empty() const;
+    /**
+     * @brief Whether this is the only handle referencing the underlying buffer
+     */
+    bool IsUnique() const;
+    /**
+     * @brief
+     *  When the packet was read off of the network, if whoever read it recorded that. Like the
+     *  contents, this should only be set before the buffer is shared.
+     */
+    std::chrono::steady_clock::time_point GetReceiveTime() const;
+    void SetReceiveTime(std::chrono::steady_clock::time_point receiveTime);
+    explicit operator bool() const;
+    operator std::span<const std::byte>() const;
+
+private:
+    friend class PacketBufferPool;
+
+    /* Private types */
+    struct Block
+    {
+        std::atomic<uint32_t> RefCount { 1 };
+        uint32_t Size = 0;
+        uint32_t Capacity = 0;
+        // Left at the clock's epoch unless the reader sets it
+        std::chrono::steady_clock::time_point ReceiveTime;
+        // Pool to return this block to, or null if it was allocated on its own
+        PacketBufferPool* Pool = nullptr;
+    };
+
+    /* Private fields */
+    Block* block = nullptr;
+
+    /* Private methods */
+    explicit PacketBuffer(Block* block);
+    static std::byte* blockData(Block* block);
+};
+
+/**
+ * @brief
+ *  A thread-safe pool of fixed-capacity PacketBuffers, carved out of large slab allocations
+ *  so acquiring a buffer does not touch the heap once the pool has warmed up.
+ *  The process-wide pools come in a couple of size classes, and keep a small cache of free
+ *  buffers on each thread that uses them, so threads acquiring and releasing buffers at once
+ *  rarely contend on the pool's lock.
+ *  A pool must outlive every buffer acquired from it.
+ */
+class PacketBufferPool
+{
+public:
+    /* Public types */
+    struct Stats
+    {
+        size_t BufferCapacity = 0;
+        // Buffers acquired without allocating anything
+        uint64_t Hits = 0;
+        // Buffers acquired that needed another slab to be allocated first
+        uint64_t Misses = 0;
+        // Buffers in every slab allocated, which are never freed
+        uint64_t AllocatedBuffers = 0;
+        uint64_t BuffersInUse = 0;
+        // Most buffers in use at once, sampled whenever buffers are taken from the shared free
+        // list, so can lag by a thread cache's worth
+        uint64_t PeakBuffersInUse = 0;
+    };
+
+    /* Constants */
+    // Large enough to hold any datagram we expect to see on the media path
+    static constexpr size_t DEFAULT_BUFFER_CAPACITY = 2048;
+    static constexpr size_t DEFAULT_BUFFERS_PER_SLAB = 256;
+    // For the occasional jumbo datagram or stream read
+    static constexpr size_t LARGE_BUFFER_CAPACITY = 16384;
+    static constexpr size_t LARGE_BUFFERS_PER_SLAB = 32;
+    // Most bytes of free buffers each thread holds on to for each process-wide pool
+    static constexpr size_t THREAD_CACHE_BYTES = 128 * 1024;
+
+    /* Static methods */
+    /**
+     * @brief The process-wide pool used by the media path
+     */
+    static PacketBufferPool& Default();
+    /**
+     * @brief The process-wide pool with the smallest buffers that fit size, or null if none do
+     */
+    static PacketBufferPool* ForSize(size_t size);
+    /**
+     * @brief Stats of every process-wide pool, smallest buffers first
+     */
+    static std::vector<Stats> GetSizeClassStats();
+    /**
+     * @brief Buffers copied that were too big for any pool, so were allocated on their own
+     */
+    static uint64_t GetUnpooledBufferCount();
+
+    /* Constructor/Destructor */
+    PacketBufferPool(
+        size_t bufferCapacity = DEFAULT_BUFFER_CAPACITY,
+        size_t buffersPerSlab = DEFAULT_BUFFERS_PER_SLAB);
+
+    /* Public methods */
+    /**
+     * @brief Acquires an empty buffer from the pool
+     */
+    PacketBuffer Acquire();
+
+    /* Getters/Setters */
+    size_t GetBufferCapacity() const;
+    Stats GetStats();
+
+private:
+    friend class PacketBuffer;
+
+    /* Private types */
+    struct ThreadCache
+    {
+        PacketBufferPool* Pool = nullptr;
+        std::vector<PacketBuffer::Block*> Blocks;
+
+        // Hands the thread's buffers back when it exits
+        ~ThreadCache();
+    };
+
+    /* Private constants */
+    static constexpr size_t NUM_SIZE_CLASSES = 2;
+
+    /* Private fields */
+    const size_t bufferCapacity;
+    const size_t buffersPerSlab;
+    // Index of the process-wide pool's thread caches, or empty if buffers aren't cached, since
+    // only pools that are never destroyed can safely be cached by threads
+    const std::optional<size_t> sizeClass;
+    const size_t threadCacheBuffers;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<std::byte[]>> slabs;
+    std::vector<PacketBuffer::Block*> freeBlocks;
+    std::atomic<uint64_t> acquiredBuffers { 0 };
+    std::atomic<uint64_t> releasedBuffers { 0 };
+    // Guarded by mutex
+    uint64_t misses = 0;
+    uint64_t peakBuffersInUse = 0;
+    inline static std::atomic<uint64_t> unpooledBuffers { 0 };
+
+    /* Constructor/Destructor */
+    PacketBufferPool(size_t bufferCapacity, size_t buffersPerSlab,
+        std::optional<size_t> sizeClass);
+
+    /* Private methods */
+    static const std::array<PacketBufferPool*, NUM_SIZE_CLASSES>& sizeClasses();
+    /**
+     * @brief This thread's cache of the pool's buffers, or null if the pool isn't cached
+     */
+    ThreadCache* threadCache();
+    size_t blockStride() const;
+    /**
+     * @brief
+     *  Takes a free block, allocating another slab if there are none, and moves up to
+     *  refillCount more into refill. Must be called with mutex held.
+     */
+    PacketBuffer::Block* takeFreeBlock(
+        std::vector<PacketBuffer::Block*>* refill = nullptr, size_t refillCount = 0);
+    void allocateSlab();
+    void release(PacketBuffer::Block* block);
+};
@@ -0,0 +1,31 @@
+/**
+ * @file PacketLatencyTracer.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "PacketLatencyTracer.h"
+
+#include <string>
+
+#pragma region Constructor/Destructor
+PacketLatencyTracer::PacketLatencyTracer(const std::shared_ptr<MetricsRegistry>& metrics,
+    ftl_channel_id_t channelId)
+{
+    const std::array<std::string, NUM_STAGES> stageNames
+    {
+        "sequenced",
+        "fanout_queued",
+        "viewer_send",
+        "relay_send",
+    };
+    for (size_t i = 0; i < NUM_STAGES; ++i)
+    {
+        stageLatencies[i] = metrics->AddHistogram("ftl_packet_latency_seconds",
+            "Time since a packet was received, as of each stage of the packet path",
+            { { "channel", std::to_string(channelId) }, { "stage", stageNames[i] } },
+            LATENCY_BUCKETS);
+    }
+}
+#pragma endregion Constructor/Destructor
@@ -0,0 +1,98 @@
+/**
+ * @file PacketLatencyTracer.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "FtlTypes.h"
+#include "Metrics.h"
+#include "PacketBuffer.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+
+/**
+ * @brief
+ *  Records how long packets have been inside the plugin by the time they reach each stage of
+ *  the packet path, measured from when they were read off of the network. Every tracer for the
+ *  same channel records into the same per-stream histograms.
+ *  Tracing is compiled out entirely unless FTL_PACKET_LATENCY_TRACING is defined.
+ */
+class PacketLatencyTracer
+{
+public:
+    /* Public types */
+    enum class Stage
+    {
+        // Sequence numbers have been tracked and any losses NACKed
+        Sequenced = 0,
+        // Handed to the stream to fan out to viewers and relays
+        FanoutQueued,
+        // About to be handed to Janus for a shard of viewers
+        ViewerSend,
+        // About to be queued for the stream's relays
+        RelaySend,
+    };
+
+    /* Constants */
+#ifdef FTL_PACKET_LATENCY_TRACING
+    static constexpr bool IS_ENABLED = true;
+#else
+    static constexpr bool IS_ENABLED = false;
+#endif
+    static constexpr size_t NUM_STAGES = 4;
+    // Upper bounds in seconds. Packets normally spend microseconds inside the plugin, so the
+    // buckets are finer than the default ones.
+    static inline const std::vector<double> LATENCY_BUCKETS
+    {
+        0.000001, 0.0000025, 0.000005, 0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005,
+        0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+    };
+
+    /* Static methods */
+    /**
+     * @brief Marks packets that were just read off of the network with the current time
+     */
+    static void StampReceived(std::span<PacketBuffer> packets)
+    {
+        if constexpr (IS_ENABLED)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            for (PacketBuffer& packet : packets)
+            {
+                packet.SetReceiveTime(now);
+            }
+        }
+    }
+
+    /* Constructor/Destructor */
+    PacketLatencyTracer(const std::shared_ptr<MetricsRegistry>& metrics,
+        ftl_channel_id_t channelId);
+
+    /* Public methods */
+    /**
+     * @brief Records how long ago the packet was received, if it was stamped when it was
+     */
+    void Record(Stage stage, const PacketBuffer& packet)
+    {
+        if constexpr (IS_ENABLED)
+        {
+            const auto receiveTime = packet.GetReceiveTime();
+            if (receiveTime != std::chrono::steady_clock::time_point())
+            {
+                stageLatencies[static_cast<size_t>(stage)]->ObserveDuration(
+                    std::chrono::steady_clock::now() - receiveTime);
+            }
+        }
+    }
+
+private:
+    /* Private fields */
+    std::array<std::shared_ptr<MetricHistogram>, NUM_STAGES> stageLatencies;
+};
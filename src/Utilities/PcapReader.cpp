@@ -0,0 +1,255 @@
+/**
+ * @file PcapReader.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "PcapReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t PCAPNG_MAGIC = 0x0A0D0D0A;
+    constexpr uint16_t ETHER_TYPE_IPV4 = 0x0800;
+    constexpr uint16_t ETHER_TYPE_IPV6 = 0x86DD;
+    constexpr uint16_t ETHER_TYPE_VLAN = 0x8100;
+    constexpr uint16_t ETHER_TYPE_QINQ = 0x88A8;
+    constexpr size_t ETHERNET_HEADER_SIZE = 14;
+    constexpr size_t VLAN_TAG_SIZE = 4;
+    constexpr size_t NULL_HEADER_SIZE = 4;
+    constexpr size_t LINUX_SLL_HEADER_SIZE = 16;
+    constexpr size_t LINUX_SLL2_HEADER_SIZE = 20;
+    constexpr size_t IPV4_MIN_HEADER_SIZE = 20;
+    constexpr size_t IPV6_HEADER_SIZE = 40;
+    constexpr size_t UDP_HEADER_SIZE = 8;
+    constexpr uint8_t IP_PROTOCOL_UDP = 17;
+
+    // Network byte order
+    uint16_t readUint16(std::span<const std::byte> bytes, size_t offset)
+    {
+        return (static_cast<uint16_t>(bytes[offset]) << 8) |
+            static_cast<uint16_t>(bytes[offset + 1]);
+    }
+}
+
+#pragma region Constructor/Destructor
+PcapReader::PcapReader(std::istream& input) : input(input)
+{
+    std::byte header[GLOBAL_HEADER_SIZE];
+    input.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (input.gcount() < static_cast<std::streamsize>(sizeof(header)))
+    {
+        throw std::runtime_error("Capture is too short to have a pcap header");
+    }
+
+    uint32_t magic;
+    std::memcpy(&magic, header, sizeof(magic));
+    if ((magic == MAGIC_MICROSECONDS) || (magic == MAGIC_NANOSECONDS))
+    {
+        isByteSwapped = false;
+    }
+    else if ((__builtin_bswap32(magic) == MAGIC_MICROSECONDS) ||
+        (__builtin_bswap32(magic) == MAGIC_NANOSECONDS))
+    {
+        isByteSwapped = true;
+        magic = __builtin_bswap32(magic);
+    }
+    else if (magic == PCAPNG_MAGIC)
+    {
+        throw std::runtime_error("pcapng captures aren't supported, save the capture as pcap");
+    }
+    else
+    {
+        throw std::runtime_error("Not a pcap capture");
+    }
+    hasNanosecondTimestamps = (magic == MAGIC_NANOSECONDS);
+
+    linkType = readUint32(header + 20);
+    switch (linkType)
+    {
+    case LINK_TYPE_NULL:
+    case LINK_TYPE_ETHERNET:
+    case LINK_TYPE_RAW:
+    case LINK_TYPE_LINUX_SLL:
+    case LINK_TYPE_IPV4:
+    case LINK_TYPE_IPV6:
+    case LINK_TYPE_LINUX_SLL2:
+        break;
+    default:
+        throw std::runtime_error(fmt::format("Unsupported pcap link type {}", linkType));
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+std::optional<PcapReader::UdpDatagram> PcapReader::ReadNextUdpDatagram()
+{
+    while (true)
+    {
+        std::byte recordHeader[RECORD_HEADER_SIZE];
+        input.read(reinterpret_cast<char*>(recordHeader), sizeof(recordHeader));
+        if (input.gcount() < static_cast<std::streamsize>(sizeof(recordHeader)))
+        {
+            return std::nullopt;
+        }
+        const uint32_t timestampSeconds = readUint32(recordHeader);
+        const uint32_t timestampFraction = readUint32(recordHeader + 4);
+        const uint32_t capturedLength = readUint32(recordHeader + 8);
+        if (capturedLength > MAX_FRAME_SIZE)
+        {
+            spdlog::warn("pcap frame claims to be {} bytes, treating the rest of the capture "
+                "as corrupt", capturedLength);
+            return std::nullopt;
+        }
+
+        frame.resize(capturedLength);
+        input.read(reinterpret_cast<char*>(frame.data()), capturedLength);
+        if (input.gcount() < static_cast<std::streamsize>(capturedLength))
+        {
+            return std::nullopt;
+        }
+
+        std::optional<UdpDatagram> datagram = parseFrame(frame);
+        if (!datagram.has_value())
+        {
+            ++skippedFrameCount;
+            continue;
+        }
+        datagram->Timestamp = std::chrono::seconds(timestampSeconds) +
+            (hasNanosecondTimestamps ?
+                std::chrono::nanoseconds(timestampFraction) :
+                std::chrono::microseconds(timestampFraction));
+        return datagram;
+    }
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+uint32_t PcapReader::GetLinkType() const
+{
+    return linkType;
+}
+
+uint64_t PcapReader::GetSkippedFrameCount() const
+{
+    return skippedFrameCount;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+uint32_t PcapReader::readUint32(const std::byte* bytes) const
+{
+    // Record headers are in the byte order of whoever wrote the capture
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return isByteSwapped ? __builtin_bswap32(value) : value;
+}
+
+std::optional<PcapReader::UdpDatagram> PcapReader::parseFrame(
+    std::span<const std::byte> frameBytes) const
+{
+    // Find where the IP packet starts, it tells us its own version
+    size_t ipOffset = 0;
+    switch (linkType)
+    {
+    case LINK_TYPE_NULL:
+        ipOffset = NULL_HEADER_SIZE;
+        break;
+    case LINK_TYPE_ETHERNET:
+    {
+        size_t etherTypeOffset = (ETHERNET_HEADER_SIZE - 2);
+        while (((etherTypeOffset + 2) <= frameBytes.size()) &&
+            ((readUint16(frameBytes, etherTypeOffset) == ETHER_TYPE_VLAN) ||
+                (readUint16(frameBytes, etherTypeOffset) == ETHER_TYPE_QINQ)))
+        {
+            etherTypeOffset += VLAN_TAG_SIZE;
+        }
+        if (((etherTypeOffset + 2) > frameBytes.size()) ||
+            ((readUint16(frameBytes, etherTypeOffset) != ETHER_TYPE_IPV4) &&
+                (readUint16(frameBytes, etherTypeOffset) != ETHER_TYPE_IPV6)))
+        {
+            return std::nullopt;
+        }
+        ipOffset = etherTypeOffset + 2;
+        break;
+    }
+    case LINK_TYPE_LINUX_SLL:
+        ipOffset = LINUX_SLL_HEADER_SIZE;
+        break;
+    case LINK_TYPE_LINUX_SLL2:
+        ipOffset = LINUX_SLL2_HEADER_SIZE;
+        break;
+    default:
+        ipOffset = 0;
+        break;
+    }
+
+    if (ipOffset >= frameBytes.size())
+    {
+        return std::nullopt;
+    }
+    return parseIp(frameBytes.subspan(ipOffset));
+}
+
+std::optional<PcapReader::UdpDatagram> PcapReader::parseIp(std::span<const std::byte> packet)
+{
+    const uint8_t version = (static_cast<uint8_t>(packet[0]) >> 4);
+    if (version == 4)
+    {
+        if (packet.size() < IPV4_MIN_HEADER_SIZE)
+        {
+            return std::nullopt;
+        }
+        const size_t headerSize = (static_cast<uint8_t>(packet[0]) & 0x0F) * 4;
+        const size_t totalSize = std::min<size_t>(readUint16(packet, 2), packet.size());
+        // Fragments can't be put back together without the rest of them, skip them
+        const bool isFragment = ((readUint16(packet, 6) & 0x3FFF) != 0);
+        if ((static_cast<uint8_t>(packet[9]) != IP_PROTOCOL_UDP) || isFragment ||
+            (headerSize < IPV4_MIN_HEADER_SIZE) || (headerSize > totalSize))
+        {
+            return std::nullopt;
+        }
+        return parseUdp(packet.subspan(headerSize, (totalSize - headerSize)));
+    }
+    else if (version == 6)
+    {
+        // Only UDP directly after the fixed header, we don't walk extension headers
+        if ((packet.size() < IPV6_HEADER_SIZE) ||
+            (static_cast<uint8_t>(packet[6]) != IP_PROTOCOL_UDP))
+        {
+            return std::nullopt;
+        }
+        const size_t payloadSize =
+            std::min<size_t>(readUint16(packet, 4), (packet.size() - IPV6_HEADER_SIZE));
+        return parseUdp(packet.subspan(IPV6_HEADER_SIZE, payloadSize));
+    }
+    return std::nullopt;
+}
+
+std::optional<PcapReader::UdpDatagram> PcapReader::parseUdp(std::span<const std::byte> segment)
+{
+    if (segment.size() < UDP_HEADER_SIZE)
+    {
+        return std::nullopt;
+    }
+    const size_t length = readUint16(segment, 4);
+    if ((length < UDP_HEADER_SIZE) || (length > segment.size()))
+    {
+        // The capture's snap length cut off the end of the datagram
+        return std::nullopt;
+    }
+
+    const std::span<const std::byte> payload =
+        segment.subspan(UDP_HEADER_SIZE, (length - UDP_HEADER_SIZE));
+    return UdpDatagram {
+        .SourcePort = readUint16(segment, 0),
+        .DestinationPort = readUint16(segment, 2),
+        .Payload = std::vector<std::byte>(payload.begin(), payload.end()),
+    };
+}
+#pragma endregion Private methods
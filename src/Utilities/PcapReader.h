@@ -0,0 +1,92 @@
+/**
+ * @file PcapReader.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <span>
+#include <vector>
+
+/**
+ * @brief
+ *  Reads UDP datagrams out of a capture in the classic pcap format, as written by tcpdump
+ *  and friends (pcapng isn't supported, save it as pcap). Handles Ethernet (with or without
+ *  VLAN tags), Linux cooked, loopback, and raw IP captures of IPv4 and IPv6. Frames that
+ *  aren't unfragmented UDP are skipped. Not thread-safe.
+ */
+class PcapReader
+{
+public:
+    /* Public types */
+    struct UdpDatagram
+    {
+        // When the datagram was captured, since the Unix epoch
+        std::chrono::nanoseconds Timestamp { 0 };
+        uint16_t SourcePort = 0;
+        uint16_t DestinationPort = 0;
+        std::vector<std::byte> Payload;
+    };
+
+    /* Constants */
+    static constexpr uint32_t LINK_TYPE_NULL = 0;
+    static constexpr uint32_t LINK_TYPE_ETHERNET = 1;
+    static constexpr uint32_t LINK_TYPE_RAW = 101;
+    static constexpr uint32_t LINK_TYPE_LINUX_SLL = 113;
+    static constexpr uint32_t LINK_TYPE_IPV4 = 228;
+    static constexpr uint32_t LINK_TYPE_IPV6 = 229;
+    static constexpr uint32_t LINK_TYPE_LINUX_SLL2 = 276;
+
+    /* Constructor/Destructor */
+    /**
+     * @brief Reads the capture's header, throwing if it isn't a capture we can read
+     * @param input stream positioned at the start of the capture, which must outlive us
+     */
+    PcapReader(std::istream& input);
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Returns the next UDP datagram in the capture, or nothing once the end of the capture
+     *  has been reached. A truncated final frame is treated as the end of the capture.
+     */
+    std::optional<UdpDatagram> ReadNextUdpDatagram();
+
+    /* Getters/Setters */
+    uint32_t GetLinkType() const;
+    /**
+     * @brief Frames read so far that weren't UDP datagrams we could read
+     */
+    uint64_t GetSkippedFrameCount() const;
+
+private:
+    /* Private constants */
+    static constexpr uint32_t MAGIC_MICROSECONDS = 0xA1B2C3D4;
+    static constexpr uint32_t MAGIC_NANOSECONDS = 0xA1B23C4D;
+    static constexpr size_t GLOBAL_HEADER_SIZE = 24;
+    static constexpr size_t RECORD_HEADER_SIZE = 16;
+    // Far bigger than any frame we'll see, captures claiming more are corrupt
+    static constexpr uint32_t MAX_FRAME_SIZE = 262144;
+
+    /* Private fields */
+    std::istream& input;
+    // Whether the capture was written with the opposite byte order to ours
+    bool isByteSwapped = false;
+    bool hasNanosecondTimestamps = false;
+    uint32_t linkType = 0;
+    uint64_t skippedFrameCount = 0;
+    std::vector<std::byte> frame;
+
+    /* Private methods */
+    uint32_t readUint32(const std::byte* bytes) const;
+    std::optional<UdpDatagram> parseFrame(std::span<const std::byte> frameBytes) const;
+    static std::optional<UdpDatagram> parseIp(std::span<const std::byte> packet);
+    static std::optional<UdpDatagram> parseUdp(std::span<const std::byte> segment);
+};
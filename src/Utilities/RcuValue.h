@@ -0,0 +1,84 @@
+/**
+ * @file RcuValue.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief
+ *  Holds a value that is read often and changed rarely, in the style of read-copy-update.
+ *  Readers take an immutable snapshot without locking, while writers copy the current value,
+ *  modify the copy, and publish it in place of the original.
+ */
+template<typename T>
+class RcuValue
+{
+public:
+    /* Constructor/Destructor */
+    RcuValue(T initialValue = T()) :
+        current(std::make_shared<const T>(std::move(initialValue)))
+    { }
+
+    /* Public methods */
+    /**
+     * @brief Returns the current snapshot, which stays valid for as long as it is held
+     */
+    std::shared_ptr<const T> Read() const
+    {
+        return current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief
+     *  Applies the given callable to a copy of the current value and publishes the result.
+     *  Blocks until every reader has released the previous snapshot, so once this returns
+     *  nothing is still looking at the old value. Updates are serialized with each other.
+     *  Must not be called by a thread that is holding a snapshot of this value.
+     * @return whatever the callable returns
+     */
+    template<typename Callable>
+    auto Update(Callable update)
+    {
+        std::scoped_lock lock(updateMutex);
+        auto updatedValue = std::make_shared<T>(*current.load(std::memory_order_relaxed));
+        if constexpr (std::is_void_v<std::invoke_result_t<Callable, T&>>)
+        {
+            update(*updatedValue);
+            publish(std::move(updatedValue));
+        }
+        else
+        {
+            auto result = update(*updatedValue);
+            publish(std::move(updatedValue));
+            return result;
+        }
+    }
+
+private:
+    /* Private fields */
+    std::atomic<std::shared_ptr<const T>> current;
+    std::mutex updateMutex;
+
+    /* Private methods */
+    void publish(std::shared_ptr<const T> updatedValue)
+    {
+        std::shared_ptr<const T> previousValue =
+            current.exchange(std::move(updatedValue), std::memory_order_acq_rel);
+        // New readers can only see the updated value now, so once we hold the last reference to
+        // the previous one every reader is done with it.
+        while (previousValue.use_count() > 1)
+        {
+            std::this_thread::yield();
+        }
+    }
+};
@@ -0,0 +1,48 @@
+/**
+ * @file RetryBackoff.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RetryBackoff.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+RetryBackoff::RetryBackoff(Policy policy, std::chrono::steady_clock::time_point start)
+:
+    policy(policy),
+    deadline(start + policy.Timeout),
+    currentDelay(policy.InitialDelay)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+std::optional<std::chrono::milliseconds> RetryBackoff::NextDelay(
+    std::chrono::steady_clock::time_point now)
+{
+    const std::chrono::milliseconds delay = std::min(currentDelay, policy.MaxDelay);
+    if ((now + delay) >= deadline)
+    {
+        return std::nullopt;
+    }
+
+    currentDelay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        delay * policy.Multiplier);
+    ++retryCount;
+    return delay;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+uint32_t RetryBackoff::GetRetryCount() const
+{
+    return retryCount;
+}
+
+std::chrono::steady_clock::time_point RetryBackoff::GetDeadline() const
+{
+    return deadline;
+}
+#pragma endregion Getters/Setters
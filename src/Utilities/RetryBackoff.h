@@ -0,0 +1,53 @@
+/**
+ * @file RetryBackoff.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief
+ *  Schedules retries of a failing request with exponentially increasing delays, giving up
+ *  once the next attempt could no longer start before the request's deadline.
+ */
+class RetryBackoff
+{
+public:
+    /* Public types */
+    struct Policy
+    {
+        std::chrono::milliseconds InitialDelay { 250 };
+        std::chrono::milliseconds MaxDelay { 4000 };
+        double Multiplier = 2.0;
+        // Total time a request may spend on attempts and delays between them
+        std::chrono::milliseconds Timeout { 15000 };
+    };
+
+    /* Constructor/Destructor */
+    RetryBackoff(Policy policy,
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now());
+
+    /* Public methods */
+    /**
+     * @brief Returns how long to wait before retrying, or nothing if it's time to give up
+     */
+    std::optional<std::chrono::milliseconds> NextDelay(
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    /* Getters/Setters */
+    uint32_t GetRetryCount() const;
+    std::chrono::steady_clock::time_point GetDeadline() const;
+
+private:
+    /* Private fields */
+    const Policy policy;
+    const std::chrono::steady_clock::time_point deadline;
+    std::chrono::milliseconds currentDelay;
+    uint32_t retryCount = 0;
+};
@@ -0,0 +1,84 @@
+/**
+ * @file RollingByteCounter.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RollingByteCounter.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+RollingByteCounter::RollingByteCounter(
+    std::chrono::milliseconds window,
+    std::chrono::milliseconds bucketDuration)
+:
+    bucketDuration(std::max(bucketDuration, std::chrono::milliseconds(1))),
+    bucketCount(std::max<size_t>(1,
+        (window + this->bucketDuration - Clock::duration(1)) / this->bucketDuration)),
+    buckets(std::make_unique<std::atomic<uint64_t>[]>(bucketCount))
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void RollingByteCounter::Add(uint64_t bytes, Clock::time_point now)
+{
+    // There is only ever one writer, so plain loads and stores are enough here
+    const int64_t bucket = bucketForTime(now);
+    const int64_t previousBucket = newestBucket.load(std::memory_order_relaxed);
+    uint64_t sum = runningSum.load(std::memory_order_relaxed);
+    if (bucket > previousBucket)
+    {
+        // Expire every bucket we've moved past since the last update
+        const int64_t elapsed = std::min<int64_t>(bucket - previousBucket, bucketCount);
+        for (int64_t i = 1; i <= elapsed; ++i)
+        {
+            std::atomic<uint64_t>& expired = bucketAt(previousBucket + i);
+            sum -= expired.load(std::memory_order_relaxed);
+            expired.store(0, std::memory_order_relaxed);
+        }
+        newestBucket.store(bucket, std::memory_order_release);
+    }
+
+    // Bytes reported with an older time than the newest bucket are counted in the newest one
+    std::atomic<uint64_t>& current = bucketAt(newestBucket.load(std::memory_order_relaxed));
+    current.store(current.load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+    runningSum.store(sum + bytes, std::memory_order_release);
+}
+
+uint64_t RollingByteCounter::GetSum(Clock::time_point now) const
+{
+    const uint64_t sum = runningSum.load(std::memory_order_acquire);
+    const int64_t newest = newestBucket.load(std::memory_order_acquire);
+    const int64_t elapsed = bucketForTime(now) - newest;
+    if (elapsed <= 0)
+    {
+        return sum;
+    }
+    if (elapsed >= static_cast<int64_t>(bucketCount))
+    {
+        return 0;
+    }
+
+    // Discount buckets that have expired since the last update without modifying them
+    uint64_t expired = 0;
+    for (int64_t i = 1; i <= elapsed; ++i)
+    {
+        expired += bucketAt(newest + i).load(std::memory_order_relaxed);
+    }
+    return (expired < sum) ? (sum - expired) : 0;
+}
+#pragma endregion Public methods
+
+#pragma region Private methods
+int64_t RollingByteCounter::bucketForTime(Clock::time_point time) const
+{
+    return time.time_since_epoch() / bucketDuration;
+}
+
+std::atomic<uint64_t>& RollingByteCounter::bucketAt(int64_t bucket) const
+{
+    return buckets[bucket % bucketCount];
+}
+#pragma endregion Private methods
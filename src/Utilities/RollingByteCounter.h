@@ -0,0 +1,58 @@
+/**
+ * @file RollingByteCounter.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief
+ *  Counts the bytes seen over a sliding window of time using a fixed ring of time buckets and
+ *  a running sum, so recording bytes and reading the total are constant-time and memory usage
+ *  does not grow with the packet rate.
+ *  Bytes may only be added from one thread at a time, but the sum can be read from any thread
+ *  without blocking the writer. Reads that race with a write may be off by the bytes of the
+ *  buckets being updated.
+ */
+class RollingByteCounter
+{
+public:
+    /* Public types */
+    using Clock = std::chrono::steady_clock;
+
+    /* Constructor/Destructor */
+    /**
+     * @param window length of time bytes are counted for
+     * @param bucketDuration granularity that bytes expire from the window at
+     */
+    RollingByteCounter(
+        std::chrono::milliseconds window,
+        std::chrono::milliseconds bucketDuration = std::chrono::milliseconds(10));
+
+    /* Public methods */
+    void Add(uint64_t bytes, Clock::time_point now = Clock::now());
+    /**
+     * @brief The number of bytes recorded within the window ending at the given time
+     */
+    uint64_t GetSum(Clock::time_point now = Clock::now()) const;
+
+private:
+    /* Private fields */
+    const Clock::duration bucketDuration;
+    const size_t bucketCount;
+    const std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+    std::atomic<uint64_t> runningSum { 0 };
+    // Absolute index (time since clock epoch / bucket duration) of the newest bucket
+    std::atomic<int64_t> newestBucket { 0 };
+
+    /* Private methods */
+    int64_t bucketForTime(Clock::time_point time) const;
+    std::atomic<uint64_t>& bucketAt(int64_t bucket) const;
+};
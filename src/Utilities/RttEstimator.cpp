@@ -0,0 +1,67 @@
+/**
+ * @file RttEstimator.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "RttEstimator.h"
+
+#include <algorithm>
+
+#pragma region Constructor/Destructor
+RttEstimator::RttEstimator(std::chrono::microseconds initialRtt)
+:
+    smoothedRtt(initialRtt),
+    rttVariation(initialRtt / 2)
+{ }
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void RttEstimator::AddSample(std::chrono::microseconds rtt)
+{
+    rtt = std::max(rtt, std::chrono::microseconds(0));
+    if (sampleCount == 0)
+    {
+        smoothedRtt = rtt;
+        rttVariation = rtt / 2;
+    }
+    else
+    {
+        // RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, then SRTT = 7/8 SRTT + 1/8 R
+        const std::chrono::microseconds error = (smoothedRtt > rtt) ?
+            (smoothedRtt - rtt) : (rtt - smoothedRtt);
+        rttVariation = ((rttVariation * 3) + error) / 4;
+        smoothedRtt = ((smoothedRtt * 7) + rtt) / 8;
+    }
+    ++sampleCount;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool RttEstimator::HasSamples() const
+{
+    return (sampleCount > 0);
+}
+
+uint32_t RttEstimator::GetSampleCount() const
+{
+    return sampleCount;
+}
+
+std::chrono::microseconds RttEstimator::GetSmoothedRtt() const
+{
+    return smoothedRtt;
+}
+
+std::chrono::microseconds RttEstimator::GetRttVariation() const
+{
+    return rttVariation;
+}
+
+std::chrono::microseconds RttEstimator::GetRetransmitTimeout() const
+{
+    return std::clamp(smoothedRtt + (rttVariation * 4), MIN_RETRANSMIT_TIMEOUT,
+        MAX_RETRANSMIT_TIMEOUT);
+}
+#pragma endregion Getters/Setters
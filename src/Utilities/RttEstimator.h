@@ -0,0 +1,49 @@
+/**
+ * @file RttEstimator.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief
+ *  Smooths round trip time samples the way TCP does (RFC 6298), giving an estimate of the
+ *  round trip time along with how long to wait for an answer before giving up on it.
+ */
+class RttEstimator
+{
+public:
+    /* Constants */
+    // Assumed until the first sample arrives
+    static constexpr std::chrono::microseconds DEFAULT_INITIAL_RTT { 100000 };
+    // Keeps the timeout from collapsing onto the RTT on very steady connections
+    static constexpr std::chrono::microseconds MIN_RETRANSMIT_TIMEOUT { 10000 };
+    static constexpr std::chrono::microseconds MAX_RETRANSMIT_TIMEOUT { 1000000 };
+
+    /* Constructor/Destructor */
+    RttEstimator(std::chrono::microseconds initialRtt = DEFAULT_INITIAL_RTT);
+
+    /* Public methods */
+    void AddSample(std::chrono::microseconds rtt);
+
+    /* Getters/Setters */
+    bool HasSamples() const;
+    uint32_t GetSampleCount() const;
+    std::chrono::microseconds GetSmoothedRtt() const;
+    std::chrono::microseconds GetRttVariation() const;
+    /**
+     * @brief How long to wait for an answer to a request before it's considered lost
+     */
+    std::chrono::microseconds GetRetransmitTimeout() const;
+
+private:
+    /* Private fields */
+    std::chrono::microseconds smoothedRtt;
+    std::chrono::microseconds rttVariation;
+    uint32_t sampleCount = 0;
+};
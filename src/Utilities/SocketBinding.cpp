@@ -0,0 +1,246 @@
+/**
+ * @file SocketBinding.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "SocketBinding.h"
+
+#include "Util.h"
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <net/if.h>
+#include <spdlog/spdlog.h>
+
+namespace
+{
+    /**
+     * @brief
+     *  Sets a buffer size, going past the system maximum if we're allowed to, and warns if we
+     *  end up with less than asked for
+     */
+    void applyBufferSize(int socketHandle, int option, int forceOption, int bytes,
+        const char* optionName)
+    {
+        if ((setsockopt(socketHandle, SOL_SOCKET, forceOption, &bytes, sizeof(bytes)) != 0) &&
+            (setsockopt(socketHandle, SOL_SOCKET, option, &bytes, sizeof(bytes)) != 0))
+        {
+            int error = errno;
+            spdlog::warn("Unable to set {} to {} bytes. Error {}: {}", optionName, bytes,
+                error, Util::ErrnoToString(error));
+            return;
+        }
+
+        // The kernel doubles what it's given to make room for its own bookkeeping
+        int effectiveBytes = 0;
+        socklen_t optionLength = sizeof(effectiveBytes);
+        if ((getsockopt(socketHandle, SOL_SOCKET, option, &effectiveBytes, &optionLength) == 0) &&
+            ((effectiveBytes / 2) < bytes))
+        {
+            spdlog::warn("{} was capped at {} bytes rather than {}, raise the system maximum "
+                "or grant CAP_NET_ADMIN to go higher", optionName, (effectiveBytes / 2), bytes);
+        }
+    }
+}
+
+#pragma region BindAddress
+int SocketBinding::BindAddress::GetFamily() const
+{
+    return Address.ss_family;
+}
+#pragma endregion BindAddress
+
+#pragma region Static methods
+Result<SocketBinding::BindAddress> SocketBinding::ParseAddress(const std::string& address,
+    uint16_t port)
+{
+    BindAddress bindAddress;
+    auto ipv4Address = reinterpret_cast<sockaddr_in*>(&bindAddress.Address);
+    if (address.empty())
+    {
+        ipv4Address->sin_family = AF_INET;
+        ipv4Address->sin_addr.s_addr = htonl(INADDR_ANY);
+        ipv4Address->sin_port = htons(port);
+        bindAddress.Length = sizeof(sockaddr_in);
+        return Result<BindAddress>::Success(bindAddress);
+    }
+    if (inet_pton(AF_INET, address.c_str(), &ipv4Address->sin_addr) == 1)
+    {
+        ipv4Address->sin_family = AF_INET;
+        ipv4Address->sin_port = htons(port);
+        bindAddress.Length = sizeof(sockaddr_in);
+        return Result<BindAddress>::Success(bindAddress);
+    }
+
+    // Link-local addresses need the interface they're on, ex. fe80::1%eth1
+    auto ipv6Address = reinterpret_cast<sockaddr_in6*>(&bindAddress.Address);
+    const size_t scopeIndex = address.find('%');
+    const std::string ipv6Literal = address.substr(0, scopeIndex);
+    if (inet_pton(AF_INET6, ipv6Literal.c_str(), &ipv6Address->sin6_addr) != 1)
+    {
+        return Result<BindAddress>::Error(fmt::format(
+            "\"{}\" is not an IPv4 or IPv6 address", address));
+    }
+    if (scopeIndex != std::string::npos)
+    {
+        const std::string scope = address.substr(scopeIndex + 1);
+        ipv6Address->sin6_scope_id = if_nametoindex(scope.c_str());
+        if (ipv6Address->sin6_scope_id == 0)
+        {
+            return Result<BindAddress>::Error(fmt::format(
+                "\"{}\" is not a network interface", scope));
+        }
+    }
+    ipv6Address->sin6_family = AF_INET6;
+    ipv6Address->sin6_port = htons(port);
+    bindAddress.Length = sizeof(sockaddr_in6);
+    return Result<BindAddress>::Success(bindAddress);
+}
+
+std::optional<sockaddr_in> SocketBinding::ToIpv4(const sockaddr_storage& address)
+{
+    if (address.ss_family == AF_INET)
+    {
+        return *reinterpret_cast<const sockaddr_in*>(&address);
+    }
+    if (address.ss_family != AF_INET6)
+    {
+        return std::nullopt;
+    }
+
+    const auto& ipv6Address = *reinterpret_cast<const sockaddr_in6*>(&address);
+    if (!IN6_IS_ADDR_V4MAPPED(&ipv6Address.sin6_addr))
+    {
+        return std::nullopt;
+    }
+    sockaddr_in ipv4Address
+    {
+        .sin_family = AF_INET,
+        .sin_port = ipv6Address.sin6_port,
+    };
+    // The IPv4 address is the last four bytes of ::ffff:a.b.c.d
+    std::memcpy(&ipv4Address.sin_addr, &ipv6Address.sin6_addr.s6_addr[12],
+        sizeof(ipv4Address.sin_addr));
+    return ipv4Address;
+}
+#pragma endregion Static methods
+
+#pragma region Public methods
+bool SocketBinding::IsDefault() const
+{
+    return Address.empty() && Interface.empty() && (ReceiveBufferBytes == 0) &&
+        (SendBufferBytes == 0) && (BusyPollMicroseconds == 0) && IncomingCpus.empty();
+}
+
+Result<SocketBinding::BindAddress> SocketBinding::GetBindAddress(uint16_t port) const
+{
+    return ParseAddress(Address, port);
+}
+
+Result<SocketBinding::BindAddress> SocketBinding::GetBindAddress(uint16_t port,
+    int family) const
+{
+    BindAddress bindAddress;
+    if (Address.empty() && (family == AF_INET6))
+    {
+        auto ipv6Address = reinterpret_cast<sockaddr_in6*>(&bindAddress.Address);
+        ipv6Address->sin6_family = AF_INET6;
+        ipv6Address->sin6_addr = in6addr_any;
+        ipv6Address->sin6_port = htons(port);
+        bindAddress.Length = sizeof(sockaddr_in6);
+        return Result<BindAddress>::Success(bindAddress);
+    }
+
+    Result<BindAddress> parseResult = ParseAddress(Address, port);
+    if (parseResult.IsError || (parseResult.Value.GetFamily() == family))
+    {
+        return parseResult;
+    }
+    if (family == AF_INET)
+    {
+        const auto& ipv6Address = *reinterpret_cast<const sockaddr_in6*>(
+            &parseResult.Value.Address);
+        std::optional<sockaddr_in> ipv4Address = ToIpv4(parseResult.Value.Address);
+        if (!ipv4Address.has_value() && IN6_IS_ADDR_UNSPECIFIED(&ipv6Address.sin6_addr))
+        {
+            ipv4Address = sockaddr_in
+            {
+                .sin_family = AF_INET,
+                .sin_port = htons(port),
+                .sin_addr = { .s_addr = htonl(INADDR_ANY) },
+            };
+        }
+        if (ipv4Address.has_value())
+        {
+            std::memcpy(&bindAddress.Address, &ipv4Address.value(), sizeof(sockaddr_in));
+            bindAddress.Length = sizeof(sockaddr_in);
+            return Result<BindAddress>::Success(bindAddress);
+        }
+    }
+    return Result<BindAddress>::Error(fmt::format("{} peers can't be reached from {}",
+        ((family == AF_INET6) ? "IPv6" : "IPv4"), Address));
+}
+
+Result<void> SocketBinding::Apply(int socketHandle, int family,
+    std::optional<size_t> socketIndex) const
+{
+    if (family == AF_INET6)
+    {
+        // Some distributions default to IPv6 only, we want IPv4 peers on "::" too
+        int ipv6Only = 0;
+        if (setsockopt(socketHandle, IPPROTO_IPV6, IPV6_V6ONLY, &ipv6Only,
+            sizeof(ipv6Only)) != 0)
+        {
+            int error = errno;
+            return Result<void>::Error(fmt::format(
+                "Unable to accept IPv4 on IPv6 socket. Error {}: {}", error,
+                Util::ErrnoToString(error)));
+        }
+    }
+
+    if (!Interface.empty() && (setsockopt(socketHandle, SOL_SOCKET, SO_BINDTODEVICE,
+        Interface.c_str(), Interface.size()) != 0))
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format(
+            "Unable to bind socket to interface {}. Error {}: {}", Interface, error,
+            Util::ErrnoToString(error)));
+    }
+
+    if (ReceiveBufferBytes > 0)
+    {
+        applyBufferSize(socketHandle, SO_RCVBUF, SO_RCVBUFFORCE, ReceiveBufferBytes,
+            "SO_RCVBUF");
+    }
+    if (SendBufferBytes > 0)
+    {
+        applyBufferSize(socketHandle, SO_SNDBUF, SO_SNDBUFFORCE, SendBufferBytes, "SO_SNDBUF");
+    }
+
+    if ((BusyPollMicroseconds > 0) && (setsockopt(socketHandle, SOL_SOCKET, SO_BUSY_POLL,
+        &BusyPollMicroseconds, sizeof(BusyPollMicroseconds)) != 0))
+    {
+        int error = errno;
+        spdlog::warn("Unable to set SO_BUSY_POLL to {}us. Error {}: {}", BusyPollMicroseconds,
+            error, Util::ErrnoToString(error));
+    }
+
+    if (socketIndex.has_value() && !IncomingCpus.empty())
+    {
+        // The kernel prefers the socket in a SO_REUSEPORT group whose CPU matches the one
+        // the packet was received on, keeping each NIC queue's traffic on one socket
+        int incomingCpu = IncomingCpus.at(socketIndex.value() % IncomingCpus.size());
+        if (setsockopt(socketHandle, SOL_SOCKET, SO_INCOMING_CPU, &incomingCpu,
+            sizeof(incomingCpu)) != 0)
+        {
+            int error = errno;
+            spdlog::warn("Unable to set SO_INCOMING_CPU to {}. Error {}: {}", incomingCpu,
+                error, Util::ErrnoToString(error));
+        }
+    }
+
+    return Result<void>::Success();
+}
+#pragma endregion Public methods
@@ -0,0 +1,83 @@
+/**
+ * @file SocketBinding.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <netinet/in.h>
+#include <optional>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+/**
+ * @brief
+ *  Where one kind of socket (ex. the control listener, or media sockets) is bound, and how
+ *  it's tuned, so each kind of traffic can be kept to its own interface and NIC queues.
+ *  Defaults leave sockets bound to every IPv4 address with the system's default options.
+ */
+struct SocketBinding
+{
+    /* Public types */
+    struct BindAddress
+    {
+        sockaddr_storage Address {};
+        socklen_t Length = 0;
+
+        int GetFamily() const;
+    };
+
+    /* Static methods */
+    /**
+     * @brief
+     *  Parses an IPv4 or IPv6 address literal to bind to, where empty binds every IPv4 address
+     */
+    static Result<BindAddress> ParseAddress(const std::string& address, uint16_t port);
+    /**
+     * @brief
+     *  The IPv4 address of an IPv4 peer, or one reaching a dual-stack socket through an
+     *  IPv4-mapped IPv6 address. Nothing for peers that only have an IPv6 address.
+     */
+    static std::optional<sockaddr_in> ToIpv4(const sockaddr_storage& address);
+
+    /* Public fields */
+    // Address literal to bind to, "::" to accept IPv4 and IPv6 on every address
+    std::string Address;
+    // Network interface to bind to with SO_BINDTODEVICE, ex. "eth1"
+    std::string Interface;
+    // SO_RCVBUF and SO_SNDBUF sizes, or 0 for the system default
+    int ReceiveBufferBytes = 0;
+    int SendBufferBytes = 0;
+    // SO_BUSY_POLL time, or 0 to wait for interrupts as usual
+    int BusyPollMicroseconds = 0;
+    // SO_INCOMING_CPU of each socket in a SO_REUSEPORT group, in turn
+    std::vector<int> IncomingCpus;
+
+    /* Public methods */
+    bool IsDefault() const;
+    Result<BindAddress> GetBindAddress(uint16_t port) const;
+    /**
+     * @brief
+     *  The address to bind a socket that talks to peers of the given family. Empty binds every
+     *  address of that family, and "::" binds every IPv4 address for IPv4 peers. Anything else
+     *  has to be an address of the same family.
+     */
+    Result<BindAddress> GetBindAddress(uint16_t port, int family) const;
+    /**
+     * @brief
+     *  Applies everything but the address to a socket that's about to be bound or connected.
+     *  Failing to bind to the interface is an error. Tuning the kernel won't allow (ex. buffers
+     *  over net.core.rmem_max without CAP_NET_ADMIN) is logged and left at what it allows.
+     * @param family address family the socket was created with
+     * @param socketIndex
+     *  the socket's position in its SO_REUSEPORT group, picking its incoming CPU, or nothing
+     *  to leave the incoming CPU alone
+     */
+    Result<void> Apply(int socketHandle, int family,
+        std::optional<size_t> socketIndex = std::nullopt) const;
+};
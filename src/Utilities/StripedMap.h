@@ -0,0 +1,178 @@
+/**
+ * @file StripedMap.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief
+ *  A thread-safe map of shared records, split into stripes that each have their own lock so
+ *  that operations on different keys rarely contend. Stripe locks are only held for the
+ *  lookup itself - records are handed out as shared pointers, and are responsible for
+ *  synchronizing access to their own contents.
+ */
+template<typename TKey, typename TValue, typename THash = std::hash<TKey>>
+class StripedMap
+{
+public:
+    /* Constants */
+    static constexpr size_t DEFAULT_NUM_STRIPES = 64;
+
+    /* Constructor/Destructor */
+    StripedMap(size_t numStripes = DEFAULT_NUM_STRIPES) :
+        stripes(std::max<size_t>(numStripes, 1))
+    { }
+
+    /* Public methods */
+    /**
+     * @brief Returns the record for the given key, or null if there isn't one
+     */
+    std::shared_ptr<TValue> Find(const TKey& key) const
+    {
+        const Stripe& stripe = stripeFor(key);
+        std::shared_lock lock(stripe.Mutex);
+        auto it = stripe.Values.find(key);
+        return (it != stripe.Values.end()) ? it->second : nullptr;
+    }
+
+    /**
+     * @brief Returns the record for the given key, default-constructing one if there isn't one
+     */
+    std::shared_ptr<TValue> GetOrCreate(const TKey& key)
+    {
+        if (std::shared_ptr<TValue> value = Find(key))
+        {
+            return value;
+        }
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock lock(stripe.Mutex);
+        auto [it, inserted] = stripe.Values.try_emplace(key, nullptr);
+        if (inserted)
+        {
+            it->second = std::make_shared<TValue>();
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Sets the record for the given key, replacing any record already there
+     */
+    void Insert(const TKey& key, std::shared_ptr<TValue> value)
+    {
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock lock(stripe.Mutex);
+        stripe.Values.insert_or_assign(key, std::move(value));
+    }
+
+    /**
+     * @brief Removes the record for the given key
+     * @return the removed record, or null if there wasn't one
+     */
+    std::shared_ptr<TValue> Remove(const TKey& key)
+    {
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock lock(stripe.Mutex);
+        auto it = stripe.Values.find(key);
+        if (it == stripe.Values.end())
+        {
+            return nullptr;
+        }
+        std::shared_ptr<TValue> value = std::move(it->second);
+        stripe.Values.erase(it);
+        return value;
+    }
+
+    /**
+     * @brief
+     *  Removes the record for the given key if the predicate returns true for it. The predicate
+     *  is called while the stripe is locked, so no one can look the record up in the meantime.
+     * @return true if the record was removed
+     */
+    template<typename Predicate>
+    bool RemoveIf(const TKey& key, Predicate predicate)
+    {
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock lock(stripe.Mutex);
+        auto it = stripe.Values.find(key);
+        if ((it == stripe.Values.end()) || !predicate(*it->second))
+        {
+            return false;
+        }
+        stripe.Values.erase(it);
+        return true;
+    }
+
+    /* Getters/Setters */
+    size_t GetSize() const
+    {
+        size_t size = 0;
+        for (const Stripe& stripe : stripes)
+        {
+            std::shared_lock lock(stripe.Mutex);
+            size += stripe.Values.size();
+        }
+        return size;
+    }
+
+    /**
+     * @brief
+     *  Returns every key in the map. Stripes are read one at a time, so the result may miss
+     *  records added or removed while it's being gathered.
+     */
+    std::vector<TKey> GetKeys() const
+    {
+        std::vector<TKey> keys;
+        for (const Stripe& stripe : stripes)
+        {
+            std::shared_lock lock(stripe.Mutex);
+            for (const auto& valuePair : stripe.Values)
+            {
+                keys.push_back(valuePair.first);
+            }
+        }
+        return keys;
+    }
+
+private:
+    /* Private types */
+    struct Stripe
+    {
+        mutable std::shared_mutex Mutex;
+        std::unordered_map<TKey, std::shared_ptr<TValue>, THash> Values;
+    };
+
+    /* Private fields */
+    std::vector<Stripe> stripes;
+
+    /* Private methods */
+    size_t stripeIndex(const TKey& key) const
+    {
+        // Hashes of pointers and small integers are often just the value itself, so mix the
+        // bits before picking a stripe to keep aligned addresses from piling into a few stripes
+        uint64_t hash = static_cast<uint64_t>(THash{}(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash >> 32) % stripes.size();
+    }
+
+    Stripe& stripeFor(const TKey& key)
+    {
+        return stripes[stripeIndex(key)];
+    }
+
+    const Stripe& stripeFor(const TKey& key) const
+    {
+        return stripes[stripeIndex(key)];
+    }
+};
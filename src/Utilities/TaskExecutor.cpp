@@ -0,0 +1,124 @@
+/**
+ * @file TaskExecutor.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "TaskExecutor.h"
+
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+#pragma region Constructor/Destructor
+TaskExecutor::TaskExecutor(size_t numThreads, size_t maxQueuedTasks)
+:
+    maxQueuedTasks(std::max<size_t>(1, maxQueuedTasks))
+{
+    for (size_t i = 0; i < std::max<size_t>(1, numThreads); ++i)
+    {
+        threads.emplace_back(
+            [this](std::stop_token stopToken)
+            {
+                threadBody(stopToken);
+            });
+    }
+}
+
+TaskExecutor::~TaskExecutor()
+{
+    // Workers keep going until the queue is empty once they've been asked to stop
+    for (auto& thread : threads)
+    {
+        thread.request_stop();
+    }
+    for (auto& thread : threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void TaskExecutor::Submit(Task task)
+{
+    {
+        std::unique_lock lock(mutex);
+        if (queuedTasks.size() >= maxQueuedTasks)
+        {
+            ++stats.Overflows;
+            taskDequeuedCondition.wait(lock,
+                [this]() { return (queuedTasks.size() < maxQueuedTasks); });
+        }
+        queuedTasks.push_back(QueuedTask
+            {
+                .Run = std::move(task),
+                .SubmitTime = std::chrono::steady_clock::now(),
+            });
+        stats.PeakQueuedTasks = std::max(stats.PeakQueuedTasks, queuedTasks.size());
+    }
+    taskQueuedCondition.notify_one();
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+size_t TaskExecutor::GetWorkerCount() const
+{
+    return threads.size();
+}
+
+TaskExecutor::Stats TaskExecutor::GetStats()
+{
+    std::scoped_lock lock(mutex);
+    Stats currentStats = stats;
+    currentStats.QueuedTasks = queuedTasks.size();
+    return currentStats;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void TaskExecutor::threadBody(std::stop_token stopToken)
+{
+    while (true)
+    {
+        QueuedTask task;
+        {
+            std::unique_lock lock(mutex);
+            if (!taskQueuedCondition.wait(lock, stopToken,
+                [this]() { return !queuedTasks.empty(); }))
+            {
+                // We've been asked to stop and there's nothing left to run
+                return;
+            }
+            task = std::move(queuedTasks.front());
+            queuedTasks.pop_front();
+        }
+        taskDequeuedCondition.notify_one();
+
+        const auto startTime = std::chrono::steady_clock::now();
+        try
+        {
+            task.Run();
+        }
+        catch (const std::exception& e)
+        {
+            spdlog::error("Unhandled exception in executor task: {}", e.what());
+        }
+        const auto endTime = std::chrono::steady_clock::now();
+
+        const auto queueLatency =
+            std::chrono::duration_cast<std::chrono::microseconds>(startTime - task.SubmitTime);
+        const auto runTime =
+            std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
+        std::scoped_lock lock(mutex);
+        ++stats.CompletedTasks;
+        stats.TotalQueueLatency += queueLatency;
+        stats.MaxQueueLatency = std::max(stats.MaxQueueLatency, queueLatency);
+        stats.TotalRunTime += runTime;
+        stats.MaxRunTime = std::max(stats.MaxRunTime, runTime);
+    }
+}
+#pragma endregion Private methods
@@ -0,0 +1,93 @@
+/**
+ * @file TaskExecutor.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ *  Runs tasks on a fixed set of worker threads, in the order they were submitted. The queue
+ *  of waiting tasks is bounded, and submitting to a full queue blocks until a worker makes
+ *  room, so a flood of work slows its producer down instead of piling up without limit.
+ */
+class TaskExecutor
+{
+public:
+    /* Public types */
+    using Task = std::function<void()>;
+
+    struct Stats
+    {
+        // Tasks currently waiting for a worker
+        size_t QueuedTasks = 0;
+        // Most tasks that have been waiting for a worker at once
+        size_t PeakQueuedTasks = 0;
+        uint64_t CompletedTasks = 0;
+        // Number of times a task was submitted to find the queue full
+        uint64_t Overflows = 0;
+        // Time between tasks being submitted and a worker starting them
+        std::chrono::microseconds TotalQueueLatency { 0 };
+        std::chrono::microseconds MaxQueueLatency { 0 };
+        // Time workers spent running tasks
+        std::chrono::microseconds TotalRunTime { 0 };
+        std::chrono::microseconds MaxRunTime { 0 };
+    };
+
+    /* Constants */
+    static constexpr size_t DEFAULT_MAX_QUEUED_TASKS = 4096;
+
+    /* Constructor/Destructor */
+    TaskExecutor(size_t numThreads, size_t maxQueuedTasks = DEFAULT_MAX_QUEUED_TASKS);
+    /**
+     * @brief Runs every task that has already been submitted, then stops the workers
+     */
+    ~TaskExecutor();
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Queues a task to run on a worker thread, waiting for room if the queue is full. Must not
+     *  be called from a task, which could otherwise end up waiting on itself.
+     */
+    void Submit(Task task);
+
+    /* Getters/Setters */
+    size_t GetWorkerCount() const;
+    Stats GetStats();
+
+private:
+    /* Private types */
+    struct QueuedTask
+    {
+        Task Run;
+        std::chrono::steady_clock::time_point SubmitTime;
+    };
+
+    /* Private fields */
+    const size_t maxQueuedTasks;
+    std::mutex mutex;
+    // Signalled when a task is queued
+    std::condition_variable_any taskQueuedCondition;
+    // Signalled when a worker takes a task off of the queue
+    std::condition_variable taskDequeuedCondition;
+    std::list<QueuedTask> queuedTasks;
+    Stats stats;
+    std::vector<std::jthread> threads;
+
+    /* Private methods */
+    void threadBody(std::stop_token stopToken);
+};
@@ -0,0 +1,59 @@
+/**
+ * @file ThreadPlacement.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <atomic>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * @brief
+ *  Remembers which thread last did a piece of work, and which CPU it was running on at the
+ *  time, so it can be shown to anyone debugging the node. Recording never takes a lock, and
+ *  may be read from any thread.
+ */
+class ThreadPlacement
+{
+public:
+    /* Public types */
+    struct Snapshot
+    {
+        // Kernel thread ID, as shown by tools like top, or 0 if nothing has been recorded
+        pid_t ThreadId = 0;
+        // -1 if nothing has been recorded
+        int Cpu = -1;
+    };
+
+    /* Public methods */
+    /**
+     * @brief Records the calling thread and the CPU it's currently running on
+     */
+    void Record()
+    {
+        // The thread ID never changes, so it's only looked up once per thread
+        thread_local const pid_t currentThreadId = static_cast<pid_t>(syscall(SYS_gettid));
+        threadId.store(currentThreadId, std::memory_order_relaxed);
+        cpu.store(sched_getcpu(), std::memory_order_relaxed);
+    }
+
+    /* Getters/Setters */
+    Snapshot Get() const
+    {
+        return Snapshot {
+            .ThreadId = threadId.load(std::memory_order_relaxed),
+            .Cpu = cpu.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    /* Private fields */
+    std::atomic<pid_t> threadId { 0 };
+    std::atomic<int> cpu { -1 };
+};
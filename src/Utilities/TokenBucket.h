@@ -0,0 +1,87 @@
+/**
+ * @file TokenBucket.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief
+ *  Classic token bucket: holds up to a burst's worth of tokens, refilled continuously at a
+ *  fixed rate. Not thread-safe.
+ */
+template<typename Clock = std::chrono::steady_clock>
+class TokenBucket
+{
+public:
+    /* Public types */
+    using TimePoint = typename Clock::time_point;
+
+    /* Constructor/Destructor */
+    /**
+     * @param ratePerSecond tokens added per second
+     * @param burst the most tokens the bucket can hold, which it starts out full with
+     */
+    TokenBucket(double ratePerSecond, double burst, TimePoint now = Clock::now()) :
+        ratePerSecond(ratePerSecond),
+        burst(burst),
+        tokens(burst),
+        lastRefillTime(now)
+    { }
+
+    /* Public methods */
+    /**
+     * @brief Takes the given number of tokens if the bucket holds that many
+     */
+    bool TryConsume(TimePoint now, double amount = 1.0)
+    {
+        refill(now);
+        if (tokens < amount)
+        {
+            return false;
+        }
+        tokens -= amount;
+        return true;
+    }
+
+    /* Getters/Setters */
+    double GetTokens(TimePoint now) const
+    {
+        if (now <= lastRefillTime)
+        {
+            return tokens;
+        }
+        const std::chrono::duration<double> elapsed = now - lastRefillTime;
+        return std::min(burst, tokens + (elapsed.count() * ratePerSecond));
+    }
+
+    /**
+     * @brief Whether the bucket has refilled completely, so forgetting it changes nothing
+     */
+    bool IsFull(TimePoint now) const
+    {
+        return GetTokens(now) >= burst;
+    }
+
+private:
+    /* Private fields */
+    const double ratePerSecond;
+    const double burst;
+    double tokens;
+    TimePoint lastRefillTime;
+
+    /* Private methods */
+    void refill(TimePoint now)
+    {
+        if (now > lastRefillTime)
+        {
+            tokens = GetTokens(now);
+            lastRefillTime = now;
+        }
+    }
+};
@@ -0,0 +1,294 @@
+/**
+ * @file UnixSocketHandoff.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "UnixSocketHandoff.h"
+
+#include "Util.h"
+
+#include <cstring>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    Result<sockaddr_un> unixAddress(const std::string& path)
+    {
+        sockaddr_un address { .sun_family = AF_UNIX };
+        if (path.empty() || (path.size() >= sizeof(address.sun_path)))
+        {
+            return Result<sockaddr_un>::Error(
+                fmt::format("Invalid Unix socket path '{}'", path));
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return Result<sockaddr_un>::Success(address);
+    }
+
+    /**
+     * @return whether the handle became readable before the timeout
+     */
+    Result<bool> waitForReadable(int handle, std::chrono::milliseconds timeout)
+    {
+        pollfd pollHandle { .fd = handle, .events = POLLIN };
+        int pollResult = 0;
+        do
+        {
+            pollResult = poll(&pollHandle, 1, timeout.count());
+        }
+        while ((pollResult < 0) && (errno == EINTR));
+        if (pollResult < 0)
+        {
+            int error = errno;
+            return Result<bool>::Error(fmt::format("poll failed. Error {}: {}", error,
+                Util::ErrnoToString(error)));
+        }
+        return Result<bool>::Success(pollResult > 0);
+    }
+
+    /**
+     * @brief
+     *  Makes sure whoever is on the other end of a connection runs as the same user as us,
+     *  since they either get or give every socket we're serving streams on
+     */
+    Result<void> checkPeerCredentials(int socketHandle)
+    {
+        ucred credentials {};
+        socklen_t credentialsLength = sizeof(credentials);
+        if (getsockopt(socketHandle, SOL_SOCKET, SO_PEERCRED, &credentials,
+            &credentialsLength) != 0)
+        {
+            int error = errno;
+            return Result<void>::Error(fmt::format(
+                "Couldn't get peer credentials. Error {}: {}", error,
+                Util::ErrnoToString(error)));
+        }
+        if (credentials.uid != geteuid())
+        {
+            return Result<void>::Error(fmt::format(
+                "Peer (pid {}) runs as uid {}, not our uid {}", credentials.pid,
+                credentials.uid, geteuid()));
+        }
+        return Result<void>::Success();
+    }
+}
+
+#pragma region Public methods
+Result<int> UnixSocketHandoff::Listen(const std::string& path)
+{
+    Result<sockaddr_un> address = unixAddress(path);
+    if (address.IsError)
+    {
+        return Result<int>::Error(address.ErrorMessage);
+    }
+
+    int listenHandle = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listenHandle < 0)
+    {
+        int error = errno;
+        return Result<int>::Error(fmt::format("Couldn't create Unix socket. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+    unlink(path.c_str());
+    // Nobody can connect until we listen, so there's no window where the socket is open to
+    // anyone the umask lets in
+    if ((bind(listenHandle, reinterpret_cast<const sockaddr*>(&address.Value),
+            sizeof(address.Value)) != 0) ||
+        (chmod(path.c_str(), (S_IRUSR | S_IWUSR)) != 0) ||
+        (listen(listenHandle, 1) != 0))
+    {
+        int error = errno;
+        close(listenHandle);
+        return Result<int>::Error(fmt::format("Couldn't listen on {}. Error {}: {}",
+            path, error, Util::ErrnoToString(error)));
+    }
+    return Result<int>::Success(listenHandle);
+}
+
+Result<int> UnixSocketHandoff::Connect(const std::string& path)
+{
+    Result<sockaddr_un> address = unixAddress(path);
+    if (address.IsError)
+    {
+        return Result<int>::Error(address.ErrorMessage);
+    }
+
+    int socketHandle = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socketHandle < 0)
+    {
+        int error = errno;
+        return Result<int>::Error(fmt::format("Couldn't create Unix socket. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+    if (connect(socketHandle, reinterpret_cast<const sockaddr*>(&address.Value),
+        sizeof(address.Value)) != 0)
+    {
+        int error = errno;
+        close(socketHandle);
+        return Result<int>::Error(fmt::format("Couldn't connect to {}. Error {}: {}",
+            path, error, Util::ErrnoToString(error)));
+    }
+    Result<void> credentialsResult = checkPeerCredentials(socketHandle);
+    if (credentialsResult.IsError)
+    {
+        close(socketHandle);
+        return Result<int>::Error(fmt::format("Won't take over from {}: {}", path,
+            credentialsResult.ErrorMessage));
+    }
+    return Result<int>::Success(socketHandle);
+}
+
+Result<std::optional<int>> UnixSocketHandoff::Accept(int listenHandle,
+    std::chrono::milliseconds timeout)
+{
+    Result<bool> waitResult = waitForReadable(listenHandle, timeout);
+    if (waitResult.IsError)
+    {
+        return Result<std::optional<int>>::Error(waitResult.ErrorMessage);
+    }
+    if (!waitResult.Value)
+    {
+        return Result<std::optional<int>>::Success(std::nullopt);
+    }
+
+    int socketHandle = accept4(listenHandle, nullptr, nullptr, SOCK_CLOEXEC);
+    if (socketHandle < 0)
+    {
+        int error = errno;
+        return Result<std::optional<int>>::Error(fmt::format(
+            "Couldn't accept Unix socket connection. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+    Result<void> credentialsResult = checkPeerCredentials(socketHandle);
+    if (credentialsResult.IsError)
+    {
+        // Turned away like a connection that never came, so we keep waiting for our successor
+        spdlog::warn("Rejecting handoff connection: {}", credentialsResult.ErrorMessage);
+        close(socketHandle);
+        return Result<std::optional<int>>::Success(std::nullopt);
+    }
+    return Result<std::optional<int>>::Success(socketHandle);
+}
+
+Result<void> UnixSocketHandoff::Send(int socketHandle, std::span<const std::byte> payload,
+    std::span<const int> handles)
+{
+    if (payload.empty() || (payload.size() > MAX_PAYLOAD_SIZE))
+    {
+        return Result<void>::Error(fmt::format("Can't send a {} byte payload", payload.size()));
+    }
+    if (handles.size() > MAX_HANDLES)
+    {
+        return Result<void>::Error(fmt::format("Can't send {} handles in one message, "
+            "at most {} can be sent", handles.size(), MAX_HANDLES));
+    }
+
+    iovec payloadVector
+    {
+        .iov_base = const_cast<std::byte*>(payload.data()),
+        .iov_len = payload.size(),
+    };
+    msghdr message
+    {
+        .msg_iov = &payloadVector,
+        .msg_iovlen = 1,
+    };
+    alignas(cmsghdr) std::byte controlBuffer[CMSG_SPACE(sizeof(int) * MAX_HANDLES)] {};
+    if (!handles.empty())
+    {
+        message.msg_control = controlBuffer;
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * handles.size());
+        cmsghdr* control = CMSG_FIRSTHDR(&message);
+        control->cmsg_level = SOL_SOCKET;
+        control->cmsg_type = SCM_RIGHTS;
+        control->cmsg_len = CMSG_LEN(sizeof(int) * handles.size());
+        std::memcpy(CMSG_DATA(control), handles.data(), sizeof(int) * handles.size());
+    }
+
+    ssize_t sendResult = 0;
+    do
+    {
+        sendResult = sendmsg(socketHandle, &message, MSG_NOSIGNAL);
+    }
+    while ((sendResult < 0) && (errno == EINTR));
+    if (sendResult < 0)
+    {
+        int error = errno;
+        return Result<void>::Error(fmt::format("Couldn't send handoff message. Error {}: {}",
+            error, Util::ErrnoToString(error)));
+    }
+    return Result<void>::Success();
+}
+
+Result<UnixSocketHandoff::Message> UnixSocketHandoff::Receive(int socketHandle,
+    std::chrono::milliseconds timeout)
+{
+    Result<bool> waitResult = waitForReadable(socketHandle, timeout);
+    if (waitResult.IsError || !waitResult.Value)
+    {
+        return Result<Message>::Error(fmt::format("Couldn't receive handoff message: {}",
+            waitResult.IsError ? waitResult.ErrorMessage : "timed out"));
+    }
+
+    Message received;
+    received.Payload.resize(MAX_PAYLOAD_SIZE);
+    iovec payloadVector
+    {
+        .iov_base = received.Payload.data(),
+        .iov_len = received.Payload.size(),
+    };
+    alignas(cmsghdr) std::byte controlBuffer[CMSG_SPACE(sizeof(int) * MAX_HANDLES)] {};
+    msghdr message
+    {
+        .msg_iov = &payloadVector,
+        .msg_iovlen = 1,
+        .msg_control = controlBuffer,
+        .msg_controllen = sizeof(controlBuffer),
+    };
+    ssize_t receiveResult = 0;
+    do
+    {
+        receiveResult = recvmsg(socketHandle, &message, MSG_CMSG_CLOEXEC);
+    }
+    while ((receiveResult < 0) && (errno == EINTR));
+    if (receiveResult < 0)
+    {
+        int error = errno;
+        return Result<Message>::Error(fmt::format(
+            "Couldn't receive handoff message. Error {}: {}", error,
+            Util::ErrnoToString(error)));
+    }
+
+    // Take ownership of whatever handles arrived before deciding if the message is any good,
+    // so none are leaked
+    for (cmsghdr* control = CMSG_FIRSTHDR(&message); control != nullptr;
+        control = CMSG_NXTHDR(&message, control))
+    {
+        if ((control->cmsg_level == SOL_SOCKET) && (control->cmsg_type == SCM_RIGHTS))
+        {
+            const size_t numHandles = (control->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const size_t firstHandle = received.Handles.size();
+            received.Handles.resize(firstHandle + numHandles);
+            std::memcpy(&received.Handles[firstHandle], CMSG_DATA(control),
+                sizeof(int) * numHandles);
+        }
+    }
+    if ((receiveResult == 0) || (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)))
+    {
+        for (const int handle : received.Handles)
+        {
+            close(handle);
+        }
+        return Result<Message>::Error((receiveResult == 0) ?
+            "Handoff connection was closed" : "Handoff message was truncated");
+    }
+    received.Payload.resize(receiveResult);
+    return Result<Message>::Success(std::move(received));
+}
+#pragma endregion Public methods
@@ -0,0 +1,73 @@
+/**
+ * @file UnixSocketHandoff.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Result.h"
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief
+ *  Passes messages along with open file descriptors (via SCM_RIGHTS) between processes over
+ *  a Unix domain socket, so one process can hand live sockets to another.
+ *  Sockets are SOCK_SEQPACKET, so every message arrives whole and on its own.
+ */
+class UnixSocketHandoff
+{
+public:
+    /* Public types */
+    struct Message
+    {
+        std::vector<std::byte> Payload;
+        // Owned by whoever received the message, and opened close-on-exec
+        std::vector<int> Handles;
+    };
+
+    /* Constants */
+    static constexpr size_t MAX_PAYLOAD_SIZE = 64 * 1024;
+    // Well under the kernel's limit of descriptors per message (SCM_MAX_FD)
+    static constexpr size_t MAX_HANDLES = 64;
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Listens on the given path, replacing any socket left there by a previous process. The
+     *  socket is only accessible to our user.
+     */
+    static Result<int> Listen(const std::string& path);
+
+    /**
+     * @brief Connects to whoever is listening on the given path, if they run as our user
+     */
+    static Result<int> Connect(const std::string& path);
+
+    /**
+     * @return
+     *  the accepted connection, or nothing if none arrived before the timeout or it came from
+     *  another user
+     */
+    static Result<std::optional<int>> Accept(int listenHandle, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief
+     *  Sends a message along with the given handles. The handles stay open in this process,
+     *  the receiver gets its own copies.
+     */
+    static Result<void> Send(int socketHandle, std::span<const std::byte> payload,
+        std::span<const int> handles = {});
+
+    /**
+     * @brief Waits for the next message, failing if the other end hangs up or times out
+     */
+    static Result<Message> Receive(int socketHandle, std::chrono::milliseconds timeout);
+};
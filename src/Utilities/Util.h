@@ -82,6 +82,13 @@ public:
         return std::string(str);
     }
 
+    static std::string AddrToString(in6_addr addr)
+    {
+        char str[INET6_ADDRSTRLEN];
+        inet_ntop(AF_INET6, &(addr), str, INET6_ADDRSTRLEN);
+        return std::string(str);
+    }
+
     static std::vector<std::byte> StringToByteVector(const std::string& str)
     {
         std::vector<std::byte> bytes;
@@ -0,0 +1,118 @@
+/**
+ * @file VideoCodecTraits.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "Rtp/H264Rtp.h"
+#include "Utilities/FtlTypes.h"
+#include "Utilities/Result.h"
+#include "VideoDecoders/H264SpsParser.h"
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+class H264VideoDecoder;
+
+/**
+ * @brief
+ *  Everything the media path needs to know about a video codec, specialized for each codec
+ *  we support. A stream's codec is looked up once when the stream starts, binding it to the
+ *  matching specialization, so per-packet work never branches on the codec.
+ *
+ *  Supporting a new codec means adding a VideoCodecKind, a specialization providing:
+ *   - IsKeyframePayload, whether an RTP payload carries part of a keyframe
+ *   - ForEachParameterSet, calling back with each whole parameter set in an RTP payload
+ *   - ParseParameterSet, reading VideoParameters out of one of those parameter sets
+ *   - Decoder, the VideoDecoder used to generate previews
+ *  and adding the codec to SupportedVideoCodecList.
+ */
+template<VideoCodecKind Codec>
+struct VideoCodecTraits;
+
+template<>
+struct VideoCodecTraits<VideoCodecKind::H264>
+{
+    using Decoder = H264VideoDecoder;
+
+    static bool IsKeyframePayload(std::span<const std::byte> rtpPayload)
+    {
+        return H264Rtp::IsKeyframePayload(rtpPayload);
+    }
+
+    /**
+     * @brief Invokes the given callable with every SPS carried alone or in a STAP-A
+     */
+    template<typename Callable>
+    static void ForEachParameterSet(std::span<const std::byte> rtpPayload, Callable&& call)
+    {
+        H264Rtp::ForEachNalUnit(rtpPayload,
+            [&call](std::span<const std::byte> nalUnit)
+            {
+                if (H264Rtp::NalType(nalUnit[0]) == H264Rtp::NAL_TYPE_SPS)
+                {
+                    call(nalUnit);
+                }
+            });
+    }
+
+    static Result<VideoParameters> ParseParameterSet(std::span<const std::byte> nalUnit)
+    {
+        return H264SpsParser::Parse(nalUnit);
+    }
+};
+
+/**
+ * @brief A set of video codecs with VideoCodecTraits, to bind a runtime codec kind to
+ */
+template<VideoCodecKind... Codecs>
+struct VideoCodecList
+{
+    template<VideoCodecKind Codec>
+    using Tag = std::integral_constant<VideoCodecKind, Codec>;
+
+    /**
+     * @brief
+     *  Invokes the given callable with a Tag for the given codec, whose value can be used to
+     *  instantiate templates for it.
+     * @return false if the codec isn't in the list, and the callable wasn't invoked
+     */
+    template<typename Visitor>
+    static bool Visit(VideoCodecKind codec, Visitor&& visitor)
+    {
+        return (((codec == Codecs) ? (visitor(Tag<Codecs> { }), true) : false) || ...);
+    }
+
+    /**
+     * @brief Invokes the given callable with a Tag for every codec in the list
+     */
+    template<typename Visitor>
+    static void ForEach(Visitor&& visitor)
+    {
+        (visitor(Tag<Codecs> { }), ...);
+    }
+};
+
+using SupportedVideoCodecList = VideoCodecList<VideoCodecKind::H264>;
+
+using KeyframePayloadDetector = bool (*)(std::span<const std::byte> rtpPayload);
+
+/**
+ * @brief
+ *  The keyframe check for the given codec's RTP payloads, to be looked up once per stream.
+ *  Codecs we don't support never carry keyframes as far as we can tell.
+ */
+inline KeyframePayloadDetector GetKeyframePayloadDetector(VideoCodecKind codec)
+{
+    KeyframePayloadDetector detector = [](std::span<const std::byte>) { return false; };
+    SupportedVideoCodecList::Visit(codec,
+        [&detector](auto codecTag)
+        {
+            detector = &VideoCodecTraits<decltype(codecTag)::value>::IsKeyframePayload;
+        });
+    return detector;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file H264SpsParser.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "H264SpsParser.h"
+
+#include "../Rtp/H264Rtp.h"
+#include "../Rtp/RtpPacket.h"
+#include "../Utilities/H264NalScanner.h"
+
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief
+     *  Reads bits and Exp-Golomb codes from an RBSP. Reading past the end yields zeros and
+     *  marks the reader as overrun rather than throwing, so callers check once at the end.
+     */
+    class BitReader
+    {
+    public:
+        BitReader(std::span<const uint8_t> bytes) : bytes(bytes)
+        { }
+
+        uint32_t ReadBits(uint8_t count)
+        {
+            uint32_t value = 0;
+            for (uint8_t i = 0; i < count; ++i)
+            {
+                value = (value << 1) | ReadBit();
+            }
+            return value;
+        }
+
+        uint32_t ReadBit()
+        {
+            if (bitPosition >= (bytes.size() * 8))
+            {
+                isOverrun = true;
+                return 0;
+            }
+            uint8_t byte = bytes[bitPosition / 8];
+            uint32_t bit = (byte >> (7 - (bitPosition % 8))) & 0b1;
+            ++bitPosition;
+            return bit;
+        }
+
+        // ue(v)
+        uint32_t ReadUnsignedExpGolomb()
+        {
+            uint8_t leadingZeros = 0;
+            while (ReadBit() == 0)
+            {
+                if (isOverrun || (++leadingZeros > 31))
+                {
+                    isOverrun = true;
+                    return 0;
+                }
+            }
+            return ((1u << leadingZeros) - 1) + ReadBits(leadingZeros);
+        }
+
+        // se(v)
+        int32_t ReadSignedExpGolomb()
+        {
+            uint32_t codeNum = ReadUnsignedExpGolomb();
+            int32_t magnitude = static_cast<int32_t>((codeNum + 1) / 2);
+            return ((codeNum % 2) == 1) ? magnitude : -magnitude;
+        }
+
+        bool IsOverrun() const
+        {
+            return isOverrun;
+        }
+
+    private:
+        std::span<const uint8_t> bytes;
+        size_t bitPosition = 0;
+        bool isOverrun = false;
+    };
+
+    void skipScalingList(BitReader& reader, size_t size)
+    {
+        int32_t lastScale = 8;
+        int32_t nextScale = 8;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (nextScale != 0)
+            {
+                int32_t deltaScale = reader.ReadSignedExpGolomb();
+                nextScale = (lastScale + deltaScale + 256) % 256;
+            }
+            lastScale = (nextScale == 0) ? lastScale : nextScale;
+        }
+    }
+
+    bool hasChromaFormatInfo(uint8_t profileIdc)
+    {
+        switch (profileIdc)
+        {
+        case 100: case 110: case 122: case 244: case 44: case 83: case 86: case 118: case 128:
+        case 138: case 139: case 134: case 135:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+#pragma region Static methods
+Result<VideoParameters> H264SpsParser::Parse(std::span<const std::byte> nalUnit)
+{
+    if (nalUnit.size() < 4)
+    {
+        return Result<VideoParameters>::Error("SPS is too short");
+    }
+    if ((static_cast<uint8_t>(nalUnit[0]) & 0b00011111) != NAL_TYPE_SPS)
+    {
+        return Result<VideoParameters>::Error("NAL unit is not an SPS");
+    }
+
+    // Strip emulation prevention bytes (00 00 03 -> 00 00) to get at the raw bitstream
+    std::vector<uint8_t> rbsp;
+    H264NalScanner::AppendUnescaped(nalUnit.subspan(1), rbsp);
+
+    BitReader reader(rbsp);
+    VideoParameters parameters;
+    parameters.ProfileIdc = reader.ReadBits(8);
+    reader.ReadBits(8); // constraint_set flags and reserved_zero_2bits
+    parameters.LevelIdc = reader.ReadBits(8);
+    reader.ReadUnsignedExpGolomb(); // seq_parameter_set_id
+
+    uint32_t chromaFormatIdc = 1;
+    bool separateColourPlane = false;
+    if (hasChromaFormatInfo(parameters.ProfileIdc))
+    {
+        chromaFormatIdc = reader.ReadUnsignedExpGolomb();
+        if (chromaFormatIdc == 3)
+        {
+            separateColourPlane = reader.ReadBit();
+        }
+        reader.ReadUnsignedExpGolomb(); // bit_depth_luma_minus8
+        reader.ReadUnsignedExpGolomb(); // bit_depth_chroma_minus8
+        reader.ReadBit(); // qpprime_y_zero_transform_bypass_flag
+        if (reader.ReadBit()) // seq_scaling_matrix_present_flag
+        {
+            const size_t numScalingLists = (chromaFormatIdc != 3) ? 8 : 12;
+            for (size_t i = 0; i < numScalingLists; ++i)
+            {
+                if (reader.ReadBit()) // seq_scaling_list_present_flag
+                {
+                    skipScalingList(reader, (i < 6) ? 16 : 64);
+                }
+            }
+        }
+    }
+
+    reader.ReadUnsignedExpGolomb(); // log2_max_frame_num_minus4
+    uint32_t picOrderCntType = reader.ReadUnsignedExpGolomb();
+    if (picOrderCntType == 0)
+    {
+        reader.ReadUnsignedExpGolomb(); // log2_max_pic_order_cnt_lsb_minus4
+    }
+    else if (picOrderCntType == 1)
+    {
+        reader.ReadBit(); // delta_pic_order_always_zero_flag
+        reader.ReadSignedExpGolomb(); // offset_for_non_ref_pic
+        reader.ReadSignedExpGolomb(); // offset_for_top_to_bottom_field
+        uint32_t numRefFramesInPicOrderCntCycle = reader.ReadUnsignedExpGolomb();
+        for (uint32_t i = 0; (i < numRefFramesInPicOrderCntCycle) && !reader.IsOverrun(); ++i)
+        {
+            reader.ReadSignedExpGolomb(); // offset_for_ref_frame
+        }
+    }
+    reader.ReadUnsignedExpGolomb(); // max_num_ref_frames
+    reader.ReadBit(); // gaps_in_frame_num_value_allowed_flag
+
+    uint32_t picWidthInMbs = reader.ReadUnsignedExpGolomb() + 1;
+    uint32_t picHeightInMapUnits = reader.ReadUnsignedExpGolomb() + 1;
+    uint32_t frameMbsOnly = reader.ReadBit();
+    if (!frameMbsOnly)
+    {
+        reader.ReadBit(); // mb_adaptive_frame_field_flag
+    }
+    reader.ReadBit(); // direct_8x8_inference_flag
+
+    uint32_t cropLeft = 0, cropRight = 0, cropTop = 0, cropBottom = 0;
+    if (reader.ReadBit()) // frame_cropping_flag
+    {
+        cropLeft = reader.ReadUnsignedExpGolomb();
+        cropRight = reader.ReadUnsignedExpGolomb();
+        cropTop = reader.ReadUnsignedExpGolomb();
+        cropBottom = reader.ReadUnsignedExpGolomb();
+    }
+
+    if (reader.ReadBit()) // vui_parameters_present_flag
+    {
+        if (reader.ReadBit()) // aspect_ratio_info_present_flag
+        {
+            constexpr uint32_t EXTENDED_SAR = 255;
+            if (reader.ReadBits(8) == EXTENDED_SAR)
+            {
+                reader.ReadBits(16); // sar_width
+                reader.ReadBits(16); // sar_height
+            }
+        }
+        if (reader.ReadBit()) // overscan_info_present_flag
+        {
+            reader.ReadBit(); // overscan_appropriate_flag
+        }
+        if (reader.ReadBit()) // video_signal_type_present_flag
+        {
+            reader.ReadBits(3); // video_format
+            reader.ReadBit(); // video_full_range_flag
+            if (reader.ReadBit()) // colour_description_present_flag
+            {
+                reader.ReadBits(24); // colour_primaries, transfer and matrix coefficients
+            }
+        }
+        if (reader.ReadBit()) // chroma_loc_info_present_flag
+        {
+            reader.ReadUnsignedExpGolomb(); // chroma_sample_loc_type_top_field
+            reader.ReadUnsignedExpGolomb(); // chroma_sample_loc_type_bottom_field
+        }
+        if (reader.ReadBit()) // timing_info_present_flag
+        {
+            uint32_t numUnitsInTick = reader.ReadBits(32);
+            uint32_t timeScale = reader.ReadBits(32);
+            // Each frame is two ticks, one per field
+            if ((numUnitsInTick > 0) && (timeScale > 0) && !reader.IsOverrun())
+            {
+                parameters.FrameRate = static_cast<double>(timeScale) / (2.0 * numUnitsInTick);
+            }
+        }
+    }
+
+    if (reader.IsOverrun())
+    {
+        return Result<VideoParameters>::Error("SPS ended unexpectedly");
+    }
+
+    // Cropping is measured in chroma samples, and in field pairs for interlaced video
+    const uint32_t frameHeightMultiplier = 2 - frameMbsOnly;
+    uint32_t cropUnitX = 1;
+    uint32_t cropUnitY = frameHeightMultiplier;
+    if ((chromaFormatIdc != 0) && !separateColourPlane)
+    {
+        const uint32_t subWidthChroma = (chromaFormatIdc == 3) ? 1 : 2;
+        const uint32_t subHeightChroma = (chromaFormatIdc == 1) ? 2 : 1;
+        cropUnitX = subWidthChroma;
+        cropUnitY = subHeightChroma * frameHeightMultiplier;
+    }
+
+    // Hostile streams can send sizes that would wrap in 32 bits and come out looking sensible
+    const uint64_t width = static_cast<uint64_t>(picWidthInMbs) * 16;
+    const uint64_t height = static_cast<uint64_t>(frameHeightMultiplier) * picHeightInMapUnits * 16;
+    const uint64_t cropWidth =
+        static_cast<uint64_t>(cropUnitX) * (static_cast<uint64_t>(cropLeft) + cropRight);
+    const uint64_t cropHeight =
+        static_cast<uint64_t>(cropUnitY) * (static_cast<uint64_t>(cropTop) + cropBottom);
+    if ((cropWidth >= width) || (cropHeight >= height) ||
+        ((width - cropWidth) > UINT16_MAX) || ((height - cropHeight) > UINT16_MAX))
+    {
+        return Result<VideoParameters>::Error("SPS describes invalid frame dimensions");
+    }
+    parameters.Width = width - cropWidth;
+    parameters.Height = height - cropHeight;
+
+    return Result<VideoParameters>::Success(parameters);
+}
+
+Result<VideoParameters> H264SpsParser::ParseFromRtpPackets(const std::list<PacketBuffer>& packets)
+{
+    for (const auto& packet : packets)
+    {
+        // The SPS may be sent on its own or aggregated with the PPS
+        std::span<const std::byte> spsNalUnit;
+        H264Rtp::ForEachNalUnit(RtpPacket::GetRtpPayload(packet),
+            [&spsNalUnit](std::span<const std::byte> nalUnit)
+            {
+                if (spsNalUnit.empty() && (H264Rtp::NalType(nalUnit[0]) == NAL_TYPE_SPS))
+                {
+                    spsNalUnit = nalUnit;
+                }
+            });
+        if (!spsNalUnit.empty())
+        {
+            return Parse(spsNalUnit);
+        }
+    }
+    return Result<VideoParameters>::Error("No SPS found");
+}
+#pragma endregion Static methods
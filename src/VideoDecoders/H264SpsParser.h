@@ -0,0 +1,40 @@
+/**
+ * @file H264SpsParser.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../Utilities/FtlTypes.h"
+#include "../Utilities/Result.h"
+
+#include <cstddef>
+#include <list>
+#include <span>
+
+/**
+ * @brief
+ *  Reads video properties out of H264 Sequence Parameter Sets (ITU-T H.264 7.3.2.1) without
+ *  decoding any video, so stream dimensions are available as soon as an SPS arrives.
+ */
+class H264SpsParser
+{
+public:
+    /* Constants */
+    static constexpr uint8_t NAL_TYPE_SPS = 7;
+
+    /* Static methods */
+    /**
+     * @brief Parses a single SPS NAL unit, including its one-byte NAL header
+     */
+    static Result<VideoParameters> Parse(std::span<const std::byte> nalUnit);
+
+    /**
+     * @brief
+     *  Finds and parses the first SPS carried un-fragmented (alone or in a STAP-A) in the given
+     *  RTP packets, as captured for a keyframe.
+     */
+    static Result<VideoParameters> ParseFromRtpPackets(const std::list<PacketBuffer>& packets);
+};
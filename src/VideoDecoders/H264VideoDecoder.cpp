@@ -10,96 +10,266 @@
 
 #include "H264VideoDecoder.h"
 
+#include "H264SpsParser.h"
+#include "../Rtp/H264Rtp.h"
 #include "../Rtp/RtpPacket.h"
 
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+extern "C"
+{
+    #include <libavutil/hwcontext.h>
+}
+
+#pragma region Constructor/Destructor
+H264VideoDecoder::H264VideoDecoder(JpegOptions jpegOptions, std::string hardwareDeviceType)
+:
+    jpegOptions(jpegOptions),
+    hardwareDeviceType(std::move(hardwareDeviceType))
+{ }
+#pragma endregion Constructor/Destructor
+
 #pragma region PreviewGenerator
+VideoDecoder::DecodedKeyframe H264VideoDecoder::DecodeKeyframe(
+    const std::list<PacketBuffer>& keyframePackets)
+{
+    const AVFrame* frame = readFrame(keyframePackets);
+
+    DecodedKeyframe decoded
+    {
+        .Width = static_cast<uint16_t>(frame->width),
+        .Height = static_cast<uint16_t>(frame->height),
+    };
+    decoded.JpegBytes = encodeToJpeg(frame);
+    return decoded;
+}
+
 std::vector<uint8_t> H264VideoDecoder::GenerateJpegImage(
-    const std::list<std::vector<std::byte>>& keyframePackets)
+    const std::list<PacketBuffer>& keyframePackets)
 {
-    AVFramePtr frame = readFramePtr(keyframePackets);
+    const AVFrame* frame = readFrame(keyframePackets);
 
     // Now encode it to a JPEG
-    std::vector<uint8_t> returnVal = encodeToJpeg(std::move(frame));
-    return returnVal;
+    return encodeToJpeg(frame);
 }
 
 std::pair<uint16_t, uint16_t> H264VideoDecoder::ReadVideoDimensions(
-    const std::list<std::vector<std::byte>>& keyframePackets)
+    const std::list<PacketBuffer>& keyframePackets)
 {
-    AVFramePtr frame = readFramePtr(keyframePackets);
+    // The SPS tells us the dimensions without having to decode anything
+    Result<VideoParameters> parameters = H264SpsParser::ParseFromRtpPackets(keyframePackets);
+    if (!parameters.IsError)
+    {
+        return std::make_pair(parameters.Value.Width, parameters.Value.Height);
+    }
+
+    const AVFrame* frame = readFrame(keyframePackets);
     return std::make_pair(frame->width, frame->height);
 }
 #pragma endregion
 
 #pragma region Private methods
-AVFramePtr H264VideoDecoder::readFramePtr(
-    const std::list<std::vector<std::byte>>& keyframePackets)
+const AVFrame* H264VideoDecoder::readFrame(
+    const std::list<PacketBuffer>& keyframePackets)
 {
-    std::vector<char> keyframeDataBuffer;
-
-    // We need to shove all of the keyframe NAL units into a buffer to feed into libav
+    // Work out exactly how large the Annex B bitstream will be, so it can be written straight
+    // into a single buffer that libav can take a reference to
+    size_t bitstreamSize = 0;
     for (const auto& packet : keyframePackets)
     {
-        // Grab the payload out of the RTP packet
-        const std::span<const std::byte> payload = RtpPacket::GetRtpPayload(packet);
-        if (payload.size() < 2)
+        bitstreamSize += H264Rtp::AnnexBSize(RtpPacket::GetRtpPayload(packet));
+    }
+    if (bitstreamSize == 0)
+    {
+        throw PreviewGenerationFailedException("Keyframe contains no NAL units.");
+    }
+
+    // The decoder may hold on to the previous buffer, in which case we need a new one
+    const size_t bufferSize = bitstreamSize + AV_INPUT_BUFFER_PADDING_SIZE;
+    if ((keyframeBuffer == nullptr) || (keyframeBuffer->size < bufferSize) ||
+        !av_buffer_is_writable(keyframeBuffer.get()))
+    {
+        keyframeBuffer.reset(av_buffer_alloc(bufferSize));
+        if (keyframeBuffer == nullptr)
         {
-            // Invalid packet payload
-            continue;
+            throw PreviewGenerationFailedException("Could not allocate keyframe buffer!");
         }
+    }
+
+    std::span<std::byte> output(reinterpret_cast<std::byte*>(keyframeBuffer->data), bufferSize);
+    size_t offset = 0;
+    for (const auto& packet : keyframePackets)
+    {
+        offset += H264Rtp::WriteAnnexB(RtpPacket::GetRtpPayload(packet), output.subspan(offset));
+    }
+    std::fill(output.begin() + offset, output.end(), std::byte(0));
 
-        // Parse out H264 packet data
-        uint8_t fragmentType = static_cast<uint8_t>(payload[0]) & 0b00011111; // 0x1F
-        // uint8_t nalType      = *(payload+1) & 0b00011111; // 0x1F
-        uint8_t startBit = static_cast<uint8_t>(payload[1]) & 0b10000000; // 0x80
-        // uint8_t endBit       = *(payload+1) & 0b01000000; // 0x40
+    // Decode time
+    AVCodecContext* context = prepareDecoderContext();
+    if (decoderPacket == nullptr)
+    {
+        decoderPacket.reset(av_packet_alloc());
+        decodedFrame.reset(av_frame_alloc());
+    }
 
-        // For fragmented types, start bits are special, they have some extra data in the NAL header
-        // that we need to include.
-        if (fragmentType == 28)
+    av_packet_unref(decoderPacket.get());
+    decoderPacket->buf = av_buffer_ref(keyframeBuffer.get());
+    if (decoderPacket->buf == nullptr)
+    {
+        throw PreviewGenerationFailedException("Could not reference keyframe buffer!");
+    }
+    decoderPacket->data = keyframeBuffer->data;
+    decoderPacket->size = bitstreamSize;
+    decoderPacket->flags |= AV_PKT_FLAG_KEY;
+
+    // So let's decode this packet.
+    int ret = avcodec_send_packet(context, decoderPacket.get());
+    av_packet_unref(decoderPacket.get());
+    if (ret < 0)
+    {
+        decoderContext.reset();
+        throw PreviewGenerationFailedException("Error sending a packet for decoding.");
+    }
+
+    // Receive the decoded frame
+    ret = avcodec_receive_frame(context, decodedFrame.get());
+    if (ret < 0)
+    {
+        decoderContext.reset();
+        throw PreviewGenerationFailedException("Error receiving decoded frame.");
+    }
+
+    // Frames decoded on a hardware device live in device memory until we download them
+    if ((hardwarePixelFormat != AV_PIX_FMT_NONE) && (decodedFrame->format == hardwarePixelFormat))
+    {
+        if (downloadedFrame == nullptr)
         {
-            if (startBit)
-            {
-                // Write the start code
-                keyframeDataBuffer.push_back(0x00);
-                keyframeDataBuffer.push_back(0x00);
-                keyframeDataBuffer.push_back(0x01);
-
-                // Write the re-constructed header
-                char firstByte = (static_cast<uint8_t>(payload[0]) & 0b11100000) |
-                    (static_cast<uint8_t>(payload[1]) & 0b00011111);
-                keyframeDataBuffer.push_back(firstByte);
-            }
+            downloadedFrame.reset(av_frame_alloc());
+        }
+        av_frame_unref(downloadedFrame.get());
+        if (av_hwframe_transfer_data(downloadedFrame.get(), decodedFrame.get(), 0) < 0)
+        {
+            decoderContext.reset();
+            disableHardwareDecoding("could not download decoded frame");
+            throw PreviewGenerationFailedException("Error downloading decoded frame.");
+        }
+        return downloadedFrame.get();
+    }
 
-            // Write the rest of the payload
-            for (size_t i = 2; i < payload.size(); ++i)
-            {
-                keyframeDataBuffer.push_back(static_cast<char>(payload[i]));
-            }
+    return decodedFrame.get();
+}
+
+std::vector<uint8_t> H264VideoDecoder::encodeToJpeg(const AVFrame* decodedFrame)
+{
+    const AVFrame* frame = scaleFrame(decodedFrame);
+    AVCodecContext* context = prepareJpegContext(frame);
+    if (jpegPacket == nullptr)
+    {
+        jpegPacket.reset(av_packet_alloc());
+    }
+
+    int ret = avcodec_send_frame(context, frame);
+    if (ret < 0)
+    {
+        jpegContext.reset();
+        throw PreviewGenerationFailedException("Error sending frame to jpeg codec!");
+    }
+
+    ret = avcodec_receive_packet(context, jpegPacket.get());
+    if (ret < 0)
+    {
+        jpegContext.reset();
+        throw PreviewGenerationFailedException("Error receiving jpeg packet!");
+    }
+
+    std::vector<uint8_t> returnVal(jpegPacket->data, jpegPacket->data + jpegPacket->size);
+    av_packet_unref(jpegPacket.get());
+    return returnVal;
+}
+
+const AVFrame* H264VideoDecoder::scaleFrame(const AVFrame* frame)
+{
+    const auto [width, height] = previewSize(frame->width, frame->height);
+    if ((scaledFrame == nullptr) || (scaledFrame->width != width) ||
+        (scaledFrame->height != height))
+    {
+        scaledFrame.reset(av_frame_alloc());
+        if (scaledFrame == nullptr)
+        {
+            throw PreviewGenerationFailedException("Could not allocate scaled frame!");
         }
-        else
+        scaledFrame->format = AV_PIX_FMT_YUVJ420P;
+        scaledFrame->width = width;
+        scaledFrame->height = height;
+        if (av_frame_get_buffer(scaledFrame.get(), 0) < 0)
         {
-            // Write the start code
-            keyframeDataBuffer.push_back(0x00);
-            keyframeDataBuffer.push_back(0x00);
-            keyframeDataBuffer.push_back(0x01);
+            scaledFrame.reset();
+            throw PreviewGenerationFailedException("Could not allocate scaled frame buffer!");
+        }
+    }
+    else if (av_frame_make_writable(scaledFrame.get()) < 0)
+    {
+        throw PreviewGenerationFailedException("Could not make scaled frame writable!");
+    }
 
-            // Write the rest of the payload
-            for (size_t i = 0; i < payload.size(); ++i)
-            {
-                keyframeDataBuffer.push_back(static_cast<char>(payload[i]));
-            }
+    const ScaleSource source { frame->width, frame->height, frame->format };
+    auto contextIt = scaleContexts.find(source);
+    if (contextIt == scaleContexts.end())
+    {
+        if (scaleContexts.size() >= MAX_SCALE_CONTEXTS)
+        {
+            scaleContexts.clear();
+        }
+        SwsContextPtr context(sws_getContext(
+            frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+            width, height, AV_PIX_FMT_YUVJ420P,
+            SWS_BILINEAR, nullptr, nullptr, nullptr));
+        if (context == nullptr)
+        {
+            throw PreviewGenerationFailedException("Could not create scaling context!");
         }
+        contextIt = scaleContexts.emplace(source, std::move(context)).first;
+    }
 
+    sws_scale(contextIt->second.get(), frame->data, frame->linesize, 0, frame->height,
+        scaledFrame->data, scaledFrame->linesize);
+    if (jpegOptions.Quality > 0)
+    {
+        scaledFrame->quality = FF_QP2LAMBDA * jpegOptions.Quality;
     }
+    return scaledFrame.get();
+}
 
-    // Decode time
-    const AVCodec* codec;
-    AVFramePtr frame(av_frame_alloc());
-    AVPacketPtr packet(av_packet_alloc());
-    int ret;
+std::pair<int, int> H264VideoDecoder::previewSize(int width, int height) const
+{
+    // Only ever scale down, keeping the aspect ratio
+    double scale = 1.0;
+    if ((jpegOptions.MaxWidth > 0) && (width > jpegOptions.MaxWidth))
+    {
+        scale = std::min(scale, static_cast<double>(jpegOptions.MaxWidth) / width);
+    }
+    if ((jpegOptions.MaxHeight > 0) && (height > jpegOptions.MaxHeight))
+    {
+        scale = std::min(scale, static_cast<double>(jpegOptions.MaxHeight) / height);
+    }
+
+    // 4:2:0 chroma needs even dimensions
+    int scaledWidth = std::max(2, static_cast<int>(width * scale) & ~1);
+    int scaledHeight = std::max(2, static_cast<int>(height * scale) & ~1);
+    return std::make_pair(scaledWidth, scaledHeight);
+}
 
-    codec = avcodec_find_decoder(AV_CODEC_ID_H264);
+AVCodecContext* H264VideoDecoder::prepareDecoderContext()
+{
+    if (decoderContext != nullptr)
+    {
+        // Forget anything left over from the previous keyframe
+        avcodec_flush_buffers(decoderContext.get());
+        return decoderContext.get();
+    }
+
+    const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_H264);
     if (!codec)
     {
         throw PreviewGenerationFailedException("Could not find H264 codec!");
@@ -111,75 +281,139 @@ AVFramePtr H264VideoDecoder::readFramePtr(
         throw PreviewGenerationFailedException("Could not allocate video codec context!");
     }
 
+    const bool isHardwareDecoding = prepareHardwareDecoding(codec, context.get());
     if (avcodec_open2(context.get(), codec, nullptr) < 0)
     {
-        throw PreviewGenerationFailedException("Could not open codec!");
+        if (!isHardwareDecoding)
+        {
+            throw PreviewGenerationFailedException("Could not open codec!");
+        }
+
+        // Try again in software
+        disableHardwareDecoding("could not open codec");
+        return prepareDecoderContext();
     }
 
-    av_init_packet(packet.get());
-    packet->data = reinterpret_cast<uint8_t*>(keyframeDataBuffer.data());
-    packet->size = keyframeDataBuffer.size();
-    packet->flags |= AV_PKT_FLAG_KEY;
+    decoderContext = std::move(context);
+    return decoderContext.get();
+}
 
-    // So let's decode this packet.
-    ret = avcodec_send_packet(context.get(), packet.get());
-    if (ret < 0)
+bool H264VideoDecoder::prepareHardwareDecoding(const AVCodec* codec, AVCodecContext* context)
+{
+    if (hardwareDeviceType.empty())
     {
-        throw PreviewGenerationFailedException("Error sending a packet for decoding.");
+        return false;
     }
 
-    // Receive the decoded frame
-    ret = avcodec_receive_frame(context.get(), frame.get());
-    if (ret < 0)
+    if (hardwareDevice == nullptr)
     {
-        throw PreviewGenerationFailedException("Error receiving decoded frame.");
+        AVHWDeviceType deviceType = av_hwdevice_find_type_by_name(hardwareDeviceType.c_str());
+        if (deviceType == AV_HWDEVICE_TYPE_NONE)
+        {
+            disableHardwareDecoding("unknown device type");
+            return false;
+        }
+
+        for (int i = 0; const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i); ++i)
+        {
+            if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+                (config->device_type == deviceType))
+            {
+                hardwarePixelFormat = config->pix_fmt;
+                break;
+            }
+        }
+        if (hardwarePixelFormat == AV_PIX_FMT_NONE)
+        {
+            disableHardwareDecoding("H264 decoder does not support this device");
+            return false;
+        }
+
+        AVBufferRef* device = nullptr;
+        if (av_hwdevice_ctx_create(&device, deviceType, nullptr, nullptr, 0) < 0)
+        {
+            disableHardwareDecoding("could not create device");
+            return false;
+        }
+        hardwareDevice.reset(device);
     }
 
-    return frame;
+    context->hw_device_ctx = av_buffer_ref(hardwareDevice.get());
+    if (context->hw_device_ctx == nullptr)
+    {
+        disableHardwareDecoding("could not reference device");
+        return false;
+    }
+    context->opaque = this;
+    context->get_format = &H264VideoDecoder::selectHardwarePixelFormat;
+    return true;
 }
 
-std::vector<uint8_t> H264VideoDecoder::encodeToJpeg(AVFramePtr frame)
+void H264VideoDecoder::disableHardwareDecoding(const std::string& reason)
 {
-    int ret;
-    const AVCodec* jpegCodec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
-    AVPacketPtr jpegPacket(av_packet_alloc());
-    av_init_packet(jpegPacket.get());
-    if (!jpegCodec)
+    spdlog::warn("Hardware decoding with {} is unavailable ({}), decoding thumbnails in "
+        "software", hardwareDeviceType, reason);
+    hardwareDeviceType.clear();
+    hardwareDevice.reset();
+    hardwarePixelFormat = AV_PIX_FMT_NONE;
+}
+
+AVPixelFormat H264VideoDecoder::selectHardwarePixelFormat(AVCodecContext* context,
+    const AVPixelFormat* formats)
+{
+    auto decoder = static_cast<const H264VideoDecoder*>(context->opaque);
+    for (const AVPixelFormat* format = formats; *format != AV_PIX_FMT_NONE; ++format)
     {
-        throw PreviewGenerationFailedException("Could not find mjpeg codec!");
+        if (*format == decoder->hardwarePixelFormat)
+        {
+            return *format;
+        }
     }
 
-    AVCodecContextPtr jpegCodecContext(avcodec_alloc_context3(jpegCodec));
-    if (jpegCodecContext.get() == nullptr)
+    // The device can't handle this stream, let libavcodec pick a software format
+    return avcodec_default_get_format(context, formats);
+}
+
+AVCodecContext* H264VideoDecoder::prepareJpegContext(const AVFrame* frame)
+{
+    if ((jpegContext != nullptr) &&
+        (jpegContext->width == frame->width) &&
+        (jpegContext->height == frame->height))
     {
-        throw PreviewGenerationFailedException("Failed to allocated mjpeg codec context!");
+        return jpegContext.get();
     }
+    jpegContext.reset();
 
-    jpegCodecContext->pix_fmt       = AV_PIX_FMT_YUVJ420P;
-    jpegCodecContext->height        = frame->height;
-    jpegCodecContext->width         = frame->width;
-    jpegCodecContext->time_base.num = 1;
-    jpegCodecContext->time_base.den = 1000000;
+    const AVCodec* jpegCodec = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+    if (!jpegCodec)
+    {
+        throw PreviewGenerationFailedException("Could not find mjpeg codec!");
+    }
 
-    ret = avcodec_open2(jpegCodecContext.get(), jpegCodec, nullptr);
-    if (ret < 0)
+    AVCodecContextPtr context(avcodec_alloc_context3(jpegCodec));
+    if (context.get() == nullptr)
     {
-        throw PreviewGenerationFailedException("Couldn't open mjpeg codec!");
+        throw PreviewGenerationFailedException("Failed to allocated mjpeg codec context!");
     }
 
-    ret = avcodec_send_frame(jpegCodecContext.get(), frame.get());
-    if (ret < 0)
+    context->pix_fmt       = AV_PIX_FMT_YUVJ420P;
+    context->height        = frame->height;
+    context->width         = frame->width;
+    context->time_base.num = 1;
+    context->time_base.den = 1000000;
+    if (jpegOptions.Quality > 0)
     {
-        throw PreviewGenerationFailedException("Error sending frame to jpeg codec!");
+        // Encode every preview at a fixed quantizer, taken from each frame's quality
+        context->flags |= AV_CODEC_FLAG_QSCALE;
+        context->global_quality = FF_QP2LAMBDA * jpegOptions.Quality;
     }
 
-    ret = avcodec_receive_packet(jpegCodecContext.get(), jpegPacket.get());
-    if (ret < 0)
+    if (avcodec_open2(context.get(), jpegCodec, nullptr) < 0)
     {
-        throw PreviewGenerationFailedException("Error receiving jpeg packet!");
+        throw PreviewGenerationFailedException("Couldn't open mjpeg codec!");
     }
 
-    std::vector<uint8_t> returnVal(jpegPacket->data, jpegPacket->data + jpegPacket->size);
-    return returnVal;
+    jpegContext = std::move(context);
+    return jpegContext.get();
 }
 #pragma endregion
@@ -13,6 +13,11 @@
 #include "VideoDecoder.h"
 #include "../Utilities/FtlTypes.h"
 #include "../Utilities/LibAvCodecPtr.h"
+#include "../Utilities/LibSwScalePtr.h"
+
+#include <map>
+#include <string>
+#include <tuple>
 
 extern "C"
 {
@@ -28,13 +33,72 @@ class H264VideoDecoder :
     public VideoDecoder
 {
 public:
+    /* Constructor/Destructor */
+    /**
+     * @param hardwareDeviceType
+     *  libavutil name of a hardware device to decode with (eg: "vaapi", "cuda"), or empty to
+     *  decode in software. Falls back to software if the device can't be used.
+     */
+    H264VideoDecoder(JpegOptions jpegOptions = {}, std::string hardwareDeviceType = "");
+
     /* VideoDecoder */
+    DecodedKeyframe DecodeKeyframe(const std::list<PacketBuffer>& keyframePackets) override;
     std::pair<uint16_t, uint16_t> ReadVideoDimensions(
-        const std::list<std::vector<std::byte>>& keyframePackets) override;
+        const std::list<PacketBuffer>& keyframePackets) override;
     std::vector<uint8_t> GenerateJpegImage(
-        const std::list<std::vector<std::byte>>& keyframePackets) override;
+        const std::list<PacketBuffer>& keyframePackets) override;
 
 private:
-    AVFramePtr readFramePtr(const std::list<std::vector<std::byte>>& keyframePackets);
-    std::vector<uint8_t> encodeToJpeg(AVFramePtr frame);
+    /* Private types */
+    // Width, height and pixel format of the frames a scaling context was made for
+    using ScaleSource = std::tuple<int, int, int>;
+
+    /* Constants */
+    // Scaling contexts are cached for this many different source formats before being pruned
+    static constexpr size_t MAX_SCALE_CONTEXTS = 8;
+
+    /* Private fields */
+    const JpegOptions jpegOptions;
+    // Cleared if hardware decoding fails, so we don't keep trying
+    std::string hardwareDeviceType;
+    AVBufferRefPtr hardwareDevice;
+    AVPixelFormat hardwarePixelFormat = AV_PIX_FMT_NONE;
+    // Hardware frames are downloaded here before scaling
+    AVFramePtr downloadedFrame;
+    // Reused between keyframes, and rebuilt from scratch after any decoding error
+    AVCodecContextPtr decoderContext;
+    AVPacketPtr decoderPacket;
+    AVFramePtr decodedFrame;
+    // Annex B bitstream the keyframe is assembled into, reused while the decoder isn't using it
+    AVBufferRefPtr keyframeBuffer;
+    // Decoded frames are scaled into a reused frame, with one scaling context per source size
+    std::map<ScaleSource, SwsContextPtr> scaleContexts;
+    AVFramePtr scaledFrame;
+    // Reused until the size of the previews being encoded changes
+    AVCodecContextPtr jpegContext;
+    AVPacketPtr jpegPacket;
+
+    /* Private methods */
+    /**
+     * @brief Decodes the keyframe. The returned frame is valid until the next call.
+     */
+    const AVFrame* readFrame(const std::list<PacketBuffer>& keyframePackets);
+    std::vector<uint8_t> encodeToJpeg(const AVFrame* frame);
+    /**
+     * @brief
+     *  Scales the frame to the preview size in the JPEG encoder's pixel format.
+     *  The returned frame is valid until the next call.
+     */
+    const AVFrame* scaleFrame(const AVFrame* frame);
+    std::pair<int, int> previewSize(int width, int height) const;
+    AVCodecContext* prepareDecoderContext();
+    /**
+     * @brief Sets up the context to decode on the hardware device, if one is configured
+     * @return false if the hardware device can't be used
+     */
+    bool prepareHardwareDecoding(const AVCodec* codec, AVCodecContext* context);
+    void disableHardwareDecoding(const std::string& reason);
+    static AVPixelFormat selectHardwarePixelFormat(AVCodecContext* context,
+        const AVPixelFormat* formats);
+    AVCodecContext* prepareJpegContext(const AVFrame* frame);
 };
@@ -0,0 +1,227 @@
+/**
+ * @file ThumbnailWorkerPool.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "ThumbnailWorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <spdlog/spdlog.h>
+
+#pragma region Constructor/Destructor
+ThumbnailWorkerPool::ThumbnailWorkerPool(
+    std::unordered_map<VideoCodecKind, DecoderFactory> decoderFactories,
+    size_t numWorkers,
+    const std::shared_ptr<MetricsRegistry>& metrics)
+:
+    decoderFactories(std::move(decoderFactories))
+{
+    if (metrics != nullptr)
+    {
+        const std::string help = "Time taken to decode a keyframe for a stream's thumbnail";
+        jpegDecodeDuration = metrics->AddHistogram("ftl_thumbnail_decode_seconds", help,
+            { { "output", "jpeg" } });
+        dimensionsDecodeDuration = metrics->AddHistogram("ftl_thumbnail_decode_seconds", help,
+            { { "output", "dimensions" } });
+    }
+
+    if (numWorkers == 0)
+    {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back(
+            [this](std::stop_token stopToken)
+            {
+                workerThreadBody(stopToken);
+            });
+    }
+
+    spdlog::info("Started thumbnail pool with {} worker threads", workers.size());
+}
+
+ThumbnailWorkerPool::~ThumbnailWorkerPool()
+{
+    for (auto& worker : workers)
+    {
+        worker.request_stop();
+    }
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+bool ThumbnailWorkerPool::Enqueue(Job job)
+{
+    if ((job.Keyframe == nullptr) || !IsCodecSupported(job.Keyframe->Codec))
+    {
+        return false;
+    }
+
+    {
+        std::scoped_lock lock(mutex);
+        auto it = pendingJobs.find(job.StreamId);
+        if (it != pendingJobs.end())
+        {
+            // Newest keyframe wins, but don't lose a pending request for a preview
+            job.GenerateJpeg = (job.GenerateJpeg || it->second.GenerateJpeg);
+            it->second = std::move(job);
+            return true;
+        }
+        if (pendingJobs.size() >= MAX_PENDING_JOBS)
+        {
+            return false;
+        }
+        pendingStreams.push_back(job.StreamId);
+        pendingJobs.emplace(job.StreamId, std::move(job));
+    }
+    jobCondition.notify_one();
+    return true;
+}
+
+std::vector<ThumbnailWorkerPool::JobResult> ThumbnailWorkerPool::CollectResults()
+{
+    std::vector<JobResult> collected;
+    std::scoped_lock lock(mutex);
+    std::swap(collected, results);
+    return collected;
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+bool ThumbnailWorkerPool::IsCodecSupported(VideoCodecKind codec) const
+{
+    return (decoderFactories.count(codec) > 0);
+}
+
+size_t ThumbnailWorkerPool::GetWorkerCount() const
+{
+    return workers.size();
+}
+
+size_t ThumbnailWorkerPool::GetPendingJobCount()
+{
+    std::scoped_lock lock(mutex);
+    return pendingJobs.size();
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void ThumbnailWorkerPool::workerThreadBody(std::stop_token stopToken)
+{
+    // Decoders are owned by a single worker, so they never need to be thread-safe
+    std::unordered_map<VideoCodecKind, std::unique_ptr<VideoDecoder>> decoders;
+    for (const auto& [codec, factory] : decoderFactories)
+    {
+        decoders.try_emplace(codec, factory());
+    }
+
+    std::unique_lock lock(mutex);
+    while (!stopToken.stop_requested())
+    {
+        Job job;
+        if (!jobCondition.wait(lock, stopToken,
+            [this, &job, &lock]() { return takeNextJob(job, lock); }))
+        {
+            break;
+        }
+
+        lock.unlock();
+        const auto startTime = std::chrono::steady_clock::now();
+        JobResult result = runJob(job, decoders);
+        const std::shared_ptr<MetricHistogram>& decodeDuration =
+            job.GenerateJpeg ? jpegDecodeDuration : dimensionsDecodeDuration;
+        if (decodeDuration != nullptr)
+        {
+            decodeDuration->ObserveDuration(std::chrono::steady_clock::now() - startTime);
+        }
+        // Release our reference to the keyframe before going back to sleep
+        job.Keyframe.reset();
+        lock.lock();
+
+        activeStreams.erase(job.StreamId);
+        results.push_back(std::move(result));
+        // A job for this stream may have been held back while we were decoding it
+        if (pendingJobs.count(job.StreamId) > 0)
+        {
+            jobCondition.notify_one();
+        }
+    }
+}
+
+bool ThumbnailWorkerPool::takeNextJob(Job& job, const std::unique_lock<std::mutex>& lock)
+{
+    auto streamIt = std::find_if(pendingStreams.begin(), pendingStreams.end(),
+        [this](const ftl_stream_id_t& streamId)
+        {
+            return (activeStreams.count(streamId) == 0);
+        });
+    if (streamIt == pendingStreams.end())
+    {
+        return false;
+    }
+
+    const ftl_stream_id_t streamId = *streamIt;
+    pendingStreams.erase(streamIt);
+    auto jobIt = pendingJobs.find(streamId);
+    job = std::move(jobIt->second);
+    pendingJobs.erase(jobIt);
+    activeStreams.insert(streamId);
+    return true;
+}
+
+ThumbnailWorkerPool::JobResult ThumbnailWorkerPool::runJob(const Job& job,
+    std::unordered_map<VideoCodecKind, std::unique_ptr<VideoDecoder>>& decoders)
+{
+    JobResult result
+    {
+        .ChannelId = job.ChannelId,
+        .StreamId = job.StreamId,
+        .KeyframeGeneration = job.Keyframe->Generation,
+    };
+
+    auto decoderIt = decoders.find(job.Keyframe->Codec);
+    if ((decoderIt == decoders.end()) || (decoderIt->second == nullptr))
+    {
+        result.ErrorMessage = "No decoder available for codec";
+        return result;
+    }
+    VideoDecoder& decoder = *decoderIt->second;
+
+    try
+    {
+        if (job.GenerateJpeg)
+        {
+            VideoDecoder::DecodedKeyframe decoded = decoder.DecodeKeyframe(job.Keyframe->Packets);
+            result.VideoWidth = decoded.Width;
+            result.VideoHeight = decoded.Height;
+            result.JpegBytes = std::move(decoded.JpegBytes);
+        }
+        else
+        {
+            std::pair<uint16_t, uint16_t> widthHeight =
+                decoder.ReadVideoDimensions(job.Keyframe->Packets);
+            result.VideoWidth = widthHeight.first;
+            result.VideoHeight = widthHeight.second;
+        }
+        result.IsSuccess = true;
+    }
+    catch (const PreviewGenerationFailedException& e)
+    {
+        result.ErrorMessage = e.what();
+    }
+
+    return result;
+}
+#pragma endregion Private methods
@@ -0,0 +1,124 @@
+/**
+ * @file ThumbnailWorkerPool.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "VideoDecoder.h"
+#include "../Utilities/FtlTypes.h"
+#include "../Utilities/Metrics.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief
+ *  A fixed pool of worker threads that decode stream keyframes, reading their dimensions and
+ *  optionally encoding JPEG previews, so this work is kept off the service report thread.
+ *  At most one job is pending per stream; enqueueing a newer keyframe for a stream replaces
+ *  the keyframe of its pending job. A stream is never decoded by two workers at once.
+ */
+class ThumbnailWorkerPool
+{
+public:
+    /* Public types */
+    /**
+     * @brief Creates a decoder for a codec. Each worker creates its own decoders.
+     */
+    using DecoderFactory = std::function<std::unique_ptr<VideoDecoder>()>;
+
+    struct Job
+    {
+        ftl_channel_id_t ChannelId = 0;
+        ftl_stream_id_t StreamId = 0;
+        std::shared_ptr<const FtlKeyframe> Keyframe;
+        // Whether a JPEG preview should be encoded, or only the dimensions read
+        bool GenerateJpeg = false;
+    };
+
+    struct JobResult
+    {
+        ftl_channel_id_t ChannelId = 0;
+        ftl_stream_id_t StreamId = 0;
+        uint64_t KeyframeGeneration = 0;
+        bool IsSuccess = false;
+        // Only set if decoding failed
+        std::string ErrorMessage;
+        uint16_t VideoWidth = 0;
+        uint16_t VideoHeight = 0;
+        // Empty unless a JPEG preview was requested and generated
+        std::vector<uint8_t> JpegBytes;
+    };
+
+    /* Constants */
+    // Jobs for new streams beyond this are rejected rather than queueing without bound
+    static constexpr size_t MAX_PENDING_JOBS = 1024;
+
+    /* Constructor/Destructor */
+    /**
+     * @param decoderFactories factories for each codec that jobs can be decoded for
+     * @param numWorkers number of worker threads, or 0 to use one per hardware thread.
+     * @param metrics where to record how long decoding takes, if anywhere
+     */
+    ThumbnailWorkerPool(
+        std::unordered_map<VideoCodecKind, DecoderFactory> decoderFactories,
+        size_t numWorkers = 0,
+        const std::shared_ptr<MetricsRegistry>& metrics = nullptr);
+    ~ThumbnailWorkerPool();
+
+    /* Public methods */
+    /**
+     * @brief
+     *  Queues a keyframe to be decoded. If a job is already pending for the stream, its
+     *  keyframe is replaced by this one, and a JPEG is generated if either job asked for one.
+     * @return false if the codec is unsupported or too many jobs are already pending
+     */
+    bool Enqueue(Job job);
+
+    /**
+     * @brief Removes and returns the results of all jobs completed since the last call
+     */
+    std::vector<JobResult> CollectResults();
+
+    /* Getters/Setters */
+    bool IsCodecSupported(VideoCodecKind codec) const;
+    size_t GetWorkerCount() const;
+    size_t GetPendingJobCount();
+
+private:
+    /* Private fields */
+    const std::unordered_map<VideoCodecKind, DecoderFactory> decoderFactories;
+    std::mutex mutex;
+    std::condition_variable_any jobCondition;
+    // Streams in the order their pending jobs were first queued
+    std::deque<ftl_stream_id_t> pendingStreams;
+    std::unordered_map<ftl_stream_id_t, Job> pendingJobs;
+    // Streams currently being decoded by a worker
+    std::unordered_set<ftl_stream_id_t> activeStreams;
+    std::vector<JobResult> results;
+    // Null if decode times aren't being recorded
+    std::shared_ptr<MetricHistogram> jpegDecodeDuration;
+    std::shared_ptr<MetricHistogram> dimensionsDecodeDuration;
+    std::vector<std::jthread> workers;
+
+    /* Private methods */
+    void workerThreadBody(std::stop_token stopToken);
+    /**
+     * @brief Removes the oldest pending job whose stream is not already being decoded
+     */
+    bool takeNextJob(Job& job, const std::unique_lock<std::mutex>& lock);
+    JobResult runJob(const Job& job,
+        std::unordered_map<VideoCodecKind, std::unique_ptr<VideoDecoder>>& decoders);
+};
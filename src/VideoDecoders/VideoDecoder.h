@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include "../Utilities/PacketBuffer.h"
+
 #include <cstdint>
 #include <list>
 #include <vector>
@@ -20,16 +22,48 @@ struct Keyframe;
  * @brief
  *  VideoDecoder is a generic interface to decode video streams for various use cases
  *  eg: generating thumbnails, reading video dimensions, etc.
+ *  Implementations keep their codec contexts between calls so they can be reused, so a
+ *  VideoDecoder must only be used by one thread at a time. Give each thread its own instance.
  */
 class VideoDecoder
 {
 public:
+    /* Public types */
+    /**
+     * @brief The results of decoding a single keyframe
+     */
+    struct DecodedKeyframe
+    {
+        uint16_t Width = 0;
+        uint16_t Height = 0;
+        std::vector<uint8_t> JpegBytes;
+    };
+
+    /**
+     * @brief How JPEG previews should be generated
+     */
+    struct JpegOptions
+    {
+        // Previews are scaled down to fit within these dimensions, 0 for no limit
+        uint16_t MaxWidth = 0;
+        uint16_t MaxHeight = 0;
+        // JPEG quantizer from 2 (best) to 31 (smallest), or 0 for the encoder's default
+        uint8_t Quality = 0;
+    };
+
     virtual ~VideoDecoder()
     { }
 
+    /**
+     * @brief
+     *  Decodes the keyframe once, reading its dimensions and encoding a JPEG preview from the
+     *  same decoded frame.
+     */
+    virtual DecodedKeyframe DecodeKeyframe(const std::list<PacketBuffer>& keyframePackets) = 0;
+
     virtual std::pair<uint16_t, uint16_t> ReadVideoDimensions(
-        const std::list<std::vector<std::byte>>& keyframePackets) = 0;
+        const std::list<PacketBuffer>& keyframePackets) = 0;
 
     virtual std::vector<uint8_t> GenerateJpegImage(
-        const std::list<std::vector<std::byte>>& keyframePackets) = 0;
+        const std::list<PacketBuffer>& keyframePackets) = 0;
 };
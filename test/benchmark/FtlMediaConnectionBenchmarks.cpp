@@ -0,0 +1,187 @@
+/**
+ * @file FtlMediaConnectionBenchmarks.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../../src/FtlMediaConnection.h"
+#include "../mocks/MockConnectionTransport.h"
+#include "RtpPacketFactory.h"
+
+namespace
+{
+    constexpr rtp_ssrc_t AUDIO_SSRC = 1234;
+    constexpr rtp_ssrc_t VIDEO_SSRC = 1235;
+    constexpr rtp_payload_type_t AUDIO_PAYLOAD_TYPE = 97;
+    constexpr rtp_payload_type_t VIDEO_PAYLOAD_TYPE = 96;
+    // Packets sent per measured run, about a second of 10Mbps video
+    constexpr size_t PACKETS_PER_RUN = 1024;
+
+    enum class LossPattern
+    {
+        None,
+        // Each packet has a 1% chance of being lost
+        Random,
+        // Runs of 10 packets are lost every 512 packets, like a congested link dropping a burst
+        Burst,
+    };
+
+    /**
+     * @brief
+     *  Feeds video packets to a media connection through a mock transport, and waits for
+     *  every packet that wasn't lost to come out the other end
+     */
+    class MediaConnectionHarness
+    {
+    public:
+        MediaConnectionHarness(bool nackLostPackets)
+        :
+            factory(VIDEO_SSRC, VIDEO_PAYLOAD_TYPE)
+        {
+            auto mockTransport = std::make_unique<MockConnectionTransport>();
+            transport = mockTransport.get();
+            transport->SetOnWrite(
+                [this](const std::span<const std::byte>& bytes)
+                {
+                    nacksSent.fetch_add(1, std::memory_order_relaxed);
+                    return Result<void>::Success();
+                });
+            connection = std::make_unique<FtlMediaConnection>(
+                std::move(mockTransport),
+                MediaMetadata {
+                    .HasVideo = true,
+                    .HasAudio = true,
+                    .VideoCodec = VideoCodecKind::H264,
+                    .AudioCodec = AudioCodecKind::Opus,
+                    .VideoSsrc = VIDEO_SSRC,
+                    .AudioSsrc = AUDIO_SSRC,
+                    .VideoPayloadType = VIDEO_PAYLOAD_TYPE,
+                    .AudioPayloadType = AUDIO_PAYLOAD_TYPE,
+                },
+                1,
+                1,
+                nullptr,
+                [this](const PacketBuffer& packet)
+                {
+                    packetsDelivered.fetch_add(1, std::memory_order_release);
+                },
+                2000,
+                nackLostPackets);
+        }
+
+        /**
+         * @brief Builds the next run of packets, leaving out those the loss pattern drops
+         */
+        std::vector<std::vector<std::byte>> NextRun(LossPattern loss)
+        {
+            std::vector<std::vector<std::byte>> packets;
+            packets.reserve(PACKETS_PER_RUN);
+            for (size_t i = 0; i < PACKETS_PER_RUN; ++i, ++nextSequence)
+            {
+                const bool isLost =
+                    ((loss == LossPattern::Random) && (lossDistribution(random) < 0.01)) ||
+                    ((loss == LossPattern::Burst) && ((nextSequence % 512) >= 502));
+                if (isLost)
+                {
+                    continue;
+                }
+                // A frame every 8 packets, at 90kHz and 60fps
+                packets.push_back(factory.Create(nextSequence, (nextSequence / 8) * 1500,
+                    ((nextSequence % 8) == 7)));
+            }
+            return packets;
+        }
+
+        void Send(const std::vector<std::vector<std::byte>>& packets)
+        {
+            packetsExpected += packets.size();
+            for (const auto& packet : packets)
+            {
+                transport->InjectReceivedBytes(packet);
+            }
+            while (packetsDelivered.load(std::memory_order_acquire) < packetsExpected)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        uint64_t GetNacksSent() const
+        {
+            return nacksSent.load(std::memory_order_relaxed);
+        }
+
+    private:
+        const RtpPacketFactory factory;
+        MockConnectionTransport* transport;
+        std::atomic<uint64_t> packetsDelivered { 0 };
+        std::atomic<uint64_t> nacksSent { 0 };
+        uint64_t packetsExpected = 0;
+        rtp_sequence_num_t nextSequence = 0;
+        std::minstd_rand random { 1234 };
+        std::uniform_real_distribution<double> lossDistribution { 0.0, 1.0 };
+        // Destroyed first, so it stops reading before the rest of the harness goes away
+        std::unique_ptr<FtlMediaConnection> connection;
+    };
+
+    void measureRuns(Catch::Benchmark::Chronometer& meter, MediaConnectionHarness& harness,
+        LossPattern loss)
+    {
+        std::vector<std::vector<std::vector<std::byte>>> runs;
+        for (int i = 0; i < meter.runs(); ++i)
+        {
+            runs.push_back(harness.NextRun(loss));
+        }
+        meter.measure(
+            [&](int i)
+            {
+                harness.Send(runs[i]);
+            });
+    }
+}
+
+TEST_CASE( "FtlMediaConnection packet processing, 1024 packets per run",
+    "[benchmark][media]" )
+{
+    BENCHMARK_ADVANCED("without NACKs")(Catch::Benchmark::Chronometer meter)
+    {
+        MediaConnectionHarness harness(false);
+        measureRuns(meter, harness, LossPattern::None);
+    };
+
+    BENCHMARK_ADVANCED("with NACKs and no loss")(Catch::Benchmark::Chronometer meter)
+    {
+        MediaConnectionHarness harness(true);
+        measureRuns(meter, harness, LossPattern::None);
+    };
+
+    BENCHMARK_ADVANCED("with NACKs and 1% random loss")(Catch::Benchmark::Chronometer meter)
+    {
+        MediaConnectionHarness harness(true);
+        measureRuns(meter, harness, LossPattern::Random);
+    };
+
+    BENCHMARK_ADVANCED("with NACKs and burst loss")(Catch::Benchmark::Chronometer meter)
+    {
+        MediaConnectionHarness harness(true);
+        measureRuns(meter, harness, LossPattern::Burst);
+    };
+}
+
+TEST_CASE( "FtlMediaConnection sends NACKs for synthetic losses", "[benchmark][media]" )
+{
+    // Keeps the benchmarks above honest, by making sure the lossy runs actually NACK something
+    MediaConnectionHarness harness(true);
+    for (int i = 0; i < 4; ++i)
+    {
+        harness.Send(harness.NextRun(LossPattern::Burst));
+    }
+    CHECK(harness.GetNacksSent() > 0);
+}
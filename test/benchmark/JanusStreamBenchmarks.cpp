@@ -0,0 +1,121 @@
+/**
+ * @file JanusStreamBenchmarks.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <fmt/core.h>
+#include <memory>
+#include <vector>
+
+#include "../../src/JanusSession.h"
+#include "../../src/JanusStream.h"
+#include "../mocks/MockJanusCore.h"
+#include "RtpPacketFactory.h"
+
+namespace
+{
+    constexpr rtp_ssrc_t AUDIO_SSRC = 1234;
+    constexpr rtp_ssrc_t VIDEO_SSRC = 1235;
+    constexpr rtp_payload_type_t AUDIO_PAYLOAD_TYPE = 97;
+    constexpr rtp_payload_type_t VIDEO_PAYLOAD_TYPE = 96;
+    // Distinct packets to cycle through, so viewers see sequences move forward
+    constexpr size_t NUM_PACKETS = 1024;
+
+    /**
+     * @brief
+     *  A stream with the given number of started viewers, all relayed to the mock core, the
+     *  last audioOnlyViewerCount of which only want audio
+     */
+    class ViewerHarness
+    {
+    public:
+        ViewerHarness(size_t viewerCount, size_t audioOnlyViewerCount = 0)
+        :
+            handles(viewerCount)
+        {
+            sessions.reserve(viewerCount);
+            for (janus_plugin_session& handle : handles)
+            {
+                handle = core.CreatePluginSession();
+                sessions.push_back(std::make_unique<JanusSession>(&handle, core.GetCallbacks()));
+                sessions.back()->SetIsStarted(true);
+                sessions.back()->SetIsAudioOnly(
+                    (sessions.size() + audioOnlyViewerCount) > viewerCount);
+                stream.AddViewerSession(sessions.back().get());
+            }
+
+            const RtpPacketFactory factory(VIDEO_SSRC, VIDEO_PAYLOAD_TYPE);
+            packets.reserve(NUM_PACKETS);
+            for (rtp_sequence_num_t seq = 0; seq < NUM_PACKETS; ++seq)
+            {
+                packets.push_back(PacketBuffer::Copy(
+                    factory.Create(seq, (seq / 8) * 1500, ((seq % 8) == 7))));
+            }
+        }
+
+        ~ViewerHarness()
+        {
+            stream.RemoveAllViewerSessions();
+        }
+
+        void Send(size_t packetIndex)
+        {
+            stream.SendRtpPacket(packets[packetIndex % packets.size()]);
+        }
+
+    private:
+        MockJanusCore core;
+        std::vector<janus_plugin_session> handles;
+        std::vector<std::unique_ptr<JanusSession>> sessions;
+        std::vector<PacketBuffer> packets;
+        JanusStream stream
+        {
+            1,
+            1,
+            MediaMetadata {
+                .HasVideo = true,
+                .HasAudio = true,
+                .VideoCodec = VideoCodecKind::H264,
+                .AudioCodec = AudioCodecKind::Opus,
+                .VideoSsrc = VIDEO_SSRC,
+                .AudioSsrc = AUDIO_SSRC,
+                .VideoPayloadType = VIDEO_PAYLOAD_TYPE,
+                .AudioPayloadType = AUDIO_PAYLOAD_TYPE,
+            },
+        };
+    };
+}
+
+TEST_CASE( "JanusStream::SendRtpPacket", "[benchmark][janus]" )
+{
+    for (const size_t viewerCount : { 1, 100, 10000 })
+    {
+        ViewerHarness harness(viewerCount);
+        BENCHMARK_ADVANCED(fmt::format("to {} viewers", viewerCount))(
+            Catch::Benchmark::Chronometer meter)
+        {
+            meter.measure(
+                [&](int i)
+                {
+                    harness.Send(i);
+                });
+        };
+    }
+}
+
+TEST_CASE( "JanusStream::SendRtpPacket video with audio-only viewers", "[benchmark][janus]" )
+{
+    // Video shouldn't cost any more than it does for the viewers actually watching it
+    ViewerHarness harness(10100, 10000);
+    BENCHMARK_ADVANCED("to 100 of 10100 viewers")(Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure(
+            [&](int i)
+            {
+                harness.Send(i);
+            });
+    };
+}
@@ -0,0 +1,63 @@
+/**
+ * @file ExtendedSequenceCounterBenchmarks.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+
+#include "../../../src/Rtp/ExtendedSequenceCounter.h"
+
+namespace
+{
+    /**
+     * @brief Sequences counting up from just before a wrap, swapping every tenth pair if asked
+     */
+    std::vector<rtp_sequence_num_t> sequencesFrom(rtp_sequence_num_t first, size_t count,
+        bool isReordered)
+    {
+        std::vector<rtp_sequence_num_t> sequences;
+        sequences.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            sequences.push_back(static_cast<rtp_sequence_num_t>(first + i));
+        }
+        for (size_t i = 0; isReordered && ((i + 1) < count); i += 10)
+        {
+            std::swap(sequences[i], sequences[i + 1]);
+        }
+        return sequences;
+    }
+}
+
+TEST_CASE( "ExtendedSequenceCounter::Extend", "[benchmark][rtp]" )
+{
+    BENCHMARK_ADVANCED("in order")(Catch::Benchmark::Chronometer meter)
+    {
+        ExtendedSequenceCounter counter;
+        const std::vector<rtp_sequence_num_t> sequences =
+            sequencesFrom(65000, meter.runs(), false);
+        rtp_extended_sequence_num_t extendedSeq = 0;
+        meter.measure(
+            [&](int i)
+            {
+                return counter.Extend(sequences[i], &extendedSeq);
+            });
+    };
+
+    BENCHMARK_ADVANCED("with reordering")(Catch::Benchmark::Chronometer meter)
+    {
+        ExtendedSequenceCounter counter;
+        const std::vector<rtp_sequence_num_t> sequences =
+            sequencesFrom(65000, meter.runs(), true);
+        rtp_extended_sequence_num_t extendedSeq = 0;
+        meter.measure(
+            [&](int i)
+            {
+                return counter.Extend(sequences[i], &extendedSeq);
+            });
+    };
+}
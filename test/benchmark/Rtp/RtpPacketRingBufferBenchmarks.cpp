@@ -0,0 +1,80 @@
+/**
+ * @file RtpPacketRingBufferBenchmarks.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <utility>
+#include <vector>
+
+#include "../../../src/Rtp/RtpPacketRingBuffer.h"
+#include "../RtpPacketFactory.h"
+
+namespace
+{
+    // Same size as a media connection's buffer
+    constexpr size_t BUFFER_CAPACITY = 128;
+
+    /**
+     * @brief Packets with consecutive sequences, minus every lossInterval-th one if non-zero
+     */
+    std::vector<RtpPacket> packetsWithLoss(size_t count, size_t lossInterval, bool isReordered)
+    {
+        const RtpPacketFactory factory(1234, 96);
+        std::vector<RtpPacket> packets;
+        packets.reserve(count);
+        for (rtp_extended_sequence_num_t seq = 0; packets.size() < count; ++seq)
+        {
+            if ((lossInterval > 0) && ((seq % lossInterval) == (lossInterval - 1)))
+            {
+                continue;
+            }
+            const auto bytes =
+                factory.Create(static_cast<rtp_sequence_num_t>(seq), 0, false, 0);
+            packets.emplace_back(PacketBuffer::Copy(bytes), seq);
+        }
+        for (size_t i = 0; isReordered && ((i + 1) < packets.size()); i += 10)
+        {
+            std::swap(packets[i], packets[i + 1]);
+        }
+        return packets;
+    }
+}
+
+TEST_CASE( "RtpPacketRingBuffer::Insert", "[benchmark][rtp]" )
+{
+    BENCHMARK_ADVANCED("in order")(Catch::Benchmark::Chronometer meter)
+    {
+        RtpPacketRingBuffer buffer(BUFFER_CAPACITY);
+        const std::vector<RtpPacket> packets = packetsWithLoss(meter.runs(), 0, false);
+        meter.measure(
+            [&](int i)
+            {
+                return buffer.Insert(packets[i]).Count;
+            });
+    };
+
+    BENCHMARK_ADVANCED("with reordering")(Catch::Benchmark::Chronometer meter)
+    {
+        RtpPacketRingBuffer buffer(BUFFER_CAPACITY);
+        const std::vector<RtpPacket> packets = packetsWithLoss(meter.runs(), 0, true);
+        meter.measure(
+            [&](int i)
+            {
+                return buffer.Insert(packets[i]).Count;
+            });
+    };
+
+    BENCHMARK_ADVANCED("with 1% loss")(Catch::Benchmark::Chronometer meter)
+    {
+        RtpPacketRingBuffer buffer(BUFFER_CAPACITY);
+        const std::vector<RtpPacket> packets = packetsWithLoss(meter.runs(), 100, false);
+        meter.measure(
+            [&](int i)
+            {
+                return buffer.Insert(packets[i]).Count;
+            });
+    };
+}
@@ -0,0 +1,61 @@
+/**
+ * @file RtpPacketFactory.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../../src/Rtp/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Builds synthetic RTP packets shaped like the ones FTL clients send
+ */
+class RtpPacketFactory
+{
+public:
+    /* Constants */
+    static constexpr size_t RTP_HEADER_SIZE = 12;
+    // Typical size of a video packet from OBS, which fills each packet up to its MTU
+    static constexpr size_t DEFAULT_PAYLOAD_SIZE = 1200;
+
+    /* Constructor/Destructor */
+    RtpPacketFactory(rtp_ssrc_t ssrc, rtp_payload_type_t payloadType) :
+        ssrc(ssrc),
+        payloadType(payloadType)
+    { }
+
+    /* Public methods */
+    std::vector<std::byte> Create(rtp_sequence_num_t sequence, uint32_t timestamp,
+        bool marker = false, size_t payloadSize = DEFAULT_PAYLOAD_SIZE) const
+    {
+        std::vector<std::byte> bytes(RTP_HEADER_SIZE + payloadSize, std::byte(0));
+        // Version 2, no padding, extensions, or CSRCs
+        bytes[0] = std::byte(0x80);
+        bytes[1] = std::byte((marker ? 0x80 : 0x00) | (payloadType & 0x7F));
+        writeBigEndian(bytes, 2, sequence, 2);
+        writeBigEndian(bytes, 4, timestamp, 4);
+        writeBigEndian(bytes, 8, ssrc, 4);
+        return bytes;
+    }
+
+private:
+    /* Private fields */
+    const rtp_ssrc_t ssrc;
+    const rtp_payload_type_t payloadType;
+
+    /* Private methods */
+    static void writeBigEndian(std::vector<std::byte>& bytes, size_t offset, uint32_t value,
+        size_t numBytes)
+    {
+        for (size_t i = 0; i < numBytes; ++i)
+        {
+            bytes[offset + i] = std::byte((value >> (8 * (numBytes - i - 1))) & 0xFF);
+        }
+    }
+};
@@ -0,0 +1,64 @@
+/**
+ * @file H264NalScannerBenchmarks.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+#include "../../../src/Utilities/H264NalScanner.h"
+
+namespace
+{
+    /**
+     * @brief
+     *  A slice-sized run of bytes with as many lone zeroes as compressed video tends to have,
+     *  but no patterns to find, so every scan reads it end to end
+     */
+    std::vector<std::byte> sliceBytes(size_t size)
+    {
+        std::mt19937 random(1234);
+        std::uniform_int_distribution<int> byteDistribution(0, 255);
+        std::vector<std::byte> bytes(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            const int value = byteDistribution(random);
+            bytes[i] = ((i > 0) && (bytes[i - 1] == std::byte(0)) && (value == 0)) ?
+                std::byte(0x80) : std::byte(value);
+        }
+        return bytes;
+    }
+}
+
+TEST_CASE( "H264NalScanner::FindStartCode", "[benchmark][utilities]" )
+{
+    const std::vector<std::byte> slice = sliceBytes(64 * 1024);
+    WARN( "Vectorized scan uses " << H264NalScanner::GetImplementationName() );
+
+    BENCHMARK( "vectorized, 64KiB" )
+    {
+        return H264NalScanner::FindStartCode(slice);
+    };
+
+    BENCHMARK( "scalar, 64KiB" )
+    {
+        return H264NalScanner::FindZeroZeroScalar(slice, 0, 0x01);
+    };
+}
+
+TEST_CASE( "H264NalScanner::AppendUnescaped", "[benchmark][utilities]" )
+{
+    const std::vector<std::byte> slice = sliceBytes(64 * 1024);
+    std::vector<uint8_t> rbsp;
+    rbsp.reserve(slice.size());
+
+    BENCHMARK( "64KiB" )
+    {
+        rbsp.clear();
+        H264NalScanner::AppendUnescaped(slice, rbsp);
+        return rbsp.size();
+    };
+}
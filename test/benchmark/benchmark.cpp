@@ -0,0 +1,24 @@
+/**
+ * @file benchmark.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+// Some Catch2 defines required for PCH support
+// https://github.com/catchorg/Catch2/blob/v2.x/docs/ci-and-misc.md#precompiled-headers-pchs
+#undef TWOBLUECUBES_SINGLE_INCLUDE_CATCH_HPP_INCLUDED
+#define CATCH_CONFIG_IMPL_ONLY
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+#include <spdlog/spdlog.h>
+
+int main(int argc, char* argv[])
+{
+    // Synthetic loss makes the packet path log a lot, which we don't want to measure
+    spdlog::set_level(spdlog::level::err);
+
+    // Benchmark!
+    int result = Catch::Session().run(argc, argv);
+    return result;
+}
@@ -8,8 +8,10 @@
 #pragma once
 
 #include <list>
+#include <mutex>
 
 #include "../../src/ConnectionTransports/ConnectionTransport.h"
+#include "../../src/Utilities/Util.h"
 
 class MockConnectionTransport : public ConnectionTransport
 {
@@ -17,13 +19,16 @@ public:
     MockConnectionTransport()
     { }
 
+    // Bytes may be injected while another thread is reading them
     void InjectReceivedBytes(const std::vector<std::byte>& bytes)
     {
+        std::scoped_lock lock(receivedBytesMutex);
         receivedBytes.emplace_back(bytes);
     }
     
     void InjectReceivedBytes(const std::string& str)
     {
+        std::scoped_lock lock(receivedBytesMutex);
         receivedBytes.emplace_back(Util::StringToByteVector(str));
     }
 
@@ -48,6 +53,7 @@ public:
 
     Result<ssize_t> Read(std::vector<std::byte>& buffer, std::chrono::milliseconds timeout) override
     {
+        std::scoped_lock lock(receivedBytesMutex);
         if (receivedBytes.empty())
         {
             return Result<ssize_t>::Success(0);
@@ -73,6 +79,7 @@ public:
     }
 
 private:
+    std::mutex receivedBytesMutex;
     std::list<std::vector<std::byte>> receivedBytes;
     std::function<Result<void>(const std::span<const std::byte>& bytes)> onWrite;
 };
\ No newline at end of file
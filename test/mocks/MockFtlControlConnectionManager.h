@@ -23,7 +23,8 @@ public:
         std::function<void(FtlControlConnection*, ftl_channel_id_t)> 
             onControlConnectionRequestedHmacKey,
         std::function<void(FtlControlConnection* connection, ftl_channel_id_t channelId,
-            MediaMetadata mediaMetadata, in_addr targetAddr)> onControlConnectionRequestedMediaPort)
+            MediaMetadata mediaMetadata, IpAddress targetAddr)>
+            onControlConnectionRequestedMediaPort)
     :
         onControlConnectionStopped(onControlConnectionStopped),
         onControlConnectionRequestedHmacKey(onControlConnectionRequestedHmacKey),
@@ -43,7 +44,7 @@ public:
     }
 
     virtual void ControlConnectionRequestedMediaPort(FtlControlConnection* connection,
-        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, in_addr targetAddr)
+        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, IpAddress targetAddr)
     {
         onControlConnectionRequestedMediaPort(connection, channelId, mediaMetadata, targetAddr);
     }
@@ -54,5 +55,5 @@ private:
     std::function<void(FtlControlConnection*, ftl_channel_id_t)> 
         onControlConnectionRequestedHmacKey;
     std::function<void(FtlControlConnection* connection, ftl_channel_id_t channelId,
-        MediaMetadata mediaMetadata, in_addr targetAddr)> onControlConnectionRequestedMediaPort;
+        MediaMetadata mediaMetadata, IpAddress targetAddr)> onControlConnectionRequestedMediaPort;
 };
\ No newline at end of file
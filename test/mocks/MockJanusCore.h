@@ -0,0 +1,80 @@
+/**
+ * @file MockJanusCore.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+extern "C"
+{
+    #include <plugins/plugin.h>
+    #include <utils.h>
+}
+
+/**
+ * @brief
+ *  Stands in for the Janus core, so code that hands packets to Janus can run outside of it.
+ *  Relayed packets are only counted. This also defines the few Janus utility functions the
+ *  plugin calls, so it must only be included by one source file of an executable.
+ */
+class MockJanusCore
+{
+public:
+    /* Constructor/Destructor */
+    MockJanusCore()
+    {
+        callbacks.relay_rtp = &MockJanusCore::relayRtp;
+    }
+
+    /* Public methods */
+    /**
+     * @brief Returns a new plugin session handle that Janus would relay packets for
+     */
+    janus_plugin_session CreatePluginSession()
+    {
+        janus_plugin_session session {};
+        // Packets are only relayed for sessions Janus still has a handle for
+        session.gateway_handle = this;
+        return session;
+    }
+
+    /* Getters/Setters */
+    janus_callbacks* GetCallbacks()
+    {
+        return &callbacks;
+    }
+
+    static uint64_t GetRelayedPacketCount()
+    {
+        return relayedPacketCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    /* Private fields */
+    janus_callbacks callbacks {};
+    static inline std::atomic<uint64_t> relayedPacketCount { 0 };
+
+    /* Private methods */
+    static void relayRtp(janus_plugin_session* handle, janus_plugin_rtp* packet)
+    {
+        relayedPacketCount.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+extern "C"
+{
+    gint64 janus_get_real_time(void)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    void janus_plugin_rtp_extensions_reset(janus_plugin_rtp_extensions* extensions)
+    { }
+}
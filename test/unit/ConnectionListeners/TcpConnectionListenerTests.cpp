@@ -0,0 +1,252 @@
+/**
+ * @file TcpConnectionListenerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "../../../src/ConnectionListeners/ConnectionAdmissionLimiter.h"
+#include "../../../src/ConnectionListeners/TcpConnectionListener.h"
+#include "../../../src/ConnectionTransports/ConnectionTransport.h"
+
+namespace
+{
+    constexpr int TEST_LISTEN_PORT = 28084;
+
+    int connectToListener()
+    {
+        int socketHandle = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = { 0 };
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(TEST_LISTEN_PORT);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        REQUIRE(connect(socketHandle, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        return socketHandle;
+    }
+
+    // Whether the listener has hung up on us
+    bool waitForHangUp(int socketHandle)
+    {
+        pollfd pollFd = { .fd = socketHandle, .events = POLLIN, .revents = 0 };
+        if (poll(&pollFd, 1, 200) <= 0)
+        {
+            return false;
+        }
+        char buffer;
+        return (read(socketHandle, &buffer, 1) <= 0);
+    }
+}
+
+TEST_CASE( "ConnectionAdmissionLimiter limits each address separately", "[connectionlisteners]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    const in_addr_t flooder = htonl(0x0A000001);
+    const in_addr_t streamer = htonl(0x0A000002);
+    ConnectionAdmissionLimiter limiter(1.0, 2);
+
+    CHECK(limiter.TryAdmit(flooder, start));
+    CHECK(limiter.TryAdmit(flooder, start));
+    for (int i = 0; i < 100; ++i)
+    {
+        CHECK_FALSE(limiter.TryAdmit(flooder, start));
+    }
+
+    // Someone else reconnecting at the same time still gets in
+    CHECK(limiter.TryAdmit(streamer, start));
+
+    // And the flooder earns connections back over time
+    CHECK(limiter.TryAdmit(flooder, start + 1s));
+    CHECK_FALSE(limiter.TryAdmit(flooder, start + 1s));
+
+    ConnectionAdmissionLimiter::Stats stats = limiter.GetStats();
+    CHECK(stats.Admitted == 4);
+    CHECK(stats.Rejected == 101);
+    CHECK(stats.TrackedAddresses == 2);
+}
+
+TEST_CASE( "ConnectionAdmissionLimiter keeps IPv4 and IPv6 peers apart", "[connectionlisteners]" )
+{
+    const auto start = std::chrono::steady_clock::now();
+    ConnectionAdmissionLimiter limiter(0.001, 1);
+
+    // A /64 whose bits match an IPv4 address doesn't get to spend that address's connections
+    const in_addr_t victim = htonl(0x0A000001);
+    in6_addr lookalike {};
+    std::memcpy(lookalike.s6_addr, &victim, sizeof(victim));
+    CHECK(limiter.TryAdmit(lookalike, start));
+    CHECK_FALSE(limiter.TryAdmit(lookalike, start));
+    CHECK(limiter.TryAdmit(victim, start));
+
+    // Neither do other /64s that would fold to the same value
+    in6_addr otherPrefix {};
+    std::memcpy(&otherPrefix.s6_addr[4], &victim, sizeof(victim));
+    CHECK(limiter.TryAdmit(otherPrefix, start));
+
+    // Every address in one /64 shares its bucket
+    in6_addr sameSubnet = lookalike;
+    sameSubnet.s6_addr[15] = 0x42;
+    CHECK_FALSE(limiter.TryAdmit(sameSubnet, start));
+
+    // An IPv4 peer on a dual-stack socket is the IPv4 peer we've already seen
+    in6_addr mappedVictim {};
+    REQUIRE(inet_pton(AF_INET6, "::ffff:10.0.0.1", &mappedVictim) == 1);
+    CHECK_FALSE(limiter.TryAdmit(mappedVictim, start));
+    CHECK(limiter.GetStats().TrackedAddresses == 3);
+}
+
+TEST_CASE( "ConnectionAdmissionLimiter forgets idle addresses", "[connectionlisteners]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    ConnectionAdmissionLimiter limiter(1.0, 1);
+    for (in_addr_t addr = 0; addr < ConnectionAdmissionLimiter::MIN_PURGE_SIZE; ++addr)
+    {
+        CHECK(limiter.TryAdmit(addr, start));
+    }
+    CHECK(limiter.GetStats().TrackedAddresses == ConnectionAdmissionLimiter::MIN_PURGE_SIZE);
+
+    // Once everyone's bucket has refilled, they're swept out as new addresses arrive
+    CHECK(limiter.TryAdmit(ConnectionAdmissionLimiter::MIN_PURGE_SIZE, start + 10s));
+    CHECK(limiter.GetStats().TrackedAddresses == 1);
+}
+
+TEST_CASE( "TcpConnectionListener accepts on several sockets and turns away floods",
+    "[connectionlisteners]" )
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ConnectionTransport>> transports;
+    TcpConnectionListener listener(TEST_LISTEN_PORT, SOMAXCONN, 2,
+        std::make_unique<ConnectionAdmissionLimiter>(0.001, 2));
+    listener.SetOnNewConnection(
+        [&mutex, &transports](std::unique_ptr<ConnectionTransport> transport)
+        {
+            std::scoped_lock lock(mutex);
+            transports.push_back(std::move(transport));
+        });
+
+    std::promise<void> readyPromise;
+    std::future<void> readyFuture = readyPromise.get_future();
+    std::thread listenThread(
+        [&listener, &readyPromise]() { listener.Listen(std::move(readyPromise)); });
+    readyFuture.get();
+
+    std::vector<int> clients;
+    for (int i = 0; i < 3; ++i)
+    {
+        clients.push_back(connectToListener());
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        std::scoped_lock lock(mutex);
+        if (transports.size() >= 2)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    {
+        std::scoped_lock lock(mutex);
+        CHECK(transports.size() == 2);
+    }
+
+    // Whichever connection was accepted after the burst ran out is closed right away
+    int numHungUp = 0;
+    for (int client : clients)
+    {
+        numHungUp += waitForHangUp(client) ? 1 : 0;
+    }
+    CHECK(numHungUp == 1);
+
+    listener.StopListening();
+    listenThread.join();
+    for (int client : clients)
+    {
+        close(client);
+    }
+}
+
+TEST_CASE( "TcpConnectionListener accepts IPv4 and IPv6 on a dual-stack address",
+    "[connectionlisteners]" )
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ConnectionTransport>> transports;
+    SocketBinding binding;
+    binding.Address = "::";
+    TcpConnectionListener listener(TEST_LISTEN_PORT, SOMAXCONN, 1, nullptr, {}, binding);
+    listener.SetOnNewConnection(
+        [&mutex, &transports](std::unique_ptr<ConnectionTransport> transport)
+        {
+            std::scoped_lock lock(mutex);
+            transports.push_back(std::move(transport));
+        });
+
+    std::promise<void> readyPromise;
+    std::future<void> readyFuture = readyPromise.get_future();
+    std::thread listenThread(
+        [&listener, &readyPromise]() { listener.Listen(std::move(readyPromise)); });
+    readyFuture.get();
+
+    int ipv4Client = connectToListener();
+    for (int i = 0; i < 100; ++i)
+    {
+        std::scoped_lock lock(mutex);
+        if (transports.size() >= 1)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    int ipv6Client = socket(AF_INET6, SOCK_STREAM, 0);
+    sockaddr_in6 addr = { 0 };
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port = htons(TEST_LISTEN_PORT);
+    addr.sin6_addr = in6addr_loopback;
+    REQUIRE(connect(ipv6Client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    for (int i = 0; i < 100; ++i)
+    {
+        std::scoped_lock lock(mutex);
+        if (transports.size() >= 2)
+        {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    {
+        std::scoped_lock lock(mutex);
+        REQUIRE(transports.size() == 2);
+
+        // IPv4 clients come through with their IPv4 address, rather than a mapped one
+        std::optional<sockaddr_in> ipv4Addr = transports.at(0)->GetAddr();
+        REQUIRE(ipv4Addr.has_value());
+        CHECK(ipv4Addr->sin_addr.s_addr == htonl(INADDR_LOOPBACK));
+        CHECK_FALSE(transports.at(0)->GetAddr6().has_value());
+
+        CHECK_FALSE(transports.at(1)->GetAddr().has_value());
+        std::optional<sockaddr_in6> ipv6Addr = transports.at(1)->GetAddr6();
+        REQUIRE(ipv6Addr.has_value());
+        CHECK(IN6_IS_ADDR_LOOPBACK(&ipv6Addr->sin6_addr));
+    }
+
+    listener.StopListening();
+    listenThread.join();
+    close(ipv4Client);
+    close(ipv6Client);
+}
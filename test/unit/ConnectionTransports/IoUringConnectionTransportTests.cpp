@@ -0,0 +1,279 @@
+/**
+ * @file IoUringConnectionTransportTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../../src/ConnectionTransports/IoUringConnectionTransport.h"
+
+namespace
+{
+    sockaddr_in loopbackAddr(uint32_t hostAddr, uint16_t port = 0)
+    {
+        return sockaddr_in
+        {
+            .sin_family = AF_INET,
+            .sin_port = htons(port),
+            .sin_addr = { .s_addr = htonl(hostAddr) },
+        };
+    }
+
+    int openUdpSocket(const sockaddr_in& addr)
+    {
+        int socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        REQUIRE(socketHandle >= 0);
+        REQUIRE(bind(socketHandle, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+        return socketHandle;
+    }
+
+    sockaddr_in getBoundAddr(int socketHandle)
+    {
+        sockaddr_in addr {};
+        socklen_t addrLength = sizeof(addr);
+        REQUIRE(getsockname(socketHandle, reinterpret_cast<sockaddr*>(&addr), &addrLength) == 0);
+        return addr;
+    }
+
+    void sendTo(int socketHandle, const sockaddr_in& addr, uint8_t value, size_t size = 100)
+    {
+        std::vector<std::byte> payload(size, std::byte { value });
+        REQUIRE(sendto(socketHandle, payload.data(), payload.size(), 0,
+            reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) ==
+            static_cast<ssize_t>(size));
+    }
+}
+
+class IoUringTestFixture
+{
+public:
+    IoUringTestFixture()
+    {
+        receiverHandle = openUdpSocket(loopbackAddr(INADDR_LOOPBACK));
+        receiverAddr = getBoundAddr(receiverHandle);
+        senderHandle = openUdpSocket(loopbackAddr(INADDR_LOOPBACK));
+        senderAddr = getBoundAddr(senderHandle);
+
+        auto result = IoUringConnectionTransport::Create(receiverHandle,
+            loopbackAddr(INADDR_LOOPBACK));
+        if (result.IsError)
+        {
+            close(receiverHandle);
+            receiverHandle = -1;
+            unavailableReason = result.ErrorMessage;
+            return;
+        }
+        transport = std::move(result.Value);
+    }
+
+    ~IoUringTestFixture()
+    {
+        transport.reset();
+        close(senderHandle);
+    }
+
+    int receiverHandle = -1;
+    sockaddr_in receiverAddr {};
+    int senderHandle = -1;
+    sockaddr_in senderAddr {};
+    std::unique_ptr<IoUringConnectionTransport> transport;
+    std::string unavailableReason;
+};
+
+TEST_CASE_METHOD(IoUringTestFixture, "io_uring transport receives datagrams from its target")
+{
+    if (!transport)
+    {
+        WARN("io_uring is unavailable: " << unavailableReason);
+        return;
+    }
+    std::vector<PacketBuffer> buffers(16);
+
+    // Nothing to read doesn't block
+    Result<size_t> result = transport->ReadBatch(buffers, std::chrono::milliseconds(0));
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value == 0);
+
+    sendTo(senderHandle, receiverAddr, 1, 100);
+    sendTo(senderHandle, receiverAddr, 2, 1400);
+    size_t received = 0;
+    while (received < 2)
+    {
+        result = transport->ReadBatch(std::span(buffers).subspan(received),
+            std::chrono::milliseconds(1000));
+        REQUIRE_FALSE(result.IsError);
+        REQUIRE(result.Value > 0);
+        received += result.Value;
+    }
+    REQUIRE(buffers[0].Size() == 100);
+    CHECK(buffers[0].Data()[0] == std::byte { 1 });
+    CHECK(buffers[0].Data()[99] == std::byte { 1 });
+    REQUIRE(buffers[1].Size() == 1400);
+    CHECK(buffers[1].Data()[0] == std::byte { 2 });
+    CHECK(buffers[1].Data()[1399] == std::byte { 2 });
+
+    // We learn which port to write back to from what's received
+    REQUIRE(transport->GetAddr().has_value());
+    CHECK(transport->GetAddr()->sin_port == senderAddr.sin_port);
+    std::vector<std::byte> reply { std::byte { 7 }, std::byte { 8 }, std::byte { 9 } };
+    REQUIRE_FALSE(transport->Write(reply).IsError);
+    std::byte replyBuffer[16];
+    timeval receiveTimeout { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(senderHandle, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+    REQUIRE(recv(senderHandle, replyBuffer, sizeof(replyBuffer), 0) == 3);
+    CHECK(replyBuffer[2] == std::byte { 9 });
+}
+
+TEST_CASE_METHOD(IoUringTestFixture, "io_uring transport discards datagrams from other addresses")
+{
+    if (!transport)
+    {
+        WARN("io_uring is unavailable: " << unavailableReason);
+        return;
+    }
+    int strangerHandle = openUdpSocket(loopbackAddr(0x7F000002));
+    sendTo(strangerHandle, receiverAddr, 3);
+    sendTo(senderHandle, receiverAddr, 4);
+
+    std::vector<PacketBuffer> buffers(16);
+    Result<size_t> result = Result<size_t>::Success(0);
+    for (int attempt = 0; (attempt < 10) && (result.Value == 0); ++attempt)
+    {
+        result = transport->ReadBatch(buffers, std::chrono::milliseconds(100));
+        REQUIRE_FALSE(result.IsError);
+    }
+    REQUIRE(result.Value == 1);
+    CHECK(buffers[0].Data()[0] == std::byte { 4 });
+    CHECK(transport->GetDiscardedPacketCount() == 1);
+    close(strangerHandle);
+}
+
+TEST_CASE_METHOD(IoUringTestFixture, "io_uring transport keeps up with bursts")
+{
+    if (!transport)
+    {
+        WARN("io_uring is unavailable: " << unavailableReason);
+        return;
+    }
+
+    // More datagrams than the kernel has buffers for, so it has to be re-armed along the way
+    int receiveBufferBytes = 4 * 1024 * 1024;
+    setsockopt(receiverHandle, SOL_SOCKET, SO_RCVBUF, &receiveBufferBytes,
+        sizeof(receiveBufferBytes));
+    constexpr size_t burstSize = 300;
+    std::vector<PacketBuffer> buffers(64);
+    size_t received = 0;
+    for (size_t i = 0; i < burstSize; ++i)
+    {
+        sendTo(senderHandle, receiverAddr, static_cast<uint8_t>(i));
+    }
+    for (int attempt = 0; (attempt < 100) && (received < burstSize); ++attempt)
+    {
+        Result<size_t> result = transport->ReadBatch(buffers, std::chrono::milliseconds(100));
+        REQUIRE_FALSE(result.IsError);
+        for (size_t i = 0; i < result.Value; ++i)
+        {
+            CHECK(buffers[i].Data()[0] == std::byte { static_cast<uint8_t>(received + i) });
+        }
+        received += result.Value;
+    }
+    CHECK(received == burstSize);
+
+    // Datagrams that have already been received are picked up without entering the kernel
+    sendTo(senderHandle, receiverAddr, 5);
+    Result<size_t> result = transport->ReadBatch(buffers, std::chrono::milliseconds(1000));
+    REQUIRE_FALSE(result.IsError);
+    REQUIRE(result.Value == 1);
+    sendTo(senderHandle, receiverAddr, 6);
+    usleep(50 * 1000);
+    const uint64_t syscallCount = transport->GetSyscallCount();
+    result = transport->ReadBatch(buffers, std::chrono::milliseconds(1000));
+    REQUIRE_FALSE(result.IsError);
+    REQUIRE(result.Value == 1);
+    CHECK(buffers[0].Data()[0] == std::byte { 6 });
+    CHECK(transport->GetSyscallCount() == syscallCount);
+}
+
+TEST_CASE_METHOD(IoUringTestFixture, "io_uring transport hands back its socket when detached")
+{
+    if (!transport)
+    {
+        WARN("io_uring is unavailable: " << unavailableReason);
+        return;
+    }
+    Result<std::optional<int>> detachResult = transport->Detach();
+    REQUIRE_FALSE(detachResult.IsError);
+    REQUIRE(detachResult.Value == receiverHandle);
+    CHECK(transport->ReadBatch(std::span<PacketBuffer>(), std::chrono::milliseconds(0)).IsError);
+
+    // The socket still works without the ring
+    fcntl(receiverHandle, F_SETFL, (fcntl(receiverHandle, F_GETFL, 0) & ~O_NONBLOCK));
+    sendTo(senderHandle, receiverAddr, 7);
+    std::byte buffer[128];
+    timeval receiveTimeout { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(receiverHandle, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout,
+        sizeof(receiveTimeout));
+    REQUIRE(recv(receiverHandle, buffer, sizeof(buffer), 0) == 100);
+    CHECK(buffer[0] == std::byte { 7 });
+    close(receiverHandle);
+}
+
+TEST_CASE("io_uring transport receives from and replies to IPv6 peers")
+{
+    sockaddr_in6 loopback6 { .sin6_family = AF_INET6 };
+    loopback6.sin6_addr = in6addr_loopback;
+    int handles[2];
+    sockaddr_in6 addrs[2];
+    for (size_t i = 0; i < 2; ++i)
+    {
+        handles[i] = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+        REQUIRE(handles[i] >= 0);
+        REQUIRE(bind(handles[i], reinterpret_cast<const sockaddr*>(&loopback6),
+            sizeof(loopback6)) == 0);
+        socklen_t addrLength = sizeof(addrs[i]);
+        REQUIRE(getsockname(handles[i], reinterpret_cast<sockaddr*>(&addrs[i]),
+            &addrLength) == 0);
+    }
+    auto result = IoUringConnectionTransport::Create(handles[0], std::nullopt, loopback6);
+    if (result.IsError)
+    {
+        close(handles[0]);
+        close(handles[1]);
+        WARN("io_uring is unavailable: " << result.ErrorMessage);
+        return;
+    }
+    std::unique_ptr<IoUringConnectionTransport> transport = std::move(result.Value);
+
+    std::vector<std::byte> payload(100, std::byte { 1 });
+    REQUIRE(sendto(handles[1], payload.data(), payload.size(), 0,
+        reinterpret_cast<const sockaddr*>(&addrs[0]), sizeof(addrs[0])) == 100);
+    std::vector<PacketBuffer> buffers(16);
+    Result<size_t> readResult = Result<size_t>::Success(0);
+    for (int attempt = 0; (attempt < 10) && (readResult.Value == 0); ++attempt)
+    {
+        readResult = transport->ReadBatch(buffers, std::chrono::milliseconds(100));
+        REQUIRE_FALSE(readResult.IsError);
+    }
+    REQUIRE(readResult.Value == 1);
+    CHECK(buffers[0].Size() == 100);
+    CHECK(transport->GetDiscardedPacketCount() == 0);
+
+    // We learn which port to write back to from what's received
+    CHECK_FALSE(transport->GetAddr().has_value());
+    REQUIRE(transport->GetAddr6().has_value());
+    CHECK(transport->GetAddr6()->sin6_port == addrs[1].sin6_port);
+    std::vector<std::byte> reply { std::byte { 7 }, std::byte { 8 }, std::byte { 9 } };
+    REQUIRE_FALSE(transport->Write(reply).IsError);
+    std::byte replyBuffer[16];
+    timeval receiveTimeout { .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(handles[1], SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+    CHECK(recv(handles[1], replyBuffer, sizeof(replyBuffer), 0) == 3);
+    close(handles[1]);
+}
@@ -5,14 +5,21 @@
  * @copyright Copyright (c) 2021 Daniel Stiner
  */
 
+#include <arpa/inet.h>
 #include <fcntl.h>
 #include <catch2/catch.hpp>
+#include <netinet/in.h>
 #include <optional>
 #include <unistd.h>
 
 #include "../../../src/ConnectionTransports/NetworkSocketConnectionTransport.h"
 #include "../../../src/Utilities/Util.h"
 
+static std::vector<std::byte> toByteVector(const PacketBuffer& buffer)
+{
+    return std::vector<std::byte>(buffer.Bytes().begin(), buffer.Bytes().end());
+}
+
 class UdpTestFixture {
 public:
     UdpTestFixture()
@@ -97,3 +104,212 @@ TEST_CASE_METHOD(UdpTestFixture, "UDP transport can receive packets")
         CHECK( buffer.size() == 0 );
     }
 }
+
+TEST_CASE_METHOD(UdpTestFixture, "UDP transport can receive packets in batches")
+{
+    std::vector<PacketBuffer> buffers(4);
+
+    SECTION( "when no packets are available to read, batch reading does not block" )
+    {
+        auto result = transport->ReadBatch(buffers, std::chrono::milliseconds(0));
+        if (result.IsError)
+        {
+            FAIL("ErrorMessage: " << result.ErrorMessage);
+        }
+        REQUIRE( result.Value == 0 );
+    }
+
+    std::vector<std::vector<std::byte>> packets;
+    for (int i = 0; i < 6; ++i)
+    {
+        packets.push_back(Util::StringToByteVector(fmt::format("Packet #{}", i)));
+    }
+
+    INFO( "when making more packets available than there are buffers" )
+    {
+        for (const auto& packet : packets)
+        {
+            REQUIRE(write(mockSocketPairFd, packet.data(), packet.size()) == (ssize_t)packet.size());
+        }
+    }
+
+    INFO( "then the first batch read fills every buffer in order" )
+    {
+        auto result = transport->ReadBatch(buffers, std::chrono::milliseconds(0));
+        if (result.IsError)
+        {
+            FAIL("ErrorMessage: " << result.ErrorMessage);
+        }
+        REQUIRE( result.Value == buffers.size() );
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            CHECK_THAT( toByteVector(buffers[i]), Catch::Equals( packets[i] ) );
+        }
+    }
+
+    INFO( "then the second batch read gets the remaining packets" )
+    {
+        auto result = transport->ReadBatch(buffers, std::chrono::milliseconds(0));
+        if (result.IsError)
+        {
+            FAIL("ErrorMessage: " << result.ErrorMessage);
+        }
+        REQUIRE( result.Value == 2 );
+        CHECK_THAT( toByteVector(buffers[0]), Catch::Equals( packets[4] ) );
+        CHECK_THAT( toByteVector(buffers[1]), Catch::Equals( packets[5] ) );
+    }
+
+    INFO( "then the third batch read gets no packets" )
+    {
+        auto result = transport->ReadBatch(buffers, std::chrono::milliseconds(0));
+        if (result.IsError)
+        {
+            FAIL("ErrorMessage: " << result.ErrorMessage);
+        }
+        CHECK( result.Value == 0 );
+    }
+}
+
+/**
+ * @brief Binds a UDP socket to an ephemeral port on the given loopback address
+ */
+static int bindLoopbackUdpSocket(const char* addr, sockaddr_in& boundAddr)
+{
+    int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    REQUIRE( handle != -1 );
+    boundAddr = { .sin_family = AF_INET, .sin_port = 0, .sin_addr = {} };
+    REQUIRE( inet_pton(AF_INET, addr, &boundAddr.sin_addr) == 1 );
+    REQUIRE( bind(handle, reinterpret_cast<sockaddr*>(&boundAddr), sizeof(boundAddr)) == 0 );
+    socklen_t boundAddrLen = sizeof(boundAddr);
+    REQUIRE( getsockname(handle, reinterpret_cast<sockaddr*>(&boundAddr), &boundAddrLen) == 0 );
+    return handle;
+}
+
+/**
+ * @brief Binds a UDP socket to an ephemeral port on the IPv6 loopback address
+ */
+static int bindLoopbackUdp6Socket(sockaddr_in6& boundAddr)
+{
+    int handle = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    REQUIRE( handle != -1 );
+    boundAddr = { .sin6_family = AF_INET6, .sin6_port = 0 };
+    boundAddr.sin6_addr = in6addr_loopback;
+    REQUIRE( bind(handle, reinterpret_cast<sockaddr*>(&boundAddr), sizeof(boundAddr)) == 0 );
+    socklen_t boundAddrLen = sizeof(boundAddr);
+    REQUIRE( getsockname(handle, reinterpret_cast<sockaddr*>(&boundAddr), &boundAddrLen) == 0 );
+    return handle;
+}
+
+TEST_CASE("UDP transport source filter drops datagrams from unexpected addresses")
+{
+    sockaddr_in senderAddr;
+    int senderHandle = bindLoopbackUdpSocket("127.0.0.1", senderAddr);
+    sockaddr_in receiverAddr;
+    int receiverHandle = bindLoopbackUdpSocket("127.0.0.1", receiverAddr);
+
+    const bool expectSender = GENERATE(true, false);
+    const bool attachFilter = GENERATE(true, false);
+    sockaddr_in targetAddr = senderAddr;
+    if (!expectSender)
+    {
+        REQUIRE( inet_pton(AF_INET, "10.0.0.1", &targetAddr.sin_addr) == 1 );
+    }
+    auto result = NetworkSocketConnectionTransport::Nonblocking(
+        NetworkSocketConnectionKind::Udp, receiverHandle, targetAddr);
+    REQUIRE( !result.IsError );
+    std::unique_ptr<NetworkSocketConnectionTransport> transport = std::move(result.Value);
+    if (attachFilter)
+    {
+        auto filterResult = transport->AttachSourceFilter();
+        if (filterResult.IsError)
+        {
+            FAIL("ErrorMessage: " << filterResult.ErrorMessage);
+        }
+    }
+
+    std::vector<std::byte> packet = Util::StringToByteVector("Filtered Packet");
+    REQUIRE( sendto(senderHandle, packet.data(), packet.size(), 0,
+        reinterpret_cast<sockaddr*>(&receiverAddr), sizeof(receiverAddr)) ==
+        static_cast<ssize_t>(packet.size()) );
+
+    std::vector<std::byte> buffer;
+    auto readResult = transport->Read(buffer, std::chrono::milliseconds(100));
+    REQUIRE( !readResult.IsError );
+    if (expectSender)
+    {
+        CHECK_THAT( buffer, Catch::Equals( packet ) );
+        CHECK( transport->GetDiscardedPacketCount() == 0 );
+    }
+    else
+    {
+        CHECK( buffer.empty() );
+        // The kernel drops filtered datagrams before they are ever read
+        CHECK( transport->GetDiscardedPacketCount() == (attachFilter ? 0 : 1) );
+    }
+
+    close(senderHandle);
+}
+
+TEST_CASE("UDP transport receives from and replies to IPv6 peers")
+{
+    sockaddr_in6 senderAddr;
+    int senderHandle = bindLoopbackUdp6Socket(senderAddr);
+    sockaddr_in6 receiverAddr;
+    int receiverHandle = bindLoopbackUdp6Socket(receiverAddr);
+
+    const bool expectSender = GENERATE(true, false);
+    const bool attachFilter = GENERATE(true, false);
+    // We don't know which port media is sent from until it arrives
+    sockaddr_in6 targetAddr = senderAddr;
+    targetAddr.sin6_port = 0;
+    if (!expectSender)
+    {
+        // Only differs from the sender in the last word of the address
+        REQUIRE( inet_pton(AF_INET6, "::2", &targetAddr.sin6_addr) == 1 );
+    }
+    auto result = NetworkSocketConnectionTransport::Nonblocking(
+        NetworkSocketConnectionKind::Udp, receiverHandle, std::nullopt, targetAddr);
+    REQUIRE( !result.IsError );
+    std::unique_ptr<NetworkSocketConnectionTransport> transport = std::move(result.Value);
+    if (attachFilter)
+    {
+        auto filterResult = transport->AttachSourceFilter();
+        if (filterResult.IsError)
+        {
+            FAIL("ErrorMessage: " << filterResult.ErrorMessage);
+        }
+    }
+
+    std::vector<std::byte> packet = Util::StringToByteVector("IPv6 Packet");
+    REQUIRE( sendto(senderHandle, packet.data(), packet.size(), 0,
+        reinterpret_cast<sockaddr*>(&receiverAddr), sizeof(receiverAddr)) ==
+        static_cast<ssize_t>(packet.size()) );
+
+    std::vector<std::byte> buffer;
+    auto readResult = transport->Read(buffer, std::chrono::milliseconds(100));
+    REQUIRE( !readResult.IsError );
+    if (expectSender)
+    {
+        CHECK_THAT( buffer, Catch::Equals( packet ) );
+        CHECK( transport->GetDiscardedPacketCount() == 0 );
+
+        // Replies go back to the port the peer sent from
+        REQUIRE( transport->GetAddr6().has_value() );
+        CHECK( transport->GetAddr6()->sin6_port == senderAddr.sin6_port );
+        std::vector<std::byte> reply = Util::StringToByteVector("Reply");
+        REQUIRE( !transport->Write(reply).IsError );
+        timeval receiveTimeout { .tv_sec = 1, .tv_usec = 0 };
+        setsockopt(senderHandle, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout,
+            sizeof(receiveTimeout));
+        std::vector<std::byte> replyBuffer(16);
+        CHECK( recv(senderHandle, replyBuffer.data(), replyBuffer.size(), 0) ==
+            static_cast<ssize_t>(reply.size()) );
+    }
+    else
+    {
+        CHECK( buffer.empty() );
+        CHECK( transport->GetDiscardedPacketCount() == (attachFilter ? 0 : 1) );
+    }
+
+    close(senderHandle);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file PcapConnectionTransportTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <thread>
+
+#include "../../../src/ConnectionTransports/PcapConnectionTransport.h"
+
+static std::vector<PcapReader::UdpDatagram> datagramsAt(
+    const std::vector<std::chrono::milliseconds>& offsets)
+{
+    std::vector<PcapReader::UdpDatagram> datagrams;
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        datagrams.push_back(PcapReader::UdpDatagram {
+            .Timestamp = std::chrono::seconds(1000) + offsets[i],
+            .Payload = std::vector<std::byte>(12, std::byte(i)),
+        });
+    }
+    return datagrams;
+}
+
+TEST_CASE("PcapConnectionTransport replays every datagram in order as fast as possible")
+{
+    using namespace std::chrono_literals;
+    PcapConnectionTransport transport(datagramsAt({ 0ms, 1000ms, 2000ms, 60000ms }),
+        PcapConnectionTransport::Timing::AsFastAsPossible);
+
+    std::array<PacketBuffer, 3> buffers;
+    auto firstBatch = transport.ReadBatch(buffers, 0ms);
+    REQUIRE_FALSE(firstBatch.IsError);
+    REQUIRE(firstBatch.Value == 3);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        REQUIRE(buffers[i].Size() == 12);
+        REQUIRE(buffers[i].Bytes()[0] == std::byte(i));
+    }
+    REQUIRE_FALSE(transport.IsFinished());
+
+    std::vector<std::byte> readBuffer;
+    auto readResult = transport.Read(readBuffer, 0ms);
+    REQUIRE(readResult.Value == 12);
+    REQUIRE(readBuffer[0] == std::byte(3));
+    REQUIRE(transport.IsFinished());
+    REQUIRE(transport.GetDatagramsRead() == 4);
+
+    // Once finished, the transport just sits idle
+    auto idleBatch = transport.ReadBatch(buffers, 0ms);
+    REQUIRE_FALSE(idleBatch.IsError);
+    REQUIRE(idleBatch.Value == 0);
+}
+
+TEST_CASE("PcapConnectionTransport replays datagrams with their captured spacing")
+{
+    using namespace std::chrono_literals;
+    PcapConnectionTransport transport(datagramsAt({ 0ms, 0ms, 100ms }),
+        PcapConnectionTransport::Timing::Original);
+
+    std::array<PacketBuffer, 8> buffers;
+    const auto startTime = std::chrono::steady_clock::now();
+    auto firstBatch = transport.ReadBatch(buffers, 0ms);
+    REQUIRE(firstBatch.Value == 2);
+
+    // The last datagram isn't due yet
+    auto earlyBatch = transport.ReadBatch(buffers, 10ms);
+    REQUIRE_FALSE(earlyBatch.IsError);
+    REQUIRE(earlyBatch.Value == 0);
+
+    auto lateBatch = transport.ReadBatch(buffers, 1000ms);
+    REQUIRE(lateBatch.Value == 1);
+    REQUIRE(buffers[0].Bytes()[0] == std::byte(2));
+    REQUIRE((std::chrono::steady_clock::now() - startTime) >= 100ms);
+    REQUIRE(transport.IsFinished());
+}
+
+TEST_CASE("PcapConnectionTransport counts writes and wakes readers when stopped")
+{
+    using namespace std::chrono_literals;
+    PcapConnectionTransport transport(datagramsAt({ 0ms, 60000ms }),
+        PcapConnectionTransport::Timing::Original);
+
+    std::array<std::byte, 16> nack {};
+    REQUIRE_FALSE(transport.Write(nack).IsError);
+    REQUIRE_FALSE(transport.Write(nack).IsError);
+    REQUIRE(transport.GetDatagramsWritten() == 2);
+
+    std::array<PacketBuffer, 4> buffers;
+    REQUIRE(transport.ReadBatch(buffers, 0ms).Value == 1);
+
+    std::thread stopper(
+        [&transport]()
+        {
+            std::this_thread::sleep_for(50ms);
+            transport.Stop();
+        });
+    const auto startTime = std::chrono::steady_clock::now();
+    auto stoppedBatch = transport.ReadBatch(buffers, 10000ms);
+    stopper.join();
+    REQUIRE(stoppedBatch.IsError);
+    REQUIRE((std::chrono::steady_clock::now() - startTime) < 5000ms);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file UdpMediaDemuxerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../../src/ConnectionTransports/UdpMediaDemuxer.h"
+#include "../../../src/ConnectionTransports/ConnectionTransport.h"
+#include "../../../src/Utilities/Util.h"
+
+static int openClientSocket()
+{
+    int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    REQUIRE(handle != -1);
+    sockaddr_in addr
+    {
+        .sin_family = AF_INET,
+        .sin_port = 0,
+        .sin_addr = { .s_addr = htonl(INADDR_LOOPBACK) },
+    };
+    REQUIRE(bind(handle, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    return handle;
+}
+
+static uint16_t findFreePort()
+{
+    int handle = openClientSocket();
+    sockaddr_in addr {};
+    socklen_t addrLen = sizeof(addr);
+    getsockname(handle, reinterpret_cast<sockaddr*>(&addr), &addrLen);
+    close(handle);
+    return ntohs(addr.sin_port);
+}
+
+static std::vector<std::byte> rtpPacketWithSsrc(uint32_t ssrc, uint8_t marker)
+{
+    std::vector<std::byte> packet(16, std::byte(marker));
+    uint32_t networkSsrc = htonl(ssrc);
+    std::memcpy(packet.data() + 8, &networkSsrc, sizeof(networkSsrc));
+    return packet;
+}
+
+static void sendTo(int handle, uint16_t port, const std::vector<std::byte>& packet)
+{
+    sockaddr_in addr
+    {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr = { .s_addr = htonl(INADDR_LOOPBACK) },
+    };
+    REQUIRE(sendto(handle, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr*>(&addr),
+        sizeof(addr)) == static_cast<ssize_t>(packet.size()));
+}
+
+static std::vector<std::byte> readOne(ConnectionTransport& transport)
+{
+    std::vector<std::byte> buffer;
+    auto result = transport.Read(buffer, std::chrono::milliseconds(1000));
+    REQUIRE_FALSE(result.IsError);
+    return buffer;
+}
+
+TEST_CASE("UdpMediaDemuxer routes datagrams on a shared port by source and SSRC")
+{
+    const uint16_t port = findFreePort();
+    auto demuxer = std::make_shared<UdpMediaDemuxer>(port, 2);
+    REQUIRE(demuxer->GetPort() == port);
+
+    const IpAddress loopback(in_addr { .s_addr = htonl(INADDR_LOOPBACK) });
+    const std::array<uint32_t, 2> ssrcsA { 100, 101 };
+    const std::array<uint32_t, 2> ssrcsB { 200, 201 };
+    auto transportA = demuxer->CreateTransport(loopback, ssrcsA);
+    auto transportB = demuxer->CreateTransport(loopback, ssrcsB);
+
+    int clientA = openClientSocket();
+    int clientB = openClientSocket();
+
+    // Both peers share an address, so they're told apart by SSRC
+    auto packetA = rtpPacketWithSsrc(101, 0xAA);
+    auto packetB = rtpPacketWithSsrc(200, 0xBB);
+    sendTo(clientA, port, packetA);
+    sendTo(clientB, port, packetB);
+    CHECK_THAT(readOne(*transportA), Catch::Equals(packetA));
+    CHECK_THAT(readOne(*transportB), Catch::Equals(packetB));
+
+    // Once a peer's endpoint is known, any datagram it sends is routed to it
+    auto pingA = rtpPacketWithSsrc(0, 0xCC);
+    sendTo(clientA, port, pingA);
+    CHECK_THAT(readOne(*transportA), Catch::Equals(pingA));
+
+    // Writes go back to the learned endpoint
+    auto reply = Util::StringToByteVector("Pong!");
+    REQUIRE_FALSE(transportA->Write(reply).IsError);
+    std::vector<std::byte> replyBuffer(64);
+    ssize_t replySize = recv(clientA, replyBuffer.data(), replyBuffer.size(), 0);
+    REQUIRE(replySize == static_cast<ssize_t>(reply.size()));
+    replyBuffer.resize(replySize);
+    CHECK_THAT(replyBuffer, Catch::Equals(reply));
+
+    // Stopped transports can't be read from
+    transportB->Stop();
+    std::vector<std::byte> buffer;
+    CHECK(transportB->Read(buffer, std::chrono::milliseconds(0)).IsError);
+
+    close(clientA);
+    close(clientB);
+}
+
+TEST_CASE("UdpMediaDemuxer routes IPv4 and IPv6 peers on a dual-stack port")
+{
+    const uint16_t port = findFreePort();
+    SocketBinding binding;
+    binding.Address = "::";
+    auto demuxer = std::make_shared<UdpMediaDemuxer>(port, 1, binding);
+
+    const std::array<uint32_t, 1> ssrcs4 { 100 };
+    const std::array<uint32_t, 1> ssrcs6 { 200 };
+    auto transport4 = demuxer->CreateTransport(
+        IpAddress(in_addr { .s_addr = htonl(INADDR_LOOPBACK) }), ssrcs4);
+    auto transport6 = demuxer->CreateTransport(IpAddress(in6addr_loopback), ssrcs6);
+
+    // IPv4 peers arrive through mapped addresses, but are routed and answered all the same
+    int client4 = openClientSocket();
+    auto packet4 = rtpPacketWithSsrc(100, 0xAA);
+    sendTo(client4, port, packet4);
+    CHECK_THAT(readOne(*transport4), Catch::Equals(packet4));
+    REQUIRE(transport4->GetAddr().has_value());
+    CHECK_FALSE(transport4->GetAddr6().has_value());
+
+    int client6 = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+    REQUIRE(client6 != -1);
+    sockaddr_in6 addr6 { .sin6_family = AF_INET6, .sin6_port = htons(port) };
+    addr6.sin6_addr = in6addr_loopback;
+    auto packet6 = rtpPacketWithSsrc(200, 0xBB);
+    REQUIRE(sendto(client6, packet6.data(), packet6.size(), 0,
+        reinterpret_cast<sockaddr*>(&addr6), sizeof(addr6)) ==
+        static_cast<ssize_t>(packet6.size()));
+    CHECK_THAT(readOne(*transport6), Catch::Equals(packet6));
+    CHECK_FALSE(transport6->GetAddr().has_value());
+    REQUIRE(transport6->GetAddr6().has_value());
+
+    auto reply = Util::StringToByteVector("Pong!");
+    std::vector<std::byte> replyBuffer(64);
+    REQUIRE_FALSE(transport4->Write(reply).IsError);
+    CHECK(recv(client4, replyBuffer.data(), replyBuffer.size(), 0) ==
+        static_cast<ssize_t>(reply.size()));
+    REQUIRE_FALSE(transport6->Write(reply).IsError);
+    CHECK(recv(client6, replyBuffer.data(), replyBuffer.size(), 0) ==
+        static_cast<ssize_t>(reply.size()));
+
+    close(client4);
+    close(client6);
+}
+
+TEST_CASE("UdpMediaDemuxer turns away IPv6 peers on an IPv4 port")
+{
+    auto demuxer = std::make_shared<UdpMediaDemuxer>(findFreePort(), 1);
+    const std::array<uint32_t, 1> ssrcs { 100 };
+    CHECK_THROWS(demuxer->CreateTransport(IpAddress(in6addr_loopback), ssrcs));
+}
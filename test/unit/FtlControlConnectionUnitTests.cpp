@@ -9,9 +9,12 @@
 #include <memory>
 #include <openssl/hmac.h>
 #include <optional>
+#include <random>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 
+#include "../../src/FtlControlCommandParser.h"
 #include "../../src/FtlControlConnection.h"
 #include "../../src/Utilities/Util.h"
 #include "../mocks/MockConnectionTransport.h"
@@ -32,7 +35,7 @@ public:
     {
         ftl_channel_id_t ChannelId;
         MediaMetadata MediaMetadataInfo;
-        in_addr TargetAddr;
+        IpAddress TargetAddr;
     };
     struct FtlControlConnectionState
     {
@@ -136,7 +139,7 @@ private:
     }
 
     void handleControlConnectionRequestedMediaPort(FtlControlConnection* connection,
-        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, in_addr targetAddr)
+        ftl_channel_id_t channelId, MediaMetadata mediaMetadata, IpAddress targetAddr)
     {
         controlConnections[connection].MediaPortRequest =
             FtlControlConnectionMediaPortRequest
@@ -332,4 +335,250 @@ TEST_CASE_METHOD(FtlControlConnectionUnitTestsFixture,
         REQUIRE(response == fmt::format("{} hi. Use UDP port {}\n", 200, mediaPort));
         lastPayloadReceived.clear();
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(FtlControlConnectionUnitTestsFixture,
+    "FtlControlConnection processes commands split across reads")
+{
+    auto [controlConnection, mockTransportPtr] = ConnectMockControlConnection();
+    std::vector<std::byte> lastPayloadReceived;
+    std::mutex mutex;
+    mockTransportPtr->SetOnWrite(
+        [&](const std::span<const std::byte>& bytes)
+        {
+            std::scoped_lock lock(mutex);
+            lastPayloadReceived.assign(bytes.begin(), bytes.end());
+            return Result<void>::Success();
+        });
+
+    // Split the command and its delimiter over several reads
+    mockTransportPtr->InjectReceivedBytes("HM");
+    mockTransportPtr->InjectReceivedBytes("AC\r\n");
+    mockTransportPtr->InjectReceivedBytes("\r");
+    mockTransportPtr->InjectReceivedBytes("\n");
+
+    REQUIRE(WaitFor(
+        [&]()
+        {
+            std::scoped_lock lock(mutex);
+            return !lastPayloadReceived.empty();
+        }));
+    std::scoped_lock lock(mutex);
+    CHECK(Util::BytesToString(lastPayloadReceived).substr(0, 4) == "200 ");
+}
+
+TEST_CASE_METHOD(FtlControlConnectionUnitTestsFixture,
+    "FtlControlConnection disconnects clients that never finish a command")
+{
+    auto [controlConnection, mockTransportPtr] = ConnectMockControlConnection();
+    FtlControlConnection* controlConnectionPtr = controlConnection.get();
+
+    mockTransportPtr->InjectReceivedBytes(std::string(8192, 'A'));
+
+    REQUIRE(WaitFor(
+        [&]()
+        {
+            auto state = GetControlConnectionState(controlConnectionPtr);
+            return state.has_value() && state.value().HasStopped;
+        }));
+}
+
+TEST_CASE("FtlControlCommandParser recognizes FTL commands")
+{
+    using Kind = FtlControlCommandParser::CommandKind;
+    CHECK(FtlControlCommandParser::GetCommandKind("HMAC") == Kind::Hmac);
+    CHECK(FtlControlCommandParser::GetCommandKind("CONNECT 1 $00") == Kind::Connect);
+    CHECK(FtlControlCommandParser::GetCommandKind("CONNECT garbage") == Kind::Connect);
+    CHECK(FtlControlCommandParser::GetCommandKind("VendorName: OBS") == Kind::Attribute);
+    CHECK(FtlControlCommandParser::GetCommandKind("PING: x") == Kind::Attribute);
+    CHECK(FtlControlCommandParser::GetCommandKind(".") == Kind::Dot);
+    CHECK(FtlControlCommandParser::GetCommandKind("PING 1234") == Kind::Ping);
+    CHECK(FtlControlCommandParser::GetCommandKind("") == Kind::Unknown);
+    CHECK(FtlControlCommandParser::GetCommandKind("HMACK") == Kind::Unknown);
+    CHECK(FtlControlCommandParser::GetCommandKind("Key:Value") == Kind::Unknown);
+
+    CHECK(FtlControlCommandParser::FindDelimiter("HMAC\r\n\r\n") == 4);
+    CHECK(FtlControlCommandParser::FindDelimiter("HMAC\r\n\r\n.\r\n\r\n", 5) == 9);
+    CHECK_FALSE(FtlControlCommandParser::FindDelimiter("HMAC\r\n\r").has_value());
+}
+
+TEST_CASE("FtlControlCommandParser parses CONNECT commands")
+{
+    auto connect = FtlControlCommandParser::ParseConnect("CONNECT 1234 $0123456789abcdef");
+    REQUIRE(connect.has_value());
+    CHECK(connect.value().ChannelId == 1234);
+    CHECK(connect.value().HmacHash == "0123456789abcdef");
+
+    // Too large for a channel ID
+    CHECK_FALSE(FtlControlCommandParser::ParseConnect("CONNECT 4294967296 $00").has_value());
+    CHECK(FtlControlCommandParser::ParseConnect("CONNECT 4294967295 $00").has_value());
+
+    for (std::string_view malformed : {
+        "CONNECT", "CONNECT ", "CONNECT 1234", "CONNECT 1234 ", "CONNECT 1234 $",
+        "CONNECT 1234 00", "CONNECT -1 $00", "CONNECT +1 $00", "CONNECT 12a4 $00",
+        "CONNECT 1234 $00AB", "CONNECT 1234 $00 ", "CONNECT  1234 $00", "CONNECT1234 $00" })
+    {
+        INFO(malformed);
+        CHECK_FALSE(FtlControlCommandParser::ParseConnect(malformed).has_value());
+    }
+}
+
+TEST_CASE("FtlControlCommandParser parses attributes")
+{
+    auto attribute = FtlControlCommandParser::ParseAttribute("VendorName: My: Encoder");
+    REQUIRE(attribute.has_value());
+    CHECK(attribute.value().Key == "VendorName");
+    CHECK(attribute.value().Value == "My: Encoder");
+
+    for (std::string_view malformed : { "", ": ", "Key: ", ": Value", "Key:Value",
+        "Key: Val\nue", "Ke\ry: Value" })
+    {
+        INFO(malformed);
+        CHECK_FALSE(FtlControlCommandParser::ParseAttribute(malformed).has_value());
+    }
+
+    CHECK(FtlControlCommandParser::ParseUnsigned<uint16_t>("1080") == 1080);
+    CHECK_FALSE(FtlControlCommandParser::ParseUnsigned<uint16_t>("65536").has_value());
+    CHECK_FALSE(FtlControlCommandParser::ParseUnsigned<uint16_t>("").has_value());
+    CHECK_FALSE(FtlControlCommandParser::ParseUnsigned<uint16_t>("10 ").has_value());
+    CHECK_FALSE(FtlControlCommandParser::ParseUnsigned<uint8_t>("-1").has_value());
+}
+
+TEST_CASE("FtlControlCommandParser handles arbitrary input")
+{
+    // Mutate real commands as well as generating noise, so the fuzzing reaches past the first
+    // few characters of each command
+    const std::vector<std::string> seeds {
+        "HMAC", "CONNECT 1234 $0123456789abcdef", "VendorName: OBS", "VideoWidth: 1920", ".",
+        "PING 1234", "HMAC\r\n\r\nCONNECT 1 $ab\r\n\r\n",
+    };
+    const std::string alphabet = "CONNECTHMAPIG $:.0123456789abcdefxyz\r\n\0\xff";
+    std::mt19937 random(1234);
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string input = seeds.at(random() % seeds.size());
+        const int numMutations = random() % 4;
+        for (int mutation = 0; mutation < numMutations; ++mutation)
+        {
+            const size_t index = input.empty() ? 0 : (random() % input.size());
+            const char c = alphabet.at(random() % alphabet.size());
+            switch (random() % 3)
+            {
+            case 0:
+                input.insert(index, 1, c);
+                break;
+            case 1:
+                if (!input.empty())
+                {
+                    input.erase(index, 1);
+                }
+                break;
+            default:
+                if (!input.empty())
+                {
+                    input.at(index) = c;
+                }
+                break;
+            }
+        }
+        if ((i % 2) == 0)
+        {
+            input.resize(random() % 64);
+            for (char& c : input)
+            {
+                c = static_cast<char>(random());
+            }
+        }
+
+        const std::string_view command(input);
+        INFO(input);
+        auto isWithinCommand = [&command](std::string_view view)
+            {
+                return (view.data() >= command.data()) &&
+                    ((view.data() + view.size()) <= (command.data() + command.size()));
+            };
+
+        std::optional<size_t> delimiterIndex = FtlControlCommandParser::FindDelimiter(command);
+        if (delimiterIndex.has_value())
+        {
+            REQUIRE(command.substr(delimiterIndex.value(), 4) == "\r\n\r\n");
+        }
+
+        auto connect = FtlControlCommandParser::ParseConnect(command);
+        if (connect.has_value())
+        {
+            REQUIRE(isWithinCommand(connect.value().HmacHash));
+            REQUIRE_FALSE(connect.value().HmacHash.empty());
+            REQUIRE(command.ends_with(connect.value().HmacHash));
+        }
+
+        auto attribute = FtlControlCommandParser::ParseAttribute(command);
+        if (attribute.has_value())
+        {
+            REQUIRE(isWithinCommand(attribute.value().Key));
+            REQUIRE(isWithinCommand(attribute.value().Value));
+            REQUIRE_FALSE(attribute.value().Key.empty());
+            REQUIRE_FALSE(attribute.value().Value.empty());
+        }
+
+        auto kind = FtlControlCommandParser::GetCommandKind(command);
+        if (kind == FtlControlCommandParser::CommandKind::Attribute)
+        {
+            REQUIRE(attribute.has_value());
+        }
+        if (connect.has_value())
+        {
+            REQUIRE(kind == FtlControlCommandParser::CommandKind::Connect);
+        }
+    }
+}
+
+TEST_CASE("FtlControlCommandParser benchmark", "[.][benchmark]")
+{
+    const std::string commands =
+        "HMAC\r\n\r\n"
+        "CONNECT 1234 $0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef\r\n\r\n"
+        "ProtocolVersion: 0.9\r\n\r\n"
+        "VendorName: OBS Studio\r\n\r\n"
+        "VideoCodec: H264\r\n\r\n"
+        "VideoWidth: 1920\r\n\r\n"
+        "VideoIngestSSRC: 1235\r\n\r\n"
+        ".\r\n\r\n"
+        "PING 1234\r\n\r\n";
+    constexpr int iterations = 100000;
+
+    size_t numCommands = 0;
+    size_t numParsed = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        const std::string_view buffer(commands);
+        size_t commandStart = 0;
+        while (auto delimiterIndex =
+            FtlControlCommandParser::FindDelimiter(buffer, commandStart))
+        {
+            std::string_view command =
+                buffer.substr(commandStart, (delimiterIndex.value() - commandStart));
+            switch (FtlControlCommandParser::GetCommandKind(command))
+            {
+            case FtlControlCommandParser::CommandKind::Connect:
+                numParsed += FtlControlCommandParser::ParseConnect(command).has_value();
+                break;
+            case FtlControlCommandParser::CommandKind::Attribute:
+                numParsed += FtlControlCommandParser::ParseAttribute(command).has_value();
+                break;
+            default:
+                break;
+            }
+            ++numCommands;
+            commandStart = delimiterIndex.value() + FtlControlCommandParser::DELIMITER.size();
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    REQUIRE(numCommands == (9 * iterations));
+    REQUIRE(numParsed == (6 * iterations));
+    WARN(fmt::format("Parsed {} commands in {} ms ({} ns per command)", numCommands,
+        (elapsed.count() / 1000000), (elapsed.count() / numCommands)));
+}
@@ -0,0 +1,199 @@
+/**
+ * @file FtlHandoffTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../src/FtlHandoff.h"
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    struct HandoffSocketPair
+    {
+        HandoffSocketPair()
+        {
+            REQUIRE(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, Handles) == 0);
+        }
+        ~HandoffSocketPair()
+        {
+            close(Handles[0]);
+            close(Handles[1]);
+        }
+        int Handles[2];
+    };
+
+    bool isSameFile(int first, int second)
+    {
+        struct stat firstStat, secondStat;
+        return (fstat(first, &firstStat) == 0) && (fstat(second, &secondStat) == 0) &&
+            (firstStat.st_dev == secondStat.st_dev) && (firstStat.st_ino == secondStat.st_ino);
+    }
+}
+
+TEST_CASE( "FtlHandoffProtocol requests and sends sockets", "[handoff]" )
+{
+    HandoffSocketPair sockets;
+    REQUIRE_FALSE(FtlHandoffProtocol::SendRequest(sockets.Handles[0]).IsError);
+    REQUIRE_FALSE(FtlHandoffProtocol::ReceiveRequest(sockets.Handles[1], 1s).IsError);
+
+    int pipeHandles[2];
+    REQUIRE(pipe(pipeHandles) == 0);
+    FtlHandoff sent
+    {
+        .ControlListenHandles = { pipeHandles[0] },
+        .MediaHandles = { pipeHandles[1] },
+    };
+    REQUIRE_FALSE(FtlHandoffProtocol::SendSockets(sockets.Handles[1], sent).IsError);
+
+    Result<FtlHandoff> received = FtlHandoffProtocol::ReceiveSockets(sockets.Handles[0], 1s);
+    REQUIRE_FALSE(received.IsError);
+    REQUIRE(received.Value.ControlListenHandles.size() == 1);
+    REQUIRE(received.Value.MediaHandles.size() == 1);
+    CHECK(isSameFile(received.Value.ControlListenHandles[0], pipeHandles[0]));
+    CHECK(isSameFile(received.Value.MediaHandles[0], pipeHandles[1]));
+
+    FtlHandoffProtocol::CloseHandles(received.Value);
+    CHECK(received.Value.ControlListenHandles.empty());
+    CHECK(received.Value.MediaHandles.empty());
+    FtlHandoffProtocol::CloseHandles(sent);
+}
+
+TEST_CASE( "FtlHandoffProtocol sends streams until done", "[handoff]" )
+{
+    HandoffSocketPair sockets;
+    int pipeHandles[2];
+    REQUIRE(pipe(pipeHandles) == 0);
+
+    FtlStreamHandoff sent
+    {
+        .ChannelId = 1234,
+        .StreamId = 5678,
+        .Metadata = MediaMetadata
+        {
+            .VendorName = "OBS Studio",
+            .VendorVersion = "27.0.1",
+            .HasVideo = true,
+            .HasAudio = true,
+            .VideoCodec = VideoCodecKind::H264,
+            .AudioCodec = AudioCodecKind::Opus,
+            .VideoWidth = 1920,
+            .VideoHeight = 1080,
+            .VideoSsrc = 1235,
+            .AudioSsrc = 1234,
+            .VideoPayloadType = 96,
+            .AudioPayloadType = 97,
+        },
+        .MediaPort = 9000,
+        .PendingControlBytes = "PING 1234",
+        .Sequences =
+        {
+            FtlSsrcSequenceHandoff
+            {
+                .Ssrc = 1235,
+                .Sequence = ExtendedSequenceCounter::State
+                {
+                    .MaxSeq = 65530,
+                    .Cycles = 3,
+                    .Received = 100,
+                    .Initialized = true,
+                },
+            },
+        },
+        .ControlHandle = pipeHandles[0],
+        .MediaHandle = pipeHandles[1],
+    };
+    sent.ControlAddr = sockaddr_in { .sin_family = AF_INET, .sin_port = htons(45678) };
+    inet_pton(AF_INET, "10.0.0.1", &sent.ControlAddr->sin_addr);
+    sent.MediaAddr = sent.ControlAddr;
+    sent.MediaAddr->sin_port = htons(45679);
+
+    REQUIRE_FALSE(FtlHandoffProtocol::SendStream(sockets.Handles[0], sent).IsError);
+    sent.MediaHandle = -1;
+    sent.MediaAddr = std::nullopt;
+    sent.MediaAddr6 = sockaddr_in6 { .sin6_family = AF_INET6, .sin6_port = htons(45680) };
+    inet_pton(AF_INET6, "2001:db8::1", &sent.MediaAddr6->sin6_addr);
+    REQUIRE_FALSE(FtlHandoffProtocol::SendStream(sockets.Handles[0], sent).IsError);
+    REQUIRE_FALSE(FtlHandoffProtocol::SendDone(sockets.Handles[0]).IsError);
+
+    Result<std::optional<FtlStreamHandoff>> received =
+        FtlHandoffProtocol::ReceiveStream(sockets.Handles[1], 1s);
+    REQUIRE_FALSE(received.IsError);
+    REQUIRE(received.Value.has_value());
+    FtlStreamHandoff& stream = received.Value.value();
+    CHECK(stream.ChannelId == sent.ChannelId);
+    CHECK(stream.StreamId == sent.StreamId);
+    CHECK(stream.Metadata.VendorName == sent.Metadata.VendorName);
+    CHECK(stream.Metadata.VendorVersion == sent.Metadata.VendorVersion);
+    CHECK(stream.Metadata.HasVideo);
+    CHECK(stream.Metadata.HasAudio);
+    CHECK(stream.Metadata.VideoCodec == VideoCodecKind::H264);
+    CHECK(stream.Metadata.AudioCodec == AudioCodecKind::Opus);
+    CHECK(stream.Metadata.VideoWidth == 1920);
+    CHECK(stream.Metadata.VideoHeight == 1080);
+    CHECK(stream.Metadata.VideoSsrc == 1235);
+    CHECK(stream.Metadata.AudioSsrc == 1234);
+    CHECK(stream.Metadata.VideoPayloadType == 96);
+    CHECK(stream.Metadata.AudioPayloadType == 97);
+    CHECK(stream.MediaPort == 9000);
+    REQUIRE(stream.ControlAddr.has_value());
+    CHECK(stream.ControlAddr->sin_addr.s_addr == sent.ControlAddr->sin_addr.s_addr);
+    CHECK(stream.ControlAddr->sin_port == sent.ControlAddr->sin_port);
+    CHECK_FALSE(stream.ControlAddr6.has_value());
+    REQUIRE(stream.MediaAddr.has_value());
+    CHECK(stream.MediaAddr->sin_port == htons(45679));
+    CHECK_FALSE(stream.MediaAddr6.has_value());
+    CHECK(stream.PendingControlBytes == sent.PendingControlBytes);
+    REQUIRE(stream.Sequences.size() == 1);
+    CHECK(stream.Sequences[0].Ssrc == 1235);
+    CHECK(stream.Sequences[0].Sequence.MaxSeq == 65530);
+    CHECK(stream.Sequences[0].Sequence.Cycles == 3);
+    CHECK(stream.Sequences[0].Sequence.Received == 100);
+    CHECK(stream.Sequences[0].Sequence.Initialized);
+    CHECK(isSameFile(stream.ControlHandle, pipeHandles[0]));
+    CHECK(isSameFile(stream.MediaHandle, pipeHandles[1]));
+    FtlHandoffProtocol::CloseHandles(stream);
+    CHECK(stream.ControlHandle == -1);
+    CHECK(stream.MediaHandle == -1);
+
+    // Streams on a shared media port arrive without a media socket of their own
+    received = FtlHandoffProtocol::ReceiveStream(sockets.Handles[1], 1s);
+    REQUIRE_FALSE(received.IsError);
+    REQUIRE(received.Value.has_value());
+    CHECK(received.Value->ControlHandle >= 0);
+    CHECK(received.Value->MediaHandle == -1);
+
+    // Streamers that only have an IPv6 address are handed off with it
+    CHECK_FALSE(received.Value->MediaAddr.has_value());
+    REQUIRE(received.Value->MediaAddr6.has_value());
+    CHECK(IN6_ARE_ADDR_EQUAL(&received.Value->MediaAddr6->sin6_addr,
+        &sent.MediaAddr6->sin6_addr));
+    CHECK(received.Value->MediaAddr6->sin6_port == htons(45680));
+    FtlHandoffProtocol::CloseHandles(received.Value.value());
+
+    received = FtlHandoffProtocol::ReceiveStream(sockets.Handles[1], 1s);
+    REQUIRE_FALSE(received.IsError);
+    CHECK_FALSE(received.Value.has_value());
+
+    close(pipeHandles[0]);
+    close(pipeHandles[1]);
+}
+
+TEST_CASE( "FtlHandoffProtocol rejects unexpected messages", "[handoff]" )
+{
+    HandoffSocketPair sockets;
+    // A stream where the sockets were expected
+    REQUIRE_FALSE(FtlHandoffProtocol::SendDone(sockets.Handles[0]).IsError);
+    CHECK(FtlHandoffProtocol::ReceiveSockets(sockets.Handles[1], 1s).IsError);
+    // Nothing at all
+    CHECK(FtlHandoffProtocol::ReceiveStream(sockets.Handles[1], 10ms).IsError);
+}
@@ -63,3 +63,22 @@ TEST_CASE("A skip less than MAX_DROPOUT is treated as valid")
         extend(counter, extended, extended);
     }
 }
+
+TEST_CASE("A sequence carries on from another counter's state")
+{
+    ExtendedSequenceCounter counter;
+    rtp_extended_sequence_num_t extended = MAX_SEQ_NUM - 50;
+    for (int i = 0; i < 100; ++i, ++extended)
+    {
+        extend(counter, extended, extended);
+    }
+
+    // Already past the wrap, so the new counter has to know about the cycle to keep counting
+    ExtendedSequenceCounter resumedCounter;
+    resumedCounter.SetState(counter.GetState());
+    CHECK(resumedCounter.GetState() == counter.GetState());
+    for (int i = 0; i < 10; ++i, ++extended)
+    {
+        extend(resumedCounter, extended, extended);
+    }
+}
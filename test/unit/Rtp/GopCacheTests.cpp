@@ -0,0 +1,76 @@
+/**
+ * @file GopCacheTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <netinet/in.h>
+#include <vector>
+
+#include "../../../src/Rtp/GopCache.h"
+#include "../../../src/Rtp/RtpPacket.h"
+
+static PacketBuffer makeVideoPacket(rtp_sequence_num_t sequence, rtp_timestamp_t timestamp)
+{
+    std::vector<std::byte> bytes(12);
+    RtpHeader* header = reinterpret_cast<RtpHeader*>(bytes.data());
+    header->Version = 2;
+    header->SequenceNumber = htons(sequence);
+    header->Timestamp = htonl(timestamp);
+    return PacketBuffer::Copy(bytes);
+}
+
+static std::vector<rtp_sequence_num_t> sequences(const std::vector<PacketBuffer>& packets)
+{
+    std::vector<rtp_sequence_num_t> result;
+    for (const auto& packet : packets)
+    {
+        result.push_back(RtpPacket::GetRtpSequence(packet));
+    }
+    return result;
+}
+
+TEST_CASE( "GopCache holds packets from the latest keyframe onward", "[rtp]" )
+{
+    GopCache cache;
+
+    // Packets before the first keyframe are useless on their own
+    cache.Add(makeVideoPacket(1, 1000), false);
+    CHECK(cache.Empty());
+
+    // A keyframe split across several packets shares one timestamp
+    cache.Add(makeVideoPacket(2, 2000), true);
+    cache.Add(makeVideoPacket(3, 2000), true);
+    cache.Add(makeVideoPacket(4, 3000), false);
+    cache.Add(makeVideoPacket(5, 4000), false);
+    CHECK(sequences(cache.Snapshot()) == std::vector<rtp_sequence_num_t>({ 2, 3, 4, 5 }));
+
+    // The next keyframe replaces the whole group
+    cache.Add(makeVideoPacket(6, 5000), true);
+    cache.Add(makeVideoPacket(7, 6000), false);
+    CHECK(sequences(cache.Snapshot()) == std::vector<rtp_sequence_num_t>({ 6, 7 }));
+
+    cache.Clear();
+    CHECK(cache.Empty());
+}
+
+TEST_CASE( "GopCache drops groups that grow too large", "[rtp]" )
+{
+    GopCache cache(4);
+    cache.Add(makeVideoPacket(1, 1000), true);
+    for (rtp_sequence_num_t seq = 2; seq <= 4; ++seq)
+    {
+        cache.Add(makeVideoPacket(seq, seq * 1000), false);
+    }
+    CHECK(cache.Size() == 4);
+
+    // Overflowing discards the group, and nothing is cached until the next keyframe
+    cache.Add(makeVideoPacket(5, 5000), false);
+    CHECK(cache.Empty());
+    cache.Add(makeVideoPacket(6, 6000), false);
+    CHECK(cache.Empty());
+    cache.Add(makeVideoPacket(7, 7000), true);
+    CHECK(sequences(cache.Snapshot()) == std::vector<rtp_sequence_num_t>({ 7 }));
+}
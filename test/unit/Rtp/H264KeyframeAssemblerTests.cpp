@@ -0,0 +1,178 @@
+/**
+ * @file H264KeyframeAssemblerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <netinet/in.h>
+#include <vector>
+
+#include "../../../src/Rtp/H264KeyframeAssembler.h"
+
+static RtpPacket makeVideoPacket(rtp_extended_sequence_num_t sequence, rtp_timestamp_t timestamp,
+    std::initializer_list<uint8_t> payload, bool isMarker = false)
+{
+    std::vector<std::byte> bytes(12);
+    RtpHeader* header = reinterpret_cast<RtpHeader*>(bytes.data());
+    header->Version = 2;
+    header->MarkerBit = isMarker;
+    header->SequenceNumber = htons(static_cast<rtp_sequence_num_t>(sequence));
+    header->Timestamp = htonl(timestamp);
+    for (const uint8_t& value : payload)
+    {
+        bytes.push_back(std::byte(value));
+    }
+    return RtpPacket(PacketBuffer::Copy(bytes), sequence);
+}
+
+static std::vector<rtp_sequence_num_t> sequences(const std::list<PacketBuffer>& packets)
+{
+    std::vector<rtp_sequence_num_t> result;
+    for (const auto& packet : packets)
+    {
+        result.push_back(RtpPacket::GetRtpSequence(packet));
+    }
+    return result;
+}
+
+// A keyframe access unit: delimiter, SPS, PPS, then an IDR slice split into three fragments
+static std::vector<RtpPacket> makeKeyframe(rtp_extended_sequence_num_t firstSequence,
+    rtp_timestamp_t timestamp)
+{
+    return {
+        makeVideoPacket(firstSequence, timestamp, { 0x09, 0xF0 }),
+        makeVideoPacket(firstSequence + 1, timestamp, { 0x67, 0x42 }),
+        makeVideoPacket(firstSequence + 2, timestamp, { 0x68, 0xCE }),
+        makeVideoPacket(firstSequence + 3, timestamp, { 0x7C, 0x85, 0xAA }),
+        makeVideoPacket(firstSequence + 4, timestamp, { 0x7C, 0x05, 0xBB }),
+        makeVideoPacket(firstSequence + 5, timestamp, { 0x7C, 0x45, 0xCC }, true),
+    };
+}
+
+TEST_CASE( "H264KeyframeAssembler completes keyframes at the marker bit", "[rtp]" )
+{
+    H264KeyframeAssembler assembler;
+    CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x41, 0x9A }, true)));
+
+    std::vector<RtpPacket> keyframe = makeKeyframe(2, 2000);
+    for (size_t i = 0; i < (keyframe.size() - 1); ++i)
+    {
+        CHECK_FALSE(assembler.Add(keyframe[i]));
+    }
+    REQUIRE(assembler.Add(keyframe.back()));
+    // The access unit delimiter isn't part of the keyframe
+    CHECK(sequences(assembler.GetKeyframePackets()) ==
+        std::vector<rtp_sequence_num_t>({ 3, 4, 5, 6, 7 }));
+
+    // Late duplicates don't complete the same keyframe twice
+    CHECK_FALSE(assembler.Add(keyframe[4]));
+    CHECK_FALSE(assembler.Add(makeVideoPacket(8, 3000, { 0x41, 0x9A }, true)));
+}
+
+TEST_CASE( "H264KeyframeAssembler handles reordered packets and multiple slices", "[rtp]" )
+{
+    H264KeyframeAssembler assembler;
+    CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x41, 0x9A }, true)));
+
+    CHECK_FALSE(assembler.Add(makeVideoPacket(2, 2000, { 0x67, 0x42 })));
+    CHECK_FALSE(assembler.Add(makeVideoPacket(4, 2000, { 0x65, 0x88 })));
+    CHECK_FALSE(assembler.Add(makeVideoPacket(6, 2000, { 0x65, 0x99 }, true)));
+    CHECK_FALSE(assembler.Add(makeVideoPacket(5, 2000, { 0x06, 0x05 })));
+    REQUIRE(assembler.Add(makeVideoPacket(3, 2000, { 0x68, 0xCE })));
+    CHECK(sequences(assembler.GetKeyframePackets()) ==
+        std::vector<rtp_sequence_num_t>({ 2, 3, 4, 6 }));
+}
+
+TEST_CASE( "H264KeyframeAssembler requires every packet up to the marker bit", "[rtp]" )
+{
+    H264KeyframeAssembler assembler;
+    CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x41, 0x9A }, true)));
+
+    std::vector<RtpPacket> keyframe = makeKeyframe(2, 2000);
+    const size_t skipped = GENERATE(0, 1, 2, 3, 4);
+    for (size_t i = 0; i < keyframe.size(); ++i)
+    {
+        if (i != skipped)
+        {
+            CHECK_FALSE(assembler.Add(keyframe[i]));
+        }
+    }
+
+    // A retransmission fills the gap
+    CHECK(assembler.Add(keyframe[skipped]));
+}
+
+TEST_CASE( "H264KeyframeAssembler recognizes aggregated parameter sets", "[rtp]" )
+{
+    H264KeyframeAssembler assembler;
+    CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x41, 0x9A }, true)));
+
+    // STAP-A of an SPS and PPS
+    CHECK_FALSE(assembler.Add(makeVideoPacket(2, 2000,
+        { 0x78, 0x00, 0x02, 0x67, 0x42, 0x00, 0x02, 0x68, 0xCE })));
+    CHECK(assembler.Add(makeVideoPacket(3, 2000, { 0x65, 0x88 }, true)));
+    CHECK(sequences(assembler.GetKeyframePackets()) ==
+        std::vector<rtp_sequence_num_t>({ 2, 3 }));
+}
+
+TEST_CASE( "H264KeyframeAssembler rejects incomplete keyframes", "[rtp]" )
+{
+    H264KeyframeAssembler assembler;
+
+    SECTION( "missing PPS" )
+    {
+        CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x67, 0x42 })));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(2, 1000, { 0x65, 0x88 }, true)));
+    }
+
+    SECTION( "start of the access unit lost" )
+    {
+        CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x41, 0x9A }, true)));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(3, 2000, { 0x67, 0x42 })));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(4, 2000, { 0x68, 0xCE })));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(5, 2000, { 0x65, 0x88 }, true)));
+    }
+
+    SECTION( "access unit ended before its marker bit" )
+    {
+        CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x67, 0x42 })));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(2, 1000, { 0x68, 0xCE })));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(3, 1000, { 0x65, 0x88 })));
+        CHECK_FALSE(assembler.Add(makeVideoPacket(5, 2000, { 0x41, 0x9A }, true)));
+        // A straggler from the abandoned access unit is ignored
+        CHECK_FALSE(assembler.Add(makeVideoPacket(4, 1000, { 0x65, 0x99 }, true)));
+    }
+}
+
+TEST_CASE( "H264KeyframeAssembler ignores the rest of an abandoned access unit", "[rtp]" )
+{
+    H264KeyframeAssembler assembler;
+    CHECK_FALSE(assembler.Add(makeVideoPacket(1, 1000, { 0x41, 0x9A }, true)));
+    CHECK(assembler.GetHeldBytes() == 0);
+
+    std::vector<RtpPacket> keyframe = makeKeyframe(2, 2000);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        CHECK_FALSE(assembler.Add(keyframe[i]));
+    }
+    CHECK(assembler.GetHeldBytes() > 0);
+
+    assembler.Abandon();
+    CHECK(assembler.GetHeldBytes() == 0);
+    CHECK_FALSE(assembler.Add(keyframe[4]));
+    CHECK_FALSE(assembler.Add(keyframe[5]));
+    CHECK(assembler.GetHeldBytes() == 0);
+    CHECK(assembler.GetKeyframePackets().empty());
+
+    // The next keyframe is captured as usual
+    std::vector<RtpPacket> nextKeyframe = makeKeyframe(8, 3000);
+    for (size_t i = 0; i < (nextKeyframe.size() - 1); ++i)
+    {
+        CHECK_FALSE(assembler.Add(nextKeyframe[i]));
+    }
+    REQUIRE(assembler.Add(nextKeyframe.back()));
+    CHECK(sequences(assembler.GetKeyframePackets()) ==
+        std::vector<rtp_sequence_num_t>({ 9, 10, 11, 12, 13 }));
+}
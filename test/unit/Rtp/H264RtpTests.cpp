@@ -0,0 +1,101 @@
+/**
+ * @file H264RtpTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "../../../src/Rtp/H264Rtp.h"
+
+static std::vector<std::byte> bytes(std::initializer_list<uint8_t> values)
+{
+    std::vector<std::byte> result;
+    for (const uint8_t& value : values)
+    {
+        result.push_back(std::byte(value));
+    }
+    return result;
+}
+
+static std::vector<std::byte> assemble(const std::vector<std::vector<std::byte>>& payloads)
+{
+    size_t size = 0;
+    for (const auto& payload : payloads)
+    {
+        size += H264Rtp::AnnexBSize(payload);
+    }
+
+    std::vector<std::byte> output(size);
+    size_t offset = 0;
+    for (const auto& payload : payloads)
+    {
+        offset += H264Rtp::WriteAnnexB(payload, std::span(output).subspan(offset));
+    }
+    REQUIRE(offset == size);
+    return output;
+}
+
+TEST_CASE( "H264Rtp identifies keyframe payloads", "[rtp]" )
+{
+    CHECK(H264Rtp::IsKeyframePayload(bytes({ 0x67, 0x42 }))); // SPS
+    CHECK(H264Rtp::IsKeyframePayload(bytes({ 0x68, 0xCE }))); // PPS
+    CHECK(H264Rtp::IsKeyframePayload(bytes({ 0x65, 0x88 }))); // IDR
+    CHECK(H264Rtp::IsKeyframePayload(bytes({ 0x7C, 0x85 }))); // FU-A of IDR
+    CHECK_FALSE(H264Rtp::IsKeyframePayload(bytes({ 0x41, 0x9A }))); // Non-IDR slice
+    CHECK_FALSE(H264Rtp::IsKeyframePayload(bytes({ 0x7C, 0x81 }))); // FU-A of non-IDR slice
+    CHECK(H264Rtp::IsKeyframePayload(bytes({ 0x7C, 0x88 }))); // FU-A of PPS
+    CHECK(H264Rtp::IsKeyframePayload(
+        bytes({ 0x78, 0x00, 0x02, 0x09, 0xF0, 0x00, 0x02, 0x67, 0x42 }))); // STAP-A with SPS
+    CHECK_FALSE(H264Rtp::IsKeyframePayload(bytes({ 0x78, 0x00, 0x02, 0x09, 0xF0 })));
+    CHECK_FALSE(H264Rtp::IsKeyframePayload(bytes({ 0x65 })));
+}
+
+TEST_CASE( "H264Rtp writes single NAL unit payloads as Annex B", "[rtp]" )
+{
+    std::vector<std::byte> output = assemble({
+        bytes({ 0x67, 0x42, 0x00 }),
+        bytes({ 0x68, 0xCE }),
+    });
+    CHECK(output == bytes({ 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x00, 0x00, 0x01, 0x68, 0xCE }));
+}
+
+TEST_CASE( "H264Rtp reassembles FU-A fragments as Annex B", "[rtp]" )
+{
+    std::vector<std::byte> output = assemble({
+        bytes({ 0x7C, 0x85, 0xAA, 0xBB }), // Start fragment of an IDR with NRI 3
+        bytes({ 0x7C, 0x05, 0xCC }),
+        bytes({ 0x7C, 0x45, 0xDD }), // End fragment
+    });
+    CHECK(output == bytes({ 0x00, 0x00, 0x01, 0x65, 0xAA, 0xBB, 0xCC, 0xDD }));
+}
+
+TEST_CASE( "H264Rtp unpacks STAP-A aggregates as Annex B", "[rtp]" )
+{
+    std::vector<std::byte> stapA = bytes({ 0x78, 0x00, 0x02, 0x67, 0x42, 0x00, 0x01, 0x68 });
+    CHECK(assemble({ stapA }) == bytes({ 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x00, 0x01, 0x68 }));
+
+    std::vector<std::vector<std::byte>> nalUnits;
+    H264Rtp::ForEachNalUnit(stapA,
+        [&nalUnits](std::span<const std::byte> nalUnit)
+        {
+            nalUnits.emplace_back(nalUnit.begin(), nalUnit.end());
+        });
+    CHECK(nalUnits ==
+        std::vector<std::vector<std::byte>>({ bytes({ 0x67, 0x42 }), bytes({ 0x68 }) }));
+
+    // A truncated aggregate yields only its whole NAL units
+    stapA.pop_back();
+    CHECK(assemble({ stapA }) == bytes({ 0x00, 0x00, 0x01, 0x67, 0x42 }));
+}
+
+TEST_CASE( "H264Rtp skips invalid payloads and short output buffers", "[rtp]" )
+{
+    CHECK(H264Rtp::AnnexBSize(bytes({ 0x65 })) == 0);
+
+    std::vector<std::byte> payload = bytes({ 0x65, 0x88, 0x80 });
+    std::vector<std::byte> output(H264Rtp::AnnexBSize(payload) - 1);
+    CHECK(H264Rtp::WriteAnnexB(payload, output) == 0);
+}
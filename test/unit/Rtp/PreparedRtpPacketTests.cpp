@@ -0,0 +1,70 @@
+/**
+ * @file PreparedRtpPacketTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "../../../src/Rtp/PreparedRtpPacket.h"
+
+static PacketBuffer makeRtpPacket(uint8_t payloadType, size_t payloadSize)
+{
+    std::vector<std::byte> bytes(PreparedRtpPacket::RTP_FIXED_HEADER_SIZE + payloadSize);
+    bytes[0] = std::byte(0x80); // Version 2
+    bytes[1] = std::byte(payloadType);
+    for (size_t i = PreparedRtpPacket::RTP_FIXED_HEADER_SIZE; i < bytes.size(); ++i)
+    {
+        bytes[i] = std::byte(i);
+    }
+    return PacketBuffer::Copy(bytes);
+}
+
+TEST_CASE( "PreparedRtpPacket shares one mutable copy between receivers", "[rtp]" )
+{
+    PacketBuffer packet = makeRtpPacket(96, 100);
+    PreparedRtpPacket prepared(packet, 96);
+    REQUIRE(prepared.IsValid());
+    CHECK(prepared.IsVideo());
+    CHECK(prepared.GetLength() == packet.Size());
+    CHECK(prepared.GetCopyCount() == 0);
+
+    SECTION( "receivers that don't modify the packet don't cause copies" )
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            std::span<std::byte> bytes = prepared.MutableBytes();
+            REQUIRE(std::equal(bytes.begin(), bytes.end(), packet.Bytes().begin()));
+        }
+        CHECK(prepared.GetCopyCount() == 1);
+    }
+
+    SECTION( "a receiver that modifies the header doesn't affect the next receiver" )
+    {
+        std::span<std::byte> bytes = prepared.MutableBytes();
+        bytes[2] = std::byte(0xFF);
+        bytes[3] = std::byte(0xFF);
+
+        bytes = prepared.MutableBytes();
+        CHECK(std::equal(bytes.begin(), bytes.end(), packet.Bytes().begin()));
+        CHECK(prepared.GetCopyCount() == 2);
+        // The original packet is never touched
+        CHECK(packet.Bytes()[2] == std::byte(0));
+    }
+}
+
+TEST_CASE( "PreparedRtpPacket rejects packets it can't hand out", "[rtp]" )
+{
+    PreparedRtpPacket audio(makeRtpPacket(97, 10), 96);
+    CHECK(audio.IsValid());
+    CHECK_FALSE(audio.IsVideo());
+
+    PreparedRtpPacket truncated(PacketBuffer::Copy(std::vector<std::byte>(4)), 96);
+    CHECK_FALSE(truncated.IsValid());
+    CHECK(truncated.MutableBytes().empty());
+
+    PreparedRtpPacket oversized(makeRtpPacket(96, PreparedRtpPacket::MAX_PACKET_SIZE), 96);
+    CHECK_FALSE(oversized.IsValid());
+}
@@ -0,0 +1,62 @@
+/**
+ * @file RtpHeaderRewriterTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <netinet/in.h>
+#include <vector>
+
+#include "../../../src/Rtp/RtpHeaderRewriter.h"
+
+struct RewrittenHeader
+{
+    rtp_sequence_num_t Sequence;
+    rtp_timestamp_t Timestamp;
+};
+
+static RewrittenHeader rewrite(RtpHeaderRewriter& rewriter, rtp_sequence_num_t sequence,
+    rtp_timestamp_t timestamp)
+{
+    std::vector<std::byte> bytes(12);
+    RtpHeader* header = reinterpret_cast<RtpHeader*>(bytes.data());
+    header->SequenceNumber = htons(sequence);
+    header->Timestamp = htonl(timestamp);
+    rewriter.Rewrite(bytes);
+    return RewrittenHeader { ntohs(header->SequenceNumber), ntohl(header->Timestamp) };
+}
+
+TEST_CASE( "RtpHeaderRewriter passes packets through until rebased", "[rtp]" )
+{
+    RtpHeaderRewriter rewriter;
+    CHECK_FALSE(rewriter.HasSentPackets());
+
+    // Rebasing before anything has been sent has nothing to follow on from
+    rewriter.Rebase(3000);
+    RewrittenHeader first = rewrite(rewriter, 100, 90000);
+    CHECK(first.Sequence == 100);
+    CHECK(first.Timestamp == 90000);
+    CHECK(rewriter.IsPassthrough());
+    CHECK(rewriter.HasSentPackets());
+}
+
+TEST_CASE( "RtpHeaderRewriter keeps resent packets continuous", "[rtp]" )
+{
+    RtpHeaderRewriter rewriter;
+    rewrite(rewriter, 65534, 90000);
+    rewrite(rewriter, 65535, 93000);
+
+    // Jump back in time to resend older packets, wrapping the sequence number
+    rewriter.Rebase(3000);
+    RewrittenHeader resent = rewrite(rewriter, 65500, 30000);
+    CHECK(resent.Sequence == 0);
+    CHECK(resent.Timestamp == 96000);
+    CHECK_FALSE(rewriter.IsPassthrough());
+
+    // Later packets keep the same offset
+    RewrittenHeader next = rewrite(rewriter, 65501, 33000);
+    CHECK(next.Sequence == 1);
+    CHECK(next.Timestamp == 99000);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file RtpPacketRingBufferTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/Rtp/RtpPacketRingBuffer.h"
+
+RtpPacket packetWithSequence(rtp_extended_sequence_num_t seq)
+{
+    std::vector<std::byte> bytes(12, std::byte(0));
+    bytes[2] = std::byte((seq >> 8) & 0xFF);
+    bytes[3] = std::byte(seq & 0xFF);
+    return RtpPacket(PacketBuffer::Copy(bytes), seq);
+}
+
+std::vector<rtp_extended_sequence_num_t> storedSequences(const RtpPacketRingBuffer& buffer)
+{
+    std::vector<rtp_extended_sequence_num_t> sequences;
+    buffer.ForEach(
+        [&sequences](const RtpPacket& packet) { sequences.push_back(packet.ExtendedSequenceNum); });
+    return sequences;
+}
+
+TEST_CASE("In-order packets are stored without gaps")
+{
+    RtpPacketRingBuffer buffer(8);
+    REQUIRE(buffer.Empty());
+    for (rtp_extended_sequence_num_t seq = 100; seq < 105; ++seq)
+    {
+        auto missing = buffer.Insert(packetWithSequence(seq));
+        CHECK(missing.Count == 0);
+    }
+    CHECK(buffer.Size() == 5);
+    CHECK(buffer.NewestSequenceNum() == 104);
+    CHECK_THAT(storedSequences(buffer),
+        Catch::Equals(std::vector<rtp_extended_sequence_num_t> { 100, 101, 102, 103, 104 }));
+}
+
+TEST_CASE("Skipped sequences are reported as missing and can be filled in later")
+{
+    RtpPacketRingBuffer buffer(8);
+    buffer.Insert(packetWithSequence(10));
+    auto missing = buffer.Insert(packetWithSequence(14));
+    CHECK(missing.First == 11);
+    CHECK(missing.Count == 3);
+    CHECK_FALSE(buffer.Contains(12));
+
+    missing = buffer.Insert(packetWithSequence(12));
+    CHECK(missing.Count == 0);
+    CHECK(buffer.Contains(12));
+    CHECK(buffer.Size() == 3);
+    CHECK_THAT(storedSequences(buffer),
+        Catch::Equals(std::vector<rtp_extended_sequence_num_t> { 10, 12, 14 }));
+}
+
+TEST_CASE("Packets that fall out of the window are evicted")
+{
+    RtpPacketRingBuffer buffer(4);
+    for (rtp_extended_sequence_num_t seq = 0; seq < 10; ++seq)
+    {
+        buffer.Insert(packetWithSequence(seq));
+    }
+    CHECK(buffer.Size() == 4);
+    CHECK_THAT(storedSequences(buffer),
+        Catch::Equals(std::vector<rtp_extended_sequence_num_t> { 6, 7, 8, 9 }));
+
+    // Packets older than the window are discarded
+    buffer.Insert(packetWithSequence(2));
+    CHECK_FALSE(buffer.Contains(2));
+    CHECK(buffer.Size() == 4);
+
+    // A large jump evicts everything but the new packet
+    auto missing = buffer.Insert(packetWithSequence(1000));
+    CHECK(missing.First == 10);
+    CHECK(missing.Count == 990);
+    CHECK(buffer.Size() == 1);
+}
+
+TEST_CASE("Cleared buffers do not return stale packets")
+{
+    RtpPacketRingBuffer buffer(8);
+    buffer.Insert(packetWithSequence(3));
+    buffer.Insert(packetWithSequence(4));
+    buffer.Clear();
+    CHECK(buffer.Empty());
+
+    buffer.Insert(packetWithSequence(6));
+    CHECK_FALSE(buffer.Contains(4));
+    CHECK_THAT(storedSequences(buffer),
+        Catch::Equals(std::vector<rtp_extended_sequence_num_t> { 6 }));
+
+    RtpPacketRingBuffer other(8);
+    other.Insert(packetWithSequence(20));
+    buffer.Swap(other);
+    CHECK(buffer.NewestSequenceNum() == 20);
+    CHECK(other.NewestSequenceNum() == 6);
+}
+
+TEST_CASE("Held bytes follow the packet buffers slots refer to until they're released")
+{
+    RtpPacketRingBuffer buffer(4);
+    const size_t packetCapacity = packetWithSequence(0).Bytes.Capacity();
+    buffer.Insert(packetWithSequence(1));
+    buffer.Insert(packetWithSequence(2));
+    CHECK(buffer.GetHeldBytes() == (2 * packetCapacity));
+
+    // Evicted packets stay referenced until their slots are reused
+    buffer.Insert(packetWithSequence(7));
+    CHECK(buffer.GetHeldBytes() == (3 * packetCapacity));
+    buffer.Insert(packetWithSequence(5));
+    CHECK(buffer.GetHeldBytes() == (3 * packetCapacity));
+
+    // As do cleared ones
+    buffer.Clear();
+    CHECK(buffer.GetHeldBytes() == (3 * packetCapacity));
+    buffer.Insert(packetWithSequence(20));
+    CHECK(buffer.GetHeldBytes() == (4 * packetCapacity));
+
+    PacketBuffer heldElsewhere = buffer.Get(20)->Bytes;
+    REQUIRE_FALSE(heldElsewhere.IsUnique());
+    buffer.Release();
+    CHECK(buffer.Empty());
+    CHECK(buffer.GetHeldBytes() == 0);
+    CHECK(heldElsewhere.IsUnique());
+
+    buffer.Insert(packetWithSequence(21));
+    CHECK(buffer.GetHeldBytes() == packetCapacity);
+    CHECK_THAT(storedSequences(buffer),
+        Catch::Equals(std::vector<rtp_extended_sequence_num_t> { 21 }));
+}
+
+TEST_CASE("Removed packets are let go of without moving the window")
+{
+    RtpPacketRingBuffer buffer(4);
+    const size_t packetCapacity = packetWithSequence(0).Bytes.Capacity();
+    buffer.Insert(packetWithSequence(10));
+    buffer.Insert(packetWithSequence(11));
+    buffer.Insert(packetWithSequence(13));
+
+    CHECK(buffer.Remove(11));
+    CHECK_FALSE(buffer.Remove(11));
+    CHECK_FALSE(buffer.Remove(12));
+    CHECK_FALSE(buffer.Contains(11));
+    CHECK(buffer.Size() == 2);
+    CHECK(buffer.GetHeldBytes() == (2 * packetCapacity));
+    CHECK(buffer.NewestSequenceNum() == 13);
+
+    // The gap left behind can be filled in again
+    auto missing = buffer.Insert(packetWithSequence(11));
+    CHECK(missing.Count == 0);
+    CHECK_THAT(storedSequences(buffer),
+        Catch::Equals(std::vector<rtp_extended_sequence_num_t> { 10, 11, 13 }));
+}
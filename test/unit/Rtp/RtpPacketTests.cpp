@@ -0,0 +1,107 @@
+/**
+ * @file RtpPacketTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "../../../src/Rtp/RtpPacket.h"
+
+static std::vector<std::byte> makeRtpBytes(std::initializer_list<uint8_t> values)
+{
+    std::vector<std::byte> bytes;
+    for (const uint8_t& value : values)
+    {
+        bytes.push_back(std::byte(value));
+    }
+    return bytes;
+}
+
+TEST_CASE( "RtpPacket parses the fields of a plain RTP header", "[rtp]" )
+{
+    const std::vector<std::byte> bytes = makeRtpBytes({
+        0x80, 0xE0, 0x12, 0x34, // Version 2, marker, payload type 96, sequence 0x1234
+        0x00, 0x01, 0x00, 0x02, // Timestamp
+        0xDE, 0xAD, 0xBE, 0xEF, // SSRC
+        0x65, 0x88, 0x84,       // An IDR slice
+    });
+    auto fields = RtpPacket::ParseFields(bytes);
+    REQUIRE(fields.has_value());
+    CHECK(fields->Ssrc == 0xDEADBEEF);
+    CHECK(fields->SequenceNum == 0x1234);
+    CHECK(fields->Timestamp == 0x00010002);
+    CHECK(fields->PayloadType == 96);
+    CHECK(fields->IsMarker);
+    CHECK(fields->PayloadOffset == 12);
+    CHECK(fields->PayloadSize == 3);
+    CHECK(fields->NalType == 5);
+
+    RtpPacket packet(PacketBuffer::Copy(bytes), 70000);
+    CHECK(packet.Fields.SequenceNum == 0x1234);
+    CHECK(packet.ExtendedSequenceNum == 70000);
+    CHECK(packet.Payload().size() == 3);
+    CHECK(packet.Payload()[0] == std::byte(0x65));
+}
+
+TEST_CASE( "RtpPacket skips CSRCs, header extensions and padding", "[rtp]" )
+{
+    const std::vector<std::byte> bytes = makeRtpBytes({
+        0xB1, 0x61, 0x00, 0x01, // Version 2, padding, extension, 1 CSRC, payload type 97
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x01,
+        0x11, 0x22, 0x33, 0x44, // CSRC
+        0xBE, 0xDE, 0x00, 0x01, // Extension of one word
+        0x10, 0xFF, 0x00, 0x00,
+        0x41, 0x9A,             // Payload
+        0x00, 0x00, 0x03,       // Padding
+    });
+    auto fields = RtpPacket::ParseFields(bytes);
+    REQUIRE(fields.has_value());
+    CHECK(fields->PayloadType == 97);
+    CHECK_FALSE(fields->IsMarker);
+    CHECK(fields->PayloadOffset == 24);
+    CHECK(fields->PayloadSize == 2);
+    CHECK(fields->NalType == 1);
+}
+
+TEST_CASE( "RtpPacket rejects malformed packets", "[rtp]" )
+{
+    SECTION( "shorter than the fixed header" )
+    {
+        CHECK_FALSE(RtpPacket::ParseFields(makeRtpBytes({ 0x80, 0x60, 0x00, 0x01 })));
+    }
+
+    SECTION( "not version 2" )
+    {
+        CHECK_FALSE(RtpPacket::ParseFields(makeRtpBytes({
+            0x40, 0x60, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x41,
+        })));
+    }
+
+    SECTION( "CSRCs past the end" )
+    {
+        CHECK_FALSE(RtpPacket::ParseFields(makeRtpBytes({
+            0x82, 0x60, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+            0x11, 0x22, 0x33, 0x44,
+        })));
+    }
+
+    SECTION( "header extension past the end" )
+    {
+        CHECK_FALSE(RtpPacket::ParseFields(makeRtpBytes({
+            0x90, 0x60, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+            0xBE, 0xDE, 0x00, 0x04, 0x10, 0xFF,
+        })));
+    }
+
+    SECTION( "more padding than payload" )
+    {
+        CHECK_FALSE(RtpPacket::ParseFields(makeRtpBytes({
+            0xA0, 0x60, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+            0x41, 0x05,
+        })));
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file RtpReorderBufferTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/Rtp/RtpReorderBuffer.h"
+
+namespace
+{
+    constexpr std::chrono::milliseconds REORDER_DELAY { 30 };
+
+    RtpPacket reorderPacket(rtp_extended_sequence_num_t seq)
+    {
+        std::vector<std::byte> bytes(12, std::byte(0));
+        bytes[2] = std::byte((seq >> 8) & 0xFF);
+        bytes[3] = std::byte(seq & 0xFF);
+        return RtpPacket(PacketBuffer::Copy(bytes), seq);
+    }
+
+    class ReorderHarness
+    {
+    public:
+        ReorderHarness(size_t capacity = RtpReorderBuffer::DEFAULT_CAPACITY)
+        :
+            buffer(REORDER_DELAY, capacity)
+        { }
+
+        RtpReorderBuffer::InsertResult Insert(rtp_extended_sequence_num_t seq,
+            std::chrono::milliseconds at)
+        {
+            return buffer.Insert(reorderPacket(seq), start + at, recordRelease());
+        }
+
+        void ReleaseReady(std::chrono::milliseconds at)
+        {
+            buffer.ReleaseReady(start + at, recordRelease());
+        }
+
+        void Flush()
+        {
+            buffer.Flush(recordRelease());
+        }
+
+        RtpReorderBuffer buffer;
+        std::vector<rtp_extended_sequence_num_t> released;
+
+    private:
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        std::function<void(const RtpPacket&)> recordRelease()
+        {
+            return [this](const RtpPacket& packet)
+            {
+                released.push_back(packet.ExtendedSequenceNum);
+            };
+        }
+    };
+
+    using Sequences = std::vector<rtp_extended_sequence_num_t>;
+    using std::chrono_literals::operator""ms;
+}
+
+TEST_CASE("In-order packets are released as soon as they arrive")
+{
+    ReorderHarness harness;
+    for (rtp_extended_sequence_num_t seq = 100; seq < 104; ++seq)
+    {
+        CHECK(harness.Insert(seq, 0ms) == RtpReorderBuffer::InsertResult::Accepted);
+    }
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 100, 101, 102, 103 }));
+    CHECK(harness.buffer.Size() == 0);
+    CHECK(harness.buffer.GetHeldBytes() == 0);
+}
+
+TEST_CASE("Reordered packets are released in sequence once the gap fills")
+{
+    ReorderHarness harness;
+    harness.Insert(10, 0ms);
+    harness.Insert(12, 1ms);
+    harness.Insert(13, 2ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10 }));
+    CHECK(harness.buffer.Size() == 2);
+
+    harness.Insert(11, 5ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 11, 12, 13 }));
+    CHECK(harness.buffer.Size() == 0);
+}
+
+TEST_CASE("Packets waiting on a gap are released once they've been held for the delay")
+{
+    ReorderHarness harness;
+    harness.Insert(10, 0ms);
+    harness.Insert(12, 1ms);
+    harness.Insert(14, 20ms);
+
+    harness.ReleaseReady(30ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10 }));
+
+    // 12 has waited long enough, 14 hasn't
+    harness.ReleaseReady(31ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 12 }));
+    harness.ReleaseReady(50ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 12, 14 }));
+
+    // Packets given up on that show up afterwards are late
+    CHECK(harness.Insert(11, 55ms) == RtpReorderBuffer::InsertResult::Late);
+    CHECK(harness.Insert(13, 55ms) == RtpReorderBuffer::InsertResult::Late);
+    CHECK(harness.Insert(11, 56ms) == RtpReorderBuffer::InsertResult::Duplicate);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 12, 14 }));
+}
+
+TEST_CASE("Copies of held and released packets are dropped as duplicates")
+{
+    ReorderHarness harness;
+    harness.Insert(10, 0ms);
+    harness.Insert(12, 1ms);
+    CHECK(harness.Insert(10, 2ms) == RtpReorderBuffer::InsertResult::Duplicate);
+    CHECK(harness.Insert(12, 2ms) == RtpReorderBuffer::InsertResult::Duplicate);
+    harness.Insert(11, 3ms);
+    CHECK(harness.Insert(11, 4ms) == RtpReorderBuffer::InsertResult::Duplicate);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 11, 12 }));
+}
+
+TEST_CASE("Packets too far ahead push the packets before them out early")
+{
+    ReorderHarness harness(4);
+    harness.Insert(10, 0ms);
+    harness.Insert(12, 0ms);
+    harness.Insert(13, 0ms);
+    harness.Insert(16, 0ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 12, 13 }));
+    CHECK(harness.buffer.Size() == 1);
+
+    // A jump far ahead releases everything held and gives up on what's between
+    harness.Insert(1000, 1ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 10, 12, 13, 16 }));
+    CHECK(harness.Insert(996, 2ms) == RtpReorderBuffer::InsertResult::Late);
+    CHECK(harness.Insert(999, 2ms) == RtpReorderBuffer::InsertResult::Accepted);
+    CHECK(harness.buffer.Size() == 2);
+}
+
+TEST_CASE("Sequences that start counting again are released from where they restart")
+{
+    ReorderHarness harness;
+    harness.Insert(5000, 0ms);
+    harness.Insert(5002, 0ms);
+    harness.Insert(10, 1ms);
+    harness.Insert(11, 1ms);
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 5000, 5002, 10, 11 }));
+}
+
+TEST_CASE("Flushing releases every packet held in order")
+{
+    ReorderHarness harness;
+    harness.Insert(3, 0ms);
+    harness.Insert(7, 0ms);
+    harness.Insert(5, 0ms);
+    harness.Flush();
+    CHECK_THAT(harness.released, Catch::Equals(Sequences { 3, 5, 7 }));
+    CHECK(harness.buffer.Size() == 0);
+    CHECK(harness.Insert(6, 1ms) == RtpReorderBuffer::InsertResult::Late);
+}
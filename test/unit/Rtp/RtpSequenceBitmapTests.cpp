@@ -0,0 +1,82 @@
+/**
+ * @file RtpSequenceBitmapTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "../../../src/Rtp/RtpSequenceBitmap.h"
+
+static std::vector<rtp_extended_sequence_num_t> markedSequences(const RtpSequenceBitmap& bitmap)
+{
+    std::vector<rtp_extended_sequence_num_t> sequences;
+    bitmap.ForEach([&sequences](rtp_extended_sequence_num_t seq) { sequences.push_back(seq); });
+    return sequences;
+}
+
+TEST_CASE("RtpSequenceBitmap marks and clears sequences")
+{
+    RtpSequenceBitmap bitmap;
+    REQUIRE(bitmap.Empty());
+
+    CHECK(bitmap.Set(1000));
+    CHECK(bitmap.Set(998));
+    CHECK(bitmap.Set(1063));
+    CHECK(bitmap.Set(1064));
+    CHECK(bitmap.NewestSequenceNum() == 1064);
+    CHECK(bitmap.Count() == 4);
+    CHECK(bitmap.Test(998));
+    CHECK_FALSE(bitmap.Test(999));
+    CHECK(markedSequences(bitmap) ==
+        std::vector<rtp_extended_sequence_num_t> { 998, 1000, 1063, 1064 });
+
+    bitmap.Reset(1000);
+    CHECK_FALSE(bitmap.Test(1000));
+    CHECK(bitmap.Count() == 3);
+
+    bitmap.Clear();
+    CHECK(bitmap.Empty());
+}
+
+TEST_CASE("RtpSequenceBitmap drops sequences that fall out of the window")
+{
+    RtpSequenceBitmap bitmap;
+    const rtp_extended_sequence_num_t start = 70000;
+    bitmap.Set(start);
+    bitmap.Set(start + 10);
+
+    // Sequences older than the window can't be marked
+    CHECK_FALSE(bitmap.Set(start + 10 - RtpSequenceBitmap::WINDOW_SIZE));
+
+    CHECK(bitmap.Advance(start + RtpSequenceBitmap::WINDOW_SIZE - 1) == 0);
+    CHECK(bitmap.Test(start));
+    CHECK(bitmap.Advance(start + RtpSequenceBitmap::WINDOW_SIZE) == 1);
+    CHECK_FALSE(bitmap.Test(start));
+    CHECK(markedSequences(bitmap) == std::vector<rtp_extended_sequence_num_t> { start + 10 });
+
+    // Jumping further than the window clears everything
+    CHECK(bitmap.Advance(start + 10000) == 1);
+    CHECK(bitmap.Empty());
+}
+
+TEST_CASE("RtpSequenceBitmap can be reset while iterating")
+{
+    RtpSequenceBitmap bitmap;
+    for (rtp_extended_sequence_num_t seq = 100; seq < 300; seq += 3)
+    {
+        bitmap.Set(seq);
+    }
+
+    size_t visited = 0;
+    bitmap.ForEach(
+        [&](rtp_extended_sequence_num_t seq)
+        {
+            ++visited;
+            bitmap.Reset(seq);
+        });
+    CHECK(visited == 67);
+    CHECK(bitmap.Empty());
+}
@@ -0,0 +1,172 @@
+/**
+ * @file AsyncServiceConnectionTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+#include "../../../src/ServiceConnections/AsyncServiceConnection.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    /**
+     * @brief Blocks every call until unblocked, and fails to end streams
+     */
+    class FakeServiceConnection : public ServiceConnection
+    {
+    public:
+        FakeServiceConnection(std::shared_future<void> unblocked) : unblocked(unblocked)
+        { }
+
+        void Init() override
+        { }
+
+        Result<std::vector<std::byte>> GetHmacKey(ftl_channel_id_t channelId) override
+        {
+            unblocked.wait();
+            return Result<std::vector<std::byte>>::Success({ std::byte(channelId) });
+        }
+
+        Result<ftl_stream_id_t> StartStream(ftl_channel_id_t channelId) override
+        {
+            unblocked.wait();
+            ++NumCalls;
+            return Result<ftl_stream_id_t>::Success(channelId + 100);
+        }
+
+        Result<ServiceResponse> UpdateStreamMetadata(ftl_stream_id_t, StreamMetadata) override
+        {
+            return Result<ServiceResponse>::Success(ServiceResponse::Ok);
+        }
+
+        std::vector<Result<ServiceResponse>> UpdateStreamMetadataBatch(
+            const std::vector<std::pair<ftl_stream_id_t, StreamMetadata>>& updates) override
+        {
+            unblocked.wait();
+            throw std::runtime_error("Service unavailable");
+        }
+
+        Result<void> EndStream(ftl_stream_id_t) override
+        {
+            unblocked.wait();
+            return Result<void>::Error("Unknown stream");
+        }
+
+        Result<void> SendJpegPreviewImage(ftl_stream_id_t, std::vector<uint8_t>) override
+        {
+            return Result<void>::Success();
+        }
+
+        std::atomic<int> NumCalls { 0 };
+
+    private:
+        std::shared_future<void> unblocked;
+    };
+}
+
+TEST_CASE( "AsyncServiceConnection runs calls off of the calling thread", "[serviceconnections]" )
+{
+    std::promise<void> unblock;
+    auto connection = std::make_shared<FakeServiceConnection>(unblock.get_future().share());
+    AsyncServiceConnection asyncConnection(connection, 2);
+
+    std::future<Result<ftl_stream_id_t>> started = asyncConnection.StartStream(1);
+    std::future<Result<void>> ended = asyncConnection.EndStream(2);
+    std::future<std::vector<Result<ServiceConnection::ServiceResponse>>> updated =
+        asyncConnection.UpdateStreamMetadataBatch({ { 3, StreamMetadata {} },
+            { 4, StreamMetadata {} } });
+
+    // Calls don't block the caller while the service is slow
+    CHECK(started.wait_for(20ms) == std::future_status::timeout);
+    unblock.set_value();
+
+    REQUIRE(started.wait_for(5s) == std::future_status::ready);
+    Result<ftl_stream_id_t> startResult = started.get();
+    REQUIRE_FALSE(startResult.IsError);
+    CHECK(startResult.Value == 101);
+
+    REQUIRE(ended.wait_for(5s) == std::future_status::ready);
+    CHECK(ended.get().ErrorMessage == "Unknown stream");
+
+    // Exceptions become an error result for every update in the batch
+    REQUIRE(updated.wait_for(5s) == std::future_status::ready);
+    std::vector<Result<ServiceConnection::ServiceResponse>> updateResults = updated.get();
+    REQUIRE(updateResults.size() == 2);
+    CHECK(updateResults[0].IsError);
+    CHECK(updateResults[1].ErrorMessage == "Service unavailable");
+}
+
+TEST_CASE( "AsyncServiceConnection fails calls it can't run", "[serviceconnections]" )
+{
+    std::promise<void> unblock;
+    auto connection = std::make_shared<FakeServiceConnection>(unblock.get_future().share());
+    std::vector<std::future<Result<ftl_stream_id_t>>> results;
+    {
+        AsyncServiceConnection asyncConnection(connection, 1);
+        // The first call occupies the only I/O thread, so the rest stay queued
+        results.push_back(asyncConnection.StartStream(1));
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+        while ((asyncConnection.GetPendingCallCount() > 0) &&
+            (std::chrono::steady_clock::now() < deadline))
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        for (size_t i = 0; i <= AsyncServiceConnection::MAX_PENDING_CALLS; ++i)
+        {
+            results.push_back(asyncConnection.StartStream(2));
+        }
+        CHECK(asyncConnection.GetPendingCallCount() == AsyncServiceConnection::MAX_PENDING_CALLS);
+
+        // Once the queue is full, calls fail right away
+        REQUIRE(results.back().wait_for(0ms) == std::future_status::ready);
+        CHECK(results.back().get().IsError);
+        results.pop_back();
+
+        unblock.set_value();
+    }
+
+    // The call in progress finishes, and anything still queued at shutdown fails.
+    // Nothing is left waiting forever.
+    size_t numSucceeded = 0;
+    for (auto& result : results)
+    {
+        REQUIRE(result.wait_for(0ms) == std::future_status::ready);
+        numSucceeded += result.get().IsError ? 0 : 1;
+    }
+    CHECK(numSucceeded == static_cast<size_t>(connection->NumCalls.load()));
+    CHECK(numSucceeded >= 1);
+}
+
+TEST_CASE( "AsyncServiceConnection records how long each kind of call takes",
+    "[serviceconnections]" )
+{
+    std::promise<void> unblock;
+    unblock.set_value();
+    auto connection = std::make_shared<FakeServiceConnection>(unblock.get_future().share());
+    auto metrics = std::make_shared<MetricsRegistry>();
+    const std::string metricName = "ftl_service_call_seconds";
+    const std::string metricHelp = "Time taken by calls to the service connection";
+    {
+        AsyncServiceConnection asyncConnection(connection, 1, metrics);
+        REQUIRE(asyncConnection.StartStream(1).wait_for(5s) == std::future_status::ready);
+        REQUIRE(asyncConnection.StartStream(2).wait_for(5s) == std::future_status::ready);
+        // Calls that throw are timed too
+        REQUIRE(asyncConnection.UpdateStreamMetadataBatch({ { 3, StreamMetadata {} } })
+            .wait_for(5s) == std::future_status::ready);
+
+        CHECK(metrics->AddHistogram(metricName, metricHelp, { { "method", "StartStream" } })
+            ->GetSnapshot().Count == 2);
+        CHECK(metrics->AddHistogram(metricName, metricHelp,
+            { { "method", "UpdateStreamMetadataBatch" } })->GetSnapshot().Count == 1);
+        CHECK(metrics->AddHistogram(metricName, metricHelp, { { "method", "EndStream" } })
+            ->GetSnapshot().Count == 0);
+    }
+}
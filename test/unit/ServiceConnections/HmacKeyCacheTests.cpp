@@ -0,0 +1,145 @@
+/**
+ * @file HmacKeyCacheTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../../../src/ServiceConnections/HmacKeyCache.h"
+
+namespace
+{
+    const std::vector<std::byte> TEST_KEY { std::byte('k'), std::byte('e'), std::byte('y') };
+    // Channel the fake service doesn't know about
+    constexpr ftl_channel_id_t UNKNOWN_CHANNEL_ID = 404;
+
+    struct FakeService
+    {
+        std::atomic<int> Requests { 0 };
+
+        Result<std::vector<std::byte>> GetHmacKey(ftl_channel_id_t channelId)
+        {
+            ++Requests;
+            if (channelId == UNKNOWN_CHANNEL_ID)
+            {
+                return Result<std::vector<std::byte>>::Error("Unknown channel");
+            }
+            return Result<std::vector<std::byte>>::Success(TEST_KEY);
+        }
+    };
+}
+
+TEST_CASE( "HmacKeyCache caches keys until they expire", "[serviceconnections]" )
+{
+    using namespace std::chrono_literals;
+    FakeService service;
+    HmacKeyCache cache(
+        [&service](ftl_channel_id_t channelId) { return service.GetHmacKey(channelId); },
+        50ms, 0ms);
+
+    Result<std::vector<std::byte>> result = cache.GetHmacKey(1);
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value == TEST_KEY);
+    CHECK(cache.GetHmacKey(1).Value == TEST_KEY);
+    CHECK(service.Requests == 1);
+
+    // Other channels are looked up separately
+    CHECK_FALSE(cache.GetHmacKey(2).IsError);
+    CHECK(service.Requests == 2);
+
+    SECTION( "expired keys are fetched again" )
+    {
+        std::this_thread::sleep_for(60ms);
+        CHECK_FALSE(cache.GetHmacKey(1).IsError);
+        CHECK(service.Requests == 3);
+    }
+
+    SECTION( "invalidated keys are fetched again" )
+    {
+        cache.Invalidate(1);
+        CHECK(cache.GetSize() == 1);
+        CHECK_FALSE(cache.GetHmacKey(1).IsError);
+        CHECK(service.Requests == 3);
+    }
+
+    SECTION( "failures aren't cached without a negative TTL" )
+    {
+        CHECK(cache.GetHmacKey(UNKNOWN_CHANNEL_ID).IsError);
+        CHECK(cache.GetHmacKey(UNKNOWN_CHANNEL_ID).IsError);
+        CHECK(service.Requests == 4);
+        CHECK(cache.GetSize() == 2);
+    }
+}
+
+TEST_CASE( "HmacKeyCache caches failed lookups separately", "[serviceconnections]" )
+{
+    using namespace std::chrono_literals;
+    FakeService service;
+    HmacKeyCache cache(
+        [&service](ftl_channel_id_t channelId) { return service.GetHmacKey(channelId); },
+        10s, 50ms);
+
+    CHECK(cache.GetHmacKey(UNKNOWN_CHANNEL_ID).IsError);
+    CHECK(cache.GetHmacKey(UNKNOWN_CHANNEL_ID).IsError);
+    CHECK(service.Requests == 1);
+
+    std::this_thread::sleep_for(60ms);
+    CHECK(cache.GetHmacKey(UNKNOWN_CHANNEL_ID).IsError);
+    CHECK(service.Requests == 2);
+}
+
+TEST_CASE( "HmacKeyCache reports exceptions as errors", "[serviceconnections]" )
+{
+    using namespace std::chrono_literals;
+    HmacKeyCache cache(
+        [](ftl_channel_id_t) -> Result<std::vector<std::byte>>
+        {
+            throw std::runtime_error("Service unreachable");
+        },
+        10s, 10s);
+
+    Result<std::vector<std::byte>> result = cache.GetHmacKey(1);
+    CHECK(result.IsError);
+    CHECK(result.ErrorMessage == "Service unreachable");
+}
+
+TEST_CASE( "HmacKeyCache shares one lookup between concurrent callers", "[serviceconnections]" )
+{
+    using namespace std::chrono_literals;
+    FakeService service;
+    std::promise<void> unblock;
+    std::shared_future<void> unblocked = unblock.get_future().share();
+    HmacKeyCache cache(
+        [&service, unblocked](ftl_channel_id_t channelId)
+        {
+            unblocked.wait();
+            return service.GetHmacKey(channelId);
+        },
+        10s, 0ms);
+
+    std::vector<std::future<Result<std::vector<std::byte>>>> callers;
+    for (int i = 0; i < 8; ++i)
+    {
+        callers.push_back(std::async(std::launch::async,
+            [&cache]() { return cache.GetHmacKey(1); }));
+    }
+    // Give every caller a chance to pile up behind the first lookup
+    std::this_thread::sleep_for(20ms);
+    unblock.set_value();
+
+    for (auto& caller : callers)
+    {
+        Result<std::vector<std::byte>> result = caller.get();
+        REQUIRE_FALSE(result.IsError);
+        CHECK(result.Value == TEST_KEY);
+    }
+    CHECK(service.Requests == 1);
+}
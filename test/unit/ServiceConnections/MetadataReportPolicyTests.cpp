@@ -0,0 +1,136 @@
+/**
+ * @file MetadataReportPolicyTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/ServiceConnections/MetadataReportPolicy.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    StreamMetadata steadyMetadata()
+    {
+        return StreamMetadata
+        {
+            .streamTimeSeconds = 60,
+            .numActiveViewers = 10,
+            .currentSourceBitrateBps = 5000000,
+            .numPacketsReceived = 1000,
+            .numPacketsNacked = 5,
+            .numPacketsLost = 2,
+            .videoCodec = "H264",
+            .audioCodec = "OPUS",
+            .videoWidth = 1920,
+            .videoHeight = 1080,
+        };
+    }
+
+    const MetadataReportPolicy::Policy HEARTBEAT_POLICY
+    {
+        .HeartbeatInterval = 60000ms,
+        .BitrateChangeThreshold = 0.1,
+        .HeartbeatJitter = 0.0,
+    };
+}
+
+TEST_CASE("MetadataReportPolicy reports every stream when there's no heartbeat interval",
+    "[service]")
+{
+    MetadataReportPolicy policy(MetadataReportPolicy::Policy { });
+    const auto now = MetadataReportPolicy::Clock::now();
+    policy.Reported(1, steadyMetadata(), now);
+    CHECK(policy.ShouldReport(1, steadyMetadata(), now));
+    CHECK(policy.GetStreamCount() == 0);
+}
+
+TEST_CASE("MetadataReportPolicy only reports unchanged streams as a heartbeat", "[service]")
+{
+    MetadataReportPolicy policy(HEARTBEAT_POLICY);
+    const auto start = MetadataReportPolicy::Clock::now();
+    CHECK(policy.ShouldReport(1, steadyMetadata(), start));
+    policy.Reported(1, steadyMetadata(), start);
+
+    // Counters that always go up, and small bitrate wobbles, aren't worth a report
+    StreamMetadata metadata = steadyMetadata();
+    metadata.streamTimeSeconds += 30;
+    metadata.numPacketsReceived += 5000;
+    metadata.numPacketsNacked += 10;
+    metadata.currentSourceBitrateBps = 5400000;
+    CHECK_FALSE(policy.ShouldReport(1, metadata, (start + 30s)));
+    CHECK(policy.ShouldReport(1, metadata, (start + 60s)));
+
+    policy.RemoveStream(1);
+    CHECK(policy.GetStreamCount() == 0);
+    CHECK(policy.ShouldReport(1, metadata, (start + 30s)));
+}
+
+TEST_CASE("MetadataReportPolicy reports meaningful changes straight away", "[service]")
+{
+    MetadataReportPolicy policy(HEARTBEAT_POLICY);
+    const auto start = MetadataReportPolicy::Clock::now();
+    policy.Reported(1, steadyMetadata(), start);
+    const auto soon = (start + 1s);
+
+    StreamMetadata metadata = steadyMetadata();
+    metadata.numActiveViewers = 11;
+    CHECK(policy.ShouldReport(1, metadata, soon));
+
+    metadata = steadyMetadata();
+    metadata.numPacketsLost = 3;
+    CHECK(policy.ShouldReport(1, metadata, soon));
+
+    metadata = steadyMetadata();
+    metadata.currentSourceBitrateBps = 4500000;
+    CHECK(policy.ShouldReport(1, metadata, soon));
+
+    metadata = steadyMetadata();
+    metadata.videoWidth = 1280;
+    metadata.videoHeight = 720;
+    CHECK(policy.ShouldReport(1, metadata, soon));
+
+    // A stream starting to send after sending nothing is a change too
+    StreamMetadata idle = steadyMetadata();
+    idle.currentSourceBitrateBps = 0;
+    policy.Reported(2, idle, start);
+    CHECK_FALSE(policy.ShouldReport(2, idle, soon));
+    CHECK(policy.ShouldReport(2, steadyMetadata(), soon));
+
+    // Reporting a change pushes the heartbeat back
+    policy.Reported(1, metadata, (start + 30s));
+    CHECK_FALSE(policy.ShouldReport(1, metadata, (start + 60s)));
+    CHECK(policy.ShouldReport(1, metadata, (start + 90s)));
+}
+
+TEST_CASE("MetadataReportPolicy spreads heartbeats out without making them late", "[service]")
+{
+    MetadataReportPolicy::Policy jitteredPolicy = HEARTBEAT_POLICY;
+    jitteredPolicy.HeartbeatJitter = 0.5;
+    MetadataReportPolicy policy(jitteredPolicy, 1234);
+    const auto start = MetadataReportPolicy::Clock::now();
+
+    constexpr ftl_stream_id_t NUM_STREAMS = 100;
+    for (ftl_stream_id_t streamId = 0; streamId < NUM_STREAMS; ++streamId)
+    {
+        policy.Reported(streamId, steadyMetadata(), start);
+    }
+
+    // Every heartbeat falls in the back half of the interval, and they don't all fall together
+    size_t dueEarly = 0;
+    size_t dueAtHalfway = 0;
+    size_t dueByInterval = 0;
+    for (ftl_stream_id_t streamId = 0; streamId < NUM_STREAMS; ++streamId)
+    {
+        dueEarly += policy.ShouldReport(streamId, steadyMetadata(), (start + 29s)) ? 1 : 0;
+        dueAtHalfway += policy.ShouldReport(streamId, steadyMetadata(), (start + 45s)) ? 1 : 0;
+        dueByInterval += policy.ShouldReport(streamId, steadyMetadata(), (start + 60s)) ? 1 : 0;
+    }
+    CHECK(dueEarly == 0);
+    CHECK(dueAtHalfway > 10);
+    CHECK(dueAtHalfway < 90);
+    CHECK(dueByInterval == NUM_STREAMS);
+}
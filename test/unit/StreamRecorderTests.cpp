@@ -0,0 +1,204 @@
+/**
+ * @file StreamRecorderTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../src/Rtp/RtpPacket.h"
+#include "../../src/StreamRecorder.h"
+#include "../../src/Utilities/PcapReader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr rtp_payload_type_t VIDEO_PAYLOAD_TYPE = 96;
+    constexpr rtp_payload_type_t AUDIO_PAYLOAD_TYPE = 97;
+    // An IDR slice, and a slice predicted from it
+    constexpr uint8_t IDR_NAL_HEADER = 0x65;
+    constexpr uint8_t NON_IDR_NAL_HEADER = 0x41;
+
+    MediaMetadata recordedMetadata(bool hasVideo = true)
+    {
+        return MediaMetadata
+        {
+            .HasVideo = hasVideo,
+            .HasAudio = true,
+            .VideoCodec = VideoCodecKind::H264,
+            .AudioCodec = AudioCodecKind::Opus,
+            .VideoPayloadType = VIDEO_PAYLOAD_TYPE,
+            .AudioPayloadType = AUDIO_PAYLOAD_TYPE,
+        };
+    }
+
+    PacketBuffer recordedPacket(rtp_payload_type_t payloadType, rtp_sequence_num_t sequence,
+        rtp_timestamp_t timestamp, uint8_t firstPayloadByte, size_t payloadSize = 100)
+    {
+        std::vector<std::byte> bytes(12 + payloadSize, std::byte(sequence & 0xFF));
+        RtpHeader* header = reinterpret_cast<RtpHeader*>(bytes.data());
+        header->Version = 2;
+        header->CsrcCount = 0;
+        header->Extension = 0;
+        header->Padding = 0;
+        header->MarkerBit = 0;
+        header->Type = payloadType;
+        header->SequenceNumber = htons(sequence);
+        header->Timestamp = htonl(timestamp);
+        bytes[12] = std::byte(firstPayloadByte);
+        return PacketBuffer::Copy(bytes);
+    }
+
+    std::filesystem::path recordingDirectory(const std::string& testName)
+    {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() /
+            ("janus-ftl-recording-" + testName + "-" + std::to_string(getpid()));
+        std::filesystem::remove_all(directory);
+        return directory;
+    }
+
+    std::filesystem::path segmentPath(const StreamRecorder& recorder, int index,
+        const char* extension = StreamRecorder::SEGMENT_EXTENSION)
+    {
+        return fmt::format("{}-{:04}{}", recorder.GetSegmentPathPrefix().string(), index,
+            extension);
+    }
+
+    std::vector<rtp_sequence_num_t> recordedSequences(const std::filesystem::path& path)
+    {
+        std::ifstream input(path, std::ios::binary);
+        PcapReader reader(input);
+        std::vector<rtp_sequence_num_t> sequences;
+        while (std::optional<PcapReader::UdpDatagram> datagram = reader.ReadNextUdpDatagram())
+        {
+            sequences.push_back(RtpPacket::GetRtpSequence(datagram->Payload));
+        }
+        return sequences;
+    }
+}
+
+TEST_CASE("StreamRecorder writes captures the replay tool can read", "[recording]")
+{
+    const std::filesystem::path directory = recordingDirectory("capture");
+    Result<std::unique_ptr<StreamRecorder>> startResult =
+        StreamRecorder::Start(directory, 1234, 5678, recordedMetadata());
+    REQUIRE_FALSE(startResult.IsError);
+    StreamRecorder& recorder = *startResult.Value;
+
+    std::vector<PacketBuffer> packets
+    {
+        recordedPacket(VIDEO_PAYLOAD_TYPE, 10, 9000, IDR_NAL_HEADER),
+        recordedPacket(VIDEO_PAYLOAD_TYPE, 11, 9000, IDR_NAL_HEADER),
+        recordedPacket(AUDIO_PAYLOAD_TYPE, 500, 480, 0),
+        recordedPacket(VIDEO_PAYLOAD_TYPE, 12, 12000, NON_IDR_NAL_HEADER, 1000),
+    };
+    for (const PacketBuffer& packet : packets)
+    {
+        recorder.SendRtpPacket(packet);
+    }
+    recorder.Stop();
+    // Anything sent once stopped is ignored
+    recorder.SendRtpPacket(packets.front());
+
+    const StreamRecorder::Stats stats = recorder.GetStats();
+    CHECK(stats.RecordedPackets == 4);
+    CHECK(stats.DroppedPackets == 0);
+    CHECK(stats.WriteErrors == 0);
+    CHECK(stats.Segments == 1);
+    CHECK(stats.QueuedPackets == 0);
+    CHECK(std::filesystem::file_size(segmentPath(recorder, 0)) == (24 + stats.RecordedBytes));
+
+    std::ifstream input(segmentPath(recorder, 0), std::ios::binary);
+    PcapReader reader(input);
+    CHECK(reader.GetLinkType() == PcapReader::LINK_TYPE_RAW);
+    for (const PacketBuffer& packet : packets)
+    {
+        std::optional<PcapReader::UdpDatagram> datagram = reader.ReadNextUdpDatagram();
+        REQUIRE(datagram.has_value());
+        CHECK(datagram->DestinationPort == StreamRecorder::RECORDED_PORT);
+        CHECK(datagram->Timestamp.count() > 0);
+        CHECK(std::equal(datagram->Payload.begin(), datagram->Payload.end(),
+            packet.Bytes().begin(), packet.Bytes().end()));
+    }
+    CHECK_FALSE(reader.ReadNextUdpDatagram().has_value());
+    CHECK(reader.GetSkippedFrameCount() == 0);
+
+    // The one keyframe starts straight after the capture's header
+    std::ifstream index(segmentPath(recorder, 0, StreamRecorder::INDEX_EXTENSION));
+    uint64_t offset = 0;
+    int64_t captureTime = 0;
+    uint32_t rtpTimestamp = 0;
+    REQUIRE(index >> offset >> captureTime >> rtpTimestamp);
+    CHECK(offset == 24);
+    CHECK(rtpTimestamp == 9000);
+    CHECK_FALSE(index >> offset);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StreamRecorder rotates segments at the first keyframe past their size", "[recording]")
+{
+    const std::filesystem::path directory = recordingDirectory("rotate");
+    Result<std::unique_ptr<StreamRecorder>> startResult =
+        StreamRecorder::Start(directory, 1, 2, recordedMetadata(), 2000);
+    REQUIRE_FALSE(startResult.IsError);
+    StreamRecorder& recorder = *startResult.Value;
+
+    rtp_sequence_num_t sequence = 0;
+    recorder.SendRtpPacket(recordedPacket(VIDEO_PAYLOAD_TYPE, sequence++, 0, IDR_NAL_HEADER));
+    for (int i = 0; i < 20; ++i)
+    {
+        recorder.SendRtpPacket(
+            recordedPacket(VIDEO_PAYLOAD_TYPE, sequence++, 3000, NON_IDR_NAL_HEADER));
+    }
+    recorder.SendRtpPacket(recordedPacket(VIDEO_PAYLOAD_TYPE, sequence++, 6000, IDR_NAL_HEADER));
+    recorder.SendRtpPacket(recordedPacket(VIDEO_PAYLOAD_TYPE, sequence++, 6000, IDR_NAL_HEADER));
+    recorder.Stop();
+
+    // 21 packets is past the size but short of twice it, so the segment waits on a keyframe
+    CHECK(recorder.GetStats().Segments == 2);
+    CHECK(recordedSequences(segmentPath(recorder, 0)).size() == 21);
+    CHECK_THAT(recordedSequences(segmentPath(recorder, 1)),
+        Catch::Equals(std::vector<rtp_sequence_num_t> { 21, 22 }));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StreamRecorder rotates segments without keyframes at their size", "[recording]")
+{
+    const std::filesystem::path directory = recordingDirectory("rotate-audio");
+    Result<std::unique_ptr<StreamRecorder>> startResult =
+        StreamRecorder::Start(directory, 1, 2, recordedMetadata(false), 1000);
+    REQUIRE_FALSE(startResult.IsError);
+    StreamRecorder& recorder = *startResult.Value;
+
+    // Each packet takes up 156 bytes of capture
+    for (rtp_sequence_num_t sequence = 0; sequence < 14; ++sequence)
+    {
+        recorder.SendRtpPacket(recordedPacket(AUDIO_PAYLOAD_TYPE, sequence, 0, 0));
+    }
+    recorder.Stop();
+
+    CHECK(recorder.GetStats().Segments == 2);
+    CHECK(recordedSequences(segmentPath(recorder, 0)).size() == 7);
+    CHECK(recordedSequences(segmentPath(recorder, 1)).size() == 7);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("StreamRecorder fails to start somewhere it can't write", "[recording]")
+{
+    const std::filesystem::path directory = recordingDirectory("unwritable");
+    std::filesystem::create_directories(directory.parent_path());
+    // A file where the directory should be
+    std::ofstream(directory) << "not a directory";
+
+    CHECK(StreamRecorder::Start(directory, 1, 2, recordedMetadata()).IsError);
+
+    std::filesystem::remove(directory);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file BitratePolicerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+
+#include "../../../src/Utilities/BitratePolicer.h"
+
+using Verdict = BitratePolicer<>::Verdict;
+
+TEST_CASE("BitratePolicer drops packets over the limit, then reports repeated violations",
+    "[utilities]")
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    // 8000bps is 1000 bytes a second, with a 2000 byte burst
+    BitratePolicer policer(8000, 2000, 3, start);
+
+    CHECK(policer.Police(start, 1000) == Verdict::Accept);
+    CHECK(policer.Police(start, 1000) == Verdict::Accept);
+    CHECK(policer.Police(start, 1000) == Verdict::Drop);
+    CHECK(policer.GetViolations() == 1);
+
+    // Half a second later, another 500 bytes fit
+    CHECK(policer.Police(start + 500ms, 500) == Verdict::Accept);
+    CHECK(policer.Police(start + 500ms, 500) == Verdict::Drop);
+    CHECK_FALSE(policer.HasExceeded());
+    CHECK(policer.Police(start + 600ms, 500) == Verdict::Exceeded);
+    CHECK(policer.HasExceeded());
+
+    // Only reported once
+    CHECK(policer.Police(start + 600ms, 500) == Verdict::Drop);
+}
+
+TEST_CASE("BitratePolicer doesn't count spikes far apart together", "[utilities]")
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    // With no burst given, the stream gets one second's worth
+    BitratePolicer policer(8000, 0, 2, start);
+
+    CHECK(policer.Police(start, 1000) == Verdict::Accept);
+    CHECK(policer.Police(start, 1) == Verdict::Drop);
+    CHECK(policer.Police(start + 2s, 1000) == Verdict::Accept);
+    CHECK(policer.Police(start + 2s, 1) == Verdict::Drop);
+    CHECK(policer.GetViolations() == 1);
+    CHECK(policer.Police(start + 2s, 1) == Verdict::Exceeded);
+
+    SECTION("Violations are only ever dropped without a violation limit")
+    {
+        BitratePolicer unlimitedPolicer(8000, 1000, 0, start);
+        CHECK(unlimitedPolicer.Police(start, 1000) == Verdict::Accept);
+        for (int i = 0; i < 100; ++i)
+        {
+            CHECK(unlimitedPolicer.Police(start, 1000) == Verdict::Drop);
+        }
+        CHECK_FALSE(unlimitedPolicer.HasExceeded());
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file BoundedPacketQueueTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "../../../src/Utilities/BoundedPacketQueue.h"
+
+using PacketKind = BoundedPacketQueue::PacketKind;
+
+static PacketBuffer makePacket(uint8_t value)
+{
+    std::byte byte = std::byte(value);
+    return PacketBuffer::Copy(std::span<const std::byte>(&byte, 1));
+}
+
+static std::vector<uint8_t> drain(BoundedPacketQueue& queue)
+{
+    std::vector<uint8_t> values;
+    std::array<PacketBuffer, 4> buffers;
+    while (size_t numPopped = queue.PopFront(buffers))
+    {
+        for (size_t i = 0; i < numPopped; ++i)
+        {
+            values.push_back(static_cast<uint8_t>(buffers[i].Bytes()[0]));
+        }
+    }
+    return values;
+}
+
+TEST_CASE( "BoundedPacketQueue is a FIFO until it fills up", "[utilities]" )
+{
+    BoundedPacketQueue queue(8);
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        PacketKind kind = (i == 0) ? PacketKind::Keyframe : PacketKind::Dependent;
+        REQUIRE(queue.Push(makePacket(i), kind));
+    }
+    CHECK(queue.Size() == 8);
+    CHECK(drain(queue) == std::vector<uint8_t>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+    CHECK(queue.Empty());
+    CHECK(queue.GetStats().EnqueuedPackets == 8);
+    CHECK(queue.GetStats().DroppedPackets == 0);
+}
+
+TEST_CASE( "BoundedPacketQueue sheds dependent packets until the next keyframe", "[utilities]" )
+{
+    BoundedPacketQueue queue(4);
+    REQUIRE(queue.Push(makePacket(0), PacketKind::Keyframe));
+    REQUIRE(queue.Push(makePacket(1), PacketKind::Dependent));
+    REQUIRE(queue.Push(makePacket(2), PacketKind::Independent));
+    REQUIRE(queue.Push(makePacket(3), PacketKind::Dependent));
+
+    // Overflowing drops the queued dependent packets along with the one that overflowed
+    CHECK_FALSE(queue.Push(makePacket(4), PacketKind::Dependent));
+    CHECK(queue.IsAwaitingKeyframe());
+    CHECK(queue.GetStats().Overflows == 1);
+    CHECK(queue.GetStats().DroppedPackets == 3);
+
+    // Independent packets still get through while we wait on a keyframe
+    CHECK(queue.Push(makePacket(5), PacketKind::Independent));
+    CHECK_FALSE(queue.Push(makePacket(6), PacketKind::Dependent));
+    CHECK(queue.Push(makePacket(7), PacketKind::Keyframe));
+    CHECK_FALSE(queue.IsAwaitingKeyframe());
+
+    // With no dependent packets to shed, the oldest independent packet makes way instead
+    CHECK(queue.Push(makePacket(8), PacketKind::Independent));
+    CHECK(queue.Push(makePacket(9), PacketKind::Dependent));
+    CHECK(queue.GetStats().Overflows == 3);
+    CHECK(drain(queue) == std::vector<uint8_t>({ 0, 7, 8, 9 }));
+}
+
+TEST_CASE( "BoundedPacketQueue doesn't wait on keyframes for streams without them", "[utilities]" )
+{
+    BoundedPacketQueue queue(2);
+    REQUIRE(queue.Push(makePacket(0), PacketKind::Dependent));
+    REQUIRE(queue.Push(makePacket(1), PacketKind::Dependent));
+    CHECK(queue.Push(makePacket(2), PacketKind::Dependent));
+    CHECK_FALSE(queue.IsAwaitingKeyframe());
+    CHECK(queue.Push(makePacket(3), PacketKind::Dependent));
+    CHECK(drain(queue) == std::vector<uint8_t>({ 2, 3 }));
+}
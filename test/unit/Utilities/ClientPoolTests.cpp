@@ -0,0 +1,100 @@
+/**
+ * @file ClientPoolTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <future>
+#include <vector>
+
+#include "../../../src/Utilities/ClientPool.h"
+
+namespace
+{
+    struct FakeClient
+    {
+        int Id;
+    };
+}
+
+TEST_CASE( "ClientPool reuses idle clients", "[utilities]" )
+{
+    int numCreated = 0;
+    ClientPool<FakeClient> pool(
+        [&numCreated]() { return std::make_unique<FakeClient>(FakeClient { ++numCreated }); });
+
+    {
+        auto first = pool.Acquire();
+        // A second caller can't share a client that's already leased
+        auto second = pool.Acquire();
+        CHECK(first->Id == 1);
+        CHECK(second->Id == 2);
+    }
+    CHECK(pool.GetIdleCount() == 2);
+
+    // The most recently returned client is handed out first
+    CHECK(pool.Acquire()->Id == 1);
+    CHECK(numCreated == 2);
+
+    SECTION( "discarded clients are replaced" )
+    {
+        {
+            auto lease = pool.Acquire();
+            lease.Discard();
+        }
+        CHECK(pool.GetIdleCount() == 1);
+        CHECK(pool.Acquire()->Id == 2);
+    }
+
+    SECTION( "cleared clients are replaced" )
+    {
+        pool.Clear();
+        CHECK(pool.GetIdleCount() == 0);
+        CHECK(pool.Acquire()->Id == 3);
+    }
+}
+
+TEST_CASE( "ClientPool limits the number of idle clients", "[utilities]" )
+{
+    ClientPool<FakeClient> pool([]() { return std::make_unique<FakeClient>(); }, 2);
+    {
+        std::vector<ClientPool<FakeClient>::Lease> leases;
+        for (int i = 0; i < 4; ++i)
+        {
+            leases.push_back(pool.Acquire());
+        }
+    }
+    CHECK(pool.GetIdleCount() == 2);
+}
+
+TEST_CASE( "ClientPool leases clients across threads", "[utilities]" )
+{
+    std::atomic<int> numCreated { 0 };
+    ClientPool<FakeClient> pool(
+        [&numCreated]() { return std::make_unique<FakeClient>(FakeClient { ++numCreated }); });
+
+    std::vector<std::future<void>> callers;
+    for (int i = 0; i < 4; ++i)
+    {
+        callers.push_back(std::async(std::launch::async,
+            [&pool]()
+            {
+                for (int request = 0; request < 1000; ++request)
+                {
+                    auto lease = pool.Acquire();
+                    ++lease->Id;
+                }
+            }));
+    }
+    for (auto& caller : callers)
+    {
+        caller.get();
+    }
+
+    // Every client was reused rather than created per request
+    CHECK(numCreated <= 4);
+    CHECK(pool.GetIdleCount() == static_cast<size_t>(numCreated.load()));
+}
@@ -0,0 +1,55 @@
+/**
+ * @file CpuTopologyTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "../../../src/Utilities/CpuTopology.h"
+
+TEST_CASE("CpuTopology parses and formats kernel CPU lists", "[utilities]")
+{
+    REQUIRE(CpuTopology::ParseCpuList("0-3,8,10-11") ==
+        std::vector<int> { 0, 1, 2, 3, 8, 10, 11 });
+    // Order is kept, so workers can be pinned in whatever order is listed
+    REQUIRE(CpuTopology::ParseCpuList(" 8, 2-3 ,2,") == std::vector<int> { 8, 2, 3 });
+    REQUIRE(CpuTopology::ParseCpuList("").empty());
+
+    REQUIRE_THROWS_AS(CpuTopology::ParseCpuList("1x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(CpuTopology::ParseCpuList("-1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(CpuTopology::ParseCpuList("5-2"), std::invalid_argument);
+    REQUIRE_THROWS_AS(CpuTopology::ParseCpuList("0-100000"), std::invalid_argument);
+
+    const std::vector<int> cpus { 0, 1, 2, 3, 8, 10, 11 };
+    REQUIRE(CpuTopology::FormatCpuList(cpus) == "0-3,8,10-11");
+    REQUIRE(CpuTopology::FormatCpuList(std::vector<int> {}).empty());
+}
+
+TEST_CASE("CpuTopology reads NUMA nodes out of sysfs", "[utilities]")
+{
+    const std::filesystem::path sysfsPath = std::filesystem::temp_directory_path() /
+        ("janus-ftl-cpu-topology-" + std::to_string(getpid()));
+    std::filesystem::create_directories(sysfsPath / "cpu" / "cpu0" / "node0");
+    std::filesystem::create_directories(sysfsPath / "cpu" / "cpu3" / "node1");
+    // Without the kernel telling us otherwise, everything is on node 0
+    std::filesystem::create_directories(sysfsPath / "cpu" / "cpu4" / "topology");
+    std::filesystem::create_directories(sysfsPath / "node" / "node1");
+    std::ofstream(sysfsPath / "node" / "node1" / "cpulist") << "2-3,6\n";
+
+    REQUIRE(CpuTopology::GetNumaNode(0, sysfsPath) == 0);
+    REQUIRE(CpuTopology::GetNumaNode(3, sysfsPath) == 1);
+    REQUIRE(CpuTopology::GetNumaNode(4, sysfsPath) == 0);
+    REQUIRE(CpuTopology::GetNumaNode(5, sysfsPath) == CpuTopology::UNKNOWN_NUMA_NODE);
+    REQUIRE(CpuTopology::GetNumaNode(-1, sysfsPath) == CpuTopology::UNKNOWN_NUMA_NODE);
+
+    REQUIRE(CpuTopology::GetNumaNodeCpus(1, sysfsPath) == std::vector<int> { 2, 3, 6 });
+    REQUIRE(CpuTopology::GetNumaNodeCpus(2, sysfsPath).empty());
+
+    std::filesystem::remove_all(sysfsPath);
+}
@@ -0,0 +1,223 @@
+/**
+ * @file DatagramFanoutQueueTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <array>
+#include <optional>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../../../src/Utilities/DatagramFanoutQueue.h"
+
+namespace
+{
+    PacketBuffer makePacket(int value)
+    {
+        std::byte byteValue = std::byte(value);
+        return PacketBuffer::Copy(std::span<const std::byte>(&byteValue, 1));
+    }
+
+    std::optional<std::byte> readPacket(int socketHandle, int timeoutMs = 5000)
+    {
+        pollfd readPollFd { .fd = socketHandle, .events = POLLIN, .revents = 0 };
+        if (poll(&readPollFd, 1, timeoutMs) != 1)
+        {
+            return std::nullopt;
+        }
+        std::byte received;
+        if (read(socketHandle, &received, 1) != 1)
+        {
+            return std::nullopt;
+        }
+        return received;
+    }
+}
+
+TEST_CASE( "DatagramFanoutQueue sends every packet to every target in order", "[utilities]" )
+{
+    constexpr size_t NUM_TARGETS = 3;
+    constexpr int NUM_PACKETS = 200;
+    std::array<std::array<int, 2>, NUM_TARGETS> sockets;
+    for (auto& socketPair : sockets)
+    {
+        REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, socketPair.data()) == 0);
+    }
+
+    {
+        DatagramFanoutQueue fanoutQueue;
+        std::vector<DatagramFanoutQueue::TargetId> targetIds;
+        for (const auto& socketPair : sockets)
+        {
+            targetIds.push_back(fanoutQueue.AddTarget(socketPair[0]));
+        }
+        CHECK(fanoutQueue.GetTargetCount() == NUM_TARGETS);
+
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            REQUIRE(fanoutQueue.Enqueue(makePacket(i),
+                BoundedPacketQueue::PacketKind::Independent));
+        }
+
+        // The local socket buffers are small, so read as we go to let the queue keep draining
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            for (const auto& socketPair : sockets)
+            {
+                std::optional<std::byte> received = readPacket(socketPair[1]);
+                REQUIRE(received.has_value());
+                CHECK(received.value() == std::byte(i));
+            }
+        }
+
+        for (const DatagramFanoutQueue::TargetId& targetId : targetIds)
+        {
+            // The sender might not have counted its last batch yet
+            DatagramSendQueue::Stats stats = fanoutQueue.GetTargetStats(targetId);
+            for (int i = 0; (i < 100) && (stats.SentPackets < NUM_PACKETS); ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                stats = fanoutQueue.GetTargetStats(targetId);
+            }
+            CHECK(stats.SentPackets == NUM_PACKETS);
+            CHECK(stats.DroppedPackets == 0);
+            CHECK(stats.SendErrors == 0);
+            CHECK(stats.QueuedPackets == 0);
+        }
+
+        fanoutQueue.RemoveTarget(targetIds.front());
+        CHECK(fanoutQueue.GetTargetCount() == (NUM_TARGETS - 1));
+        fanoutQueue.Stop();
+        CHECK_FALSE(fanoutQueue.Enqueue(makePacket(0),
+            BoundedPacketQueue::PacketKind::Independent));
+    }
+
+    for (const auto& socketPair : sockets)
+    {
+        close(socketPair[0]);
+        close(socketPair[1]);
+    }
+}
+
+TEST_CASE( "DatagramFanoutQueue doesn't let a stalled target hold up the others", "[utilities]" )
+{
+    int fastSockets[2];
+    int stalledSockets[2];
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, fastSockets) == 0);
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, stalledSockets) == 0);
+
+    {
+        constexpr int NUM_PACKETS = 2000;
+        DatagramFanoutQueue fanoutQueue(64);
+        auto fastTarget = fanoutQueue.AddTarget(fastSockets[0]);
+        auto stalledTarget = fanoutQueue.AddTarget(stalledSockets[0]);
+
+        // Nobody ever reads from the stalled target, so its socket buffer fills up and the
+        // ring soon laps it
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            REQUIRE(fanoutQueue.Enqueue(makePacket(i),
+                BoundedPacketQueue::PacketKind::Independent));
+            std::optional<std::byte> received = readPacket(fastSockets[1]);
+            REQUIRE(received.has_value());
+            CHECK(received.value() == std::byte(i));
+        }
+
+        CHECK(fanoutQueue.GetTargetStats(fastTarget).DroppedPackets == 0);
+        DatagramSendQueue::Stats stalledStats = fanoutQueue.GetTargetStats(stalledTarget);
+        CHECK(stalledStats.SentPackets < NUM_PACKETS);
+        CHECK(stalledStats.Overflows > 0);
+        CHECK(stalledStats.DroppedPackets > 0);
+        CHECK(stalledStats.QueuedPackets > 0);
+        CHECK(stalledStats.QueuedPackets <= 64);
+    }
+
+    close(fastSockets[0]);
+    close(fastSockets[1]);
+    close(stalledSockets[0]);
+    close(stalledSockets[1]);
+}
+
+TEST_CASE( "DatagramFanoutQueue can start new targets at the latest keyframe", "[utilities]" )
+{
+    using PacketKind = BoundedPacketQueue::PacketKind;
+    int sockets[2];
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, sockets) == 0);
+
+    {
+        DatagramFanoutQueue fanoutQueue(DatagramFanoutQueue::DEFAULT_CAPACITY, true);
+        fanoutQueue.Enqueue(makePacket(0), PacketKind::Keyframe);
+        fanoutQueue.Enqueue(makePacket(1), PacketKind::Dependent);
+        fanoutQueue.Enqueue(makePacket(2), PacketKind::Keyframe);
+        fanoutQueue.Enqueue(makePacket(3), PacketKind::Independent);
+        fanoutQueue.Enqueue(makePacket(4), PacketKind::Keyframe);
+        fanoutQueue.Enqueue(makePacket(5), PacketKind::Dependent);
+        fanoutQueue.AddTarget(sockets[0]);
+        fanoutQueue.Enqueue(makePacket(6), PacketKind::Dependent);
+
+        for (int i = 2; i <= 6; ++i)
+        {
+            std::optional<std::byte> received = readPacket(sockets[1]);
+            REQUIRE(received.has_value());
+            CHECK(received.value() == std::byte(i));
+        }
+        CHECK_FALSE(readPacket(sockets[1], 50).has_value());
+    }
+
+    close(sockets[0]);
+    close(sockets[1]);
+}
+
+TEST_CASE( "DatagramFanoutQueue spreads bursts out to every target when paced", "[utilities]" )
+{
+    constexpr size_t NUM_TARGETS = 2;
+    constexpr int NUM_PACKETS = 100;
+    constexpr size_t PACKET_BYTES = 1200;
+    std::array<std::array<int, 2>, NUM_TARGETS> sockets;
+    for (auto& socketPair : sockets)
+    {
+        REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, socketPair.data()) == 0);
+    }
+
+    {
+        DatagramFanoutQueue fanoutQueue(DatagramFanoutQueue::DEFAULT_CAPACITY, false,
+            std::chrono::milliseconds(100));
+        for (const auto& socketPair : sockets)
+        {
+            fanoutQueue.AddTarget(socketPair[0]);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            std::vector<std::byte> bytes(PACKET_BYTES, std::byte(i));
+            REQUIRE(fanoutQueue.Enqueue(PacketBuffer::Copy(bytes),
+                BoundedPacketQueue::PacketKind::Independent));
+        }
+
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            for (const auto& socketPair : sockets)
+            {
+                pollfd readPollFd { .fd = socketPair[1], .events = POLLIN, .revents = 0 };
+                REQUIRE(poll(&readPollFd, 1, 5000) == 1);
+                std::array<std::byte, PACKET_BYTES> received;
+                REQUIRE(read(socketPair[1], received.data(), received.size()) == PACKET_BYTES);
+                CHECK(received[0] == std::byte(i));
+            }
+        }
+
+        // All but the first few packets are let out at a burst's worth per interval
+        CHECK((std::chrono::steady_clock::now() - start) >= std::chrono::milliseconds(70));
+    }
+
+    for (const auto& socketPair : sockets)
+    {
+        close(socketPair[0]);
+        close(socketPair[1]);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file DatagramSendQueueTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <array>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../../../src/Utilities/DatagramSendQueue.h"
+
+TEST_CASE( "DatagramSendQueue sends queued datagrams in order", "[utilities]" )
+{
+    int sockets[2];
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, sockets) == 0);
+
+    constexpr int NUM_PACKETS = 200;
+    {
+        DatagramSendQueue sendQueue(sockets[0]);
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            std::byte value = std::byte(i);
+            REQUIRE(sendQueue.Enqueue(PacketBuffer::Copy(std::span<const std::byte>(&value, 1)),
+                BoundedPacketQueue::PacketKind::Independent));
+        }
+
+        // The local socket buffer is small, so read as we go to let the queue keep draining
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            pollfd readPollFd { .fd = sockets[1], .events = POLLIN, .revents = 0 };
+            REQUIRE(poll(&readPollFd, 1, 5000) == 1);
+            std::byte received;
+            REQUIRE(read(sockets[1], &received, 1) == 1);
+            CHECK(received == std::byte(i));
+        }
+
+        // The sender might not have counted its last batch yet
+        DatagramSendQueue::Stats stats = sendQueue.GetStats();
+        for (int i = 0; (i < 100) && (stats.SentPackets < NUM_PACKETS); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            stats = sendQueue.GetStats();
+        }
+        CHECK(stats.SentPackets == NUM_PACKETS);
+        CHECK(stats.DroppedPackets == 0);
+        CHECK(stats.SendErrors == 0);
+        CHECK(stats.QueuedPackets == 0);
+
+        sendQueue.Stop();
+        std::byte value = std::byte(0);
+        CHECK_FALSE(sendQueue.Enqueue(PacketBuffer::Copy(std::span<const std::byte>(&value, 1)),
+            BoundedPacketQueue::PacketKind::Independent));
+    }
+
+    close(sockets[0]);
+    close(sockets[1]);
+}
+
+TEST_CASE( "DatagramSendQueue spreads bursts out when paced", "[utilities]" )
+{
+    int sockets[2];
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, sockets) == 0);
+
+    constexpr int NUM_PACKETS = 100;
+    constexpr size_t PACKET_BYTES = 1200;
+    {
+        DatagramSendQueue sendQueue(sockets[0], DatagramSendQueue::DEFAULT_CAPACITY,
+            std::chrono::milliseconds(100));
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            std::vector<std::byte> bytes(PACKET_BYTES, std::byte(i));
+            REQUIRE(sendQueue.Enqueue(PacketBuffer::Copy(bytes),
+                BoundedPacketQueue::PacketKind::Independent));
+        }
+
+        for (int i = 0; i < NUM_PACKETS; ++i)
+        {
+            pollfd readPollFd { .fd = sockets[1], .events = POLLIN, .revents = 0 };
+            REQUIRE(poll(&readPollFd, 1, 5000) == 1);
+            std::array<std::byte, PACKET_BYTES> received;
+            REQUIRE(read(sockets[1], received.data(), received.size()) == PACKET_BYTES);
+            CHECK(received[0] == std::byte(i));
+        }
+
+        // All but the first few packets are sent at a burst's worth per interval
+        CHECK((std::chrono::steady_clock::now() - start) >= std::chrono::milliseconds(70));
+    }
+
+    close(sockets[0]);
+    close(sockets[1]);
+}
@@ -0,0 +1,50 @@
+/**
+ * @file DeadlineQueueTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "../../../src/Utilities/DeadlineQueue.h"
+
+TEST_CASE( "DeadlineQueue hands back values as their deadlines pass", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    DeadlineQueue<int> deadlines;
+    CHECK_FALSE(deadlines.GetNextDeadline().has_value());
+
+    deadlines.Push(start + 30ms, 3);
+    deadlines.Push(start + 10ms, 1);
+    deadlines.Push(start + 20ms, 2);
+    deadlines.Push(start + 10ms, 4);
+    REQUIRE(deadlines.GetNextDeadline().has_value());
+    CHECK(deadlines.GetNextDeadline().value() == (start + 10ms));
+    CHECK(deadlines.GetSize() == 4);
+
+    CHECK(deadlines.PopExpired(start).empty());
+
+    // Values sharing a deadline come back in the order they were pushed
+    CHECK(deadlines.PopExpired(start + 10ms) == std::vector<int> { 1, 4 });
+    CHECK(deadlines.GetNextDeadline().value() == (start + 20ms));
+
+    CHECK(deadlines.PopExpired(start + 1s) == std::vector<int> { 2, 3 });
+    CHECK_FALSE(deadlines.GetNextDeadline().has_value());
+    CHECK(deadlines.GetSize() == 0);
+}
+
+TEST_CASE( "DeadlineQueue holds move-only values", "[utilities]" )
+{
+    const auto now = std::chrono::steady_clock::now();
+    DeadlineQueue<std::unique_ptr<int>> deadlines;
+    deadlines.Push(now, std::make_unique<int>(7));
+
+    std::vector<std::unique_ptr<int>> expired = deadlines.PopExpired(now);
+    REQUIRE(expired.size() == 1);
+    CHECK(*expired.front() == 7);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file EgressPacerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+
+#include "../../../src/Utilities/EgressPacer.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE( "EgressPacer spreads a burst out over its interval", "[utilities]" )
+{
+    const auto start = std::chrono::steady_clock::now();
+    EgressPacer pacer(50ms, 1000ms, start);
+
+    constexpr size_t NUM_PACKETS = 100;
+    constexpr size_t PACKET_BYTES = 1200;
+    for (size_t i = 0; i < NUM_PACKETS; ++i)
+    {
+        pacer.AddQueued(PACKET_BYTES, start);
+    }
+
+    // A few packets go straight out, the rest wait their turn
+    auto now = start;
+    size_t sentBackToBack = 0;
+    while (pacer.GetDelay(now) == EgressPacer::Clock::duration::zero())
+    {
+        pacer.AddSent(PACKET_BYTES, now);
+        ++sentBackToBack;
+    }
+    CHECK(sentBackToBack == (EgressPacer::BURST_BYTES / PACKET_BYTES));
+
+    size_t sent = sentBackToBack;
+    while (sent < NUM_PACKETS)
+    {
+        const EgressPacer::Clock::duration delay = pacer.GetDelay(now);
+        REQUIRE(delay < 50ms);
+        if (delay == EgressPacer::Clock::duration::zero())
+        {
+            pacer.AddSent(PACKET_BYTES, now);
+            ++sent;
+        }
+        now += delay;
+    }
+    CHECK(now > (start + 40ms));
+    CHECK(now <= (start + 50ms));
+}
+
+TEST_CASE( "EgressPacer doesn't hold up a steady stream", "[utilities]" )
+{
+    const auto start = std::chrono::steady_clock::now();
+    EgressPacer pacer(20ms, 1000ms, start);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto now = start + (i * 10ms);
+        pacer.AddQueued(1000, now);
+        REQUIRE(pacer.GetDelay(now) == EgressPacer::Clock::duration::zero());
+        pacer.AddSent(1000, now);
+    }
+
+    // Sent at no less than twice the stream's bitrate
+    CHECK(pacer.GetBytesPerSecond(start + 1990ms) >= Approx(200000).epsilon(0.01));
+}
+
+TEST_CASE( "EgressPacer never paces slower than a burst per interval", "[utilities]" )
+{
+    const auto start = std::chrono::steady_clock::now();
+    EgressPacer pacer(10ms, 1000ms, start);
+    CHECK(pacer.GetBytesPerSecond(start + 1h) == Approx(EgressPacer::BURST_BYTES * 100.0));
+
+    // Time going backwards doesn't refill the budget
+    pacer.AddSent(2 * EgressPacer::BURST_BYTES, start + 1h);
+    CHECK(pacer.GetDelay(start) > EgressPacer::Clock::duration::zero());
+    CHECK(pacer.GetDelay(start + 1h + 20ms) == EgressPacer::Clock::duration::zero());
+}
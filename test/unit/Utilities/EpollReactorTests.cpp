@@ -0,0 +1,139 @@
+/**
+ * @file EpollReactorTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "../../../src/Utilities/CpuTopology.h"
+#include "../../../src/Utilities/EpollReactor.h"
+#include "../../../src/Utilities/Util.h"
+
+TEST_CASE( "EpollReactor dispatches readable handles and unregisters them", "[utilities]" )
+{
+    int sockets[2];
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, sockets) == 0);
+
+    EpollReactor reactor(2);
+    REQUIRE(reactor.GetWorkerCount() == 2);
+
+    std::promise<std::string> readPromise;
+    std::promise<void> unregisteredPromise;
+    auto registerResult = reactor.Register(
+        sockets[0],
+        [&]()
+        {
+            char buffer[64];
+            ssize_t bytesRead = read(sockets[0], buffer, sizeof(buffer));
+            readPromise.set_value(std::string(buffer, bytesRead));
+            // Stop watching after the first read
+            return false;
+        },
+        [&]()
+        {
+            unregisteredPromise.set_value();
+        });
+    if (registerResult.IsError)
+    {
+        FAIL("ErrorMessage: " << registerResult.ErrorMessage);
+    }
+
+    std::string message = "Hello reactor";
+    REQUIRE(write(sockets[1], message.data(), message.size()) == (ssize_t)message.size());
+
+    auto readFuture = readPromise.get_future();
+    REQUIRE(readFuture.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+    CHECK(readFuture.get() == message);
+
+    reactor.WaitUntilUnregistered(registerResult.Value);
+    auto unregisteredFuture = unregisteredPromise.get_future();
+    CHECK(unregisteredFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+    // Unregistering again should have no effect
+    reactor.Unregister(registerResult.Value);
+
+    close(sockets[0]);
+    close(sockets[1]);
+}
+
+TEST_CASE( "EpollReactor places registrations near the CPUs workers are pinned to", "[utilities]" )
+{
+    int sockets[2];
+    REQUIRE(socketpair(AF_LOCAL, SOCK_DGRAM, 0, sockets) == 0);
+
+    // Nothing has a CPU 1000, so that worker can't really be pinned, but it's always on a
+    // different (unknown) NUMA node to CPU 0's worker, which lets us tell them apart
+    const int firstNode = CpuTopology::GetNumaNode(0);
+    EpollReactor reactor(0, { 0, 1000 });
+    REQUIRE(reactor.GetWorkerCount() == 2);
+    REQUIRE(reactor.GetWorkerNumaNodes() ==
+        std::vector<int> { firstNode, CpuTopology::UNKNOWN_NUMA_NODE });
+
+    std::mutex readMutex;
+    std::condition_variable readCondition;
+    std::vector<std::thread::id> readThreads;
+    auto registerResult = reactor.Register(
+        sockets[0],
+        [&]()
+        {
+            char buffer[64];
+            if (read(sockets[0], buffer, sizeof(buffer)) > 0)
+            {
+                std::scoped_lock lock(readMutex);
+                readThreads.push_back(std::this_thread::get_id());
+            }
+            readCondition.notify_all();
+            return true;
+        },
+        nullptr,
+        firstNode);
+    REQUIRE_FALSE(registerResult.IsError);
+    const EpollReactor::RegistrationId id = registerResult.Value;
+    REQUIRE(reactor.GetNumaNode(id) == firstNode);
+
+    const auto readOnce = [&]()
+        {
+            std::unique_lock lock(readMutex);
+            const size_t expectedReads = (readThreads.size() + 1);
+            REQUIRE(write(sockets[1], "x", 1) == 1);
+            REQUIRE(readCondition.wait_for(lock, std::chrono::seconds(1),
+                [&]() { return (readThreads.size() == expectedReads); }));
+            return readThreads.back();
+        };
+    const std::thread::id firstThread = readOnce();
+
+    // Moves happen on the registration's worker, so wait for it to change hands
+    auto moveResult = reactor.MoveNearCpu(id, 1000);
+    REQUIRE_FALSE(moveResult.IsError);
+    REQUIRE(moveResult.Value == CpuTopology::UNKNOWN_NUMA_NODE);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while ((reactor.GetNumaNode(id) != CpuTopology::UNKNOWN_NUMA_NODE) &&
+        (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(reactor.GetNumaNode(id) == CpuTopology::UNKNOWN_NUMA_NODE);
+    CHECK(readOnce() != firstThread);
+
+    // Already there, so nothing moves
+    moveResult = reactor.MoveNearCpu(id, 1000);
+    REQUIRE_FALSE(moveResult.IsError);
+    REQUIRE(moveResult.Value == CpuTopology::UNKNOWN_NUMA_NODE);
+    REQUIRE(reactor.MoveNearCpu(id, 2000).IsError);
+
+    reactor.Unregister(id);
+    reactor.WaitUntilUnregistered(id);
+    REQUIRE_FALSE(reactor.GetNumaNode(id).has_value());
+
+    close(sockets[0]);
+    close(sockets[1]);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file FanoutWorkerPoolTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../../src/Utilities/FanoutWorkerPool.h"
+
+TEST_CASE( "FanoutWorkerPool delivers packets to each registration in order", "[utilities]" )
+{
+    FanoutWorkerPool pool(2);
+    REQUIRE(pool.GetWorkerCount() == 2);
+
+    constexpr size_t NUM_TARGETS = 4;
+    constexpr size_t NUM_PACKETS = 500;
+    std::mutex receivedMutex;
+    std::vector<std::vector<uint8_t>> received(NUM_TARGETS);
+    std::vector<std::promise<void>> donePromises(NUM_TARGETS);
+    std::vector<FanoutWorkerPool::RegistrationId> ids;
+    for (size_t target = 0; target < NUM_TARGETS; ++target)
+    {
+        ids.push_back(pool.Register(
+            [&, target](const PacketBuffer& packet)
+            {
+                std::scoped_lock lock(receivedMutex);
+                received[target].push_back(static_cast<uint8_t>(packet.Bytes()[0]));
+                if (received[target].size() == NUM_PACKETS)
+                {
+                    donePromises[target].set_value();
+                }
+            }));
+    }
+
+    for (size_t i = 0; i < NUM_PACKETS; ++i)
+    {
+        // Every registration shares the same buffer
+        std::byte value = std::byte(i % 256);
+        PacketBuffer packet = PacketBuffer::Copy(std::span<const std::byte>(&value, 1));
+        for (const auto& id : ids)
+        {
+            REQUIRE(pool.Enqueue(id, packet));
+        }
+    }
+
+    for (size_t target = 0; target < NUM_TARGETS; ++target)
+    {
+        auto doneFuture = donePromises[target].get_future();
+        REQUIRE(doneFuture.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        std::scoped_lock lock(receivedMutex);
+        for (size_t i = 0; i < NUM_PACKETS; ++i)
+        {
+            CHECK(received[target][i] == static_cast<uint8_t>(i % 256));
+        }
+    }
+    CHECK(pool.GetDroppedPacketCount() == 0);
+    CHECK(pool.GetMaxQueueDepth() == 0);
+
+    // Registrations are spread across both workers, and each has run on some CPU since
+    CHECK(pool.GetWorkerIndex(ids[0]) != pool.GetWorkerIndex(ids[1]));
+    const std::vector<ThreadPlacement::Snapshot> placements = pool.GetWorkerPlacements();
+    REQUIRE(placements.size() == 2);
+    CHECK(placements[0].ThreadId != placements[1].ThreadId);
+    for (const auto& placement : placements)
+    {
+        CHECK(placement.ThreadId != 0);
+        CHECK(placement.Cpu >= 0);
+    }
+}
+
+TEST_CASE( "FanoutWorkerPool never delivers after a registration is removed", "[utilities]" )
+{
+    FanoutWorkerPool pool(1);
+
+    std::atomic<bool> isUnregistered = false;
+    std::atomic<size_t> lateDeliveries = 0;
+    std::promise<void> firstDeliveryPromise;
+    std::atomic<bool> firstDelivery = true;
+    FanoutWorkerPool::RegistrationId id = pool.Register(
+        [&](const PacketBuffer&)
+        {
+            if (firstDelivery.exchange(false))
+            {
+                firstDeliveryPromise.set_value();
+            }
+            // Give Unregister a chance to race with us
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (isUnregistered)
+            {
+                ++lateDeliveries;
+            }
+        });
+
+    PacketBuffer packet = PacketBuffer::Copy(std::vector<std::byte>(4));
+    for (size_t i = 0; i < 100; ++i)
+    {
+        REQUIRE(pool.Enqueue(id, packet));
+    }
+    REQUIRE(firstDeliveryPromise.get_future().wait_for(std::chrono::seconds(5)) ==
+        std::future_status::ready);
+
+    pool.Unregister(id);
+    isUnregistered = true;
+    CHECK_FALSE(pool.Enqueue(id, packet));
+
+    // Let the worker drain whatever was still queued for the removed registration
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(lateDeliveries == 0);
+
+    // Unregistering again should have no effect
+    pool.Unregister(id);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file H264NalScannerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+
+#include "../../../src/Utilities/H264NalScanner.h"
+
+namespace
+{
+    std::vector<std::byte> bytesOf(std::initializer_list<uint8_t> values)
+    {
+        std::vector<std::byte> bytes;
+        for (uint8_t value : values)
+        {
+            bytes.push_back(std::byte(value));
+        }
+        return bytes;
+    }
+}
+
+TEST_CASE( "H264NalScanner finds start codes and emulation prevention bytes", "[utilities]" )
+{
+    const std::vector<std::byte> bitstream =
+        bytesOf({ 0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x01,
+            0x68 });
+    CHECK( H264NalScanner::FindStartCode(bitstream) == 1 );
+    CHECK( H264NalScanner::FindStartCode(bitstream, 2) == 10 );
+    CHECK( H264NalScanner::FindStartCode(bitstream, 11) == bitstream.size() );
+    CHECK( H264NalScanner::FindEmulationPreventionByte(bitstream) == 8 );
+    CHECK( H264NalScanner::FindEmulationPreventionByte(bitstream, 9) == bitstream.size() );
+
+    // Patterns cut short by the end of the bytes aren't found
+    CHECK( H264NalScanner::FindStartCode(bytesOf({ 0x42, 0x00, 0x00 })) == 3 );
+    CHECK( H264NalScanner::FindStartCode(bytesOf({ })) == 0 );
+}
+
+TEST_CASE( "H264NalScanner strips emulation prevention bytes", "[utilities]" )
+{
+    std::vector<uint8_t> rbsp { 0xAA };
+    H264NalScanner::AppendUnescaped(
+        bytesOf({ 0x01, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0x03, 0x02 }),
+        rbsp);
+    CHECK_THAT( rbsp, Catch::Equals(std::vector<uint8_t>
+        { 0xAA, 0x01, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02 }) );
+}
+
+TEST_CASE( "H264NalScanner matches a byte by byte scan", "[utilities]" )
+{
+    // Mostly zeroes and a few small values, so every block is thick with near misses
+    std::mt19937 random(1234);
+    std::discrete_distribution<int> byteDistribution({ 60, 10, 5, 10, 15 });
+    for (size_t size = 0; size < 200; ++size)
+    {
+        std::vector<std::byte> bytes(size);
+        for (std::byte& byte : bytes)
+        {
+            const int value = byteDistribution(random);
+            byte = std::byte((value == 4) ? 0x42 : value);
+        }
+        for (size_t offset = 0; offset <= size; offset += 7)
+        {
+            REQUIRE( H264NalScanner::FindStartCode(bytes, offset) ==
+                H264NalScanner::FindZeroZeroScalar(bytes, offset, 0x01) );
+            const size_t scalarEscape = H264NalScanner::FindZeroZeroScalar(bytes, offset, 0x03);
+            REQUIRE( H264NalScanner::FindEmulationPreventionByte(bytes, offset) ==
+                ((scalarEscape < size) ? (scalarEscape + 2) : size) );
+        }
+    }
+}
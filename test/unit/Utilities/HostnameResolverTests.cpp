@@ -0,0 +1,69 @@
+/**
+ * @file HostnameResolverTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "../../../src/Utilities/HostnameResolver.h"
+
+TEST_CASE( "HostnameResolver caches successful lookups", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    int numLookups = 0;
+    HostnameResolver resolver(50ms,
+        [&numLookups](const std::string& hostname)
+        {
+            ++numLookups;
+            if (hostname == "missing.example")
+            {
+                return Result<IpAddress>::Error("Not found");
+            }
+            in_addr addr { .s_addr = htonl(0x7F000001) };
+            return Result<IpAddress>::Success(IpAddress(addr));
+        });
+
+    Result<IpAddress> result = resolver.Resolve("edge.example");
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value == IpAddress(in_addr { .s_addr = htonl(0x7F000001) }));
+    CHECK_FALSE(resolver.Resolve("edge.example").IsError);
+    CHECK(numLookups == 1);
+
+    SECTION( "failed lookups aren't cached" )
+    {
+        CHECK(resolver.Resolve("missing.example").IsError);
+        CHECK(resolver.Resolve("missing.example").IsError);
+        CHECK(numLookups == 3);
+    }
+
+    SECTION( "invalidated hostnames are looked up again" )
+    {
+        resolver.Invalidate("edge.example");
+        CHECK_FALSE(resolver.Resolve("edge.example").IsError);
+        CHECK(numLookups == 2);
+    }
+
+    SECTION( "expired lookups are looked up again" )
+    {
+        std::this_thread::sleep_for(60ms);
+        CHECK_FALSE(resolver.Resolve("edge.example").IsError);
+        CHECK(numLookups == 2);
+    }
+}
+
+TEST_CASE( "HostnameResolver looks up addresses with getaddrinfo", "[utilities]" )
+{
+    Result<IpAddress> result = HostnameResolver::LookupWithGetAddrInfo("127.0.0.1");
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value == IpAddress(in_addr { .s_addr = htonl(INADDR_LOOPBACK) }));
+
+    result = HostnameResolver::LookupWithGetAddrInfo("::1");
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value == IpAddress(in6addr_loopback));
+}
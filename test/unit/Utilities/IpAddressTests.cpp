@@ -0,0 +1,83 @@
+/**
+ * @file IpAddressTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <netinet/in.h>
+#include <unordered_set>
+
+#include "../../../src/Utilities/IpAddress.h"
+
+namespace
+{
+    in6_addr parseIpv6(const char* address)
+    {
+        in6_addr parsed {};
+        REQUIRE(inet_pton(AF_INET6, address, &parsed) == 1);
+        return parsed;
+    }
+}
+
+TEST_CASE( "IpAddress holds IPv4 and IPv6 addresses", "[utilities]" )
+{
+    const IpAddress ipv4(in_addr { .s_addr = htonl(0x0A000001) });
+    CHECK(ipv4.GetFamily() == AF_INET);
+    CHECK(ipv4.ToString() == "10.0.0.1");
+    std::optional<sockaddr_in> ipv4Socket = ipv4.ToIpv4(8084);
+    REQUIRE(ipv4Socket.has_value());
+    CHECK(ipv4Socket->sin_addr.s_addr == htonl(0x0A000001));
+    CHECK(ipv4Socket->sin_port == htons(8084));
+
+    const IpAddress ipv6(parseIpv6("2001:db8::1"));
+    CHECK(ipv6.GetFamily() == AF_INET6);
+    CHECK(ipv6.ToString() == "2001:db8::1");
+    CHECK_FALSE(ipv6.ToIpv4(8084).has_value());
+    const sockaddr_in6 ipv6Socket = ipv6.ToIpv6(8084);
+    CHECK(IpAddress(ipv6Socket.sin6_addr) == ipv6);
+    CHECK(ipv6Socket.sin6_port == htons(8084));
+
+    // IPv4 peers reach dual-stack sockets at their mapped address
+    const sockaddr_in6 mappedSocket = ipv4.ToIpv6(8084);
+    CHECK(IN6_IS_ADDR_V4MAPPED(&mappedSocket.sin6_addr));
+    CHECK(IpAddress(mappedSocket.sin6_addr) == ipv4);
+}
+
+TEST_CASE( "IpAddress compares peers however they reached us", "[utilities]" )
+{
+    const IpAddress ipv4(in_addr { .s_addr = htonl(0x0A000001) });
+    const IpAddress mapped(parseIpv6("::ffff:10.0.0.1"));
+    CHECK(mapped.GetFamily() == AF_INET);
+    CHECK(mapped == ipv4);
+    CHECK(IpAddress::Hash()(mapped) == IpAddress::Hash()(ipv4));
+
+    // An IPv6 address sharing the IPv4 address's bytes is someone else
+    in6_addr lookalikeBytes {};
+    std::memcpy(&lookalikeBytes, &ipv4.ToIpv4(0)->sin_addr, sizeof(in_addr));
+    const IpAddress lookalike(lookalikeBytes);
+    CHECK_FALSE(lookalike == ipv4);
+
+    std::unordered_set<IpAddress, IpAddress::Hash> addresses { ipv4, mapped, lookalike,
+        IpAddress(parseIpv6("2001:db8::1")), IpAddress(parseIpv6("2001:db8::2")) };
+    CHECK(addresses.size() == 4);
+}
+
+TEST_CASE( "IpAddress reads socket addresses", "[utilities]" )
+{
+    sockaddr_storage storage {};
+    auto& ipv6Socket = reinterpret_cast<sockaddr_in6&>(storage);
+    ipv6Socket.sin6_family = AF_INET6;
+    ipv6Socket.sin6_port = htons(9000);
+    ipv6Socket.sin6_addr = parseIpv6("::ffff:192.168.1.2");
+    std::optional<IpAddress> address = IpAddress::FromSockaddr(storage);
+    REQUIRE(address.has_value());
+    CHECK(address->ToString() == "192.168.1.2");
+    CHECK(IpAddress::GetPort(storage) == htons(9000));
+
+    storage.ss_family = AF_UNIX;
+    CHECK_FALSE(IpAddress::FromSockaddr(storage).has_value());
+}
@@ -0,0 +1,83 @@
+/**
+ * @file LingerListTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../../../src/Utilities/LingerList.h"
+
+TEST_CASE( "LingerList expires entries once they've lingered long enough", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    LingerList<uint32_t> list(10s, 0);
+
+    CHECK(list.Add(1, 100, start).empty());
+    CHECK(list.Add(2, 200, start + 5s).empty());
+    CHECK(list.Contains(1));
+    CHECK(list.GetSize() == 2);
+    CHECK(list.GetTotalCost() == 300);
+
+    CHECK(list.RemoveExpired(start + 9s).empty());
+    CHECK(list.RemoveExpired(start + 10s) == std::vector<uint32_t> { 1 });
+    CHECK_FALSE(list.Contains(1));
+    CHECK(list.GetTotalCost() == 200);
+
+    // Lingering again starts the timer over
+    CHECK(list.Add(2, 200, start + 12s).empty());
+    CHECK(list.RemoveExpired(start + 15s).empty());
+    CHECK(list.RemoveExpired(start + 22s) == std::vector<uint32_t> { 2 });
+    CHECK(list.GetSize() == 0);
+    CHECK(list.GetTotalCost() == 0);
+}
+
+TEST_CASE( "LingerList entries stop lingering when removed", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    LingerList<uint32_t> list(10s, 0);
+
+    list.Add(1, 100, start);
+    CHECK(list.Remove(1));
+    CHECK_FALSE(list.Remove(1));
+    CHECK_FALSE(list.Remove(2));
+    CHECK(list.GetTotalCost() == 0);
+    CHECK(list.RemoveExpired(start + 1h).empty());
+}
+
+TEST_CASE( "LingerList evicts the longest lingering entries when over budget", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    LingerList<uint32_t> list(10s, 1000);
+
+    CHECK(list.Add(1, 400, start).empty());
+    CHECK(list.Add(2, 400, start + 1s).empty());
+    // Re-adding 1 makes 2 the one that has lingered longest
+    CHECK(list.Add(1, 400, start + 2s).empty());
+    CHECK(list.Add(3, 400, start + 3s) == std::vector<uint32_t> { 2 });
+    CHECK(list.GetTotalCost() == 800);
+
+    // Evicts as many as it takes
+    CHECK(list.Add(4, 900, start + 4s) == std::vector<uint32_t> { 1, 3 });
+    CHECK(list.GetSize() == 1);
+
+    // Something costing more than the whole budget doesn't linger at all
+    CHECK(list.Add(5, 1001, start + 5s) == std::vector<uint32_t> { 4, 5 });
+    CHECK(list.GetSize() == 0);
+    CHECK(list.GetTotalCost() == 0);
+
+    // Free entries never push anything out
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        CHECK(list.Add(100 + i, 0, start + 6s).empty());
+    }
+    CHECK(list.Add(6, 1000, start + 6s).empty());
+    CHECK(list.GetSize() == 101);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file MetricsTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../src/Utilities/Metrics.h"
+
+TEST_CASE( "MetricsRegistry renders counters and gauges in the Prometheus text format",
+    "[utilities]" )
+{
+    MetricsRegistry registry;
+    auto firstCounter = registry.AddCounter("ftl_test_packets_total", "Packets seen",
+        { { "channel", "1" } });
+    auto secondCounter = registry.AddCounter("ftl_test_packets_total", "Packets seen",
+        { { "channel", "2" } });
+    auto gauge = registry.AddGauge("ftl_test_depth", "Queue depth");
+    firstCounter->Increment();
+    firstCounter->Increment(2);
+    secondCounter->Increment();
+    gauge->Set(1.5);
+
+    CHECK(registry.Render() ==
+        "# HELP ftl_test_depth Queue depth\n"
+        "# TYPE ftl_test_depth gauge\n"
+        "ftl_test_depth 1.5\n"
+        "# HELP ftl_test_packets_total Packets seen\n"
+        "# TYPE ftl_test_packets_total counter\n"
+        "ftl_test_packets_total{channel=\"1\"} 3\n"
+        "ftl_test_packets_total{channel=\"2\"} 1\n");
+
+    // Adding the same series again hands back the one that's already there
+    CHECK(registry.AddCounter("ftl_test_packets_total", "Packets seen",
+        { { "channel", "1" } }) == firstCounter);
+    CHECK_THROWS(registry.AddGauge("ftl_test_packets_total", "Packets seen"));
+
+    // Series stop being reported once nobody holds on to them
+    secondCounter.reset();
+    gauge.reset();
+    CHECK(registry.Render() ==
+        "# HELP ftl_test_packets_total Packets seen\n"
+        "# TYPE ftl_test_packets_total counter\n"
+        "ftl_test_packets_total{channel=\"1\"} 3\n");
+}
+
+TEST_CASE( "MetricsRegistry renders histograms with cumulative buckets", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    MetricsRegistry registry;
+    auto histogram = registry.AddHistogram("ftl_test_seconds", "Time taken",
+        { { "method", "Test\"Quoted\"" } }, { 0.001, 0.01 });
+    histogram->ObserveDuration(500us);
+    histogram->ObserveDuration(1ms);
+    histogram->ObserveDuration(5ms);
+    histogram->ObserveDuration(2s);
+
+    MetricHistogram::Snapshot snapshot = histogram->GetSnapshot();
+    CHECK(snapshot.BucketCounts == std::vector<uint64_t> { 2, 1, 1 });
+    CHECK(snapshot.Count == 4);
+    CHECK(snapshot.Sum == Approx(2.0065));
+
+    CHECK(registry.Render() ==
+        "# HELP ftl_test_seconds Time taken\n"
+        "# TYPE ftl_test_seconds histogram\n"
+        "ftl_test_seconds_bucket{method=\"Test\\\"Quoted\\\"\",le=\"0.001\"} 2\n"
+        "ftl_test_seconds_bucket{method=\"Test\\\"Quoted\\\"\",le=\"0.01\"} 3\n"
+        "ftl_test_seconds_bucket{method=\"Test\\\"Quoted\\\"\",le=\"+Inf\"} 4\n"
+        "ftl_test_seconds_sum{method=\"Test\\\"Quoted\\\"\"} 2.0065\n"
+        "ftl_test_seconds_count{method=\"Test\\\"Quoted\\\"\"} 4\n");
+}
+
+TEST_CASE( "MetricHistogram counts every observation made from many threads", "[utilities]" )
+{
+    constexpr size_t numThreads = MetricHistogram::NUM_SHARDS + 4;
+    constexpr size_t observationsPerThread = 1000;
+    MetricHistogram histogram({ 1, 2 });
+    {
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back(
+                [&histogram, i]()
+                {
+                    for (size_t j = 0; j < observationsPerThread; ++j)
+                    {
+                        histogram.Observe(static_cast<double>(i % 3));
+                    }
+                });
+        }
+    }
+
+    MetricHistogram::Snapshot snapshot = histogram.GetSnapshot();
+    CHECK(snapshot.Count == (numThreads * observationsPerThread));
+    // Seven threads each observe 0 and 1, which share the first bucket, and six observe 2
+    CHECK(snapshot.BucketCounts == std::vector<uint64_t> { 14000, 6000, 0 });
+    CHECK(snapshot.Sum == Approx(((7 * 1) + (6 * 2)) * observationsPerThread));
+}
+
+TEST_CASE( "MetricsRegistry reports values from collectors until they're removed", "[utilities]" )
+{
+    MetricsRegistry registry;
+    uint64_t packetsReceived = 10;
+    auto collectorId = registry.AddCollector(
+        [&packetsReceived](MetricsRegistry::Writer& writer)
+        {
+            writer.Counter("ftl_test_received_total", "Packets received", { { "channel", "1" } },
+                packetsReceived);
+            writer.Gauge("ftl_test_bitrate", "Bitrate", { { "channel", "1" } }, 2000);
+        });
+
+    CHECK(registry.Render() ==
+        "# HELP ftl_test_bitrate Bitrate\n"
+        "# TYPE ftl_test_bitrate gauge\n"
+        "ftl_test_bitrate{channel=\"1\"} 2000\n"
+        "# HELP ftl_test_received_total Packets received\n"
+        "# TYPE ftl_test_received_total counter\n"
+        "ftl_test_received_total{channel=\"1\"} 10\n");
+
+    packetsReceived = 20;
+    CHECK(registry.Render().find("ftl_test_received_total{channel=\"1\"} 20\n") !=
+        std::string::npos);
+
+    registry.RemoveCollector(collectorId);
+    CHECK(registry.Render().empty());
+}
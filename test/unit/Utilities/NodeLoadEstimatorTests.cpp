@@ -0,0 +1,63 @@
+/**
+ * @file NodeLoadEstimatorTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <thread>
+
+#include "../../../src/Utilities/NodeLoadEstimator.h"
+
+TEST_CASE( "NodeLoadEstimator reports the most saturated resource", "[utilities]" )
+{
+    NodeLoadEstimator estimator(NodeCapacity
+        {
+            .MaxViewers = 100,
+            .MaxEgressBitsPerSecond = 1000000000,
+            .MaxFanoutQueueDepth = 8192,
+        });
+
+    CHECK(estimator.Estimate(NodeLoad()) == 0);
+    CHECK(estimator.Estimate(NodeLoad { .ViewerCount = 25 }) == 250);
+    CHECK(estimator.Estimate(
+        NodeLoad { .ViewerCount = 25, .EgressBitsPerSecond = 500000000 }) == 500);
+    CHECK(estimator.Estimate(
+        NodeLoad { .ViewerCount = 25, .CpuUtilization = 0.75 }) == 750);
+    CHECK(estimator.Estimate(
+        NodeLoad { .ViewerCount = 25, .FanoutQueueDepth = 4096 }) == 500);
+
+    // Overloaded is as loaded as it gets
+    CHECK(estimator.Estimate(NodeLoad { .ViewerCount = 1000 }) ==
+        NodeLoadEstimator::MAXIMUM_LOAD);
+}
+
+TEST_CASE( "NodeLoadEstimator ignores resources without a limit", "[utilities]" )
+{
+    NodeLoadEstimator estimator(NodeCapacity {});
+    CHECK(estimator.Estimate(
+        NodeLoad { .ViewerCount = 100000, .EgressBitsPerSecond = 100000000000 }) == 0);
+    // CPU is always limited to the machine we're on
+    CHECK(estimator.Estimate(NodeLoad { .CpuUtilization = 0.5 }) == 500);
+}
+
+TEST_CASE( "CpuUsageSampler measures time spent on the CPU", "[utilities]" )
+{
+    CpuUsageSampler sampler;
+
+    // Keep a core busy for a little while
+    const auto busyUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    volatile uint64_t counter = 0;
+    while (std::chrono::steady_clock::now() < busyUntil)
+    {
+        counter = counter + 1;
+    }
+    const double busyUtilization = sampler.Sample();
+    CHECK(busyUtilization > 0.0);
+    CHECK(busyUtilization <= 1.0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(sampler.Sample() < busyUtilization);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file OverloadControllerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/Utilities/OverloadController.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const OverloadController::Policy QUEUE_POLICY
+    {
+        .MaxFanoutQueueDepth = 100,
+        .SustainFor = 1000ms,
+        .RecoverAfter = 5000ms,
+        .ShedViewerFraction = 0.25,
+    };
+}
+
+TEST_CASE( "OverloadController steps up a level each time overload is sustained", "[utilities]" )
+{
+    OverloadController controller(QUEUE_POLICY);
+    const auto start = OverloadController::Clock::now();
+    CHECK( controller.Sample(10, start) == OverloadController::Level::Normal );
+
+    // A brief spike isn't enough
+    CHECK( controller.Sample(500, (start + 250ms)) == OverloadController::Level::Normal );
+    CHECK( controller.Sample(10, (start + 500ms)) == OverloadController::Level::Normal );
+
+    CHECK( controller.Sample(100, (start + 1000ms)) == OverloadController::Level::Normal );
+    CHECK( controller.Sample(100, (start + 2000ms)) ==
+        OverloadController::Level::RejectingViewers );
+    CHECK_FALSE( controller.IsAcceptingViewers() );
+    CHECK_FALSE( controller.IsSheddingVideo() );
+
+    // Rejecting viewers gets its own chance to help before video is shed
+    CHECK( controller.Sample(100, (start + 2500ms)) ==
+        OverloadController::Level::RejectingViewers );
+    CHECK( controller.Sample(100, (start + 3000ms)) == OverloadController::Level::SheddingVideo );
+    CHECK( controller.IsSheddingVideo() );
+    CHECK( controller.Sample(100, (start + 9000ms)) == OverloadController::Level::SheddingVideo );
+}
+
+TEST_CASE( "OverloadController steps down a level at a time once healthy", "[utilities]" )
+{
+    OverloadController controller(QUEUE_POLICY);
+    const auto start = OverloadController::Clock::now();
+    controller.Sample(100, start);
+    controller.Sample(100, (start + 1000ms));
+    REQUIRE( controller.Sample(100, (start + 2000ms)) == OverloadController::Level::SheddingVideo );
+
+    CHECK( controller.Sample(0, (start + 3000ms)) == OverloadController::Level::SheddingVideo );
+    CHECK( controller.Sample(0, (start + 8000ms)) == OverloadController::Level::RejectingViewers );
+    // Overload coming back part way through recovering starts the wait over
+    CHECK( controller.Sample(100, (start + 9000ms)) ==
+        OverloadController::Level::RejectingViewers );
+    CHECK( controller.Sample(0, (start + 10000ms)) ==
+        OverloadController::Level::RejectingViewers );
+    CHECK( controller.Sample(0, (start + 14000ms)) ==
+        OverloadController::Level::RejectingViewers );
+    CHECK( controller.Sample(0, (start + 15000ms)) == OverloadController::Level::Normal );
+    CHECK( controller.IsAcceptingViewers() );
+}
+
+TEST_CASE( "OverloadController counts slow fanout as overload", "[utilities]" )
+{
+    OverloadController controller(OverloadController::Policy
+        {
+            .MaxFanoutLatency = 20ms,
+            .SustainFor = 0ms,
+        });
+    const auto start = OverloadController::Clock::now();
+    controller.RecordFanoutLatency(1ms);
+    controller.RecordFanoutLatency(5ms);
+    CHECK( controller.Sample(1000000, start) == OverloadController::Level::Normal );
+
+    controller.RecordFanoutLatency(25ms);
+    controller.RecordFanoutLatency(2ms);
+    CHECK( controller.Sample(0, (start + 250ms)) == OverloadController::Level::RejectingViewers );
+    // The slowest fanout is only counted for the sample it was recorded before
+    CHECK( controller.Sample(0, (start + 500ms)) == OverloadController::Level::RejectingViewers );
+}
+
+TEST_CASE( "OverloadController sheds the given share of viewers, rounding up", "[utilities]" )
+{
+    OverloadController controller(QUEUE_POLICY);
+    CHECK( controller.GetShedViewerCount(0) == 0 );
+    CHECK( controller.GetShedViewerCount(1) == 1 );
+    CHECK( controller.GetShedViewerCount(8) == 2 );
+    CHECK( controller.GetShedViewerCount(9) == 3 );
+
+    controller.RecordRejectedViewer();
+    controller.RecordShedVideoPackets(3);
+    controller.RecordShedVideoPackets(2);
+    CHECK( controller.GetRejectedViewerCount() == 1 );
+    CHECK( controller.GetShedVideoPacketCount() == 5 );
+}
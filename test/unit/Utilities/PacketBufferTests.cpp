@@ -0,0 +1,137 @@
+/**
+ * @file PacketBufferTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+#include "../../../src/Utilities/PacketBuffer.h"
+#include "../../../src/Utilities/Util.h"
+
+TEST_CASE( "PacketBuffer copies share the underlying bytes", "[utilities]" )
+{
+    std::vector<std::byte> bytes = Util::StringToByteVector("Hello, packet!");
+    PacketBuffer buffer = PacketBuffer::Copy(bytes);
+    REQUIRE( buffer.Size() == bytes.size() );
+    CHECK( buffer.IsUnique() );
+    CHECK_THAT( std::vector<std::byte>(buffer.Bytes().begin(), buffer.Bytes().end()),
+        Catch::Equals( bytes ) );
+
+    PacketBuffer shared = buffer;
+    CHECK( shared.Data() == buffer.Data() );
+    CHECK_FALSE( buffer.IsUnique() );
+    CHECK_FALSE( shared.IsUnique() );
+
+    shared.Reset();
+    CHECK_FALSE( shared );
+    CHECK( buffer.IsUnique() );
+}
+
+TEST_CASE( "PacketBufferPool re-uses released buffers", "[utilities]" )
+{
+    PacketBufferPool pool(64, 2);
+    PacketBuffer first = pool.Acquire();
+    REQUIRE( first.Capacity() == 64 );
+    REQUIRE( first.Empty() );
+    const std::byte* firstData = first.Data();
+
+    first.Resize(10);
+    CHECK( first.Size() == 10 );
+    CHECK_THROWS_AS( first.Resize(65), std::out_of_range );
+
+    first.Reset();
+    PacketBuffer reused = pool.Acquire();
+    CHECK( reused.Data() == firstData );
+    CHECK( reused.Empty() );
+
+    // Acquiring more buffers than fit in a slab allocates another one
+    std::vector<PacketBuffer> buffers;
+    for (int i = 0; i < 5; ++i)
+    {
+        buffers.push_back(pool.Acquire());
+        CHECK( buffers.back().Capacity() == 64 );
+    }
+}
+
+TEST_CASE( "PacketBuffer copies of oversized data are allocated outside the pool", "[utilities]" )
+{
+    std::vector<std::byte> bytes(PacketBufferPool::Default().GetBufferCapacity() + 1,
+        std::byte(0x42));
+    PacketBuffer buffer = PacketBuffer::Copy(bytes);
+    REQUIRE( buffer.Size() == bytes.size() );
+    CHECK( buffer.Bytes()[bytes.size() - 1] == std::byte(0x42) );
+}
+
+TEST_CASE( "PacketBufferPool counts hits, misses and buffers in use", "[utilities]" )
+{
+    PacketBufferPool pool(64, 2);
+    std::vector<PacketBuffer> buffers;
+    for (int i = 0; i < 3; ++i)
+    {
+        buffers.push_back(pool.Acquire());
+    }
+    buffers.pop_back();
+    buffers.push_back(pool.Acquire());
+
+    PacketBufferPool::Stats stats = pool.GetStats();
+    CHECK( stats.BufferCapacity == 64 );
+    // The first and third acquires each needed a new slab
+    CHECK( stats.Misses == 2 );
+    CHECK( stats.Hits == 2 );
+    CHECK( stats.AllocatedBuffers == 4 );
+    CHECK( stats.BuffersInUse == 3 );
+    CHECK( stats.PeakBuffersInUse == 3 );
+
+    buffers.clear();
+    stats = pool.GetStats();
+    CHECK( stats.BuffersInUse == 0 );
+    CHECK( stats.PeakBuffersInUse == 3 );
+}
+
+TEST_CASE( "PacketBuffer copies pick the smallest size class that fits", "[utilities]" )
+{
+    CHECK( PacketBufferPool::ForSize(1) == &PacketBufferPool::Default() );
+    CHECK( PacketBufferPool::ForSize(PacketBufferPool::LARGE_BUFFER_CAPACITY + 1) == nullptr );
+    const std::vector<PacketBufferPool::Stats> sizeClasses =
+        PacketBufferPool::GetSizeClassStats();
+    REQUIRE( sizeClasses.size() == 2 );
+    CHECK( sizeClasses[0].BufferCapacity == PacketBufferPool::DEFAULT_BUFFER_CAPACITY );
+    CHECK( sizeClasses[1].BufferCapacity == PacketBufferPool::LARGE_BUFFER_CAPACITY );
+
+    std::vector<std::byte> jumbo(PacketBufferPool::DEFAULT_BUFFER_CAPACITY + 1);
+    CHECK( PacketBuffer::Copy(jumbo).Capacity() == PacketBufferPool::LARGE_BUFFER_CAPACITY );
+
+    const uint64_t unpooled = PacketBufferPool::GetUnpooledBufferCount();
+    std::vector<std::byte> huge(PacketBufferPool::LARGE_BUFFER_CAPACITY + 1);
+    CHECK( PacketBuffer::Copy(huge).Capacity() == huge.size() );
+    CHECK( PacketBufferPool::GetUnpooledBufferCount() == (unpooled + 1) );
+}
+
+TEST_CASE( "PacketBufferPool buffers can be released on other threads", "[utilities]" )
+{
+    PacketBufferPool& pool = PacketBufferPool::Default();
+    const uint64_t inUse = pool.GetStats().BuffersInUse;
+
+    // Enough to fill and spill a thread's cache several times over
+    std::vector<PacketBuffer> buffers;
+    for (int i = 0; i < 1000; ++i)
+    {
+        buffers.push_back(pool.Acquire());
+        buffers.back().Data()[0] = std::byte(i & 0xFF);
+    }
+    std::thread releaser([&buffers]() { buffers.clear(); });
+    releaser.join();
+    CHECK( pool.GetStats().BuffersInUse == inUse );
+
+    // Buffers the other thread cached were given back when it exited
+    const uint64_t allocated = pool.GetStats().AllocatedBuffers;
+    for (int i = 0; i < 1000; ++i)
+    {
+        buffers.push_back(pool.Acquire());
+    }
+    CHECK( pool.GetStats().AllocatedBuffers == allocated );
+}
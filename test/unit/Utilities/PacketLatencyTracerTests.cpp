@@ -0,0 +1,47 @@
+/**
+ * @file PacketLatencyTracerTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <memory>
+#include <vector>
+
+#include "../../../src/Utilities/PacketLatencyTracer.h"
+
+TEST_CASE( "PacketLatencyTracer records stamped packets into per-stage histograms",
+    "[utilities]" )
+{
+    auto metrics = std::make_shared<MetricsRegistry>();
+    PacketLatencyTracer tracer(metrics, 1234);
+    std::vector<PacketBuffer> packets
+    {
+        PacketBufferPool::Default().Acquire(),
+        PacketBufferPool::Default().Acquire(),
+    };
+    PacketLatencyTracer::StampReceived(std::span(packets).first(1));
+
+    // Only packets stamped when they were received are recorded
+    tracer.Record(PacketLatencyTracer::Stage::Sequenced, packets[0]);
+    tracer.Record(PacketLatencyTracer::Stage::Sequenced, packets[1]);
+    tracer.Record(PacketLatencyTracer::Stage::RelaySend, packets[0]);
+
+    auto sequenced = metrics->AddHistogram("ftl_packet_latency_seconds", "",
+        { { "channel", "1234" }, { "stage", "sequenced" } });
+    auto viewerSend = metrics->AddHistogram("ftl_packet_latency_seconds", "",
+        { { "channel", "1234" }, { "stage", "viewer_send" } });
+    auto relaySend = metrics->AddHistogram("ftl_packet_latency_seconds", "",
+        { { "channel", "1234" }, { "stage", "relay_send" } });
+    const uint64_t expectedCount = PacketLatencyTracer::IS_ENABLED ? 1 : 0;
+    CHECK(sequenced->GetSnapshot().Count == expectedCount);
+    CHECK(viewerSend->GetSnapshot().Count == 0);
+    CHECK(relaySend->GetSnapshot().Count == expectedCount);
+    CHECK(sequenced->GetBucketBounds() == PacketLatencyTracer::LATENCY_BUCKETS);
+
+    // A recycled buffer doesn't carry over the time its last packet was received
+    packets.clear();
+    PacketBuffer recycled = PacketBufferPool::Default().Acquire();
+    CHECK(recycled.GetReceiveTime() == std::chrono::steady_clock::time_point());
+}
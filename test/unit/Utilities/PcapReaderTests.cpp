@@ -0,0 +1,250 @@
+/**
+ * @file PcapReaderTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "../../../src/Utilities/PcapReader.h"
+
+/**
+ * @brief Writes a pcap capture in memory, in our own byte order unless told otherwise
+ */
+class PcapWriter
+{
+public:
+    PcapWriter(uint32_t linkType, bool byteSwapped = false, bool nanoseconds = false) :
+        byteSwapped(byteSwapped)
+    {
+        appendUint32(nanoseconds ? 0xA1B23C4D : 0xA1B2C3D4);
+        appendUint16(2);
+        appendUint16(4);
+        appendUint32(0);
+        appendUint32(0);
+        appendUint32(65535);
+        appendUint32(linkType);
+    }
+
+    void AppendFrame(uint32_t seconds, uint32_t fraction, const std::vector<uint8_t>& frame)
+    {
+        appendUint32(seconds);
+        appendUint32(fraction);
+        appendUint32(frame.size());
+        appendUint32(frame.size());
+        bytes.append(frame.begin(), frame.end());
+    }
+
+    std::string Bytes() const
+    {
+        return bytes;
+    }
+
+private:
+    const bool byteSwapped;
+    std::string bytes;
+
+    void appendUint32(uint32_t value)
+    {
+        if (byteSwapped)
+        {
+            value = __builtin_bswap32(value);
+        }
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void appendUint16(uint16_t value)
+    {
+        if (byteSwapped)
+        {
+            value = __builtin_bswap16(value);
+        }
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
+
+static std::vector<uint8_t> udpSegment(uint16_t sourcePort, uint16_t destinationPort,
+    const std::vector<uint8_t>& payload)
+{
+    const uint16_t length = 8 + payload.size();
+    std::vector<uint8_t> segment {
+        uint8_t(sourcePort >> 8), uint8_t(sourcePort & 0xFF),
+        uint8_t(destinationPort >> 8), uint8_t(destinationPort & 0xFF),
+        uint8_t(length >> 8), uint8_t(length & 0xFF),
+        0, 0,
+    };
+    segment.insert(segment.end(), payload.begin(), payload.end());
+    return segment;
+}
+
+static std::vector<uint8_t> ipv4Packet(const std::vector<uint8_t>& segment,
+    uint8_t protocol = 17, uint16_t fragmentBits = 0)
+{
+    const uint16_t length = 20 + segment.size();
+    std::vector<uint8_t> packet {
+        0x45, 0, uint8_t(length >> 8), uint8_t(length & 0xFF),
+        0, 0, uint8_t(fragmentBits >> 8), uint8_t(fragmentBits & 0xFF),
+        64, protocol, 0, 0,
+        10, 0, 0, 1,
+        10, 0, 0, 2,
+    };
+    packet.insert(packet.end(), segment.begin(), segment.end());
+    return packet;
+}
+
+static std::vector<uint8_t> ipv6Packet(const std::vector<uint8_t>& segment)
+{
+    std::vector<uint8_t> packet(40, 0);
+    packet[0] = 0x60;
+    packet[4] = uint8_t(segment.size() >> 8);
+    packet[5] = uint8_t(segment.size() & 0xFF);
+    packet[6] = 17;
+    packet[7] = 64;
+    packet.insert(packet.end(), segment.begin(), segment.end());
+    return packet;
+}
+
+static std::vector<uint8_t> ethernetFrame(const std::vector<uint8_t>& packet,
+    uint16_t etherType, std::optional<uint16_t> vlanId = std::nullopt)
+{
+    std::vector<uint8_t> frame(12, 0xAA);
+    if (vlanId.has_value())
+    {
+        frame.insert(frame.end(),
+            { 0x81, 0x00, uint8_t(vlanId.value() >> 8), uint8_t(vlanId.value() & 0xFF) });
+    }
+    frame.insert(frame.end(), { uint8_t(etherType >> 8), uint8_t(etherType & 0xFF) });
+    frame.insert(frame.end(), packet.begin(), packet.end());
+    return frame;
+}
+
+static std::vector<std::byte> toBytes(const std::vector<uint8_t>& values)
+{
+    std::vector<std::byte> bytes(values.size());
+    std::memcpy(bytes.data(), values.data(), values.size());
+    return bytes;
+}
+
+TEST_CASE("PcapReader reads UDP datagrams out of Ethernet captures")
+{
+    const std::vector<uint8_t> firstPayload { 0x80, 0x60, 0x00, 0x01 };
+    const std::vector<uint8_t> secondPayload { 0x80, 0x61, 0x00, 0x02, 0x03 };
+    PcapWriter writer(PcapReader::LINK_TYPE_ETHERNET);
+    writer.AppendFrame(100, 250000,
+        ethernetFrame(ipv4Packet(udpSegment(5000, 9000, firstPayload)), 0x0800));
+    // ARP, which is skipped
+    writer.AppendFrame(100, 300000, ethernetFrame(std::vector<uint8_t>(28, 0), 0x0806));
+    writer.AppendFrame(101, 0,
+        ethernetFrame(ipv4Packet(udpSegment(5001, 9001, secondPayload)), 0x0800, 42));
+    std::istringstream input(writer.Bytes());
+
+    PcapReader reader(input);
+    REQUIRE(reader.GetLinkType() == PcapReader::LINK_TYPE_ETHERNET);
+
+    auto first = reader.ReadNextUdpDatagram();
+    REQUIRE(first.has_value());
+    REQUIRE(first->Timestamp == (std::chrono::seconds(100) + std::chrono::microseconds(250000)));
+    REQUIRE(first->SourcePort == 5000);
+    REQUIRE(first->DestinationPort == 9000);
+    REQUIRE(first->Payload == toBytes(firstPayload));
+
+    auto second = reader.ReadNextUdpDatagram();
+    REQUIRE(second.has_value());
+    REQUIRE(second->Timestamp == std::chrono::seconds(101));
+    REQUIRE(second->SourcePort == 5001);
+    REQUIRE(second->Payload == toBytes(secondPayload));
+
+    REQUIRE_FALSE(reader.ReadNextUdpDatagram().has_value());
+    REQUIRE(reader.GetSkippedFrameCount() == 1);
+}
+
+TEST_CASE("PcapReader reads captures written with the other byte order and nanoseconds")
+{
+    const std::vector<uint8_t> payload { 1, 2, 3 };
+    PcapWriter writer(PcapReader::LINK_TYPE_RAW, true, true);
+    writer.AppendFrame(7, 123, ipv6Packet(udpSegment(1, 2, payload)));
+    std::istringstream input(writer.Bytes());
+
+    PcapReader reader(input);
+    REQUIRE(reader.GetLinkType() == PcapReader::LINK_TYPE_RAW);
+    auto datagram = reader.ReadNextUdpDatagram();
+    REQUIRE(datagram.has_value());
+    REQUIRE(datagram->Timestamp == (std::chrono::seconds(7) + std::chrono::nanoseconds(123)));
+    REQUIRE(datagram->DestinationPort == 2);
+    REQUIRE(datagram->Payload == toBytes(payload));
+}
+
+TEST_CASE("PcapReader reads Linux cooked captures")
+{
+    const std::vector<uint8_t> payload { 9, 8, 7, 6 };
+    std::vector<uint8_t> frame(16, 0);
+    frame[14] = 0x08;
+    frame[15] = 0x00;
+    const std::vector<uint8_t> packet = ipv4Packet(udpSegment(1234, 4321, payload));
+    frame.insert(frame.end(), packet.begin(), packet.end());
+    PcapWriter writer(PcapReader::LINK_TYPE_LINUX_SLL);
+    writer.AppendFrame(1, 0, frame);
+    std::istringstream input(writer.Bytes());
+
+    PcapReader reader(input);
+    auto datagram = reader.ReadNextUdpDatagram();
+    REQUIRE(datagram.has_value());
+    REQUIRE(datagram->SourcePort == 1234);
+    REQUIRE(datagram->Payload == toBytes(payload));
+}
+
+TEST_CASE("PcapReader skips frames it can't read a whole UDP datagram out of")
+{
+    PcapWriter writer(PcapReader::LINK_TYPE_IPV4);
+    // TCP
+    writer.AppendFrame(1, 0, ipv4Packet(std::vector<uint8_t>(20, 0), 6));
+    // A fragment
+    writer.AppendFrame(1, 1, ipv4Packet(udpSegment(1, 2, { 1 }), 17, 0x2000));
+    // Cut short by the snap length
+    std::vector<uint8_t> truncated = ipv4Packet(udpSegment(1, 2, { 1, 2, 3, 4 }));
+    truncated.resize(truncated.size() - 2);
+    writer.AppendFrame(1, 2, truncated);
+    writer.AppendFrame(1, 3, ipv4Packet(udpSegment(1, 2, { 42 })));
+    std::istringstream input(writer.Bytes());
+
+    PcapReader reader(input);
+    auto datagram = reader.ReadNextUdpDatagram();
+    REQUIRE(datagram.has_value());
+    REQUIRE(datagram->Payload == toBytes({ 42 }));
+    REQUIRE(reader.GetSkippedFrameCount() == 3);
+}
+
+TEST_CASE("PcapReader treats a truncated final frame as the end of the capture")
+{
+    PcapWriter writer(PcapReader::LINK_TYPE_IPV4);
+    writer.AppendFrame(1, 0, ipv4Packet(udpSegment(1, 2, { 1, 2, 3 })));
+    writer.AppendFrame(1, 1, ipv4Packet(udpSegment(1, 2, { 4, 5, 6 })));
+    std::string bytes = writer.Bytes();
+    bytes.resize(bytes.size() - 5);
+    std::istringstream input(bytes);
+
+    PcapReader reader(input);
+    REQUIRE(reader.ReadNextUdpDatagram().has_value());
+    REQUIRE_FALSE(reader.ReadNextUdpDatagram().has_value());
+}
+
+TEST_CASE("PcapReader rejects captures it can't read")
+{
+    std::istringstream tooShort("abc");
+    REQUIRE_THROWS_AS(PcapReader(tooShort), std::runtime_error);
+
+    std::string pcapng(24, '\0');
+    const uint32_t pcapngMagic = 0x0A0D0D0A;
+    std::memcpy(pcapng.data(), &pcapngMagic, sizeof(pcapngMagic));
+    std::istringstream pcapngInput(pcapng);
+    REQUIRE_THROWS_AS(PcapReader(pcapngInput), std::runtime_error);
+
+    // 802.11
+    PcapWriter writer(105);
+    std::istringstream unsupportedInput(writer.Bytes());
+    REQUIRE_THROWS_AS(PcapReader(unsupportedInput), std::runtime_error);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file RcuValueTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "../../../src/Utilities/RcuValue.h"
+
+TEST_CASE( "RcuValue publishes updates without disturbing existing snapshots", "[utilities]" )
+{
+    RcuValue<std::vector<int>> value({ 1, 2, 3 });
+
+    std::shared_ptr<const std::vector<int>> snapshot = value.Read();
+    REQUIRE(snapshot->size() == 3);
+
+    // Update from another thread, since we're holding a snapshot
+    auto updated = std::async(std::launch::async,
+        [&value]()
+        {
+            return value.Update(
+                [](std::vector<int>& values)
+                {
+                    values.push_back(4);
+                    return values.size();
+                });
+        });
+
+    // The update can't finish until we let go of our snapshot
+    CHECK(updated.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+    CHECK(*snapshot == std::vector<int>({ 1, 2, 3 }));
+    snapshot.reset();
+
+    REQUIRE(updated.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    CHECK(updated.get() == 4);
+    CHECK(*value.Read() == std::vector<int>({ 1, 2, 3, 4 }));
+
+    value.Update([](std::vector<int>& values) { values.clear(); });
+    CHECK(value.Read()->empty());
+}
+
+TEST_CASE( "RcuValue readers always see a complete snapshot", "[utilities]" )
+{
+    // Every published vector holds copies of a single number
+    RcuValue<std::vector<int>> value(std::vector<int>(64, 0));
+
+    std::atomic<bool> isDone = false;
+    std::atomic<size_t> tornReads = 0;
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 2; ++i)
+    {
+        readers.emplace_back(
+            [&]()
+            {
+                while (!isDone)
+                {
+                    auto snapshot = value.Read();
+                    for (int element : *snapshot)
+                    {
+                        if (element != snapshot->front())
+                        {
+                            ++tornReads;
+                        }
+                    }
+                }
+            });
+    }
+
+    for (int i = 1; i <= 200; ++i)
+    {
+        value.Update(
+            [i](std::vector<int>& values)
+            {
+                std::fill(values.begin(), values.end(), i);
+            });
+    }
+    isDone = true;
+    readers.clear();
+
+    CHECK(tornReads == 0);
+    CHECK(value.Read()->front() == 200);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file RetryBackoffTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/Utilities/RetryBackoff.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE( "RetryBackoff doubles delays up to a limit", "[utilities]" )
+{
+    const auto start = std::chrono::steady_clock::now();
+    RetryBackoff backoff(
+        RetryBackoff::Policy
+        {
+            .InitialDelay = 100ms,
+            .MaxDelay = 500ms,
+            .Timeout = 60s,
+        },
+        start);
+
+    CHECK(backoff.NextDelay(start) == 100ms);
+    CHECK(backoff.NextDelay(start) == 200ms);
+    CHECK(backoff.NextDelay(start) == 400ms);
+    CHECK(backoff.NextDelay(start) == 500ms);
+    CHECK(backoff.NextDelay(start) == 500ms);
+    CHECK(backoff.GetRetryCount() == 5);
+}
+
+TEST_CASE( "RetryBackoff gives up at the deadline", "[utilities]" )
+{
+    const auto start = std::chrono::steady_clock::now();
+    RetryBackoff backoff(
+        RetryBackoff::Policy
+        {
+            .InitialDelay = 1s,
+            .MaxDelay = 1s,
+            .Timeout = 3s,
+        },
+        start);
+    REQUIRE(backoff.GetDeadline() == (start + 3s));
+
+    CHECK(backoff.NextDelay(start) == 1s);
+    CHECK(backoff.NextDelay(start + 1500ms) == 1s);
+    // Waiting another second would run into the deadline, so don't bother
+    CHECK_FALSE(backoff.NextDelay(start + 2s).has_value());
+    CHECK(backoff.GetRetryCount() == 2);
+}
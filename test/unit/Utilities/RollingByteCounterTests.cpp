@@ -0,0 +1,71 @@
+/**
+ * @file RollingByteCounterTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <thread>
+
+#include "../../../src/Utilities/RollingByteCounter.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE( "RollingByteCounter sums bytes within the window", "[utilities]" )
+{
+    RollingByteCounter counter(100ms, 10ms);
+    const RollingByteCounter::Clock::time_point start(1s);
+
+    CHECK( counter.GetSum(start) == 0 );
+
+    counter.Add(100, start);
+    counter.Add(50, start + 5ms);
+    counter.Add(25, start + 40ms);
+    CHECK( counter.GetSum(start + 40ms) == 175 );
+
+    // Reading ahead of the newest bucket discounts expired buckets without modifying them
+    CHECK( counter.GetSum(start + 100ms) == 25 );
+    CHECK( counter.GetSum(start + 140ms) == 0 );
+    CHECK( counter.GetSum(start + 40ms) == 175 );
+
+    // Adding advances the window, expiring the oldest buckets
+    counter.Add(10, start + 105ms);
+    CHECK( counter.GetSum(start + 105ms) == 35 );
+}
+
+TEST_CASE( "RollingByteCounter resets after a gap longer than the window", "[utilities]" )
+{
+    RollingByteCounter counter(100ms, 10ms);
+    const RollingByteCounter::Clock::time_point start(1s);
+
+    counter.Add(1000, start);
+    counter.Add(10, start + 1s);
+    CHECK( counter.GetSum(start + 1s) == 10 );
+}
+
+TEST_CASE( "RollingByteCounter can be read while it is being written", "[utilities]" )
+{
+    RollingByteCounter counter(100ms, 10ms);
+    const RollingByteCounter::Clock::time_point start(1s);
+    constexpr int NUM_ADDS = 100000;
+
+    std::thread writer(
+        [&]()
+        {
+            for (int i = 0; i < NUM_ADDS; ++i)
+            {
+                counter.Add(1, start);
+            }
+        });
+    uint64_t lastSum = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint64_t sum = counter.GetSum(start);
+        REQUIRE( sum >= lastSum );
+        REQUIRE( sum <= NUM_ADDS );
+        lastSum = sum;
+    }
+    writer.join();
+    CHECK( counter.GetSum(start) == NUM_ADDS );
+}
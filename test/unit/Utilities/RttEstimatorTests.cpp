@@ -0,0 +1,60 @@
+/**
+ * @file RttEstimatorTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/Utilities/RttEstimator.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE( "RttEstimator starts from its initial RTT", "[utilities]" )
+{
+    RttEstimator estimator(40ms);
+    CHECK_FALSE(estimator.HasSamples());
+    CHECK(estimator.GetSmoothedRtt() == 40ms);
+    CHECK(estimator.GetRttVariation() == 20ms);
+    CHECK(estimator.GetRetransmitTimeout() == 120ms);
+
+    // The first sample replaces the guess outright
+    estimator.AddSample(80ms);
+    CHECK(estimator.HasSamples());
+    CHECK(estimator.GetSmoothedRtt() == 80ms);
+    CHECK(estimator.GetRttVariation() == 40ms);
+}
+
+TEST_CASE( "RttEstimator smooths samples", "[utilities]" )
+{
+    RttEstimator estimator;
+    estimator.AddSample(80ms);
+    estimator.AddSample(160ms);
+    // SRTT = (7 * 80 + 160) / 8, RTTVAR = (3 * 40 + 80) / 4
+    CHECK(estimator.GetSmoothedRtt() == 90ms);
+    CHECK(estimator.GetRttVariation() == 50ms);
+    CHECK(estimator.GetRetransmitTimeout() == 290ms);
+    CHECK(estimator.GetSampleCount() == 2);
+
+    // Steady samples settle the variation down
+    for (int i = 0; i < 100; ++i)
+    {
+        estimator.AddSample(50ms);
+    }
+    CHECK(estimator.GetSmoothedRtt() < 51ms);
+    CHECK(estimator.GetRttVariation() < 1ms);
+}
+
+TEST_CASE( "RttEstimator keeps its timeout within limits", "[utilities]" )
+{
+    RttEstimator estimator;
+    for (int i = 0; i < 100; ++i)
+    {
+        estimator.AddSample(1ms);
+    }
+    CHECK(estimator.GetRetransmitTimeout() == RttEstimator::MIN_RETRANSMIT_TIMEOUT);
+
+    estimator.AddSample(10s);
+    CHECK(estimator.GetRetransmitTimeout() == RttEstimator::MAX_RETRANSMIT_TIMEOUT);
+}
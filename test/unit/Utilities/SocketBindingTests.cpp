@@ -0,0 +1,149 @@
+/**
+ * @file SocketBindingTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <arpa/inet.h>
+#include <catch2/catch.hpp>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../../src/Utilities/SocketBinding.h"
+
+TEST_CASE( "SocketBinding parses IPv4 and IPv6 bind addresses", "[utilities]" )
+{
+    SocketBinding binding;
+    CHECK(binding.IsDefault());
+
+    // Nothing configured sticks with every IPv4 address
+    Result<SocketBinding::BindAddress> anyAddress = binding.GetBindAddress(8084);
+    REQUIRE_FALSE(anyAddress.IsError);
+    REQUIRE(anyAddress.Value.GetFamily() == AF_INET);
+    const auto& anyIpv4 = reinterpret_cast<const sockaddr_in&>(anyAddress.Value.Address);
+    CHECK(anyIpv4.sin_addr.s_addr == htonl(INADDR_ANY));
+    CHECK(anyIpv4.sin_port == htons(8084));
+    CHECK(anyAddress.Value.Length == sizeof(sockaddr_in));
+
+    Result<SocketBinding::BindAddress> ipv4Address =
+        SocketBinding::ParseAddress("10.0.0.1", 9000);
+    REQUIRE_FALSE(ipv4Address.IsError);
+    REQUIRE(ipv4Address.Value.GetFamily() == AF_INET);
+    CHECK(reinterpret_cast<const sockaddr_in&>(ipv4Address.Value.Address).sin_addr.s_addr ==
+        htonl(0x0A000001));
+
+    Result<SocketBinding::BindAddress> ipv6Address =
+        SocketBinding::ParseAddress("2001:db8::1", 9000);
+    REQUIRE_FALSE(ipv6Address.IsError);
+    REQUIRE(ipv6Address.Value.GetFamily() == AF_INET6);
+    const auto& ipv6 = reinterpret_cast<const sockaddr_in6&>(ipv6Address.Value.Address);
+    CHECK(ipv6.sin6_port == htons(9000));
+    CHECK(ipv6.sin6_addr.s6_addr[0] == 0x20);
+    CHECK(ipv6.sin6_addr.s6_addr[15] == 0x01);
+    CHECK(ipv6Address.Value.Length == sizeof(sockaddr_in6));
+
+    Result<SocketBinding::BindAddress> linkLocal = SocketBinding::ParseAddress("fe80::1%lo", 0);
+    REQUIRE_FALSE(linkLocal.IsError);
+    CHECK(reinterpret_cast<const sockaddr_in6&>(linkLocal.Value.Address).sin6_scope_id != 0);
+
+    CHECK(SocketBinding::ParseAddress("eth0", 0).IsError);
+    CHECK(SocketBinding::ParseAddress("10.0.0.256", 0).IsError);
+    CHECK(SocketBinding::ParseAddress("fe80::1%nosuchinterface", 0).IsError);
+}
+
+TEST_CASE( "SocketBinding picks bind addresses for each family of peer", "[utilities]" )
+{
+    SocketBinding binding;
+    Result<SocketBinding::BindAddress> anyIpv6 = binding.GetBindAddress(9000, AF_INET6);
+    REQUIRE_FALSE(anyIpv6.IsError);
+    REQUIRE(anyIpv6.Value.GetFamily() == AF_INET6);
+    const auto& ipv6 = reinterpret_cast<const sockaddr_in6&>(anyIpv6.Value.Address);
+    CHECK(IN6_IS_ADDR_UNSPECIFIED(&ipv6.sin6_addr));
+    CHECK(ipv6.sin6_port == htons(9000));
+    CHECK(binding.GetBindAddress(9000, AF_INET).Value.GetFamily() == AF_INET);
+
+    // "::" covers IPv4 peers too
+    binding.Address = "::";
+    Result<SocketBinding::BindAddress> anyIpv4 = binding.GetBindAddress(9000, AF_INET);
+    REQUIRE_FALSE(anyIpv4.IsError);
+    REQUIRE(anyIpv4.Value.GetFamily() == AF_INET);
+    const auto& ipv4 = reinterpret_cast<const sockaddr_in&>(anyIpv4.Value.Address);
+    CHECK(ipv4.sin_addr.s_addr == htonl(INADDR_ANY));
+    CHECK(ipv4.sin_port == htons(9000));
+    CHECK(binding.GetBindAddress(9000, AF_INET6).Value.GetFamily() == AF_INET6);
+
+    // Specific addresses only reach their own family
+    binding.Address = "10.0.0.1";
+    CHECK_FALSE(binding.GetBindAddress(9000, AF_INET).IsError);
+    CHECK(binding.GetBindAddress(9000, AF_INET6).IsError);
+    binding.Address = "2001:db8::1";
+    CHECK_FALSE(binding.GetBindAddress(9000, AF_INET6).IsError);
+    CHECK(binding.GetBindAddress(9000, AF_INET).IsError);
+}
+
+TEST_CASE( "SocketBinding unmaps IPv4 peers of dual-stack sockets", "[utilities]" )
+{
+    sockaddr_storage address {};
+    auto& ipv4 = reinterpret_cast<sockaddr_in&>(address);
+    ipv4.sin_family = AF_INET;
+    ipv4.sin_port = htons(1234);
+    ipv4.sin_addr.s_addr = htonl(0x7F000001);
+    std::optional<sockaddr_in> unmapped = SocketBinding::ToIpv4(address);
+    REQUIRE(unmapped.has_value());
+    CHECK(unmapped->sin_addr.s_addr == htonl(0x7F000001));
+
+    address = {};
+    auto& ipv6 = reinterpret_cast<sockaddr_in6&>(address);
+    ipv6.sin6_family = AF_INET6;
+    ipv6.sin6_port = htons(1234);
+    REQUIRE(inet_pton(AF_INET6, "::ffff:10.1.2.3", &ipv6.sin6_addr) == 1);
+    unmapped = SocketBinding::ToIpv4(address);
+    REQUIRE(unmapped.has_value());
+    CHECK(unmapped->sin_family == AF_INET);
+    CHECK(unmapped->sin_port == htons(1234));
+    CHECK(unmapped->sin_addr.s_addr == htonl(0x0A010203));
+
+    // Peers that only have an IPv6 address have no IPv4 address to give
+    REQUIRE(inet_pton(AF_INET6, "2001:db8::1", &ipv6.sin6_addr) == 1);
+    CHECK_FALSE(SocketBinding::ToIpv4(address).has_value());
+}
+
+TEST_CASE( "SocketBinding tunes sockets before they're bound", "[utilities]" )
+{
+    SocketBinding binding;
+    binding.Address = "::";
+    binding.ReceiveBufferBytes = 64 * 1024;
+    binding.SendBufferBytes = 32 * 1024;
+    binding.IncomingCpus = { 0 };
+    CHECK_FALSE(binding.IsDefault());
+
+    Result<SocketBinding::BindAddress> bindAddress = binding.GetBindAddress(0);
+    REQUIRE_FALSE(bindAddress.IsError);
+    int socketHandle = socket(AF_INET6, SOCK_DGRAM, 0);
+    REQUIRE(socketHandle >= 0);
+    REQUIRE_FALSE(binding.Apply(socketHandle, AF_INET6, 0).IsError);
+
+    int option = 0;
+    socklen_t optionLength = sizeof(option);
+    REQUIRE(getsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, &option, &optionLength) == 0);
+    CHECK(option >= binding.ReceiveBufferBytes);
+    REQUIRE(getsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, &option, &optionLength) == 0);
+    CHECK(option >= binding.SendBufferBytes);
+    REQUIRE(getsockopt(socketHandle, IPPROTO_IPV6, IPV6_V6ONLY, &option, &optionLength) == 0);
+    CHECK(option == 0);
+    REQUIRE(getsockopt(socketHandle, SOL_SOCKET, SO_INCOMING_CPU, &option, &optionLength) == 0);
+    CHECK(option == 0);
+
+    CHECK(bind(socketHandle, reinterpret_cast<const sockaddr*>(&bindAddress.Value.Address),
+        bindAddress.Value.Length) == 0);
+    close(socketHandle);
+
+    // Traffic can't be kept to an interface that doesn't exist
+    binding.Interface = "nosuchinterface";
+    socketHandle = socket(AF_INET, SOCK_DGRAM, 0);
+    REQUIRE(socketHandle >= 0);
+    CHECK(binding.Apply(socketHandle, AF_INET).IsError);
+    close(socketHandle);
+}
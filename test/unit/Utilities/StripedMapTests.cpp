@@ -0,0 +1,118 @@
+/**
+ * @file StripedMapTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "../../../src/Utilities/StripedMap.h"
+
+namespace
+{
+    struct Counter
+    {
+        std::mutex Mutex;
+        int Value = 0;
+    };
+}
+
+TEST_CASE( "StripedMap stores records by key", "[utilities]" )
+{
+    StripedMap<uint32_t, Counter> map(4);
+    CHECK(map.Find(1) == nullptr);
+
+    std::shared_ptr<Counter> first = map.GetOrCreate(1);
+    REQUIRE(first != nullptr);
+    first->Value = 10;
+    // Looking the key up again hands back the same record
+    CHECK(map.GetOrCreate(1) == first);
+    CHECK(map.Find(1) == first);
+
+    auto replacement = std::make_shared<Counter>();
+    map.Insert(2, replacement);
+    CHECK(map.Find(2) == replacement);
+    CHECK(map.GetSize() == 2);
+    std::vector<uint32_t> keys = map.GetKeys();
+    std::sort(keys.begin(), keys.end());
+    CHECK(keys == std::vector<uint32_t> { 1, 2 });
+
+    SECTION( "records are removed" )
+    {
+        CHECK(map.Remove(1) == first);
+        CHECK(map.Remove(1) == nullptr);
+        CHECK(map.Find(1) == nullptr);
+        // Callers still holding the record can keep using it
+        CHECK(first->Value == 10);
+        CHECK(map.GetSize() == 1);
+    }
+
+    SECTION( "records are only conditionally removed if the predicate agrees" )
+    {
+        auto isUnused = [](const Counter& counter) { return (counter.Value == 0); };
+        CHECK_FALSE(map.RemoveIf(1, isUnused));
+        CHECK_FALSE(map.RemoveIf(3, isUnused));
+        CHECK(map.RemoveIf(2, isUnused));
+        CHECK(map.Find(1) == first);
+        CHECK(map.Find(2) == nullptr);
+    }
+}
+
+TEST_CASE( "StripedMap spreads pointer keys across stripes", "[utilities]" )
+{
+    // Aligned addresses share their low bits, which shouldn't all land in the same stripe
+    std::vector<std::unique_ptr<Counter>> owners;
+    StripedMap<Counter*, Counter> map(8);
+    for (int i = 0; i < 256; ++i)
+    {
+        owners.push_back(std::make_unique<Counter>());
+        map.GetOrCreate(owners.back().get());
+    }
+    CHECK(map.GetSize() == 256);
+    for (const auto& owner : owners)
+    {
+        CHECK(map.Find(owner.get()) != nullptr);
+    }
+}
+
+TEST_CASE( "StripedMap is safe to use across threads", "[utilities]" )
+{
+    StripedMap<uint32_t, Counter> map;
+    constexpr uint32_t NUM_KEYS = 100;
+    constexpr int NUM_THREADS = 4;
+    constexpr int NUM_ROUNDS = 100;
+
+    std::vector<std::future<void>> workers;
+    for (int thread = 0; thread < NUM_THREADS; ++thread)
+    {
+        workers.push_back(std::async(std::launch::async,
+            [&map]()
+            {
+                for (int round = 0; round < NUM_ROUNDS; ++round)
+                {
+                    for (uint32_t key = 0; key < NUM_KEYS; ++key)
+                    {
+                        std::shared_ptr<Counter> counter = map.GetOrCreate(key);
+                        std::lock_guard lock(counter->Mutex);
+                        ++counter->Value;
+                    }
+                }
+            }));
+    }
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    REQUIRE(map.GetSize() == NUM_KEYS);
+    for (uint32_t key = 0; key < NUM_KEYS; ++key)
+    {
+        CHECK(map.Find(key)->Value == (NUM_THREADS * NUM_ROUNDS));
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file TaskExecutorTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../../../src/Utilities/TaskExecutor.h"
+
+TEST_CASE( "TaskExecutor runs tasks on a fixed set of workers", "[utilities]" )
+{
+    std::mutex threadIdsMutex;
+    std::set<std::thread::id> threadIds;
+    std::atomic<int> numRun { 0 };
+    {
+        TaskExecutor executor(3);
+        REQUIRE(executor.GetWorkerCount() == 3);
+        for (int i = 0; i < 500; ++i)
+        {
+            executor.Submit(
+                [&]()
+                {
+                    {
+                        std::scoped_lock lock(threadIdsMutex);
+                        threadIds.insert(std::this_thread::get_id());
+                    }
+                    ++numRun;
+                });
+        }
+    }
+
+    // Destroying the executor runs whatever was still queued
+    CHECK(numRun == 500);
+    CHECK(threadIds.size() <= 3);
+    CHECK(threadIds.count(std::this_thread::get_id()) == 0);
+}
+
+TEST_CASE( "TaskExecutor waits for room when its queue is full", "[utilities]" )
+{
+    std::promise<void> unblock;
+    std::shared_future<void> unblocked = unblock.get_future().share();
+    std::atomic<int> numRun { 0 };
+    TaskExecutor executor(1, 2);
+
+    auto blockingTask = [unblocked, &numRun]()
+        {
+            unblocked.wait();
+            ++numRun;
+        };
+    // One task for the worker to block on, and two to fill the queue behind it
+    executor.Submit(blockingTask);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((executor.GetStats().QueuedTasks > 0) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    executor.Submit(blockingTask);
+    executor.Submit(blockingTask);
+    CHECK(executor.GetStats().QueuedTasks == 2);
+
+    std::future<void> overflowingSubmit = std::async(std::launch::async,
+        [&executor, blockingTask]()
+        {
+            executor.Submit(blockingTask);
+        });
+    CHECK(overflowingSubmit.wait_for(std::chrono::milliseconds(20)) ==
+        std::future_status::timeout);
+
+    unblock.set_value();
+    REQUIRE(overflowingSubmit.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    while ((numRun < 4) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(numRun == 4);
+
+    TaskExecutor::Stats stats = executor.GetStats();
+    CHECK(stats.Overflows == 1);
+    CHECK(stats.PeakQueuedTasks == 2);
+    CHECK(stats.CompletedTasks == 4);
+    CHECK(stats.MaxQueueLatency.count() > 0);
+    CHECK(stats.TotalQueueLatency >= stats.MaxQueueLatency);
+    CHECK(stats.TotalRunTime >= stats.MaxRunTime);
+}
+
+TEST_CASE( "TaskExecutor keeps running after a task throws", "[utilities]" )
+{
+    TaskExecutor executor(1);
+    std::promise<void> ran;
+    executor.Submit([]() { throw std::runtime_error("Oops"); });
+    executor.Submit([&ran]() { ran.set_value(); });
+    CHECK(ran.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+}
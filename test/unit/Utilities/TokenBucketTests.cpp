@@ -0,0 +1,39 @@
+/**
+ * @file TokenBucketTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <chrono>
+
+#include "../../../src/Utilities/TokenBucket.h"
+
+TEST_CASE( "TokenBucket allows a burst, then refills at its rate", "[utilities]" )
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::steady_clock::now();
+    TokenBucket bucket(2.0, 3.0, start);
+    CHECK(bucket.IsFull(start));
+
+    CHECK(bucket.TryConsume(start));
+    CHECK(bucket.TryConsume(start));
+    CHECK(bucket.TryConsume(start));
+    CHECK_FALSE(bucket.TryConsume(start));
+    CHECK_FALSE(bucket.IsFull(start));
+
+    // Two tokens a second, so one more after half a second
+    CHECK_FALSE(bucket.TryConsume(start + 400ms));
+    CHECK(bucket.TryConsume(start + 500ms));
+    CHECK_FALSE(bucket.TryConsume(start + 500ms));
+
+    // Never holds more than a burst's worth
+    CHECK(bucket.GetTokens(start + 1h) == Approx(3.0));
+    CHECK(bucket.IsFull(start + 1h));
+    CHECK_FALSE(bucket.TryConsume(start + 1h, 4.0));
+    CHECK(bucket.TryConsume(start + 1h, 3.0));
+
+    // Time going backwards doesn't add or take away tokens
+    CHECK(bucket.GetTokens(start) == Approx(0.0));
+}
@@ -0,0 +1,149 @@
+/**
+ * @file UnixSocketHandoffTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../../src/Utilities/UnixSocketHandoff.h"
+
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+TEST_CASE( "UnixSocketHandoff passes open handles between sockets", "[utilities]" )
+{
+    int socketHandles[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, socketHandles) == 0);
+    int pipeHandles[2];
+    REQUIRE(pipe(pipeHandles) == 0);
+
+    const std::vector<std::byte> payload { std::byte { 1 }, std::byte { 2 }, std::byte { 3 } };
+    Result<void> sendResult = UnixSocketHandoff::Send(socketHandles[0], payload,
+        std::vector<int> { pipeHandles[1] });
+    REQUIRE_FALSE(sendResult.IsError);
+    // The receiver gets its own copy, so ours can go
+    close(pipeHandles[1]);
+
+    Result<UnixSocketHandoff::Message> receiveResult =
+        UnixSocketHandoff::Receive(socketHandles[1], 1s);
+    REQUIRE_FALSE(receiveResult.IsError);
+    CHECK(receiveResult.Value.Payload == payload);
+    REQUIRE(receiveResult.Value.Handles.size() == 1);
+
+    const char written = 'x';
+    REQUIRE(write(receiveResult.Value.Handles[0], &written, 1) == 1);
+    char readByte = 0;
+    REQUIRE(read(pipeHandles[0], &readByte, 1) == 1);
+    CHECK(readByte == written);
+
+    close(receiveResult.Value.Handles[0]);
+    close(pipeHandles[0]);
+    close(socketHandles[0]);
+    close(socketHandles[1]);
+}
+
+TEST_CASE( "UnixSocketHandoff times out and notices hang ups", "[utilities]" )
+{
+    int socketHandles[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, socketHandles) == 0);
+
+    CHECK(UnixSocketHandoff::Receive(socketHandles[1], 10ms).IsError);
+    close(socketHandles[0]);
+    CHECK(UnixSocketHandoff::Receive(socketHandles[1], 1s).IsError);
+    close(socketHandles[1]);
+}
+
+TEST_CASE( "UnixSocketHandoff connects through a socket path", "[utilities]" )
+{
+    char directory[] = "/tmp/janus-ftl-handoff-XXXXXX";
+    REQUIRE(mkdtemp(directory) != nullptr);
+    const std::string path = std::string(directory) + "/handoff.sock";
+
+    Result<int> listenResult = UnixSocketHandoff::Listen(path);
+    REQUIRE_FALSE(listenResult.IsError);
+    struct stat socketStat {};
+    REQUIRE(stat(path.c_str(), &socketStat) == 0);
+    CHECK((socketStat.st_mode & 0777) == 0600);
+    Result<std::optional<int>> acceptResult = UnixSocketHandoff::Accept(listenResult.Value, 10ms);
+    REQUIRE_FALSE(acceptResult.IsError);
+    CHECK_FALSE(acceptResult.Value.has_value());
+
+    Result<int> connectResult = UnixSocketHandoff::Connect(path);
+    REQUIRE_FALSE(connectResult.IsError);
+    acceptResult = UnixSocketHandoff::Accept(listenResult.Value, 1s);
+    REQUIRE_FALSE(acceptResult.IsError);
+    REQUIRE(acceptResult.Value.has_value());
+
+    const std::vector<std::byte> payload { std::byte { 42 } };
+    REQUIRE_FALSE(UnixSocketHandoff::Send(connectResult.Value, payload).IsError);
+    Result<UnixSocketHandoff::Message> receiveResult =
+        UnixSocketHandoff::Receive(acceptResult.Value.value(), 1s);
+    REQUIRE_FALSE(receiveResult.IsError);
+    CHECK(receiveResult.Value.Payload == payload);
+    CHECK(receiveResult.Value.Handles.empty());
+
+    close(acceptResult.Value.value());
+    close(connectResult.Value);
+    close(listenResult.Value);
+    unlink(path.c_str());
+    rmdir(directory);
+}
+
+TEST_CASE( "UnixSocketHandoff turns away other users", "[utilities]" )
+{
+    if (geteuid() != 0)
+    {
+        WARN("Skipping, connecting as another user needs root");
+        return;
+    }
+    char directory[] = "/tmp/janus-ftl-handoff-XXXXXX";
+    REQUIRE(mkdtemp(directory) != nullptr);
+    const std::string path = std::string(directory) + "/handoff.sock";
+    Result<int> listenResult = UnixSocketHandoff::Listen(path);
+    REQUIRE_FALSE(listenResult.IsError);
+
+    // Even if someone opens up the socket's permissions, only our own user gets our sockets
+    REQUIRE(chmod(directory, 0755) == 0);
+    REQUIRE(chmod(path.c_str(), 0666) == 0);
+    int hangUpPipe[2];
+    REQUIRE(pipe(hangUpPipe) == 0);
+    const pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0)
+    {
+        close(hangUpPipe[1]);
+        int socketHandle = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        sockaddr_un address { .sun_family = AF_UNIX };
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        if ((setresuid(65534, 65534, 65534) != 0) ||
+            (connect(socketHandle, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) != 0))
+        {
+            _exit(1);
+        }
+        // Stay connected until the parent has had its look at us
+        char unused;
+        _exit((read(hangUpPipe[0], &unused, 1) < 0) ? 1 : 0);
+    }
+    close(hangUpPipe[0]);
+
+    Result<std::optional<int>> acceptResult = UnixSocketHandoff::Accept(listenResult.Value, 1s);
+    REQUIRE_FALSE(acceptResult.IsError);
+    CHECK_FALSE(acceptResult.Value.has_value());
+
+    close(hangUpPipe[1]);
+    int childStatus = 0;
+    REQUIRE(waitpid(child, &childStatus, 0) == child);
+    CHECK(WEXITSTATUS(childStatus) == 0);
+    close(listenResult.Value);
+    unlink(path.c_str());
+    rmdir(directory);
+}
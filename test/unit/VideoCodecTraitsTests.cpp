@@ -0,0 +1,64 @@
+/**
+ * @file VideoCodecTraitsTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+
+#include "../../src/VideoCodecTraits.h"
+
+#include <vector>
+
+TEST_CASE("VideoCodecList binds runtime codecs to their traits", "[codecs]")
+{
+    std::vector<VideoCodecKind> visited;
+    CHECK(SupportedVideoCodecList::Visit(VideoCodecKind::H264,
+        [&visited](auto codecTag) { visited.push_back(codecTag.value); }));
+    CHECK_FALSE(SupportedVideoCodecList::Visit(VideoCodecKind::Unsupported,
+        [&visited](auto codecTag) { visited.push_back(codecTag.value); }));
+    CHECK_THAT(visited, Catch::Equals(std::vector<VideoCodecKind> { VideoCodecKind::H264 }));
+
+    visited.clear();
+    SupportedVideoCodecList::ForEach(
+        [&visited](auto codecTag) { visited.push_back(codecTag.value); });
+    CHECK_THAT(visited, Catch::Equals(std::vector<VideoCodecKind> { VideoCodecKind::H264 }));
+}
+
+TEST_CASE("Keyframe payload detectors are bound to the stream's codec", "[codecs]")
+{
+    // An IDR slice, and a slice predicted from it
+    const std::vector<std::byte> idrPayload { std::byte(0x65), std::byte(0x88) };
+    const std::vector<std::byte> nonIdrPayload { std::byte(0x41), std::byte(0x9A) };
+
+    const KeyframePayloadDetector h264Detector =
+        GetKeyframePayloadDetector(VideoCodecKind::H264);
+    CHECK(h264Detector(idrPayload));
+    CHECK_FALSE(h264Detector(nonIdrPayload));
+
+    const KeyframePayloadDetector unsupportedDetector =
+        GetKeyframePayloadDetector(VideoCodecKind::Unsupported);
+    REQUIRE(unsupportedDetector != nullptr);
+    CHECK_FALSE(unsupportedDetector(idrPayload));
+}
+
+TEST_CASE("H264 traits only report SPS NAL units as parameter sets", "[codecs]")
+{
+    // A STAP-A aggregating a (truncated) SPS and a PPS
+    const std::vector<std::byte> stapA
+    {
+        std::byte(0x18),
+        std::byte(0x00), std::byte(0x02), std::byte(0x67), std::byte(0x42),
+        std::byte(0x00), std::byte(0x02), std::byte(0x68), std::byte(0xCE),
+    };
+    std::vector<std::vector<std::byte>> parameterSets;
+    VideoCodecTraits<VideoCodecKind::H264>::ForEachParameterSet(stapA,
+        [&parameterSets](std::span<const std::byte> parameterSet)
+        {
+            parameterSets.emplace_back(parameterSet.begin(), parameterSet.end());
+        });
+    REQUIRE(parameterSets.size() == 1);
+    CHECK(parameterSets[0] == std::vector<std::byte> { std::byte(0x67), std::byte(0x42) });
+    CHECK(VideoCodecTraits<VideoCodecKind::H264>::ParseParameterSet(parameterSets[0]).IsError);
+}
@@ -0,0 +1,307 @@
+/**
+ * @file H264SpsParserTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <catch2/catch.hpp>
+#include <vector>
+
+#include "../../../src/VideoDecoders/H264SpsParser.h"
+
+namespace
+{
+    /**
+     * @brief Builds up an SPS NAL unit bit by bit, inserting emulation prevention bytes
+     */
+    class SpsWriter
+    {
+    public:
+        void Bits(uint32_t value, uint8_t count)
+        {
+            for (int i = count - 1; i >= 0; --i)
+            {
+                bits.push_back((value >> i) & 0b1);
+            }
+        }
+
+        void Ue(uint32_t value)
+        {
+            uint32_t codeNum = value + 1;
+            uint8_t length = 0;
+            while ((codeNum >> length) > 1)
+            {
+                ++length;
+            }
+            Bits(0, length);
+            Bits(codeNum, length + 1);
+        }
+
+        std::vector<std::byte> Finish()
+        {
+            // rbsp_trailing_bits
+            bits.push_back(1);
+            while ((bits.size() % 8) != 0)
+            {
+                bits.push_back(0);
+            }
+
+            std::vector<std::byte> nalUnit { std::byte(0x67) };
+            size_t zeroCount = 0;
+            for (size_t i = 0; i < bits.size(); i += 8)
+            {
+                uint8_t byte = 0;
+                for (size_t bit = 0; bit < 8; ++bit)
+                {
+                    byte = (byte << 1) | bits[i + bit];
+                }
+                if ((zeroCount >= 2) && (byte <= 0x03))
+                {
+                    nalUnit.push_back(std::byte(0x03));
+                    zeroCount = 0;
+                }
+                zeroCount = (byte == 0x00) ? (zeroCount + 1) : 0;
+                nalUnit.push_back(std::byte(byte));
+            }
+            return nalUnit;
+        }
+
+    private:
+        std::vector<uint8_t> bits;
+    };
+
+    struct SpsFields
+    {
+        uint8_t ProfileIdc = 66;
+        uint8_t LevelIdc = 31;
+        uint32_t ChromaFormatIdc = 1;
+        bool ScalingMatrix = false;
+        uint32_t PicOrderCntType = 0;
+        uint32_t WidthInMbs = 80;
+        uint32_t HeightInMapUnits = 45;
+        bool FrameMbsOnly = true;
+        uint32_t CropLeft = 0;
+        uint32_t CropRight = 0;
+        uint32_t CropBottom = 0;
+        uint32_t NumUnitsInTick = 0;
+        uint32_t TimeScale = 0;
+    };
+
+    std::vector<std::byte> makeSps(const SpsFields& fields)
+    {
+        SpsWriter writer;
+        writer.Bits(fields.ProfileIdc, 8);
+        writer.Bits(0, 8);
+        writer.Bits(fields.LevelIdc, 8);
+        writer.Ue(0); // seq_parameter_set_id
+        if (fields.ProfileIdc == 100)
+        {
+            writer.Ue(fields.ChromaFormatIdc);
+            if (fields.ChromaFormatIdc == 3)
+            {
+                writer.Bits(0, 1);
+            }
+            writer.Ue(0);
+            writer.Ue(0);
+            writer.Bits(0, 1);
+            writer.Bits(fields.ScalingMatrix, 1);
+            if (fields.ScalingMatrix)
+            {
+                // One 4x4 list present, where every delta is +1
+                writer.Bits(1, 1);
+                for (int i = 0; i < 16; ++i)
+                {
+                    writer.Ue(1);
+                }
+                writer.Bits(0, 7);
+            }
+        }
+        writer.Ue(0); // log2_max_frame_num_minus4
+        writer.Ue(fields.PicOrderCntType);
+        if (fields.PicOrderCntType == 0)
+        {
+            writer.Ue(2);
+        }
+        else if (fields.PicOrderCntType == 1)
+        {
+            writer.Bits(0, 1);
+            writer.Ue(4); // offset_for_non_ref_pic, se(v) -2
+            writer.Ue(0);
+            writer.Ue(2);
+            writer.Ue(1);
+            writer.Ue(2);
+        }
+        writer.Ue(4); // max_num_ref_frames
+        writer.Bits(0, 1);
+        writer.Ue(fields.WidthInMbs - 1);
+        writer.Ue(fields.HeightInMapUnits - 1);
+        writer.Bits(fields.FrameMbsOnly, 1);
+        if (!fields.FrameMbsOnly)
+        {
+            writer.Bits(1, 1);
+        }
+        writer.Bits(1, 1); // direct_8x8_inference_flag
+        bool isCropped = ((fields.CropLeft > 0) || (fields.CropRight > 0) ||
+            (fields.CropBottom > 0));
+        writer.Bits(isCropped, 1);
+        if (isCropped)
+        {
+            writer.Ue(fields.CropLeft);
+            writer.Ue(fields.CropRight);
+            writer.Ue(0);
+            writer.Ue(fields.CropBottom);
+        }
+        bool hasVui = (fields.TimeScale > 0);
+        writer.Bits(hasVui, 1);
+        if (hasVui)
+        {
+            writer.Bits(1, 1); // aspect_ratio_info_present_flag
+            writer.Bits(255, 8);
+            writer.Bits(1, 16);
+            writer.Bits(1, 16);
+            writer.Bits(0, 1);
+            writer.Bits(1, 1); // video_signal_type_present_flag
+            writer.Bits(5, 3);
+            writer.Bits(0, 1);
+            writer.Bits(1, 1);
+            writer.Bits(0x010101, 24);
+            writer.Bits(0, 1);
+            writer.Bits(1, 1); // timing_info_present_flag
+            writer.Bits(fields.NumUnitsInTick, 32);
+            writer.Bits(fields.TimeScale, 32);
+            writer.Bits(1, 1);
+            writer.Bits(0, 5); // remaining VUI flags
+        }
+        return writer.Finish();
+    }
+}
+
+TEST_CASE( "H264SpsParser reads uncropped baseline dimensions", "[videodecoders]" )
+{
+    Result<VideoParameters> result = H264SpsParser::Parse(makeSps({}));
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value.Width == 1280);
+    CHECK(result.Value.Height == 720);
+    CHECK(result.Value.ProfileIdc == 66);
+    CHECK(result.Value.LevelIdc == 31);
+    CHECK_FALSE(result.Value.FrameRate.has_value());
+}
+
+TEST_CASE( "H264SpsParser applies frame cropping", "[videodecoders]" )
+{
+    SpsFields fields
+    {
+        .ProfileIdc = 100,
+        .LevelIdc = 42,
+        .ScalingMatrix = GENERATE(false, true),
+        .PicOrderCntType = GENERATE(0u, 1u, 2u),
+        .WidthInMbs = 120,
+        .HeightInMapUnits = 68,
+        .CropBottom = 4,
+        .NumUnitsInTick = 1,
+        .TimeScale = 120,
+    };
+    Result<VideoParameters> result = H264SpsParser::Parse(makeSps(fields));
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value.Width == 1920);
+    CHECK(result.Value.Height == 1080);
+    CHECK(result.Value.ProfileIdc == 100);
+    CHECK(result.Value.LevelIdc == 42);
+    REQUIRE(result.Value.FrameRate.has_value());
+    CHECK(result.Value.FrameRate.value() == Approx(60.0));
+}
+
+TEST_CASE( "H264SpsParser handles interlaced and 4:4:4 video", "[videodecoders]" )
+{
+    SECTION( "field coded video counts map units in field pairs" )
+    {
+        Result<VideoParameters> result = H264SpsParser::Parse(makeSps({
+            .WidthInMbs = 120,
+            .HeightInMapUnits = 34,
+            .FrameMbsOnly = false,
+            .CropBottom = 2,
+        }));
+        REQUIRE_FALSE(result.IsError);
+        CHECK(result.Value.Width == 1920);
+        CHECK(result.Value.Height == 1080);
+    }
+
+    SECTION( "4:4:4 crops in whole luma samples" )
+    {
+        Result<VideoParameters> result = H264SpsParser::Parse(makeSps({
+            .ProfileIdc = 100,
+            .ChromaFormatIdc = 3,
+            .WidthInMbs = 2,
+            .HeightInMapUnits = 2,
+            .CropRight = 2,
+            .CropBottom = 6,
+        }));
+        REQUIRE_FALSE(result.IsError);
+        CHECK(result.Value.Width == 30);
+        CHECK(result.Value.Height == 26);
+    }
+}
+
+TEST_CASE( "H264SpsParser rejects malformed input", "[videodecoders]" )
+{
+    std::vector<std::byte> sps = makeSps({});
+
+    SECTION( "truncated SPS" )
+    {
+        sps.resize(5);
+        CHECK(H264SpsParser::Parse(sps).IsError);
+    }
+
+    SECTION( "wrong NAL type" )
+    {
+        sps[0] = std::byte(0x68);
+        CHECK(H264SpsParser::Parse(sps).IsError);
+    }
+
+    SECTION( "cropping larger than the frame" )
+    {
+        CHECK(H264SpsParser::Parse(makeSps({ .WidthInMbs = 1, .CropRight = 8 })).IsError);
+    }
+
+    SECTION( "sizes that only look valid once wrapped to 32 bits" )
+    {
+        CHECK(H264SpsParser::Parse(makeSps({ .WidthInMbs = (1u << 28) + 80 })).IsError);
+        CHECK(H264SpsParser::Parse(makeSps({ .HeightInMapUnits = (1u << 28) + 45 })).IsError);
+        CHECK(H264SpsParser::Parse(
+            makeSps({ .CropLeft = (1u << 31), .CropRight = (1u << 31) })).IsError);
+    }
+}
+
+TEST_CASE( "H264SpsParser finds the SPS among keyframe packets", "[videodecoders]" )
+{
+    constexpr size_t RTP_HEADER_SIZE = 12;
+    auto makePacket = [](const std::vector<std::byte>& payload)
+    {
+        std::vector<std::byte> bytes(RTP_HEADER_SIZE);
+        bytes[0] = std::byte(0x80);
+        bytes[1] = std::byte(96);
+        bytes.insert(bytes.end(), payload.begin(), payload.end());
+        return PacketBuffer::Copy(bytes);
+    };
+
+    std::list<PacketBuffer> packets;
+    packets.push_back(makePacket({ std::byte(0x68), std::byte(0xCE), std::byte(0x38) }));
+    CHECK(H264SpsParser::ParseFromRtpPackets(packets).IsError);
+
+    packets.push_back(makePacket(makeSps({})));
+    Result<VideoParameters> result = H264SpsParser::ParseFromRtpPackets(packets);
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value.Width == 1280);
+
+    // Aggregated with the PPS in a STAP-A
+    std::vector<std::byte> sps = makeSps({ .WidthInMbs = 40, .HeightInMapUnits = 30 });
+    std::vector<std::byte> stapA { std::byte(0x78), std::byte(sps.size() >> 8),
+        std::byte(sps.size() & 0xFF) };
+    stapA.insert(stapA.end(), sps.begin(), sps.end());
+    stapA.insert(stapA.end(), { std::byte(0x00), std::byte(0x01), std::byte(0x68) });
+    result = H264SpsParser::ParseFromRtpPackets({ makePacket(stapA) });
+    REQUIRE_FALSE(result.IsError);
+    CHECK(result.Value.Width == 640);
+    CHECK(result.Value.Height == 480);
+}
@@ -0,0 +1,199 @@
+/**
+ * @file ThumbnailWorkerPoolTests.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "../../../src/VideoDecoders/ThumbnailWorkerPool.h"
+
+namespace
+{
+    struct FakeDecoderState
+    {
+        std::atomic<uint32_t> DimensionReads { 0 };
+        std::atomic<uint32_t> JpegsGenerated { 0 };
+        // Decoding blocks until this is ready
+        std::shared_future<void> Unblocked;
+    };
+
+    /**
+     * @brief Reports the number of keyframe packets as the frame width
+     */
+    class FakeVideoDecoder : public VideoDecoder
+    {
+    public:
+        FakeVideoDecoder(std::shared_ptr<FakeDecoderState> state) : state(state)
+        { }
+
+        DecodedKeyframe DecodeKeyframe(const std::list<PacketBuffer>& keyframePackets) override
+        {
+            state->Unblocked.wait();
+            throwIfEmpty(keyframePackets);
+            ++state->JpegsGenerated;
+            return DecodedKeyframe
+            {
+                .Width = static_cast<uint16_t>(keyframePackets.size()),
+                .Height = 1,
+                .JpegBytes = { 0xFF, 0xD8 },
+            };
+        }
+
+        std::pair<uint16_t, uint16_t> ReadVideoDimensions(
+            const std::list<PacketBuffer>& keyframePackets) override
+        {
+            state->Unblocked.wait();
+            throwIfEmpty(keyframePackets);
+            ++state->DimensionReads;
+            return std::make_pair(static_cast<uint16_t>(keyframePackets.size()), 1);
+        }
+
+        std::vector<uint8_t> GenerateJpegImage(const std::list<PacketBuffer>&) override
+        {
+            return {};
+        }
+
+    private:
+        std::shared_ptr<FakeDecoderState> state;
+
+        static void throwIfEmpty(const std::list<PacketBuffer>& keyframePackets)
+        {
+            if (keyframePackets.empty())
+            {
+                throw PreviewGenerationFailedException("Empty keyframe");
+            }
+        }
+    };
+
+    std::shared_ptr<const FtlKeyframe> makeKeyframe(uint64_t generation, size_t numPackets)
+    {
+        auto keyframe = std::make_shared<FtlKeyframe>();
+        keyframe->Codec = VideoCodecKind::H264;
+        keyframe->Generation = generation;
+        for (size_t i = 0; i < numPackets; ++i)
+        {
+            keyframe->Packets.push_back(PacketBufferPool::Default().Acquire());
+        }
+        return keyframe;
+    }
+
+    std::vector<ThumbnailWorkerPool::JobResult> waitForResults(ThumbnailWorkerPool& pool,
+        size_t count)
+    {
+        std::vector<ThumbnailWorkerPool::JobResult> results;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while ((results.size() < count) && (std::chrono::steady_clock::now() < deadline))
+        {
+            for (auto& result : pool.CollectResults())
+            {
+                results.push_back(std::move(result));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return results;
+    }
+}
+
+TEST_CASE( "ThumbnailWorkerPool decodes keyframes for each stream", "[videodecoders]" )
+{
+    auto state = std::make_shared<FakeDecoderState>();
+    std::promise<void> unblock;
+    state->Unblocked = unblock.get_future().share();
+    unblock.set_value();
+
+    ThumbnailWorkerPool pool(
+        {
+            { VideoCodecKind::H264,
+                [state]() { return std::make_unique<FakeVideoDecoder>(state); } },
+        },
+        2);
+    REQUIRE(pool.GetWorkerCount() == 2);
+    CHECK(pool.IsCodecSupported(VideoCodecKind::H264));
+    CHECK_FALSE(pool.IsCodecSupported(VideoCodecKind::Unsupported));
+
+    REQUIRE(pool.Enqueue({ .ChannelId = 1, .StreamId = 10, .Keyframe = makeKeyframe(1, 3),
+        .GenerateJpeg = true }));
+    REQUIRE(pool.Enqueue({ .ChannelId = 2, .StreamId = 20, .Keyframe = makeKeyframe(4, 5) }));
+    REQUIRE(pool.Enqueue({ .ChannelId = 3, .StreamId = 30, .Keyframe = makeKeyframe(7, 0) }));
+
+    std::vector<ThumbnailWorkerPool::JobResult> results = waitForResults(pool, 3);
+    REQUIRE(results.size() == 3);
+    std::sort(results.begin(), results.end(),
+        [](const auto& a, const auto& b) { return (a.StreamId < b.StreamId); });
+
+    CHECK(results[0].ChannelId == 1);
+    CHECK(results[0].IsSuccess);
+    CHECK(results[0].KeyframeGeneration == 1);
+    CHECK(results[0].VideoWidth == 3);
+    CHECK(results[0].JpegBytes.size() == 2);
+
+    CHECK(results[1].IsSuccess);
+    CHECK(results[1].KeyframeGeneration == 4);
+    CHECK(results[1].VideoWidth == 5);
+    CHECK(results[1].JpegBytes.empty());
+
+    CHECK_FALSE(results[2].IsSuccess);
+    CHECK_FALSE(results[2].ErrorMessage.empty());
+
+    CHECK(state->JpegsGenerated == 1);
+    CHECK(state->DimensionReads == 1);
+}
+
+TEST_CASE( "ThumbnailWorkerPool coalesces pending jobs for a stream", "[videodecoders]" )
+{
+    auto state = std::make_shared<FakeDecoderState>();
+    std::promise<void> unblock;
+    state->Unblocked = unblock.get_future().share();
+
+    ThumbnailWorkerPool pool(
+        {
+            { VideoCodecKind::H264,
+                [state]() { return std::make_unique<FakeVideoDecoder>(state); } },
+        },
+        2);
+
+    // The first job is picked up and blocks, the rest pile up behind it
+    REQUIRE(pool.Enqueue({ .StreamId = 10, .Keyframe = makeKeyframe(1, 1) }));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((pool.GetPendingJobCount() > 0) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(pool.GetPendingJobCount() == 0);
+
+    REQUIRE(pool.Enqueue({ .StreamId = 10, .Keyframe = makeKeyframe(2, 2),
+        .GenerateJpeg = true }));
+    REQUIRE(pool.Enqueue({ .StreamId = 10, .Keyframe = makeKeyframe(3, 3) }));
+    // The idle worker must not pick up the stream that is already being decoded
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(pool.GetPendingJobCount() == 1);
+
+    unblock.set_value();
+    std::vector<ThumbnailWorkerPool::JobResult> results = waitForResults(pool, 2);
+    REQUIRE(results.size() == 2);
+    CHECK(results[0].KeyframeGeneration == 1);
+    CHECK(results[0].JpegBytes.empty());
+    // Newest keyframe wins, and the earlier request for a preview is kept
+    CHECK(results[1].KeyframeGeneration == 3);
+    CHECK(results[1].VideoWidth == 3);
+    CHECK(results[1].JpegBytes.size() == 2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(pool.CollectResults().empty());
+}
+
+TEST_CASE( "ThumbnailWorkerPool rejects jobs it cannot decode", "[videodecoders]" )
+{
+    ThumbnailWorkerPool pool({}, 1);
+
+    CHECK_FALSE(pool.Enqueue({ .StreamId = 10, .Keyframe = makeKeyframe(1, 1) }));
+    CHECK_FALSE(pool.Enqueue({ .StreamId = 10, .Keyframe = nullptr }));
+    CHECK(pool.GetPendingJobCount() == 0);
+}
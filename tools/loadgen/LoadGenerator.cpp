@@ -0,0 +1,214 @@
+/**
+ * @file LoadGenerator.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "LoadGenerator.h"
+
+#include <algorithm>
+
+namespace
+{
+    std::chrono::microseconds percentile(
+        const std::vector<std::chrono::microseconds>& sortedValues, double fraction)
+    {
+        const size_t index = static_cast<size_t>(fraction * (sortedValues.size() - 1));
+        return sortedValues.at(index);
+    }
+
+    double toMilliseconds(std::chrono::microseconds value)
+    {
+        return std::chrono::duration<double, std::milli>(value).count();
+    }
+}
+
+#pragma region Constructor/Destructor
+LoadGenerator::LoadGenerator(Options options) :
+    options(std::move(options)),
+    tickThreadCount(std::max<uint32_t>(1, this->options.ThreadCount))
+{
+    streams.reserve(this->options.StreamCount);
+    for (uint32_t i = 0; i < this->options.StreamCount; ++i)
+    {
+        SyntheticStream::Options streamOptions = this->options.Stream;
+        streamOptions.ChannelId = this->options.FirstChannelId + i;
+        // Every stream gets its own (repeatable) impairments
+        streamOptions.RandomSeed = this->options.Stream.RandomSeed + i;
+        streams.push_back(std::make_unique<SyntheticStream>(std::move(streamOptions)));
+    }
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    // Stop generating packets before the streams go away
+    tickThreads.clear();
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void LoadGenerator::Run(const std::atomic<bool>& isStopRequested)
+{
+    for (size_t i = 0; i < tickThreadCount; ++i)
+    {
+        tickThreads.emplace_back(
+            [this, i](std::stop_token stopToken)
+            {
+                tickThreadBody(stopToken, i);
+            });
+    }
+
+    spdlog::info("Starting {} streams to {}, channels {} through {}...", streams.size(),
+        options.Stream.TargetHostname, options.FirstChannelId,
+        (options.FirstChannelId + streams.size() - 1));
+    const auto startTime = std::chrono::steady_clock::now();
+    auto lastReportTime = startTime;
+    auto nextReportTime = startTime + options.ReportInterval;
+    std::optional<std::chrono::steady_clock::time_point> endTime;
+    Totals previousTotals;
+    while (!isStopRequested.load())
+    {
+        const auto now = std::chrono::steady_clock::now();
+        if (startedStreamCount.load(std::memory_order_relaxed) < streams.size())
+        {
+            const size_t streamIndex = startedStreamCount.load(std::memory_order_relaxed);
+            streams.at(streamIndex)->Start();
+            startedStreamCount.store((streamIndex + 1), std::memory_order_release);
+            if ((streamIndex + 1) == streams.size())
+            {
+                spdlog::info("All streams started");
+                if (options.Duration.count() > 0)
+                {
+                    endTime = now + options.Duration;
+                }
+            }
+        }
+
+        if (now >= nextReportTime)
+        {
+            Totals totals = collectTotals();
+            report(totals, previousTotals, (now - lastReportTime));
+            previousTotals = std::move(totals);
+            lastReportTime = now;
+            nextReportTime += options.ReportInterval;
+        }
+
+        if (endTime.has_value() && (now >= endTime.value()))
+        {
+            break;
+        }
+
+        const bool isRamping =
+            (startedStreamCount.load(std::memory_order_relaxed) < streams.size());
+        std::this_thread::sleep_for(
+            isRamping ? options.RampInterval : std::chrono::milliseconds(100));
+    }
+
+    spdlog::info("Stopping...");
+    tickThreads.clear();
+    const auto now = std::chrono::steady_clock::now();
+    spdlog::info("Final totals over {}s:",
+        std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count());
+    report(collectTotals(), Totals(), (now - startTime));
+    for (const std::unique_ptr<SyntheticStream>& stream : streams)
+    {
+        stream->Stop();
+    }
+}
+#pragma endregion Public methods
+
+#pragma region Private methods
+void LoadGenerator::tickThreadBody(std::stop_token stopToken, size_t threadIndex)
+{
+    auto nextTickTime = std::chrono::steady_clock::now();
+    while (!stopToken.stop_requested())
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const size_t startedCount = startedStreamCount.load(std::memory_order_acquire);
+        for (size_t i = threadIndex; i < startedCount; i += tickThreadCount)
+        {
+            streams[i]->Tick(now);
+        }
+
+        // If we fall behind, catch up on the next tick rather than spinning
+        nextTickTime = std::max((nextTickTime + TICK_INTERVAL), now);
+        std::this_thread::sleep_until(nextTickTime);
+    }
+}
+
+LoadGenerator::Totals LoadGenerator::collectTotals()
+{
+    Totals totals;
+    const size_t startedCount = startedStreamCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < startedCount; ++i)
+    {
+        const SyntheticStream::Stats stats = streams[i]->GetStats();
+        if (stats.IsConnected && stats.IsClosed)
+        {
+            ++totals.Closed;
+        }
+        else if (stats.IsConnected)
+        {
+            ++totals.Connected;
+        }
+        else if (stats.IsClosed)
+        {
+            ++totals.Failed;
+        }
+        else
+        {
+            ++totals.Connecting;
+        }
+        if (stats.AcceptanceLatency.has_value())
+        {
+            totals.AcceptanceLatencies.push_back(stats.AcceptanceLatency.value());
+        }
+        totals.PacketsGenerated += stats.PacketsGenerated;
+        totals.BytesGenerated += stats.BytesGenerated;
+        totals.PacketsDropped += stats.PacketsDropped;
+        totals.NacksReceived += stats.NacksReceived;
+        totals.PacketsRetransmitted += stats.PacketsRetransmitted;
+        totals.RetransmitsMissed += stats.RetransmitsMissed;
+        totals.PacketsSent += stats.PacketsSent;
+        totals.PacketsSendQueueDropped += stats.PacketsSendQueueDropped;
+    }
+    std::sort(totals.AcceptanceLatencies.begin(), totals.AcceptanceLatencies.end());
+    return totals;
+}
+
+void LoadGenerator::report(const Totals& totals, const Totals& previousTotals,
+    std::chrono::steady_clock::duration elapsed)
+{
+    const double elapsedSeconds = std::chrono::duration<double>(elapsed).count();
+    if (elapsedSeconds <= 0)
+    {
+        return;
+    }
+
+    spdlog::info("Streams: {} connected, {} connecting, {} failed to connect, {} closed by "
+        "the server", totals.Connected, totals.Connecting, totals.Failed, totals.Closed);
+    if (!totals.AcceptanceLatencies.empty())
+    {
+        const std::vector<std::chrono::microseconds>& latencies = totals.AcceptanceLatencies;
+        spdlog::info("Acceptance latency: min {:.1f}ms, p50 {:.1f}ms, p95 {:.1f}ms, "
+            "p99 {:.1f}ms, max {:.1f}ms",
+            toMilliseconds(latencies.front()), toMilliseconds(percentile(latencies, 0.5)),
+            toMilliseconds(percentile(latencies, 0.95)),
+            toMilliseconds(percentile(latencies, 0.99)), toMilliseconds(latencies.back()));
+    }
+    const uint64_t bytes = totals.BytesGenerated - previousTotals.BytesGenerated;
+    const uint64_t packets = totals.PacketsGenerated - previousTotals.PacketsGenerated;
+    const uint64_t packetsSent = totals.PacketsSent - previousTotals.PacketsSent;
+    spdlog::info("Throughput: {:.2f} Mbps, {:.0f} packets/s generated, {:.0f} packets/s sent",
+        ((bytes * 8) / elapsedSeconds / 1'000'000), (packets / elapsedSeconds),
+        (packetsSent / elapsedSeconds));
+    spdlog::info("Loss: {} packets dropped on purpose, {} dropped by full send queues; "
+        "{} NACKs received, {} packets retransmitted, {} too old to retransmit",
+        (totals.PacketsDropped - previousTotals.PacketsDropped),
+        (totals.PacketsSendQueueDropped - previousTotals.PacketsSendQueueDropped),
+        (totals.NacksReceived - previousTotals.NacksReceived),
+        (totals.PacketsRetransmitted - previousTotals.PacketsRetransmitted),
+        (totals.RetransmitsMissed - previousTotals.RetransmitsMissed));
+}
+#pragma endregion Private methods
@@ -0,0 +1,90 @@
+/**
+ * @file LoadGenerator.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "SyntheticStream.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ *  Drives many synthetic streams at an FTL ingest server at once, and reports how the server
+ *  keeps up. Streams are started one after another, and share a small pool of threads that
+ *  generate their packets.
+ */
+class LoadGenerator
+{
+public:
+    /* Public types */
+    struct Options
+    {
+        uint32_t StreamCount = 1;
+        // Streams get consecutive channel IDs starting from this one
+        ftl_channel_id_t FirstChannelId = 1;
+        // Used for every stream, save for its channel ID and random seed
+        SyntheticStream::Options Stream;
+        uint32_t ThreadCount = 1;
+        // Time between starting each stream, so the server isn't hit by every handshake at once
+        std::chrono::milliseconds RampInterval { 50 };
+        // How long to run once every stream has been started, or zero to run until stopped
+        std::chrono::seconds Duration { 0 };
+        std::chrono::seconds ReportInterval { 5 };
+    };
+
+    /* Constants */
+    // How often each thread generates whatever packets have come due
+    static constexpr std::chrono::milliseconds TICK_INTERVAL { 1 };
+
+    /* Constructor/Destructor */
+    LoadGenerator(Options options);
+    ~LoadGenerator();
+
+    /* Public methods */
+    /**
+     * @brief Runs until the configured duration has passed, or a stop has been requested
+     */
+    void Run(const std::atomic<bool>& isStopRequested);
+
+private:
+    /* Private types */
+    struct Totals
+    {
+        uint32_t Connecting = 0;
+        uint32_t Connected = 0;
+        uint32_t Failed = 0;
+        uint32_t Closed = 0;
+        std::vector<std::chrono::microseconds> AcceptanceLatencies;
+        uint64_t PacketsGenerated = 0;
+        uint64_t BytesGenerated = 0;
+        uint64_t PacketsDropped = 0;
+        uint64_t NacksReceived = 0;
+        uint64_t PacketsRetransmitted = 0;
+        uint64_t RetransmitsMissed = 0;
+        uint64_t PacketsSent = 0;
+        uint64_t PacketsSendQueueDropped = 0;
+    };
+
+    /* Private fields */
+    const Options options;
+    const uint32_t tickThreadCount;
+    std::vector<std::unique_ptr<SyntheticStream>> streams;
+    // Streams before this index have been started, and may be ticked
+    std::atomic<size_t> startedStreamCount { 0 };
+    std::vector<std::jthread> tickThreads;
+
+    /* Private methods */
+    void tickThreadBody(std::stop_token stopToken, size_t threadIndex);
+    Totals collectTotals();
+    void report(const Totals& totals, const Totals& previousTotals,
+        std::chrono::steady_clock::duration elapsed);
+};
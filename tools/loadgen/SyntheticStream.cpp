@@ -0,0 +1,405 @@
+/**
+ * @file SyntheticStream.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "SyntheticStream.h"
+
+#include "../../src/Rtp/H264Rtp.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t VIDEO_CLOCK_RATE = 90000;
+    constexpr uint32_t AUDIO_CLOCK_RATE = 48000;
+    constexpr size_t RTP_HEADER_SIZE = 12;
+    constexpr size_t RTCP_FEEDBACK_HEADER_SIZE = 12;
+    constexpr size_t RTCP_NACK_FCI_SIZE = 4;
+    // FU-A puts a FU indicator and FU header in front of each fragment
+    constexpr size_t FU_A_HEADER_SIZE = 2;
+    constexpr uint8_t NAL_REF_IDC_HIGHEST = (0x3 << 5);
+    constexpr uint8_t FU_A_START_BIT = 0x80;
+    constexpr uint8_t FU_A_END_BIT = 0x40;
+    constexpr uint8_t NAL_TYPE_NON_IDR_SLICE = 1;
+
+    uint16_t readUint16(std::span<const std::byte> bytes, size_t offset)
+    {
+        return (static_cast<uint16_t>(bytes[offset]) << 8) |
+            static_cast<uint16_t>(bytes[offset + 1]);
+    }
+
+    uint32_t readUint32(std::span<const std::byte> bytes, size_t offset)
+    {
+        return (static_cast<uint32_t>(readUint16(bytes, offset)) << 16) |
+            static_cast<uint32_t>(readUint16(bytes, offset + 2));
+    }
+
+    void writeUint16(std::byte* bytes, uint16_t value)
+    {
+        bytes[0] = std::byte(value >> 8);
+        bytes[1] = std::byte(value & 0xFF);
+    }
+
+    void writeUint32(std::byte* bytes, uint32_t value)
+    {
+        writeUint16(bytes, static_cast<uint16_t>(value >> 16));
+        writeUint16(bytes + 2, static_cast<uint16_t>(value & 0xFFFF));
+    }
+}
+
+#pragma region Constructor/Destructor
+SyntheticStream::SyntheticStream(Options options) :
+    options(std::move(options)),
+    // FTL clients use the channel ID for audio, and the next SSRC up for video
+    videoSsrc(this->options.ChannelId + 1),
+    audioSsrc(this->options.ChannelId),
+    client(std::make_unique<FtlClient>(this->options.TargetHostname, this->options.ChannelId,
+        this->options.StreamKey)),
+    random(this->options.RandomSeed)
+{
+    client->SetOnMediaBytesReceived(
+        [this](const std::span<const std::byte>& bytes)
+        {
+            onMediaBytesReceived(bytes);
+        });
+}
+
+SyntheticStream::~SyntheticStream()
+{
+    // Make sure the connection thread is done calling back into us before we go away
+    Stop();
+}
+#pragma endregion Constructor/Destructor
+
+#pragma region Public methods
+void SyntheticStream::Start()
+{
+    connectStartTime = std::chrono::steady_clock::now();
+    connectedFuture = client->ConnectAsync(FtlClient::ConnectMetadata
+        {
+            .VendorName = "janus-ftl-loadgen",
+            .VendorVersion = "0.0.0",
+            .HasVideo = true,
+            .VideoCodec = "H264",
+            .VideoHeight = 1080,
+            .VideoWidth = 1920,
+            .VideoPayloadType = VIDEO_PAYLOAD_TYPE,
+            .VideoIngestSsrc = videoSsrc,
+            .HasAudio = true,
+            .AudioCodec = "OPUS",
+            .AudioPayloadType = AUDIO_PAYLOAD_TYPE,
+            .AudioIngestSsrc = audioSsrc,
+        });
+}
+
+void SyntheticStream::Tick(std::chrono::steady_clock::time_point now)
+{
+    checkConnected(now);
+    if (!isConnected.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    while (videoFrameTime(videoFrameCount) <= now)
+    {
+        generateVideoFrame(videoFrameTime(videoFrameCount));
+        ++videoFrameCount;
+    }
+    while (audioFrameTime(audioFrameCount) <= now)
+    {
+        generateAudioFrame(audioFrameTime(audioFrameCount));
+        ++audioFrameCount;
+    }
+    while (!delayedFrames.empty() && (delayedFrames.begin()->first <= now))
+    {
+        sendPackets(delayedFrames.begin()->second);
+        delayedFrames.erase(delayedFrames.begin());
+    }
+}
+
+void SyntheticStream::Stop()
+{
+    client->Stop();
+}
+#pragma endregion Public methods
+
+#pragma region Getters/Setters
+SyntheticStream::Stats SyntheticStream::GetStats()
+{
+    const bool connected = isConnected.load(std::memory_order_acquire);
+    const DatagramSendQueue::Stats sendStats = client->GetRelayStats();
+    return Stats {
+        .IsConnected = connected,
+        .IsClosed = client->IsClosed(),
+        .AcceptanceLatency = connected ?
+            std::optional(std::chrono::microseconds(
+                acceptanceLatencyMicroseconds.load(std::memory_order_relaxed))) :
+            std::nullopt,
+        .PacketsGenerated = packetsGenerated.load(std::memory_order_relaxed),
+        .BytesGenerated = bytesGenerated.load(std::memory_order_relaxed),
+        .PacketsDropped = packetsDropped.load(std::memory_order_relaxed),
+        .NacksReceived = nacksReceived.load(std::memory_order_relaxed),
+        .PacketsRetransmitted = packetsRetransmitted.load(std::memory_order_relaxed),
+        .RetransmitsMissed = retransmitsMissed.load(std::memory_order_relaxed),
+        .PacketsSent = sendStats.SentPackets,
+        .PacketsSendQueueDropped = sendStats.DroppedPackets,
+    };
+}
+
+ftl_channel_id_t SyntheticStream::GetChannelId() const
+{
+    return options.ChannelId;
+}
+#pragma endregion Getters/Setters
+
+#pragma region Private methods
+void SyntheticStream::checkConnected(std::chrono::steady_clock::time_point now)
+{
+    if (isConnected.load(std::memory_order_relaxed) || !connectedFuture.valid() ||
+        (connectedFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
+    {
+        return;
+    }
+
+    // The client has already logged why, if we couldn't connect
+    if (connectedFuture.get().IsError)
+    {
+        return;
+    }
+
+    // Only as precise as our ticks, which is plenty next to a network round trip or three
+    acceptanceLatencyMicroseconds.store(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - connectStartTime).count(),
+        std::memory_order_relaxed);
+    mediaStartTime = now;
+    isConnected.store(true, std::memory_order_release);
+}
+
+std::chrono::steady_clock::time_point SyntheticStream::videoFrameTime(
+    uint64_t frameNumber) const
+{
+    return mediaStartTime +
+        std::chrono::nanoseconds((frameNumber * 1'000'000'000) / options.FramesPerSecond);
+}
+
+std::chrono::steady_clock::time_point SyntheticStream::audioFrameTime(
+    uint64_t frameNumber) const
+{
+    return mediaStartTime + (frameNumber * AUDIO_FRAME_INTERVAL);
+}
+
+void SyntheticStream::generateVideoFrame(std::chrono::steady_clock::time_point frameTime)
+{
+    // Size frames so the stream averages out to the configured bitrate, keyframes included
+    const uint64_t framesPerKeyframe = std::max<uint64_t>(1,
+        (options.KeyframeInterval.count() * options.FramesPerSecond) / 1000);
+    const uint64_t averageFrameSize = options.VideoBitrateBps / 8 / options.FramesPerSecond;
+    const uint64_t frameSize = std::max<uint64_t>(1,
+        (averageFrameSize * framesPerKeyframe) /
+            (framesPerKeyframe + KEYFRAME_SIZE_MULTIPLIER - 1));
+    const bool isKeyframe = ((videoFrameCount % framesPerKeyframe) == 0);
+    size_t remainingBytes = isKeyframe ? (frameSize * KEYFRAME_SIZE_MULTIPLIER) : frameSize;
+    const rtp_timestamp_t timestamp = static_cast<rtp_timestamp_t>(
+        (videoFrameCount * VIDEO_CLOCK_RATE) / options.FramesPerSecond);
+    const uint8_t nalType = isKeyframe ? H264Rtp::NAL_TYPE_IDR : NAL_TYPE_NON_IDR_SLICE;
+
+    // Each frame is one NAL unit, fragmented with FU-A like OBS does
+    std::vector<OutgoingPacket> packets;
+    bool isFirstFragment = true;
+    while (remainingBytes > 0)
+    {
+        const size_t fragmentSize =
+            std::min(remainingBytes, (MAX_RTP_PAYLOAD_SIZE - FU_A_HEADER_SIZE));
+        remainingBytes -= fragmentSize;
+        const bool isLastFragment = (remainingBytes == 0);
+        const std::array<std::byte, FU_A_HEADER_SIZE> fuHeader = {
+            std::byte(NAL_REF_IDC_HIGHEST | H264Rtp::NAL_TYPE_FU_A),
+            std::byte((isFirstFragment ? FU_A_START_BIT : 0) |
+                (isLastFragment ? FU_A_END_BIT : 0) | nalType),
+        };
+        const rtp_sequence_num_t sequence = nextVideoSequence++;
+        OutgoingPacket packet {
+            .Bytes = buildRtpPacket(VIDEO_PAYLOAD_TYPE, sequence, timestamp, videoSsrc,
+                isLastFragment, fuHeader, fragmentSize),
+            .Kind = isKeyframe ?
+                BoundedPacketQueue::PacketKind::Keyframe :
+                BoundedPacketQueue::PacketKind::Dependent,
+        };
+        remember(videoSsrc, sequence, packet);
+        packets.push_back(std::move(packet));
+        isFirstFragment = false;
+    }
+    emitFrame(std::move(packets), frameTime);
+}
+
+void SyntheticStream::generateAudioFrame(std::chrono::steady_clock::time_point frameTime)
+{
+    constexpr uint64_t FRAMES_PER_SECOND = (std::chrono::seconds(1) / AUDIO_FRAME_INTERVAL);
+    const size_t frameSize =
+        std::max<size_t>(1, (options.AudioBitrateBps / 8 / FRAMES_PER_SECOND));
+    const rtp_timestamp_t timestamp = static_cast<rtp_timestamp_t>(
+        (audioFrameCount * AUDIO_CLOCK_RATE) / FRAMES_PER_SECOND);
+    const rtp_sequence_num_t sequence = nextAudioSequence++;
+
+    std::vector<OutgoingPacket> packets;
+    packets.push_back(OutgoingPacket {
+        .Bytes = buildRtpPacket(AUDIO_PAYLOAD_TYPE, sequence, timestamp, audioSsrc, true, {},
+            std::min(frameSize, MAX_RTP_PAYLOAD_SIZE)),
+        .Kind = BoundedPacketQueue::PacketKind::Independent,
+    });
+    remember(audioSsrc, sequence, packets.back());
+    emitFrame(std::move(packets), frameTime);
+}
+
+void SyntheticStream::emitFrame(std::vector<OutgoingPacket> packets,
+    std::chrono::steady_clock::time_point frameTime)
+{
+    for (const OutgoingPacket& packet : packets)
+    {
+        packetsGenerated.fetch_add(1, std::memory_order_relaxed);
+        bytesGenerated.fetch_add(packet.Bytes.Size(), std::memory_order_relaxed);
+    }
+
+    if (options.ReorderRate > 0)
+    {
+        for (size_t i = 0; (i + 1) < packets.size(); ++i)
+        {
+            if (chanceDistribution(random) < options.ReorderRate)
+            {
+                std::swap(packets[i], packets[i + 1]);
+                // Don't let the same packet keep getting pushed back
+                ++i;
+            }
+        }
+    }
+
+    if (options.LossRate > 0)
+    {
+        const size_t packetCount = packets.size();
+        std::erase_if(packets,
+            [this](const OutgoingPacket&)
+            {
+                return (chanceDistribution(random) < options.LossRate);
+            });
+        packetsDropped.fetch_add((packetCount - packets.size()), std::memory_order_relaxed);
+    }
+
+    if (options.MaxJitter.count() > 0)
+    {
+        std::uniform_int_distribution<int64_t> jitterDistribution(0,
+            std::chrono::duration_cast<std::chrono::microseconds>(options.MaxJitter).count());
+        delayedFrames.emplace(
+            (frameTime + std::chrono::microseconds(jitterDistribution(random))),
+            std::move(packets));
+        return;
+    }
+
+    sendPackets(packets);
+}
+
+void SyntheticStream::sendPackets(const std::vector<OutgoingPacket>& packets)
+{
+    for (const OutgoingPacket& packet : packets)
+    {
+        client->RelayPacket(packet.Bytes, packet.Kind);
+    }
+}
+
+PacketBuffer SyntheticStream::buildRtpPacket(rtp_payload_type_t payloadType,
+    rtp_sequence_num_t sequence, rtp_timestamp_t timestamp, rtp_ssrc_t ssrc, bool marker,
+    std::span<const std::byte> payloadHeader, size_t payloadSize)
+{
+    PacketBuffer packet = PacketBufferPool::Default().Acquire();
+    packet.Resize(RTP_HEADER_SIZE + payloadHeader.size() + payloadSize);
+    std::byte* bytes = packet.Data();
+    // Version 2, no padding, extensions, or CSRCs
+    bytes[0] = std::byte(RTP_VERSION << 6);
+    bytes[1] = std::byte((marker ? 0x80 : 0x00) | (payloadType & 0x7F));
+    writeUint16(bytes + 2, sequence);
+    writeUint32(bytes + 4, timestamp);
+    writeUint32(bytes + 8, ssrc);
+    std::copy(payloadHeader.begin(), payloadHeader.end(), (bytes + RTP_HEADER_SIZE));
+    // The payload itself is never decoded, zeroes are as good as anything
+    std::memset((bytes + RTP_HEADER_SIZE + payloadHeader.size()), 0, payloadSize);
+    return packet;
+}
+
+void SyntheticStream::remember(rtp_ssrc_t ssrc, rtp_sequence_num_t sequence,
+    const OutgoingPacket& packet)
+{
+    std::array<SentPacket, RETRANSMIT_HISTORY_SIZE>& history =
+        (ssrc == videoSsrc) ? videoHistory : audioHistory;
+    std::scoped_lock lock(historyMutex);
+    history[sequence % RETRANSMIT_HISTORY_SIZE] = SentPacket {
+        .Sequence = sequence,
+        .Packet = packet,
+    };
+}
+
+void SyntheticStream::onMediaBytesReceived(const std::span<const std::byte>& bytes)
+{
+    // A datagram may hold several RTCP packets, look for any NACKs among them
+    // See https://tools.ietf.org/html/rfc4585#section-6.2.1
+    size_t offset = 0;
+    while ((offset + RTCP_FEEDBACK_HEADER_SIZE) <= bytes.size())
+    {
+        const std::span<const std::byte> packet = bytes.subspan(offset);
+        const uint8_t version = (static_cast<uint8_t>(packet[0]) >> 6);
+        const uint8_t feedbackType = (static_cast<uint8_t>(packet[0]) & 0x1F);
+        const uint8_t packetType = static_cast<uint8_t>(packet[1]);
+        const size_t packetSize = (static_cast<size_t>(readUint16(packet, 2)) + 1) * 4;
+        if ((version != RTP_VERSION) || (packetSize > packet.size()))
+        {
+            return;
+        }
+        offset += packetSize;
+        if ((packetType != RtcpType::RTPFB) || (feedbackType != RtcpFeedbackMessageType::NACK))
+        {
+            continue;
+        }
+
+        nacksReceived.fetch_add(1, std::memory_order_relaxed);
+        const rtp_ssrc_t mediaSsrc = readUint32(packet, 8);
+        for (size_t fciOffset = RTCP_FEEDBACK_HEADER_SIZE;
+            (fciOffset + RTCP_NACK_FCI_SIZE) <= packetSize;
+            fciOffset += RTCP_NACK_FCI_SIZE)
+        {
+            const rtp_sequence_num_t packetId = readUint16(packet, fciOffset);
+            const uint16_t followingLostPackets = readUint16(packet, fciOffset + 2);
+            retransmit(mediaSsrc, packetId);
+            for (int i = 0; i < 16; ++i)
+            {
+                if ((followingLostPackets & (0x1 << i)) != 0)
+                {
+                    retransmit(mediaSsrc, static_cast<rtp_sequence_num_t>(packetId + i + 1));
+                }
+            }
+        }
+    }
+}
+
+void SyntheticStream::retransmit(rtp_ssrc_t ssrc, rtp_sequence_num_t sequence)
+{
+    if ((ssrc != videoSsrc) && (ssrc != audioSsrc))
+    {
+        return;
+    }
+    const std::array<SentPacket, RETRANSMIT_HISTORY_SIZE>& history =
+        (ssrc == videoSsrc) ? videoHistory : audioHistory;
+
+    // Retransmissions skip the impairments, the server has already been through enough
+    std::scoped_lock lock(historyMutex);
+    const SentPacket& sentPacket = history[sequence % RETRANSMIT_HISTORY_SIZE];
+    if (sentPacket.Sequence != sequence)
+    {
+        retransmitsMissed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    client->RelayPacket(sentPacket.Packet.Bytes, sentPacket.Packet.Kind);
+    packetsRetransmitted.fetch_add(1, std::memory_order_relaxed);
+}
+#pragma endregion Private methods
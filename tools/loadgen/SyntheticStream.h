@@ -0,0 +1,176 @@
+/**
+ * @file SyntheticStream.h
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#pragma once
+
+#include "../../src/FtlClient.h"
+#include "../../src/Rtp/Types.h"
+#include "../../src/Utilities/PacketBuffer.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief
+ *  One synthetic FTL stream, shaped like one from OBS: H.264 video fragmented into MTU sized
+ *  packets with a keyframe every so often, alongside Opus audio. Packets can be lost,
+ *  delayed, and reordered on their way out, and lost packets are retransmitted when the
+ *  server NACKs them, just like a real client would.
+ *
+ *  Connects on the FtlClient's own thread. Tick is only ever called by one thread at a time.
+ */
+class SyntheticStream
+{
+public:
+    /* Public types */
+    struct Options
+    {
+        std::string TargetHostname;
+        ftl_channel_id_t ChannelId = 0;
+        std::vector<std::byte> StreamKey;
+        uint32_t VideoBitrateBps = 6'000'000;
+        uint32_t AudioBitrateBps = 128'000;
+        uint32_t FramesPerSecond = 60;
+        std::chrono::milliseconds KeyframeInterval { 2000 };
+        // Chance of each packet being dropped on its way out, from 0 to 1
+        double LossRate = 0.0;
+        // Each frame's packets go out up to this much later than they're due
+        std::chrono::milliseconds MaxJitter { 0 };
+        // Chance of each packet being swapped with the one after it, from 0 to 1
+        double ReorderRate = 0.0;
+        uint32_t RandomSeed = 0;
+    };
+
+    struct Stats
+    {
+        bool IsConnected = false;
+        bool IsClosed = false;
+        // How long the server took to accept the stream, once it has
+        std::optional<std::chrono::microseconds> AcceptanceLatency;
+        uint64_t PacketsGenerated = 0;
+        uint64_t BytesGenerated = 0;
+        uint64_t PacketsDropped = 0;
+        uint64_t NacksReceived = 0;
+        uint64_t PacketsRetransmitted = 0;
+        // Asked for by a NACK, but too old to still be around
+        uint64_t RetransmitsMissed = 0;
+        // Packets the client's send queue has put on the wire
+        uint64_t PacketsSent = 0;
+        uint64_t PacketsSendQueueDropped = 0;
+    };
+
+    /* Constants */
+    static constexpr rtp_payload_type_t VIDEO_PAYLOAD_TYPE = 96;
+    static constexpr rtp_payload_type_t AUDIO_PAYLOAD_TYPE = 97;
+    static constexpr size_t MAX_RTP_PAYLOAD_SIZE = 1200;
+    // Keyframes are this many times bigger than other frames, about what x264 does at 60fps
+    static constexpr uint32_t KEYFRAME_SIZE_MULTIPLIER = 8;
+    // Opus frames are 20ms
+    static constexpr std::chrono::milliseconds AUDIO_FRAME_INTERVAL { 20 };
+    // Packets kept around for retransmission, per SSRC
+    static constexpr size_t RETRANSMIT_HISTORY_SIZE = 2048;
+
+    /* Constructor/Destructor */
+    SyntheticStream(Options options);
+    ~SyntheticStream();
+
+    /* Public methods */
+    /**
+     * @brief Starts connecting to the server, returning right away
+     */
+    void Start();
+
+    /**
+     * @brief Generates and sends everything that is due by now
+     */
+    void Tick(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Closes the connection (blocks until close is complete)
+     */
+    void Stop();
+
+    /* Getters/Setters */
+    Stats GetStats();
+    ftl_channel_id_t GetChannelId() const;
+
+private:
+    /* Private types */
+    struct OutgoingPacket
+    {
+        PacketBuffer Bytes;
+        BoundedPacketQueue::PacketKind Kind;
+    };
+
+    struct SentPacket
+    {
+        std::optional<rtp_sequence_num_t> Sequence;
+        OutgoingPacket Packet;
+    };
+
+    /* Private fields */
+    const Options options;
+    const rtp_ssrc_t videoSsrc;
+    const rtp_ssrc_t audioSsrc;
+    std::unique_ptr<FtlClient> client;
+    std::future<Result<void>> connectedFuture;
+    std::chrono::steady_clock::time_point connectStartTime;
+    // Set once, when the stream has been accepted, and read from whichever thread reports
+    std::atomic<bool> isConnected { false };
+    std::atomic<int64_t> acceptanceLatencyMicroseconds { 0 };
+    std::mt19937 random;
+    std::uniform_real_distribution<double> chanceDistribution { 0.0, 1.0 };
+    // Frames are due at fixed offsets from when we were accepted, so timing never drifts
+    std::chrono::steady_clock::time_point mediaStartTime;
+    uint64_t videoFrameCount = 0;
+    uint64_t audioFrameCount = 0;
+    rtp_sequence_num_t nextVideoSequence = 0;
+    rtp_sequence_num_t nextAudioSequence = 0;
+    // Frames waiting out their jitter, by the time they're due to go out
+    std::multimap<std::chrono::steady_clock::time_point, std::vector<OutgoingPacket>>
+        delayedFrames;
+    // Everything we've generated recently, including packets that were lost, so NACKs can be
+    // answered from the connection thread
+    std::mutex historyMutex;
+    std::array<SentPacket, RETRANSMIT_HISTORY_SIZE> videoHistory;
+    std::array<SentPacket, RETRANSMIT_HISTORY_SIZE> audioHistory;
+    // Counters are read from whichever thread reports on us
+    std::atomic<uint64_t> packetsGenerated { 0 };
+    std::atomic<uint64_t> bytesGenerated { 0 };
+    std::atomic<uint64_t> packetsDropped { 0 };
+    std::atomic<uint64_t> nacksReceived { 0 };
+    std::atomic<uint64_t> packetsRetransmitted { 0 };
+    std::atomic<uint64_t> retransmitsMissed { 0 };
+
+    /* Private methods */
+    void checkConnected(std::chrono::steady_clock::time_point now);
+    std::chrono::steady_clock::time_point videoFrameTime(uint64_t frameNumber) const;
+    std::chrono::steady_clock::time_point audioFrameTime(uint64_t frameNumber) const;
+    void generateVideoFrame(std::chrono::steady_clock::time_point frameTime);
+    void generateAudioFrame(std::chrono::steady_clock::time_point frameTime);
+    // Sends a frame's packets through whatever impairments have been configured
+    void emitFrame(std::vector<OutgoingPacket> packets,
+        std::chrono::steady_clock::time_point frameTime);
+    void sendPackets(const std::vector<OutgoingPacket>& packets);
+    static PacketBuffer buildRtpPacket(rtp_payload_type_t payloadType,
+        rtp_sequence_num_t sequence, rtp_timestamp_t timestamp, rtp_ssrc_t ssrc, bool marker,
+        std::span<const std::byte> payloadHeader, size_t payloadSize);
+    void remember(rtp_ssrc_t ssrc, rtp_sequence_num_t sequence, const OutgoingPacket& packet);
+    void onMediaBytesReceived(const std::span<const std::byte>& bytes);
+    void retransmit(rtp_ssrc_t ssrc, rtp_sequence_num_t sequence);
+};
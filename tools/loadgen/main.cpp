@@ -0,0 +1,218 @@
+/**
+ * @file main.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @brief
+ *  Synthetic FTL load generator. Drives many realistic FTL streams at an ingest server, so it
+ *  can be capacity planned without an army of OBS instances.
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "LoadGenerator.h"
+
+#include <atomic>
+#include <csignal>
+#include <getopt.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::atomic<bool> isStopRequested { false };
+
+    void printUsage(const char* programName)
+    {
+        fmt::print(
+            "Usage: {} [options]\n"
+            "\n"
+            "  -H, --host HOST               FTL ingest server to stream to (127.0.0.1)\n"
+            "  -n, --streams N               Concurrent streams to run (1)\n"
+            "  -c, --channel-id ID           Channel ID of the first stream, the rest count up "
+                "from it (1)\n"
+            "  -k, --stream-key KEY          HMAC key every stream authenticates with (the "
+                "dummy service's default)\n"
+            "  -b, --video-bitrate KBPS      Video bitrate of each stream (6000)\n"
+            "  -a, --audio-bitrate KBPS      Audio bitrate of each stream (128)\n"
+            "  -f, --fps FPS                 Video frames per second (60)\n"
+            "  -g, --keyframe-interval MS    Time between keyframes (2000)\n"
+            "  -l, --loss PERCENT            Chance of each packet being lost (0)\n"
+            "  -j, --jitter MS               Most each frame is delayed by (0)\n"
+            "  -o, --reorder PERCENT         Chance of each packet being swapped with the next "
+                "(0)\n"
+            "  -r, --ramp MS                 Time between starting each stream (50)\n"
+            "  -d, --duration SECONDS        Time to run once every stream has started, 0 runs "
+                "until interrupted (0)\n"
+            "  -t, --threads N               Threads generating packets (number of cores)\n"
+            "  -i, --report-interval SECONDS Time between reports (5)\n"
+            "  -s, --seed N                  Seed for the random impairments (0)\n"
+            "  -v, --verbose                 Log debug messages\n"
+            "  -h, --help                    Show this message\n",
+            programName);
+    }
+
+    uint32_t parseUnsigned(const char* optionName, const std::string& value)
+    {
+        try
+        {
+            size_t parsedLength = 0;
+            unsigned long parsed = std::stoul(value, &parsedLength);
+            if ((parsedLength == value.size()) && (parsed <= UINT32_MAX))
+            {
+                return static_cast<uint32_t>(parsed);
+            }
+        }
+        catch (const std::logic_error&)
+        { }
+        throw std::invalid_argument(
+            fmt::format("--{} expects a non-negative integer, got '{}'", optionName, value));
+    }
+
+    double parsePercent(const char* optionName, const std::string& value)
+    {
+        try
+        {
+            size_t parsedLength = 0;
+            double parsed = std::stod(value, &parsedLength);
+            if ((parsedLength == value.size()) && (parsed >= 0) && (parsed <= 100))
+            {
+                return (parsed / 100);
+            }
+        }
+        catch (const std::logic_error&)
+        { }
+        throw std::invalid_argument(
+            fmt::format("--{} expects a percentage from 0 to 100, got '{}'", optionName, value));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // The dummy service connection's default key
+    const std::string defaultStreamKey = "aBcDeFgHiJkLmNoPqRsTuVwXyZ123456";
+    LoadGenerator::Options options {
+        .ThreadCount = std::max(1u, std::thread::hardware_concurrency()),
+    };
+    options.Stream.TargetHostname = "127.0.0.1";
+    options.Stream.StreamKey = std::vector<std::byte>(
+        reinterpret_cast<const std::byte*>(defaultStreamKey.data()),
+        reinterpret_cast<const std::byte*>(defaultStreamKey.data() + defaultStreamKey.size()));
+
+    const option longOptions[] = {
+        { "host", required_argument, nullptr, 'H' },
+        { "streams", required_argument, nullptr, 'n' },
+        { "channel-id", required_argument, nullptr, 'c' },
+        { "stream-key", required_argument, nullptr, 'k' },
+        { "video-bitrate", required_argument, nullptr, 'b' },
+        { "audio-bitrate", required_argument, nullptr, 'a' },
+        { "fps", required_argument, nullptr, 'f' },
+        { "keyframe-interval", required_argument, nullptr, 'g' },
+        { "loss", required_argument, nullptr, 'l' },
+        { "jitter", required_argument, nullptr, 'j' },
+        { "reorder", required_argument, nullptr, 'o' },
+        { "ramp", required_argument, nullptr, 'r' },
+        { "duration", required_argument, nullptr, 'd' },
+        { "threads", required_argument, nullptr, 't' },
+        { "report-interval", required_argument, nullptr, 'i' },
+        { "seed", required_argument, nullptr, 's' },
+        { "verbose", no_argument, nullptr, 'v' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 },
+    };
+    try
+    {
+        int optionIndex = 0;
+        int opt;
+        while ((opt = getopt_long(argc, argv, "H:n:c:k:b:a:f:g:l:j:o:r:d:t:i:s:vh", longOptions,
+            &optionIndex)) != -1)
+        {
+            // Find the long name of the option, for error messages
+            const char* name = "";
+            for (const option& longOption : longOptions)
+            {
+                if ((longOption.name != nullptr) && (longOption.val == opt))
+                {
+                    name = longOption.name;
+                }
+            }
+            const std::string value = (optarg != nullptr) ? optarg : "";
+            switch (opt)
+            {
+            case 'H':
+                options.Stream.TargetHostname = value;
+                break;
+            case 'n':
+                options.StreamCount = parseUnsigned(name, value);
+                break;
+            case 'c':
+                options.FirstChannelId = parseUnsigned(name, value);
+                break;
+            case 'k':
+                options.Stream.StreamKey = std::vector<std::byte>(
+                    reinterpret_cast<const std::byte*>(value.data()),
+                    reinterpret_cast<const std::byte*>(value.data() + value.size()));
+                break;
+            case 'b':
+                options.Stream.VideoBitrateBps = parseUnsigned(name, value) * 1000;
+                break;
+            case 'a':
+                options.Stream.AudioBitrateBps = parseUnsigned(name, value) * 1000;
+                break;
+            case 'f':
+                options.Stream.FramesPerSecond = std::max(1u, parseUnsigned(name, value));
+                break;
+            case 'g':
+                options.Stream.KeyframeInterval =
+                    std::chrono::milliseconds(parseUnsigned(name, value));
+                break;
+            case 'l':
+                options.Stream.LossRate = parsePercent(name, value);
+                break;
+            case 'j':
+                options.Stream.MaxJitter = std::chrono::milliseconds(parseUnsigned(name, value));
+                break;
+            case 'o':
+                options.Stream.ReorderRate = parsePercent(name, value);
+                break;
+            case 'r':
+                options.RampInterval = std::chrono::milliseconds(parseUnsigned(name, value));
+                break;
+            case 'd':
+                options.Duration = std::chrono::seconds(parseUnsigned(name, value));
+                break;
+            case 't':
+                options.ThreadCount = std::max(1u, parseUnsigned(name, value));
+                break;
+            case 'i':
+                options.ReportInterval =
+                    std::chrono::seconds(std::max(1u, parseUnsigned(name, value)));
+                break;
+            case 's':
+                options.Stream.RandomSeed = parseUnsigned(name, value);
+                break;
+            case 'v':
+                spdlog::set_level(spdlog::level::debug);
+                break;
+            case 'h':
+                printUsage(argv[0]);
+                return 0;
+            default:
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    catch (const std::invalid_argument& e)
+    {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    // Stop cleanly on Ctrl+C, so we still get our final report
+    std::signal(SIGINT, [](int) { isStopRequested.store(true); });
+    std::signal(SIGTERM, [](int) { isStopRequested.store(true); });
+
+    LoadGenerator loadGenerator(std::move(options));
+    loadGenerator.Run(isStopRequested);
+    return 0;
+}
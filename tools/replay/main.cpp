@@ -0,0 +1,436 @@
+/**
+ * @file main.cpp
+ * @author Hayden McAfee (hayden@outlook.com)
+ * @brief
+ *  Replays a capture of real FTL media traffic through the plugin's ingest path, and reports
+ *  how fast it went through and how long packets spent at each stage on the way.
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 Hayden McAfee
+ */
+
+#include "../../src/ConnectionTransports/PcapConnectionTransport.h"
+#include "../../src/FtlMediaConnection.h"
+#include "../../src/JanusSession.h"
+#include "../../src/JanusStream.h"
+#include "../../src/Utilities/Metrics.h"
+#include "../../src/Utilities/PacketLatencyTracer.h"
+#include "../../test/mocks/MockJanusCore.h"
+
+#include <array>
+#include <fstream>
+#include <future>
+#include <getopt.h>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace
+{
+    // What OBS sends FTL streams with, unless the capture's metadata is given
+    constexpr rtp_payload_type_t DEFAULT_VIDEO_PAYLOAD_TYPE = 96;
+    constexpr rtp_payload_type_t DEFAULT_AUDIO_PAYLOAD_TYPE = 97;
+    constexpr size_t RTP_HEADER_SIZE = 12;
+    constexpr std::chrono::milliseconds FINISHED_POLL_INTERVAL { 10 };
+
+    struct Options
+    {
+        std::string CapturePath;
+        std::optional<uint16_t> DestinationPort;
+        PcapConnectionTransport::Timing Timing = PcapConnectionTransport::Timing::AsFastAsPossible;
+        uint32_t ViewerCount = 1;
+        ftl_channel_id_t ChannelId = 1;
+        rtp_payload_type_t VideoPayloadType = DEFAULT_VIDEO_PAYLOAD_TYPE;
+        rtp_payload_type_t AudioPayloadType = DEFAULT_AUDIO_PAYLOAD_TYPE;
+        std::optional<rtp_ssrc_t> VideoSsrc;
+        std::optional<rtp_ssrc_t> AudioSsrc;
+        bool NackLostPackets = true;
+    };
+
+    void printUsage(const char* programName)
+    {
+        fmt::print(
+            "Usage: {} [options] CAPTURE\n"
+            "\n"
+            "Replays the FTL media packets in a pcap capture through the ingest path.\n"
+            "\n"
+            "  -p, --port PORT               Only replay datagrams sent to this UDP port (every "
+                "port)\n"
+            "  -t, --timing original|fast    Replay with the capture's own spacing, or as fast "
+                "as possible (fast)\n"
+            "  -n, --viewers N               Viewers to fan packets out to (1)\n"
+            "  -c, --channel-id ID           Channel ID to replay the stream as (1)\n"
+            "  -V, --video-ssrc SSRC         Video SSRC (the first seen with the video payload "
+                "type)\n"
+            "  -A, --audio-ssrc SSRC         Audio SSRC (the first seen with the audio payload "
+                "type)\n"
+            "      --video-payload-type PT   Video payload type ({})\n"
+            "      --audio-payload-type PT   Audio payload type ({})\n"
+            "      --no-nacks                Don't NACK packets missing from the capture\n"
+            "  -v, --verbose                 Log debug messages\n"
+            "  -h, --help                    Show this message\n",
+            programName, DEFAULT_VIDEO_PAYLOAD_TYPE, DEFAULT_AUDIO_PAYLOAD_TYPE);
+    }
+
+    uint32_t parseUnsigned(const char* optionName, const std::string& value,
+        uint32_t maxValue = UINT32_MAX)
+    {
+        try
+        {
+            size_t parsedLength = 0;
+            unsigned long parsed = std::stoul(value, &parsedLength);
+            if ((parsedLength == value.size()) && (parsed <= maxValue))
+            {
+                return static_cast<uint32_t>(parsed);
+            }
+        }
+        catch (const std::logic_error&)
+        { }
+        throw std::invalid_argument(fmt::format(
+            "--{} expects an integer from 0 to {}, got '{}'", optionName, maxValue, value));
+    }
+
+    std::vector<PcapReader::UdpDatagram> readCapture(const Options& options)
+    {
+        std::ifstream input(options.CapturePath, std::ios::binary);
+        if (!input)
+        {
+            throw std::runtime_error(fmt::format("Couldn't open {}", options.CapturePath));
+        }
+
+        PcapReader reader(input);
+        std::vector<PcapReader::UdpDatagram> datagrams;
+        while (std::optional<PcapReader::UdpDatagram> datagram = reader.ReadNextUdpDatagram())
+        {
+            if (!options.DestinationPort.has_value() ||
+                (datagram->DestinationPort == options.DestinationPort.value()))
+            {
+                datagrams.push_back(std::move(datagram.value()));
+            }
+        }
+        spdlog::debug("Read {} UDP datagrams from {}, skipped {} other frames",
+            datagrams.size(), options.CapturePath, reader.GetSkippedFrameCount());
+        return datagrams;
+    }
+
+    /**
+     * @brief
+     *  Works out the stream's metadata, taking the SSRC of each media type from the first RTP
+     *  packet with its payload type unless it was given
+     */
+    MediaMetadata findMediaMetadata(const Options& options,
+        const std::vector<PcapReader::UdpDatagram>& datagrams)
+    {
+        std::optional<rtp_ssrc_t> videoSsrc = options.VideoSsrc;
+        std::optional<rtp_ssrc_t> audioSsrc = options.AudioSsrc;
+        for (const PcapReader::UdpDatagram& datagram : datagrams)
+        {
+            if (videoSsrc.has_value() && audioSsrc.has_value())
+            {
+                break;
+            }
+            const std::vector<std::byte>& payload = datagram.Payload;
+            // RTP version 2
+            if ((payload.size() < RTP_HEADER_SIZE) ||
+                ((static_cast<uint8_t>(payload[0]) >> 6) != 2))
+            {
+                continue;
+            }
+            const rtp_payload_type_t payloadType = (static_cast<uint8_t>(payload[1]) & 0x7F);
+            const rtp_ssrc_t ssrc = (static_cast<uint32_t>(payload[8]) << 24) |
+                (static_cast<uint32_t>(payload[9]) << 16) |
+                (static_cast<uint32_t>(payload[10]) << 8) | static_cast<uint32_t>(payload[11]);
+            if (!videoSsrc.has_value() && (payloadType == options.VideoPayloadType))
+            {
+                videoSsrc = ssrc;
+            }
+            else if (!audioSsrc.has_value() && (payloadType == options.AudioPayloadType))
+            {
+                audioSsrc = ssrc;
+            }
+        }
+        if (!videoSsrc.has_value() && !audioSsrc.has_value())
+        {
+            throw std::runtime_error(fmt::format(
+                "No RTP packets with payload type {} or {} in the capture",
+                options.VideoPayloadType, options.AudioPayloadType));
+        }
+
+        return MediaMetadata {
+            .VendorName = "janus-ftl-replay",
+            .HasVideo = videoSsrc.has_value(),
+            .HasAudio = audioSsrc.has_value(),
+            .VideoCodec = VideoCodecKind::H264,
+            .AudioCodec = AudioCodecKind::Opus,
+            .VideoSsrc = videoSsrc.value_or(0),
+            .AudioSsrc = audioSsrc.value_or(0),
+            .VideoPayloadType = options.VideoPayloadType,
+            .AudioPayloadType = options.AudioPayloadType,
+        };
+    }
+
+    /**
+     * @brief
+     *  Upper bound of the bucket the given quantile falls in, or nullopt if it's past every
+     *  bound
+     */
+    std::optional<double> histogramQuantile(const MetricHistogram& histogram, double quantile)
+    {
+        const MetricHistogram::Snapshot snapshot = histogram.GetSnapshot();
+        const std::vector<double>& bounds = histogram.GetBucketBounds();
+        const double rank = (quantile * snapshot.Count);
+        uint64_t cumulativeCount = 0;
+        for (size_t i = 0; i < bounds.size(); ++i)
+        {
+            cumulativeCount += snapshot.BucketCounts[i];
+            if (cumulativeCount >= rank)
+            {
+                return bounds[i];
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string formatLatency(std::optional<double> seconds, double lastBound)
+    {
+        if (!seconds.has_value())
+        {
+            return fmt::format(">{:.1f}us", (lastBound * 1e6));
+        }
+        return fmt::format("<={:.1f}us", (seconds.value() * 1e6));
+    }
+
+    void printStageLatencies(MetricsRegistry& metrics, ftl_channel_id_t channelId)
+    {
+        if constexpr (!PacketLatencyTracer::IS_ENABLED)
+        {
+            fmt::print("Per-stage latency: not traced, build with packet_latency_tracing=true\n");
+            return;
+        }
+
+        const std::array<std::string, PacketLatencyTracer::NUM_STAGES> stageNames
+        {
+            "sequenced",
+            "fanout_queued",
+            "viewer_send",
+            "relay_send",
+        };
+        const double lastBound = PacketLatencyTracer::LATENCY_BUCKETS.back();
+        fmt::print("Per-stage latency since each packet was read:\n");
+        fmt::print("  {:<14} {:>10} {:>12} {:>12} {:>12} {:>12}\n",
+            "stage", "packets", "mean", "p50", "p90", "p99");
+        for (const std::string& stageName : stageNames)
+        {
+            // The tracers have already added these series, so we get the same ones back
+            const std::shared_ptr<MetricHistogram> histogram = metrics.AddHistogram(
+                "ftl_packet_latency_seconds",
+                "Time since a packet was received, as of each stage of the packet path",
+                { { "channel", std::to_string(channelId) }, { "stage", stageName } },
+                PacketLatencyTracer::LATENCY_BUCKETS);
+            const MetricHistogram::Snapshot snapshot = histogram->GetSnapshot();
+            if (snapshot.Count == 0)
+            {
+                fmt::print("  {:<14} {:>10}\n", stageName, 0);
+                continue;
+            }
+            fmt::print("  {:<14} {:>10} {:>10.1f}us {:>12} {:>12} {:>12}\n",
+                stageName, snapshot.Count, ((snapshot.Sum / snapshot.Count) * 1e6),
+                formatLatency(histogramQuantile(*histogram, 0.5), lastBound),
+                formatLatency(histogramQuantile(*histogram, 0.9), lastBound),
+                formatLatency(histogramQuantile(*histogram, 0.99), lastBound));
+        }
+    }
+
+    int replay(const Options& options)
+    {
+        std::vector<PcapReader::UdpDatagram> datagrams = readCapture(options);
+        if (datagrams.empty())
+        {
+            throw std::runtime_error("The capture has no UDP datagrams to replay");
+        }
+        const MediaMetadata mediaMetadata = findMediaMetadata(options, datagrams);
+        fmt::print("Replaying {} datagrams: video SSRC {}, audio SSRC {}, {} viewers\n",
+            datagrams.size(),
+            mediaMetadata.HasVideo ? std::to_string(mediaMetadata.VideoSsrc) : "none",
+            mediaMetadata.HasAudio ? std::to_string(mediaMetadata.AudioSsrc) : "none",
+            options.ViewerCount);
+
+        uint64_t datagramBytes = 0;
+        for (const PcapReader::UdpDatagram& datagram : datagrams)
+        {
+            datagramBytes += datagram.Payload.size();
+        }
+
+        // Viewers are relayed to a stand-in for the Janus core, which only counts packets
+        auto metrics = std::make_shared<MetricsRegistry>();
+        MockJanusCore core;
+        std::vector<janus_plugin_session> handles(options.ViewerCount);
+        std::vector<std::unique_ptr<JanusSession>> sessions;
+        JanusStream stream(options.ChannelId, 1, mediaMetadata, nullptr, false, false, metrics);
+        for (janus_plugin_session& handle : handles)
+        {
+            handle = core.CreatePluginSession();
+            sessions.push_back(std::make_unique<JanusSession>(&handle, core.GetCallbacks()));
+            sessions.back()->SetIsStarted(true);
+            stream.AddViewerSession(sessions.back().get());
+        }
+
+        auto transport = std::make_unique<PcapConnectionTransport>(std::move(datagrams),
+            options.Timing);
+        // Owned by the connection, which outlives every use of this
+        PcapConnectionTransport* replayTransport = transport.get();
+        std::promise<void> closedPromise;
+        std::future<void> closedFuture = closedPromise.get_future();
+        const auto startTime = std::chrono::steady_clock::now();
+        FtlMediaConnection connection(
+            std::move(transport),
+            mediaMetadata,
+            options.ChannelId,
+            1,
+            [&closedPromise](FtlMediaConnection&)
+            {
+                closedPromise.set_value();
+            },
+            [&stream](const PacketBuffer& packet)
+            {
+                stream.SendRtpPacket(packet);
+            },
+            2000,
+            options.NackLostPackets,
+            nullptr,
+            metrics);
+
+        // Every datagram read has been handled by the time the connection closes
+        while (!replayTransport->IsFinished())
+        {
+            std::this_thread::sleep_for(FINISHED_POLL_INTERVAL);
+        }
+        connection.RequestStop();
+        closedFuture.wait();
+        const std::chrono::duration<double> elapsed =
+            (std::chrono::steady_clock::now() - startTime);
+        const FtlStreamStats stats = connection.GetStats();
+        stream.RemoveAllViewerSessions();
+
+        const double elapsedSeconds = std::max(elapsed.count(), 1e-9);
+        fmt::print("Replayed {} datagrams ({} bytes) in {:.3f}s: {:.0f} packets/s, {:.2f} Mbps\n",
+            replayTransport->GetDatagramsRead(), datagramBytes, elapsedSeconds,
+            (replayTransport->GetDatagramsRead() / elapsedSeconds),
+            ((datagramBytes * 8) / elapsedSeconds / 1e6));
+        fmt::print("Ingest: {} packets received, {} lost, {} NACKed in {} NACK datagrams\n",
+            stats.PacketsReceived, stats.PacketsLost, stats.PacketsNacked,
+            replayTransport->GetDatagramsWritten());
+        fmt::print("Fanout: {} packets relayed to viewers\n",
+            MockJanusCore::GetRelayedPacketCount());
+        printStageLatencies(*metrics, options.ChannelId);
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    enum LongOnlyOption
+    {
+        VideoPayloadTypeOption = 256,
+        AudioPayloadTypeOption,
+        NoNacksOption,
+    };
+    const option longOptions[] = {
+        { "port", required_argument, nullptr, 'p' },
+        { "timing", required_argument, nullptr, 't' },
+        { "viewers", required_argument, nullptr, 'n' },
+        { "channel-id", required_argument, nullptr, 'c' },
+        { "video-ssrc", required_argument, nullptr, 'V' },
+        { "audio-ssrc", required_argument, nullptr, 'A' },
+        { "video-payload-type", required_argument, nullptr, VideoPayloadTypeOption },
+        { "audio-payload-type", required_argument, nullptr, AudioPayloadTypeOption },
+        { "no-nacks", no_argument, nullptr, NoNacksOption },
+        { "verbose", no_argument, nullptr, 'v' },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 },
+    };
+    Options options;
+    try
+    {
+        int optionIndex = 0;
+        int opt;
+        while ((opt = getopt_long(argc, argv, "p:t:n:c:V:A:vh", longOptions, &optionIndex)) !=
+            -1)
+        {
+            // Find the long name of the option, for error messages
+            const char* name = "";
+            for (const option& longOption : longOptions)
+            {
+                if ((longOption.name != nullptr) && (longOption.val == opt))
+                {
+                    name = longOption.name;
+                }
+            }
+            const std::string value = (optarg != nullptr) ? optarg : "";
+            switch (opt)
+            {
+            case 'p':
+                options.DestinationPort = parseUnsigned(name, value, UINT16_MAX);
+                break;
+            case 't':
+                if (value == "original")
+                {
+                    options.Timing = PcapConnectionTransport::Timing::Original;
+                }
+                else if (value == "fast")
+                {
+                    options.Timing = PcapConnectionTransport::Timing::AsFastAsPossible;
+                }
+                else
+                {
+                    throw std::invalid_argument(fmt::format(
+                        "--timing expects 'original' or 'fast', got '{}'", value));
+                }
+                break;
+            case 'n':
+                options.ViewerCount = parseUnsigned(name, value);
+                break;
+            case 'c':
+                options.ChannelId = parseUnsigned(name, value);
+                break;
+            case 'V':
+                options.VideoSsrc = parseUnsigned(name, value);
+                break;
+            case 'A':
+                options.AudioSsrc = parseUnsigned(name, value);
+                break;
+            case VideoPayloadTypeOption:
+                options.VideoPayloadType = parseUnsigned(name, value, 127);
+                break;
+            case AudioPayloadTypeOption:
+                options.AudioPayloadType = parseUnsigned(name, value, 127);
+                break;
+            case NoNacksOption:
+                options.NackLostPackets = false;
+                break;
+            case 'v':
+                spdlog::set_level(spdlog::level::debug);
+                break;
+            case 'h':
+                printUsage(argv[0]);
+                return 0;
+            default:
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        if ((optind + 1) != argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        options.CapturePath = argv[optind];
+
+        return replay(options);
+    }
+    catch (const std::exception& e)
+    {
+        spdlog::error("{}", e.what());
+        return 1;
+    }
+}